@@ -0,0 +1,34 @@
+#pragma once
+
+#include "debug/AllocationCounter.hpp"
+
+#include <benchmark/benchmark.h>
+
+namespace chatterino {
+
+/// Reports the allocations per iteration as the "allocs" counter of the
+/// benchmark, create it right before the benchmark loop
+class ReportAllocations
+{
+public:
+    explicit ReportAllocations(benchmark::State &state)
+        : state_(state)
+    {
+    }
+
+    ~ReportAllocations()
+    {
+        this->state_.counters["allocs"] =
+            benchmark::Counter(double(this->counter_.allocations()),
+                               benchmark::Counter::kAvgIterations);
+    }
+
+    ReportAllocations(const ReportAllocations &) = delete;
+    ReportAllocations &operator=(const ReportAllocations &) = delete;
+
+private:
+    benchmark::State &state_;
+    AllocationCounter counter_;
+};
+
+}  // namespace chatterino
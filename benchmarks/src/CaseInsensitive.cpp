@@ -0,0 +1,136 @@
+#include "util/CaseInsensitive.hpp"
+
+#include "Allocations.hpp"
+#include "Fixtures.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+
+using namespace chatterino;
+
+namespace {
+
+std::vector<QString> fixtureContents()
+{
+    std::vector<QString> contents;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        auto *message = Communi::IrcMessage::fromData(line.toUtf8(), nullptr);
+        contents.push_back(message->parameter(1));
+        delete message;
+    }
+    return contents;
+}
+
+std::vector<QString> fixtureLogins()
+{
+    std::vector<QString> logins;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        auto *message = Communi::IrcMessage::fromData(line.toUtf8(), nullptr);
+        logins.push_back(message->nick());
+        delete message;
+    }
+    return logins;
+}
+
+// what a search or ignored phrase might look for
+const QString NEEDLE = "PogChamp";
+// a display name like the ones the user card compares against every login
+const QString LOGIN = "Pajlada";
+
+}  // namespace
+
+static void BM_ContainsQt(benchmark::State &state)
+{
+    auto contents = fixtureContents();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &content : contents)
+        {
+            benchmark::DoNotOptimize(
+                content.contains(NEEDLE, Qt::CaseInsensitive));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(contents.size()));
+}
+
+static void BM_ContainsIgnoreCase(benchmark::State &state)
+{
+    auto contents = fixtureContents();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &content : contents)
+        {
+            benchmark::DoNotOptimize(containsIgnoreCase(content, NEEDLE));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(contents.size()));
+}
+
+static void BM_EqualsQt(benchmark::State &state)
+{
+    auto logins = fixtureLogins();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &login : logins)
+        {
+            benchmark::DoNotOptimize(
+                login.compare(LOGIN, Qt::CaseInsensitive) == 0);
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(logins.size()));
+}
+
+static void BM_EqualsIgnoreCase(benchmark::State &state)
+{
+    auto logins = fixtureLogins();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &login : logins)
+        {
+            benchmark::DoNotOptimize(equalsIgnoreCase(login, LOGIN));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(logins.size()));
+}
+
+static void BM_StartsWithQt(benchmark::State &state)
+{
+    auto logins = fixtureLogins();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &login : logins)
+        {
+            benchmark::DoNotOptimize(
+                login.startsWith(QStringLiteral("Pa"), Qt::CaseInsensitive));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(logins.size()));
+}
+
+static void BM_StartsWithIgnoreCase(benchmark::State &state)
+{
+    auto logins = fixtureLogins();
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &login : logins)
+        {
+            benchmark::DoNotOptimize(startsWithIgnoreCase(login, u"Pa"));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * int64_t(logins.size()));
+}
+
+BENCHMARK(BM_ContainsQt);
+BENCHMARK(BM_ContainsIgnoreCase);
+BENCHMARK(BM_EqualsQt);
+BENCHMARK(BM_EqualsIgnoreCase);
+BENCHMARK(BM_StartsWithQt);
+BENCHMARK(BM_StartsWithIgnoreCase);
@@ -0,0 +1,145 @@
+#include "util/ConcurrentMap.hpp"
+
+#include "Allocations.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QMap>
+#include <QMutex>
+#include <QMutexLocker>
+#include <QString>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// The QMap with a single mutex ConcurrentMap used to be
+class LegacyConcurrentMap
+{
+public:
+    bool tryGet(const QString &name, int &value) const
+    {
+        QMutexLocker lock(&this->mutex_);
+
+        auto a = this->data_.find(name);
+        if (a == this->data_.end())
+        {
+            return false;
+        }
+
+        value = a.value();
+
+        return true;
+    }
+
+    void insert(const QString &name, int value)
+    {
+        QMutexLocker lock(&this->mutex_);
+
+        this->data_.insert(name, value);
+    }
+
+private:
+    mutable QMutex mutex_;
+    QMap<QString, int> data_;
+};
+
+// about as many keys as there are emojis
+const std::vector<QString> &keys()
+{
+    static std::vector<QString> keys = [] {
+        std::vector<QString> keys;
+        for (int i = 0; i < 4000; i++)
+        {
+            keys.push_back(QString("%1-fe0f").arg(0x1f000 + i, 0, 16));
+        }
+        return keys;
+    }();
+    return keys;
+}
+
+template <typename Map>
+Map &filledMap()
+{
+    static Map map;
+    static const bool filled = [] {
+        for (size_t i = 0; i < keys().size(); i++)
+        {
+            map.insert(keys()[i], int(i));
+        }
+        return true;
+    }();
+    (void)filled;
+
+    return map;
+}
+
+template <typename Map>
+void lookups(benchmark::State &state, Map &map)
+{
+    static std::atomic<size_t> nextStart{0};
+
+    const auto &all = keys();
+    // threads start at different keys so they don't read in lockstep
+    size_t i = nextStart.fetch_add(997);
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        int value = 0;
+        map.tryGet(all[i % all.size()], value);
+        benchmark::DoNotOptimize(value);
+        i += 7;
+    }
+    state.SetItemsProcessed(state.iterations());
+}
+
+// lookups while another thread keeps writing
+template <typename Map>
+void lookupsWithWriter(benchmark::State &state, Map &map)
+{
+    std::atomic<bool> stop{false};
+    std::thread writer([&] {
+        const auto &all = keys();
+        size_t i = 0;
+        while (!stop.load(std::memory_order_relaxed))
+        {
+            map.insert(all[i % all.size()], int(i));
+            i += 13;
+        }
+    });
+
+    lookups(state, map);
+
+    stop = true;
+    writer.join();
+}
+
+}  // namespace
+
+static void BM_ConcurrentMapLookup(benchmark::State &state)
+{
+    lookups(state, filledMap<ConcurrentMap<QString, int>>());
+}
+
+static void BM_LegacyConcurrentMapLookup(benchmark::State &state)
+{
+    lookups(state, filledMap<LegacyConcurrentMap>());
+}
+
+static void BM_ConcurrentMapLookupWithWriter(benchmark::State &state)
+{
+    lookupsWithWriter(state, filledMap<ConcurrentMap<QString, int>>());
+}
+
+static void BM_LegacyConcurrentMapLookupWithWriter(benchmark::State &state)
+{
+    lookupsWithWriter(state, filledMap<LegacyConcurrentMap>());
+}
+
+BENCHMARK(BM_ConcurrentMapLookup)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_LegacyConcurrentMapLookup)->ThreadRange(1, 8)->UseRealTime();
+BENCHMARK(BM_ConcurrentMapLookupWithWriter)->UseRealTime();
+BENCHMARK(BM_LegacyConcurrentMapLookupWithWriter)->UseRealTime();
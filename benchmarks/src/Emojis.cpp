@@ -1,9 +1,15 @@
 #include "providers/emoji/Emojis.hpp"
 
+#include "Allocations.hpp"
+
+#include "messages/Emote.hpp"
+
 #include <benchmark/benchmark.h>
 #include <QDebug>
 #include <QString>
 
+#include <algorithm>
+
 using namespace chatterino;
 
 static void BM_ShortcodeParsing(benchmark::State &state)
@@ -38,6 +44,7 @@ static void BM_ShortcodeParsing(benchmark::State &state)
         },
     };
 
+    ReportAllocations allocations(state);
     for (auto _ : state)
     {
         for (const auto &test : tests)
@@ -55,3 +62,79 @@ static void BM_ShortcodeParsing(benchmark::State &state)
 }
 
 BENCHMARK(BM_ShortcodeParsing);
+
+static void BM_EmojiParsing(benchmark::State &state)
+{
+    Emojis emojis;
+
+    emojis.load();
+
+    struct TestCase {
+        QString input;
+        std::vector<boost::variant<EmotePtr, QString>> expectedOutput;
+    };
+
+    const auto &emojiMap = emojis.emojis;
+    std::shared_ptr<EmojiData> penguin;
+    emojiMap.tryGet("1F427", penguin);
+    std::shared_ptr<EmojiData> cool;
+    emojiMap.tryGet("1F60E", cool);
+    std::shared_ptr<EmojiData> thumbsUp;
+    emojiMap.tryGet("1F44D-1F3FD", thumbsUp);
+
+    std::vector<TestCase> tests{
+        {
+            // input
+            "foo 🐧 bar",
+            // expected output
+            {QString("foo "), penguin->emote, QString(" bar")},
+        },
+        {
+            // input
+            "foo bar",
+            // expected output
+            {QString("foo bar")},
+        },
+        {
+            // input
+            "🐧😎👍🏽",
+            // expected output
+            {penguin->emote, cool->emote, thumbsUp->emote},
+        },
+        {
+            // input
+            "a longer message without any emojis in it, like most messages",
+            // expected output
+            {QString("a longer message without any emojis in it, like most "
+                     "messages")},
+        },
+    };
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &test : tests)
+        {
+            auto output = emojis.parse(test.input);
+
+            bool areEqual =
+                std::equal(output.begin(), output.end(),
+                           test.expectedOutput.begin(),
+                           test.expectedOutput.end());
+
+            if (!areEqual)
+            {
+                qDebug() << "BAD BENCH";
+                for (const auto &v : output)
+                {
+                    if (v.type() == typeid(QString))
+                    {
+                        qDebug() << "output:" << boost::get<QString>(v);
+                    }
+                }
+            }
+        }
+    }
+}
+
+BENCHMARK(BM_EmojiParsing);
@@ -0,0 +1,108 @@
+#include "controllers/filters/parser/FilterParser.hpp"
+
+#include "Allocations.hpp"
+#include "Fixtures.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+
+#include <cassert>
+
+using namespace chatterino;
+
+namespace {
+
+// Messages with the fields filters look at, filled in from the tags
+std::vector<MessagePtr> fixtureMessages()
+{
+    std::vector<MessagePtr> messages;
+
+    for (const auto &line : fixturePrivmsgs())
+    {
+        auto *ircMessage =
+            Communi::IrcMessage::fromData(line.toUtf8(), nullptr);
+        auto tags = ircMessage->tags();
+
+        auto message = std::make_shared<Message>();
+        message->displayName = tags.value("display-name").toString();
+        message->loginName = ircMessage->nick();
+        message->channelName = ircMessage->parameter(0).mid(1);
+        message->messageText = ircMessage->parameter(1);
+        message->usernameColor = QColor(tags.value("color").toString());
+
+        BadgeSet badgeSet;
+        auto badges = tags.value("badges").toString();
+        for (const auto &badge : badges.split(',', QString::SkipEmptyParts))
+        {
+            auto parts = badge.split('/');
+            badgeSet.badges.emplace_back(parts.value(0), parts.value(1));
+        }
+        auto badgeInfos = tags.value("badge-info").toString();
+        for (const auto &info : badgeInfos.split(',', QString::SkipEmptyParts))
+        {
+            auto parts = info.split('/');
+            badgeSet.badgeInfos.emplace(parts.value(0), parts.value(1));
+        }
+        message->badgeSet = std::make_shared<const BadgeSet>(badgeSet);
+
+        messages.push_back(std::move(message));
+        delete ircMessage;
+    }
+
+    return messages;
+}
+
+void runFilter(benchmark::State &state, const QString &filter)
+{
+    auto messages = fixtureMessages();
+    filterparser::FilterParser parser(filter);
+    assert(parser.valid());
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &message : messages)
+        {
+            filterparser::Context context(message, nullptr);
+            benchmark::DoNotOptimize(parser.execute(context));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(messages.size()));
+}
+
+}  // namespace
+
+static void BM_FilterSimple(benchmark::State &state)
+{
+    runFilter(state, "author.subbed");
+}
+
+static void BM_FilterBadges(benchmark::State &state)
+{
+    runFilter(state, "author.badges contains \"moderator\" || "
+                     "author.badges contains \"vip\"");
+}
+
+static void BM_FilterRegex(benchmark::State &state)
+{
+    runFilter(state, "message.content match ri\"(pog|kappa|gg)\" && "
+                     "message.length < 100");
+}
+
+static void BM_FilterParsing(benchmark::State &state)
+{
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        filterparser::FilterParser parser(
+            "(author.subbed && author.sub_length >= 12) || "
+            "{\"pajlada\", \"forsen\"} contains channel.name");
+        benchmark::DoNotOptimize(parser.valid());
+    }
+}
+
+BENCHMARK(BM_FilterSimple);
+BENCHMARK(BM_FilterBadges);
+BENCHMARK(BM_FilterRegex);
+BENCHMARK(BM_FilterParsing);
@@ -0,0 +1,29 @@
+#include "Fixtures.hpp"
+
+namespace chatterino {
+
+const std::vector<QString> &fixturePrivmsgs()
+{
+    static const std::vector<QString> lines{
+        R"(@badge-info=;badges=;color=#FF0000;display-name=Chatter1;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e01;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715611000;turbo=0;user-id=100000001;user-type= :chatter1!chatter1@chatter1.tmi.twitch.tv PRIVMSG #pajlada :hello chat)",
+        R"(@badge-info=subscriber/14;badges=subscriber/12,bits/1000;color=#1E90FF;display-name=SubUser;emotes=25:6-10;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e02;mod=0;room-id=11148817;subscriber=1;tmi-sent-ts=1642715612000;turbo=0;user-id=100000002;user-type= :subuser!subuser@subuser.tmi.twitch.tv PRIVMSG #pajlada :pog! Kappa that was insane)",
+        R"(@badge-info=;badges=moderator/1;color=#00FF7F;display-name=ModUser;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e03;mod=1;room-id=11148817;subscriber=0;tmi-sent-ts=1642715613000;turbo=0;user-id=100000003;user-type=mod :moduser!moduser@moduser.tmi.twitch.tv PRIVMSG #pajlada :please keep the chat in english, the rules are at https://chatterino.com/rules)",
+        R"(@badge-info=;badges=;color=;display-name=NoColor;emotes=;first-msg=1;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e04;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715614000;turbo=0;user-id=100000004;user-type= :nocolor!nocolor@nocolor.tmi.twitch.tv PRIVMSG #pajlada :first time here, what game is this?)",
+        R"(@badge-info=subscriber/3;badges=subscriber/3;color=#9ACD32;display-name=EmoteSpammer;emotes=25:0-4,6-10,12-16,18-22/1902:24-28;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e05;mod=0;room-id=11148817;subscriber=1;tmi-sent-ts=1642715615000;turbo=0;user-id=100000005;user-type= :emotespammer!emotespammer@emotespammer.tmi.twitch.tv PRIVMSG #pajlada :Kappa Kappa Kappa Kappa Keepo OMEGALUL forsenE)",
+        R"(@badge-info=;badges=vip/1;color=#DAA520;display-name=VipUser;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e06;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715616000;turbo=0;user-id=100000006;user-type= :vipuser!vipuser@vipuser.tmi.twitch.tv PRIVMSG #pajlada :@pajlada did you see the clip? clips.twitch.tv/SomeClipName-abc123)",
+        R"(@badge-info=;badges=;color=#8A2BE2;display-name=日本語ユーザー;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e07;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715617000;turbo=0;user-id=100000007;user-type= :nihongo!nihongo@nihongo.tmi.twitch.tv PRIVMSG #pajlada :こんにちは！今日の配信も楽しみ 🐧😎👍🏽)",
+        R"(@badge-info=;badges=;color=#FF4500;display-name=Replier;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e08;mod=0;reply-parent-display-name=Chatter1;reply-parent-msg-body=hello\schat;reply-parent-msg-id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e01;reply-parent-user-id=100000001;reply-parent-user-login=chatter1;room-id=11148817;subscriber=0;tmi-sent-ts=1642715618000;turbo=0;user-id=100000008;user-type= :replier!replier@replier.tmi.twitch.tv PRIVMSG #pajlada :@Chatter1 hi!)",
+        R"(@badge-info=;badges=broadcaster/1;color=#B22222;display-name=pajlada;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e09;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715619000;turbo=0;user-id=11148817;user-type= :pajlada!pajlada@pajlada.tmi.twitch.tv PRIVMSG #pajlada :thanks for the follows everyone, new video at https://www.youtube.com/watch?v=dQw4w9WgXcQ)",
+        R"(@badge-info=;badges=;bits=100;color=#2E8B57;display-name=Cheerer;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e10;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715620000;turbo=0;user-id=100000010;user-type= :cheerer!cheerer@cheerer.tmi.twitch.tv PRIVMSG #pajlada :Cheer100 keep it up!)",
+        R"(@badge-info=subscriber/27;badges=subscriber/24,glhf-pledge/1;color=#5F9EA0;display-name=Copypaster;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e11;mod=0;room-id=11148817;subscriber=1;tmi-sent-ts=1642715621000;turbo=0;user-id=100000011;user-type= :copypaster!copypaster@copypaster.tmi.twitch.tv PRIVMSG #pajlada :I'm not saying this is the best stream on the platform, but it is definitely in the top one, and I have been watching since before most of you even knew what a stream was, so trust me when I say this is peak content and nothing else comes close to it at all)",
+        R"(@badge-info=;badges=;color=#D2691E;display-name=Linker;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e12;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715622000;turbo=0;user-id=100000012;user-type= :linker!linker@linker.tmi.twitch.tv PRIVMSG #pajlada :github.com/Chatterino/chatterino2 and example.org/path?query=1 and not.a.link)",
+        R"(@badge-info=;badges=moderator/1,partner/1;color=#FF69B4;display-name=Partner;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e13;mod=1;room-id=11148817;subscriber=0;tmi-sent-ts=1642715623000;turbo=0;user-id=100000013;user-type=mod :partner!partner@partner.tmi.twitch.tv PRIVMSG #pajlada :ACTION waves at everyone)",
+        R"(@badge-info=;badges=;color=#0000FF;display-name=Asker;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e14;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715624000;turbo=0;user-id=100000014;user-type= :asker!asker@asker.tmi.twitch.tv PRIVMSG #pajlada :what settings do you use? is that 1440p?)",
+        R"(@badge-info=;badges=;color=#008000;display-name=Short;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e15;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715625000;turbo=0;user-id=100000015;user-type= :short!short@short.tmi.twitch.tv PRIVMSG #pajlada :W)",
+        R"(@badge-info=;badges=;color=#7F00FF;display-name=Mentioner;emotes=;first-msg=0;flags=;id=2a1b7a3e-0c1f-4b4e-9d3c-1a2b3c4d5e16;mod=0;room-id=11148817;subscriber=0;tmi-sent-ts=1642715626000;turbo=0;user-id=100000016;user-type= :mentioner!mentioner@mentioner.tmi.twitch.tv PRIVMSG #pajlada :@SubUser @ModUser @VipUser gg)",
+    };
+
+    return lines;
+}
+
+}  // namespace chatterino
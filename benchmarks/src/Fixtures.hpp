@@ -0,0 +1,15 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+// PRIVMSGs as Twitch sends them, with the tags of a typical busy channel:
+// plain chatters, subscribers, moderators, emotes, links, replies and a
+// bit of non-latin text. The same lines are used by all benchmarks so their
+// results can be compared between builds.
+const std::vector<QString> &fixturePrivmsgs();
+
+}  // namespace chatterino
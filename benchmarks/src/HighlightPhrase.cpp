@@ -0,0 +1,75 @@
+#include "controllers/highlights/HighlightPhrase.hpp"
+
+#include "Allocations.hpp"
+#include "Fixtures.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+
+using namespace chatterino;
+
+namespace {
+
+std::vector<QString> fixtureContents()
+{
+    std::vector<QString> contents;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        auto *message = Communi::IrcMessage::fromData(line.toUtf8(), nullptr);
+        contents.push_back(message->parameter(1));
+        delete message;
+    }
+    return contents;
+}
+
+// A few phrases like the ones users add, checked against every message
+std::vector<HighlightPhrase> phrases(bool isRegex)
+{
+    std::vector<HighlightPhrase> phrases;
+    for (const auto &pattern :
+         isRegex
+             ? std::vector<QString>{"pajl(a|ada)", "\\bclip\\b", "^@?subuser",
+                                    "chatter(ino|ino2)"}
+             : std::vector<QString>{"pajlada", "clip", "subuser",
+                                    "chatterino"})
+    {
+        phrases.emplace_back(pattern, true, false, false, isRegex, false, "",
+                             QColor());
+    }
+    return phrases;
+}
+
+void runPhrases(benchmark::State &state, bool isRegex)
+{
+    auto contents = fixtureContents();
+    auto highlights = phrases(isRegex);
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &content : contents)
+        {
+            for (const auto &phrase : highlights)
+            {
+                benchmark::DoNotOptimize(phrase.isMatch(content));
+            }
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(contents.size()));
+}
+
+}  // namespace
+
+static void BM_HighlightPhrases(benchmark::State &state)
+{
+    runPhrases(state, false);
+}
+
+static void BM_HighlightRegexPhrases(benchmark::State &state)
+{
+    runPhrases(state, true);
+}
+
+BENCHMARK(BM_HighlightPhrases);
+BENCHMARK(BM_HighlightRegexPhrases);
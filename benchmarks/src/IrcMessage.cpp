@@ -0,0 +1,56 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include "Allocations.hpp"
+#include "Fixtures.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+
+using namespace chatterino;
+
+static void BM_IrcMessageParsing(benchmark::State &state)
+{
+    std::vector<QByteArray> lines;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        lines.push_back(line.toUtf8());
+    }
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &line : lines)
+        {
+            auto *message = Communi::IrcMessage::fromData(line, nullptr);
+            benchmark::DoNotOptimize(message->tags());
+            delete message;
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(lines.size()));
+}
+
+BENCHMARK(BM_IrcMessageParsing);
+
+static void BM_TwitchIrcLineParsing(benchmark::State &state)
+{
+    std::vector<QByteArray> lines;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        lines.push_back(line.toUtf8());
+    }
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &line : lines)
+        {
+            auto parsed = TwitchIrcLine::parse(line);
+            benchmark::DoNotOptimize(parsed->hasTag(QLatin1String("room-id")));
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * int64_t(lines.size()));
+}
+
+BENCHMARK(BM_TwitchIrcLineParsing);
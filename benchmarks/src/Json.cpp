@@ -0,0 +1,77 @@
+#include "util/JsonDocument.hpp"
+
+#include "Allocations.hpp"
+
+#include <benchmark/benchmark.h>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// same shape as the chatter list of a big channel
+QByteArray makeChatters(int count)
+{
+    QByteArray json = R"({"chatter_count":)" + QByteArray::number(count) +
+                      R"(,"chatters":{"broadcaster":["forsen"],"viewers":[)";
+    for (int i = 0; i < count; i++)
+    {
+        if (i != 0)
+        {
+            json += ',';
+        }
+        json += "\"viewer_" + QByteArray::number(i) + '"';
+    }
+    json += "]}}";
+
+    return json;
+}
+
+}  // namespace
+
+static void BM_JsonChattersQJsonDocument(benchmark::State &state)
+{
+    auto json = makeChatters(int(state.range(0)));
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        std::vector<QString> names;
+        auto root = QJsonDocument::fromJson(json).object();
+        auto viewers =
+            root.value("chatters").toObject().value("viewers").toArray();
+        names.reserve(size_t(viewers.size()));
+        for (const auto &viewer : viewers)
+        {
+            names.push_back(viewer.toString());
+        }
+        benchmark::DoNotOptimize(names);
+    }
+}
+
+static void BM_JsonChattersInSitu(benchmark::State &state)
+{
+    auto json = makeChatters(int(state.range(0)));
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        std::vector<QString> names;
+        JsonDocument document(json);
+        const auto *chatters = rj::member(document.root(), "chatters");
+        const auto *viewers = rj::member(*chatters, "viewers");
+        names.reserve(viewers->Size());
+        for (const auto &viewer : viewers->GetArray())
+        {
+            names.push_back(rj::toString(viewer));
+        }
+        benchmark::DoNotOptimize(names);
+    }
+}
+
+BENCHMARK(BM_JsonChattersQJsonDocument)->Arg(1000)->Arg(50000);
+BENCHMARK(BM_JsonChattersInSitu)->Arg(1000)->Arg(50000);
@@ -0,0 +1,323 @@
+#include "messages/LimitedQueue.hpp"
+
+#include "Allocations.hpp"
+
+#include <benchmark/benchmark.h>
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// The chunk-vector based queue LimitedQueue used before it was turned into a
+// ring buffer, trimmed down to the operations that are benchmarked here.
+namespace legacy {
+
+    template <typename T>
+    class LimitedQueueSnapshot
+    {
+    public:
+        LimitedQueueSnapshot() = default;
+
+        LimitedQueueSnapshot(
+            std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>>
+                chunks,
+            size_t length, size_t firstChunkOffset)
+            : chunks_(chunks)
+            , length_(length)
+            , firstChunkOffset_(firstChunkOffset)
+        {
+        }
+
+        std::size_t size() const
+        {
+            return this->length_;
+        }
+
+        T const &operator[](std::size_t index) const
+        {
+            index += this->firstChunkOffset_;
+
+            size_t x = 0;
+
+            for (size_t i = 0; i < this->chunks_->size(); i++)
+            {
+                auto &chunk = this->chunks_->at(i);
+
+                if (x <= index && x + chunk->size() > index)
+                {
+                    return chunk->at(index - x);
+                }
+                x += chunk->size();
+            }
+
+            return this->chunks_->at(0)->at(0);
+        }
+
+    private:
+        std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> chunks_;
+
+        size_t length_ = 0;
+        size_t firstChunkOffset_ = 0;
+    };
+
+    template <typename T>
+    class LimitedQueue
+    {
+        using Chunk = std::vector<T>;
+        using ChunkVector = std::vector<std::shared_ptr<Chunk>>;
+
+    public:
+        LimitedQueue(size_t limit)
+            : limit_(limit)
+        {
+            this->chunks_ = std::make_shared<ChunkVector>();
+            auto chunk = std::make_shared<Chunk>();
+            chunk->resize(this->chunkSize_);
+            this->chunks_->push_back(chunk);
+        }
+
+        bool pushBack(const T &item, T &deleted)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            auto lastChunk = this->chunks_->back();
+
+            if (lastChunk->size() <= this->lastChunkEnd_)
+            {
+                auto newVector = std::make_shared<ChunkVector>();
+
+                for (auto &chunk : *this->chunks_)
+                {
+                    newVector->push_back(chunk);
+                }
+
+                auto newChunk = std::make_shared<Chunk>();
+                newChunk->resize(this->chunkSize_);
+                newVector->push_back(newChunk);
+
+                this->chunks_ = newVector;
+                this->lastChunkEnd_ = 0;
+                lastChunk = this->chunks_->back();
+            }
+
+            lastChunk->at(this->lastChunkEnd_++) = item;
+
+            return this->deleteFirstItem(deleted);
+        }
+
+        bool replaceItem(size_t index, const T &replacement)
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            size_t x = 0;
+
+            for (size_t i = 0; i < this->chunks_->size(); i++)
+            {
+                auto &chunk = this->chunks_->at(i);
+
+                size_t start = i == 0 ? this->firstChunkOffset_ : 0;
+                size_t end = i == chunk->size() - 1 ? this->lastChunkEnd_
+                                                    : chunk->size();
+
+                for (size_t j = start; j < end; j++)
+                {
+                    if (x == index)
+                    {
+                        auto newChunk = std::make_shared<Chunk>(*chunk);
+                        newChunk->at(j) = replacement;
+                        this->chunks_->at(i) = newChunk;
+
+                        return true;
+                    }
+                    x++;
+                }
+            }
+            return false;
+        }
+
+        LimitedQueueSnapshot<T> getSnapshot()
+        {
+            std::lock_guard<std::mutex> lock(this->mutex_);
+
+            return LimitedQueueSnapshot<T>(this->chunks_,
+                                           this->limit_ - this->space(),
+                                           this->firstChunkOffset_);
+        }
+
+    private:
+        size_t space() const
+        {
+            size_t totalSize = 0;
+            for (auto &chunk : *this->chunks_)
+            {
+                totalSize += chunk->size();
+            }
+
+            totalSize -= this->chunks_->back()->size() - this->lastChunkEnd_;
+            if (this->chunks_->size() != 1)
+            {
+                totalSize -= this->firstChunkOffset_;
+            }
+
+            return this->limit_ - totalSize;
+        }
+
+        bool deleteFirstItem(T &deleted)
+        {
+            if (space() > 0)
+            {
+                return false;
+            }
+
+            deleted = this->chunks_->front()->at(this->firstChunkOffset_);
+
+            if (this->firstChunkOffset_ == this->chunks_->front()->size() - 1)
+            {
+                auto newVector = std::make_shared<ChunkVector>();
+
+                bool first = true;
+                for (auto &chunk : *this->chunks_)
+                {
+                    if (!first)
+                    {
+                        newVector->push_back(chunk);
+                    }
+                    first = false;
+                }
+
+                this->chunks_ = newVector;
+                this->firstChunkOffset_ = 0;
+            }
+            else
+            {
+                this->firstChunkOffset_++;
+            }
+
+            return true;
+        }
+
+        std::shared_ptr<ChunkVector> chunks_;
+        std::mutex mutex_;
+
+        size_t firstChunkOffset_ = 0;
+        size_t lastChunkEnd_ = 0;
+        const size_t limit_;
+
+        const size_t chunkSize_ = 100;
+    };
+
+}  // namespace legacy
+
+using Item = std::shared_ptr<int>;
+
+template <typename Queue>
+void fill(Queue &queue, size_t count)
+{
+    Item deleted;
+    for (size_t i = 0; i < count; i++)
+    {
+        queue.pushBack(std::make_shared<int>(int(i)), deleted);
+    }
+}
+
+// Appending to a full queue while a view holds on to a snapshot, which is
+// what every ChannelView does for each incoming message
+template <typename Queue>
+void pushBackWithSnapshot(benchmark::State &state)
+{
+    const auto limit = size_t(state.range(0));
+    Queue queue(limit);
+    fill(queue, limit);
+
+    auto item = std::make_shared<int>(0);
+    Item deleted;
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        queue.pushBack(item, deleted);
+        auto snapshot = queue.getSnapshot();
+        benchmark::DoNotOptimize(snapshot);
+    }
+}
+
+// Reading the whole queue through a snapshot by index
+template <typename Queue>
+void snapshotIndexing(benchmark::State &state)
+{
+    const auto limit = size_t(state.range(0));
+    Queue queue(limit);
+    fill(queue, limit);
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        auto snapshot = queue.getSnapshot();
+        for (size_t i = 0; i < snapshot.size(); i++)
+        {
+            benchmark::DoNotOptimize(snapshot[i]);
+        }
+    }
+}
+
+// Replacing items in the middle of a full queue, e.g. for timeouts
+template <typename Queue>
+void replaceItem(benchmark::State &state)
+{
+    const auto limit = size_t(state.range(0));
+    Queue queue(limit);
+    fill(queue, limit);
+
+    auto item = std::make_shared<int>(0);
+    // keep a snapshot around so the first replacement has to copy
+    auto snapshot = queue.getSnapshot();
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        queue.replaceItem(limit / 2, item);
+    }
+}
+
+}  // namespace
+
+static void BM_LimitedQueue_PushBack(benchmark::State &state)
+{
+    pushBackWithSnapshot<LimitedQueue<Item>>(state);
+}
+
+static void BM_LegacyLimitedQueue_PushBack(benchmark::State &state)
+{
+    pushBackWithSnapshot<legacy::LimitedQueue<Item>>(state);
+}
+
+static void BM_LimitedQueue_SnapshotIndexing(benchmark::State &state)
+{
+    snapshotIndexing<LimitedQueue<Item>>(state);
+}
+
+static void BM_LegacyLimitedQueue_SnapshotIndexing(benchmark::State &state)
+{
+    snapshotIndexing<legacy::LimitedQueue<Item>>(state);
+}
+
+static void BM_LimitedQueue_ReplaceItem(benchmark::State &state)
+{
+    replaceItem<LimitedQueue<Item>>(state);
+}
+
+static void BM_LegacyLimitedQueue_ReplaceItem(benchmark::State &state)
+{
+    replaceItem<legacy::LimitedQueue<Item>>(state);
+}
+
+BENCHMARK(BM_LimitedQueue_PushBack)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_LegacyLimitedQueue_PushBack)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_LimitedQueue_SnapshotIndexing)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_LegacyLimitedQueue_SnapshotIndexing)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_LimitedQueue_ReplaceItem)->Arg(1000)->Arg(5000);
+BENCHMARK(BM_LegacyLimitedQueue_ReplaceItem)->Arg(1000)->Arg(5000);
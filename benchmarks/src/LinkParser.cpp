@@ -0,0 +1,40 @@
+#include "common/LinkParser.hpp"
+
+#include "Allocations.hpp"
+#include "Fixtures.hpp"
+
+#include <benchmark/benchmark.h>
+#include <IrcMessage>
+#include <QStringList>
+
+using namespace chatterino;
+
+static void BM_LinkParsing(benchmark::State &state)
+{
+    // the words of the messages, every one of them is checked for a link
+    QStringList words;
+    for (const auto &line : fixturePrivmsgs())
+    {
+        auto *message = Communi::IrcMessage::fromData(line.toUtf8(), nullptr);
+        words += message->parameter(1).split(' ', QString::SkipEmptyParts);
+        delete message;
+    }
+
+    // the tld list is loaded on the first use
+    LinkParser warmup("chatterino.com");
+    benchmark::DoNotOptimize(warmup.hasMatch());
+
+    ReportAllocations allocations(state);
+    for (auto _ : state)
+    {
+        for (const auto &word : words)
+        {
+            LinkParser parser(word);
+            benchmark::DoNotOptimize(parser.hasMatch());
+        }
+    }
+
+    state.SetItemsProcessed(state.iterations() * words.size());
+}
+
+BENCHMARK(BM_LinkParsing);
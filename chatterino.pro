@@ -40,6 +40,12 @@ useBreakpad {
     DEFINES += C_USE_BREAKPAD
 }
 
+# compresses PubSub with permessage-deflate, needs zlib
+usePubsubDeflate {
+    LIBS += -lz
+    DEFINES += CHATTERINO_PUBSUB_DEFLATE
+}
+
 # use C++17
 CONFIG += c++17
 
@@ -124,22 +130,29 @@ SOURCES += \
     src/BaseSettings.cpp \
     src/BaseTheme.cpp \
     src/BrowserExtension.cpp \
+    src/common/AggregateChannel.cpp \
     src/common/Args.cpp \
     src/common/Channel.cpp \
     src/common/ChannelChatters.cpp \
+    src/common/ChannelLoadScheduler.cpp \
+    src/common/ChannelProjection.cpp \
     src/common/ChatterinoSetting.cpp \
     src/common/ChatterSet.cpp \
+    src/common/CompletionIndex.cpp \
     src/common/CompletionModel.cpp \
     src/common/Credentials.cpp \
     src/common/DownloadManager.cpp \
     src/common/Env.cpp \
     src/common/LinkParser.cpp \
+    src/common/MembershipDeltas.cpp \
     src/common/Modes.cpp \
+    src/common/NetworkCache.cpp \
     src/common/NetworkCommon.cpp \
     src/common/NetworkManager.cpp \
     src/common/NetworkPrivate.cpp \
     src/common/NetworkRequest.cpp \
     src/common/NetworkResult.cpp \
+    src/common/NetworkScheduler.cpp \
     src/common/QLogging.cpp \
     src/common/Version.cpp \
     src/common/WindowDescriptors.cpp \
@@ -149,34 +162,50 @@ SOURCES += \
     src/controllers/commands/Command.cpp \
     src/controllers/commands/CommandController.cpp \
     src/controllers/commands/CommandModel.cpp \
+    src/controllers/commands/CommandTemplate.cpp \
     src/controllers/filters/FilterModel.cpp \
+    src/controllers/filters/parser/Context.cpp \
     src/controllers/filters/parser/FilterParser.cpp \
     src/controllers/filters/parser/Tokenizer.cpp \
     src/controllers/filters/parser/Types.cpp \
     src/controllers/highlights/BadgeHighlightModel.cpp \
     src/controllers/highlights/HighlightBadge.cpp \
+    src/controllers/highlights/HighlightBlacklistMatcher.cpp \
     src/controllers/highlights/HighlightBlacklistModel.cpp \
+    src/controllers/highlights/HighlightMatcher.cpp \
     src/controllers/highlights/HighlightModel.cpp \
     src/controllers/highlights/HighlightPhrase.cpp \
+    src/controllers/highlights/Rehighlight.cpp \
     src/controllers/highlights/UserHighlightModel.cpp \
     src/controllers/hotkeys/Hotkey.cpp \
     src/controllers/hotkeys/HotkeyController.cpp \
     src/controllers/hotkeys/HotkeyHelpers.cpp \
     src/controllers/hotkeys/HotkeyModel.cpp \
     src/controllers/ignores/IgnoreController.cpp \
+    src/controllers/ignores/IgnoreMatcher.cpp \
     src/controllers/ignores/IgnoreModel.cpp \
     src/controllers/moderationactions/ModerationAction.cpp \
     src/controllers/moderationactions/ModerationActionModel.cpp \
+    src/controllers/nicknames/NicknameMatcher.cpp \
     src/controllers/nicknames/NicknamesModel.cpp \
     src/controllers/notifications/NotificationController.cpp \
     src/controllers/notifications/NotificationModel.cpp \
     src/controllers/pings/MutedChannelModel.cpp \
     src/debug/Benchmark.cpp \
+    src/debug/EventLoopWatchdog.cpp \
+    src/debug/StartupProfiler.cpp \
+    src/debug/Trace.cpp \
     src/main.cpp \
     src/messages/Emote.cpp \
     src/messages/Image.cpp \
+    src/messages/ImageCache.cpp \
+    src/messages/ImageDecodePool.cpp \
+    src/messages/ImageLoadFailures.cpp \
     src/messages/ImageSet.cpp \
+    src/messages/MessageArena.cpp \
+    src/messages/MessageCodec.cpp \
     src/messages/layouts/MessageLayout.cpp \
+    src/messages/layouts/MessageLayoutBuffers.cpp \
     src/messages/layouts/MessageLayoutContainer.cpp \
     src/messages/layouts/MessageLayoutElement.cpp \
     src/messages/Link.cpp \
@@ -185,10 +214,14 @@ SOURCES += \
     src/messages/MessageColor.cpp \
     src/messages/MessageContainer.cpp \
     src/messages/MessageElement.cpp \
+    src/messages/layouts/ModerationButtonStrip.cpp \
+    src/messages/layouts/ScaledPixmaps.cpp \
+    src/messages/layouts/SharedMessageLayouts.cpp \
     src/messages/search/AuthorPredicate.cpp \
     src/messages/search/ChannelPredicate.cpp \
     src/messages/search/LinkPredicate.cpp \
     src/messages/search/MessageFlagsPredicate.cpp \
+    src/messages/search/MessageTokenIndex.cpp \
     src/messages/search/RegexPredicate.cpp \
     src/messages/search/SubstringPredicate.cpp \
     src/messages/SharedMessageBuilder.cpp \
@@ -200,6 +233,7 @@ SOURCES += \
     src/providers/ffz/FfzBadges.cpp \
     src/providers/ffz/FfzEmotes.cpp \
     src/providers/irc/AbstractIrcServer.cpp \
+    src/providers/irc/ConnectionLiveness.cpp \
     src/providers/irc/Irc2.cpp \
     src/providers/irc/IrcAccount.cpp \
     src/providers/irc/IrcChannel2.cpp \
@@ -209,6 +243,17 @@ SOURCES += \
     src/providers/irc/IrcServer.cpp \
     src/providers/IvrApi.cpp \
     src/providers/LinkResolver.cpp \
+    src/providers/irc/JoinQueue.cpp \
+    src/providers/twitch/ChannelEmoteIndex.cpp \
+    src/providers/twitch/HeadlessChannels.cpp \
+    src/providers/twitch/HistorySpill.cpp \
+    src/providers/twitch/IrcReplay.cpp \
+    src/providers/twitch/LiveStatusService.cpp \
+    src/providers/twitch/MessageSendQueue.cpp \
+    src/providers/twitch/PendingRedemptions.cpp \
+    src/providers/twitch/SyntheticLoad.cpp \
+    src/providers/twitch/TwitchIrcLine.cpp \
+    src/providers/twitch/TwitchTags.cpp \
     src/providers/twitch/api/Helix.cpp \
     src/providers/twitch/ChannelPointReward.cpp \
     src/providers/twitch/IrcMessageHandler.cpp \
@@ -226,10 +271,15 @@ SOURCES += \
     src/providers/twitch/TwitchMessageBuilder.cpp \
     src/providers/twitch/TwitchUser.cpp \
     src/RunGui.cpp \
+    src/providers/twitch/api/HelixBatcher.cpp \
     src/singletons/Badges.cpp \
     src/singletons/Emotes.cpp \
     src/singletons/Fonts.cpp \
+    src/singletons/MetricsExporter.cpp \
+    src/singletons/helper/CompressedLog.cpp \
     src/singletons/helper/GifTimer.cpp \
+    src/singletons/helper/HighlightNotifier.cpp \
+    src/singletons/helper/LogWriter.cpp \
     src/singletons/helper/LoggingChannel.cpp \
     src/singletons/Logging.cpp \
     src/singletons/NativeMessaging.cpp \
@@ -241,23 +291,39 @@ SOURCES += \
     src/singletons/TooltipPreviewImage.cpp \
     src/singletons/Updates.cpp \
     src/singletons/WindowManager.cpp \
+    src/singletons/helper/ToastQueue.cpp \
+    src/util/AhoCorasick.cpp \
     src/util/AttachToConsole.cpp \
+    src/util/CaseInsensitive.cpp \
+    src/util/ChannelCosts.cpp \
     src/util/Clipboard.cpp \
+    src/util/CombinedRegex.cpp \
     src/util/DebugCount.cpp \
     src/util/DisplayBadge.cpp \
     src/util/FormatTime.cpp \
+    src/util/FrameScheduler.cpp \
     src/util/FunctionEventFilter.cpp \
     src/util/FuzzyConvert.cpp \
+    src/util/GuiTaskQueue.cpp \
     src/util/Helpers.cpp \
+    src/util/Hotness.cpp \
     src/util/IncognitoBrowser.cpp \
     src/util/InitUpdateButton.cpp \
+    src/util/JsonDocument.cpp \
     src/util/LayoutHelper.cpp \
+    src/util/LazyPixmap.cpp \
+    src/util/MemoryUsage.cpp \
     src/util/NuulsUploader.cpp \
+    src/util/OrderedWorkQueue.cpp \
     src/util/RapidjsonHelpers.cpp \
     src/util/RatelimitBucket.cpp \
+    src/util/SettingsWriter.cpp \
+    src/util/SharedRingBuffer.cpp \
+    src/util/Similarity.cpp \
     src/util/SplitCommand.cpp \
     src/util/StreamerMode.cpp \
     src/util/StreamLink.cpp \
+    src/util/StringPool.cpp \
     src/util/Twitch.cpp \
     src/util/WindowsHelper.cpp \
     src/widgets/AccountSwitchPopup.cpp \
@@ -289,11 +355,13 @@ SOURCES += \
     src/widgets/FramelessEmbedWindow.cpp \
     src/widgets/helper/Button.cpp \
     src/widgets/helper/ChannelView.cpp \
+    src/widgets/helper/ChannelViewSurface.cpp \
     src/widgets/helper/ColorButton.cpp \
     src/widgets/helper/ComboBoxItemDelegate.cpp \
     src/widgets/helper/DebugPopup.cpp \
     src/widgets/helper/EditableModelView.cpp \
     src/widgets/helper/EffectLabel.cpp \
+    src/widgets/helper/EmoteGrid.cpp \
     src/widgets/helper/NotebookButton.cpp \
     src/widgets/helper/NotebookTab.cpp \
     src/widgets/helper/QColorPicker.cpp \
@@ -342,28 +410,34 @@ HEADERS += \
     src/BaseSettings.hpp \
     src/BaseTheme.hpp \
     src/BrowserExtension.hpp \
+    src/common/AggregateChannel.hpp \
     src/common/Aliases.hpp \
     src/common/Args.hpp \
     src/common/Atomic.hpp \
     src/common/Channel.hpp \
     src/common/ChannelChatters.hpp \
+    src/common/ChannelLoadScheduler.hpp \
+    src/common/ChannelProjection.hpp \
     src/common/ChatterinoSetting.hpp \
     src/common/ChatterSet.hpp \
     src/common/Common.hpp \
+    src/common/CompletionIndex.hpp \
     src/common/CompletionModel.hpp \
-    src/common/ConcurrentMap.hpp \
     src/common/Credentials.hpp \
     src/common/DownloadManager.hpp \
     src/common/Env.hpp \
     src/common/FlagsEnum.hpp \
     src/common/IrcColors.hpp \
     src/common/LinkParser.hpp \
+    src/common/MembershipDeltas.hpp \
     src/common/Modes.hpp \
+    src/common/NetworkCache.hpp \
     src/common/NetworkCommon.hpp \
     src/common/NetworkManager.hpp \
     src/common/NetworkPrivate.hpp \
     src/common/NetworkRequest.hpp \
     src/common/NetworkResult.hpp \
+    src/common/NetworkScheduler.hpp \
     src/common/NullablePtr.hpp \
     src/common/Outcome.hpp \
     src/common/ProviderId.hpp \
@@ -380,18 +454,23 @@ HEADERS += \
     src/controllers/commands/Command.hpp \
     src/controllers/commands/CommandController.hpp \
     src/controllers/commands/CommandModel.hpp \
+    src/controllers/commands/CommandTemplate.hpp \
     src/controllers/filters/FilterModel.hpp \
     src/controllers/filters/FilterRecord.hpp \
     src/controllers/filters/FilterSet.hpp \
+    src/controllers/filters/parser/Context.hpp \
     src/controllers/filters/parser/FilterParser.hpp \
     src/controllers/filters/parser/Tokenizer.hpp \
     src/controllers/filters/parser/Types.hpp \
     src/controllers/highlights/BadgeHighlightModel.hpp \
     src/controllers/highlights/HighlightBadge.hpp \
+    src/controllers/highlights/HighlightBlacklistMatcher.hpp \
     src/controllers/highlights/HighlightBlacklistModel.hpp \
     src/controllers/highlights/HighlightBlacklistUser.hpp \
+    src/controllers/highlights/HighlightMatcher.hpp \
     src/controllers/highlights/HighlightModel.hpp \
     src/controllers/highlights/HighlightPhrase.hpp \
+    src/controllers/highlights/Rehighlight.hpp \
     src/controllers/highlights/UserHighlightModel.hpp \
     src/controllers/hotkeys/ActionNames.hpp \
     src/controllers/hotkeys/Hotkey.hpp \
@@ -400,22 +479,34 @@ HEADERS += \
     src/controllers/hotkeys/HotkeyHelpers.hpp \
     src/controllers/hotkeys/HotkeyModel.hpp \
     src/controllers/ignores/IgnoreController.hpp \
+    src/controllers/ignores/IgnoreMatcher.hpp \
     src/controllers/ignores/IgnoreModel.hpp \
     src/controllers/ignores/IgnorePhrase.hpp \
     src/controllers/moderationactions/ModerationAction.hpp \
     src/controllers/moderationactions/ModerationActionModel.hpp \
     src/controllers/nicknames/Nickname.hpp \
+    src/controllers/nicknames/NicknameMatcher.hpp \
     src/controllers/nicknames/NicknamesModel.hpp \
     src/controllers/notifications/NotificationController.hpp \
     src/controllers/notifications/NotificationModel.hpp \
     src/controllers/pings/MutedChannelModel.hpp \
+    src/debug/AllocationCounter.hpp \
     src/debug/AssertInGuiThread.hpp \
     src/debug/Benchmark.hpp \
     src/ForwardDecl.hpp \
+    src/debug/EventLoopWatchdog.hpp \
+    src/debug/StartupProfiler.hpp \
+    src/debug/Trace.hpp \
     src/messages/Emote.hpp \
     src/messages/Image.hpp \
+    src/messages/ImageCache.hpp \
+    src/messages/ImageDecodePool.hpp \
+    src/messages/ImageLoadFailures.hpp \
     src/messages/ImageSet.hpp \
+    src/messages/MessageArena.hpp \
+    src/messages/MessageCodec.hpp \
     src/messages/layouts/MessageLayout.hpp \
+    src/messages/layouts/MessageLayoutBuffers.hpp \
     src/messages/layouts/MessageLayoutContainer.hpp \
     src/messages/layouts/MessageLayoutElement.hpp \
     src/messages/LimitedQueue.hpp \
@@ -427,11 +518,15 @@ HEADERS += \
     src/messages/MessageContainer.hpp \
     src/messages/MessageElement.hpp \
     src/messages/MessageParseArgs.hpp \
+    src/messages/layouts/ModerationButtonStrip.hpp \
+    src/messages/layouts/ScaledPixmaps.hpp \
+    src/messages/layouts/SharedMessageLayouts.hpp \
     src/messages/search/AuthorPredicate.hpp \
     src/messages/search/ChannelPredicate.hpp \
     src/messages/search/LinkPredicate.hpp \
     src/messages/search/MessageFlagsPredicate.hpp \
     src/messages/search/MessagePredicate.hpp \
+    src/messages/search/MessageTokenIndex.hpp \
     src/messages/search/SubstringPredicate.hpp \
     src/messages/Selection.hpp \
     src/messages/SharedMessageBuilder.hpp \
@@ -444,6 +539,7 @@ HEADERS += \
     src/providers/ffz/FfzBadges.hpp \
     src/providers/ffz/FfzEmotes.hpp \
     src/providers/irc/AbstractIrcServer.hpp \
+    src/providers/irc/ConnectionLiveness.hpp \
     src/providers/irc/Irc2.hpp \
     src/providers/irc/IrcAccount.hpp \
     src/providers/irc/IrcChannel2.hpp \
@@ -453,6 +549,17 @@ HEADERS += \
     src/providers/irc/IrcServer.hpp \
     src/providers/IvrApi.hpp \
     src/providers/LinkResolver.hpp \
+    src/providers/irc/JoinQueue.hpp \
+    src/providers/twitch/ChannelEmoteIndex.hpp \
+    src/providers/twitch/HeadlessChannels.hpp \
+    src/providers/twitch/HistorySpill.hpp \
+    src/providers/twitch/IrcReplay.hpp \
+    src/providers/twitch/LiveStatusService.hpp \
+    src/providers/twitch/MessageSendQueue.hpp \
+    src/providers/twitch/PendingRedemptions.hpp \
+    src/providers/twitch/SyntheticLoad.hpp \
+    src/providers/twitch/TwitchIrcLine.hpp \
+    src/providers/twitch/TwitchTags.hpp \
     src/providers/twitch/api/Helix.hpp \
     src/providers/twitch/ChannelPointReward.hpp \
     src/providers/twitch/ChatterinoWebSocketppLogger.hpp \
@@ -473,10 +580,15 @@ HEADERS += \
     src/providers/twitch/TwitchMessageBuilder.hpp \
     src/providers/twitch/TwitchUser.hpp \
     src/RunGui.hpp \
+    src/providers/twitch/api/HelixBatcher.hpp \
     src/singletons/Badges.hpp \
     src/singletons/Emotes.hpp \
     src/singletons/Fonts.hpp \
+    src/singletons/MetricsExporter.hpp \
+    src/singletons/helper/CompressedLog.hpp \
     src/singletons/helper/GifTimer.hpp \
+    src/singletons/helper/HighlightNotifier.hpp \
+    src/singletons/helper/LogWriter.hpp \
     src/singletons/helper/LoggingChannel.hpp \
     src/singletons/Logging.hpp \
     src/singletons/NativeMessaging.hpp \
@@ -488,31 +600,49 @@ HEADERS += \
     src/singletons/TooltipPreviewImage.hpp \
     src/singletons/Updates.hpp \
     src/singletons/WindowManager.hpp \
+    src/singletons/helper/ToastQueue.hpp \
+    src/util/AhoCorasick.hpp \
     src/util/AttachToConsole.hpp \
+    src/util/CaseInsensitive.hpp \
+    src/util/ChannelCosts.hpp \
     src/util/Clamp.hpp \
     src/util/Clipboard.hpp \
     src/util/CombinePath.hpp \
+    src/util/CombinedRegex.hpp \
     src/util/ConcurrentMap.hpp \
     src/util/DebugCount.hpp \
     src/util/DisplayBadge.hpp \
     src/util/DistanceBetweenPoints.hpp \
     src/util/ExponentialBackoff.hpp \
     src/util/FormatTime.hpp \
+    src/util/FrameScheduler.hpp \
     src/util/FunctionEventFilter.hpp \
     src/util/FuzzyConvert.hpp \
+    src/util/GuiTaskQueue.hpp \
     src/util/Helpers.hpp \
+    src/util/Hotness.hpp \
     src/util/IncognitoBrowser.hpp \
     src/util/InitUpdateButton.hpp \
     src/util/IrcHelpers.hpp \
     src/util/IsBigEndian.hpp \
+    src/util/JsonDocument.hpp \
     src/util/LayoutCreator.hpp \
     src/util/LayoutHelper.hpp \
+    src/util/LazyPixmap.hpp \
+    src/util/MemoryUsage.hpp \
     src/util/NuulsUploader.hpp \
+    src/util/OrderedWorkQueue.hpp \
     src/util/Overloaded.hpp \
     src/util/PersistSignalVector.hpp \
+    src/util/PoolAllocator.hpp \
     src/util/PostToThread.hpp \
     src/util/QObjectRef.hpp \
     src/util/QStringHash.hpp \
+    src/util/SettingsWriter.hpp \
+    src/util/SharedRingBuffer.hpp \
+    src/util/Similarity.hpp \
+    src/util/StringPool.hpp \
+    src/util/WeakCache.hpp \
     src/util/rangealgorithm.hpp \
     src/util/RapidjsonHelpers.hpp \
     src/util/RapidJsonSerializeQString.hpp \
@@ -557,12 +687,14 @@ HEADERS += \
     src/widgets/FramelessEmbedWindow.hpp \
     src/widgets/helper/Button.hpp \
     src/widgets/helper/ChannelView.hpp \
+    src/widgets/helper/ChannelViewSurface.hpp \
     src/widgets/helper/ColorButton.hpp \
     src/widgets/helper/ComboBoxItemDelegate.hpp \
     src/widgets/helper/CommonTexts.hpp \
     src/widgets/helper/DebugPopup.hpp \
     src/widgets/helper/EditableModelView.hpp \
     src/widgets/helper/EffectLabel.hpp \
+    src/widgets/helper/EmoteGrid.hpp \
     src/widgets/helper/Line.hpp \
     src/widgets/helper/NotebookButton.hpp \
     src/widgets/helper/NotebookTab.hpp \
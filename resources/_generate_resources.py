@@ -7,8 +7,8 @@ resources_footer = \
 </RCC>'''
 
 header_header = \
-'''#include <QPixmap>
-#include "common/Singleton.hpp"
+'''#include "common/Singleton.hpp"
+#include "util/LazyPixmap.hpp"
 
 namespace chatterino {
 
@@ -29,11 +29,9 @@ source_header = \
 
 namespace chatterino {
 
-Resources2::Resources2()
-{
+Resources2::Resources2() = default;
 '''
 
 source_footer = \
-'''}
-
+'''
 }  // namespace chatterino'''
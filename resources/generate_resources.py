@@ -4,7 +4,9 @@ from pathlib import Path
 from _generate_resources import *
 
 ignored_files = ['qt.conf', 'resources.qrc', 'resources_autogenerated.qrc', 'windows.rc',
-        'generate_resources.py', '_generate_resources.py']
+        'generate_resources.py', '_generate_resources.py',
+        # emoji.bin is generated from emoji.json and listed in resources.qrc
+        'emoji.json', 'emoji.bin']
 
 ignored_names = ['.gitignore', '.DS_Store']
 
@@ -33,10 +35,6 @@ with open('./resources_autogenerated.qrc', 'w') as out:
 
 with open('../src/autogenerated/ResourcesAutogen.cpp', 'w') as out:
     out.write(source_header)
-    for file in sorted(image_files):
-        var_name = file.with_suffix("").as_posix().replace("/",".")
-        out.write(f'    this->{var_name}')
-        out.write(f' = QPixmap(":/{file.as_posix()}");\n')
     out.write(source_footer)
 
 def writeHeader(out, name, element, indent):
@@ -48,7 +46,8 @@ def writeHeader(out, name, element, indent):
         if name != "":
             out.write(f"{indent}}} {name};\n");
     else:
-        out.write(f"{indent}QPixmap {element};\n")
+        # pixmaps are only decoded when they're first used
+        out.write(f'{indent}LazyPixmap {name}{{":/{element.as_posix()}"}};\n')
 
 with open('../src/autogenerated/ResourcesAutogen.hpp', 'w') as out:
     out.write(header_header)
@@ -62,7 +61,7 @@ with open('../src/autogenerated/ResourcesAutogen.hpp', 'w') as out:
             if directory not in elements_ref:
                 elements_ref[directory] = {}
             elements_ref = elements_ref[directory]
-        elements_ref[filename] = filename
+        elements_ref[filename] = file
 
     writeHeader(out, "", elements, '')
 
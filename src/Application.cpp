@@ -7,10 +7,12 @@
 #include "common/Version.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/commands/CommandController.hpp"
+#include "controllers/highlights/Rehighlight.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
 #include "controllers/ignores/IgnoreController.hpp"
 #include "controllers/notifications/NotificationController.hpp"
 #include "debug/AssertInGuiThread.hpp"
+#include "debug/StartupProfiler.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/bttv/BttvEmotes.hpp"
 #include "providers/chatterino/ChatterinoBadges.hpp"
@@ -23,6 +25,7 @@
 #include "singletons/Emotes.hpp"
 #include "singletons/Fonts.hpp"
 #include "singletons/Logging.hpp"
+#include "singletons/MetricsExporter.hpp"
 #include "singletons/NativeMessaging.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Resources.hpp"
@@ -31,6 +34,7 @@
 #include "singletons/Toasts.hpp"
 #include "singletons/Updates.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/FunctionEventFilter.hpp"
 #include "util/IsBigEndian.hpp"
 #include "util/PostToThread.hpp"
 #include "util/RapidjsonHelpers.hpp"
@@ -39,9 +43,25 @@
 #include "widgets/splits/Split.hpp"
 
 #include <QDesktopServices>
+#include <QTimer>
+#include <QtConcurrent>
+#include <boost/core/demangle.hpp>
+
+#include <typeinfo>
 
 namespace chatterino {
 
+namespace {
+
+    QString singletonName(const Singleton &singleton)
+    {
+        return QString::fromStdString(
+                   boost::core::demangle(typeid(singleton).name()))
+            .remove("chatterino::");
+    }
+
+}  // namespace
+
 static std::atomic<bool> isAppInitialized{false};
 
 Application *Application::instance = nullptr;
@@ -64,6 +84,7 @@ Application::Application(Settings &_settings, Paths &_paths)
     , twitch(&this->emplace<TwitchIrcServer>())
     , chatterinoBadges(&this->emplace<ChatterinoBadges>())
     , ffzBadges(&this->emplace<FfzBadges>())
+    , metrics(&this->emplace<MetricsExporter>())
     , logging(&this->emplace<Logging>())
 {
     this->instance = this;
@@ -78,8 +99,21 @@ void Application::initialize(Settings &settings, Paths &paths)
     assert(isAppInitialized == false);
     isAppInitialized = true;
 
+    StartupProfiler::Phase phase("initialize application");
+
+    // the loads are independent, each initialize only waits for the load of
+    // its own singleton
+    std::vector<QFuture<void>> loads;
+    for (auto &singleton : this->singletons_)
+    {
+        loads.push_back(
+            QtConcurrent::run([singleton = singleton.get(), &paths] {
+                singleton->load(paths);
+            }));
+    }
+
     // Show changelog
-    if (!getArgs().isFramelessEmbed &&
+    if (!getArgs().isFramelessEmbed && !getArgs().headless &&
         getSettings()->currentVersion.getValue() != "" &&
         getSettings()->currentVersion.getValue() != CHATTERINO_VERSION)
     {
@@ -104,13 +138,18 @@ void Application::initialize(Settings &settings, Paths &paths)
         }
     }
 
-    for (auto &singleton : this->singletons_)
+    for (size_t i = 0; i < this->singletons_.size(); i++)
     {
+        auto &singleton = this->singletons_[i];
+        StartupProfiler::Phase singletonPhase(singletonName(*singleton));
+
+        loads[i].waitForFinished();
         singleton->initialize(settings, paths);
     }
 
     // add crash message
-    if (!getArgs().isFramelessEmbed && getArgs().crashRecovery)
+    if (!getArgs().isFramelessEmbed && !getArgs().headless &&
+        getArgs().crashRecovery)
     {
         if (auto selected =
                 this->windows->getMainWindow().getNotebook().getSelectedPage())
@@ -133,7 +172,7 @@ void Application::initialize(Settings &settings, Paths &paths)
 
     this->windows->updateWordTypeMask();
 
-    if (!getArgs().isFramelessEmbed)
+    if (!getArgs().isFramelessEmbed && !getArgs().headless)
     {
         this->initNm(paths);
     }
@@ -146,9 +185,31 @@ int Application::run(QApplication &qtApp)
 
     this->twitch->connect();
 
-    if (!getArgs().isFramelessEmbed)
+    if (!getArgs().isFramelessEmbed && !getArgs().headless)
     {
-        this->windows->getMainWindow().show();
+        auto &window = this->windows->getMainWindow();
+        window.show();
+
+        // the startup ends once the window and its children are painted
+        window.installEventFilter(new FunctionEventFilter(
+            &window, [](QObject *, QEvent *event) {
+                if (event->type() == QEvent::Paint &&
+                    !StartupProfiler::instance().isFinished())
+                {
+                    QTimer::singleShot(0, [] {
+                        auto &profiler = StartupProfiler::instance();
+                        profiler.step("show window until first paint");
+                        profiler.finish(getPaths()->miscDirectory +
+                                        "/startup.txt");
+                    });
+                }
+                return false;
+            }));
+    }
+    else
+    {
+        StartupProfiler::instance().finish(getPaths()->miscDirectory +
+                                           "/startup.txt");
     }
 
     getSettings()->betaUpdates.connect(
@@ -160,12 +221,21 @@ int Application::run(QApplication &qtApp)
         this->windows->forceLayoutChannelViews();
     });
 
-    getSettings()->highlightedMessages.delayedItemsChanged.connect([this] {
-        this->windows->forceLayoutChannelViews();
-    });
-    getSettings()->highlightedUsers.delayedItemsChanged.connect([this] {
-        this->windows->forceLayoutChannelViews();
-    });
+    // messages that are already in the channels are checked against the
+    // changed rules in the background
+    auto rehighlight = [this] {
+        std::vector<ChannelPtr> channels;
+        this->twitch->forEachChannel([&](ChannelPtr channel) {
+            channels.push_back(std::move(channel));
+        });
+        channels.push_back(this->twitch->whispersChannel);
+        rehighlightMessages(channels);
+    };
+    getSettings()->highlightedMessages.delayedItemsChanged.connect(
+        rehighlight);
+    getSettings()->highlightedUsers.delayedItemsChanged.connect(rehighlight);
+    getSettings()->highlightedBadges.delayedItemsChanged.connect(rehighlight);
+    getSettings()->enableSelfHighlight.connect(rehighlight, false);
 
     getSettings()->removeSpacesBetweenEmotes.connect([this] {
         this->windows->forceLayoutChannelViews();
@@ -292,14 +362,13 @@ void Application::initPubsub()
                 auto replaced = false;
                 LimitedQueueSnapshot<MessagePtr> snapshot =
                     chan->getMessageSnapshot();
-                int snapshotLength = snapshot.size();
-
                 // without parens it doesn't build on windows
-                int end = (std::max)(0, snapshotLength - 200);
+                auto searched = (std::min)(snapshot.size(), size_t(200));
+                auto end = snapshot.rbegin() + std::ptrdiff_t(searched);
 
-                for (int i = snapshotLength - 1; i >= end; --i)
+                for (auto it = snapshot.rbegin(); it != end; ++it)
                 {
-                    auto &s = snapshot[i];
+                    const auto &s = *it;
                     if (!s->flags.has(MessageFlag::PubSub) &&
                         s->timeoutUser == msg->timeoutUser)
                     {
@@ -358,10 +427,11 @@ void Application::initPubsub()
 
             auto msg = MessageBuilder(action).release();
 
+            // deleting notifies the views, so it's done on the gui thread
             postToThread([chan, msg] {
+                chan->deleteMessage(msg->id);
                 chan->addMessage(msg);
             });
-            chan->deleteMessage(msg->id);
         });
 
     this->twitch->pubsub->signals_.moderation.automodInfoMessage.connect(
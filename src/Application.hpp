@@ -28,6 +28,7 @@ class Fonts;
 class Toasts;
 class ChatterinoBadges;
 class FfzBadges;
+class MetricsExporter;
 
 class Application
 {
@@ -61,6 +62,7 @@ public:
     TwitchIrcServer *const twitch{};
     ChatterinoBadges *const chatterinoBadges{};
     FfzBadges *const ffzBadges{};
+    MetricsExporter *const metrics{};
 
     /*[[deprecated]]*/ Logging *const logging{};
 
@@ -13,11 +13,18 @@
 #include "common/Modes.hpp"
 #include "common/NetworkManager.hpp"
 #include "common/QLogging.hpp"
+#include "debug/EventLoopWatchdog.hpp"
+#include "debug/StartupProfiler.hpp"
+#include "debug/Trace.hpp"
+#include "providers/twitch/HeadlessChannels.hpp"
+#include "providers/twitch/SyntheticLoad.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Updates.hpp"
 #include "util/CombinePath.hpp"
+#include "util/SettingsWriter.hpp"
 #include "widgets/dialogs/LastRunCrashDialog.hpp"
 
 #ifdef USEWINSDK
@@ -184,6 +191,33 @@ namespace {
         }
         qCDebug(chatterinoCache) << "Deleted" << deletedCount << "files";
     }
+
+    // Starts the load of --load-test once the channels had some time to join
+    void scheduleLoadTest(const QStringList &options)
+    {
+        SyntheticLoad load;
+        auto error = load.parse(options);
+        if (!error.isEmpty())
+        {
+            qCWarning(chatterinoArgs) << "--load-test:" << error;
+            return;
+        }
+
+        QTimer::singleShot(15 * 1000, [load] {
+            std::vector<ChannelPtr> channels;
+            getApp()->twitch->forEachChannel([&](ChannelPtr channel) {
+                channels.push_back(std::move(channel));
+            });
+
+            auto error = startSyntheticLoad(load, channels, [](auto &stats) {
+                qCInfo(chatterinoApp) << stats.summary();
+            });
+            if (!error.isEmpty())
+            {
+                qCWarning(chatterinoApp) << "--load-test:" << error;
+            }
+        });
+    }
 }  // namespace
 
 void runGui(QApplication &a, Paths &paths, Settings &settings)
@@ -192,6 +226,11 @@ void runGui(QApplication &a, Paths &paths, Settings &settings)
     initResources();
     initSignalHandler();
 
+    if (getArgs().traceFile)
+    {
+        Tracer::instance().enable();
+    }
+
     settings.restartOnCrash.connect([](const bool &value) {
         restartOnSignal = value;
     });
@@ -221,7 +260,9 @@ void runGui(QApplication &a, Paths &paths, Settings &settings)
     });
 
     chatterino::NetworkManager::init();
+    chatterino::NetworkManager::warmUp();
     chatterino::Updates::instance().checkForUpdates();
+    StartupProfiler::instance().step("initialize Qt, resources and network");
 
 #ifdef C_USE_BREAKPAD
     QBreakpadInstance.setDumpPath(getPaths()->settingsFolderPath + "/Crashes");
@@ -240,20 +281,52 @@ void runGui(QApplication &a, Paths &paths, Settings &settings)
         createRunningFile(runningPath);
     }
 
+    if (settings.eventLoopWatchdog)
+    {
+        EventLoopWatchdog::instance().start(
+            std::chrono::milliseconds(
+                std::max(settings.eventLoopWatchdogDeadline.getValue(), 1)),
+            combinePath(paths.miscDirectory, "stalls.log"));
+    }
+
+    StartupProfiler::instance().step("check the last run");
+
     Application app(settings, paths);
+    StartupProfiler::instance().step("create singletons");
     app.initialize(settings, paths);
+    // joined instead of the channels of the window layout, which isn't loaded
+    std::unique_ptr<HeadlessChannels> headlessChannels;
+    if (getArgs().headless)
+    {
+        headlessChannels = std::make_unique<HeadlessChannels>(
+            getArgs().headlessChannelsFile);
+    }
+    if (getArgs().loadTest)
+    {
+        scheduleLoadTest(*getArgs().loadTest);
+    }
     app.run(a);
     app.save();
 
+    EventLoopWatchdog::instance().stop();
+
     removeRunningFile(runningPath);
 
     if (!getArgs().dontSaveSettings)
     {
+        // settings.json is written here anyway, the files that were queued
+        // (lists, commands) are written right away
+        SettingsWriter::instance().flush();
         pajlada::Settings::SettingManager::gSave();
     }
 
     chatterino::NetworkManager::deinit();
 
+    if (getArgs().traceFile)
+    {
+        Tracer::instance().write(*getArgs().traceFile);
+    }
+
 #ifdef USEWINSDK
     // flushing windows clipboard to keep copied messages
     flushClipboard();
@@ -2,71 +2,6 @@
 
 namespace chatterino {
 
-Resources2::Resources2()
-{
-    this->avatars._1xelerate = QPixmap(":/avatars/_1xelerate.png");
-    this->avatars.alazymeme = QPixmap(":/avatars/alazymeme.png");
-    this->avatars.brian6932 = QPixmap(":/avatars/brian6932.png");
-    this->avatars.fourtf = QPixmap(":/avatars/fourtf.png");
-    this->avatars.hicupalot = QPixmap(":/avatars/hicupalot.png");
-    this->avatars.iprodigy = QPixmap(":/avatars/iprodigy.png");
-    this->avatars.kararty = QPixmap(":/avatars/kararty.png");
-    this->avatars.karlpolice = QPixmap(":/avatars/karlpolice.png");
-    this->avatars.mm2pl = QPixmap(":/avatars/mm2pl.png");
-    this->avatars.pajlada = QPixmap(":/avatars/pajlada.png");
-    this->avatars.slch = QPixmap(":/avatars/slch.png");
-    this->avatars.xheaveny = QPixmap(":/avatars/xheaveny.png");
-    this->avatars.zneix = QPixmap(":/avatars/zneix.png");
-    this->buttons.addSplit = QPixmap(":/buttons/addSplit.png");
-    this->buttons.addSplitDark = QPixmap(":/buttons/addSplitDark.png");
-    this->buttons.ban = QPixmap(":/buttons/ban.png");
-    this->buttons.banRed = QPixmap(":/buttons/banRed.png");
-    this->buttons.clearSearch = QPixmap(":/buttons/clearSearch.png");
-    this->buttons.copyDark = QPixmap(":/buttons/copyDark.png");
-    this->buttons.copyLight = QPixmap(":/buttons/copyLight.png");
-    this->buttons.menuDark = QPixmap(":/buttons/menuDark.png");
-    this->buttons.menuLight = QPixmap(":/buttons/menuLight.png");
-    this->buttons.mod = QPixmap(":/buttons/mod.png");
-    this->buttons.modModeDisabled = QPixmap(":/buttons/modModeDisabled.png");
-    this->buttons.modModeDisabled2 = QPixmap(":/buttons/modModeDisabled2.png");
-    this->buttons.modModeEnabled = QPixmap(":/buttons/modModeEnabled.png");
-    this->buttons.modModeEnabled2 = QPixmap(":/buttons/modModeEnabled2.png");
-    this->buttons.search = QPixmap(":/buttons/search.png");
-    this->buttons.timeout = QPixmap(":/buttons/timeout.png");
-    this->buttons.trashCan = QPixmap(":/buttons/trashCan.png");
-    this->buttons.unban = QPixmap(":/buttons/unban.png");
-    this->buttons.unmod = QPixmap(":/buttons/unmod.png");
-    this->buttons.unvip = QPixmap(":/buttons/unvip.png");
-    this->buttons.update = QPixmap(":/buttons/update.png");
-    this->buttons.updateError = QPixmap(":/buttons/updateError.png");
-    this->buttons.viewersDark = QPixmap(":/buttons/viewersDark.png");
-    this->buttons.viewersLight = QPixmap(":/buttons/viewersLight.png");
-    this->buttons.vip = QPixmap(":/buttons/vip.png");
-    this->error = QPixmap(":/error.png");
-    this->icon = QPixmap(":/icon.png");
-    this->pajaDank = QPixmap(":/pajaDank.png");
-    this->scrolling.downScroll = QPixmap(":/scrolling/downScroll.png");
-    this->scrolling.neutralScroll = QPixmap(":/scrolling/neutralScroll.png");
-    this->scrolling.upScroll = QPixmap(":/scrolling/upScroll.png");
-    this->settings.aboutlogo = QPixmap(":/settings/aboutlogo.png");
-    this->split.down = QPixmap(":/split/down.png");
-    this->split.left = QPixmap(":/split/left.png");
-    this->split.move = QPixmap(":/split/move.png");
-    this->split.right = QPixmap(":/split/right.png");
-    this->split.up = QPixmap(":/split/up.png");
-    this->streamerMode = QPixmap(":/streamerMode.png");
-    this->twitch.admin = QPixmap(":/twitch/admin.png");
-    this->twitch.automod = QPixmap(":/twitch/automod.png");
-    this->twitch.broadcaster = QPixmap(":/twitch/broadcaster.png");
-    this->twitch.cheer1 = QPixmap(":/twitch/cheer1.png");
-    this->twitch.globalmod = QPixmap(":/twitch/globalmod.png");
-    this->twitch.moderator = QPixmap(":/twitch/moderator.png");
-    this->twitch.prime = QPixmap(":/twitch/prime.png");
-    this->twitch.staff = QPixmap(":/twitch/staff.png");
-    this->twitch.subscriber = QPixmap(":/twitch/subscriber.png");
-    this->twitch.turbo = QPixmap(":/twitch/turbo.png");
-    this->twitch.verified = QPixmap(":/twitch/verified.png");
-    this->twitch.vip = QPixmap(":/twitch/vip.png");
-}
+Resources2::Resources2() = default;
 
 }  // namespace chatterino
@@ -1,5 +1,5 @@
-#include <QPixmap>
 #include "common/Singleton.hpp"
+#include "util/LazyPixmap.hpp"
 
 namespace chatterino {
 
@@ -9,79 +9,79 @@ public:
     Resources2();
 
     struct {
-        QPixmap _1xelerate;
-        QPixmap alazymeme;
-        QPixmap brian6932;
-        QPixmap fourtf;
-        QPixmap hicupalot;
-        QPixmap iprodigy;
-        QPixmap kararty;
-        QPixmap karlpolice;
-        QPixmap mm2pl;
-        QPixmap pajlada;
-        QPixmap slch;
-        QPixmap xheaveny;
-        QPixmap zneix;
+        LazyPixmap _1xelerate{":/avatars/_1xelerate.png"};
+        LazyPixmap alazymeme{":/avatars/alazymeme.png"};
+        LazyPixmap brian6932{":/avatars/brian6932.png"};
+        LazyPixmap fourtf{":/avatars/fourtf.png"};
+        LazyPixmap hicupalot{":/avatars/hicupalot.png"};
+        LazyPixmap iprodigy{":/avatars/iprodigy.png"};
+        LazyPixmap kararty{":/avatars/kararty.png"};
+        LazyPixmap karlpolice{":/avatars/karlpolice.png"};
+        LazyPixmap mm2pl{":/avatars/mm2pl.png"};
+        LazyPixmap pajlada{":/avatars/pajlada.png"};
+        LazyPixmap slch{":/avatars/slch.png"};
+        LazyPixmap xheaveny{":/avatars/xheaveny.png"};
+        LazyPixmap zneix{":/avatars/zneix.png"};
     } avatars;
     struct {
-        QPixmap addSplit;
-        QPixmap addSplitDark;
-        QPixmap ban;
-        QPixmap banRed;
-        QPixmap clearSearch;
-        QPixmap copyDark;
-        QPixmap copyLight;
-        QPixmap menuDark;
-        QPixmap menuLight;
-        QPixmap mod;
-        QPixmap modModeDisabled;
-        QPixmap modModeDisabled2;
-        QPixmap modModeEnabled;
-        QPixmap modModeEnabled2;
-        QPixmap search;
-        QPixmap timeout;
-        QPixmap trashCan;
-        QPixmap unban;
-        QPixmap unmod;
-        QPixmap unvip;
-        QPixmap update;
-        QPixmap updateError;
-        QPixmap viewersDark;
-        QPixmap viewersLight;
-        QPixmap vip;
+        LazyPixmap addSplit{":/buttons/addSplit.png"};
+        LazyPixmap addSplitDark{":/buttons/addSplitDark.png"};
+        LazyPixmap ban{":/buttons/ban.png"};
+        LazyPixmap banRed{":/buttons/banRed.png"};
+        LazyPixmap clearSearch{":/buttons/clearSearch.png"};
+        LazyPixmap copyDark{":/buttons/copyDark.png"};
+        LazyPixmap copyLight{":/buttons/copyLight.png"};
+        LazyPixmap menuDark{":/buttons/menuDark.png"};
+        LazyPixmap menuLight{":/buttons/menuLight.png"};
+        LazyPixmap mod{":/buttons/mod.png"};
+        LazyPixmap modModeDisabled{":/buttons/modModeDisabled.png"};
+        LazyPixmap modModeDisabled2{":/buttons/modModeDisabled2.png"};
+        LazyPixmap modModeEnabled{":/buttons/modModeEnabled.png"};
+        LazyPixmap modModeEnabled2{":/buttons/modModeEnabled2.png"};
+        LazyPixmap search{":/buttons/search.png"};
+        LazyPixmap timeout{":/buttons/timeout.png"};
+        LazyPixmap trashCan{":/buttons/trashCan.png"};
+        LazyPixmap unban{":/buttons/unban.png"};
+        LazyPixmap unmod{":/buttons/unmod.png"};
+        LazyPixmap unvip{":/buttons/unvip.png"};
+        LazyPixmap update{":/buttons/update.png"};
+        LazyPixmap updateError{":/buttons/updateError.png"};
+        LazyPixmap viewersDark{":/buttons/viewersDark.png"};
+        LazyPixmap viewersLight{":/buttons/viewersLight.png"};
+        LazyPixmap vip{":/buttons/vip.png"};
     } buttons;
-    QPixmap error;
-    QPixmap icon;
-    QPixmap pajaDank;
+    LazyPixmap error{":/error.png"};
+    LazyPixmap icon{":/icon.png"};
+    LazyPixmap pajaDank{":/pajaDank.png"};
     struct {
-        QPixmap downScroll;
-        QPixmap neutralScroll;
-        QPixmap upScroll;
+        LazyPixmap downScroll{":/scrolling/downScroll.png"};
+        LazyPixmap neutralScroll{":/scrolling/neutralScroll.png"};
+        LazyPixmap upScroll{":/scrolling/upScroll.png"};
     } scrolling;
     struct {
-        QPixmap aboutlogo;
+        LazyPixmap aboutlogo{":/settings/aboutlogo.png"};
     } settings;
     struct {
-        QPixmap down;
-        QPixmap left;
-        QPixmap move;
-        QPixmap right;
-        QPixmap up;
+        LazyPixmap down{":/split/down.png"};
+        LazyPixmap left{":/split/left.png"};
+        LazyPixmap move{":/split/move.png"};
+        LazyPixmap right{":/split/right.png"};
+        LazyPixmap up{":/split/up.png"};
     } split;
-    QPixmap streamerMode;
+    LazyPixmap streamerMode{":/streamerMode.png"};
     struct {
-        QPixmap admin;
-        QPixmap automod;
-        QPixmap broadcaster;
-        QPixmap cheer1;
-        QPixmap globalmod;
-        QPixmap moderator;
-        QPixmap prime;
-        QPixmap staff;
-        QPixmap subscriber;
-        QPixmap turbo;
-        QPixmap verified;
-        QPixmap vip;
+        LazyPixmap admin{":/twitch/admin.png"};
+        LazyPixmap automod{":/twitch/automod.png"};
+        LazyPixmap broadcaster{":/twitch/broadcaster.png"};
+        LazyPixmap cheer1{":/twitch/cheer1.png"};
+        LazyPixmap globalmod{":/twitch/globalmod.png"};
+        LazyPixmap moderator{":/twitch/moderator.png"};
+        LazyPixmap prime{":/twitch/prime.png"};
+        LazyPixmap staff{":/twitch/staff.png"};
+        LazyPixmap subscriber{":/twitch/subscriber.png"};
+        LazyPixmap turbo{":/twitch/turbo.png"};
+        LazyPixmap verified{":/twitch/verified.png"};
+        LazyPixmap vip{":/twitch/vip.png"};
     } twitch;
 };
 
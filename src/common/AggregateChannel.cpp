@@ -0,0 +1,57 @@
+#include "common/AggregateChannel.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "messages/Message.hpp"
+#include "util/DebugCount.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    DebugCounter duplicateCount("aggregated duplicates");
+
+}  // namespace
+
+AggregateChannel::AggregateChannel(const QString &name, Type type)
+    : Channel(name, type)
+{
+    this->setBatchedAppends(true);
+}
+
+bool AggregateChannel::collect(const MessagePtr &message,
+                               boost::optional<MessageFlags> overridingFlags)
+{
+    assertInGuiThread();
+
+    if (this->contains(message))
+    {
+        duplicateCount.increase();
+        return false;
+    }
+
+    this->addMessage(message, overridingFlags);
+    return true;
+}
+
+bool AggregateChannel::contains(const MessagePtr &message)
+{
+    if (!message->id.isEmpty())
+    {
+        return this->findMessage(message->id) != nullptr;
+    }
+
+    auto snapshot = this->getMessageSnapshot();
+    auto count = std::min(snapshot.size(), recentCheckCount);
+    for (size_t i = snapshot.size() - count; i < snapshot.size(); i++)
+    {
+        if (snapshot[i] == message)
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+}  // namespace chatterino
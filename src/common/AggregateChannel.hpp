@@ -0,0 +1,36 @@
+#pragma once
+
+#include "common/Channel.hpp"
+
+namespace chatterino {
+
+/**
+ * @brief A channel that collects messages of other channels, like
+ *        /mentions, /whispers and /live.
+ *
+ * Messages arrive from every channel at once during busy moments, so its
+ * appends are batched: the projections of the views get them together once
+ * the event loop runs again. A message that reaches it through several
+ * routes is only kept once, messages with an id are matched by it, others
+ * by the message itself among the last few.
+ *
+ * Gui thread only.
+ */
+class AggregateChannel : public Channel
+{
+public:
+    // how many of the last messages are checked for messages without an id
+    static constexpr size_t recentCheckCount = 32;
+
+    AggregateChannel(const QString &name, Type type);
+
+    /// Adds the message unless it's in the channel already, returns whether
+    /// it was added
+    bool collect(const MessagePtr &message,
+                 boost::optional<MessageFlags> overridingFlags = boost::none);
+
+    /// Returns true if the message was collected already
+    bool contains(const MessagePtr &message);
+};
+
+}  // namespace chatterino
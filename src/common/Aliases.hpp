@@ -1,5 +1,7 @@
 #pragma once
 
+#include "util/QStringHash.hpp"
+
 #include <QHash>
 #include <QString>
 #include <functional>
@@ -23,7 +25,7 @@
     struct hash<chatterino::name> {                        \
         size_t operator()(const chatterino::name &s) const \
         {                                                  \
-            return qHash(s.string);                        \
+            return chatterino::hashQString(s.string);      \
         }                                                  \
     };                                                     \
     } /* namespace std */
@@ -52,6 +52,28 @@ Args::Args(const QApplication &app)
         "specify platform. Only Twitch channels are supported at the moment.\n"
         "If platform isn't specified, default is Twitch.",
         "t:channel1;t:channel2;..."));
+    QCommandLineOption traceOption(
+        "trace",
+        "Records where time is spent and writes it to the file on exit. "
+        "The trace can be opened in chrome://tracing or ui.perfetto.dev.",
+        "file");
+    parser.addOption(traceOption);
+    QCommandLineOption loadTestOption(
+        "load-test",
+        "Generates chat traffic in all open channels once they're joined, to "
+        "see how the machine holds up under load. The options are the ones "
+        "of /debug-load, for example \"rate=500 seconds=30\". A summary is "
+        "logged at the end.",
+        "options");
+    parser.addOption(loadTestOption);
+    QCommandLineOption headlessOption(
+        "headless",
+        "Runs without any windows and only logs the chat of the channels in "
+        "the file, one channel per line. The channels are joined and parted "
+        "when the file changes. Logs are written even if logging is turned "
+        "off in the settings.",
+        "channels-file");
+    parser.addOption(headlessOption);
 
     if (!parser.parse(app.arguments()))
     {
@@ -78,9 +100,29 @@ Args::Args(const QApplication &app)
 
     this->verbose = parser.isSet(verboseOption);
 
+    if (parser.isSet(traceOption))
+    {
+        this->traceFile = parser.value(traceOption);
+    }
+
+    if (parser.isSet(loadTestOption))
+    {
+        this->loadTest = parser.value(loadTestOption)
+                             .split(' ', QString::SkipEmptyParts);
+    }
+
     this->printVersion = parser.isSet("V");
     this->crashRecovery = parser.isSet("crash-recovery");
 
+    if (parser.isSet(headlessOption))
+    {
+        this->headless = true;
+        this->headlessChannelsFile = parser.value(headlessOption);
+        // the layout and settings of the normal runs are kept as they are
+        this->dontSaveSettings = true;
+        this->dontLoadMainWindow = true;
+    }
+
     if (parser.isSet(parentWindowIdOption))
     {
         this->isFramelessEmbed = true;
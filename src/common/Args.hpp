@@ -1,6 +1,7 @@
 #pragma once
 
 #include <QApplication>
+#include <QStringList>
 #include <boost/optional.hpp>
 #include "common/WindowDescriptors.hpp"
 
@@ -19,11 +20,20 @@ public:
     bool isFramelessEmbed{};
     boost::optional<unsigned long long> parentWindowId{};
 
+    // Only joins and logs the channels of headlessChannelsFile, without any
+    // windows
+    bool headless{};
+    QString headlessChannelsFile;
+
     // Not settings directly
     bool dontSaveSettings{};
     bool dontLoadMainWindow{};
     boost::optional<WindowLayout> customChannelLayout;
     bool verbose{};
+    // Chrome trace of the trace scopes, written on exit
+    boost::optional<QString> traceFile;
+    // Options of the synthetic load generated once the channels are joined
+    boost::optional<QStringList> loadTest;
 
 private:
     void applyCustomChannelLayout(const QString &argValue);
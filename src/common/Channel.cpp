@@ -17,7 +17,44 @@
 #include <QNetworkReply>
 #include <QNetworkRequest>
 
+#include <algorithm>
+
 namespace chatterino {
+namespace {
+
+    // Returns the lowercase names of the users a message should be found
+    // under, this is the sender and the target of moderation messages.
+    // Subscription messages without a sender use the first word instead.
+    std::vector<QString> userKeys(const Message &message)
+    {
+        std::vector<QString> keys;
+
+        if (!message.loginName.isEmpty())
+        {
+            keys.push_back(message.loginName.toLower());
+        }
+        else if (message.flags.has(MessageFlag::Subscription))
+        {
+            auto name = message.messageText.section(' ', 0, 0).toLower();
+            if (!name.isEmpty())
+            {
+                keys.push_back(name);
+            }
+        }
+
+        if (!message.timeoutUser.isEmpty())
+        {
+            auto key = message.timeoutUser.toLower();
+            if (keys.empty() || keys.front() != key)
+            {
+                keys.push_back(key);
+            }
+        }
+
+        return keys;
+    }
+
+}  // namespace
 
 //
 // Channel
@@ -28,6 +65,16 @@ Channel::Channel(const QString &name, Type type)
     , name_(name)
     , type_(type)
 {
+    if (type != Type::None)
+    {
+        this->tokenIndex_ = std::make_unique<MessageTokenIndex>();
+    }
+
+    QObject::connect(&this->flushAppendsTimer_, &QTimer::timeout, [this] {
+        this->flushAppendedMessages();
+    });
+    this->flushAppendsTimer_.setInterval(0);
+    this->flushAppendsTimer_.setSingleShot(true);
 }
 
 Channel::~Channel()
@@ -70,6 +117,11 @@ bool Channel::hasMessages() const
     return !this->messages_.empty();
 }
 
+int64_t Channel::addedMessageCount() const
+{
+    return this->addedMessageCount_.load(std::memory_order_relaxed);
+}
+
 LimitedQueueSnapshot<MessagePtr> Channel::getMessageSnapshot()
 {
     return this->messages_.getSnapshot();
@@ -88,7 +140,37 @@ void Channel::addMessage(MessagePtr message,
         app->logging->addMessage(this->name_, message);
     }
 
-    if (this->messages_.pushBack(message, deleted))
+    bool removedMessage = false;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        if (this->messages_.pushBack(message, deleted))
+        {
+            this->unindexMessage(deleted, this->firstMessagePosition_++);
+            removedMessage = true;
+        }
+
+        this->indexMessage(message, this->nextMessagePosition_++);
+    }
+
+    this->addedMessageCount_.fetch_add(1, std::memory_order_relaxed);
+
+    if (this->batchedAppends_)
+    {
+        if (removedMessage)
+        {
+            this->pendingRemovals_.push_back(std::move(deleted));
+        }
+        this->pendingAppends_.push_back({message, overridingFlags});
+
+        if (!this->flushAppendsTimer_.isActive())
+        {
+            this->flushAppendsTimer_.start();
+        }
+        return;
+    }
+
+    if (removedMessage)
     {
         this->messageRemovedFromStart.invoke(deleted);
     }
@@ -96,10 +178,77 @@ void Channel::addMessage(MessagePtr message,
     this->messageAppended.invoke(message, overridingFlags);
 }
 
+void Channel::setBatchedAppends(bool enabled)
+{
+    if (!enabled)
+    {
+        this->flushAppendedMessages();
+    }
+
+    this->batchedAppends_ = enabled;
+}
+
+void Channel::flushAppendedMessages()
+{
+    this->flushAppendsTimer_.stop();
+
+    if (this->pendingAppends_.empty())
+    {
+        return;
+    }
+
+    // receivers may add messages again
+    auto removals = std::move(this->pendingRemovals_);
+    auto appends = std::move(this->pendingAppends_);
+    this->pendingRemovals_.clear();
+    this->pendingAppends_.clear();
+
+    for (auto &message : removals)
+    {
+        this->messageRemovedFromStart.invoke(message);
+    }
+
+    this->messagesAppended.invoke(appends);
+}
+
+void Channel::setMessageLimit(size_t limit)
+{
+    // receivers have to see the removals after the appends they belong to
+    this->flushAppendedMessages();
+
+    if (limit == this->messages_.limit())
+    {
+        return;
+    }
+
+    std::vector<MessagePtr> removed;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        removed = this->messages_.setLimit(limit);
+        for (const auto &message : removed)
+        {
+            this->unindexMessage(message, this->firstMessagePosition_++);
+        }
+    }
+
+    for (auto &message : removed)
+    {
+        this->messageRemovedFromStart.invoke(message);
+    }
+
+    this->messageLimitChanged.invoke();
+}
+
+size_t Channel::getMessageLimit() const
+{
+    return this->messages_.limit();
+}
+
 void Channel::addOrReplaceTimeout(MessagePtr message)
 {
-    LimitedQueueSnapshot<MessagePtr> snapshot = this->getMessageSnapshot();
-    int snapshotLength = snapshot.size();
+    auto userMessages = this->findUserMessages(message->timeoutUser);
+    int snapshotLength = this->getMessageSnapshot().size();
 
     int end = std::max(0, snapshotLength - 20);
 
@@ -110,9 +259,15 @@ void Channel::addOrReplaceTimeout(MessagePtr message)
     auto timeoutStackStyle = static_cast<TimeoutStackStyle>(
         getSettings()->timeoutStackStyle.getValue());
 
-    for (int i = snapshotLength - 1; i >= end; --i)
+    // only messages concerning the timed out user can affect stacking
+    for (auto it = userMessages.rbegin(); it != userMessages.rend(); ++it)
     {
-        auto &s = snapshot[i];
+        if (int(it->first) < end)
+        {
+            break;
+        }
+
+        auto &s = it->second;
 
         if (s->parseTime < minimumTime)
         {
@@ -168,19 +323,19 @@ void Channel::addOrReplaceTimeout(MessagePtr message)
         }
     }
 
-    // disable the messages from the user
-    for (int i = 0; i < snapshotLength; i++)
+    // disable the messages from the user, the views lay them out again
+    // together
+    std::vector<size_t> disabled;
+    for (auto &[index, s] : userMessages)
     {
-        auto &s = snapshot[i];
         if (s->loginName == message->timeoutUser &&
             s->flags.hasNone({MessageFlag::Timeout, MessageFlag::Untimeout,
                               MessageFlag::Whisper}))
         {
-            // FOURTF: disabled for now
-            // PAJLADA: Shitty solution described in Message.hpp
-            s->flags.set(MessageFlag::Disabled);
+            disabled.push_back(index);
         }
     }
+    this->setMessageFlag(std::move(disabled), MessageFlag::Disabled);
 
     if (addMessage)
     {
@@ -194,8 +349,8 @@ void Channel::addOrReplaceTimeout(MessagePtr message)
 void Channel::disableAllMessages()
 {
     LimitedQueueSnapshot<MessagePtr> snapshot = this->getMessageSnapshot();
-    int snapshotLength = snapshot.size();
-    for (int i = 0; i < snapshotLength; i++)
+    std::vector<size_t> disabled;
+    for (size_t i = 0; i < snapshot.size(); i++)
     {
         auto &message = snapshot[i];
         if (message->flags.hasAny({MessageFlag::System, MessageFlag::Timeout,
@@ -204,15 +359,109 @@ void Channel::disableAllMessages()
             continue;
         }
 
-        // FOURTF: disabled for now
-        const_cast<Message *>(message.get())->flags.set(MessageFlag::Disabled);
+        disabled.push_back(i);
+    }
+
+    this->setMessageFlag(std::move(disabled), MessageFlag::Disabled);
+}
+
+void Channel::setMessageFlag(std::vector<size_t> indices, MessageFlag flag)
+{
+    this->flushAppendedMessages();
+
+    std::vector<size_t> changed;
+    changed.reserve(indices.size());
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        std::sort(indices.begin(), indices.end());
+        auto snapshot = this->messages_.getSnapshot();
+        for (auto index : indices)
+        {
+            if (index >= snapshot.size() ||
+                (!changed.empty() && changed.back() == index))
+            {
+                continue;
+            }
+
+            auto &message = snapshot[index];
+            if (message->flags.has(flag))
+            {
+                continue;
+            }
+
+            // PAJLADA: Shitty solution described in Message.hpp
+            message->flags.set(flag);
+            changed.push_back(index);
+        }
+    }
+
+    if (!changed.empty())
+    {
+        this->messagesChanged.invoke(changed);
+    }
+}
+
+void Channel::updateMessages(
+    const std::vector<MessagePtr> &messages,
+    const std::function<bool(const Message &)> &update)
+{
+    this->flushAppendedMessages();
+
+    std::vector<size_t> changed;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        // both are in the order of the channel, messages that were removed
+        // in the meantime are skipped
+        auto snapshot = this->messages_.getSnapshot();
+        size_t index = 0;
+        for (const auto &message : messages)
+        {
+            auto start = index;
+            while (index < snapshot.size() && snapshot[index] != message)
+            {
+                index++;
+            }
+            if (index == snapshot.size())
+            {
+                index = start;
+                continue;
+            }
+
+            if (update(*message))
+            {
+                changed.push_back(index);
+            }
+            index++;
+        }
+    }
+
+    if (!changed.empty())
+    {
+        this->messagesChanged.invoke(changed);
     }
 }
 
 void Channel::addMessagesAtStart(std::vector<MessagePtr> &_messages)
 {
-    std::vector<MessagePtr> addedMessages =
-        this->messages_.pushFront(_messages);
+    this->flushAppendedMessages();
+
+    std::vector<MessagePtr> addedMessages;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        addedMessages = this->messages_.pushFront(_messages);
+        this->firstMessagePosition_ -= int64_t(addedMessages.size());
+
+        for (size_t i = 0; i < addedMessages.size(); i++)
+        {
+            // newer messages with the same id take precedence
+            this->indexMessage(addedMessages[i],
+                               this->firstMessagePosition_ + int64_t(i),
+                               false);
+        }
+    }
 
     if (addedMessages.size() != 0)
     {
@@ -222,7 +471,36 @@ void Channel::addMessagesAtStart(std::vector<MessagePtr> &_messages)
 
 void Channel::replaceMessage(MessagePtr message, MessagePtr replacement)
 {
-    int index = this->messages_.replaceItem(message, replacement);
+    this->flushAppendedMessages();
+
+    int index = -1;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        auto position = this->findMessagePosition(message->id);
+        if (position >= 0)
+        {
+            auto snapshot = this->messages_.getSnapshot();
+            if (size_t(position) < snapshot.size() &&
+                snapshot[size_t(position)] == message &&
+                this->messages_.replaceItem(size_t(position), replacement))
+            {
+                index = int(position);
+            }
+        }
+
+        if (index < 0)
+        {
+            index = this->messages_.replaceItem(message, replacement);
+        }
+
+        if (index >= 0)
+        {
+            auto absolutePosition = this->firstMessagePosition_ + index;
+            this->unindexMessage(message, absolutePosition);
+            this->indexMessage(replacement, absolutePosition);
+        }
+    }
 
     if (index >= 0)
     {
@@ -232,7 +510,26 @@ void Channel::replaceMessage(MessagePtr message, MessagePtr replacement)
 
 void Channel::replaceMessage(size_t index, MessagePtr replacement)
 {
-    if (this->messages_.replaceItem(index, replacement))
+    this->flushAppendedMessages();
+
+    bool replaced = false;
+    {
+        std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+        auto snapshot = this->messages_.getSnapshot();
+        if (index < snapshot.size())
+        {
+            auto previous = snapshot[index];
+            replaced = this->messages_.replaceItem(index, replacement);
+
+            auto absolutePosition =
+                this->firstMessagePosition_ + int64_t(index);
+            this->unindexMessage(previous, absolutePosition);
+            this->indexMessage(replacement, absolutePosition);
+        }
+    }
+
+    if (replaced)
     {
         this->messageReplaced.invoke(index, replacement);
     }
@@ -240,29 +537,234 @@ void Channel::replaceMessage(size_t index, MessagePtr replacement)
 
 void Channel::deleteMessage(QString messageID)
 {
-    auto msg = this->findMessage(messageID);
-    if (msg != nullptr)
+    auto index = this->findMessageIndex(messageID);
+    if (!index)
     {
-        msg->flags.set(MessageFlag::Disabled);
+        return;
     }
+
+    this->setMessageFlag({*index}, MessageFlag::Disabled);
 }
+
 MessagePtr Channel::findMessage(QString messageID)
 {
-    LimitedQueueSnapshot<MessagePtr> snapshot = this->getMessageSnapshot();
-    int snapshotLength = snapshot.size();
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+    auto position = this->findMessagePosition(messageID);
+    auto snapshot = this->messages_.getSnapshot();
+    if (position < 0 || size_t(position) >= snapshot.size())
+    {
+        return nullptr;
+    }
+
+    return snapshot[size_t(position)];
+}
+
+boost::optional<size_t> Channel::findMessageIndex(const QString &messageID)
+{
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+    auto position = this->findMessagePosition(messageID);
+    if (position < 0 ||
+        size_t(position) >= this->messages_.getSnapshot().size())
+    {
+        return boost::none;
+    }
+
+    return size_t(position);
+}
+
+std::vector<MessagePtr> Channel::findMessagesByUser(const QString &userName)
+{
+    std::vector<MessagePtr> messages;
+
+    for (auto &[index, message] : this->findUserMessages(userName))
+    {
+        messages.push_back(std::move(message));
+    }
+
+    return messages;
+}
+
+std::vector<std::pair<size_t, MessagePtr>> Channel::findUserMessages(
+    const QString &userName)
+{
+    std::vector<std::pair<size_t, MessagePtr>> messages;
+
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+    auto it = this->messagesByUser_.find(userName.toLower());
+    if (it == this->messagesByUser_.end())
+    {
+        return messages;
+    }
+
+    auto snapshot = this->messages_.getSnapshot();
+    messages.reserve(it->second.size());
+
+    for (auto position : it->second)
+    {
+        auto index = size_t(position - this->firstMessagePosition_);
+        if (index < snapshot.size())
+        {
+            messages.emplace_back(index, snapshot[index]);
+        }
+    }
+
+    return messages;
+}
+
+boost::optional<std::vector<MessagePtr>> Channel::findSearchCandidates(
+    const QStringList &words, const QStringList &authors)
+{
+    std::lock_guard<std::mutex> lock(this->messageIndexMutex_);
+
+    if (!this->tokenIndex_ || (words.empty() && authors.empty()))
+    {
+        return boost::none;
+    }
+
+    std::vector<int64_t> positions;
+    if (!authors.empty())
+    {
+        positions = this->tokenIndex_->findAuthors(authors);
+    }
+
+    for (int i = 0; i < words.size(); i++)
+    {
+        auto found = this->tokenIndex_->findSubstring(words[i]);
+        positions = i == 0 && authors.empty()
+                        ? std::move(found)
+                        : MessageTokenIndex::intersect(positions, found);
+    }
 
-    int end = std::max(0, snapshotLength - 200);
+    auto snapshot = this->messages_.getSnapshot();
+    std::vector<MessagePtr> messages;
+    messages.reserve(positions.size());
 
-    for (int i = snapshotLength - 1; i >= end; --i)
+    for (auto position : positions)
     {
-        auto &s = snapshot[i];
+        auto index = size_t(position - this->firstMessagePosition_);
+        if (index < snapshot.size())
+        {
+            messages.push_back(snapshot[index]);
+        }
+    }
 
-        if (s->id == messageID)
+    return messages;
+}
+
+void Channel::indexMessage(const MessagePtr &message, int64_t position,
+                           bool overwrite)
+{
+    if (message == nullptr)
+    {
+        return;
+    }
+
+    if (!message->id.isEmpty())
+    {
+        if (overwrite)
+        {
+            this->messagesById_[message->id] = position;
+        }
+        else
         {
-            return s;
+            this->messagesById_.emplace(message->id, position);
         }
     }
-    return nullptr;
+
+    if (this->tokenIndex_)
+    {
+        this->tokenIndex_->add(*message, position);
+    }
+
+    for (auto &&key : userKeys(*message))
+    {
+        auto &positions = this->messagesByUser_[key];
+
+        if (positions.empty() || positions.back() < position)
+        {
+            positions.push_back(position);
+        }
+        else
+        {
+            auto it =
+                std::lower_bound(positions.begin(), positions.end(), position);
+            if (it == positions.end() || *it != position)
+            {
+                positions.insert(it, position);
+            }
+        }
+    }
+}
+
+void Channel::unindexMessage(const MessagePtr &message, int64_t position)
+{
+    if (message == nullptr)
+    {
+        return;
+    }
+
+    if (!message->id.isEmpty())
+    {
+        auto it = this->messagesById_.find(message->id);
+        if (it != this->messagesById_.end() && it->second == position)
+        {
+            this->messagesById_.erase(it);
+        }
+    }
+
+    if (this->tokenIndex_)
+    {
+        this->tokenIndex_->remove(*message, position);
+    }
+
+    for (auto &&key : userKeys(*message))
+    {
+        auto it = this->messagesByUser_.find(key);
+        if (it == this->messagesByUser_.end())
+        {
+            continue;
+        }
+
+        auto &positions = it->second;
+        if (!positions.empty() && positions.front() == position)
+        {
+            positions.pop_front();
+        }
+        else
+        {
+            auto positionIt =
+                std::lower_bound(positions.begin(), positions.end(), position);
+            if (positionIt != positions.end() && *positionIt == position)
+            {
+                positions.erase(positionIt);
+            }
+        }
+
+        if (positions.empty())
+        {
+            this->messagesByUser_.erase(it);
+        }
+    }
+}
+
+// returns the index of the message in the current snapshot, or -1
+int64_t Channel::findMessagePosition(const QString &messageID) const
+{
+    if (messageID.isEmpty())
+    {
+        return -1;
+    }
+
+    auto it = this->messagesById_.find(messageID);
+    if (it == this->messagesById_.end())
+    {
+        return -1;
+    }
+
+    return it->second - this->firstMessagePosition_;
 }
 
 bool Channel::canSendMessage() const
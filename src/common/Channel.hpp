@@ -3,6 +3,8 @@
 #include "common/CompletionModel.hpp"
 #include "common/FlagsEnum.hpp"
 #include "messages/LimitedQueue.hpp"
+#include "messages/search/MessageTokenIndex.hpp"
+#include "util/QStringHash.hpp"
 
 #include <QDate>
 #include <QString>
@@ -10,7 +12,13 @@
 #include <boost/optional.hpp>
 #include <pajlada/signals/signal.hpp>
 
+#include <atomic>
+#include <deque>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 
 namespace chatterino {
 
@@ -43,6 +51,15 @@ public:
         Misc
     };
 
+    // A message that was added to the end of the channel, overridingFlags
+    // are the ones given to addMessage
+    struct AppendedMessage {
+        MessagePtr message;
+        boost::optional<MessageFlags> overridingFlags;
+    };
+
+    static constexpr size_t DEFAULT_MESSAGE_LIMIT = 1000;
+
     explicit Channel(const QString &name, Type type);
     virtual ~Channel();
 
@@ -52,8 +69,15 @@ public:
     pajlada::Signals::Signal<MessagePtr &> messageRemovedFromStart;
     pajlada::Signals::Signal<MessagePtr &, boost::optional<MessageFlags>>
         messageAppended;
+    // only invoked if batched appends are enabled, see setBatchedAppends
+    pajlada::Signals::Signal<std::vector<AppendedMessage> &> messagesAppended;
     pajlada::Signals::Signal<std::vector<MessagePtr> &> messagesAddedAtStart;
     pajlada::Signals::Signal<size_t, MessagePtr &> messageReplaced;
+    // the messages at the indices changed in place, e.g. their flags. The
+    // indices are ascending.
+    pajlada::Signals::Signal<std::vector<size_t> &> messagesChanged;
+    // invoked after the removals of a new message limit, see setMessageLimit
+    pajlada::Signals::NoArgSignal messageLimitChanged;
     pajlada::Signals::NoArgSignal destroyed;
     pajlada::Signals::NoArgSignal displayNameChanged;
 
@@ -73,14 +97,58 @@ public:
         MessagePtr message,
         boost::optional<MessageFlags> overridingFlags = boost::none);
     void addMessagesAtStart(std::vector<MessagePtr> &messages_);
+
+    /// Collect appended messages and deliver them once the event loop runs
+    /// again, in a single messagesAppended. messageAppended and
+    /// messageRemovedFromStart are no longer invoked for every message while
+    /// this is enabled, removed messages are reported right before the batch.
+    /// Signals referring to message indices deliver pending messages first so
+    /// receivers always see the same indices as the channel.
+    /// Gui thread only.
+    void setBatchedAppends(bool enabled);
+    /// Deliver all pending appended messages right away
+    void flushAppendedMessages();
+    /// Messages over a lower limit are removed from the start, oldest first,
+    /// and reported through messageRemovedFromStart, then
+    /// messageLimitChanged is invoked. Gui thread only.
+    void setMessageLimit(size_t limit);
+    size_t getMessageLimit() const;
     void addOrReplaceTimeout(MessagePtr message);
     void disableAllMessages();
+    /// Sets the flag on the messages at the indices of the current snapshot
+    /// and invokes messagesChanged once for all messages that didn't have it
+    /// yet. Used for moderation events affecting many messages at once.
+    void setMessageFlag(std::vector<size_t> indices, MessageFlag flag);
+    /// Calls update for each of the messages that's still in the channel and
+    /// invokes messagesChanged once for all messages it returned true for.
+    /// The messages have to be in the order of the channel, update may only
+    /// change the mutable parts of a message. Gui thread only.
+    void updateMessages(const std::vector<MessagePtr> &messages,
+                        const std::function<bool(const Message &)> &update);
     void replaceMessage(MessagePtr message, MessagePtr replacement);
     void replaceMessage(size_t index, MessagePtr replacement);
     void deleteMessage(QString messageID);
     MessagePtr findMessage(QString messageID);
+    /// Returns the index of the message in the current snapshot
+    boost::optional<size_t> findMessageIndex(const QString &messageID);
+
+    /// Returns the messages sent by, or moderation messages targeting, the
+    /// given user in the order they appear in the channel. The user name is
+    /// matched case-insensitively.
+    std::vector<MessagePtr> findMessagesByUser(const QString &userName);
+
+    /// Returns the messages that can contain all the words and were sent by
+    /// one of the authors, oldest first. Words must not contain whitespace,
+    /// empty authors allow everyone. These still have to be checked by the
+    /// search predicates. boost::none if the channel doesn't keep a token
+    /// index or there's nothing to look up, all messages have to be checked
+    /// then.
+    boost::optional<std::vector<MessagePtr>> findSearchCandidates(
+        const QStringList &words, const QStringList &authors);
 
     bool hasMessages() const;
+    /// Messages added with addMessage since the channel was created
+    int64_t addedMessageCount() const;
 
     // CHANNEL INFO
     virtual bool canSendMessage() const;
@@ -103,10 +171,38 @@ protected:
     virtual void onConnected();
 
 private:
+    void indexMessage(const MessagePtr &message, int64_t position,
+                      bool overwrite = true);
+    void unindexMessage(const MessagePtr &message, int64_t position);
+    int64_t findMessagePosition(const QString &messageID) const;
+    // returns (index in the snapshot, message) pairs, oldest first
+    std::vector<std::pair<size_t, MessagePtr>> findUserMessages(
+        const QString &userName);
+
     const QString name_;
-    LimitedQueue<MessagePtr> messages_;
+    LimitedQueue<MessagePtr> messages_{DEFAULT_MESSAGE_LIMIT};
     Type type_;
+
+    // Messages are indexed by their absolute position. Positions only grow
+    // when messages are added at the end and shrink when they are added at
+    // the start, so the index of a message in the snapshot is always its
+    // position minus firstMessagePosition_.
+    mutable std::mutex messageIndexMutex_;
+    std::unordered_map<QString, int64_t> messagesById_;
+    // lowercase user name -> sorted positions of the messages of that user
+    std::unordered_map<QString, std::deque<int64_t>> messagesByUser_;
+    // words and authors for searching, not kept by channels of type None
+    // which are only used for search results and placeholders
+    std::unique_ptr<MessageTokenIndex> tokenIndex_;
+    int64_t firstMessagePosition_ = 0;
+    int64_t nextMessagePosition_ = 0;
+    std::atomic<int64_t> addedMessageCount_{0};
     QTimer clearCompletionModelTimer_;
+
+    bool batchedAppends_ = false;
+    std::vector<AppendedMessage> pendingAppends_;
+    std::vector<MessagePtr> pendingRemovals_;
+    QTimer flushAppendsTimer_;
 };
 
 using ChannelPtr = std::shared_ptr<Channel>;
@@ -8,7 +8,6 @@ namespace chatterino {
 
 ChannelChatters::ChannelChatters(Channel &channel)
     : channel_(channel)
-    , chatterColors_(ChannelChatters::maxChatterColorCount)
 {
 }
 
@@ -23,58 +22,69 @@ void ChannelChatters::addRecentChatter(const QString &user)
     chatters->addRecentChatter(user);
 }
 
-void ChannelChatters::addJoinedUser(const QString &user)
+void ChannelChatters::addJoinedUser(const QString &user, bool announce)
 {
-    auto joinedUsers = this->joinedUsers_.access();
-    joinedUsers->append(user);
-
-    if (!this->joinedUsersMergeQueued_)
-    {
-        this->joinedUsersMergeQueued_ = true;
-
-        QTimer::singleShot(500, &this->lifetimeGuard_, [this] {
-            auto joinedUsers = this->joinedUsers_.access();
-            joinedUsers->sort();
+    auto membership = this->membership_.access();
+    membership->join(user, announce);
+    this->queueMembershipFlush();
+}
 
-            MessageBuilder builder;
-            TwitchMessageBuilder::listOfUsersSystemMessage(
-                "Users joined:", *joinedUsers, &this->channel_, &builder);
-            builder->flags.set(MessageFlag::Collapsed);
-            this->channel_.addMessage(builder.release());
+void ChannelChatters::addPartedUser(const QString &user, bool announce)
+{
+    auto membership = this->membership_.access();
+    membership->part(user, announce);
+    this->queueMembershipFlush();
+}
 
-            joinedUsers->clear();
-            this->joinedUsersMergeQueued_ = false;
-        });
+// membership_ has to be locked
+void ChannelChatters::queueMembershipFlush()
+{
+    if (this->membershipFlushQueued_)
+    {
+        return;
     }
+    this->membershipFlushQueued_ = true;
+
+    QTimer::singleShot(500, &this->lifetimeGuard_, [this] {
+        this->flushMembership();
+    });
 }
 
-void ChannelChatters::addPartedUser(const QString &user)
+void ChannelChatters::flushMembership()
 {
-    auto partedUsers = this->partedUsers_.access();
-    partedUsers->append(user);
-
-    if (!this->partedUsersMergeQueued_)
+    MembershipDeltas::Batch batch;
     {
-        this->partedUsersMergeQueued_ = true;
+        auto membership = this->membership_.access();
+        batch = membership->take(ChannelChatters::maxNamedMembers);
+        this->membershipFlushQueued_ = false;
+    }
 
-        QTimer::singleShot(500, &this->lifetimeGuard_, [this] {
-            auto partedUsers = this->partedUsers_.access();
-            partedUsers->sort();
+    {
+        auto chatters = this->chatters_.access();
+        chatters->updateMembership(batch.joined, batch.parted);
+    }
 
-            MessageBuilder builder;
-            TwitchMessageBuilder::listOfUsersSystemMessage(
-                "Users parted:", *partedUsers, &this->channel_, &builder);
-            builder->flags.set(MessageFlag::Collapsed);
-            this->channel_.addMessage(builder.release());
+    this->announceMembers("Users joined:", batch.namedJoins, batch.moreJoins);
+    this->announceMembers("Users parted:", batch.namedParts, batch.moreParts);
+}
 
-            partedUsers->clear();
-            this->partedUsersMergeQueued_ = false;
-        });
+void ChannelChatters::announceMembers(const QString &prefix,
+                                      const QStringList &users, size_t more)
+{
+    if (users.isEmpty() && more == 0)
+    {
+        return;
     }
+
+    MessageBuilder builder;
+    TwitchMessageBuilder::listOfUsersSystemMessage(
+        prefix, users, &this->channel_, &builder, more);
+    builder->flags.set(MessageFlag::Collapsed);
+    this->channel_.addMessage(builder.release());
 }
 
 void ChannelChatters::updateOnlineChatters(
-    const std::unordered_set<QString> &usernames)
+    const std::vector<QString> &usernames)
 {
     auto chatters = this->chatters_.access();
     chatters->updateOnlineChatters(usernames);
@@ -82,29 +92,48 @@ void ChannelChatters::updateOnlineChatters(
 
 size_t ChannelChatters::colorsSize() const
 {
-    auto size = this->chatterColors_.access()->size();
-    return size;
+    return this->chatterColors_.accessConst()->entries.size();
 }
 
-const QColor ChannelChatters::getUserColor(const QString &user)
+const QColor ChannelChatters::getUserColor(const QString &user) const
 {
-    const auto chatterColors = this->chatterColors_.access();
+    const auto chatterColors = this->chatterColors_.accessConst();
 
-    auto lowerUser = user.toLower();
-
-    if (!chatterColors->exists(lowerUser))
+    auto it = chatterColors->entries.find(user.toLower());
+    if (it == chatterColors->entries.end())
     {
         // Returns an invalid color so we can decide not to override `textColor`
         return QColor();
     }
 
-    return QColor::fromRgb(chatterColors->get(lowerUser));
+    return QColor::fromRgb(it->second.color);
 }
 
 void ChannelChatters::setUserColor(const QString &user, const QColor &color)
 {
-    const auto chatterColors = this->chatterColors_.access();
-    chatterColors->put(user.toLower(), color.rgb());
+    auto lowerUser = user.toLower();
+    auto chatterColors = this->chatterColors_.access();
+    auto &order = chatterColors->order;
+    auto &entries = chatterColors->entries;
+
+    auto it = entries.find(lowerUser);
+    if (it != entries.end())
+    {
+        // moves the node, nothing is allocated for users that keep chatting
+        it->second.color = color.rgb();
+        order.splice(order.begin(), order, it->second.position);
+        return;
+    }
+
+    order.push_front(lowerUser);
+    entries.emplace(std::move(lowerUser),
+                    ChatterColors::Entry{color.rgb(), order.begin()});
+
+    if (entries.size() > size_t(ChannelChatters::maxChatterColorCount))
+    {
+        entries.erase(order.back());
+        order.pop_back();
+    }
 }
 
 }  // namespace chatterino
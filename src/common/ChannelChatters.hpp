@@ -2,12 +2,15 @@
 
 #include "common/Channel.hpp"
 #include "common/ChatterSet.hpp"
+#include "common/MembershipDeltas.hpp"
 #include "common/UniqueAccess.hpp"
-#include "lrucache/lrucache.hpp"
 #include "util/QStringHash.hpp"
 
 #include <QRgb>
 
+#include <list>
+#include <unordered_map>
+
 namespace chatterino {
 
 class ChannelChatters
@@ -19,30 +22,53 @@ public:
     SharedAccessGuard<const ChatterSet> accessChatters() const;
 
     void addRecentChatter(const QString &user);
-    void addJoinedUser(const QString &user);
-    void addPartedUser(const QString &user);
-    const QColor getUserColor(const QString &user);
+    /// Joins and parts are merged for 500ms, announce is whether the user
+    /// is named in the "Users joined:"/"Users parted:" message
+    void addJoinedUser(const QString &user, bool announce = true);
+    void addPartedUser(const QString &user, bool announce = true);
+    /// Doesn't change which colors are dropped first, so lookups while
+    /// building messages only need a shared lock
+    const QColor getUserColor(const QString &user) const;
     void setUserColor(const QString &user, const QColor &color);
-    void updateOnlineChatters(const std::unordered_set<QString> &usernames);
+    /// usernames have to be sorted and in lower case
+    void updateOnlineChatters(const std::vector<QString> &usernames);
 
     // colorsSize returns the amount of colors stored in `chatterColors_`
     // NOTE: This function is only meant to be used in tests and benchmarks
     size_t colorsSize() const;
 
     static constexpr int maxChatterColorCount = 5000;
+    /// Users named in one joined/parted message, the rest are counted
+    static constexpr size_t maxNamedMembers = 100;
 
 private:
+    void queueMembershipFlush();
+    void flushMembership();
+    void announceMembers(const QString &prefix, const QStringList &users,
+                         size_t more);
+
     Channel &channel_;
 
     // maps 2 char prefix to set of names
     UniqueAccess<ChatterSet> chatters_;
-    UniqueAccess<cache::lru_cache<QString, QRgb>> chatterColors_;
 
-    // combines multiple joins/parts into one message
-    UniqueAccess<QStringList> joinedUsers_;
-    bool joinedUsersMergeQueued_ = false;
-    UniqueAccess<QStringList> partedUsers_;
-    bool partedUsersMergeQueued_ = false;
+    // Colors by lower case login, the one that was set the longest time ago
+    // is dropped first. Both containers share the string of a login.
+    struct ChatterColors {
+        struct Entry {
+            QRgb color;
+            std::list<QString>::iterator position;
+        };
+
+        // most recently set first
+        std::list<QString> order;
+        std::unordered_map<QString, Entry, QStringHash> entries;
+    };
+    UniqueAccess<ChatterColors> chatterColors_;
+
+    // combines multiple joins/parts into one update
+    UniqueAccess<MembershipDeltas> membership_;
+    bool membershipFlushQueued_ = false;
 
     QObject lifetimeGuard_;
 };
@@ -0,0 +1,100 @@
+#include "common/ChannelLoadScheduler.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "singletons/Settings.hpp"
+#include "util/PostToThread.hpp"
+
+#include <algorithm>
+#include <atomic>
+
+namespace chatterino {
+
+namespace {
+
+    // Emote and badge requests are small, these only keep a few hundred
+    // channels from starting all of them at once
+    constexpr int MAX_RUNNING_EMOTE_LOADS = 8;
+    constexpr int MAX_RUNNING_BADGE_LOADS = 8;
+
+}  // namespace
+
+ChannelLoadScheduler &ChannelLoadScheduler::instance()
+{
+    static ChannelLoadScheduler instance;
+    return instance;
+}
+
+void ChannelLoadScheduler::enqueue(Resource resource, LoadPriority priority,
+                                   Load load)
+{
+    assertInGuiThread();
+
+    auto &queue = this->queues_[size_t(resource)];
+    queue.pending[size_t(priority)].push_back(std::move(load));
+
+    this->startNext(resource);
+}
+
+std::shared_ptr<void> ChannelLoadScheduler::doneOnDestroy(Done done)
+{
+    return std::shared_ptr<void>(nullptr, [done = std::move(done)](void *) {
+        done();
+    });
+}
+
+int ChannelLoadScheduler::maxRunning(Resource resource)
+{
+    switch (resource)
+    {
+        case Resource::History: {
+            int limit = getSettings()->twitchMessageHistoryConcurrentLoads;
+            return std::max(1, limit);
+        }
+        case Resource::Emotes:
+            return MAX_RUNNING_EMOTE_LOADS;
+        case Resource::Badges:
+            return MAX_RUNNING_BADGE_LOADS;
+    }
+
+    return 1;
+}
+
+void ChannelLoadScheduler::startNext(Resource resource)
+{
+    auto &queue = this->queues_[size_t(resource)];
+    auto limit = maxRunning(resource);
+
+    for (auto &pending : queue.pending)
+    {
+        while (queue.running < limit && !pending.empty())
+        {
+            auto load = std::move(pending.front());
+            pending.pop_front();
+            queue.running++;
+
+            auto called = std::make_shared<std::atomic<bool>>(false);
+            load([this, resource, called] {
+                if (called->exchange(true))
+                {
+                    return;
+                }
+
+                auto finish = [this, resource] {
+                    this->queues_[size_t(resource)].running--;
+                    this->startNext(resource);
+                };
+
+                if (isGuiThread())
+                {
+                    finish();
+                }
+                else
+                {
+                    postToThread(finish);
+                }
+            });
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <memory>
+
+namespace chatterino {
+
+// How soon the messages of a channel are going to be looked at, lower loads
+// first. See WindowManager::loadPriority
+enum class LoadPriority {
+    // shown in the selected tab of a window
+    SelectedTab,
+    // shown in another tab of a visible window
+    VisibleWindow,
+    // only shown in minimized windows or not at all
+    Hidden,
+};
+
+/**
+ * @brief Orders the work channels do when they are opened.
+ *
+ * Restoring a big window layout opens every channel at once. Each of them
+ * loads its history, emotes and badges, so the resources are queued here
+ * separately and only a few loads of each run at the same time. Loads for the
+ * selected tabs are started before everything else.
+ *
+ * Gui thread only.
+ */
+class ChannelLoadScheduler
+{
+public:
+    enum class Resource {
+        History,
+        Emotes,
+        Badges,
+    };
+
+    // Has to be called once the load finished. It may be called from any
+    // thread and more than once, only the first call counts.
+    using Done = std::function<void()>;
+    using Load = std::function<void(Done done)>;
+
+    static ChannelLoadScheduler &instance();
+
+    void enqueue(Resource resource, LoadPriority priority, Load load);
+
+    // Calls done when the returned pointer and all copies of it are
+    // destroyed. Loads that don't report all of their outcomes can capture it
+    // in their callbacks instead of calling done.
+    static std::shared_ptr<void> doneOnDestroy(Done done);
+
+private:
+    struct Queue {
+        std::array<std::deque<Load>, 3> pending;
+        int running = 0;
+    };
+
+    static int maxRunning(Resource resource);
+
+    void startNext(Resource resource);
+
+    std::array<Queue, 3> queues_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,311 @@
+#include "common/ChannelProjection.hpp"
+
+#include "Application.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "controllers/filters/FilterSet.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageBuilder.hpp"
+#include "providers/twitch/TwitchAccount.hpp"
+#include "singletons/Settings.hpp"
+
+#include <QLocale>
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    // projections in use, there are only as many as there are views
+    std::vector<std::weak_ptr<ChannelProjection>> &projections()
+    {
+        static std::vector<std::weak_ptr<ChannelProjection>> projections;
+        return projections;
+    }
+
+}  // namespace
+
+std::shared_ptr<ChannelProjection> ChannelProjection::get(
+    const ChannelPtr &source, QList<QUuid> filterIds)
+{
+    std::sort(filterIds.begin(), filterIds.end());
+
+    auto &all = projections();
+    all.erase(std::remove_if(all.begin(), all.end(),
+                             [](const auto &projection) {
+                                 return projection.expired();
+                             }),
+              all.end());
+
+    for (const auto &weak : all)
+    {
+        auto projection = weak.lock();
+        if (projection->source_ == source &&
+            projection->filterIds_ == filterIds)
+        {
+            return projection;
+        }
+    }
+
+    auto projection =
+        std::make_shared<ChannelProjection>(source, std::move(filterIds));
+    all.push_back(projection);
+    return projection;
+}
+
+ChannelProjection::ChannelProjection(ChannelPtr source, QList<QUuid> filterIds)
+    : source_(std::move(source))
+    , filterIds_(std::move(filterIds))
+    , channel_(std::make_shared<Channel>(this->source_->getName(),
+                                         this->source_->getType()))
+{
+    if (!this->filterIds_.isEmpty())
+    {
+        this->filters_ = std::make_shared<FilterSet>(this->filterIds_);
+    }
+
+    this->channel_->setMessageLimit(this->source_->getMessageLimit());
+
+    // the messages already in the source
+    auto snapshot = this->source_->getMessageSnapshot();
+    std::vector<MessagePtr> included;
+    int64_t position = 0;
+    for (const auto &message : snapshot)
+    {
+        if (this->includes(message))
+        {
+            this->entries_.push_back({position, message});
+            included.push_back(message);
+        }
+        position++;
+    }
+    this->sourceEnd_ = int64_t(snapshot.size());
+
+    if (!included.empty())
+    {
+        this->channel_->addMessagesAtStart(included);
+    }
+
+    // during busy moments many messages arrive at once, the views handle
+    // them together
+    this->channel_->setBatchedAppends(true);
+
+    this->connections_.managedConnect(
+        this->source_->messageAppended,
+        [this](MessagePtr &message,
+               boost::optional<MessageFlags> overridingFlags) {
+            this->append(message, overridingFlags);
+        });
+    // sources like search results batch their appends as well
+    this->connections_.managedConnect(
+        this->source_->messagesAppended,
+        [this](std::vector<Channel::AppendedMessage> &messages) {
+            for (const auto &appended : messages)
+            {
+                this->append(appended.message, appended.overridingFlags);
+            }
+        });
+    this->connections_.managedConnect(
+        this->source_->messagesAddedAtStart,
+        [this](std::vector<MessagePtr> &messages) {
+            this->addAtStart(messages);
+        });
+    this->connections_.managedConnect(
+        this->source_->messageReplaced,
+        [this](size_t index, MessagePtr &replacement) {
+            this->replace(index, replacement);
+        });
+    this->connections_.managedConnect(
+        this->source_->messagesChanged, [this](std::vector<size_t> &indices) {
+            this->change(indices);
+        });
+    this->connections_.managedConnect(this->source_->messageRemovedFromStart,
+                                      [this](MessagePtr &) {
+                                          this->removeFromStart();
+                                      });
+    // the views drop the messages over a lower limit as well
+    this->connections_.managedConnect(
+        this->source_->messageLimitChanged, [this] {
+            this->channel_->setMessageLimit(this->source_->getMessageLimit());
+        });
+}
+
+const ChannelPtr &ChannelProjection::channel() const
+{
+    return this->channel_;
+}
+
+const ChannelPtr &ChannelProjection::source() const
+{
+    return this->source_;
+}
+
+const QList<QUuid> &ChannelProjection::filterIds() const
+{
+    return this->filterIds_;
+}
+
+bool ChannelProjection::includes(const MessagePtr &message) const
+{
+    if (!this->filters_)
+    {
+        return true;
+    }
+
+    if (getSettings()->excludeUserMessagesFromFilter &&
+        getApp()->accounts->twitch.getCurrent()->getUserName().compare(
+            message->loginName, Qt::CaseInsensitive) == 0)
+    {
+        return true;
+    }
+
+    return this->filters_->filter(message, this->channel_);
+}
+
+void ChannelProjection::append(const MessagePtr &message,
+                               boost::optional<MessageFlags> overridingFlags)
+{
+    auto position = this->sourceEnd_++;
+
+    if (!this->includes(message))
+    {
+        return;
+    }
+
+    if (this->channel_->lastDate_ != QDate::currentDate())
+    {
+        this->channel_->lastDate_ = QDate::currentDate();
+        auto msg = makeSystemMessage(
+            QLocale().toString(QDate::currentDate(), QLocale::LongFormat),
+            QTime(0, 0));
+        this->channel_->addMessage(msg);
+    }
+
+    // When the message was received in the source, logging will be
+    // handled. Prevent duplications.
+    if (!overridingFlags)
+    {
+        overridingFlags = MessageFlags(message->flags);
+    }
+    overridingFlags->set(MessageFlag::DoNotLog);
+
+    this->entries_.push_back({position, message});
+    this->channel_->addMessage(message, overridingFlags);
+}
+
+void ChannelProjection::addAtStart(const std::vector<MessagePtr> &messages)
+{
+    this->sourceStart_ -= int64_t(messages.size());
+
+    std::vector<MessagePtr> included;
+    std::deque<Entry> entries;
+    for (size_t i = 0; i < messages.size(); i++)
+    {
+        if (this->includes(messages[i]))
+        {
+            entries.push_back({this->sourceStart_ + int64_t(i), messages[i]});
+            included.push_back(messages[i]);
+        }
+    }
+
+    if (included.empty())
+    {
+        return;
+    }
+
+    this->entries_.insert(this->entries_.begin(), entries.begin(),
+                          entries.end());
+    this->channel_->addMessagesAtStart(included);
+}
+
+void ChannelProjection::replace(size_t index, const MessagePtr &replacement)
+{
+    auto position = this->sourceStart_ + int64_t(index);
+    auto it = std::lower_bound(this->entries_.begin(), this->entries_.end(),
+                               position, [](const Entry &entry, int64_t p) {
+                                   return entry.position < p;
+                               });
+
+    // the replaced message was filtered out, there is nothing to replace
+    if (it == this->entries_.end() || it->position != position)
+    {
+        return;
+    }
+
+    if (!this->includes(replacement))
+    {
+        return;
+    }
+
+    auto previous = std::move(it->message);
+    it->message = replacement;
+    this->channel_->replaceMessage(previous, replacement);
+}
+
+void ChannelProjection::change(const std::vector<size_t> &indices)
+{
+    // the changed messages that passed the filters, in order
+    std::vector<MessagePtr> changed;
+    auto it = this->entries_.begin();
+    for (auto index : indices)
+    {
+        auto position = this->sourceStart_ + int64_t(index);
+        it = std::lower_bound(it, this->entries_.end(), position,
+                              [](const Entry &entry, int64_t p) {
+                                  return entry.position < p;
+                              });
+        if (it == this->entries_.end())
+        {
+            break;
+        }
+        if (it->position == position)
+        {
+            changed.push_back(it->message);
+        }
+    }
+
+    if (changed.empty())
+    {
+        return;
+    }
+
+    // the messages are the same in both channels, they only have to be found
+    // in the projection. Moderation mostly concerns recent messages, so it's
+    // searched from the end.
+    this->channel_->flushAppendedMessages();
+    auto snapshot = this->channel_->getMessageSnapshot();
+    std::vector<size_t> channelIndices;
+    auto next = changed.rbegin();
+    for (auto it = snapshot.rbegin();
+         it != snapshot.rend() && next != changed.rend(); ++it)
+    {
+        if (*it == *next)
+        {
+            channelIndices.push_back(size_t(snapshot.rend() - it) - 1);
+            ++next;
+        }
+    }
+
+    if (channelIndices.empty())
+    {
+        return;
+    }
+
+    std::reverse(channelIndices.begin(), channelIndices.end());
+    this->channel_->messagesChanged.invoke(channelIndices);
+}
+
+void ChannelProjection::removeFromStart()
+{
+    this->sourceStart_++;
+
+    // messages gone from the source can't be replaced anymore, they stay in
+    // the projection until it runs out of space
+    while (!this->entries_.empty() &&
+           this->entries_.front().position < this->sourceStart_)
+    {
+        this->entries_.pop_front();
+    }
+}
+
+}  // namespace chatterino
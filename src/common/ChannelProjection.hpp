@@ -0,0 +1,84 @@
+#pragma once
+
+#include "common/Channel.hpp"
+
+#include <QList>
+#include <QUuid>
+#include <pajlada/signals/signalholder.hpp>
+
+#include <deque>
+#include <memory>
+
+namespace chatterino {
+
+class FilterSet;
+using FilterSetPtr = std::shared_ptr<FilterSet>;
+
+/**
+ * @brief The messages of a source channel that pass a set of filters.
+ *
+ * Views showing a channel don't show its messages directly, they keep the
+ * messages that passed their filters for longer than the source channel and
+ * don't log them again. All views of the same channel with the same filters
+ * share one projection, so the filters are checked once per message and the
+ * filtered messages are stored once no matter how many splits show them.
+ *
+ * The projection remembers the position in the source channel of every
+ * message it took from it, so messages replaced in the source are replaced
+ * at the right index even if earlier messages were filtered out.
+ *
+ * Gui thread only.
+ */
+class ChannelProjection
+{
+public:
+    /// Returns the projection of the source channel with the filters, it's
+    /// created if no view uses it yet. The order of the ids doesn't matter.
+    static std::shared_ptr<ChannelProjection> get(const ChannelPtr &source,
+                                                  QList<QUuid> filterIds);
+
+    ChannelProjection(ChannelPtr source, QList<QUuid> filterIds);
+
+    ChannelProjection(const ChannelProjection &) = delete;
+    ChannelProjection &operator=(const ChannelProjection &) = delete;
+
+    /// The channel holding the filtered messages. Its appends are batched.
+    const ChannelPtr &channel() const;
+    const ChannelPtr &source() const;
+    /// Sorted ids of the filters
+    const QList<QUuid> &filterIds() const;
+
+    /// Returns true if the message should be included
+    bool includes(const MessagePtr &message) const;
+
+private:
+    // a message taken from the source and its position there
+    struct Entry {
+        int64_t position;
+        MessagePtr message;
+    };
+
+    void append(const MessagePtr &message,
+                boost::optional<MessageFlags> overridingFlags);
+    void addAtStart(const std::vector<MessagePtr> &messages);
+    void replace(size_t index, const MessagePtr &replacement);
+    void change(const std::vector<size_t> &indices);
+    void removeFromStart();
+
+    ChannelPtr source_;
+    QList<QUuid> filterIds_;
+    FilterSetPtr filters_;
+    ChannelPtr channel_;
+
+    // Positions count the messages of the source like the index of the
+    // source does: appends increase sourceEnd_, messages added at the start
+    // decrease sourceStart_. entries_ is sorted by position and only holds
+    // messages still in the source, the ones that could be replaced.
+    std::deque<Entry> entries_;
+    int64_t sourceStart_ = 0;
+    int64_t sourceEnd_ = 0;
+
+    pajlada::Signals::SignalHolder connections_;
+};
+
+}  // namespace chatterino
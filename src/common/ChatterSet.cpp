@@ -1,44 +1,130 @@
 #include "common/ChatterSet.hpp"
 
-#include <tuple>
 #include "debug/Benchmark.hpp"
+#include "util/MemoryUsage.hpp"
+#include "util/StringPool.hpp"
+
+#include <algorithm>
+#include <iterator>
 
 namespace chatterino {
 
 ChatterSet::ChatterSet()
-    : items(chatterLimit)
 {
 }
 
+ChatterSet::~ChatterSet()
+{
+    MemoryUsage::decrease(MemoryCategory::Chatters, this->accountedBytes_);
+}
+
 void ChatterSet::addRecentChatter(const QString &userName)
 {
-    this->items.put(userName.toLower(), userName);
+    this->put(userName.toLower(), userName);
+}
+
+void ChatterSet::put(const QString &lowerCaseName, const QString &name)
+{
+    auto it = this->byName_.find(lowerCaseName);
+
+    if (it != this->byName_.end())
+    {
+        it->second->name = name;
+        this->recent_.splice(this->recent_.begin(), this->recent_, it->second);
+        return;
+    }
+
+    auto interned = StringPool::instance().intern(lowerCaseName);
+    this->recent_.push_front(
+        {interned, name == lowerCaseName ? interned : name});
+    this->byName_.emplace(interned, this->recent_.begin());
+
+    this->evict();
+    this->account();
+}
+
+void ChatterSet::evict()
+{
+    while (this->recent_.size() > chatterLimit)
+    {
+        this->byName_.erase(this->recent_.back().lowerCaseName);
+        this->recent_.pop_back();
+    }
 }
 
 void ChatterSet::updateOnlineChatters(
-    const std::unordered_set<QString> &lowerCaseUsernames)
+    const std::vector<QString> &lowerCaseUsernames)
 {
     BenchmarkGuard bench("update online chatters");
 
-    // Create a new lru cache without the users that are not present anymore.
-    cache::lru_cache<QString, QString> tmp(chatterLimit);
+    // Remove the users that are not present anymore, only the contained
+    // chatters have to be looked up in the (sorted) list of online users.
+    for (auto it = this->recent_.begin(); it != this->recent_.end();)
+    {
+        if (std::binary_search(lowerCaseUsernames.begin(),
+                               lowerCaseUsernames.end(), it->lowerCaseName))
+        {
+            it++;
+        }
+        else
+        {
+            this->byName_.erase(it->lowerCaseName);
+            it = this->recent_.erase(it);
+        }
+    }
 
-    for (auto &&chatter : lowerCaseUsernames)
+    // Less chatters than the limit => try to preserve as many as possible.
+    if (lowerCaseUsernames.size() < chatterLimit)
     {
-        if (this->items.exists(chatter))
-            tmp.put(chatter, this->items.get(chatter));
+        for (const auto &chatter : lowerCaseUsernames)
+        {
+            if (this->byName_.find(chatter) == this->byName_.end())
+            {
+                auto interned = StringPool::instance().intern(chatter);
+                this->recent_.push_back({interned, interned});
+                this->byName_.emplace(interned, std::prev(this->recent_.end()));
+            }
+        }
+    }
+
+    this->account();
+}
 
-        // Less chatters than the limit => try to preserve as many as possible.
-        else if (lowerCaseUsernames.size() < chatterLimit)
-            tmp.put(chatter, chatter);
+void ChatterSet::updateMembership(
+    const std::vector<QString> &lowerCaseJoined,
+    const std::vector<QString> &lowerCaseParted)
+{
+    for (const auto &chatter : lowerCaseParted)
+    {
+        auto it = this->byName_.find(chatter);
+        if (it != this->byName_.end())
+        {
+            this->recent_.erase(it->second);
+            this->byName_.erase(it);
+        }
     }
 
-    this->items = std::move(tmp);
+    // joining isn't chatting, so they don't push out recent chatters
+    for (const auto &chatter : lowerCaseJoined)
+    {
+        if (this->recent_.size() >= chatterLimit)
+        {
+            break;
+        }
+        if (this->byName_.find(chatter) == this->byName_.end())
+        {
+            auto interned = StringPool::instance().intern(chatter);
+            this->recent_.push_back({interned, interned});
+            this->byName_.emplace(interned, std::prev(this->recent_.end()));
+        }
+    }
+
+    this->account();
 }
 
 bool ChatterSet::contains(const QString &userName) const
 {
-    return this->items.exists(userName.toLower());
+    return this->byName_.find(userName.toLower()) != this->byName_.end();
 }
 
 std::vector<QString> ChatterSet::filterByPrefix(const QString &prefix) const
@@ -46,13 +132,38 @@ std::vector<QString> ChatterSet::filterByPrefix(const QString &prefix) const
     QString lowerPrefix = prefix.toLower();
     std::vector<QString> result;
 
-    for (auto &&item : this->items)
+    // all names starting with the prefix sort right after it
+    for (auto it = this->byName_.lower_bound(lowerPrefix);
+         it != this->byName_.end() && it->first.startsWith(lowerPrefix); it++)
     {
-        if (item.first.startsWith(lowerPrefix))
-            result.push_back(item.second);
+        result.push_back(it->second->name);
     }
 
     return result;
 }
 
+size_t ChatterSet::size() const
+{
+    return this->recent_.size();
+}
+
+int64_t ChatterSet::bytes() const
+{
+    // a list node has two pointers, a map node four and the color of the
+    // tree. Names are short and mostly interned, so they aren't counted.
+    constexpr size_t chatterBytes = sizeof(Chatter) + 2 * sizeof(void *) +
+                                    sizeof(std::pair<QString, void *>) +
+                                    4 * sizeof(void *);
+
+    return int64_t(this->recent_.size() * chatterBytes);
+}
+
+void ChatterSet::account()
+{
+    auto bytes = this->bytes();
+    MemoryUsage::increase(MemoryCategory::Chatters,
+                          bytes - this->accountedBytes_);
+    this->accountedBytes_ = bytes;
+}
+
 }  // namespace chatterino
@@ -2,10 +2,9 @@
 
 #include <QString>
 #include <functional>
-#include <set>
-#include <unordered_map>
-#include <unordered_set>
-#include "lrucache/lrucache.hpp"
+#include <list>
+#include <map>
+#include <vector>
 #include "util/QStringHash.hpp"
 
 namespace chatterino {
@@ -19,15 +18,23 @@ public:
     static constexpr size_t chatterLimit = 2000;
 
     ChatterSet();
+    ~ChatterSet();
+
+    ChatterSet(const ChatterSet &) = delete;
+    ChatterSet &operator=(const ChatterSet &) = delete;
 
     /// Inserts a user name if it isn't contained. Doesn't replace the original
     /// if the casing hasn't changed.
     void addRecentChatter(const QString &userName);
 
     /// Removes chatters that aren't online anymore. Adds chatters that aren't
-    /// in the list yet.
-    void updateOnlineChatters(
-        const std::unordered_set<QString> &lowerCaseUsernames);
+    /// in the list yet. lowerCaseUsernames has to be sorted.
+    void updateOnlineChatters(const std::vector<QString> &lowerCaseUsernames);
+
+    /// Removes the users that parted, adds the ones that joined while there is
+    /// room. Both have to be in lower case.
+    void updateMembership(const std::vector<QString> &lowerCaseJoined,
+                          const std::vector<QString> &lowerCaseParted);
 
     /// Checks if a username is in the list.
     bool contains(const QString &userName) const;
@@ -36,11 +43,28 @@ public:
     /// are in mixed case if available.
     std::vector<QString> filterByPrefix(const QString &prefix) const;
 
+    size_t size() const;
+
+    /// Estimate of the memory held by the list
+    int64_t bytes() const;
+
 private:
-    // user name in lower case -> user name in normal case
-    cache::lru_cache<QString, QString> items;
-};
+    struct Chatter {
+        // interned, see StringPool
+        QString lowerCaseName;
+        QString name;
+    };
+
+    void put(const QString &lowerCaseName, const QString &name);
+    void evict();
+    // updates the memory usage of chatter lists after a change
+    void account();
 
-using ChatterSet = ChatterSet;
+    // most recent chatter first
+    std::list<Chatter> recent_;
+    // sorted by user name in lower case for prefix searches
+    std::map<QString, std::list<Chatter>::iterator> byName_;
+    int64_t accountedBytes_ = 0;
+};
 
 }  // namespace chatterino
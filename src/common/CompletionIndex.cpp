@@ -0,0 +1,282 @@
+#include "common/CompletionIndex.hpp"
+
+#include "util/Hotness.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr int SCORE_MATCH = 16;
+    // a matched character at the start of a word, twice that for the first
+    // character of the query
+    constexpr int BONUS_BOUNDARY = 8;
+    constexpr int BONUS_CONSECUTIVE = 4;
+    // the candidate starts with the query's first character
+    constexpr int BONUS_PREFIX = 8;
+    // the whole candidate was typed
+    constexpr int BONUS_EXACT = 64;
+    constexpr int PENALTY_GAP_START = 3;
+    constexpr int PENALTY_GAP_EXTENSION = 1;
+
+    // the largest usage bonus, about what a word start is worth
+    constexpr double USAGE_SCALE = 12;
+    constexpr double USAGE_FADE_DAYS = 3;
+    // the largest hotness bonus, reached at 63 recent hits
+    constexpr double HOTNESS_SCALE = 6;
+
+    // Bits 0-25 are the letters, 26-35 the digits, everything else shares
+    // the remaining bits. A candidate can only match if it has all bits of
+    // the query.
+    uint64_t maskOf(QStringView lowercase)
+    {
+        uint64_t mask = 0;
+        for (auto c : lowercase)
+        {
+            auto unit = c.unicode();
+            if (unit >= 'a' && unit <= 'z')
+            {
+                mask |= uint64_t(1) << (unit - 'a');
+            }
+            else if (unit >= '0' && unit <= '9')
+            {
+                mask |= uint64_t(1) << (26 + unit - '0');
+            }
+            else
+            {
+                mask |= uint64_t(1) << (36 + unit % 28);
+            }
+        }
+        return mask;
+    }
+
+    // e.g. the 'C' of "PogChamp" or the 'h' of "peepo_happy"
+    bool isWordStart(QStringView original, qsizetype i)
+    {
+        if (i == 0)
+        {
+            return true;
+        }
+
+        auto previous = original[i - 1];
+        auto current = original[i];
+        return !previous.isLetterOrNumber() ||
+               (previous.isLower() && current.isUpper()) ||
+               (previous.isDigit() != current.isDigit());
+    }
+
+}  // namespace
+
+namespace detail {
+
+    boost::optional<int> fuzzyScore(QStringView query, QStringView candidate,
+                                    QStringView original)
+    {
+        if (query.isEmpty())
+        {
+            return 0;
+        }
+
+        // the first position where all of query has been seen
+        qsizetype j = 0;
+        qsizetype end = -1;
+        for (qsizetype i = 0; i < candidate.size(); i++)
+        {
+            if (candidate[i] == query[j] && ++j == query.size())
+            {
+                end = i;
+                break;
+            }
+        }
+        if (end == -1)
+        {
+            return boost::none;
+        }
+
+        // going back from there finds the shortest window ending there
+        qsizetype start = end;
+        j = query.size() - 1;
+        for (qsizetype i = end; i >= 0; i--)
+        {
+            if (candidate[i] == query[j] && j-- == 0)
+            {
+                start = i;
+                break;
+            }
+        }
+
+        int score = 0;
+        bool inGap = false;
+        qsizetype lastMatch = -2;
+        j = 0;
+        for (qsizetype i = start; i <= end; i++)
+        {
+            if (j < query.size() && candidate[i] == query[j])
+            {
+                score += SCORE_MATCH;
+                if (isWordStart(original, i))
+                {
+                    score += j == 0 ? 2 * BONUS_BOUNDARY : BONUS_BOUNDARY;
+                }
+                if (lastMatch == i - 1)
+                {
+                    score += BONUS_CONSECUTIVE;
+                }
+                lastMatch = i;
+                inGap = false;
+                j++;
+            }
+            else
+            {
+                score -= inGap ? PENALTY_GAP_EXTENSION : PENALTY_GAP_START;
+                inGap = true;
+            }
+        }
+
+        if (start == 0)
+        {
+            score += BONUS_PREFIX;
+        }
+        // query is a subsequence, so with the same length it's the candidate
+        if (query.size() == candidate.size())
+        {
+            score += BONUS_EXACT;
+        }
+        return score;
+    }
+
+}  // namespace detail
+
+//
+// CompletionUsage
+//
+
+void CompletionUsage::used(const QString &string)
+{
+    auto &usage = this->usages_[string];
+    usage.count++;
+    usage.last = std::chrono::steady_clock::now();
+}
+
+int CompletionUsage::bonus(const QString &string) const
+{
+    if (this->usages_.empty())
+    {
+        return 0;
+    }
+
+    auto it = this->usages_.find(string);
+    if (it == this->usages_.end())
+    {
+        return 0;
+    }
+
+    using Days = std::chrono::duration<double, std::ratio<86400>>;
+    auto days = std::chrono::duration_cast<Days>(
+                    std::chrono::steady_clock::now() - it->second.last)
+                    .count();
+    // 1 use is worth a third of the largest bonus, 7 uses all of it
+    auto uses = std::min(std::log2(1 + it->second.count) / 3, 1.0);
+    return int(USAGE_SCALE * uses / (1 + days / USAGE_FADE_DAYS));
+}
+
+//
+// CompletionIndex
+//
+
+void CompletionIndex::clear()
+{
+    this->entries_.clear();
+}
+
+void CompletionIndex::reserve(size_t count)
+{
+    this->entries_.reserve(count);
+}
+
+void CompletionIndex::add(const QString &string)
+{
+    auto key = string.toLower();
+    auto mask = maskOf(key);
+    this->entries_.push_back({string, std::move(key), mask});
+}
+
+size_t CompletionIndex::size() const
+{
+    return this->entries_.size();
+}
+
+const QString &CompletionIndex::string(size_t index) const
+{
+    return this->entries_.at(index).string;
+}
+
+std::vector<CompletionIndex::Match> CompletionIndex::find(
+    const QString &query, size_t limit, const CompletionUsage *usage,
+    const Hotness *hotness) const
+{
+    auto key = query.toLower();
+    auto mask = maskOf(key);
+
+    std::vector<Match> matches;
+    for (size_t i = 0; i < this->entries_.size(); i++)
+    {
+        const auto &entry = this->entries_[i];
+        if ((entry.mask & mask) != mask)
+        {
+            continue;
+        }
+
+        // lowercasing changes the length of a few rare characters, the case
+        // changes of those aren't known then
+        const auto &original = entry.string.size() == entry.key.size()
+                                   ? entry.string
+                                   : entry.key;
+        auto score = detail::fuzzyScore(key, entry.key, original);
+        if (!score)
+        {
+            continue;
+        }
+
+        if (usage != nullptr)
+        {
+            *score += usage->bonus(entry.string);
+        }
+        if (hotness != nullptr)
+        {
+            *score += int(std::min(
+                std::log2(1 + double(hotness->score(entry.string))),
+                HOTNESS_SCALE));
+        }
+        matches.push_back({i, *score});
+    }
+
+    auto isBetter = [this](const Match &a, const Match &b) {
+        if (a.score != b.score)
+        {
+            return a.score > b.score;
+        }
+        auto aSize = this->entries_[a.index].string.size();
+        auto bSize = this->entries_[b.index].string.size();
+        if (aSize != bSize)
+        {
+            return aSize < bSize;
+        }
+        return a.index < b.index;
+    };
+
+    // only the matches that are shown are sorted
+    if (matches.size() > limit)
+    {
+        std::nth_element(matches.begin(), matches.begin() + ptrdiff_t(limit),
+                         matches.end(), isBetter);
+        matches.resize(limit);
+    }
+    std::sort(matches.begin(), matches.end(), isBetter);
+
+    return matches;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <QString>
+#include <QStringView>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+class Hotness;
+
+namespace detail {
+
+    /// How well query matches candidate as a subsequence, in the spirit of
+    /// fzf: consecutive characters and characters at the start of a word
+    /// (after a separator or at a case change) score higher, gaps cost. Both
+    /// have to be lowercase, original is candidate as it's shown and is used
+    /// for the case changes. Returns nothing if query isn't a subsequence.
+    boost::optional<int> fuzzyScore(QStringView query, QStringView candidate,
+                                    QStringView original);
+
+}  // namespace detail
+
+/**
+ * @brief Remembers which completions were picked, so the ones that are used
+ *        often and recently can be ranked higher.
+ *
+ * Only kept while Chatterino runs. Gui thread only.
+ */
+class CompletionUsage : boost::noncopyable
+{
+public:
+    void used(const QString &string);
+
+    /// Added to the score of string, grows with the number of uses and fades
+    /// over a few days after the last one
+    int bonus(const QString &string) const;
+
+private:
+    struct Usage {
+        int count = 0;
+        std::chrono::steady_clock::time_point last;
+    };
+    std::unordered_map<QString, Usage> usages_;
+};
+
+/**
+ * @brief The candidates of a completion, e.g. all emotes of a channel,
+ *        prepared once to be matched fuzzily with every typed character.
+ *
+ * Every candidate keeps a mask of the characters it contains, so candidates
+ * that lack any character of the query are ruled out with one AND before
+ * they're scored. Only the best matches are sorted.
+ */
+class CompletionIndex
+{
+public:
+    struct Match {
+        /// In the order the candidates were added
+        size_t index;
+        int score;
+    };
+
+    void clear();
+    void reserve(size_t count);
+    void add(const QString &string);
+
+    size_t size() const;
+    const QString &string(size_t index) const;
+
+    /// The limit best matches of query, best first. Equal scores go to the
+    /// shorter candidate. Candidates that are hot get a smaller bonus than
+    /// the ones that were picked.
+    std::vector<Match> find(const QString &query, size_t limit,
+                            const CompletionUsage *usage = nullptr,
+                            const Hotness *hotness = nullptr) const;
+
+private:
+    struct Entry {
+        QString string;
+        QString key;
+        uint64_t mask;
+    };
+
+    std::vector<Entry> entries_;
+};
+
+}  // namespace chatterino
@@ -15,6 +15,7 @@
 #include "util/QStringHash.hpp"
 
 #include <QtAlgorithms>
+#include <algorithm>
 #include <utility>
 
 namespace chatterino {
@@ -44,6 +45,67 @@ bool CompletionModel::TaggedString::operator<(const TaggedString &that) const
     return CompletionModel::compareStrings(this->string, that.string);
 }
 
+//
+// Source
+//
+
+void CompletionModel::Source::update(
+    std::shared_ptr<const void> owner, uint64_t generation,
+    const std::function<std::vector<QString>()> &getStrings)
+{
+    if (this->built_ && this->owner_ == owner &&
+        this->generation_ == generation)
+    {
+        return;
+    }
+
+    this->owner_ = std::move(owner);
+    this->generation_ = generation;
+    this->built_ = true;
+
+    this->items_.clear();
+    for (auto &string : getStrings())
+    {
+        auto key = string.toLower();
+        this->items_.push_back({std::move(key), std::move(string)});
+    }
+
+    std::sort(this->items_.begin(), this->items_.end(),
+              [](const Item &a, const Item &b) {
+                  return a.key < b.key;
+              });
+}
+
+template <typename F>
+void CompletionModel::Source::forEachMatch(const QString &lowercasePrefix,
+                                           bool prefixOnly,
+                                           F &&callback) const
+{
+    if (!prefixOnly)
+    {
+        for (const auto &item : this->items_)
+        {
+            if (item.key.contains(lowercasePrefix))
+            {
+                callback(item.string);
+            }
+        }
+        return;
+    }
+
+    auto it = std::lower_bound(this->items_.begin(), this->items_.end(),
+                               lowercasePrefix,
+                               [](const Item &item, const QString &prefix) {
+                                   return item.key < prefix;
+                               });
+
+    for (; it != this->items_.end() && it->key.startsWith(lowercasePrefix);
+         it++)
+    {
+        callback(it->string);
+    }
+}
+
 //
 // CompletionModel
 //
@@ -61,16 +123,14 @@ QVariant CompletionModel::data(const QModelIndex &index, int) const
 {
     std::lock_guard<std::mutex> lock(this->itemsMutex_);
 
-    auto it = this->items_.begin();
-    std::advance(it, index.row());
-    return QVariant(it->string);
+    return QVariant(this->items_.at(size_t(index.row())).string);
 }
 
 int CompletionModel::rowCount(const QModelIndex &) const
 {
     std::lock_guard<std::mutex> lock(this->itemsMutex_);
 
-    return this->items_.size();
+    return int(this->items_.size());
 }
 
 void CompletionModel::refresh(const QString &prefix, bool isFirstWord)
@@ -86,91 +146,107 @@ void CompletionModel::refresh(const QString &prefix, bool isFirstWord)
     // Twitch channel
     auto tc = dynamic_cast<TwitchChannel *>(&this->channel_);
 
-    auto addString = [=](const QString &str, TaggedString::Type type) {
-        // Special case for handling default Twitch commands
-        if (type == TaggedString::TwitchCommand)
-        {
-            if (prefix.size() < 2)
-            {
-                return;
-            }
-
-            auto prefixChar = prefix.at(0);
-
-            static std::set<QChar> validPrefixChars{'/', '.'};
-
-            if (validPrefixChars.find(prefixChar) == validPrefixChars.end())
-            {
-                return;
-            }
-
-            if (startsWithOrContains((prefixChar + str), prefix,
-                                     Qt::CaseInsensitive,
-                                     getSettings()->prefixOnlyEmoteCompletion))
-            {
-                this->items_.emplace((prefixChar + str + " "), type);
-            }
+    const bool prefixOnly = getSettings()->prefixOnlyEmoteCompletion;
+    const auto lowercasePrefix = prefix.toLower();
 
-            return;
-        }
+    auto addMatches = [&](const Source &source, TaggedString::Type type) {
+        source.forEachMatch(lowercasePrefix, prefixOnly,
+                            [&](const QString &str) {
+                                this->items_.emplace_back(str + " ", type);
+                            });
+    };
 
-        if (startsWithOrContains(str, prefix, Qt::CaseInsensitive,
-                                 getSettings()->prefixOnlyEmoteCompletion))
+    auto emoteNames = [](const EmoteMap &emotes) {
+        std::vector<QString> names;
+        names.reserve(emotes.size());
+        for (const auto &emote : emotes)
         {
-            this->items_.emplace(str + " ", type);
+            names.push_back(emote.first.string);
         }
+        return names;
     };
 
     if (auto account = getApp()->accounts->twitch.getCurrent())
     {
         // Twitch Emotes available globally
-        for (const auto &emote : account->accessEmotes()->emotes)
+        this->twitchGlobalEmotes_.update(
+            account, account->emotesGeneration(), [&] {
+                return emoteNames(account->accessEmotes()->emotes);
+            });
+        addMatches(this->twitchGlobalEmotes_, TaggedString::TwitchGlobalEmote);
+
+        // Twitch Emotes available locally, the room id is only known once
+        // the channel is joined
+        if (tc)
         {
-            addString(emote.first.string, TaggedString::TwitchGlobalEmote);
-        }
-
-        // Twitch Emotes available locally
-        auto localEmoteData = account->accessLocalEmotes();
-        if (tc && localEmoteData->find(tc->roomId()) != localEmoteData->end())
-        {
-            for (const auto &emote : localEmoteData->at(tc->roomId()))
-            {
-                addString(emote.first.string,
-                          TaggedString::Type::TwitchLocalEmote);
-            }
+            auto roomId = tc->roomId();
+            this->twitchLocalEmotes_.update(
+                account,
+                account->emotesGeneration() * 2 + (roomId.isEmpty() ? 0 : 1),
+                [&] {
+                    auto localEmoteData = account->accessLocalEmotes();
+                    auto it = localEmoteData->find(roomId);
+                    if (it == localEmoteData->end())
+                    {
+                        return std::vector<QString>();
+                    }
+                    return emoteNames(it->second);
+                });
+            addMatches(this->twitchLocalEmotes_,
+                       TaggedString::Type::TwitchLocalEmote);
         }
     }
 
     // Bttv Global
-    for (auto &emote : *getApp()->twitch->getBttvEmotes().emotes())
-    {
-        addString(emote.first.string, TaggedString::Type::BTTVChannelEmote);
-    }
+    auto bttvGlobal = getApp()->twitch->getBttvEmotes().emotes();
+    this->bttvGlobalEmotes_.update(bttvGlobal, 0, [&] {
+        return emoteNames(*bttvGlobal);
+    });
+    addMatches(this->bttvGlobalEmotes_, TaggedString::Type::BTTVChannelEmote);
 
     // Ffz Global
-    for (auto &emote : *getApp()->twitch->getFfzEmotes().emotes())
-    {
-        addString(emote.first.string, TaggedString::Type::FFZChannelEmote);
-    }
+    auto ffzGlobal = getApp()->twitch->getFfzEmotes().emotes();
+    this->ffzGlobalEmotes_.update(ffzGlobal, 0, [&] {
+        return emoteNames(*ffzGlobal);
+    });
+    addMatches(this->ffzGlobalEmotes_, TaggedString::Type::FFZChannelEmote);
 
     // Emojis
     if (prefix.startsWith(":"))
     {
         const auto &emojiShortCodes = getApp()->emotes->emojis.shortCodes;
-        for (auto &m : emojiShortCodes)
-        {
-            addString(QString(":%1:").arg(m), TaggedString::Type::Emoji);
-        }
+        this->emojis_.update(nullptr, emojiShortCodes.size(), [&] {
+            std::vector<QString> strings;
+            for (const auto &m : emojiShortCodes)
+            {
+                strings.push_back(QString(":%1:").arg(m));
+            }
+            return strings;
+        });
+        addMatches(this->emojis_, TaggedString::Type::Emoji);
     }
 
     //
     // Stuff below is available only in regular Twitch channels
     if (!tc)
     {
+        this->sortItems();
         return;
     }
 
     // Usernames
+    auto addUsername = [&](const QString &str) {
+        if (startsWithOrContains(str, prefix, Qt::CaseInsensitive, prefixOnly))
+        {
+            this->items_.emplace_back(str + " ", TaggedString::Type::Username);
+        }
+    };
+
+    if (prefix.startsWith("@") || !getSettings()->userCompletionOnlyWithAt)
+    {
+        tc->refreshChattersForCompletion();
+    }
+
     if (prefix.startsWith("@"))
     {
         QString usernamePrefix = prefix;
@@ -180,10 +256,9 @@ void CompletionModel::refresh(const QString &prefix, bool isFirstWord)
 
         for (const auto &name : chatters)
         {
-            addString(
+            addUsername(
                 "@" + formatUserMention(name, isFirstWord,
-                                        getSettings()->mentionUsersWithComma),
-                TaggedString::Type::Username);
+                                        getSettings()->mentionUsersWithComma));
         }
     }
     else if (!getSettings()->userCompletionOnlyWithAt)
@@ -192,41 +267,72 @@ void CompletionModel::refresh(const QString &prefix, bool isFirstWord)
 
         for (const auto &name : chatters)
         {
-            addString(formatUserMention(name, isFirstWord,
-                                        getSettings()->mentionUsersWithComma),
-                      TaggedString::Type::Username);
+            addUsername(formatUserMention(name, isFirstWord,
+                                          getSettings()->mentionUsersWithComma));
         }
     }
 
     // Bttv Channel
-    for (auto &emote : *tc->bttvEmotes())
-    {
-        addString(emote.first.string, TaggedString::Type::BTTVGlobalEmote);
-    }
+    auto bttvChannel = tc->bttvEmotes();
+    this->bttvChannelEmotes_.update(bttvChannel, 0, [&] {
+        return emoteNames(*bttvChannel);
+    });
+    addMatches(this->bttvChannelEmotes_, TaggedString::Type::BTTVGlobalEmote);
 
     // Ffz Channel
-    for (auto &emote : *tc->ffzEmotes())
-    {
-        addString(emote.first.string, TaggedString::Type::BTTVGlobalEmote);
-    }
+    auto ffzChannel = tc->ffzEmotes();
+    this->ffzChannelEmotes_.update(ffzChannel, 0, [&] {
+        return emoteNames(*ffzChannel);
+    });
+    addMatches(this->ffzChannelEmotes_, TaggedString::Type::BTTVGlobalEmote);
 
     // Custom Chatterino commands
-    for (auto &command : getApp()->commands->items)
+    auto commands = getApp()->commands->items.readOnly();
+    this->customCommands_.update(commands, 0, [&] {
+        std::vector<QString> names;
+        for (const auto &command : *commands)
+        {
+            names.push_back(command.name);
+        }
+        return names;
+    });
+    addMatches(this->customCommands_, TaggedString::CustomCommand);
+
+    // Default Chatterino commands, these never change
+    this->chatterinoCommands_.update(nullptr, 0, [] {
+        auto list = getApp()->commands->getDefaultChatterinoCommandList();
+        return std::vector<QString>(list.begin(), list.end());
+    });
+    addMatches(this->chatterinoCommands_, TaggedString::ChatterinoCommand);
+
+    // Default Twitch commands, only completed after a / or .
+    auto prefixChar = prefix.at(0);
+    if (prefixChar == '/' || prefixChar == '.')
     {
-        addString(command.name, TaggedString::CustomCommand);
+        this->twitchCommands_.update(nullptr, 0, [] {
+            return std::vector<QString>(TWITCH_DEFAULT_COMMANDS.begin(),
+                                        TWITCH_DEFAULT_COMMANDS.end());
+        });
+        this->twitchCommands_.forEachMatch(
+            lowercasePrefix.mid(1), prefixOnly, [&](const QString &command) {
+                this->items_.emplace_back(prefixChar + command + " ",
+                                          TaggedString::TwitchCommand);
+            });
     }
 
-    // Default Chatterino commands
-    for (auto &command : getApp()->commands->getDefaultChatterinoCommandList())
-    {
-        addString(command, TaggedString::ChatterinoCommand);
-    }
+    this->sortItems();
+}
 
-    // Default Twitch commands
-    for (auto &command : TWITCH_DEFAULT_COMMANDS)
-    {
-        addString(command, TaggedString::TwitchCommand);
-    }
+void CompletionModel::sortItems()
+{
+    std::sort(this->items_.begin(), this->items_.end());
+
+    // strings that are in multiple sources are only shown once
+    auto last = std::unique(this->items_.begin(), this->items_.end(),
+                            [](const TaggedString &a, const TaggedString &b) {
+                                return !(a < b) && !(b < a);
+                            });
+    this->items_.erase(last, this->items_.end());
 }
 
 bool CompletionModel::compareStrings(const QString &a, const QString &b)
@@ -3,8 +3,10 @@
 #include <QAbstractListModel>
 
 #include <chrono>
+#include <functional>
+#include <memory>
 #include <mutex>
-#include <set>
+#include <vector>
 
 namespace chatterino {
 
@@ -43,6 +45,39 @@ class CompletionModel : public QAbstractListModel
         Type type;
     };
 
+    /**
+     * @brief The strings of one source of completions (e.g. the BTTV channel
+     *        emotes), sorted by their lowercase form.
+     *
+     * A source is only rebuilt when the underlying data changes, which is
+     * detected through the owner pointer and a generation number. Prefix
+     * queries are a binary search for the first match.
+     */
+    class Source
+    {
+    public:
+        /// Rebuilds the source from getStrings if owner or generation changed
+        void update(std::shared_ptr<const void> owner, uint64_t generation,
+                    const std::function<std::vector<QString>()> &getStrings);
+
+        /// Calls callback with every string that starts with (or contains if
+        /// prefixOnly isn't set) lowercasePrefix
+        template <typename F>
+        void forEachMatch(const QString &lowercasePrefix, bool prefixOnly,
+                          F &&callback) const;
+
+    private:
+        struct Item {
+            QString key;
+            QString string;
+        };
+
+        std::shared_ptr<const void> owner_;
+        uint64_t generation_ = 0;
+        bool built_ = false;
+        std::vector<Item> items_;
+    };
+
 public:
     CompletionModel(Channel &channel);
 
@@ -55,9 +90,24 @@ public:
     static bool compareStrings(const QString &a, const QString &b);
 
 private:
-    std::set<TaggedString> items_;
+    // sorts items_ and removes duplicates
+    void sortItems();
+
+    // sorted, the matches of the last refresh only
+    std::vector<TaggedString> items_;
     mutable std::mutex itemsMutex_;
     Channel &channel_;
+
+    Source twitchGlobalEmotes_;
+    Source twitchLocalEmotes_;
+    Source bttvGlobalEmotes_;
+    Source ffzGlobalEmotes_;
+    Source bttvChannelEmotes_;
+    Source ffzChannelEmotes_;
+    Source emojis_;
+    Source customCommands_;
+    Source chatterinoCommands_;
+    Source twitchCommands_;
 };
 
 }  // namespace chatterino
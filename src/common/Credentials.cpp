@@ -17,7 +17,7 @@
 #    endif
 #endif
 #include <QSaveFile>
-#include <boost/variant.hpp>
+#include <QTimer>
 
 #define FORMAT_NAME                                                  \
     ([&] {                                                           \
@@ -87,78 +87,6 @@ namespace {
             });
         }
     }
-
-    // QKeychain runs jobs asyncronously, so we have to assure that set/erase
-    // jobs gets executed in order.
-    struct SetJob {
-        QString name;
-        QString credential;
-    };
-
-    struct EraseJob {
-        QString name;
-    };
-
-    using Job = boost::variant<SetJob, EraseJob>;
-
-    static std::queue<Job> &jobQueue()
-    {
-        static std::queue<Job> jobs;
-        return jobs;
-    }
-
-    static void runNextJob()
-    {
-#ifndef NO_QTKEYCHAIN
-        auto &&queue = jobQueue();
-
-        if (!queue.empty())
-        {
-            // we were gonna use std::visit here but macos is shit
-
-            auto &&item = queue.front();
-
-            if (item.which() == 0)  // set job
-            {
-                auto set = boost::get<SetJob>(item);
-                auto job = new QKeychain::WritePasswordJob("chatterino");
-                job->setAutoDelete(true);
-                job->setKey(set.name);
-                job->setTextData(set.credential);
-                QObject::connect(job, &QKeychain::Job::finished, qApp,
-                                 [](auto) {
-                                     runNextJob();
-                                 });
-                job->start();
-            }
-            else  // erase job
-            {
-                auto erase = boost::get<EraseJob>(item);
-                auto job = new QKeychain::DeletePasswordJob("chatterino");
-                job->setAutoDelete(true);
-                job->setKey(erase.name);
-                QObject::connect(job, &QKeychain::Job::finished, qApp,
-                                 [](auto) {
-                                     runNextJob();
-                                 });
-                job->start();
-            }
-
-            queue.pop();
-        }
-#endif
-    }
-
-    static void queueJob(Job &&job)
-    {
-        auto &&queue = jobQueue();
-
-        queue.push(std::move(job));
-        if (queue.size() == 1)
-        {
-            runNextJob();
-        }
-    }
 }  // namespace
 
 Credentials &Credentials::instance()
@@ -181,19 +109,18 @@ void Credentials::get(const QString &provider, const QString &name_,
 
     if (useKeyring())
     {
-#ifndef NO_QTKEYCHAIN
-        // if NO_QTKEYCHAIN is set, then this code is never used either way
-        auto job = new QKeychain::ReadPasswordJob("chatterino");
-        job->setAutoDelete(true);
-        job->setKey(name);
-        QObject::connect(
-            job, &QKeychain::Job::finished, receiver,
-            [job, onLoaded = std::move(onLoaded)](auto) mutable {
-                onLoaded(job->textData());
-            },
-            Qt::DirectConnection);
-        job->start();
-#endif
+        if (auto it = this->cache_.find(name); it != this->cache_.end())
+        {
+            onLoaded(it->second);
+            return;
+        }
+
+        auto &waiting = this->reading_[name];
+        waiting.push_back({receiver, std::move(onLoaded)});
+        if (waiting.size() == 1)
+        {
+            this->read(name);
+        }
     }
     else
     {
@@ -215,7 +142,7 @@ void Credentials::set(const QString &provider, const QString &name_,
 
     if (useKeyring())
     {
-        queueJob(SetJob{name, credential});
+        this->queueWrite(name, credential);
     }
     else
     {
@@ -237,7 +164,7 @@ void Credentials::erase(const QString &provider, const QString &name_)
 
     if (useKeyring())
     {
-        queueJob(EraseJob{name});
+        this->queueWrite(name, boost::none);
     }
     else
     {
@@ -253,4 +180,110 @@ void Credentials::erase(const QString &provider, const QString &name_)
     }
 }
 
+void Credentials::read(const QString &name)
+{
+#ifndef NO_QTKEYCHAIN
+    // if NO_QTKEYCHAIN is set, then this code is never used either way
+    auto job = new QKeychain::ReadPasswordJob("chatterino");
+    job->setAutoDelete(true);
+    job->setKey(name);
+    QObject::connect(job, &QKeychain::Job::finished, qApp, [this, job, name] {
+        this->onRead(name, job->textData(),
+                     job->error() == QKeychain::NoError ||
+                         job->error() == QKeychain::EntryNotFound);
+    });
+    job->start();
+#else
+    (void)name;
+#endif
+}
+
+void Credentials::onRead(const QString &name, const QString &credential,
+                         bool found)
+{
+    auto waiting = std::move(this->reading_[name]);
+    this->reading_.erase(name);
+
+    // a credential that was set during the read is newer
+    auto it = this->cache_.find(name);
+    if (it == this->cache_.end() && found)
+    {
+        it = this->cache_.emplace(name, credential).first;
+    }
+    const auto &value = it != this->cache_.end() ? it->second : credential;
+
+    for (auto &&item : waiting)
+    {
+        if (item.receiver)
+        {
+            item.onLoaded(value);
+        }
+    }
+}
+
+void Credentials::queueWrite(const QString &name,
+                             boost::optional<QString> &&credential)
+{
+    // later reads get the new credential, even before it's written
+    this->cache_[name] = credential.value_or(QString());
+    this->pendingWrites_[name] = std::move(credential);
+
+    if (!this->flushQueued_)
+    {
+        this->flushQueued_ = true;
+        QTimer::singleShot(0, qApp, [this] {
+            this->flushWrites();
+        });
+    }
+}
+
+void Credentials::flushWrites()
+{
+    this->flushQueued_ = false;
+
+    for (auto &&write : this->pendingWrites_)
+    {
+        this->writes_.push(std::move(write));
+    }
+    this->pendingWrites_.clear();
+
+    if (!this->writing_)
+    {
+        this->runNextWrite();
+    }
+}
+
+void Credentials::runNextWrite()
+{
+#ifndef NO_QTKEYCHAIN
+    if (this->writes_.empty())
+    {
+        this->writing_ = false;
+        return;
+    }
+    this->writing_ = true;
+
+    auto write = std::move(this->writes_.front());
+    this->writes_.pop();
+
+    QKeychain::Job *job = nullptr;
+    if (write.second)
+    {
+        auto *writeJob = new QKeychain::WritePasswordJob("chatterino");
+        writeJob->setTextData(*write.second);
+        job = writeJob;
+    }
+    else
+    {
+        job = new QKeychain::DeletePasswordJob("chatterino");
+    }
+    job->setAutoDelete(true);
+    job->setKey(write.first);
+    QObject::connect(job, &QKeychain::Job::finished, qApp, [this](auto) {
+        this->runNextWrite();
+    });
+    job->start();
+#endif
+}
+
 }  // namespace chatterino
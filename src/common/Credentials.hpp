@@ -1,9 +1,18 @@
 #pragma once
 
+#include "util/QStringHash.hpp"
+
 #include <QObject>
+#include <QPointer>
 #include <QString>
+#include <boost/optional.hpp>
 
 #include <functional>
+#include <map>
+#include <queue>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace chatterino {
 
@@ -12,14 +21,45 @@ class Credentials
 public:
     static Credentials &instance();
 
+    /// Calls onLoaded with the credential, right away if it was read or set
+    /// before. Requests of a credential that's still being read from the
+    /// keychain wait for the same read.
     void get(const QString &provider, const QString &name, QObject *receiver,
              std::function<void(const QString &)> &&onLoaded);
+    /// Changes of the keychain are collected until the event loop runs
+    /// again, only the last change of each credential is written.
     void set(const QString &provider, const QString &name,
              const QString &credential);
     void erase(const QString &provider, const QString &name);
 
 private:
     Credentials();
+
+    struct Waiting {
+        QPointer<QObject> receiver;
+        std::function<void(const QString &)> onLoaded;
+    };
+
+    // none erases the credential
+    using Write = std::pair<QString, boost::optional<QString>>;
+
+    void read(const QString &name);
+    void onRead(const QString &name, const QString &credential, bool found);
+    void queueWrite(const QString &name,
+                    boost::optional<QString> &&credential);
+    void flushWrites();
+    void runNextWrite();
+
+    // credentials of the keychain that were read or set, by name
+    std::unordered_map<QString, QString> cache_;
+    std::unordered_map<QString, std::vector<Waiting>> reading_;
+
+    std::map<QString, boost::optional<QString>> pendingWrites_;
+    bool flushQueued_ = false;
+    // QKeychain runs jobs asyncronously, so we have to assure that the
+    // writes are executed one after another
+    std::queue<Write> writes_;
+    bool writing_ = false;
 };
 
 }  // namespace chatterino
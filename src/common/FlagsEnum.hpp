@@ -27,12 +27,12 @@ public:
         }
     }
 
-    bool operator==(const FlagsEnum<T> &other)
+    bool operator==(const FlagsEnum<T> &other) const
     {
         return this->value_ == other.value_;
     }
 
-    bool operator!=(const FlagsEnum &other)
+    bool operator!=(const FlagsEnum &other) const
     {
         return this->value_ != other.value_;
     }
@@ -85,6 +85,11 @@ public:
         return !this->hasAny(flags);
     }
 
+    T value() const
+    {
+        return this->value_;
+    }
+
 private:
     T value_{};
 };
@@ -1,57 +1,105 @@
 #include "common/LinkParser.hpp"
 
 #include <QFile>
-#include <QMap>
 #include <QRegularExpression>
-#include <QSet>
 #include <QString>
 #include <QStringRef>
 #include <QTextStream>
 
+#include <algorithm>
+#include <vector>
+
 namespace chatterino {
 namespace {
-    QSet<QString> &tlds()
+    bool tldLessThan(const QString &l, const QString &r)
+    {
+        return QString::compare(l, r, Qt::CaseInsensitive) < 0;
+    }
+
+    int compareTld(const QStringRef &tld, const QString &entry)
     {
-        static QSet<QString> tlds = [] {
+        return QStringRef::compare(tld, entry, Qt::CaseInsensitive);
+    }
+
+    // Sorted case insensitively, so a tld can be looked up in the word
+    // itself instead of in a lowercase copy of it
+    const std::vector<QString> &tlds()
+    {
+        static std::vector<QString> tlds = [] {
             QFile file(":/tlds.txt");
             file.open(QFile::ReadOnly);
             QTextStream stream(&file);
             stream.setCodec("UTF-8");
             int safetyMax = 20000;
 
-            QSet<QString> set;
+            std::vector<QString> list;
 
             while (!stream.atEnd())
             {
                 auto line = stream.readLine();
-                set.insert(line);
+                list.push_back(line);
 
                 if (safetyMax-- == 0)
                     break;
             }
 
-            return set;
+            std::sort(list.begin(), list.end(), tldLessThan);
+            return list;
         }();
         return tlds;
     }
 
-    bool isValidHostname(QStringRef &host)
+    bool isValidHostname(const QStringRef &host)
     {
         int index = host.lastIndexOf('.');
+        if (index == -1)
+        {
+            return false;
+        }
 
-        return index != -1 &&
-               tlds().contains(host.mid(index + 1).toString().toLower());
+        auto tld = host.mid(index + 1);
+        const auto &list = tlds();
+        auto it = std::lower_bound(
+            list.begin(), list.end(), tld,
+            [](const QString &entry, const QStringRef &tld) {
+                return compareTld(tld, entry) > 0;
+            });
+
+        return it != list.end() && compareTld(tld, *it) == 0;
     }
 
-    bool isValidIpv4(QStringRef &host)
+    // Same as matching ^\d{1,3}(?:\.\d{1,3}){3}$
+    bool isValidIpv4(const QStringRef &host)
     {
-        static auto exp = QRegularExpression("^\\d{1,3}(?:\\.\\d{1,3}){3}$");
+        int dots = 0;
+        int digits = 0;
 
-        return exp.match(host).hasMatch();
+        for (auto c : host)
+        {
+            auto u = c.unicode();
+            if (u >= '0' && u <= '9')
+            {
+                if (++digits > 3)
+                {
+                    return false;
+                }
+            }
+            else if (u == '.' && digits != 0 && dots < 3)
+            {
+                dots++;
+                digits = 0;
+            }
+            else
+            {
+                return false;
+            }
+        }
+
+        return dots == 3 && digits != 0;
     }
 
 #ifdef C_MATCH_IPV6_LINK
-    bool isValidIpv6(QStringRef &host)
+    bool isValidIpv6(const QStringRef &host)
     {
         static auto exp = QRegularExpression("^\\[[a-fA-F0-9:%]+\\]$");
 
@@ -0,0 +1,98 @@
+#include "common/MembershipDeltas.hpp"
+
+#include "util/StringPool.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+void MembershipDeltas::join(const QString &userName, bool announce)
+{
+    this->add(userName, true, announce);
+}
+
+void MembershipDeltas::part(const QString &userName, bool announce)
+{
+    this->add(userName, false, announce);
+}
+
+void MembershipDeltas::add(const QString &userName, bool joined,
+                           bool announce)
+{
+    auto lowerCaseName = userName.toLower();
+
+    auto it = this->users_.find(lowerCaseName);
+    if (it != this->users_.end())
+    {
+        if (it->second.joined != joined)
+        {
+            // back to where the user was before
+            this->users_.erase(it);
+        }
+        else
+        {
+            it->second.announce = announce;
+        }
+        return;
+    }
+
+    if (this->users_.size() >= MAX_USERS)
+    {
+        if (announce)
+        {
+            (joined ? this->droppedJoins_ : this->droppedParts_)++;
+        }
+        return;
+    }
+
+    auto interned = StringPool::instance().intern(lowerCaseName);
+    this->users_.emplace(
+        interned,
+        Delta{userName == interned ? interned : userName, joined, announce});
+}
+
+bool MembershipDeltas::empty() const
+{
+    return this->users_.empty() && this->droppedJoins_ == 0 &&
+           this->droppedParts_ == 0;
+}
+
+MembershipDeltas::Batch MembershipDeltas::take(size_t maxNamed)
+{
+    Batch batch;
+
+    QStringList announcedJoins;
+    QStringList announcedParts;
+    for (const auto &[lowerCaseName, delta] : this->users_)
+    {
+        (delta.joined ? batch.joined : batch.parted).push_back(lowerCaseName);
+        if (delta.announce)
+        {
+            (delta.joined ? announcedJoins : announcedParts)
+                .append(delta.name);
+        }
+    }
+    std::sort(batch.joined.begin(), batch.joined.end());
+    std::sort(batch.parted.begin(), batch.parted.end());
+
+    auto name = [maxNamed](QStringList &announced, QStringList &named,
+                           size_t &more, size_t dropped) {
+        auto count = std::min(size_t(announced.size()), maxNamed);
+        // only the named ones have to be in order
+        std::partial_sort(announced.begin(), announced.begin() + int(count),
+                          announced.end());
+        named = announced.mid(0, int(count));
+        more = size_t(announced.size()) - count + dropped;
+    };
+    name(announcedJoins, batch.namedJoins, batch.moreJoins,
+         this->droppedJoins_);
+    name(announcedParts, batch.namedParts, batch.moreParts,
+         this->droppedParts_);
+
+    this->users_.clear();
+    this->droppedJoins_ = 0;
+    this->droppedParts_ = 0;
+    return batch;
+}
+
+}  // namespace chatterino
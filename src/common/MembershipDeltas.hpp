@@ -0,0 +1,64 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <QStringList>
+
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief The JOINs and PARTs of a channel since they were last taken.
+ *
+ * Every user is kept once by their interned login with the last thing they
+ * did, a PART after a JOIN (or the other way around) cancels it. Only
+ * MAX_USERS users are kept per batch, the others are only counted, so
+ * bursts in huge channels don't grow it without bound.
+ */
+class MembershipDeltas
+{
+public:
+    static constexpr size_t MAX_USERS = 10000;
+
+    /// announce is whether the user is named in the system message
+    void join(const QString &userName, bool announce);
+    void part(const QString &userName, bool announce);
+
+    bool empty() const;
+
+    struct Batch {
+        // lower case and sorted
+        std::vector<QString> joined;
+        std::vector<QString> parted;
+
+        // the announced users in their own casing, sorted and at most
+        // maxNamed of them
+        QStringList namedJoins;
+        QStringList namedParts;
+        // announced users that weren't named
+        size_t moreJoins = 0;
+        size_t moreParts = 0;
+    };
+
+    /// Takes everything since the last call
+    Batch take(size_t maxNamed);
+
+private:
+    void add(const QString &userName, bool joined, bool announce);
+
+    struct Delta {
+        QString name;
+        bool joined;
+        bool announce;
+    };
+
+    std::unordered_map<QString, Delta> users_;
+    // announced users that didn't fit
+    size_t droppedJoins_ = 0;
+    size_t droppedParts_ = 0;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,274 @@
+#include "common/NetworkCache.hpp"
+
+#include "common/NetworkPrivate.hpp"
+#include "common/QLogging.hpp"
+#include "singletons/Paths.hpp"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QtConcurrent>
+
+namespace chatterino {
+
+namespace {
+
+    // the memory tier only holds the bodies that were used recently, all
+    // others are read from disk again
+    constexpr int MEMORY_CACHE_BYTES = 32 * 1024 * 1024;
+
+    QString bodyPath(const QString &key)
+    {
+        return getPaths()->cacheDirectory() + "/" + key;
+    }
+
+    // Entries that were cached before the metadata existed only have a body.
+    // They stay fresh forever like they used to.
+    QString metadataPath(const QString &key)
+    {
+        return bodyPath(key) + ".meta";
+    }
+
+    struct CacheControl {
+        bool noStore = false;
+        bool noCache = false;
+        boost::optional<int> maxAge;
+    };
+
+    CacheControl parseCacheControl(const QByteArray &header)
+    {
+        CacheControl cacheControl;
+
+        for (const auto &part : header.split(','))
+        {
+            auto directive = part.trimmed().toLower();
+
+            if (directive == "no-store")
+            {
+                cacheControl.noStore = true;
+            }
+            else if (directive == "no-cache")
+            {
+                cacheControl.noCache = true;
+            }
+            else if (directive.startsWith("max-age="))
+            {
+                bool ok = false;
+                auto maxAge = directive.mid(8).toInt(&ok);
+                if (ok && maxAge >= 0)
+                {
+                    cacheControl.maxAge = maxAge;
+                }
+            }
+        }
+
+        return cacheControl;
+    }
+
+}  // namespace
+
+bool NetworkCacheEntry::isFresh(bool hasTtl) const
+{
+    if (!this->freshUntil.isValid())
+    {
+        return !hasTtl;
+    }
+
+    return QDateTime::currentDateTimeUtc() < this->freshUntil;
+}
+
+bool NetworkCacheEntry::canRevalidate() const
+{
+    return !this->etag.isEmpty() || !this->lastModified.isEmpty();
+}
+
+NetworkCache::NetworkCache()
+    : memory_(MEMORY_CACHE_BYTES)
+{
+}
+
+NetworkCache &NetworkCache::instance()
+{
+    static NetworkCache instance;
+    return instance;
+}
+
+NetworkCache::EntryPtr NetworkCache::get(const QString &key)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        if (auto *entry = this->memory_.object(key))
+        {
+            return *entry;
+        }
+    }
+
+    auto entry = readFromDisk(key);
+    if (entry)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->memory_.insert(key, new EntryPtr(entry),
+                             std::max(1, entry->body.size()));
+    }
+
+    return entry;
+}
+
+void NetworkCache::put(const QString &key, EntryPtr entry)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->memory_.insert(key, new EntryPtr(entry),
+                             std::max(1, entry->body.size()));
+    }
+
+    QtConcurrent::run([key, entry = std::move(entry)] {
+        writeToDisk(key, entry);
+    });
+}
+
+void NetworkCache::remove(const QString &key)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->memory_.remove(key);
+    }
+
+    QFile::remove(bodyPath(key));
+    QFile::remove(metadataPath(key));
+}
+
+bool NetworkCache::startFetch(const QString &key,
+                              std::shared_ptr<NetworkData> data)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto it = this->fetches_.find(key);
+    if (it != this->fetches_.end())
+    {
+        it->second.push_back(std::move(data));
+        return false;
+    }
+
+    this->fetches_.emplace(key, std::vector<std::shared_ptr<NetworkData>>{});
+    return true;
+}
+
+std::vector<std::shared_ptr<NetworkData>> NetworkCache::finishFetch(
+    const QString &key)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto it = this->fetches_.find(key);
+    if (it == this->fetches_.end())
+    {
+        return {};
+    }
+
+    auto followers = std::move(it->second);
+    this->fetches_.erase(it);
+    return followers;
+}
+
+NetworkCache::EntryPtr NetworkCache::makeEntry(
+    const NetworkResult &result, boost::optional<std::chrono::seconds> ttl,
+    const QDateTime &now)
+{
+    auto cacheControl = parseCacheControl(result.header("Cache-Control"));
+    if (cacheControl.noStore)
+    {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<NetworkCacheEntry>();
+    entry->body = result.getData();
+    entry->etag = result.header("ETag");
+    entry->lastModified = result.header("Last-Modified");
+
+    if (ttl)
+    {
+        entry->freshUntil = now.addSecs(ttl->count());
+    }
+    else if (cacheControl.noCache)
+    {
+        entry->freshUntil = now;
+    }
+    else if (cacheControl.maxAge)
+    {
+        entry->freshUntil = now.addSecs(*cacheControl.maxAge);
+    }
+
+    return entry;
+}
+
+NetworkCache::EntryPtr NetworkCache::readFromDisk(const QString &key)
+{
+    QFile bodyFile(bodyPath(key));
+    if (!bodyFile.open(QIODevice::ReadOnly))
+    {
+        return nullptr;
+    }
+
+    auto entry = std::make_shared<NetworkCacheEntry>();
+    entry->body = bodyFile.readAll();
+
+    QFile metadataFile(metadataPath(key));
+    if (metadataFile.open(QIODevice::ReadOnly))
+    {
+        auto metadata =
+            QJsonDocument::fromJson(metadataFile.readAll()).object();
+        entry->etag = metadata.value("etag").toString().toUtf8();
+        entry->lastModified =
+            metadata.value("lastModified").toString().toUtf8();
+        if (metadata.contains("freshUntil"))
+        {
+            entry->freshUntil = QDateTime::fromMSecsSinceEpoch(
+                qint64(metadata.value("freshUntil").toDouble()), Qt::UTC);
+        }
+    }
+
+    return entry;
+}
+
+void NetworkCache::writeToDisk(const QString &key, EntryPtr entry)
+{
+    QSaveFile bodyFile(bodyPath(key));
+    if (!bodyFile.open(QIODevice::WriteOnly))
+    {
+        qCDebug(chatterinoHTTP) << "Failed to write cache file" << key;
+        return;
+    }
+    bodyFile.write(entry->body);
+    bodyFile.commit();
+
+    QJsonObject metadata;
+    if (!entry->etag.isEmpty())
+    {
+        metadata.insert("etag", QString::fromUtf8(entry->etag));
+    }
+    if (!entry->lastModified.isEmpty())
+    {
+        metadata.insert("lastModified", QString::fromUtf8(entry->lastModified));
+    }
+    if (entry->freshUntil.isValid())
+    {
+        metadata.insert("freshUntil",
+                        double(entry->freshUntil.toMSecsSinceEpoch()));
+    }
+
+    if (metadata.isEmpty())
+    {
+        QFile::remove(metadataPath(key));
+        return;
+    }
+
+    QSaveFile metadataFile(metadataPath(key));
+    if (metadataFile.open(QIODevice::WriteOnly))
+    {
+        metadataFile.write(QJsonDocument(metadata).toJson());
+        metadataFile.commit();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,87 @@
+#pragma once
+
+#include "common/NetworkResult.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QByteArray>
+#include <QCache>
+#include <QDateTime>
+#include <QString>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+struct NetworkData;
+
+struct NetworkCacheEntry {
+    QByteArray body;
+
+    // validators that are sent with If-None-Match and If-Modified-Since once
+    // the entry is stale
+    QByteArray etag;
+    QByteArray lastModified;
+
+    // The body is used without asking the server until then. Invalid means
+    // forever, which only requests without a ttl accept.
+    QDateTime freshUntil;
+
+    bool isFresh(bool hasTtl) const;
+    bool canRevalidate() const;
+};
+
+/**
+ * @brief Responses of GET requests made with NetworkRequest::cache.
+ *
+ * Entries live in memory and in the cache directory, the memory tier only
+ * keeps the recently used ones. Stale entries are revalidated with their
+ * ETag or Last-Modified, a 304 response reuses the cached body.
+ *
+ * It also tracks the requests that are running, so concurrent requests for
+ * the same url share one response.
+ *
+ * Thread safe.
+ */
+class NetworkCache
+{
+public:
+    using EntryPtr = std::shared_ptr<const NetworkCacheEntry>;
+
+    static NetworkCache &instance();
+
+    EntryPtr get(const QString &key);
+    void put(const QString &key, EntryPtr entry);
+    void remove(const QString &key);
+
+    /// Returns true if the request has to be sent. Otherwise the same request
+    /// is already running and this one gets its response from finishFetch.
+    bool startFetch(const QString &key, std::shared_ptr<NetworkData> data);
+    /// Returns the requests that waited for the request of the key.
+    std::vector<std::shared_ptr<NetworkData>> finishFetch(const QString &key);
+
+    /// Builds the entry for a response, nullptr if it must not be stored.
+    /// The ttl of the request takes precedence over the max-age of the
+    /// response. Without either, the entry stays fresh forever.
+    static EntryPtr makeEntry(const NetworkResult &result,
+                              boost::optional<std::chrono::seconds> ttl,
+                              const QDateTime &now);
+
+private:
+    NetworkCache();
+
+    static EntryPtr readFromDisk(const QString &key);
+    static void writeToDisk(const QString &key, EntryPtr entry);
+
+    std::mutex mutex_;
+    // costs are the body sizes
+    QCache<QString, EntryPtr> memory_;
+    std::unordered_map<QString, std::vector<std::shared_ptr<NetworkData>>>
+        fetches_;
+};
+
+}  // namespace chatterino
@@ -1,5 +1,6 @@
 #pragma once
 
+#include <cstdint>
 #include <functional>
 #include <vector>
 
@@ -24,6 +25,16 @@ enum class NetworkRequestType {
     Delete,
     Patch,
 };
+/// Order in which requests to the same host are sent
+enum class NetworkRequestPriority : uint8_t {
+    /// Images that are in view
+    High,
+    /// API requests
+    Normal,
+    /// Anything that isn't needed right now, like prefetches
+    Low,
+};
+
 const static std::vector<QString> networkRequestTypes{
     "GET",     //
     "POST",    //
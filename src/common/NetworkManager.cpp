@@ -1,9 +1,123 @@
 #include "common/NetworkManager.hpp"
 
+#include "common/Env.hpp"
+#include "common/QLogging.hpp"
+#include "singletons/Paths.hpp"
+#include "util/CombinePath.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
 #include <QNetworkAccessManager>
+#include <QNetworkReply>
+#include <QNetworkRequest>
+#include <QSslConfiguration>
+#include <QUrl>
+
+#include <unordered_map>
 
 namespace chatterino {
 
+namespace {
+
+    // hosts that are loaded from in almost every session
+    const char *const WARM_HOSTS[] = {
+        "static-cdn.jtvnw.net",
+        "cdn.betterttv.net",
+        "cdn.frankerfacez.com",
+        "api.twitch.tv",
+    };
+
+    const QString &recentMessagesHost()
+    {
+        static const QString host =
+            QUrl(Env::get().recentMessagesApiUrl).host();
+        return host;
+    }
+
+    // session tickets by host, network worker thread only until deinit
+    std::unordered_map<QString, QByteArray> sessionTickets;
+    bool ticketsChanged = false;
+
+    QString ticketsPath()
+    {
+        return combinePath(getPaths()->cacheDirectory(), "tls-sessions.json");
+    }
+
+    bool isWarmHost(const QString &host)
+    {
+        if (!host.isEmpty() && host == recentMessagesHost())
+        {
+            return true;
+        }
+        for (const auto *warmHost : WARM_HOSTS)
+        {
+            if (host == QLatin1String(warmHost))
+            {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void loadTickets()
+    {
+        QFile file(ticketsPath());
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            return;
+        }
+
+        auto object = QJsonDocument::fromJson(file.readAll()).object();
+        for (auto it = object.begin(); it != object.end(); ++it)
+        {
+            auto ticket =
+                QByteArray::fromBase64(it.value().toString().toLatin1());
+            if (!ticket.isEmpty() && isWarmHost(it.key()))
+            {
+                sessionTickets[it.key()] = ticket;
+            }
+        }
+    }
+
+    void saveTickets()
+    {
+        if (!ticketsChanged)
+        {
+            return;
+        }
+
+        QJsonObject object;
+        for (const auto &[host, ticket] : sessionTickets)
+        {
+            object.insert(host, QString::fromLatin1(ticket.toBase64()));
+        }
+
+        // the tickets resume sessions, so only the user may read them
+        QFile file(ticketsPath());
+        if (file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        {
+            file.setPermissions(QFile::ReadOwner | QFile::WriteOwner);
+            file.write(QJsonDocument(object).toJson(QJsonDocument::Compact));
+        }
+    }
+
+    QSslConfiguration sessionConfiguration(QSslConfiguration configuration,
+                                           const QString &host)
+    {
+        configuration.setSslOption(QSsl::SslOptionDisableSessionPersistence,
+                                   false);
+        auto it = sessionTickets.find(host);
+        if (it != sessionTickets.end())
+        {
+            configuration.setSessionTicket(it->second);
+        }
+        return configuration;
+    }
+
+}  // namespace
+
 QThread NetworkManager::workerThread;
 QNetworkAccessManager NetworkManager::accessManager;
 
@@ -17,6 +131,70 @@ void NetworkManager::deinit()
 {
     NetworkManager::workerThread.quit();
     NetworkManager::workerThread.wait();
+
+    // the worker thread is done, so the tickets can be read here
+    saveTickets();
+}
+
+void NetworkManager::warmUp()
+{
+    QMetaObject::invokeMethod(&NetworkManager::accessManager, [] {
+        loadTickets();
+
+        QStringList hosts;
+        for (const auto *host : WARM_HOSTS)
+        {
+            hosts.append(host);
+        }
+        if (!recentMessagesHost().isEmpty())
+        {
+            hosts.append(recentMessagesHost());
+        }
+
+        // the lookups and handshakes of all hosts run at the same time
+        for (const auto &host : hosts)
+        {
+            NetworkManager::accessManager.connectToHostEncrypted(
+                host, 443,
+                sessionConfiguration(QSslConfiguration::defaultConfiguration(),
+                                     host));
+        }
+        qCDebug(chatterinoHTTP) << "Warming up connections to" << hosts;
+    });
+}
+
+void NetworkManager::prepareTlsSession(QNetworkRequest &request)
+{
+    auto host = request.url().host();
+    if (request.url().scheme() != "https" || !isWarmHost(host))
+    {
+        return;
+    }
+
+    request.setSslConfiguration(
+        sessionConfiguration(request.sslConfiguration(), host));
+}
+
+void NetworkManager::keepTlsSession(QNetworkReply *reply)
+{
+    auto host = reply->url().host();
+    if (reply->url().scheme() != "https" || !isWarmHost(host))
+    {
+        return;
+    }
+
+    auto ticket = reply->sslConfiguration().sessionTicket();
+    if (ticket.isEmpty())
+    {
+        return;
+    }
+
+    auto &kept = sessionTickets[host];
+    if (kept != ticket)
+    {
+        kept = ticket;
+        ticketsChanged = true;
+    }
 }
 
 }  // namespace chatterino
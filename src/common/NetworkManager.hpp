@@ -3,6 +3,9 @@
 #include <QNetworkAccessManager>
 #include <QThread>
 
+class QNetworkReply;
+class QNetworkRequest;
+
 namespace chatterino {
 
 class NetworkManager : public QObject
@@ -15,6 +18,19 @@ public:
 
     static void init();
     static void deinit();
+
+    /// Opens connections to the CDN and API hosts most sessions load from
+    /// right away, so the first requests to them don't wait for DNS and a
+    /// TLS handshake. The TLS sessions of the last run are resumed where the
+    /// servers still accept them. Call after init.
+    static void warmUp();
+
+    /// Lets requests to the warmed up hosts keep their TLS sessions, network
+    /// worker thread only
+    static void prepareTlsSession(QNetworkRequest &request);
+    /// Keeps the TLS session of a finished reply for the next run, network
+    /// worker thread only
+    static void keepTlsSession(QNetworkReply *reply);
 };
 
 }  // namespace chatterino
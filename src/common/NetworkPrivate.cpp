@@ -1,21 +1,29 @@
 #include "common/NetworkPrivate.hpp"
 
+#include "common/NetworkCache.hpp"
 #include "common/NetworkManager.hpp"
 #include "common/NetworkResult.hpp"
+#include "common/NetworkScheduler.hpp"
 #include "common/Outcome.hpp"
 #include "debug/AssertInGuiThread.hpp"
-#include "singletons/Paths.hpp"
+#include "debug/Trace.hpp"
 #include "util/DebugCount.hpp"
 #include "util/PostToThread.hpp"
 
 #include <QCryptographicHash>
-#include <QFile>
 #include <QNetworkReply>
 #include <QtConcurrent>
 #include "common/QLogging.hpp"
 
 namespace chatterino {
 
+namespace {
+
+    // from sending the request until its reply is handled
+    DebugHistogram requestTime("http request time");
+
+}  // namespace
+
 NetworkData::NetworkData()
     : lifetimeManager_(new QObject)
 {
@@ -55,33 +63,107 @@ QString NetworkData::getHash()
     return this->hash_;
 }
 
-void writeToCache(const std::shared_ptr<NetworkData> &data,
-                  const QByteArray &bytes)
-{
-    if (data->cache_)
+namespace {
+
+    // Runs the callbacks of a request with a response it didn't receive
+    // itself, on the same threads as handleReply would
+    void deliver(const std::shared_ptr<NetworkData> &data,
+                 NetworkResult result, bool success)
     {
-        QtConcurrent::run([data, bytes] {
-            QFile cachedFile(getPaths()->cacheDirectory() + "/" +
-                             data->getHash());
+        if (!success)
+        {
+            postToThread([data, result = std::move(result)] {
+                if (data->onError_)
+                {
+                    data->onError_(result);
+                }
+                if (data->finally_)
+                {
+                    data->finally_();
+                }
+            });
+            return;
+        }
 
-            if (cachedFile.open(QIODevice::WriteOnly))
+        auto run = [data, result = std::move(result)] {
+            if (data->hasCaller_ && !data->caller_.get())
+            {
+                return;
+            }
+
+            if (data->onSuccess_ && data->onSuccess_(result) == Failure &&
+                data->cache_)
             {
-                cachedFile.write(bytes);
+                // the cached body couldn't be used, get a new one next time
+                NetworkCache::instance().remove(data->getHash());
             }
-        });
+
+            if (data->finally_)
+            {
+                data->finally_();
+            }
+        };
+
+        if (data->executeConcurrently_ || isGuiThread())
+        {
+            run();
+        }
+        else
+        {
+            postToThread(std::move(run));
+        }
     }
-}
 
-void loadUncached(const std::shared_ptr<NetworkData> &data)
-{
-    DebugCount::increase("http request started");
+    // Stores the response of a cached request. A 304 response is replaced by
+    // the body it confirmed.
+    NetworkResult updateCache(const std::shared_ptr<NetworkData> &data,
+                              const NetworkResult &result)
+    {
+        auto &cache = NetworkCache::instance();
+        auto key = data->getHash();
+        bool notModified = result.status() == 304 && data->staleEntry_;
+
+        auto stored = notModified ? NetworkResult(data->staleEntry_->body, 200,
+                                                  result.headers())
+                                  : result;
+        if (stored.status() != 200)
+        {
+            return stored;
+        }
 
-    NetworkRequester requester;
-    NetworkWorker *worker = new NetworkWorker;
+        auto entry = NetworkCache::makeEntry(
+            stored, data->cacheTtl_, QDateTime::currentDateTimeUtc());
+        if (!entry)
+        {
+            cache.remove(key);
+            return stored;
+        }
 
-    worker->moveToThread(&NetworkManager::workerThread);
+        if (notModified && !entry->canRevalidate())
+        {
+            // 304 responses don't have to repeat the validators
+            auto revalidated = std::make_shared<NetworkCacheEntry>(*entry);
+            revalidated->etag = data->staleEntry_->etag;
+            revalidated->lastModified = data->staleEntry_->lastModified;
+            entry = std::move(revalidated);
+        }
+
+        cache.put(key, std::move(entry));
+        return stored;
+    }
+
+    // Only used on the network worker thread
+    NetworkScheduler &scheduler()
+    {
+        static NetworkScheduler scheduler;
+        return scheduler;
+    }
+
+    // Sends the request, on the network worker thread
+    void send(const std::shared_ptr<NetworkData> &data)
+    {
+        CHATTERINO_TRACE_SCOPE("NetworkRequest::send");
 
-    auto onUrlRequested = [data, worker]() mutable {
         if (data->hasTimeout_)
         {
             data->timer_ = new QTimer();
@@ -89,6 +171,8 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
             data->timer_->start(data->timeoutMS_);
         }
 
+        NetworkManager::prepareTlsSession(data->request_);
+
         auto reply = [&]() -> QNetworkReply * {
             switch (data->requestType_)
             {
@@ -136,13 +220,18 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
         if (reply == nullptr)
         {
             qCDebug(chatterinoCommon) << "Unhandled request type";
+            postToThread(
+                [host = data->request_.url().host()] {
+                    scheduler().finish(host);
+                },
+                &NetworkManager::accessManager);
             return;
         }
 
         if (data->timer_ != nullptr && data->timer_->isActive())
         {
             QObject::connect(
-                data->timer_, &QTimer::timeout, worker, [reply, data]() {
+                data->timer_, &QTimer::timeout, reply, [reply, data]() {
                     qCDebug(chatterinoCommon) << "Aborted!";
                     reply->abort();
                     qCDebug(chatterinoHTTP)
@@ -173,9 +262,25 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
             data->onReplyCreated_(reply);
         }
 
-        auto handleReply = [data, reply]() mutable {
+        auto handleReply = [data, reply,
+                            sent = std::chrono::steady_clock::now()]() mutable {
+            CHATTERINO_TRACE_SCOPE("NetworkRequest::handleReply");
+            DebugHistogram::Timer timer(requestTime, sent);
+
+            // requests for the same url that waited for this one
+            std::vector<std::shared_ptr<NetworkData>> followers;
+            if (data->cache_)
+            {
+                followers =
+                    NetworkCache::instance().finishFetch(data->getHash());
+            }
+
             if (data->hasCaller_ && !data->caller_.get())
             {
+                for (const auto &follower : followers)
+                {
+                    load(follower);
+                }
                 return;
             }
 
@@ -191,13 +296,28 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
                                .arg(networkRequestTypes.at(
                                         int(data->requestType_)),
                                     data->request_.url().toString());
+                    for (const auto &follower : followers)
+                    {
+                        deliver(
+                            follower,
+                            NetworkResult({}, NetworkResult::timedoutStatus),
+                            false);
+                    }
                     return;
                 }
 
+                auto status =
+                    reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
+                for (const auto &follower : followers)
+                {
+                    deliver(follower,
+                            NetworkResult({}, status.toInt(),
+                                          reply->rawHeaderPairs()),
+                            false);
+                }
+
                 if (data->onError_)
                 {
-                    auto status = reply->attribute(
-                        QNetworkRequest::HttpStatusCodeAttribute);
                     if (data->requestType_ == NetworkRequestType::Get)
                     {
                         qCDebug(chatterinoHTTP)
@@ -218,8 +338,9 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
                                         QString(data->payload_));
                     }
                     // TODO: Should this always be run on the GUI thread?
-                    postToThread([data, code = status.toInt()] {
-                        data->onError_(NetworkResult({}, code));
+                    postToThread([data, code = status.toInt(),
+                                  headers = reply->rawHeaderPairs()] {
+                        data->onError_(NetworkResult({}, code, headers));
                     });
                 }
 
@@ -233,12 +354,21 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
             }
 
             QByteArray bytes = reply->readAll();
-            writeToCache(data, bytes);
 
             auto status =
                 reply->attribute(QNetworkRequest::HttpStatusCodeAttribute);
 
-            NetworkResult result(bytes, status.toInt());
+            NetworkResult result(bytes, status.toInt(),
+                                 reply->rawHeaderPairs());
+            if (data->cache_)
+            {
+                result = updateCache(data, result);
+            }
+
+            for (const auto &follower : followers)
+            {
+                deliver(follower, result, true);
+            }
 
             DebugCount::increase("http request success");
             // log("starting {}", data->request_.url().toString());
@@ -290,102 +420,109 @@ void loadUncached(const std::shared_ptr<NetworkData> &data)
                              &QObject::deleteLater);
         }
 
-        QObject::connect(
-            reply, &QNetworkReply::finished, worker,
-            [data, handleReply, worker]() mutable {
-                if (data->executeConcurrently_ || isGuiThread())
-                {
-                    handleReply();
-                    delete worker;
-                }
-                else
-                {
-                    postToThread(
-                        [worker, cb = std::move(handleReply)]() mutable {
-                            cb();
-                            delete worker;
-                        });
-                }
-            });
-    };
+        QObject::connect(reply, &QNetworkReply::finished, reply,
+                         [data, handleReply]() mutable {
+                             if (data->executeConcurrently_ || isGuiThread())
+                             {
+                                 handleReply();
+                             }
+                             else
+                             {
+                                 postToThread(std::move(handleReply));
+                             }
+                         });
+
+        // the reply lives on the worker thread, so does the scheduler
+        QObject::connect(reply, &QNetworkReply::finished, reply,
+                         [reply, host = data->request_.url().host()] {
+                             NetworkManager::keepTlsSession(reply);
+                             scheduler().finish(host);
+                         });
+    }
 
-    QObject::connect(&requester, &NetworkRequester::requestUrl, worker,
-                     onUrlRequested);
+    // Requests that waited for the cached response of this one are sent
+    // themselves
+    void releaseFollowers(const std::shared_ptr<NetworkData> &data)
+    {
+        if (!data->cache_)
+        {
+            return;
+        }
+
+        for (const auto &follower :
+             NetworkCache::instance().finishFetch(data->getHash()))
+        {
+            load(follower);
+        }
+    }
 
-    emit requester.requestUrl();
+}  // namespace
+
+void loadUncached(const std::shared_ptr<NetworkData> &data)
+{
+    DebugCount::increase("http request started");
+
+    postToThread(
+        [data] {
+            NetworkScheduler::Job job;
+            job.host = data->request_.url().host();
+            job.priority = data->priority_;
+            // the caller is checked again on the gui thread, this only saves
+            // sending requests nobody waits for anymore
+            job.cancelled = [data] {
+                return data->hasCaller_ && !data->caller_.get();
+            };
+            job.start = [data] {
+                send(data);
+            };
+            job.drop = [data] {
+                releaseFollowers(data);
+            };
+
+            scheduler().add(std::move(job));
+        },
+        &NetworkManager::accessManager);
 }
 
-// First tried to load cached, then uncached.
+// Uses the cached response while it's fresh, otherwise sends the request with
+// the validators of the cached response.
 void loadCached(const std::shared_ptr<NetworkData> &data)
 {
-    QFile cachedFile(getPaths()->cacheDirectory() + "/" + data->getHash());
+    auto &cache = NetworkCache::instance();
+    auto key = data->getHash();
+    auto entry = cache.get(key);
 
-    if (!cachedFile.exists() || !cachedFile.open(QIODevice::ReadOnly))
-    {
-        // File didn't exist OR File could not be opened
-        loadUncached(data);
-        return;
-    }
-    else
+    if (entry && entry->isFresh(data->cacheTtl_.has_value()))
     {
-        // XXX: check if bytes is empty?
-        QByteArray bytes = cachedFile.readAll();
-        NetworkResult result(bytes, 200);
-
         qCDebug(chatterinoHTTP)
             << QString("%1 [CACHED] 200 %2")
                    .arg(networkRequestTypes.at(int(data->requestType_)),
                         data->request_.url().toString());
-        if (data->onSuccess_)
-        {
-            if (data->executeConcurrently_ || isGuiThread())
-            {
-                // XXX: If outcome is Failure, we should invalidate the cache file
-                // somehow/somewhere
-                /*auto outcome =*/
-                if (data->hasCaller_ && !data->caller_.get())
-                {
-                    return;
-                }
-                data->onSuccess_(result);
-            }
-            else
-            {
-                postToThread([data, result]() {
-                    if (data->hasCaller_ && !data->caller_.get())
-                    {
-                        return;
-                    }
+        deliver(data, NetworkResult(entry->body, 200), true);
+        return;
+    }
 
-                    data->onSuccess_(result);
-                });
-            }
-        }
+    if (!cache.startFetch(key, data))
+    {
+        // gets the response of the request that is already running
+        return;
+    }
 
-        if (data->finally_)
+    if (entry && entry->canRevalidate())
+    {
+        data->staleEntry_ = entry;
+        if (!entry->etag.isEmpty())
         {
-            if (data->executeConcurrently_ || isGuiThread())
-            {
-                if (data->hasCaller_ && !data->caller_.get())
-                {
-                    return;
-                }
-
-                data->finally_();
-            }
-            else
-            {
-                postToThread([data]() {
-                    if (data->hasCaller_ && !data->caller_.get())
-                    {
-                        return;
-                    }
-
-                    data->finally_();
-                });
-            }
+            data->request_.setRawHeader("If-None-Match", entry->etag);
+        }
+        if (!entry->lastModified.isEmpty())
+        {
+            data->request_.setRawHeader("If-Modified-Since",
+                                        entry->lastModified);
         }
     }
+
+    loadUncached(data);
 }
 
 void load(const std::shared_ptr<NetworkData> &data)
@@ -1,11 +1,15 @@
 #pragma once
 
+#include "common/NetworkCache.hpp"
 #include "common/NetworkCommon.hpp"
 #include "util/QObjectRef.hpp"
 
 #include <QHttpMultiPart>
 #include <QNetworkRequest>
 #include <QTimer>
+#include <boost/optional.hpp>
+
+#include <chrono>
 #include <functional>
 #include <memory>
 
@@ -15,22 +19,6 @@ namespace chatterino {
 
 class NetworkResult;
 
-class NetworkRequester : public QObject
-{
-    Q_OBJECT
-
-signals:
-    void requestUrl();
-};
-
-class NetworkWorker : public QObject
-{
-    Q_OBJECT
-
-signals:
-    void doneUrl();
-};
-
 struct NetworkData {
     NetworkData();
     ~NetworkData();
@@ -39,7 +27,12 @@ struct NetworkData {
     bool hasCaller_{};
     QObjectRef<QObject> caller_;
     bool cache_{};
+    // without a ttl, responses are used until they expire by themselves
+    boost::optional<std::chrono::seconds> cacheTtl_;
+    // the cached response that is revalidated by this request
+    NetworkCache::EntryPtr staleEntry_;
     bool executeConcurrently_{};
+    NetworkRequestPriority priority_ = NetworkRequestPriority::Normal;
 
     NetworkReplyCreatedCallback onReplyCreated_;
     NetworkErrorCallback onError_;
@@ -123,6 +123,12 @@ NetworkRequest NetworkRequest::timeout(int ms) &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::priority(NetworkRequestPriority priority) &&
+{
+    this->data->priority_ = priority;
+    return std::move(*this);
+}
+
 NetworkRequest NetworkRequest::concurrent() &&
 {
     this->data->executeConcurrently_ = true;
@@ -162,6 +168,13 @@ NetworkRequest NetworkRequest::cache() &&
     return std::move(*this);
 }
 
+NetworkRequest NetworkRequest::cache(std::chrono::seconds ttl) &&
+{
+    this->data->cache_ = true;
+    this->data->cacheTtl_ = ttl;
+    return std::move(*this);
+}
+
 void NetworkRequest::execute()
 {
     this->executed_ = true;
@@ -187,6 +200,9 @@ void NetworkRequest::initializeDefaultValues()
                                .toUtf8();
 
     this->data->request_.setRawHeader("User-Agent", userAgent);
+    // only used if the server supports it
+    this->data->request_.setAttribute(QNetworkRequest::Http2AllowedAttribute,
+                                      true);
 }
 
 // Helper creator functions
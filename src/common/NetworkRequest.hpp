@@ -4,6 +4,7 @@
 #include "common/NetworkResult.hpp"
 
 #include <QHttpMultiPart>
+#include <chrono>
 #include <memory>
 
 namespace chatterino {
@@ -46,6 +47,9 @@ public:
 
     NetworkRequest payload(const QByteArray &payload) &&;
     NetworkRequest cache() &&;
+    /// Like cache(), but the response is only used for `ttl` before it is
+    /// revalidated with the server.
+    NetworkRequest cache(std::chrono::seconds ttl) &&;
     /// NetworkRequest makes sure that the `caller` object still exists when the
     /// callbacks are executed. Cannot be used with concurrent() since we can't
     /// make sure that the object doesn't get deleted while the callback is
@@ -56,7 +60,11 @@ public:
     NetworkRequest header(const char *headerName, const QString &value) &&;
     NetworkRequest headerList(
         const std::vector<std::pair<QByteArray, QByteArray>> &headers) &&;
+    /// The timeout starts once the request is sent, not while it waits for
+    /// other requests to its host
     NetworkRequest timeout(int ms) &&;
+    /// Requests are Normal by default
+    NetworkRequest priority(NetworkRequestPriority priority) &&;
     NetworkRequest concurrent() &&;
     NetworkRequest authorizeTwitchV5(const QString &clientID,
                                      const QString &oauthToken = QString()) &&;
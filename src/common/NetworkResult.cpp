@@ -7,9 +7,11 @@
 
 namespace chatterino {
 
-NetworkResult::NetworkResult(const QByteArray &data, int status)
+NetworkResult::NetworkResult(const QByteArray &data, int status,
+                             Headers headers)
     : data_(data)
     , status_(status)
+    , headers_(std::move(headers))
 {
 }
 
@@ -63,4 +65,22 @@ int NetworkResult::status() const
     return this->status_;
 }
 
+QByteArray NetworkResult::header(const QByteArray &name) const
+{
+    for (const auto &header : this->headers_)
+    {
+        if (header.first.compare(name, Qt::CaseInsensitive) == 0)
+        {
+            return header.second;
+        }
+    }
+
+    return {};
+}
+
+const NetworkResult::Headers &NetworkResult::headers() const
+{
+    return this->headers_;
+}
+
 }  // namespace chatterino
@@ -1,15 +1,20 @@
 #pragma once
 
 #include <rapidjson/document.h>
+#include <QByteArray>
 #include <QJsonArray>
 #include <QJsonObject>
+#include <QList>
+#include <QPair>
 
 namespace chatterino {
 
 class NetworkResult
 {
 public:
-    NetworkResult(const QByteArray &data, int status);
+    using Headers = QList<QPair<QByteArray, QByteArray>>;
+
+    NetworkResult(const QByteArray &data, int status, Headers headers = {});
 
     /// Parses the result as json and returns the root as an object.
     /// Returns empty object if parsing failed.
@@ -21,12 +26,17 @@ public:
     rapidjson::Document parseRapidJson() const;
     const QByteArray &getData() const;
     int status() const;
+    /// Returns the value of the response header, empty if it wasn't sent.
+    /// Names are compared case insensitively.
+    QByteArray header(const QByteArray &name) const;
+    const Headers &headers() const;
 
     static constexpr int timedoutStatus = -2;
 
 private:
     QByteArray data_;
     int status_;
+    Headers headers_;
 };
 
 }  // namespace chatterino
@@ -0,0 +1,101 @@
+#include "common/NetworkScheduler.hpp"
+
+#include "util/DebugCount.hpp"
+
+namespace chatterino {
+
+NetworkScheduler::NetworkScheduler(int maxRunningPerHost)
+    : maxRunningPerHost_(maxRunningPerHost)
+{
+}
+
+void NetworkScheduler::add(Job job)
+{
+    auto it = this->hosts_.find(job.host);
+    if (it == this->hosts_.end() ||
+        it->second.running < this->maxRunningPerHost_)
+    {
+        if (NetworkScheduler::start(job))
+        {
+            this->hosts_[job.host].running++;
+        }
+        return;
+    }
+
+    auto &host = it->second;
+    DebugCount::increase("http request waiting");
+    host.waiting[size_t(job.priority)].push_back(std::move(job));
+}
+
+void NetworkScheduler::finish(const QString &name)
+{
+    auto it = this->hosts_.find(name);
+    if (it == this->hosts_.end())
+    {
+        return;
+    }
+
+    auto &host = it->second;
+    host.running--;
+
+    for (auto &queue : host.waiting)
+    {
+        while (!queue.empty() && host.running < this->maxRunningPerHost_)
+        {
+            auto job = std::move(queue.front());
+            queue.pop_front();
+            DebugCount::decrease("http request waiting");
+
+            if (NetworkScheduler::start(job))
+            {
+                host.running++;
+            }
+        }
+    }
+
+    if (host.running <= 0)
+    {
+        // nothing can be waiting for a host that isn't busy
+        this->hosts_.erase(it);
+    }
+}
+
+int NetworkScheduler::running(const QString &host) const
+{
+    auto it = this->hosts_.find(host);
+    return it == this->hosts_.end() ? 0 : it->second.running;
+}
+
+size_t NetworkScheduler::waiting(const QString &host) const
+{
+    auto it = this->hosts_.find(host);
+    if (it == this->hosts_.end())
+    {
+        return 0;
+    }
+
+    size_t count = 0;
+    for (const auto &queue : it->second.waiting)
+    {
+        count += queue.size();
+    }
+    return count;
+}
+
+bool NetworkScheduler::start(Job &job)
+{
+    if (job.cancelled && job.cancelled())
+    {
+        DebugCount::increase("http request cancelled");
+        if (job.drop)
+        {
+            job.drop();
+        }
+        return false;
+    }
+
+    job.start();
+    return true;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "common/NetworkCommon.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Decides when requests are handed to the QNetworkAccessManager.
+ *
+ * Only a few requests run per host at the same time, the others wait by
+ * priority. Once a request is sent it can't be reordered anymore, so keeping
+ * them here lets visible images overtake a startup flood of prefetches.
+ * Requests are cancelled before they would start if they don't matter
+ * anymore.
+ *
+ * Not thread safe, the network worker thread owns the scheduler of requests.
+ */
+class NetworkScheduler : boost::noncopyable
+{
+public:
+    /// Same as the connections Qt opens to a HTTP/1 host
+    static constexpr int MAX_RUNNING_PER_HOST = 6;
+
+    struct Job {
+        QString host;
+        NetworkRequestPriority priority = NetworkRequestPriority::Normal;
+        /// Asked right before the job would start
+        std::function<bool()> cancelled;
+        /// Has to be followed by a call to finish once the job is done, it
+        /// must not call finish or add itself
+        std::function<void()> start;
+        /// Called instead of start for cancelled jobs
+        std::function<void()> drop;
+    };
+
+    explicit NetworkScheduler(int maxRunningPerHost = MAX_RUNNING_PER_HOST);
+
+    /// Starts the job now if its host isn't busy
+    void add(Job job);
+    /// A job of the host finished, starts the next one waiting for it
+    void finish(const QString &host);
+
+    int running(const QString &host) const;
+    size_t waiting(const QString &host) const;
+
+private:
+    struct Host {
+        int running = 0;
+        // one queue per priority
+        std::array<std::deque<Job>, 3> waiting;
+    };
+
+    // Returns false if the job was dropped
+    static bool start(Job &job);
+
+    const int maxRunningPerHost_;
+    std::unordered_map<QString, Host> hosts_;
+};
+
+}  // namespace chatterino
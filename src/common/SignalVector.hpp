@@ -24,6 +24,8 @@ public:
     pajlada::Signals::Signal<SignalVectorItemEvent<T>> itemInserted;
     pajlada::Signals::Signal<SignalVectorItemEvent<T>> itemRemoved;
     pajlada::Signals::NoArgSignal delayedItemsChanged;
+    /// Invoked once the outermost Batch is destroyed
+    pajlada::Signals::NoArgSignal batchFinished;
 
     SignalVector()
         : readOnly_(new std::vector<T>())
@@ -46,9 +48,53 @@ public:
         return bool(this->itemCompare_);
     }
 
+    /// True while a Batch of this vector is alive
+    bool inBatch() const
+    {
+        return this->batchDepth_ > 0;
+    }
+
+    /// Defers updating the read-only version until it's destroyed, so
+    /// changing many items copies the vector once. Readers on other threads
+    /// see none of the changes until then. Batches can be nested.
+    /// This may only be used from the GUI thread.
+    class Batch : boost::noncopyable
+    {
+    public:
+        explicit Batch(SignalVector &vector)
+            : vector_(vector)
+        {
+            assertInGuiThread();
+            this->vector_.batchDepth_++;
+        }
+
+        ~Batch()
+        {
+            if (--this->vector_.batchDepth_ != 0)
+            {
+                return;
+            }
+
+            if (this->vector_.readOnlyOutdated_)
+            {
+                this->vector_.updateReadOnly();
+            }
+            this->vector_.batchFinished.invoke();
+        }
+
+    private:
+        SignalVector &vector_;
+    };
+
     /// A read-only version of the vector which can be used concurrently.
     std::shared_ptr<const std::vector<T>> readOnly()
     {
+        // the gui thread sees its own changes during a batch as well
+        if (isGuiThread() && this->readOnlyOutdated_)
+        {
+            this->updateReadOnly();
+        }
+
         return this->readOnly_;
     }
 
@@ -164,11 +210,27 @@ private:
         }
 
         // update concurrent version
+        if (this->batchDepth_ > 0)
+        {
+            this->readOnlyOutdated_ = true;
+        }
+        else
+        {
+            this->updateReadOnly();
+        }
+    }
+
+    void updateReadOnly()
+    {
         this->readOnly_ = std::make_shared<const std::vector<T>>(this->items_);
+        this->readOnlyOutdated_ = false;
     }
 
     std::vector<T> items_;
     std::shared_ptr<const std::vector<T>> readOnly_;
+    // changes in a batch that readOnly_ doesn't have yet, gui thread only
+    int batchDepth_ = 0;
+    bool readOnlyOutdated_ = false;
     QTimer itemsChangedTimer_;
     std::function<bool(const T &, const T &)> itemCompare_;
 };
@@ -30,63 +30,34 @@ public:
     {
         this->vector_ = vec;
 
-        auto insert = [this](const SignalVectorItemEvent<TVectorItem> &args) {
-            if (args.caller == this)
-            {
-                return;
-            }
-            // get row index
-            int index = this->getModelIndexFromVectorIndex(args.index);
-            assert(index >= 0 && index <= this->rows_.size());
-
-            // get row items
-            std::vector<QStandardItem *> row = this->createRow();
-            this->getRowFromItem(args.item, row);
-
-            // insert row
-            index = this->beforeInsert(args.item, row, index);
-
-            this->beginInsertRows(QModelIndex(), index, index);
-            this->rows_.insert(this->rows_.begin() + index,
-                               Row(row, args.item));
-            this->endInsertRows();
-        };
-
+        // views are told about all of the initial rows at once
+        this->beginReset();
         int i = 0;
         for (const TVectorItem &item : vec->raw())
         {
-            SignalVectorItemEvent<TVectorItem> args{item, i++, 0};
-
-            insert(args);
+            this->insertItem(item, i++);
         }
 
-        this->managedConnect(vec->itemInserted, insert);
-
-        this->managedConnect(vec->itemRemoved, [this](auto args) {
-            if (args.caller == this)
+        this->managedConnect(vec->itemInserted, [this](const auto &args) {
+            if (args.caller != this)
             {
-                return;
+                this->itemChanged(true, args.item, args.index);
             }
+        });
 
-            int row = this->getModelIndexFromVectorIndex(args.index);
-            assert(row >= 0 && row <= this->rows_.size());
-
-            // remove row
-            std::vector<QStandardItem *> items = this->rows_[row].items;
-
-            this->beginRemoveRows(QModelIndex(), row, row);
-            this->rows_.erase(this->rows_.begin() + row);
-            this->endRemoveRows();
-
-            this->afterRemoved(args.item, items, row);
-
-            for (QStandardItem *item : items)
+        this->managedConnect(vec->itemRemoved, [this](const auto &args) {
+            if (args.caller != this)
             {
-                delete item;
+                this->itemChanged(false, args.item, args.index);
             }
         });
 
+        this->managedConnect(vec->batchFinished, [this] {
+            this->applyPendingChanges();
+        });
+
         this->afterInit();
+        this->endReset();
     }
 
     SignalVectorModel<TVectorItem> *initialized(SignalVector<TVectorItem> *vec)
@@ -156,6 +127,8 @@ public:
         }
         else
         {
+            // readers only see the edited item, never the vector without it
+            typename SignalVector<TVectorItem>::Batch batch(*this->vector_);
             int vecRow = this->getVectorIndexFromModelIndex(row);
             this->vector_->removeAt(vecRow, this);
 
@@ -252,15 +225,20 @@ public:
         assert(sourceRow >= 0 && sourceRow < this->rows_.size());
 
         int signalVectorRow = this->getVectorIndexFromModelIndex(sourceRow);
+        // the rows only change once the batch is done
+        int destinationVectorRow =
+            this->getVectorIndexFromModelIndex(destinationChild);
         this->beginMoveRows(sourceParent, sourceRow, sourceRow,
                             destinationParent, destinationChild);
 
         TVectorItem item =
             this->getItemFromRow(this->rows_[sourceRow].items,
                                  this->rows_[sourceRow].original.get());
-        this->vector_->removeAt(signalVectorRow);
-        this->vector_->insert(
-            item, this->getVectorIndexFromModelIndex(destinationChild));
+        {
+            typename SignalVector<TVectorItem>::Batch batch(*this->vector_);
+            this->vector_->removeAt(signalVectorRow);
+            this->vector_->insert(item, destinationVectorRow);
+        }
 
         this->endMoveRows();
 
@@ -384,10 +362,7 @@ protected:
     {
         assert(index >= 0 && index <= this->rows_.size());
 
-        this->beginInsertRows(QModelIndex(), index, index);
-        this->rows_.insert(this->rows_.begin() + index,
-                           Row(std::move(row), true));
-        this->endInsertRows();
+        this->insertModelRow(index, Row(std::move(row), true));
     }
 
     void removeCustomRow(int index)
@@ -395,9 +370,7 @@ protected:
         assert(index >= 0 && index <= this->rows_.size());
         assert(this->rows_[index].isCustomRow);
 
-        this->beginRemoveRows(QModelIndex(), index, index);
-        this->rows_.erase(this->rows_.begin() + index);
-        this->endRemoveRows();
+        this->removeModelRow(index);
     }
 
     std::vector<QStandardItem *> createRow()
@@ -436,15 +409,167 @@ protected:
     }
 
 private:
+    // batches with more changes than this reset the model instead of
+    // telling views about every row
+    static constexpr size_t MAX_INCREMENTAL_CHANGES = 16;
+
+    struct Change {
+        bool inserted;
+        TVectorItem item;
+        int index;
+    };
+
     std::vector<QMap<int, QVariant>> headerData_;
     SignalVector<TVectorItem> *vector_;
     std::vector<Row> rows_;
 
     const int columnCount_;
 
+    // changes of the current batch of the vector, applied once it's done
+    std::vector<Change> pendingChanges_;
+    // rows are changed without telling views while the model is reset
+    bool resetting_ = false;
+    // without custom rows the indices of the model and the vector match
+    int customRowCount_ = 0;
+
+    void itemChanged(bool inserted, const TVectorItem &item, int index)
+    {
+        if (this->vector_->inBatch())
+        {
+            this->pendingChanges_.push_back({inserted, item, index});
+            return;
+        }
+
+        if (inserted)
+        {
+            this->insertItem(item, index);
+        }
+        else
+        {
+            this->removeItem(item, index);
+        }
+    }
+
+    void applyPendingChanges()
+    {
+        if (this->pendingChanges_.empty())
+        {
+            return;
+        }
+
+        auto changes = std::move(this->pendingChanges_);
+        this->pendingChanges_.clear();
+
+        bool reset = changes.size() > MAX_INCREMENTAL_CHANGES;
+        if (reset)
+        {
+            this->beginReset();
+        }
+        for (const auto &change : changes)
+        {
+            if (change.inserted)
+            {
+                this->insertItem(change.item, change.index);
+            }
+            else
+            {
+                this->removeItem(change.item, change.index);
+            }
+        }
+        if (reset)
+        {
+            this->endReset();
+        }
+    }
+
+    void insertItem(const TVectorItem &item, int vectorIndex)
+    {
+        int index = this->getModelIndexFromVectorIndex(vectorIndex);
+        assert(index >= 0 && index <= this->rows_.size());
+
+        std::vector<QStandardItem *> row = this->createRow();
+        this->getRowFromItem(item, row);
+
+        index = this->beforeInsert(item, row, index);
+        this->insertModelRow(index, Row(row, item));
+    }
+
+    void removeItem(const TVectorItem &item, int vectorIndex)
+    {
+        int index = this->getModelIndexFromVectorIndex(vectorIndex);
+        assert(index >= 0 && index <= this->rows_.size());
+
+        std::vector<QStandardItem *> items = this->rows_[index].items;
+        this->removeModelRow(index);
+        this->afterRemoved(item, items, index);
+
+        for (QStandardItem *cell : items)
+        {
+            delete cell;
+        }
+    }
+
+    void insertModelRow(int index, Row row)
+    {
+        if (!this->resetting_)
+        {
+            this->beginInsertRows(QModelIndex(), index, index);
+        }
+        if (row.isCustomRow)
+        {
+            this->customRowCount_++;
+        }
+        this->rows_.insert(this->rows_.begin() + index, std::move(row));
+        if (!this->resetting_)
+        {
+            this->endInsertRows();
+        }
+    }
+
+    void removeModelRow(int index)
+    {
+        if (!this->resetting_)
+        {
+            this->beginRemoveRows(QModelIndex(), index, index);
+        }
+        if (this->rows_[index].isCustomRow)
+        {
+            this->customRowCount_--;
+        }
+        this->rows_.erase(this->rows_.begin() + index);
+        if (!this->resetting_)
+        {
+            this->endRemoveRows();
+        }
+    }
+
+    // what the index lookups return for rows that don't exist
+    int clampedRowIndex(int index) const
+    {
+        int size = int(this->rows_.size());
+        return index >= 0 && index < size ? index : size;
+    }
+
+    void beginReset()
+    {
+        this->beginResetModel();
+        this->resetting_ = true;
+    }
+
+    void endReset()
+    {
+        this->resetting_ = false;
+        this->endResetModel();
+    }
+
     // returns the related index of the SignalVector
     int getVectorIndexFromModelIndex(int index)
     {
+        if (this->customRowCount_ == 0)
+        {
+            return this->clampedRowIndex(index);
+        }
+
         int i = 0;
 
         for (auto &row : this->rows_)
@@ -469,6 +594,11 @@ public:
     // returns the related index of the model
     int getModelIndexFromVectorIndex(int vectorIndex) const
     {
+        if (this->customRowCount_ == 0)
+        {
+            return this->clampedRowIndex(vectorIndex);
+        }
+
         int modelIndex = 0;
 
         for (auto &row : this->rows())
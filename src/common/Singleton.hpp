@@ -12,6 +12,17 @@ class Singleton : boost::noncopyable
 public:
     virtual ~Singleton() = default;
 
+    /// Runs on the thread pool before initialize, at the same time as the
+    /// load of the other singletons. Only for work that touches neither the
+    /// gui, the settings nor other singletons, like reading and parsing
+    /// files.
+    virtual void load(Paths &paths)
+    {
+        (void)(paths);
+    }
+
+    /// Runs on the gui thread after load, in the order the singletons were
+    /// created in
     virtual void initialize(Settings &settings, Paths &paths)
     {
         (void)(settings);
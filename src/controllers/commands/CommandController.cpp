@@ -1,6 +1,7 @@
 #include "CommandController.hpp"
 
 #include "Application.hpp"
+#include "common/QLogging.hpp"
 #include "common/SignalVector.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/commands/Command.hpp"
@@ -8,6 +9,8 @@
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "messages/MessageElement.hpp"
+#include "providers/twitch/IrcReplay.hpp"
+#include "providers/twitch/SyntheticLoad.hpp"
 #include "providers/twitch/TwitchCommon.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/api/Helix.hpp"
@@ -16,10 +19,13 @@
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/ChannelCosts.hpp"
 #include "util/CombinePath.hpp"
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IncognitoBrowser.hpp"
+#include "util/MemoryUsage.hpp"
+#include "util/SettingsWriter.hpp"
 #include "util/StreamLink.hpp"
 #include "util/Twitch.hpp"
 #include "widgets/Window.hpp"
@@ -136,7 +142,7 @@ bool appendWhisperMessageWordsLocally(const QStringList &words)
     b->flags.set(MessageFlag::Whisper);
     auto messagexD = b.release();
 
-    app->twitch->whispersChannel->addMessage(messagexD);
+    app->twitch->whispersChannel->collect(messagexD);
 
     auto overrideFlags = boost::optional<MessageFlags>(messagexD->flags);
     overrideFlags->set(MessageFlag::DoNotLog);
@@ -253,7 +259,7 @@ void CommandController::initialize(Settings &, Paths &paths)
         {
             if (cmd.name == args.item.name)
             {
-                this->userCommands_[cmd.name] = cmd;
+                this->userCommands_[cmd.name] = CommandTemplate(cmd.func);
                 break;
             }
         }
@@ -275,9 +281,9 @@ void CommandController::initialize(Settings &, Paths &paths)
     this->items.itemRemoved.connect(addFirstMatchToMap);
 
     // Initialize setting manager for commands.json
-    auto path = combinePath(paths.settingsDirectory, "commands.json");
+    this->path_ = combinePath(paths.settingsDirectory, "commands.json");
     this->sm_ = std::make_shared<pajlada::Settings::SettingManager>();
-    this->sm_->setPath(qPrintable(path));
+    this->sm_->setPath(qPrintable(this->path_));
     this->sm_->setBackupEnabled(true);
     this->sm_->setBackupSlots(9);
 
@@ -297,9 +303,12 @@ void CommandController::initialize(Settings &, Paths &paths)
 
     // Add loaded commands to our vector of commands (which will update the map
     // of commands)
-    for (const auto &command : this->commandsSetting_->getValue())
     {
-        this->items.append(command);
+        SignalVector<Command>::Batch batch(this->items);
+        for (const auto &command : this->commandsSetting_->getValue())
+        {
+            this->items.append(command);
+        }
     }
 
     /// Deprecated commands
@@ -439,6 +448,147 @@ void CommandController::initialize(Settings &, Paths &paths)
             return "";
         });
 
+    this->registerCommand(
+        "/debug-replay", [](const QStringList &words, ChannelPtr channel) {
+            auto &replay = IrcReplay::instance();
+
+            if (words.size() == 2 && words[1] == "stop")
+            {
+                replay.stop();
+                return "";
+            }
+
+            if (words.size() < 2 || words.size() > 3)
+            {
+                channel->addMessage(makeSystemMessage(
+                    "Usage: /debug-replay <file> [<lines>/s | <speed>x] - "
+                    "replays a log of raw irc lines into the open channels, "
+                    "at its original pace by default. /debug-replay stop "
+                    "ends it early."));
+                return "";
+            }
+
+            double linesPerSecond = 0;
+            double speed = 1;
+            if (words.size() == 3)
+            {
+                auto rate = words[2];
+                bool ok = false;
+                if (rate.endsWith("/s"))
+                {
+                    linesPerSecond = rate.left(rate.size() - 2).toDouble(&ok);
+                }
+                else if (rate.endsWith("x"))
+                {
+                    speed = rate.left(rate.size() - 1).toDouble(&ok);
+                }
+
+                if (!ok || linesPerSecond < 0 || speed <= 0)
+                {
+                    channel->addMessage(makeSystemMessage(
+                        QString("Invalid rate %1, use for example 500/s or "
+                                "10x")
+                            .arg(rate)));
+                    return "";
+                }
+            }
+
+            auto error = replay.start(
+                words[1], linesPerSecond, speed,
+                [weak = std::weak_ptr<Channel>(channel)](const auto &stats) {
+                    qCDebug(chatterinoApp) << stats.summary();
+                    if (auto channel = weak.lock())
+                    {
+                        channel->addMessage(
+                            makeSystemMessage(stats.summary()));
+                    }
+                });
+            if (!error.isEmpty())
+            {
+                channel->addMessage(makeSystemMessage(error));
+            }
+
+            return "";
+        });
+
+    this->registerCommand(
+        "/debug-load", [](const QStringList &words, ChannelPtr channel) {
+            if (words.size() == 2 && words[1] == "stop")
+            {
+                IrcReplay::instance().stop();
+                return "";
+            }
+
+            // the load goes into every open channel with "all", otherwise
+            // only into this one
+            auto options = words.mid(1);
+            std::vector<ChannelPtr> channels{channel};
+            if (!options.isEmpty() && options.front() == "all")
+            {
+                options.removeFirst();
+                channels.clear();
+                getApp()->twitch->forEachChannel([&](ChannelPtr channel) {
+                    channels.push_back(std::move(channel));
+                });
+            }
+
+            SyntheticLoad load;
+            auto error = load.parse(options);
+            if (error.isEmpty())
+            {
+                error = startSyntheticLoad(
+                    load, channels,
+                    [weak = std::weak_ptr<Channel>(channel)](
+                        const auto &stats) {
+                        qCDebug(chatterinoApp) << stats.summary();
+                        if (auto channel = weak.lock())
+                        {
+                            channel->addMessage(
+                                makeSystemMessage(stats.summary()));
+                        }
+                    });
+            }
+            if (!error.isEmpty())
+            {
+                channel->addMessage(makeSystemMessage(
+                    error + ". Usage: /debug-load [all] [rate=<messages/s>] "
+                            "[seconds=<n>] [emotes|links|cheers|highlights|"
+                            "timeouts|pubsub=<0-1>] - generates chat "
+                            "traffic in this channel or all open ones. "
+                            "/debug-load stop ends it early."));
+            }
+
+            return "";
+        });
+
+    this->registerCommand(
+        "/debug-memory", [](const QStringList & /*words*/, ChannelPtr channel) {
+            for (const auto &line : MemoryUsage::snapshot(10))
+            {
+                qCDebug(chatterinoApp) << line;
+                channel->addMessage(makeSystemMessage(line));
+            }
+            return "";
+        });
+
+    this->registerCommand(
+        "/debug-costs", [](const QStringList &words, ChannelPtr channel) {
+            if (words.size() > 1 && words[1] == "reset")
+            {
+                ChannelCosts::reset();
+                channel->addMessage(
+                    makeSystemMessage("The channel costs were reset."));
+                return "";
+            }
+
+            for (const auto &line : ChannelCosts::snapshot(10))
+            {
+                qCDebug(chatterinoApp) << line;
+                channel->addMessage(makeSystemMessage(line));
+            }
+            return "";
+        });
+
     this->registerCommand("/uptime", [](const auto & /*words*/, auto channel) {
         auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
         if (twitchChannel == nullptr)
@@ -930,7 +1080,7 @@ void CommandController::initialize(Settings &, Paths &paths)
 
 void CommandController::save()
 {
-    this->sm_->save();
+    SettingsWriter::instance().queue(this->sm_, this->path_);
 }
 
 CommandModel *CommandController::createModel(QObject *parent)
@@ -1041,91 +1191,72 @@ QString CommandController::execCustomCommand(const QStringList &words,
                                              bool dryRun, ChannelPtr channel,
                                              std::map<QString, QString> context)
 {
-    QString result;
-
-    static QRegularExpression parseCommand(
-        R"((^|[^{])({{)*{(\d+\+?|([a-zA-Z.-]+)(?:;(.+?))?)})");
+    return this->execCustomCommand(words, CommandTemplate(command.func),
+                                   dryRun, channel, context);
+}
 
-    int lastCaptureEnd = 0;
+QString CommandController::execCustomCommand(
+    const QStringList &words, const CommandTemplate &command, bool dryRun,
+    ChannelPtr channel, const std::map<QString, QString> &context)
+{
+    using Type = CommandTemplate::Token::Type;
 
-    auto globalMatch = parseCommand.globalMatch(command.func);
-    int matchOffset = 0;
+    QString result;
 
-    while (true)
+    for (const auto &token : command.tokens())
     {
-        QRegularExpressionMatch match =
-            parseCommand.match(command.func, matchOffset);
-
-        if (!match.hasMatch())
+        switch (token.type)
         {
+            case Type::Text: {
+                result += token.text;
+            }
             break;
-        }
-
-        result += command.func.mid(lastCaptureEnd,
-                                   match.capturedStart() - lastCaptureEnd + 1);
-
-        lastCaptureEnd = match.capturedEnd();
-        matchOffset = lastCaptureEnd - 1;
-
-        QString wordIndexMatch = match.captured(3);
 
-        bool plus = wordIndexMatch.at(wordIndexMatch.size() - 1) == '+';
-        wordIndexMatch = wordIndexMatch.replace("+", "");
+            case Type::Variable: {
+                auto var = COMMAND_VARS.find(token.text);
 
-        bool ok;
-        int wordIndex = wordIndexMatch.replace("=", "").toInt(&ok);
-        if (!ok || wordIndex == 0)
-        {
-            auto varName = match.captured(4);
-            auto altText = match.captured(5);  // alt text or empty string
-
-            auto var = COMMAND_VARS.find(varName);
-
-            if (var != COMMAND_VARS.end())
-            {
-                result += var->second(altText, channel);
-            }
-            else
-            {
-                auto it = context.find(varName);
-                if (it != context.end())
+                if (var != COMMAND_VARS.end())
                 {
-                    result += it->second.isEmpty() ? altText : it->second;
+                    result += var->second(token.altText, channel);
                 }
                 else
                 {
-                    result += "{" + match.captured(3) + "}";
+                    auto it = context.find(token.text);
+                    if (it != context.end())
+                    {
+                        result +=
+                            it->second.isEmpty() ? token.altText : it->second;
+                    }
+                    else
+                    {
+                        result += token.placeholder;
+                    }
                 }
             }
-            continue;
-        }
+            break;
 
-        if (words.length() <= wordIndex)
-        {
-            continue;
-        }
+            case Type::Word: {
+                if (token.wordIndex < words.length())
+                {
+                    result += words[token.wordIndex];
+                }
+            }
+            break;
 
-        if (plus)
-        {
-            bool first = true;
-            for (int i = wordIndex; i < words.length(); i++)
-            {
-                if (!first)
+            case Type::WordsFrom: {
+                for (int i = token.wordIndex; i < words.length(); i++)
                 {
-                    result += " ";
+                    if (i != token.wordIndex)
+                    {
+                        result += " ";
+                    }
+                    result += words[i];
                 }
-                result += words[i];
-                first = false;
             }
-        }
-        else
-        {
-            result += words[wordIndex];
+            break;
         }
     }
 
-    result += command.func.mid(lastCaptureEnd);
-
     if (result.size() > 0 && result.at(0) == '{')
     {
         result = result.mid(1);
@@ -4,6 +4,7 @@
 #include "common/SignalVector.hpp"
 #include "common/Singleton.hpp"
 #include "controllers/commands/Command.hpp"
+#include "controllers/commands/CommandTemplate.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 
 #include <QMap>
@@ -37,6 +38,10 @@ public:
     QString execCustomCommand(const QStringList &words, const Command &command,
                               bool dryRun, ChannelPtr channel,
                               std::map<QString, QString> context = {});
+    QString execCustomCommand(const QStringList &words,
+                              const CommandTemplate &command, bool dryRun,
+                              ChannelPtr channel,
+                              const std::map<QString, QString> &context = {});
 
 private:
     void load(Paths &paths);
@@ -49,11 +54,12 @@ private:
     // Chatterino commands
     QMap<QString, CommandFunction> commands_;
 
-    // User-created commands
-    QMap<QString, Command> userCommands_;
+    // User-created commands, parsed when they are added
+    QMap<QString, CommandTemplate> userCommands_;
     int maxSpaces_ = 0;
 
     std::shared_ptr<pajlada::Settings::SettingManager> sm_;
+    QString path_;
     // Because the setting manager is not initialized until the initialize
     // function is called (and not in the constructor), we have to
     // late-initialize the setting, which is why we're storing it as a
@@ -0,0 +1,66 @@
+#include "controllers/commands/CommandTemplate.hpp"
+
+#include <QRegularExpression>
+
+namespace chatterino {
+
+CommandTemplate::CommandTemplate(const QString &func)
+{
+    static QRegularExpression parseCommand(
+        R"((^|[^{])({{)*{(\d+\+?|([a-zA-Z.-]+)(?:;(.+?))?)})");
+
+    auto addText = [this](QString text) {
+        if (!text.isEmpty())
+        {
+            this->tokens_.push_back({Token::Type::Text, std::move(text)});
+        }
+    };
+
+    int lastCaptureEnd = 0;
+    int matchOffset = 0;
+
+    while (true)
+    {
+        QRegularExpressionMatch match = parseCommand.match(func, matchOffset);
+
+        if (!match.hasMatch())
+        {
+            break;
+        }
+
+        // the match starts with the character before the placeholder
+        addText(func.mid(lastCaptureEnd,
+                         match.capturedStart() - lastCaptureEnd + 1));
+
+        lastCaptureEnd = match.capturedEnd();
+        matchOffset = lastCaptureEnd - 1;
+
+        QString wordIndexMatch = match.captured(3);
+
+        bool plus = wordIndexMatch.at(wordIndexMatch.size() - 1) == '+';
+        wordIndexMatch = wordIndexMatch.replace("+", "");
+
+        bool ok;
+        int wordIndex = wordIndexMatch.replace("=", "").toInt(&ok);
+        if (!ok || wordIndex == 0)
+        {
+            this->tokens_.push_back({Token::Type::Variable, match.captured(4),
+                                     match.captured(5),
+                                     "{" + match.captured(3) + "}"});
+            continue;
+        }
+
+        Token token{plus ? Token::Type::WordsFrom : Token::Type::Word};
+        token.wordIndex = wordIndex;
+        this->tokens_.push_back(std::move(token));
+    }
+
+    addText(func.mid(lastCaptureEnd));
+}
+
+const std::vector<CommandTemplate::Token> &CommandTemplate::tokens() const
+{
+    return this->tokens_;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,48 @@
+#pragma once
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief The func of a custom command, split into its text and placeholders.
+ *
+ * Placeholders are word references like {1} and {1+} and variables like
+ * {channel.name} or {user.name;fallback}. The func is parsed once when the
+ * command is added, running the command only concatenates the tokens.
+ */
+class CommandTemplate
+{
+public:
+    struct Token {
+        enum class Type {
+            Text,
+            // {1}
+            Word,
+            // {1+}, the words from the index on
+            WordsFrom,
+            // {name} or {name;altText}
+            Variable,
+        };
+
+        Type type;
+        // the text or the name of the variable
+        QString text;
+        // for variables, used if the variable is empty
+        QString altText;
+        // for variables, added as it is if there is no such variable
+        QString placeholder;
+        int wordIndex = 0;
+    };
+
+    explicit CommandTemplate(const QString &func = QString());
+
+    const std::vector<Token> &tokens() const;
+
+private:
+    std::vector<Token> tokens_;
+};
+
+}  // namespace chatterino
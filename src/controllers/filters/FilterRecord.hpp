@@ -11,7 +11,10 @@
 #include <QUuid>
 #include <pajlada/serialize.hpp>
 
+#include <algorithm>
 #include <memory>
+#include <mutex>
+#include <unordered_map>
 
 namespace chatterino {
 
@@ -60,17 +63,75 @@ public:
         return this->parser_->valid();
     }
 
-    bool filter(const filterparser::ContextMap &context) const
+    bool filter(const filterparser::Context &context) const
     {
         return this->parser_->execute(context);
     }
 
+    /// Same as filter, the result is remembered per message if the filter
+    /// is cacheable. Editing a filter creates a new record, so results are
+    /// never those of an older version. Can be called from any thread.
+    bool filter(const MessagePtr &message,
+                const filterparser::Context &context) const
+    {
+        if (!this->parser_->isCacheable())
+        {
+            return this->parser_->execute(context);
+        }
+
+        {
+            std::lock_guard<std::mutex> lock(this->cacheMutex_);
+            auto it = this->cache_.find(message.get());
+            // the address could belong to a newer message if the one it was
+            // seen for is gone
+            if (it != this->cache_.end() && !it->second.message.expired())
+            {
+                return it->second.result;
+            }
+        }
+
+        auto result = this->parser_->execute(context);
+
+        std::lock_guard<std::mutex> lock(this->cacheMutex_);
+        this->cache_[message.get()] = {message, result};
+
+        // drops the results of messages that are gone once the table has
+        // doubled in size
+        if (this->cache_.size() >= this->cachePurgeSize_)
+        {
+            for (auto it = this->cache_.begin(); it != this->cache_.end();)
+            {
+                if (it->second.message.expired())
+                {
+                    it = this->cache_.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
+            }
+            this->cachePurgeSize_ =
+                std::max<size_t>(1024, this->cache_.size() * 2);
+        }
+
+        return result;
+    }
+
 private:
+    struct CachedResult {
+        std::weak_ptr<const Message> message;
+        bool result = false;
+    };
+
     QString name_;
     QString filter_;
     QUuid id_;
 
     std::unique_ptr<filterparser::FilterParser> parser_;
+
+    mutable std::mutex cacheMutex_;
+    mutable std::unordered_map<const Message *, CachedResult> cache_;
+    mutable size_t cachePurgeSize_ = 1024;
 };
 
 using FilterRecordPtr = std::shared_ptr<FilterRecord>;
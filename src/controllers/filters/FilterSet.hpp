@@ -2,6 +2,7 @@
 
 #include "controllers/filters/FilterRecord.hpp"
 #include "singletons/Settings.hpp"
+#include "util/ChannelCosts.hpp"
 
 namespace chatterino {
 
@@ -41,11 +42,12 @@ public:
         if (this->filters_.size() == 0)
             return true;
 
-        filterparser::ContextMap context =
-            filterparser::buildContextMap(m, channel.get());
+        ChannelCosts::Scope costs(channel ? channel->getName() : QString(),
+                                  CostCategory::Filters);
+        filterparser::Context context(m, channel.get());
         for (const auto &f : this->filters_.values())
         {
-            if (!f->valid() || !f->filter(context))
+            if (!f->valid() || !f->filter(m, context))
                 return false;
         }
 
@@ -0,0 +1,183 @@
+#include "controllers/filters/parser/Context.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <QHash>
+
+namespace filterparser {
+
+using MessageFlag = chatterino::MessageFlag;
+
+Identifier identifierFromName(const QString &name)
+{
+    static const QHash<QString, Identifier> identifiers = {
+        {"author.badges", Identifier::AuthorBadges},
+        {"author.color", Identifier::AuthorColor},
+        {"author.name", Identifier::AuthorName},
+        {"author.no_color", Identifier::AuthorNoColor},
+        {"author.subbed", Identifier::AuthorSubbed},
+        {"author.sub_length", Identifier::AuthorSubLength},
+
+        {"channel.name", Identifier::ChannelName},
+        {"channel.watching", Identifier::ChannelWatching},
+        {"channel.live", Identifier::ChannelLive},
+
+        {"flags.highlighted", Identifier::FlagsHighlighted},
+        {"flags.points_redeemed", Identifier::FlagsPointsRedeemed},
+        {"flags.sub_message", Identifier::FlagsSubMessage},
+        {"flags.system_message", Identifier::FlagsSystemMessage},
+        {"flags.reward_message", Identifier::FlagsRewardMessage},
+        {"flags.first_message", Identifier::FlagsFirstMessage},
+        {"flags.whisper", Identifier::FlagsWhisper},
+
+        {"message.content", Identifier::MessageContent},
+        {"message.length", Identifier::MessageLength},
+    };
+
+    return identifiers.value(name, Identifier::Unknown);
+}
+
+ValueType identifierType(Identifier identifier)
+{
+    switch (identifier)
+    {
+        case Identifier::AuthorBadges:
+            return ValueType::StringList;
+        case Identifier::AuthorColor:
+            return ValueType::Color;
+        case Identifier::AuthorName:
+        case Identifier::ChannelName:
+        case Identifier::MessageContent:
+            return ValueType::String;
+        case Identifier::AuthorSubLength:
+        case Identifier::MessageLength:
+            return ValueType::Int;
+        case Identifier::AuthorNoColor:
+        case Identifier::AuthorSubbed:
+        case Identifier::ChannelWatching:
+        case Identifier::ChannelLive:
+        case Identifier::FlagsHighlighted:
+        case Identifier::FlagsPointsRedeemed:
+        case Identifier::FlagsSubMessage:
+        case Identifier::FlagsSystemMessage:
+        case Identifier::FlagsRewardMessage:
+        case Identifier::FlagsFirstMessage:
+        case Identifier::FlagsWhisper:
+            return ValueType::Bool;
+        default:
+            return ValueType::Unknown;
+    }
+}
+
+Context::Context(const MessagePtr &message, chatterino::Channel *channel)
+    : message_(*message)
+    , channel_(channel)
+{
+}
+
+QVariant Context::value(Identifier identifier) const
+{
+    switch (identifierType(identifier))
+    {
+        case ValueType::Bool:
+            return this->boolValue(identifier);
+        case ValueType::Int:
+            return this->intValue(identifier);
+        case ValueType::String:
+            return this->stringValue(identifier);
+        case ValueType::StringList:
+            return this->stringListValue(identifier);
+        case ValueType::Color:
+            return this->message_.usernameColor;
+        default:
+            return QVariant();
+    }
+}
+
+bool Context::boolValue(Identifier identifier) const
+{
+    const auto &flags = this->message_.flags;
+
+    switch (identifier)
+    {
+        case Identifier::AuthorNoColor:
+            return !this->message_.usernameColor.isValid();
+        case Identifier::AuthorSubbed:
+            return this->message_.badgeSet->isSubscribed();
+
+        case Identifier::ChannelWatching: {
+            auto watchingChannel =
+                chatterino::getApp()->twitch->watchingChannel.get();
+            return !watchingChannel->getName().isEmpty() &&
+                   watchingChannel->getName().compare(
+                       this->message_.channelName, Qt::CaseInsensitive) == 0;
+        }
+        case Identifier::ChannelLive: {
+            auto *tc =
+                dynamic_cast<chatterino::TwitchChannel *>(this->channel_);
+            return this->channel_ && !this->channel_->isEmpty() && tc &&
+                   tc->isLive();
+        }
+
+        case Identifier::FlagsHighlighted:
+            return flags.has(MessageFlag::Highlighted);
+        case Identifier::FlagsPointsRedeemed:
+            return flags.has(MessageFlag::RedeemedHighlight);
+        case Identifier::FlagsSubMessage:
+            return flags.has(MessageFlag::Subscription);
+        case Identifier::FlagsSystemMessage:
+            return flags.has(MessageFlag::System);
+        case Identifier::FlagsRewardMessage:
+            return flags.has(MessageFlag::RedeemedChannelPointReward);
+        case Identifier::FlagsFirstMessage:
+            return flags.has(MessageFlag::FirstMessage);
+        case Identifier::FlagsWhisper:
+            return flags.has(MessageFlag::Whisper);
+
+        default:
+            return false;
+    }
+}
+
+int Context::intValue(Identifier identifier) const
+{
+    switch (identifier)
+    {
+        case Identifier::AuthorSubLength:
+            return this->message_.badgeSet->subMonths;
+        case Identifier::MessageLength:
+            return this->message_.messageText.length();
+        default:
+            return 0;
+    }
+}
+
+QString Context::stringValue(Identifier identifier) const
+{
+    switch (identifier)
+    {
+        case Identifier::AuthorName:
+            return this->message_.displayName;
+        case Identifier::ChannelName:
+            return this->message_.channelName;
+        case Identifier::MessageContent:
+            return this->message_.messageText;
+        default:
+            return QString();
+    }
+}
+
+QStringList Context::stringListValue(Identifier identifier) const
+{
+    if (identifier == Identifier::AuthorBadges)
+    {
+        return this->message_.badgeSet->names;
+    }
+
+    return QStringList();
+}
+
+}  // namespace filterparser
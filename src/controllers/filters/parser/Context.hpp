@@ -0,0 +1,88 @@
+#pragma once
+
+#include "messages/Message.hpp"
+
+#include <QString>
+#include <QStringList>
+#include <QVariant>
+
+#include <memory>
+
+namespace chatterino {
+
+class Channel;
+
+}  // namespace chatterino
+
+namespace filterparser {
+
+using MessagePtr = std::shared_ptr<const chatterino::Message>;
+
+// Identifiers are resolved once when parsing, see validIdentifiersMap for
+// their names
+enum class Identifier {
+    AuthorBadges,
+    AuthorColor,
+    AuthorName,
+    AuthorNoColor,
+    AuthorSubbed,
+    AuthorSubLength,
+
+    ChannelName,
+    ChannelWatching,
+    ChannelLive,
+
+    FlagsHighlighted,
+    FlagsPointsRedeemed,
+    FlagsSubMessage,
+    FlagsSystemMessage,
+    FlagsRewardMessage,
+    FlagsFirstMessage,
+    FlagsWhisper,
+
+    MessageContent,
+    MessageLength,
+
+    Unknown,
+};
+
+// Type an expression evaluates to, Unknown if it depends on the message
+enum class ValueType {
+    Unknown,
+    Bool,
+    Int,
+    String,
+    StringList,
+    Color,
+    RegularExpression,
+};
+
+Identifier identifierFromName(const QString &name);
+ValueType identifierType(Identifier identifier);
+
+/**
+ * @brief Values of all identifiers for a single message.
+ *
+ * Nothing is computed up front, values are read from the message when an
+ * expression asks for them. What's derived from the badges was computed
+ * when the message was built, see BadgeSet. The typed getters may only be
+ * used for identifiers of the matching type.
+ */
+class Context
+{
+public:
+    Context(const MessagePtr &message, chatterino::Channel *channel);
+
+    QVariant value(Identifier identifier) const;
+
+    bool boolValue(Identifier identifier) const;
+    int intValue(Identifier identifier) const;
+    QString stringValue(Identifier identifier) const;
+    QStringList stringListValue(Identifier identifier) const;
+
+private:
+    const chatterino::Message &message_;
+    chatterino::Channel *channel_;
+};
+
+}  // namespace filterparser
@@ -1,105 +1,10 @@
 #include "FilterParser.hpp"
 
-#include "Application.hpp"
-#include "common/Channel.hpp"
 #include "controllers/filters/parser/Types.hpp"
-#include "providers/twitch/TwitchIrcServer.hpp"
 
-namespace filterparser {
-
-ContextMap buildContextMap(const MessagePtr &m, chatterino::Channel *channel)
-{
-    auto watchingChannel = chatterino::getApp()->twitch->watchingChannel.get();
-
-    /* Known Identifiers
-     *
-     * author.badges
-     * author.color
-     * author.name
-     * author.no_color
-     * author.subbed
-     * author.sub_length
-     *
-     * channel.name
-     * channel.watching
-     *
-     * flags.highlighted
-     * flags.points_redeemed
-     * flags.sub_message
-     * flags.system_message
-     * flags.reward_message
-     * flags.first_message
-     * flags.whisper
-     *
-     * message.content
-     * message.length
-     *
-     */
-
-    using MessageFlag = chatterino::MessageFlag;
-
-    QStringList badges;
-    badges.reserve(m->badges.size());
-    for (const auto &e : m->badges)
-    {
-        badges << e.key_;
-    }
-
-    bool watching = !watchingChannel->getName().isEmpty() &&
-                    watchingChannel->getName().compare(
-                        m->channelName, Qt::CaseInsensitive) == 0;
-
-    bool subscribed = false;
-    int subLength = 0;
-    for (const QString &subBadge : {"subscriber", "founder"})
-    {
-        if (!badges.contains(subBadge))
-        {
-            continue;
-        }
-        subscribed = true;
-        if (m->badgeInfos.find(subBadge) != m->badgeInfos.end())
-        {
-            subLength = m->badgeInfos.at(subBadge).toInt();
-        }
-    }
-    ContextMap vars = {
-        {"author.badges", std::move(badges)},
-        {"author.color", m->usernameColor},
-        {"author.name", m->displayName},
-        {"author.no_color", !m->usernameColor.isValid()},
-        {"author.subbed", subscribed},
-        {"author.sub_length", subLength},
+#include <cassert>
 
-        {"channel.name", m->channelName},
-        {"channel.watching", watching},
-
-        {"flags.highlighted", m->flags.has(MessageFlag::Highlighted)},
-        {"flags.points_redeemed", m->flags.has(MessageFlag::RedeemedHighlight)},
-        {"flags.sub_message", m->flags.has(MessageFlag::Subscription)},
-        {"flags.system_message", m->flags.has(MessageFlag::System)},
-        {"flags.reward_message",
-         m->flags.has(MessageFlag::RedeemedChannelPointReward)},
-        {"flags.first_message", m->flags.has(MessageFlag::FirstMessage)},
-        {"flags.whisper", m->flags.has(MessageFlag::Whisper)},
-
-        {"message.content", m->messageText},
-        {"message.length", m->messageText.length()},
-    };
-    {
-        using namespace chatterino;
-        auto *tc = dynamic_cast<TwitchChannel *>(channel);
-        if (channel && !channel->isEmpty() && tc)
-        {
-            vars["channel.live"] = tc->isLive();
-        }
-        else
-        {
-            vars["channel.live"] = false;
-        }
-    }
-    return vars;
-}
+namespace filterparser {
 
 FilterParser::FilterParser(const QString &text)
     : text_(text)
@@ -108,8 +13,12 @@ FilterParser::FilterParser(const QString &text)
 {
 }
 
-bool FilterParser::execute(const ContextMap &context) const
+bool FilterParser::execute(const Context &context) const
 {
+    if (this->builtExpression_->returnType() == ValueType::Bool)
+    {
+        return this->builtExpression_->executeBool(context);
+    }
     return this->builtExpression_->execute(context).toBool();
 }
 
@@ -118,6 +27,11 @@ bool FilterParser::valid() const
     return this->valid_;
 }
 
+bool FilterParser::isCacheable() const
+{
+    return this->cacheable_;
+}
+
 ExpressionPtr FilterParser::parseExpression(bool top)
 {
     auto e = this->parseAnd();
@@ -273,8 +187,20 @@ ExpressionPtr FilterParser::parseValue()
         }
         else if (type == TokenType::IDENTIFIER)
         {
-            return std::make_unique<ValueExpression>(this->tokenizer_.next(),
-                                                     type);
+            auto name = this->tokenizer_.next();
+            switch (identifierFromName(name))
+            {
+                // the state of the channel and flags that are changed after
+                // the message was built
+                case Identifier::ChannelWatching:
+                case Identifier::ChannelLive:
+                case Identifier::FlagsHighlighted:
+                    this->cacheable_ = false;
+                    break;
+                default:
+                    break;
+            }
+            return std::make_unique<ValueExpression>(name, type);
         }
         else if (type == TokenType::REGULAR_EXPRESSION)
         {
@@ -3,22 +3,17 @@
 #include "controllers/filters/parser/Tokenizer.hpp"
 #include "controllers/filters/parser/Types.hpp"
 
-namespace chatterino {
-
-class Channel;
-
-}  // namespace chatterino
-
 namespace filterparser {
 
-ContextMap buildContextMap(const MessagePtr &m, chatterino::Channel *channel);
-
 class FilterParser
 {
 public:
     FilterParser(const QString &text);
-    bool execute(const ContextMap &context) const;
+    bool execute(const Context &context) const;
     bool valid() const;
+    /// Returns false if the result can change for the same message, e.g.
+    /// because it depends on whether the channel is live
+    bool isCacheable() const;
 
     const QStringList &errors() const;
     const QString debugString() const;
@@ -37,6 +32,7 @@ private:
 
     QStringList parseLog_;
     bool valid_ = true;
+    bool cacheable_ = true;
 
     QString text_;
     Tokenizer tokenizer_;
@@ -88,17 +88,74 @@ QString tokenTypeToInfoString(TokenType type)
 
 ValueExpression::ValueExpression(QVariant value, TokenType type)
     : value_(value)
-    , type_(type){};
+    , type_(type)
+{
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        this->identifier_ = identifierFromName(this->value_.toString());
+    }
+}
 
-QVariant ValueExpression::execute(const ContextMap &context) const
+QVariant ValueExpression::execute(const Context &context) const
 {
     if (this->type_ == TokenType::IDENTIFIER)
     {
-        return context.value(this->value_.toString());
+        return context.value(this->identifier_);
     }
     return this->value_;
 }
 
+ValueType ValueExpression::returnType() const
+{
+    switch (this->type_)
+    {
+        case IDENTIFIER:
+            return identifierType(this->identifier_);
+        case INT:
+            return ValueType::Int;
+        case STRING:
+            return ValueType::String;
+        default:
+            return ValueType::Unknown;
+    }
+}
+
+bool ValueExpression::executeBool(const Context &context) const
+{
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        return context.boolValue(this->identifier_);
+    }
+    return this->value_.toBool();
+}
+
+int ValueExpression::executeInt(const Context &context) const
+{
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        return context.intValue(this->identifier_);
+    }
+    return this->value_.toInt();
+}
+
+QString ValueExpression::executeString(const Context &context) const
+{
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        return context.stringValue(this->identifier_);
+    }
+    return this->value_.toString();
+}
+
+QStringList ValueExpression::executeStringList(const Context &context) const
+{
+    if (this->type_ == TokenType::IDENTIFIER)
+    {
+        return context.stringListValue(this->identifier_);
+    }
+    return this->value_.toStringList();
+}
+
 TokenType ValueExpression::type()
 {
     return this->type_;
@@ -134,7 +191,18 @@ RegexExpression::RegexExpression(QString regex, bool caseInsensitive)
           regex, caseInsensitive ? QRegularExpression::CaseInsensitiveOption
                                  : QRegularExpression::NoPatternOption)){};
 
-QVariant RegexExpression::execute(const ContextMap &) const
+QVariant RegexExpression::execute(const Context &) const
+{
+    return this->regex_;
+}
+
+ValueType RegexExpression::returnType() const
+{
+    return ValueType::RegularExpression;
+}
+
+QRegularExpression RegexExpression::executeRegularExpression(
+    const Context &) const
 {
     return this->regex_;
 }
@@ -157,7 +225,7 @@ QString RegexExpression::filterString() const
 ListExpression::ListExpression(ExpressionList list)
     : list_(std::move(list)){};
 
-QVariant ListExpression::execute(const ContextMap &context) const
+QVariant ListExpression::execute(const Context &context) const
 {
     QList<QVariant> results;
     bool allStrings = true;
@@ -188,6 +256,19 @@ QVariant ListExpression::execute(const ContextMap &context) const
     }
 }
 
+ValueType ListExpression::returnType() const
+{
+    // execute() returns a QStringList if every item turned out to be a string
+    for (const auto &exp : this->list_)
+    {
+        if (exp->returnType() != ValueType::String)
+        {
+            return ValueType::Unknown;
+        }
+    }
+    return ValueType::StringList;
+}
+
 QString ListExpression::debug() const
 {
     QStringList debugs;
@@ -215,10 +296,11 @@ BinaryOperation::BinaryOperation(TokenType op, ExpressionPtr left,
     : op_(op)
     , left_(std::move(left))
     , right_(std::move(right))
+    , returnType_(this->findReturnType())
 {
 }
 
-QVariant BinaryOperation::execute(const ContextMap &context) const
+QVariant BinaryOperation::execute(const Context &context) const
 {
     auto left = this->left_->execute(context);
     auto right = this->right_->execute(context);
@@ -409,6 +491,211 @@ QVariant BinaryOperation::execute(const ContextMap &context) const
     }
 }
 
+ValueType BinaryOperation::returnType() const
+{
+    return this->returnType_;
+}
+
+ValueType BinaryOperation::findReturnType() const
+{
+    auto left = this->left_->returnType();
+    auto right = this->right_->returnType();
+
+    switch (this->op_)
+    {
+        case PLUS:
+            if (left == ValueType::String &&
+                (right == ValueType::String || right == ValueType::Int))
+            {
+                return ValueType::String;
+            }
+            // anything but a string on the left side results in an int
+            if (left != ValueType::String && left != ValueType::Unknown)
+            {
+                return ValueType::Int;
+            }
+            return ValueType::Unknown;
+        case MINUS:
+        case MULTIPLY:
+        case DIVIDE:
+        case MOD:
+            return ValueType::Int;
+        case MATCH:
+            // matching against a list returns the captured text
+            if (right == ValueType::RegularExpression)
+            {
+                return ValueType::Bool;
+            }
+            return ValueType::Unknown;
+        default:
+            return ValueType::Bool;
+    }
+}
+
+bool BinaryOperation::executeBool(const Context &context) const
+{
+    auto left = this->left_->returnType();
+    auto right = this->right_->returnType();
+
+    auto both = [&](ValueType type) {
+        return left == type && right == type;
+    };
+
+    switch (this->op_)
+    {
+        case AND:
+            if (both(ValueType::Bool))
+            {
+                return this->left_->executeBool(context) &&
+                       this->right_->executeBool(context);
+            }
+            break;
+        case OR:
+            if (both(ValueType::Bool))
+            {
+                return this->left_->executeBool(context) ||
+                       this->right_->executeBool(context);
+            }
+            break;
+        case EQ:
+        case NEQ: {
+            bool equal;
+            if (both(ValueType::String))
+            {
+                equal = this->left_->executeString(context).compare(
+                            this->right_->executeString(context),
+                            Qt::CaseInsensitive) == 0;
+            }
+            else if (both(ValueType::Int))
+            {
+                equal = this->left_->executeInt(context) ==
+                        this->right_->executeInt(context);
+            }
+            else if (both(ValueType::Bool))
+            {
+                equal = this->left_->executeBool(context) ==
+                        this->right_->executeBool(context);
+            }
+            else
+            {
+                break;
+            }
+            return this->op_ == EQ ? equal : !equal;
+        }
+        case LT:
+            if (both(ValueType::Int))
+            {
+                return this->left_->executeInt(context) <
+                       this->right_->executeInt(context);
+            }
+            break;
+        case GT:
+            if (both(ValueType::Int))
+            {
+                return this->left_->executeInt(context) >
+                       this->right_->executeInt(context);
+            }
+            break;
+        case LTE:
+            if (both(ValueType::Int))
+            {
+                return this->left_->executeInt(context) <=
+                       this->right_->executeInt(context);
+            }
+            break;
+        case GTE:
+            if (both(ValueType::Int))
+            {
+                return this->left_->executeInt(context) >=
+                       this->right_->executeInt(context);
+            }
+            break;
+        case CONTAINS:
+            if (left == ValueType::StringList && right == ValueType::String)
+            {
+                return this->left_->executeStringList(context).contains(
+                    this->right_->executeString(context), Qt::CaseInsensitive);
+            }
+            if (both(ValueType::String))
+            {
+                return this->left_->executeString(context).contains(
+                    this->right_->executeString(context), Qt::CaseInsensitive);
+            }
+            break;
+        case STARTS_WITH:
+            if (both(ValueType::String))
+            {
+                return this->left_->executeString(context).startsWith(
+                    this->right_->executeString(context), Qt::CaseInsensitive);
+            }
+            break;
+        case ENDS_WITH:
+            if (both(ValueType::String))
+            {
+                return this->left_->executeString(context).endsWith(
+                    this->right_->executeString(context), Qt::CaseInsensitive);
+            }
+            break;
+        case MATCH:
+            if (left == ValueType::String &&
+                right == ValueType::RegularExpression)
+            {
+                return this->right_->executeRegularExpression(context)
+                    .match(this->left_->executeString(context))
+                    .hasMatch();
+            }
+            break;
+        default:
+            break;
+    }
+
+    return this->execute(context).toBool();
+}
+
+int BinaryOperation::executeInt(const Context &context) const
+{
+    if (this->left_->returnType() != ValueType::Int ||
+        this->right_->returnType() != ValueType::Int)
+    {
+        return this->execute(context).toInt();
+    }
+
+    auto left = this->left_->executeInt(context);
+    auto right = this->right_->executeInt(context);
+
+    switch (this->op_)
+    {
+        case PLUS:
+            return left + right;
+        case MINUS:
+            return left - right;
+        case MULTIPLY:
+            return left * right;
+        case DIVIDE:
+            return left / right;
+        case MOD:
+            return left % right;
+        default:
+            return this->execute(context).toInt();
+    }
+}
+
+QString BinaryOperation::executeString(const Context &context) const
+{
+    if (this->op_ == PLUS && this->returnType_ == ValueType::String)
+    {
+        auto left = this->left_->executeString(context);
+        if (this->right_->returnType() == ValueType::Int)
+        {
+            return left.append(
+                QString::number(this->right_->executeInt(context)));
+        }
+        return left.append(this->right_->executeString(context));
+    }
+
+    return this->execute(context).toString();
+}
+
 QString BinaryOperation::debug() const
 {
     return QString("(%1 %2 %3)")
@@ -474,7 +761,7 @@ UnaryOperation::UnaryOperation(TokenType op, ExpressionPtr right)
 {
 }
 
-QVariant UnaryOperation::execute(const ContextMap &context) const
+QVariant UnaryOperation::execute(const Context &context) const
 {
     auto right = this->right_->execute(context);
     switch (this->op_)
@@ -488,6 +775,16 @@ QVariant UnaryOperation::execute(const ContextMap &context) const
     }
 }
 
+bool UnaryOperation::executeBool(const Context &context) const
+{
+    if (this->op_ == NOT && this->right_->returnType() == ValueType::Bool)
+    {
+        return !this->right_->executeBool(context);
+    }
+
+    return this->execute(context).toBool();
+}
+
 QString UnaryOperation::debug() const
 {
     return QString("(%1 %2)").arg(tokenTypeToInfoString(this->op_),
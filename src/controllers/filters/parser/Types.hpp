@@ -1,14 +1,11 @@
 #pragma once
 
-#include "messages/Message.hpp"
+#include "controllers/filters/parser/Context.hpp"
 
 #include <QRegularExpression>
 
 namespace filterparser {
 
-using MessagePtr = std::shared_ptr<const chatterino::Message>;
-using ContextMap = QMap<QString, QVariant>;
-
 enum TokenType {
     // control
     CONTROL_START = 0,
@@ -67,11 +64,45 @@ class Expression
 public:
     virtual ~Expression() = default;
 
-    virtual QVariant execute(const ContextMap &) const
+    virtual QVariant execute(const Context &) const
     {
         return false;
     }
 
+    // Type execute() always returns, determined once after parsing
+    virtual ValueType returnType() const
+    {
+        return ValueType::Bool;
+    }
+
+    // Typed variants of execute() that skip the QVariant, these may only be
+    // called if returnType() is the matching type
+    virtual bool executeBool(const Context &context) const
+    {
+        return this->execute(context).toBool();
+    }
+
+    virtual int executeInt(const Context &context) const
+    {
+        return this->execute(context).toInt();
+    }
+
+    virtual QString executeString(const Context &context) const
+    {
+        return this->execute(context).toString();
+    }
+
+    virtual QStringList executeStringList(const Context &context) const
+    {
+        return this->execute(context).toStringList();
+    }
+
+    virtual QRegularExpression executeRegularExpression(
+        const Context &context) const
+    {
+        return this->execute(context).toRegularExpression();
+    }
+
     virtual QString debug() const
     {
         return "(false)";
@@ -91,13 +122,19 @@ public:
     ValueExpression(QVariant value, TokenType type);
     TokenType type();
 
-    QVariant execute(const ContextMap &context) const override;
+    QVariant execute(const Context &context) const override;
+    ValueType returnType() const override;
+    bool executeBool(const Context &context) const override;
+    int executeInt(const Context &context) const override;
+    QString executeString(const Context &context) const override;
+    QStringList executeStringList(const Context &context) const override;
     QString debug() const override;
     QString filterString() const override;
 
 private:
     QVariant value_;
     TokenType type_;
+    Identifier identifier_ = Identifier::Unknown;
 };
 
 class RegexExpression : public Expression
@@ -105,7 +142,10 @@ class RegexExpression : public Expression
 public:
     RegexExpression(QString regex, bool caseInsensitive);
 
-    QVariant execute(const ContextMap &context) const override;
+    QVariant execute(const Context &context) const override;
+    ValueType returnType() const override;
+    QRegularExpression executeRegularExpression(
+        const Context &context) const override;
     QString debug() const override;
     QString filterString() const override;
 
@@ -122,7 +162,8 @@ class ListExpression : public Expression
 public:
     ListExpression(ExpressionList list);
 
-    QVariant execute(const ContextMap &context) const override;
+    QVariant execute(const Context &context) const override;
+    ValueType returnType() const override;
     QString debug() const override;
     QString filterString() const override;
 
@@ -135,14 +176,21 @@ class BinaryOperation : public Expression
 public:
     BinaryOperation(TokenType op, ExpressionPtr left, ExpressionPtr right);
 
-    QVariant execute(const ContextMap &context) const override;
+    QVariant execute(const Context &context) const override;
+    ValueType returnType() const override;
+    bool executeBool(const Context &context) const override;
+    int executeInt(const Context &context) const override;
+    QString executeString(const Context &context) const override;
     QString debug() const override;
     QString filterString() const override;
 
 private:
+    ValueType findReturnType() const;
+
     TokenType op_;
     ExpressionPtr left_;
     ExpressionPtr right_;
+    ValueType returnType_;
 };
 
 class UnaryOperation : public Expression
@@ -150,7 +198,8 @@ class UnaryOperation : public Expression
 public:
     UnaryOperation(TokenType op, ExpressionPtr right);
 
-    QVariant execute(const ContextMap &context) const override;
+    QVariant execute(const Context &context) const override;
+    bool executeBool(const Context &context) const override;
     QString debug() const override;
     QString filterString() const override;
 
@@ -1,7 +1,10 @@
 #include "HighlightBadge.hpp"
 
+#include "messages/Message.hpp"
 #include "singletons/Resources.hpp"
 
+#include <algorithm>
+
 namespace chatterino {
 
 QColor HighlightBadge::FALLBACK_HIGHLIGHT_COLOR = QColor(127, 63, 73, 127);
@@ -34,13 +37,14 @@ HighlightBadge::HighlightBadge(const QString &badgeName,
     , soundUrl_(soundUrl)
     , color_(color)
 {
-    // check badgeName at initialization to reduce cost per isMatch call
-    this->hasVersions_ = badgeName.contains("/");
-    this->isMulti_ = badgeName.contains(",");
-    if (this->isMulti_)
+    // "name" matches every version of a badge, "name/version" only that
+    // one, several of them are separated by commas
+    for (const auto &id : badgeName.split(","))
     {
-        this->badges_ = badgeName.split(",");
+        auto parts = id.split("/");
+        this->ids_.push_back(badgeId(parts.size() == 2 ? id : parts.at(0)));
     }
+    std::sort(this->ids_.begin(), this->ids_.end());
 }
 
 const QString &HighlightBadge::badgeName() const
@@ -65,42 +69,18 @@ bool HighlightBadge::hasSound() const
 
 bool HighlightBadge::isMatch(const Badge &badge) const
 {
-    if (this->isMulti_)
-    {
-        for (const auto &id : this->badges_)
-        {
-            if (this->compare(id, badge))
-            {
-                return true;
-            }
-        }
-        return false;
-    }
-    else
-    {
-        return this->compare(this->badgeName_, badge);
-    }
+    return std::binary_search(this->ids_.begin(), this->ids_.end(),
+                              badge.nameId_) ||
+           std::binary_search(this->ids_.begin(), this->ids_.end(),
+                              badge.tokenId_);
 }
 
-bool HighlightBadge::compare(const QString &id, const Badge &badge) const
+bool HighlightBadge::isMatch(const BadgeSet &badges) const
 {
-    if (this->hasVersions_)
-    {
-        auto parts = id.split("/");
-        if (parts.size() == 2)
-        {
-            return parts.at(0).compare(badge.key_, Qt::CaseInsensitive) == 0 &&
-                   parts.at(1).compare(badge.value_, Qt::CaseInsensitive) == 0;
-        }
-        else
-        {
-            return parts.at(0).compare(badge.key_, Qt::CaseInsensitive) == 0;
-        }
-    }
-    else
-    {
-        return id.compare(badge.key_, Qt::CaseInsensitive) == 0;
-    }
+    return std::any_of(this->ids_.begin(), this->ids_.end(),
+                       [&](BadgeId id) {
+                           return badges.hasId(id);
+                       });
 }
 
 bool HighlightBadge::hasCustomSound() const
@@ -8,7 +8,12 @@
 #include <QUrl>
 #include <pajlada/serialize.hpp>
 
+#include <vector>
+
 namespace chatterino {
+
+struct BadgeSet;
+
 class HighlightBadge
 {
 public:
@@ -27,6 +32,8 @@ public:
     bool hasAlert() const;
     bool hasSound() const;
     bool isMatch(const Badge &badge) const;
+    /// Returns true if any badge of the set matches
+    bool isMatch(const BadgeSet &badges) const;
 
     /**
      * @brief Check if this highlight phrase has a custom sound set.
@@ -49,8 +56,6 @@ public:
     static QColor FALLBACK_HIGHLIGHT_COLOR;
 
 private:
-    bool compare(const QString &id, const Badge &badge) const;
-
     QString badgeName_;
     QString displayName_;
     bool hasAlert_;
@@ -58,9 +63,8 @@ private:
     QUrl soundUrl_;
     std::shared_ptr<QColor> color_;
 
-    bool isMulti_;
-    bool hasVersions_;
-    QStringList badges_;
+    // names and tokens of the badges that match, sorted
+    std::vector<BadgeId> ids_;
 };
 };  // namespace chatterino
 
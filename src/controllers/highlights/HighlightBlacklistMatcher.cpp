@@ -0,0 +1,66 @@
+#include "controllers/highlights/HighlightBlacklistMatcher.hpp"
+
+#include "singletons/Settings.hpp"
+
+#include <mutex>
+
+namespace chatterino {
+
+HighlightBlacklistMatcher::HighlightBlacklistMatcher(
+    const std::vector<HighlightBlacklistUser> &users)
+{
+    for (const auto &user : users)
+    {
+        if (user.isRegex())
+        {
+            if (user.isValidRegex())
+            {
+                this->regexes_.push_back(user);
+            }
+        }
+        else
+        {
+            this->names_.insert(user.getPattern().toLower());
+        }
+    }
+}
+
+bool HighlightBlacklistMatcher::isMatch(const QString &userName) const
+{
+    if (!this->names_.empty() &&
+        this->names_.find(userName.toLower()) != this->names_.end())
+    {
+        return true;
+    }
+
+    for (const auto &user : this->regexes_)
+    {
+        if (user.isMatch(userName))
+        {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+// SignalVector replaces its read only copy on every change
+std::shared_ptr<const HighlightBlacklistMatcher> getHighlightBlacklistMatcher()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const std::vector<HighlightBlacklistUser>> users;
+    static std::shared_ptr<const HighlightBlacklistMatcher> matcher;
+
+    auto current = getCSettings().blacklistedUsers.readOnly();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!matcher || current != users)
+    {
+        matcher = std::make_shared<const HighlightBlacklistMatcher>(*current);
+        users = current;
+    }
+
+    return matcher;
+}
+
+}  // namespace chatterino
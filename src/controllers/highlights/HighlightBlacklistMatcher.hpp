@@ -0,0 +1,40 @@
+#pragma once
+
+#include "controllers/highlights/HighlightBlacklistUser.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+
+#include <memory>
+#include <unordered_set>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Checks a user name against a whole highlight blacklist at once.
+ *
+ * Plain entries are kept in a hash set of lowercase names, only the regex
+ * entries are matched one by one.
+ *
+ * A HighlightBlacklistMatcher is immutable after construction and can be
+ * used from any thread.
+ */
+class HighlightBlacklistMatcher
+{
+public:
+    explicit HighlightBlacklistMatcher(
+        const std::vector<HighlightBlacklistUser> &users);
+
+    /// Equivalent to HighlightBlacklistUser::isMatch of any of the users
+    bool isMatch(const QString &userName) const;
+
+private:
+    std::unordered_set<QString> names_;
+    std::vector<HighlightBlacklistUser> regexes_;
+};
+
+/// Matcher for the highlight blacklist, rebuilt whenever it changes
+std::shared_ptr<const HighlightBlacklistMatcher> getHighlightBlacklistMatcher();
+
+}  // namespace chatterino
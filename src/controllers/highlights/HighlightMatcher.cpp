@@ -0,0 +1,179 @@
+#include "controllers/highlights/HighlightMatcher.hpp"
+
+namespace chatterino {
+
+namespace {
+
+    uint codepointBefore(const QString &subject, int position)
+    {
+        auto c = subject[position - 1];
+        if (c.isLowSurrogate() && position >= 2 &&
+            subject[position - 2].isHighSurrogate())
+        {
+            return QChar::surrogateToUcs4(subject[position - 2], c);
+        }
+        return c.unicode();
+    }
+
+    uint codepointAt(const QString &subject, int position)
+    {
+        auto c = subject[position];
+        if (c.isHighSurrogate() && position + 1 < subject.size() &&
+            subject[position + 1].isLowSurrogate())
+        {
+            return QChar::surrogateToUcs4(c, subject[position + 1]);
+        }
+        return c.unicode();
+    }
+
+    bool isWordCharacter(uint codepoint)
+    {
+        return codepoint == '_' || QChar::isLetterOrNumber(codepoint);
+    }
+
+    bool isWordBoundary(const QString &subject, int position)
+    {
+        return isWordCharacter(codepointBefore(subject, position)) !=
+               isWordCharacter(codepointAt(subject, position));
+    }
+
+    // Plain phrases are wrapped in (\b|\s|^) and (\b|\s|$), see HighlightPhrase
+    bool matchesStartBoundary(const QString &subject, int start)
+    {
+        return start == 0 || QChar::isSpace(codepointBefore(subject, start)) ||
+               isWordBoundary(subject, start);
+    }
+
+    bool matchesEndBoundary(const QString &subject, int end)
+    {
+        return end == subject.size() ||
+               QChar::isSpace(codepointAt(subject, end)) ||
+               isWordBoundary(subject, end);
+    }
+
+}  // namespace
+
+HighlightMatcher::HighlightMatcher(std::vector<HighlightPhrase> phrases)
+    : phrases_(std::move(phrases))
+{
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        const auto &phrase = this->phrases_[i];
+
+        if (!phrase.isValid())
+        {
+            continue;
+        }
+
+        const auto &pattern = phrase.getPattern();
+
+        if (!phrase.isRegex())
+        {
+            if (phrase.isCaseSensitive())
+            {
+                this->caseSensitive_.add(pattern, i);
+                continue;
+            }
+
+            // positions in the folded subject have to line up with the
+            // original subject to check the boundaries
+            auto folded = pattern.toCaseFolded();
+            if (folded.size() == pattern.size())
+            {
+                this->caseInsensitive_.add(folded, i);
+                continue;
+            }
+        }
+        else if (CombinedRegex::canCombine(pattern))
+        {
+            this->combinedRegex_.add(pattern, phrase.isCaseSensitive());
+            this->combinedPhrases_.push_back(i);
+            continue;
+        }
+
+        this->separatePhrases_.push_back(i);
+    }
+
+    this->caseSensitive_.build();
+    this->caseInsensitive_.build();
+
+    if (!this->combinedRegex_.build())
+    {
+        this->separatePhrases_.insert(this->separatePhrases_.end(),
+                                      this->combinedPhrases_.begin(),
+                                      this->combinedPhrases_.end());
+        this->combinedPhrases_.clear();
+    }
+}
+
+std::vector<const HighlightPhrase *> HighlightMatcher::match(
+    const QString &subject) const
+{
+    std::vector<bool> matched(this->phrases_.size(), false);
+
+    auto onMatch = [&](size_t phraseIndex, int start, int end) {
+        if (!matched[phraseIndex] && matchesStartBoundary(subject, start) &&
+            matchesEndBoundary(subject, end))
+        {
+            matched[phraseIndex] = true;
+        }
+    };
+
+    if (!this->caseSensitive_.empty())
+    {
+        this->caseSensitive_.search(subject, onMatch);
+    }
+
+    if (!this->caseInsensitive_.empty())
+    {
+        auto folded = subject.toCaseFolded();
+        if (folded.size() == subject.size())
+        {
+            this->caseInsensitive_.search(folded, onMatch);
+        }
+        else
+        {
+            for (size_t i = 0; i < this->phrases_.size(); i++)
+            {
+                const auto &phrase = this->phrases_[i];
+                if (!phrase.isRegex() && !phrase.isCaseSensitive() &&
+                    phrase.isMatch(subject))
+                {
+                    matched[i] = true;
+                }
+            }
+        }
+    }
+
+    if (!this->combinedPhrases_.empty() &&
+        this->combinedRegex_.hasMatch(subject))
+    {
+        for (auto i : this->combinedPhrases_)
+        {
+            matched[i] = this->phrases_[i].isMatch(subject);
+        }
+    }
+
+    for (auto i : this->separatePhrases_)
+    {
+        matched[i] = matched[i] || this->phrases_[i].isMatch(subject);
+    }
+
+    std::vector<const HighlightPhrase *> result;
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        if (matched[i])
+        {
+            result.push_back(&this->phrases_[i]);
+        }
+    }
+
+    return result;
+}
+
+const std::vector<HighlightPhrase> &HighlightMatcher::phrases() const
+{
+    return this->phrases_;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "controllers/highlights/HighlightPhrase.hpp"
+#include "util/AhoCorasick.hpp"
+#include "util/CombinedRegex.hpp"
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Matches a subject against a whole list of HighlightPhrases at once.
+ *
+ * Plain phrases are compiled into two Aho-Corasick automatons (one for case
+ * sensitive and one for case insensitive phrases), which find all of them in
+ * a single pass over the subject. Regex phrases are merged into one combined
+ * alternation that rules out a match before any of them is run on its own.
+ *
+ * A HighlightMatcher is immutable after construction and can be used from
+ * any thread.
+ */
+class HighlightMatcher
+{
+public:
+    explicit HighlightMatcher(std::vector<HighlightPhrase> phrases);
+
+    /**
+     * @brief Find all phrases that match the subject.
+     *
+     * Equivalent to calling HighlightPhrase::isMatch for every phrase.
+     *
+     * @return the matching phrases in the order they were given in
+     */
+    std::vector<const HighlightPhrase *> match(const QString &subject) const;
+
+    const std::vector<HighlightPhrase> &phrases() const;
+
+private:
+    std::vector<HighlightPhrase> phrases_;
+
+    AhoCorasick caseSensitive_;
+    AhoCorasick caseInsensitive_;
+
+    // regex phrases that are only checked if combinedRegex_ matches
+    std::vector<size_t> combinedPhrases_;
+    CombinedRegex combinedRegex_;
+
+    // phrases that always have to be checked on their own
+    std::vector<size_t> separatePhrases_;
+};
+
+}  // namespace chatterino
@@ -367,7 +367,8 @@ void HighlightModel::customRowSetData(const std::vector<QStandardItem *> &row,
         break;
     }
 
-    getApp()->windows->forceLayoutChannelViews();
+    // only colors of the highlights changed
+    getApp()->windows->invalidateBuffers();
 }
 
 }  // namespace chatterino
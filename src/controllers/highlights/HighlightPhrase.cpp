@@ -1,5 +1,7 @@
 #include "controllers/highlights/HighlightPhrase.hpp"
 
+#include "util/CaseInsensitive.hpp"
+
 namespace chatterino {
 
 namespace {
@@ -107,7 +109,28 @@ bool HighlightPhrase::isValid() const
 
 bool HighlightPhrase::isMatch(const QString &subject) const
 {
-    return this->isValid() && this->regex_.match(subject).hasMatch();
+    if (!this->isValid())
+    {
+        return false;
+    }
+
+    // A phrase can only match messages that contain it, most messages are
+    // ruled out without running the regex. Qt's and PCRE's case folding
+    // differ in a few corners, so only ASCII messages are ruled out when
+    // ignoring the case.
+    if (!this->isRegex_)
+    {
+        bool mayMatch = this->isCaseSensitive_
+                            ? subject.contains(this->pattern_)
+                            : !isAscii(subject) ||
+                                  containsIgnoreCase(subject, this->pattern_);
+        if (!mayMatch)
+        {
+            return false;
+        }
+    }
+
+    return this->regex_.match(subject).hasMatch();
 }
 
 bool HighlightPhrase::isCaseSensitive() const
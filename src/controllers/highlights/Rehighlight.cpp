@@ -0,0 +1,150 @@
+#include "controllers/highlights/Rehighlight.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "messages/Message.hpp"
+#include "messages/SharedMessageBuilder.hpp"
+#include "providers/twitch/TwitchAccount.hpp"
+#include "util/PostToThread.hpp"
+
+#include <QtConcurrent>
+
+#include <atomic>
+
+namespace chatterino {
+
+namespace {
+
+    // incremented for every call, results of older calls are dropped
+    std::atomic<uint64_t> generation{0};
+
+    // only messages of chatters went through the highlight rules when they
+    // were built
+    bool wasHighlightChecked(const Message &message)
+    {
+        return !message.loginName.isEmpty() &&
+               !message.messageText.isEmpty() &&
+               message.flags.hasNone({MessageFlag::System, MessageFlag::Timeout,
+                                      MessageFlag::Untimeout,
+                                      MessageFlag::AutoMod,
+                                      MessageFlag::Debug});
+    }
+
+    // returns true if anything about the message changed
+    bool applyHighlight(const Message &message,
+                        const HighlightResult &highlight)
+    {
+        bool changed = false;
+
+        auto setFlag = [&](MessageFlag flag, bool value) {
+            if (message.flags.has(flag) != value)
+            {
+                // PAJLADA: Shitty solution described in Message.hpp
+                message.flags.set(flag, value);
+                changed = true;
+            }
+        };
+        setFlag(MessageFlag::Highlighted, highlight.highlighted);
+        setFlag(MessageFlag::ShowInMentions, highlight.showInMentions);
+
+        // inline whispers keep the whisper color they were built with
+        if (!message.flags.has(MessageFlag::HighlightedWhisper) &&
+            message.highlightColor != highlight.color)
+        {
+            if (!message.highlightColor || !highlight.color ||
+                *message.highlightColor != *highlight.color)
+            {
+                changed = true;
+            }
+            message.highlightColor = highlight.color;
+        }
+
+        return changed;
+    }
+
+    void rehighlightChannel(const std::weak_ptr<Channel> &weak,
+                            const LimitedQueueSnapshot<MessagePtr> &snapshot,
+                            uint64_t current)
+    {
+        auto currentUsername =
+            getApp()->accounts->twitch.getCurrent()->getUserName();
+
+        std::vector<MessagePtr> messages;
+        std::vector<HighlightResult> highlights;
+        for (const auto &message : snapshot)
+        {
+            if (generation != current)
+            {
+                return;
+            }
+
+            if (!wasHighlightChecked(*message))
+            {
+                continue;
+            }
+
+            bool isReceivedWhisper =
+                message->flags.has(MessageFlag::Whisper) &&
+                message->loginName.compare(currentUsername,
+                                           Qt::CaseInsensitive) != 0;
+
+            messages.push_back(message);
+            highlights.push_back(SharedMessageBuilder::checkHighlights(
+                message->loginName, message->messageText, *message->badgeSet,
+                message->flags.has(MessageFlag::Subscription),
+                isReceivedWhisper));
+        }
+
+        if (messages.empty())
+        {
+            return;
+        }
+
+        postToThread(
+            [weak, current, messages = std::move(messages),
+             highlights = std::move(highlights)] {
+                auto channel = weak.lock();
+                if (!channel || generation != current)
+                {
+                    return;
+                }
+
+                // messages that left the channel are skipped, the rest are
+                // visited in the same order
+                size_t i = 0;
+                channel->updateMessages(messages, [&](const Message &message) {
+                    while (messages[i].get() != &message)
+                    {
+                        i++;
+                    }
+                    return applyHighlight(message, highlights[i]);
+                });
+            },
+            TaskPriority::Low);
+    }
+
+}  // namespace
+
+void rehighlightMessages(const std::vector<ChannelPtr> &channels)
+{
+    assertInGuiThread();
+
+    auto current = ++generation;
+    for (const auto &channel : channels)
+    {
+        auto snapshot = channel->getMessageSnapshot();
+        if (snapshot.size() == 0)
+        {
+            continue;
+        }
+
+        QtConcurrent::run(
+            [weak = std::weak_ptr<Channel>(channel), snapshot, current] {
+                rehighlightChannel(weak, snapshot, current);
+            });
+    }
+}
+
+}  // namespace chatterino
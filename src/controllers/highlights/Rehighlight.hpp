@@ -0,0 +1,24 @@
+#pragma once
+
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+
+class Channel;
+using ChannelPtr = std::shared_ptr<Channel>;
+
+/**
+ * @brief Checks the highlight rules again for the messages that are already
+ *        in the channels.
+ *
+ * Every channel is checked on its own on the thread pool, so channels are
+ * handled in parallel and the gui thread only applies the results. Messages
+ * whose highlight flags or color changed are updated in place, with one
+ * messagesChanged per channel. Alerts and sounds aren't triggered again and
+ * the mentions channel isn't changed. A call makes the results of earlier
+ * calls that are still running obsolete. Gui thread only.
+ */
+void rehighlightMessages(const std::vector<ChannelPtr> &channels);
+
+}  // namespace chatterino
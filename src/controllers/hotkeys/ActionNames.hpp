@@ -105,6 +105,8 @@ inline const std::map<HotkeyCategory, ActionDefinitionMap> actionNames{
           }},
          {"showSearch", ActionDefinition{"Search"}},
          {"startWatching", ActionDefinition{"Start watching"}},
+         {"togglePerformanceOverlay",
+          ActionDefinition{"Toggle performance overlay"}},
          {"debug", ActionDefinition{"Show debug popup"}},
      }},
     {HotkeyCategory::SplitInput,
@@ -1,7 +1,6 @@
 #include "controllers/hotkeys/Hotkey.hpp"
 
 #include "Application.hpp"
-#include "common/QLogging.hpp"
 #include "controllers/hotkeys/ActionNames.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
 
@@ -61,25 +60,6 @@ QString Hotkey::getCategory() const
     return getApp()->hotkeys->categoryDisplayName(this->category_);
 }
 
-Qt::ShortcutContext Hotkey::getContext() const
-{
-    switch (this->category_)
-    {
-        case HotkeyCategory::Window:
-            return Qt::WindowShortcut;
-        case HotkeyCategory::Split:
-            return Qt::WidgetWithChildrenShortcut;
-        case HotkeyCategory::SplitInput:
-            return Qt::WidgetWithChildrenShortcut;
-        case HotkeyCategory::PopupWindow:
-            return Qt::WindowShortcut;
-    }
-    qCDebug(chatterinoHotkeys)
-        << "Using default shortcut context for" << this->getCategory()
-        << "and hopeing for the best.";
-    return Qt::WidgetShortcut;
-}
-
 QString Hotkey::toString() const
 {
     return this->keySequence().toString(QKeySequence::NativeText);
@@ -82,13 +82,6 @@ private:
     std::vector<QString> arguments_;
     QString name_;
 
-    /**
-     * @brief Returns the programmatic context of the hotkey to help Qt decide how to apply the hotkey
-     *
-     * The returned value is based off the hotkeys given category
-     */
-    Qt::ShortcutContext getContext() const;
-
     friend class HotkeyController;
 };
 
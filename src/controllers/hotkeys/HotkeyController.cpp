@@ -3,8 +3,13 @@
 #include "common/QLogging.hpp"
 #include "controllers/hotkeys/HotkeyModel.hpp"
 #include "singletons/Settings.hpp"
+#include "util/FunctionEventFilter.hpp"
 
-#include <QShortcut>
+#include <QApplication>
+#include <QKeyEvent>
+
+#include <algorithm>
+#include <array>
 
 namespace chatterino {
 
@@ -26,6 +31,8 @@ HotkeyController::HotkeyController()
     this->signalHolder_.managedConnect(
         this->hotkeys_.delayedItemsChanged, [this]() {
             qCDebug(chatterinoHotkeys) << "Reloading hotkeys!";
+            this->keymapsDirty_ = true;
+            this->pressed_.clear();
             this->onItemsUpdated.invoke();
         });
 }
@@ -37,59 +44,228 @@ HotkeyModel *HotkeyController::createModel(QObject *parent)
     return model;
 }
 
-std::vector<QShortcut *> HotkeyController::shortcutsForCategory(
+std::unique_ptr<HotkeyActions> HotkeyController::shortcutsForCategory(
     HotkeyCategory category,
     std::map<QString, std::function<QString(std::vector<QString>)>> actionMap,
     QWidget *parent)
 {
-    std::vector<QShortcut *> output;
+    if (chatterinoHotkeys().isDebugEnabled())
+    {
+        for (const auto &hotkey : this->hotkeys_)
+        {
+            if (hotkey->category() == category &&
+                actionMap.find(hotkey->action()) == actionMap.end())
+            {
+                qCDebug(chatterinoHotkeys)
+                    << qPrintable(parent->objectName())
+                    << "Unimplemeneted hotkey action:" << hotkey->action()
+                    << "in " << hotkey->getCategory();
+            }
+        }
+    }
+
+    if (this->eventFilter_ == nullptr)
+    {
+        this->eventFilter_ = new FunctionEventFilter(
+            qApp, [this](QObject *watched, QEvent *event) {
+                if (event->type() != QEvent::KeyPress ||
+                    !watched->isWidgetType())
+                {
+                    return false;
+                }
+
+                return this->handleKeyPress(static_cast<QWidget *>(watched),
+                                            static_cast<QKeyEvent *>(event));
+            });
+        qApp->installEventFilter(this->eventFilter_);
+    }
+
+    return std::unique_ptr<HotkeyActions>(
+        new HotkeyActions(*this, category, std::move(actionMap), parent));
+}
+
+int HotkeyController::normalizeKey(int key)
+{
+    if ((key & ~Qt::KeyboardModifierMask) == Qt::Key_Enter)
+    {
+        key = (key & Qt::KeyboardModifierMask) | Qt::Key_Return;
+    }
+
+    return key & ~Qt::KeypadModifier;
+}
+
+void HotkeyController::rebuildKeymaps()
+{
+    this->keymaps_.clear();
+
     for (const auto &hotkey : this->hotkeys_)
     {
-        if (hotkey->category() != category)
+        const auto &sequence = hotkey->keySequence();
+        if (sequence.isEmpty())
         {
             continue;
         }
-        auto target = actionMap.find(hotkey->action());
-        if (target == actionMap.end())
+
+        std::array<int, 4> keys{};
+        for (int i = 0; i < sequence.count() && i < 4; i++)
         {
-            qCDebug(chatterinoHotkeys)
-                << qPrintable(parent->objectName())
-                << "Unimplemeneted hotkey action:" << hotkey->action() << "in "
-                << hotkey->getCategory();
-            continue;
+            keys[i] = normalizeKey(sequence[uint(i)]);
         }
-        if (!target->second)
+
+        this->keymaps_[hotkey->category()][keys[0]].push_back(
+            {QKeySequence(keys[0], keys[1], keys[2], keys[3]), hotkey});
+    }
+
+    this->keymapsDirty_ = false;
+}
+
+bool HotkeyController::handleKeyPress(QWidget *receiver, QKeyEvent *event)
+{
+    switch (event->key())
+    {
+        case Qt::Key_unknown:
+        case Qt::Key_Shift:
+        case Qt::Key_Control:
+        case Qt::Key_Alt:
+        case Qt::Key_AltGr:
+        case Qt::Key_Meta:
+            return false;
+    }
+
+    // only the first delivery of the key press, not the ones propagated to
+    // the parents
+    auto *focus = QApplication::focusWidget();
+    if (focus == nullptr)
+    {
+        focus = QApplication::activeWindow();
+    }
+    if (receiver != focus || this->actions_.empty())
+    {
+        return false;
+    }
+
+    // widgets can still take keys for themselves like with QShortcuts, for
+    // example text edits take copy and paste
+    QKeyEvent override(QEvent::ShortcutOverride, event->key(),
+                       event->modifiers(), event->nativeScanCode(),
+                       event->nativeVirtualKey(), event->nativeModifiers(),
+                       event->text(), event->isAutoRepeat(),
+                       ushort(event->count()));
+    override.ignore();
+    QCoreApplication::sendEvent(focus, &override);
+    if (override.isAccepted())
+    {
+        this->pressed_.clear();
+        return false;
+    }
+
+    if (this->keymapsDirty_)
+    {
+        this->rebuildKeymaps();
+    }
+
+    int key = normalizeKey(event->key() | int(event->modifiers()));
+
+    this->pressed_.push_back(key);
+    auto found = this->findAction(focus);
+    if (found.match == QKeySequence::NoMatch && this->pressed_.size() > 1)
+    {
+        // the key might start another sequence
+        this->pressed_ = {key};
+        found = this->findAction(focus);
+    }
+
+    switch (found.match)
+    {
+        case QKeySequence::NoMatch:
+            this->pressed_.clear();
+            return false;
+
+        case QKeySequence::PartialMatch:
+            return true;
+
+        case QKeySequence::ExactMatch:
+            this->pressed_.clear();
+            break;
+    }
+
+    // the action might delete the widget, found holds everything it needs
+    QString output = found.function(found.hotkey->arguments());
+    if (!output.isEmpty())
+    {
+        showHotkeyError(found.hotkey, output);
+    }
+
+    return true;
+}
+
+HotkeyController::FoundAction HotkeyController::findAction(
+    QWidget *focus) const
+{
+    if (this->pressed_.size() > 4)
+    {
+        return {};
+    }
+
+    std::array<int, 4> keys{};
+    std::copy(this->pressed_.begin(), this->pressed_.end(), keys.begin());
+    QKeySequence typed(keys[0], keys[1], keys[2], keys[3]);
+
+    bool partial = false;
+    for (auto *widget = focus; widget != nullptr;
+         widget = widget->parentWidget())
+    {
+        auto range = this->actions_.equal_range(widget);
+        for (auto it = range.first; it != range.second; it++)
         {
-            // Widget has chosen to explicitly not handle this action
-            continue;
+            const auto *actions = it->second;
+
+            auto keymap = this->keymaps_.find(actions->category_);
+            if (keymap == this->keymaps_.end())
+            {
+                continue;
+            }
+            auto entries = keymap->second.find(keys[0]);
+            if (entries == keymap->second.end())
+            {
+                continue;
+            }
+
+            for (const auto &entry : entries->second)
+            {
+                auto match = entry.sequence.matches(typed);
+                if (match == QKeySequence::NoMatch)
+                {
+                    continue;
+                }
+
+                auto action = actions->actions_.find(entry.hotkey->action());
+                if (action == actions->actions_.end() || !action->second)
+                {
+                    // Widget has chosen to explicitly not handle this action
+                    continue;
+                }
+
+                if (match == QKeySequence::ExactMatch)
+                {
+                    return {match, action->second, entry.hotkey};
+                }
+                partial = true;
+            }
         }
-        auto createShortcutFromKeySeq = [&](QKeySequence qs) {
-            auto s = new QShortcut(qs, parent);
-            s->setContext(hotkey->getContext());
-            auto functionPointer = target->second;
-            QObject::connect(s, &QShortcut::activated, parent,
-                             [functionPointer, hotkey, this]() {
-                                 QString output =
-                                     functionPointer(hotkey->arguments());
-                                 if (!output.isEmpty())
-                                 {
-                                     this->showHotkeyError(hotkey, output);
-                                 }
-                             });
-            output.push_back(s);
-        };
-        auto qs = QKeySequence(hotkey->keySequence());
-
-        auto stringified = qs.toString(QKeySequence::NativeText);
-        if (stringified.contains("Return"))
+
+        // hotkeys of other windows don't apply
+        if (widget->isWindow())
         {
-            stringified.replace("Return", "Enter");
-            auto copy = QKeySequence(stringified, QKeySequence::NativeText);
-            createShortcutFromKeySeq(copy);
+            break;
         }
-        createShortcutFromKeySeq(qs);
     }
-    return output;
+
+    if (partial)
+    {
+        return {QKeySequence::PartialMatch, {}, {}};
+    }
+    return {};
 }
 
 void HotkeyController::save()
@@ -375,6 +551,10 @@ void HotkeyController::addDefaults(std::set<QString> &addedHotkeys)
         this->tryAddDefault(addedHotkeys, HotkeyCategory::Split,
                             QKeySequence("F10"), "debug",
                             std::vector<QString>(), "open debug popup");
+        this->tryAddDefault(addedHotkeys, HotkeyCategory::Split,
+                            QKeySequence("Ctrl+F10"),
+                            "togglePerformanceOverlay", std::vector<QString>(),
+                            "toggle performance overlay");
     }
 
     // split input
@@ -541,4 +721,29 @@ void HotkeyController::showHotkeyError(const std::shared_ptr<Hotkey> &hotkey,
     msgBox->exec();
 }
 
+HotkeyActions::HotkeyActions(HotkeyController &controller,
+                             HotkeyCategory category,
+                             HotkeyController::HotkeyMap actions,
+                             const QWidget *parent)
+    : controller_(controller)
+    , category_(category)
+    , actions_(std::move(actions))
+    , parent_(parent)
+{
+    this->controller_.actions_.emplace(this->parent_, this);
+}
+
+HotkeyActions::~HotkeyActions()
+{
+    auto range = this->controller_.actions_.equal_range(this->parent_);
+    for (auto it = range.first; it != range.second; it++)
+    {
+        if (it->second == this)
+        {
+            this->controller_.actions_.erase(it);
+            break;
+        }
+    }
+}
+
 }  // namespace chatterino
@@ -4,17 +4,25 @@
 #include "common/Singleton.hpp"
 #include "controllers/hotkeys/HotkeyCategory.hpp"
 
+#include <QKeySequence>
+#include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 #include <pajlada/signals/signal.hpp>
 #include <pajlada/signals/signalholder.hpp>
 
+#include <map>
+#include <memory>
 #include <set>
+#include <unordered_map>
+#include <vector>
 
-class QShortcut;
+class QKeyEvent;
 
 namespace chatterino {
 
 class Hotkey;
+class HotkeyActions;
+class FunctionEventFilter;
 
 class HotkeyModel;
 
@@ -27,9 +35,18 @@ public:
     HotkeyController();
     HotkeyModel *createModel(QObject *parent);
 
-    std::vector<QShortcut *> shortcutsForCategory(HotkeyCategory category,
-                                                  HotkeyMap actionMap,
-                                                  QWidget *parent);
+    /**
+     * @brief Makes the hotkeys of category run the actions while parent or
+     *        one of its children has focus
+     *
+     * The hotkeys of every category are kept in one keymap that's looked up
+     * for each key press, along the focused widget and its parents up to its
+     * window. Window and popup hotkeys should be added for the window itself.
+     *
+     * @returns a handle, the actions are removed when it's destroyed
+     **/
+    std::unique_ptr<HotkeyActions> shortcutsForCategory(
+        HotkeyCategory category, HotkeyMap actionMap, QWidget *parent);
 
     void save() override;
     std::shared_ptr<Hotkey> getHotkeyByName(QString name);
@@ -115,11 +132,42 @@ private:
     static void showHotkeyError(const std::shared_ptr<Hotkey> &hotkey,
                                 QString warning);
 
+    struct KeymapEntry {
+        // with the keys normalized by normalizeKey
+        QKeySequence sequence;
+        std::shared_ptr<Hotkey> hotkey;
+    };
+
+    struct FoundAction {
+        QKeySequence::SequenceMatch match = QKeySequence::NoMatch;
+        HotkeyFunction function;
+        std::shared_ptr<Hotkey> hotkey;
+    };
+
+    /// Treats Enter like Return and keys of the keypad like the others
+    static int normalizeKey(int key);
+
+    void rebuildKeymaps();
+    bool handleKeyPress(QWidget *receiver, QKeyEvent *event);
+    /// Finds the action for the keys in pressed_
+    FoundAction findAction(QWidget *focus) const;
+
     friend class KeyboardSettingsPage;
+    friend class HotkeyActions;
 
     SignalVector<std::shared_ptr<Hotkey>> hotkeys_;
     pajlada::Signals::SignalHolder signalHolder_;
 
+    // the hotkeys of each category by the first key of their sequence
+    std::map<HotkeyCategory, std::unordered_map<int, std::vector<KeymapEntry>>>
+        keymaps_;
+    bool keymapsDirty_ = true;
+    // the actions added by shortcutsForCategory by their parent
+    std::unordered_multimap<const QWidget *, const HotkeyActions *> actions_;
+    // keys of a sequence that is partially typed
+    std::vector<int> pressed_;
+    FunctionEventFilter *eventFilter_ = nullptr;
+
     const std::map<HotkeyCategory, HotkeyCategoryData> hotkeyCategories_ = {
         {HotkeyCategory::PopupWindow, {"popupWindow", "Popup Windows"}},
         {HotkeyCategory::Split, {"split", "Split"}},
@@ -128,4 +176,23 @@ private:
     };
 };
 
+/// Actions added by HotkeyController::shortcutsForCategory, they're removed
+/// when this is destroyed
+class HotkeyActions : boost::noncopyable
+{
+public:
+    ~HotkeyActions();
+
+private:
+    HotkeyActions(HotkeyController &controller, HotkeyCategory category,
+                  HotkeyController::HotkeyMap actions, const QWidget *parent);
+
+    HotkeyController &controller_;
+    const HotkeyCategory category_;
+    const HotkeyController::HotkeyMap actions_;
+    const QWidget *parent_;
+
+    friend class HotkeyController;
+};
+
 }  // namespace chatterino
@@ -1,26 +1,43 @@
 #include "controllers/ignores/IgnoreController.hpp"
 
 #include "common/QLogging.hpp"
+#include "controllers/ignores/IgnoreMatcher.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
 #include "singletons/Settings.hpp"
 
+#include <mutex>
+
 namespace chatterino {
 
+// SignalVector replaces its read only copy on every change
+std::shared_ptr<const IgnoreMatcher> getIgnoreMatcher()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const std::vector<IgnorePhrase>> phrases;
+    static std::shared_ptr<const IgnoreMatcher> matcher;
+
+    auto current = getCSettings().ignoredMessages.readOnly();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!matcher || current != phrases)
+    {
+        matcher = std::make_shared<const IgnoreMatcher>(*current);
+        phrases = current;
+    }
+
+    return matcher;
+}
+
 bool isIgnoredMessage(IgnoredMessageParameters &&params)
 {
     if (!params.message.isEmpty())
     {
-        // TODO(pajlada): Do we need to check if the phrase is valid first?
-        auto phrases = getCSettings().ignoredMessages.readOnly();
-        for (const auto &phrase : *phrases)
+        if (const auto *phrase = getIgnoreMatcher()->findBlock(params.message))
         {
-            if (phrase.isBlock() && phrase.isMatch(params.message))
-            {
-                qCDebug(chatterinoMessage)
-                    << "Blocking message because it contains ignored phrase"
-                    << phrase.getPattern();
-                return true;
-            }
+            qCDebug(chatterinoMessage)
+                << "Blocking message because it contains ignored phrase"
+                << phrase->getPattern();
+            return true;
         }
     }
 
@@ -29,10 +46,7 @@ bool isIgnoredMessage(IgnoredMessageParameters &&params)
     {
         auto sourceUserID = params.twitchUserID;
 
-        auto blocks =
-            getApp()->accounts->twitch.getCurrent()->accessBlockedUserIds();
-
-        if (auto it = blocks->find(sourceUserID); it != blocks->end())
+        if (getApp()->accounts->twitch.getCurrent()->isBlocked(sourceUserID))
         {
             switch (static_cast<ShowIgnoredUsersMessages>(
                 getSettings()->showBlockedUsersMessages.getValue()))
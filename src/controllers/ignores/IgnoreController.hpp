@@ -2,8 +2,12 @@
 
 #include <QString>
 
+#include <memory>
+
 namespace chatterino {
 
+class IgnoreMatcher;
+
 enum class ShowIgnoredUsersMessages { Never, IfModerator, IfBroadcaster };
 
 struct IgnoredMessageParameters {
@@ -16,4 +20,7 @@ struct IgnoredMessageParameters {
 
 bool isIgnoredMessage(IgnoredMessageParameters &&params);
 
+/// Matcher for the ignored phrases, rebuilt whenever they change
+std::shared_ptr<const IgnoreMatcher> getIgnoreMatcher();
+
 }  // namespace chatterino
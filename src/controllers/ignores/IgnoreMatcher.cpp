@@ -0,0 +1,139 @@
+#include "controllers/ignores/IgnoreMatcher.hpp"
+
+namespace chatterino {
+
+IgnoreMatcher::IgnoreMatcher(std::vector<IgnorePhrase> phrases)
+    : phrases_(std::move(phrases))
+{
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        const auto &phrase = this->phrases_[i];
+        const auto &pattern = phrase.getPattern();
+
+        // these never match
+        if (pattern.isEmpty() || (phrase.isRegex() && !phrase.isRegexValid()))
+        {
+            continue;
+        }
+
+        if (!phrase.isRegex())
+        {
+            if (phrase.isCaseSensitive())
+            {
+                this->caseSensitive_.add(pattern, i);
+                continue;
+            }
+
+            auto folded = pattern.toCaseFolded();
+            if (folded.size() == pattern.size())
+            {
+                this->caseInsensitive_.add(folded, i);
+                this->caseInsensitivePhrases_.push_back(i);
+                continue;
+            }
+        }
+        else if (CombinedRegex::canCombine(pattern))
+        {
+            this->combinedRegex_.add(pattern, phrase.isCaseSensitive());
+            this->combinedPhrases_.push_back(i);
+            continue;
+        }
+
+        this->separatePhrases_.push_back(i);
+    }
+
+    this->caseSensitive_.build();
+    this->caseInsensitive_.build();
+
+    if (!this->combinedRegex_.build())
+    {
+        this->separatePhrases_.insert(this->separatePhrases_.end(),
+                                      this->combinedPhrases_.begin(),
+                                      this->combinedPhrases_.end());
+        this->combinedPhrases_.clear();
+    }
+}
+
+std::vector<bool> IgnoreMatcher::candidates(const QString &subject) const
+{
+    std::vector<bool> result(this->phrases_.size(), false);
+
+    auto onMatch = [&](size_t phraseIndex, int, int) {
+        result[phraseIndex] = true;
+    };
+
+    if (!this->caseSensitive_.empty())
+    {
+        this->caseSensitive_.search(subject, onMatch);
+    }
+
+    if (!this->caseInsensitive_.empty())
+    {
+        auto folded = subject.toCaseFolded();
+        if (folded.size() == subject.size())
+        {
+            this->caseInsensitive_.search(folded, onMatch);
+        }
+        else
+        {
+            for (auto i : this->caseInsensitivePhrases_)
+            {
+                result[i] = true;
+            }
+        }
+    }
+
+    if (!this->combinedPhrases_.empty() &&
+        this->combinedRegex_.hasMatch(subject))
+    {
+        for (auto i : this->combinedPhrases_)
+        {
+            result[i] = true;
+        }
+    }
+
+    for (auto i : this->separatePhrases_)
+    {
+        result[i] = true;
+    }
+
+    return result;
+}
+
+const IgnorePhrase *IgnoreMatcher::findBlock(const QString &subject) const
+{
+    auto candidates = this->candidates(subject);
+
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        const auto &phrase = this->phrases_[i];
+        if (candidates[i] && phrase.isBlock() && phrase.isMatch(subject))
+        {
+            return &phrase;
+        }
+    }
+
+    return nullptr;
+}
+
+size_t IgnoreMatcher::firstReplaceCandidate(const QString &subject) const
+{
+    auto candidates = this->candidates(subject);
+
+    for (size_t i = 0; i < this->phrases_.size(); i++)
+    {
+        if (candidates[i] && !this->phrases_[i].isBlock())
+        {
+            return i;
+        }
+    }
+
+    return this->phrases_.size();
+}
+
+const std::vector<IgnorePhrase> &IgnoreMatcher::phrases() const
+{
+    return this->phrases_;
+}
+
+}  // namespace chatterino
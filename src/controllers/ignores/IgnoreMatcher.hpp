@@ -0,0 +1,68 @@
+#pragma once
+
+#include "controllers/ignores/IgnorePhrase.hpp"
+#include "util/AhoCorasick.hpp"
+#include "util/CombinedRegex.hpp"
+
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Screens a message against a whole list of IgnorePhrases at once.
+ *
+ * Plain phrases are found in a single pass with Aho-Corasick automatons,
+ * regex phrases are merged into one combined alternation. Only the phrases
+ * that pass this screening have to be matched on their own.
+ *
+ * An IgnoreMatcher is immutable after construction and can be used from any
+ * thread.
+ */
+class IgnoreMatcher
+{
+public:
+    explicit IgnoreMatcher(std::vector<IgnorePhrase> phrases);
+
+    /**
+     * @brief Find the first blocking phrase that matches the subject.
+     *
+     * Equivalent to checking IgnorePhrase::isMatch for every blocking phrase.
+     *
+     * @return the phrase or nullptr if no blocking phrase matches
+     */
+    const IgnorePhrase *findBlock(const QString &subject) const;
+
+    /**
+     * @brief Index of the first replacing phrase that could match the
+     *        subject.
+     *
+     * None of the replacing phrases before it matches the subject.
+     *
+     * @return an index into phrases(), phrases().size() if none can match
+     */
+    size_t firstReplaceCandidate(const QString &subject) const;
+
+    const std::vector<IgnorePhrase> &phrases() const;
+
+private:
+    /// Phrases that could match the subject, false ones can't match
+    std::vector<bool> candidates(const QString &subject) const;
+
+    std::vector<IgnorePhrase> phrases_;
+
+    AhoCorasick caseSensitive_;
+    AhoCorasick caseInsensitive_;
+    // phrases in caseInsensitive_, in case the folded subject can't be used
+    std::vector<size_t> caseInsensitivePhrases_;
+
+    // regex phrases that could only match if combinedRegex_ matches
+    std::vector<size_t> combinedPhrases_;
+    CombinedRegex combinedRegex_;
+
+    // phrases that can't be screened
+    std::vector<size_t> separatePhrases_;
+};
+
+}  // namespace chatterino
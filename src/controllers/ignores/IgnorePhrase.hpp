@@ -4,6 +4,7 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "singletons/Settings.hpp"
 
+#include "util/CaseInsensitive.hpp"
 #include "util/RapidJsonSerializeQString.hpp"
 #include "util/RapidjsonHelpers.hpp"
 
@@ -68,8 +69,10 @@ public:
         return !this->pattern_.isEmpty() &&
                (this->isRegex() ? (this->regex_.isValid() &&
                                    this->regex_.match(subject).hasMatch())
-                                : subject.contains(this->pattern_,
-                                                   this->caseSensitivity()));
+                                : this->isCaseSensitive_
+                                      ? subject.contains(this->pattern_)
+                                      : containsIgnoreCase(subject,
+                                                           this->pattern_));
     }
 
     const QRegularExpression &getRegex() const
@@ -0,0 +1,98 @@
+#include "controllers/nicknames/NicknameMatcher.hpp"
+
+#include "singletons/Settings.hpp"
+
+#include <algorithm>
+#include <mutex>
+
+namespace chatterino {
+
+NicknameMatcher::NicknameMatcher(std::vector<Nickname> nicknames)
+    : nicknames_(std::move(nicknames))
+{
+    for (size_t i = 0; i < this->nicknames_.size(); i++)
+    {
+        const auto &nickname = this->nicknames_[i];
+
+        if (nickname.isRegex())
+        {
+            this->regexes_.push_back(i);
+        }
+        else if (nickname.isCaseSensitive())
+        {
+            // only the first one with a name can ever match
+            this->caseSensitive_.emplace(nickname.name(), i);
+        }
+        else
+        {
+            this->caseInsensitive_.emplace(nickname.name().toCaseFolded(), i);
+        }
+    }
+}
+
+bool NicknameMatcher::replace(QString &userName) const
+{
+    auto first = this->nicknames_.size();
+
+    auto it = this->caseSensitive_.find(userName);
+    if (it != this->caseSensitive_.end())
+    {
+        first = it->second;
+    }
+
+    if (!this->caseInsensitive_.empty())
+    {
+        it = this->caseInsensitive_.find(userName.toCaseFolded());
+        if (it != this->caseInsensitive_.end())
+        {
+            first = std::min(first, it->second);
+        }
+    }
+
+    // regex nicknames before the plain one take precedence
+    for (auto index : this->regexes_)
+    {
+        if (index > first)
+        {
+            break;
+        }
+
+        if (this->nicknames_[index].match(userName))
+        {
+            return true;
+        }
+    }
+
+    if (first < this->nicknames_.size())
+    {
+        return this->nicknames_[first].match(userName);
+    }
+
+    return false;
+}
+
+const std::vector<Nickname> &NicknameMatcher::nicknames() const
+{
+    return this->nicknames_;
+}
+
+// SignalVector replaces its read only copy on every change
+std::shared_ptr<const NicknameMatcher> getNicknameMatcher()
+{
+    static std::mutex mutex;
+    static std::shared_ptr<const std::vector<Nickname>> nicknames;
+    static std::shared_ptr<const NicknameMatcher> matcher;
+
+    auto current = getCSettings().nicknames.readOnly();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!matcher || current != nicknames)
+    {
+        matcher = std::make_shared<const NicknameMatcher>(*current);
+        nicknames = current;
+    }
+
+    return matcher;
+}
+
+}  // namespace chatterino
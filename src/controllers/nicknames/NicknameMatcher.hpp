@@ -0,0 +1,56 @@
+#pragma once
+
+#include "controllers/nicknames/Nickname.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Replaces user names with the first matching of a list of Nicknames.
+ *
+ * Plain nicknames are looked up in hash tables by the user name, exact for
+ * the case sensitive ones and case folded for the others. Only regex
+ * nicknames that come before the plain match in the list are tried on their
+ * own, so the lookup doesn't get slower with the number of plain nicknames.
+ *
+ * A NicknameMatcher is immutable after construction and can be used from
+ * any thread.
+ */
+class NicknameMatcher
+{
+public:
+    explicit NicknameMatcher(std::vector<Nickname> nicknames);
+
+    /**
+     * @brief Replace the user name with its nickname.
+     *
+     * Equivalent to calling Nickname::match for every nickname until one
+     * matches.
+     *
+     * @return true if a nickname matched
+     */
+    bool replace(QString &userName) const;
+
+    const std::vector<Nickname> &nicknames() const;
+
+private:
+    std::vector<Nickname> nicknames_;
+
+    // name to the index of the first plain nickname with it
+    std::unordered_map<QString, size_t> caseSensitive_;
+    std::unordered_map<QString, size_t> caseInsensitive_;
+
+    // indices of the regex nicknames
+    std::vector<size_t> regexes_;
+};
+
+/// Matcher for the nicknames, rebuilt whenever they change
+std::shared_ptr<const NicknameMatcher> getNicknameMatcher();
+
+}  // namespace chatterino
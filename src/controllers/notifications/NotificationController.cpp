@@ -5,9 +5,9 @@
 #include "common/Outcome.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/notifications/NotificationModel.hpp"
+#include "providers/twitch/LiveStatusService.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/TwitchMessageBuilder.hpp"
-#include "providers/twitch/api/Helix.hpp"
 #include "singletons/Toasts.hpp"
 #include "singletons/WindowManager.hpp"
 #include "widgets/Window.hpp"
@@ -20,20 +20,23 @@
 #include <QDir>
 #include <QMediaPlayer>
 #include <QUrl>
-#include <unordered_set>
 
 namespace chatterino {
 
 void NotificationController::initialize(Settings &settings, Paths &paths)
 {
     this->initialized_ = true;
-    for (const QString &channelName : this->twitchSetting_.getValue())
     {
-        this->channelMap[Platform::Twitch].append(channelName);
+        SignalVector<QString>::Batch batch(this->channelMap[Platform::Twitch]);
+        for (const QString &channelName : this->twitchSetting_.getValue())
+        {
+            this->channelMap[Platform::Twitch].append(channelName);
+        }
     }
 
     this->channelMap[Platform::Twitch].delayedItemsChanged.connect([this] {
         this->twitchSetting_.setValue(this->channelMap[Platform::Twitch].raw());
+        this->updateWatchedChannels();
     });
     /*
     for (const QString &channelName : this->mixerSetting_.getValue()) {
@@ -45,14 +48,7 @@ void NotificationController::initialize(Settings &settings, Paths &paths)
             this->channelMap[Platform::Mixer]);
     });*/
 
-    liveStatusTimer_ = new QTimer();
-
-    this->fetchFakeChannels();
-
-    QObject::connect(this->liveStatusTimer_, &QTimer::timeout, [=] {
-        this->fetchFakeChannels();
-    });
-    this->liveStatusTimer_->start(60 * 1000);
+    this->updateWatchedChannels();
 }
 
 void NotificationController::updateChannelNotification(
@@ -128,72 +124,42 @@ NotificationModel *NotificationController::createModel(QObject *parent,
     return model;
 }
 
-namespace {
-    // TODO: combine this with getEmoteSetBatches in TwitchAccount.cpp, maybe some templated thing
-    std::vector<QStringList> getChannelsInBatches(QStringList channels)
+void NotificationController::updateWatchedChannels()
+{
+    std::vector<QString> channels;
+    for (const auto &channel : this->channelMap[Platform::Twitch])
     {
-        constexpr int batchSize = 100;
-
-        int batchCount = (channels.size() / batchSize) + 1;
-
-        std::vector<QStringList> batches;
-        batches.reserve(batchCount);
+        channels.push_back(channel.toLower());
+    }
 
-        for (int i = 0; i < batchCount; i++)
+    auto &service = LiveStatusService::instance();
+    for (const auto &channel : this->watchedChannels_)
+    {
+        if (std::find(channels.begin(), channels.end(), channel) ==
+            channels.end())
         {
-            QStringList batch;
-
-            // I hate you, msvc
-            int last = (std::min)(batchSize, channels.size() - batchSize * i);
-            for (int j = 0; j < last; j++)
-            {
-                batch.push_back(channels.at(j + (batchSize * i)));
-            }
-            batches.emplace_back(batch);
+            service.unwatch(channel, this);
+            this->removeFakeChannel(channel);
         }
-
-        return batches;
     }
-}  // namespace
 
-void NotificationController::fetchFakeChannels()
-{
-    qCDebug(chatterinoNotification) << "fetching fake channels";
-    QStringList channels;
-    for (std::vector<int>::size_type i = 0;
-         i != channelMap[Platform::Twitch].raw().size(); i++)
-    {
-        auto chan = getApp()->twitch->getChannelOrEmpty(
-            channelMap[Platform::Twitch].raw()[i]);
-        if (chan->isEmpty())
+    // open channels are only polled once, the service shares the results
+    for (const auto &channel : channels)
+    {
+        if (std::find(this->watchedChannels_.begin(),
+                      this->watchedChannels_.end(),
+                      channel) == this->watchedChannels_.end())
         {
-            channels.push_back(channelMap[Platform::Twitch].raw()[i]);
+            service.watch(channel, this,
+                          [this, channel](bool live, const auto &) {
+                              this->checkStream(live, channel);
+                          });
         }
     }
-    for (const auto &batch : getChannelsInBatches(channels))
-    {
-        getHelix()->fetchStreams(
-            QStringList(), batch,
-            [batch, this](std::vector<HelixStream> streams) {
-                std::unordered_set<QString> liveStreams;
-                for (const auto &stream : streams)
-                {
-                    liveStreams.insert(stream.userLogin);
-                }
-
-                for (const auto &name : batch)
-                {
-                    auto it = liveStreams.find(name.toLower());
-                    this->checkStream(it != liveStreams.end(), name);
-                }
-            },
-            [batch]() {
-                // we done fucked up.
-                qCWarning(chatterinoNotification)
-                    << "Failed to fetch live status for " << batch;
-            });
-    }
+
+    this->watchedChannels_ = std::move(channels);
 }
+
 void NotificationController::checkStream(bool live, QString channelName)
 {
     qCDebug(chatterinoNotification)
@@ -217,6 +183,15 @@ void NotificationController::checkStream(bool live, QString channelName)
         return;
     }
 
+    // Indicate that we have pushed notifications for this stream
+    fakeTwitchChannels.push_back(channelName);
+
+    if (!getApp()->twitch->getChannelOrEmpty(channelName)->isEmpty())
+    {
+        // The open channel sends the notifications itself
+        return;
+    }
+
     if (Toasts::isEnabled())
     {
         getApp()->toasts->sendChannelNotification(channelName,
@@ -236,10 +211,7 @@ void NotificationController::checkStream(bool live, QString channelName)
     }
     MessageBuilder builder;
     TwitchMessageBuilder::liveMessage(channelName, &builder);
-    getApp()->twitch->liveChannel->addMessage(builder.release());
-
-    // Indicate that we have pushed notifications for this stream
-    fakeTwitchChannels.push_back(channelName);
+    getApp()->twitch->liveChannel->collect(builder.release());
 }
 
 void NotificationController::removeFakeChannel(const QString channelName)
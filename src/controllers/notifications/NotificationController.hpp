@@ -4,8 +4,6 @@
 #include "common/Singleton.hpp"
 #include "singletons/Settings.hpp"
 
-#include <QTimer>
-
 namespace chatterino {
 
 class Settings;
@@ -39,13 +37,15 @@ public:
 private:
     bool initialized_ = false;
 
-    void fetchFakeChannels();
+    // Watches the live status of the notified channels
+    void updateWatchedChannels();
     void removeFakeChannel(const QString channelName);
     void checkStream(bool live, QString channelName);
 
     // fakeTwitchChannels is a list of streams who are live that we have already sent out a notification for
     std::vector<QString> fakeTwitchChannels;
-    QTimer *liveStatusTimer_;
+    // lowercase logins of the channels the live status service reports
+    std::vector<QString> watchedChannels_;
 
     ChatterinoSetting<std::vector<QString>> twitchSetting_ = {
         "/notifications/twitch"};
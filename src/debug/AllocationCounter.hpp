@@ -0,0 +1,74 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+namespace chatterino {
+
+/**
+ * @brief Counts the allocations made on the current thread while it's alive.
+ *
+ * Nothing is counted unless the program links src/debug/AllocationHooks.cpp,
+ * which only the tests and benchmarks do. With glibc malloc itself is
+ * counted, so Qt's containers are included. Elsewhere only operator new is.
+ * Counters can be nested, each one counts everything since it was created.
+ */
+class AllocationCounter
+{
+public:
+    AllocationCounter()
+        : start_(threadTotals())
+    {
+    }
+
+    AllocationCounter(const AllocationCounter &) = delete;
+    AllocationCounter &operator=(const AllocationCounter &) = delete;
+
+    int64_t allocations() const
+    {
+        return threadTotals().allocations - this->start_.allocations;
+    }
+
+    int64_t bytes() const
+    {
+        return threadTotals().bytes - this->start_.bytes;
+    }
+
+    /// True if the hooks are linked and allocations are counted
+    static bool available()
+    {
+        return hooked_;
+    }
+
+    /// Called by the hooks for every allocation
+    static void record(size_t bytes) noexcept
+    {
+        auto &totals = threadTotals();
+        totals.allocations++;
+        totals.bytes += int64_t(bytes);
+    }
+
+    static void setHooked() noexcept
+    {
+        hooked_ = true;
+    }
+
+private:
+    struct Totals {
+        int64_t allocations;
+        int64_t bytes;
+    };
+
+    // trivial, so it doesn't allocate when a thread first uses it
+    static Totals &threadTotals() noexcept
+    {
+        thread_local Totals totals{0, 0};
+        return totals;
+    }
+
+    static inline bool hooked_ = false;
+
+    Totals start_;
+};
+
+}  // namespace chatterino
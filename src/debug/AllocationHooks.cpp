@@ -0,0 +1,141 @@
+// Makes AllocationCounter count allocations. This replaces the allocator
+// of the whole program, so it's only linked into the tests and benchmarks,
+// not into chatterino-lib.
+
+#include "debug/AllocationCounter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+namespace {
+
+const bool hooked = [] {
+    chatterino::AllocationCounter::setHooked();
+    return true;
+}();
+
+}  // namespace
+
+// the sanitizers bring their own malloc
+#if defined(__SANITIZE_ADDRESS__) || defined(__SANITIZE_THREAD__)
+#    define CHATTERINO_HOOK_MALLOC 0
+#elif defined(__has_feature)
+#    if __has_feature(address_sanitizer) || __has_feature(thread_sanitizer)
+#        define CHATTERINO_HOOK_MALLOC 0
+#    endif
+#endif
+#if !defined(CHATTERINO_HOOK_MALLOC) && defined(__GLIBC__)
+#    define CHATTERINO_HOOK_MALLOC 1
+#endif
+
+#if defined(CHATTERINO_HOOK_MALLOC) && CHATTERINO_HOOK_MALLOC
+
+// glibc allows replacing malloc, operator new and Qt's containers both end up
+// here. The aligned variants aren't counted.
+extern "C" {
+
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *pointer, size_t size);
+void __libc_free(void *pointer);
+
+void *malloc(size_t size)
+{
+    chatterino::AllocationCounter::record(size);
+    return __libc_malloc(size);
+}
+
+void *calloc(size_t count, size_t size)
+{
+    chatterino::AllocationCounter::record(count * size);
+    return __libc_calloc(count, size);
+}
+
+void *realloc(void *pointer, size_t size)
+{
+    chatterino::AllocationCounter::record(size);
+    return __libc_realloc(pointer, size);
+}
+
+void free(void *pointer)
+{
+    __libc_free(pointer);
+}
+
+}  // extern "C"
+
+#else
+
+// Only operator new is counted, the aligned variants aren't.
+
+namespace {
+
+void *allocate(std::size_t size) noexcept
+{
+    chatterino::AllocationCounter::record(size);
+    // new has to return a unique pointer even for 0 bytes
+    return std::malloc(size == 0 ? 1 : size);
+}
+
+void *allocateOrThrow(std::size_t size)
+{
+    if (auto *pointer = allocate(size))
+    {
+        return pointer;
+    }
+    throw std::bad_alloc();
+}
+
+}  // namespace
+
+void *operator new(std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new[](std::size_t size)
+{
+    return allocateOrThrow(size);
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept
+{
+    return allocate(size);
+}
+
+void operator delete(void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, std::size_t) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete(void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+void operator delete[](void *pointer, const std::nothrow_t &) noexcept
+{
+    std::free(pointer);
+}
+
+#endif
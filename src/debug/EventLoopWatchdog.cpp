@@ -0,0 +1,216 @@
+#include "debug/EventLoopWatchdog.hpp"
+
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QEvent>
+#include <QFile>
+#include <QMetaEnum>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr int HEARTBEAT_INTERVAL = 10;
+    // stalls.log is moved to stalls.log.1 once it's larger
+    constexpr qint64 MAX_LOG_SIZE = 1024 * 1024;
+
+    int64_t nowMs()
+    {
+        return std::chrono::duration_cast<std::chrono::milliseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    // paths from __builtin_FILE are absolute, the part in the repository is
+    // enough to find the code
+    QString shortenPath(const char *file)
+    {
+        auto path = QString::fromUtf8(file);
+        auto src = path.lastIndexOf("src/");
+        return src == -1 ? path : path.mid(src);
+    }
+
+}  // namespace
+
+class EventLoopWatchdog::EventObserver : public QObject
+{
+public:
+    explicit EventObserver(EventLoopWatchdog &watchdog)
+        : watchdog_(watchdog)
+    {
+    }
+
+    // only called for the objects of the gui thread
+    bool eventFilter(QObject *object, QEvent *event) override
+    {
+        this->watchdog_.eventReceiver_.store(object->metaObject(),
+                                             std::memory_order_relaxed);
+        this->watchdog_.eventType_.store(int(event->type()),
+                                         std::memory_order_relaxed);
+        return false;
+    }
+
+private:
+    EventLoopWatchdog &watchdog_;
+};
+
+EventLoopWatchdog &EventLoopWatchdog::instance()
+{
+    static EventLoopWatchdog instance;
+    return instance;
+}
+
+void EventLoopWatchdog::start(std::chrono::milliseconds deadline,
+                              QString logPath)
+{
+    assertInGuiThread();
+
+    if (isRunning())
+    {
+        return;
+    }
+
+    this->deadline_ = deadline;
+    this->logPath_ = std::move(logPath);
+
+    this->observer_ = std::make_unique<EventObserver>(*this);
+    QCoreApplication::instance()->installEventFilter(this->observer_.get());
+
+    this->lastHeartbeat_.store(nowMs());
+    this->heartbeatTimer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->heartbeatTimer_, &QTimer::timeout, [this] {
+        this->lastHeartbeat_.store(nowMs(), std::memory_order_relaxed);
+    });
+    this->heartbeatTimer_.start(HEARTBEAT_INTERVAL);
+
+    running_.store(true);
+    this->thread_ = std::thread([this] {
+        this->watch();
+    });
+}
+
+void EventLoopWatchdog::stop()
+{
+    assertInGuiThread();
+
+    if (!isRunning())
+    {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        running_.store(false);
+    }
+    this->stopped_.notify_all();
+    this->thread_.join();
+
+    this->heartbeatTimer_.stop();
+    QCoreApplication::instance()->removeEventFilter(this->observer_.get());
+    this->observer_.reset();
+}
+
+void EventLoopWatchdog::watch()
+{
+    std::unique_lock<std::mutex> lock(this->mutex_);
+
+    // heartbeat before the current stall, 0 while the thread is responsive
+    int64_t stallStart = 0;
+    QString task;
+
+    while (isRunning())
+    {
+        this->stopped_.wait_for(lock,
+                                std::chrono::milliseconds(HEARTBEAT_INTERVAL));
+
+        auto heartbeat = this->lastHeartbeat_.load(std::memory_order_relaxed);
+        auto blocked = nowMs() - heartbeat > this->deadline_.count();
+
+        if (stallStart == 0 && blocked)
+        {
+            // the gui thread is stuck, so this stays what it's doing
+            stallStart = heartbeat;
+            task = this->describeCurrentTask();
+        }
+        else if (stallStart != 0 && heartbeat != stallStart)
+        {
+            auto duration = heartbeat - stallStart - HEARTBEAT_INTERVAL;
+            this->log(
+                QString("blocked for %1 ms in %2").arg(duration).arg(task));
+            stallStart = 0;
+        }
+    }
+}
+
+QString EventLoopWatchdog::describeCurrentTask() const
+{
+    if (const auto *file = this->callbackFile_.load())
+    {
+        return QString("postToThread callback from %1:%2")
+            .arg(shortenPath(file))
+            .arg(this->callbackLine_.load());
+    }
+
+    const auto *receiver = this->eventReceiver_.load();
+    if (receiver == nullptr)
+    {
+        return "unknown";
+    }
+
+    auto type = this->eventType_.load();
+    const auto *typeName =
+        QMetaEnum::fromType<QEvent::Type>().valueToKey(type);
+
+    return QString("%1 handling %2")
+        .arg(receiver->className())
+        .arg(typeName != nullptr ? QString(typeName)
+                                 : QString("event %1").arg(type));
+}
+
+void EventLoopWatchdog::log(const QString &line)
+{
+    qCWarning(chatterinoApp) << "Gui thread" << line;
+
+    if (QFile(this->logPath_).size() > MAX_LOG_SIZE)
+    {
+        QFile::remove(this->logPath_ + ".1");
+        QFile::rename(this->logPath_, this->logPath_ + ".1");
+    }
+
+    QFile file(this->logPath_);
+    if (file.open(QIODevice::Append | QIODevice::Text))
+    {
+        file.write(QString("%1 %2\n")
+                       .arg(QDateTime::currentDateTime().toString(Qt::ISODate))
+                       .arg(line)
+                       .toUtf8());
+    }
+}
+
+EventLoopWatchdog::CallbackScope::CallbackScope(const char *file, int line)
+{
+    if (!EventLoopWatchdog::isRunning() || !isGuiThread())
+    {
+        return;
+    }
+
+    auto &watchdog = EventLoopWatchdog::instance();
+    this->active_ = true;
+    this->previousFile_ = watchdog.callbackFile_.exchange(file);
+    this->previousLine_ = watchdog.callbackLine_.exchange(line);
+}
+
+EventLoopWatchdog::CallbackScope::~CallbackScope()
+{
+    if (this->active_)
+    {
+        auto &watchdog = EventLoopWatchdog::instance();
+        watchdog.callbackFile_.store(this->previousFile_);
+        watchdog.callbackLine_.store(this->previousLine_);
+    }
+}
+
+}  // namespace chatterino
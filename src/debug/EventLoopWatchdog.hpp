@@ -0,0 +1,99 @@
+#pragma once
+
+#include <QObject>
+#include <QString>
+#include <QTimer>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#if defined(__GNUC__) || defined(__clang__) || \
+    (defined(_MSC_VER) && _MSC_VER >= 1926)
+#    define CHATTERINO_CALLER_FILE __builtin_FILE()
+#    define CHATTERINO_CALLER_LINE __builtin_LINE()
+#else
+#    define CHATTERINO_CALLER_FILE ""
+#    define CHATTERINO_CALLER_LINE 0
+#endif
+
+class QMetaObject;
+
+namespace chatterino {
+
+/**
+ * @brief Logs what the gui thread was doing whenever it didn't get back to
+ *        the event loop for longer than the deadline.
+ *
+ * A timer on the gui thread stamps a heartbeat, a thread of the watchdog
+ * notices when it stops. The stall is then blamed on the postToThread
+ * callback, identified by the place it was posted from, or otherwise the
+ * class of the object whose event was being handled. Queued signals and
+ * timers show up as events of their receivers.
+ *
+ * Stalls go to stalls.log in the misc directory, which is rotated once it
+ * gets large.
+ */
+class EventLoopWatchdog
+{
+public:
+    static EventLoopWatchdog &instance();
+
+    static bool isRunning()
+    {
+        return running_.load(std::memory_order_relaxed);
+    }
+
+    void start(std::chrono::milliseconds deadline, QString logPath);
+    void stop();
+
+    /// Marks a postToThread callback as running on the gui thread until
+    /// it's destroyed
+    class CallbackScope
+    {
+    public:
+        CallbackScope(const char *file, int line);
+        ~CallbackScope();
+
+        CallbackScope(const CallbackScope &) = delete;
+        CallbackScope &operator=(const CallbackScope &) = delete;
+
+    private:
+        bool active_ = false;
+        const char *previousFile_{};
+        int previousLine_{};
+    };
+
+private:
+    EventLoopWatchdog() = default;
+
+    class EventObserver;
+
+    void watch();
+    QString describeCurrentTask() const;
+    void log(const QString &line);
+
+    static inline std::atomic<bool> running_{false};
+
+    std::chrono::milliseconds deadline_{};
+    QString logPath_;
+
+    QTimer heartbeatTimer_;
+    std::unique_ptr<EventObserver> observer_;
+    std::atomic<int64_t> lastHeartbeat_{0};
+
+    // what the gui thread is doing, written by the gui thread only
+    std::atomic<const char *> callbackFile_{nullptr};
+    std::atomic<int> callbackLine_{0};
+    std::atomic<const QMetaObject *> eventReceiver_{nullptr};
+    std::atomic<int> eventType_{0};
+
+    std::thread thread_;
+    std::mutex mutex_;
+    std::condition_variable stopped_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,126 @@
+#include "debug/StartupProfiler.hpp"
+
+#include "common/QLogging.hpp"
+#include "common/Version.hpp"
+
+#include <QDateTime>
+#include <QSaveFile>
+#include <QStringList>
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    QString formatMs(qint64 nanoseconds)
+    {
+        return QString("%1 ms").arg(nanoseconds / 1000000.0, 8, 'f', 1);
+    }
+
+}  // namespace
+
+StartupProfiler &StartupProfiler::instance()
+{
+    static StartupProfiler instance;
+    return instance;
+}
+
+StartupProfiler::StartupProfiler()
+{
+    this->timer_.start();
+}
+
+void StartupProfiler::step(const QString &name)
+{
+    this->add(name, this->lastEnd_);
+}
+
+void StartupProfiler::add(QString name, qint64 start)
+{
+    if (this->finished_)
+    {
+        return;
+    }
+
+    auto end = this->timer_.nsecsElapsed();
+    this->entries_.push_back({std::move(name), this->depth_, start, end});
+    this->lastEnd_ = end;
+}
+
+bool StartupProfiler::isFinished() const
+{
+    return this->finished_;
+}
+
+void StartupProfiler::finish(const QString &path)
+{
+    if (this->finished_)
+    {
+        return;
+    }
+
+    auto report = this->report();
+    this->finished_ = true;
+
+    for (const auto &line : report.split('\n', QString::SkipEmptyParts))
+    {
+        qCDebug(chatterinoApp).noquote() << line;
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text))
+    {
+        qCWarning(chatterinoApp) << "Failed to write startup report to" << path;
+        return;
+    }
+    file.write(report.toUtf8());
+    file.commit();
+}
+
+QString StartupProfiler::report() const
+{
+    // phases are recorded when they end, nested ones before their parent
+    auto entries = this->entries_;
+    std::stable_sort(entries.begin(), entries.end(),
+                     [](const auto &a, const auto &b) {
+                         return a.start < b.start ||
+                                (a.start == b.start && a.depth < b.depth);
+                     });
+
+    QString report =
+        QString("Startup of Chatterino %1 at %2, %3 until the first paint\n\n")
+            .arg(Version::instance().fullVersion(),
+                 QDateTime::currentDateTime().toString(Qt::ISODate),
+                 formatMs(this->lastEnd_).trimmed());
+    report += QString("%1 %2  phase\n").arg("start", 11).arg("duration", 11);
+
+    for (const auto &entry : entries)
+    {
+        report += QString("%1 %2  %3%4\n")
+                      .arg(formatMs(entry.start),
+                           formatMs(entry.end - entry.start),
+                           QString(entry.depth * 2, ' '), entry.name);
+    }
+
+    return report;
+}
+
+StartupProfiler::Phase::Phase(QString name)
+    : name_(std::move(name))
+{
+    auto &profiler = StartupProfiler::instance();
+    this->start_ = profiler.timer_.nsecsElapsed();
+    // steps in the phase start with it
+    profiler.lastEnd_ = this->start_;
+    profiler.depth_++;
+}
+
+StartupProfiler::Phase::~Phase()
+{
+    auto &profiler = StartupProfiler::instance();
+    profiler.depth_--;
+    profiler.add(std::move(this->name_), this->start_);
+}
+
+}  // namespace chatterino
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Times the phases of the startup until the main window is painted
+ *        for the first time and writes them to startup.txt.
+ *
+ * The clock starts when main first uses the profiler, so the time it takes
+ * to load the executable and its libraries isn't included. Phases can be
+ * nested, everything that's recorded after the report was written is
+ * ignored. Only used from the gui thread.
+ */
+class StartupProfiler
+{
+public:
+    static StartupProfiler &instance();
+
+    /// Records a phase from the end of the previous one until now, for code
+    /// that can't be wrapped in a Phase
+    void step(const QString &name);
+
+    /// Writes the report to path and logs it
+    void finish(const QString &path);
+
+    bool isFinished() const;
+
+    /// Records the time until it's destroyed
+    class Phase
+    {
+    public:
+        explicit Phase(QString name);
+        ~Phase();
+
+        Phase(const Phase &) = delete;
+        Phase &operator=(const Phase &) = delete;
+
+    private:
+        QString name_;
+        qint64 start_;
+    };
+
+private:
+    StartupProfiler();
+
+    struct Entry {
+        QString name;
+        int depth;
+        // nanoseconds since the start
+        qint64 start;
+        qint64 end;
+    };
+
+    void add(QString name, qint64 start);
+    QString report() const;
+
+    QElapsedTimer timer_;
+    std::vector<Entry> entries_;
+    // where the next step starts
+    qint64 lastEnd_ = 0;
+    int depth_ = 0;
+    bool finished_ = false;
+};
+
+}  // namespace chatterino
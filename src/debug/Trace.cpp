@@ -0,0 +1,168 @@
+#include "debug/Trace.hpp"
+
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+
+#include <QCoreApplication>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QSaveFile>
+#include <QThread>
+
+namespace chatterino {
+
+struct Tracer::Buffer {
+    struct Event {
+        const char *name;
+        Clock::time_point start;
+        Clock::time_point end;
+    };
+
+    explicit Buffer(int _threadId, QString _threadName)
+        : threadId(_threadId)
+        , threadName(std::move(_threadName))
+        , events(new Event[BUFFER_SIZE])
+    {
+    }
+
+    const int threadId;
+    const QString threadName;
+
+    // Only the owning thread writes, it publishes an event by bumping size
+    // after writing it. Events are never overwritten, so readers can look at
+    // everything below size without a lock.
+    std::unique_ptr<Event[]> events;
+    std::atomic<size_t> size{0};
+    std::atomic<size_t> dropped{0};
+};
+
+namespace {
+
+    QString currentThreadName(int threadId)
+    {
+        if (QCoreApplication::instance() != nullptr && isGuiThread())
+        {
+            return "gui";
+        }
+
+        auto name = QThread::currentThread()->objectName();
+        if (!name.isEmpty())
+        {
+            return name;
+        }
+
+        return QString("thread %1").arg(threadId);
+    }
+
+}  // namespace
+
+thread_local std::shared_ptr<Tracer::Buffer> Tracer::threadBuffer_;
+
+Tracer &Tracer::instance()
+{
+    static Tracer instance;
+    return instance;
+}
+
+void Tracer::enable()
+{
+    this->start_ = Clock::now();
+    enabled_.store(true);
+}
+
+void Tracer::record(const char *name, Clock::time_point start,
+                    Clock::time_point end)
+{
+    if (!isEnabled())
+    {
+        return;
+    }
+
+    auto *buffer = threadBuffer_.get();
+    if (buffer == nullptr)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto threadId = int(this->buffers_.size()) + 1;
+        threadBuffer_ =
+            std::make_shared<Buffer>(threadId, currentThreadName(threadId));
+        this->buffers_.push_back(threadBuffer_);
+        buffer = threadBuffer_.get();
+    }
+
+    auto size = buffer->size.load(std::memory_order_relaxed);
+    if (size == BUFFER_SIZE)
+    {
+        buffer->dropped.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    buffer->events[size] = {name, start, end};
+    buffer->size.store(size + 1, std::memory_order_release);
+}
+
+bool Tracer::write(const QString &path)
+{
+    enabled_.store(false);
+
+    auto toUs = [this](Clock::time_point time) {
+        return double(std::chrono::duration_cast<std::chrono::microseconds>(
+                          time - this->start_)
+                          .count());
+    };
+
+    QJsonArray events;
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (const auto &buffer : this->buffers_)
+        {
+            events.append(QJsonObject{
+                {"name", "thread_name"},
+                {"ph", "M"},
+                {"pid", 1},
+                {"tid", buffer->threadId},
+                {"args", QJsonObject{{"name", buffer->threadName}}},
+            });
+
+            auto size = buffer->size.load(std::memory_order_acquire);
+            for (size_t i = 0; i < size; i++)
+            {
+                const auto &event = buffer->events[i];
+                events.append(QJsonObject{
+                    {"name", event.name},
+                    {"cat", "chatterino"},
+                    {"ph", "X"},
+                    {"pid", 1},
+                    {"tid", buffer->threadId},
+                    {"ts", toUs(event.start)},
+                    {"dur", toUs(event.end) - toUs(event.start)},
+                });
+            }
+
+            if (auto dropped = buffer->dropped.load())
+            {
+                qCWarning(chatterinoApp)
+                    << "Dropped" << dropped << "trace events of"
+                    << buffer->threadName;
+            }
+        }
+    }
+
+    QSaveFile file(path);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoApp) << "Failed to write trace to" << path;
+        return false;
+    }
+
+    file.write(QJsonDocument(QJsonObject{
+                                 {"traceEvents", events},
+                                 {"displayTimeUnit", "ms"},
+                             })
+                   .toJson(QJsonDocument::Compact));
+    return file.commit();
+}
+
+}  // namespace chatterino
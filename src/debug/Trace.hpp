@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QString>
+
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Collects the durations of the trace scopes and writes them as a
+ *        Chrome trace, which chrome://tracing and the Perfetto UI can open.
+ *
+ * Each thread records into a buffer of its own, the lock is only taken the
+ * first time a thread records something. Once a buffer is full, further
+ * events of its thread are dropped.
+ *
+ * Nothing is recorded until enable is called, which happens with
+ * --trace <file>. Building with CHATTERINO_NO_TRACING removes the trace
+ * scopes altogether.
+ */
+class Tracer
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // events each thread can record
+    static constexpr size_t BUFFER_SIZE = 1 << 16;
+
+    static Tracer &instance();
+
+    static bool isEnabled()
+    {
+        return enabled_.load(std::memory_order_relaxed);
+    }
+
+    void enable();
+
+    /// Stops recording and writes everything that was recorded to path.
+    /// Returns false if the file couldn't be written.
+    bool write(const QString &path);
+
+    /// name has to outlive the tracer, string literals are fine
+    void record(const char *name, Clock::time_point start,
+                Clock::time_point end);
+
+private:
+    Tracer() = default;
+
+    struct Buffer;
+
+    static inline std::atomic<bool> enabled_{false};
+    // buffer of the current thread, created on its first event
+    static thread_local std::shared_ptr<Buffer> threadBuffer_;
+
+    Clock::time_point start_;
+
+    std::mutex mutex_;
+    std::vector<std::shared_ptr<Buffer>> buffers_;
+};
+
+/// Records the time until it's destroyed, see CHATTERINO_TRACE_SCOPE
+class TraceScope
+{
+public:
+    explicit TraceScope(const char *name)
+        : name_(Tracer::isEnabled() ? name : nullptr)
+    {
+        if (this->name_ != nullptr)
+        {
+            this->start_ = Tracer::Clock::now();
+        }
+    }
+
+    ~TraceScope()
+    {
+        if (this->name_ != nullptr)
+        {
+            Tracer::instance().record(this->name_, this->start_,
+                                      Tracer::Clock::now());
+        }
+    }
+
+    TraceScope(const TraceScope &) = delete;
+    TraceScope &operator=(const TraceScope &) = delete;
+
+private:
+    const char *name_;
+    Tracer::Clock::time_point start_;
+};
+
+}  // namespace chatterino
+
+#define CHATTERINO_TRACE_CONCAT_(a, b) a##b
+#define CHATTERINO_TRACE_CONCAT(a, b) CHATTERINO_TRACE_CONCAT_(a, b)
+
+#ifdef CHATTERINO_NO_TRACING
+#    define CHATTERINO_TRACE_SCOPE(name)
+#else
+/// Traces the rest of the enclosing scope, name has to be a string literal
+#    define CHATTERINO_TRACE_SCOPE(name) \
+        ::chatterino::TraceScope CHATTERINO_TRACE_CONCAT(trace, __LINE__)(name)
+#endif
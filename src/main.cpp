@@ -2,6 +2,8 @@
 #include <QCommandLineParser>
 #include <QMessageBox>
 #include <QStringList>
+#include <algorithm>
+#include <cstring>
 #include <memory>
 
 #include "BrowserExtension.hpp"
@@ -10,6 +12,7 @@
 #include "common/Modes.hpp"
 #include "common/QLogging.hpp"
 #include "common/Version.hpp"
+#include "debug/StartupProfiler.hpp"
 #include "providers/IvrApi.hpp"
 #include "providers/twitch/api/Helix.hpp"
 #include "singletons/Paths.hpp"
@@ -21,7 +24,22 @@ using namespace chatterino;
 
 int main(int argc, char **argv)
 {
+    // starts the clock of the startup report
+    auto &profiler = StartupProfiler::instance();
+
+    // headless runs don't need a display, the arguments are only parsed once
+    // the application exists
+    if (std::any_of(argv, argv + argc,
+                    [](const char *arg) {
+                        return std::strcmp(arg, "--headless") == 0;
+                    }) &&
+        qEnvironmentVariableIsEmpty("QT_QPA_PLATFORM"))
+    {
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    }
+
     QApplication a(argc, argv);
+    profiler.step("create QApplication");
 
     QCoreApplication::setApplicationName("chatterino");
     QCoreApplication::setApplicationVersion(CHATTERINO_VERSION);
@@ -54,6 +72,8 @@ int main(int argc, char **argv)
         return 1;
     }
 
+    profiler.step("find paths");
+
     initArgs(a);
 
     // run in gui mode or browser extension host mode
@@ -82,8 +102,10 @@ int main(int argc, char **argv)
 
         IvrApi::initialize();
         Helix::initialize();
+        profiler.step("parse arguments and initialize APIs");
 
         Settings settings(paths->settingsDirectory);
+        profiler.step("load settings");
 
         runGui(a, *paths, settings);
     }
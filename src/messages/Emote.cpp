@@ -1,5 +1,7 @@
 #include "Emote.hpp"
 
+#include "util/MemoryUsage.hpp"
+
 #include <unordered_map>
 
 namespace chatterino {
@@ -25,25 +27,38 @@ EmotePtr cachedOrMakeEmotePtr(Emote &&emote, const EmoteMap &cache)
     return std::make_shared<Emote>(std::move(emote));
 }
 
-EmotePtr cachedOrMakeEmotePtr(
-    Emote &&emote,
-    std::unordered_map<EmoteId, std::weak_ptr<const Emote>> &cache,
-    std::mutex &mutex, const EmoteId &id)
+int64_t EmoteMap::bytes() const
+{
+    // a node holds the pair, the pointer to the next one and the hash
+    return int64_t(sizeof(EmoteMap) + this->bucket_count() * sizeof(void *) +
+                   this->size() * (sizeof(value_type) + 2 * sizeof(void *)));
+}
+
+EmotePtr cachedOrMakeEmotePtr(Emote &&emote, WeakEmoteCache &cache,
+                              const EmoteId &id)
 {
-    std::lock_guard<std::mutex> guard(mutex);
-
-    auto shared = cache[id].lock();
-    if (shared && *shared == emote)
-    {
-        // reuse old shared_ptr if nothing changed
-        return shared;
-    }
-    else
-    {
-        shared = std::make_shared<Emote>(std::move(emote));
-        cache[id] = shared;
-        return shared;
-    }
+    return cache.getOrCreate(
+        id,
+        [&] {
+            return std::make_shared<const Emote>(std::move(emote));
+        },
+        [&](const Emote &cached) {
+            // reuse old shared_ptr if nothing changed
+            return cached == emote;
+        });
+}
+
+std::shared_ptr<const EmoteMap> makeEmoteMapPtr(EmoteMap &&map)
+{
+    auto *shared = new EmoteMap(std::move(map));
+    auto bytes = shared->bytes();
+    MemoryUsage::increase(MemoryCategory::EmoteMaps, bytes);
+
+    return std::shared_ptr<const EmoteMap>(
+        shared, [bytes](const EmoteMap *map) {
+            MemoryUsage::decrease(MemoryCategory::EmoteMaps, bytes);
+            delete map;
+        });
 }
 
 }  // namespace chatterino
@@ -2,6 +2,7 @@
 
 #include "messages/Image.hpp"
 #include "messages/ImageSet.hpp"
+#include "util/WeakCache.hpp"
 
 #include <functional>
 #include <memory>
@@ -29,15 +30,20 @@ using EmotePtr = std::shared_ptr<const Emote>;
 
 class EmoteMap : public std::unordered_map<EmoteName, EmotePtr>
 {
+public:
+    /// Estimate of the memory held by the map itself, the emotes are shared
+    int64_t bytes() const;
 };
 using EmoteIdMap = std::unordered_map<EmoteId, EmotePtr>;
 using WeakEmoteMap = std::unordered_map<EmoteName, std::weak_ptr<const Emote>>;
 using WeakEmoteIdMap = std::unordered_map<EmoteId, std::weak_ptr<const Emote>>;
+using WeakEmoteCache = WeakCache<EmoteId, const Emote>;
 
 EmotePtr cachedOrMakeEmotePtr(Emote &&emote, const EmoteMap &cache);
-EmotePtr cachedOrMakeEmotePtr(
-    Emote &&emote,
-    std::unordered_map<EmoteId, std::weak_ptr<const Emote>> &cache,
-    std::mutex &mutex, const EmoteId &id);
+EmotePtr cachedOrMakeEmotePtr(Emote &&emote, WeakEmoteCache &cache,
+                              const EmoteId &id);
+
+/// Shares a loaded map, it's counted as emote map memory until it's released
+std::shared_ptr<const EmoteMap> makeEmoteMapPtr(EmoteMap &&map);
 
 }  // namespace chatterino
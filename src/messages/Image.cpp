@@ -15,15 +15,24 @@
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
 #include "debug/Benchmark.hpp"
+#include "messages/ImageCache.hpp"
+#include "messages/ImageLoadFailures.hpp"
+#include "singletons/Settings.hpp"
 #ifndef CHATTERINO_TEST
 #    include "singletons/Emotes.hpp"
 #endif
 #include "singletons/WindowManager.hpp"
 #include "singletons/helper/GifTimer.hpp"
+#include "util/ChannelCosts.hpp"
 #include "util/DebugCount.hpp"
+#include "util/Hotness.hpp"
+#include "util/MemoryUsage.hpp"
 #include "util/PostToThread.hpp"
+#include "util/WeakCache.hpp"
 
+#include <algorithm>
 #include <queue>
+#include <utility>
 
 namespace chatterino {
 namespace detail {
@@ -43,33 +52,25 @@ namespace detail {
         {
             DebugCount::increase("animated images");
 
-#ifndef CHATTERINO_TEST
-            this->gifTimerConnection_ =
-                getApp()->emotes->gifTimer.signal.connect([this] {
-                    this->advance();
-                });
-#endif
+            std::vector<int> durations;
+            durations.reserve(size_t(this->items_.size()));
+            for (const auto &frame : this->items_)
+            {
+                durations.push_back(frame.duration);
+            }
+            this->setDurations(durations);
         }
+    }
 
-        auto totalLength =
-            std::accumulate(this->items_.begin(), this->items_.end(), 0UL,
-                            [](auto init, auto &&frame) {
-                                return init + frame.duration;
-                            });
+    Frames::Frames(std::shared_ptr<FrameStream> stream)
+        : stream_(std::move(stream))
+    {
+        assertInGuiThread();
+        DebugCount::increase("images");
+        DebugCount::increase("animated images");
+        DebugCount::increase("streamed animations");
 
-        if (totalLength == 0)
-        {
-            this->durationOffset_ = 0;
-        }
-        else
-        {
-#ifndef CHATTERINO_TEST
-            this->durationOffset_ = std::min<int>(
-                int(getApp()->emotes->gifTimer.position() % totalLength),
-                60000);
-#endif
-        }
-        this->processOffset();
+        this->setDurations(this->stream_->durations());
     }
 
     Frames::~Frames()
@@ -81,59 +82,307 @@ namespace detail {
         {
             DebugCount::decrease("animated images");
         }
-
-        this->gifTimerConnection_.disconnect();
+        if (this->stream_)
+        {
+            DebugCount::decrease("streamed animations");
+        }
     }
 
-    void Frames::advance()
+    void Frames::setDurations(const std::vector<int> &durations)
     {
-        this->durationOffset_ += gifFrameLength;
-        this->processOffset();
+        this->frameEnds_.reserve(durations.size());
+        uint64_t end = 0;
+        for (auto duration : durations)
+        {
+            end += uint64_t(std::max(duration, 0));
+            this->frameEnds_.push_back(end);
+        }
     }
 
-    void Frames::processOffset()
+    int Frames::currentIndex() const
     {
-        if (this->items_.isEmpty())
+        if (!this->animated() || this->frameEnds_.back() == 0)
         {
-            return;
+            return 0;
         }
 
-        while (true)
-        {
-            this->index_ %= this->items_.size();
+#ifndef CHATTERINO_TEST
+        auto &gifTimer = getApp()->emotes->gifTimer;
+        gifTimer.animatedImagePainted();
+        auto position = uint64_t(gifTimer.position()) % this->frameEnds_.back();
+#else
+        uint64_t position = 0;
+#endif
 
-            if (this->durationOffset_ > this->items_[this->index_].duration)
-            {
-                this->durationOffset_ -= this->items_[this->index_].duration;
-                this->index_ = (this->index_ + 1) % this->items_.size();
-            }
-            else
-            {
-                break;
-            }
-        }
+        // all animations follow the same clock, the frame that is shown is
+        // the first one that ends after the current position
+        auto it = std::upper_bound(this->frameEnds_.begin(),
+                                   this->frameEnds_.end(), position);
+        return int(it - this->frameEnds_.begin());
     }
 
     bool Frames::animated() const
     {
-        return this->items_.size() > 1;
+        return this->items_.size() > 1 || this->stream_;
     }
 
     boost::optional<QPixmap> Frames::current() const
     {
+        if (this->stream_)
+            return this->stream_->frame(this->currentIndex());
         if (this->items_.size() == 0)
             return boost::none;
-        return this->items_[this->index_].image;
+        return this->items_[this->currentIndex()].image;
     }
 
     boost::optional<QPixmap> Frames::first() const
     {
+        if (this->stream_)
+            return this->stream_->first();
         if (this->items_.size() == 0)
             return boost::none;
         return this->items_.front().image;
     }
 
+    int64_t Frames::bytes() const
+    {
+        if (this->stream_)
+        {
+            return this->stream_->bytes();
+        }
+
+        int64_t bytes = 0;
+        for (const auto &frame : this->items_)
+        {
+            bytes += int64_t(frame.image.width()) * frame.image.height() *
+                     frame.image.depth() / 8;
+        }
+        return bytes;
+    }
+
+    // FrameStream
+    struct FrameStream::Decoder {
+        QByteArray data;
+        QSize scaledSize;
+        std::unique_ptr<QBuffer> buffer;
+        std::unique_ptr<QImageReader> reader;
+        // index of the frame the reader reads next
+        int next = 0;
+
+        // Decodes count frames starting at from, wrapping around at total.
+        // The frames can only be read in order, the reader starts over from
+        // the first one when the animation wraps around.
+        std::vector<std::pair<int, QImage>> decode(int from, int count,
+                                                   int total)
+        {
+            std::vector<std::pair<int, QImage>> frames;
+
+            for (int i = 0; i < count; i++)
+            {
+                auto index = (from + i) % total;
+                if (!this->reader || index < this->next)
+                {
+                    this->restart();
+                }
+
+                QImage image;
+                while (this->next <= index)
+                {
+                    if (!this->reader->read(&image))
+                    {
+                        // the reader is started over the next time
+                        this->reader.reset();
+                        return frames;
+                    }
+                    this->next++;
+                }
+                frames.emplace_back(index, std::move(image));
+            }
+
+            return frames;
+        }
+
+        void restart()
+        {
+            this->reader.reset();
+            this->buffer = std::make_unique<QBuffer>(&this->data);
+            this->buffer->open(QIODevice::ReadOnly);
+            this->reader = std::make_unique<QImageReader>(this->buffer.get());
+            if (this->scaledSize.isValid())
+            {
+                this->reader->setScaledSize(this->scaledSize);
+            }
+            this->next = 0;
+        }
+    };
+
+    FrameStream::FrameStream(QByteArray data, QSize scaledSize,
+                             std::vector<int> durations,
+                             const QVector<Frame<QPixmap>> &decoded)
+        : data_(std::move(data))
+        , durations_(std::move(durations))
+        , first_(decoded.front().image)
+        , shown_(first_)
+        , decoder_(std::make_shared<Decoder>())
+    {
+        assertInGuiThread();
+
+        this->frameBytes_ = int64_t(this->first_.width()) *
+                            this->first_.height() * this->first_.depth() / 8;
+
+        for (int i = 0; i < decoded.size(); i++)
+        {
+            this->decoded_.emplace(i, decoded[i].image);
+        }
+
+        // the decoder shares the encoded file with the stream
+        this->decoder_->data = this->data_;
+        this->decoder_->scaledSize = scaledSize;
+    }
+
+    const std::vector<int> &FrameStream::durations() const
+    {
+        return this->durations_;
+    }
+
+    const QPixmap &FrameStream::first() const
+    {
+        return this->first_;
+    }
+
+    QPixmap FrameStream::frame(int index)
+    {
+        assertInGuiThread();
+
+        const auto total = int(this->durations_.size());
+
+        // frames that were already shown aren't needed anymore
+        for (auto it = this->decoded_.begin(); it != this->decoded_.end();)
+        {
+            if ((it->first - index + total) % total >= aheadCount)
+            {
+                it = this->decoded_.erase(it);
+            }
+            else
+            {
+                ++it;
+            }
+        }
+
+        auto it = this->decoded_.find(index);
+        if (it != this->decoded_.end())
+        {
+            this->shown_ = it->second;
+        }
+
+        if (!this->decoding_)
+        {
+            // amount of frames starting at index that are already decoded
+            int ready = 0;
+            while (ready < aheadCount &&
+                   this->decoded_.count((index + ready) % total) != 0)
+            {
+                ready++;
+            }
+
+            // decoded in batches, so the reader isn't woken up every frame
+            if (ready <= aheadCount / 2)
+            {
+                this->decode((index + ready) % total, aheadCount - ready);
+            }
+        }
+
+        return this->shown_;
+    }
+
+    int64_t FrameStream::bytes() const
+    {
+        // the frames that are kept decoded can't take up more than this
+        return this->data_.size() + (aheadCount + 2) * this->frameBytes_;
+    }
+
+    void FrameStream::decode(int from, int count)
+    {
+        this->decoding_ = true;
+
+        auto total = int(this->durations_.size());
+        ImageDecodePool::instance().push(
+            nullptr, ImagePriority::High,
+            [weak = weakOf(this), decoder = this->decoder_, from, count,
+             total] {
+                auto frames = decoder->decode(from, count, total);
+
+                postToThread([weak, frames = std::move(frames)] {
+                    auto shared = weak.lock();
+                    if (!shared)
+                        return;
+
+                    shared->decoding_ = false;
+                    for (const auto &[index, image] : frames)
+                    {
+                        shared->decoded_[index] = QPixmap::fromImage(image);
+                    }
+                });
+            },
+            [weak = weakOf(this)] {
+                // tried again the next time a frame is painted
+                postToThread(
+                    [weak] {
+                        if (auto shared = weak.lock())
+                            shared->decoding_ = false;
+                    },
+                    TaskPriority::Low);
+            });
+    }
+
     // functions
+    int frameDuration(const QImageReader &reader)
+    {
+        // It seems that browsers have special logic for fast animations.
+        // This implements Chrome and Firefox's behavior which uses
+        // a duration of 100 ms for any frames that specify a duration of <= 10 ms.
+        // See http://webkit.org/b/36082 for more information.
+        // https://github.com/SevenTV/chatterino7/issues/46#issuecomment-1010595231
+        int duration = reader.nextImageDelay();
+        if (duration <= 10)
+            duration = 100;
+        return std::max(20, duration);
+    }
+
+    // Reads all frames to find out how long they are shown, but only keeps
+    // the first ones
+    QVector<Frame<QImage>> readStreamedFrames(QImageReader &reader,
+                                              const Url &url,
+                                              std::vector<int> &durations)
+    {
+        QVector<Frame<QImage>> frames;
+
+        QImage image;
+        for (int index = 0; index < reader.imageCount(); ++index)
+        {
+            if (!reader.read(&image))
+            {
+                break;
+            }
+
+            auto duration = frameDuration(reader);
+            durations.push_back(duration);
+            if (frames.size() < FrameStream::aheadCount)
+            {
+                frames.push_back(Frame<QImage>{image, duration});
+            }
+        }
+
+        if (frames.size() == 0)
+        {
+            qCDebug(chatterinoImage)
+                << "Error while reading image" << url.string << ": '"
+                << reader.errorString() << "'";
+        }
+
+        return frames;
+    }
+
     QVector<Frame<QImage>> readFrames(QImageReader &reader, const Url &url)
     {
         QVector<Frame<QImage>> frames;
@@ -152,16 +401,7 @@ namespace detail {
             if (reader.read(&image))
             {
                 QPixmap::fromImage(image);
-                // It seems that browsers have special logic for fast animations.
-                // This implements Chrome and Firefox's behavior which uses
-                // a duration of 100 ms for any frames that specify a duration of <= 10 ms.
-                // See http://webkit.org/b/36082 for more information.
-                // https://github.com/SevenTV/chatterino7/issues/46#issuecomment-1010595231
-                int duration = reader.nextImageDelay();
-                if (duration <= 10)
-                    duration = 100;
-                duration = std::max(20, duration);
-                frames.push_back(Frame<QImage>{image, duration});
+                frames.push_back(Frame<QImage>{image, frameDuration(reader)});
             }
         }
 
@@ -176,30 +416,42 @@ namespace detail {
     }
 
     // parsed
+    // Assign returns true if the size of the image changed
     template <typename Assign>
     void assignDelayed(
         std::queue<std::pair<Assign, QVector<Frame<QPixmap>>>> &queued,
-        std::mutex &mutex, std::atomic_bool &loadedEventQueued)
+        std::mutex &mutex, std::atomic_bool &loadedEventQueued,
+        bool sizeChanged = false)
     {
         std::lock_guard<std::mutex> lock(mutex);
         int i = 0;
 
         while (!queued.empty())
         {
-            queued.front().first(queued.front().second);
+            sizeChanged |= queued.front().first(queued.front().second);
             queued.pop();
 
             if (++i > 50)
             {
-                QTimer::singleShot(3, [&] {
-                    assignDelayed(queued, mutex, loadedEventQueued);
+                QTimer::singleShot(3, [&, sizeChanged] {
+                    assignDelayed(queued, mutex, loadedEventQueued,
+                                  sizeChanged);
                 });
                 return;
             }
         }
 
 #ifndef CHATTERINO_TEST
-        getApp()->windows->forceLayoutChannelViews();
+        if (sizeChanged)
+        {
+            getApp()->windows->forceLayoutChannelViews();
+        }
+        else
+        {
+            // the layouts are still right, only the buffers show the
+            // placeholders
+            getApp()->windows->invalidateBuffers();
+        }
 #endif
         loadedEventQueued = false;
     }
@@ -240,6 +492,52 @@ namespace detail {
     }
 }  // namespace detail
 
+namespace {
+    // gui thread only
+    ImagePriority currentImagePriority = ImagePriority::High;
+
+    // images that haven't been painted for this long are always unloaded
+    constexpr std::chrono::minutes IMAGE_LIFETIME(10);
+    // images that were painted this recently are never unloaded
+    constexpr std::chrono::seconds IMAGE_MIN_LIFETIME(5);
+    constexpr std::chrono::minutes FREE_INTERVAL(2);
+    // painting counts towards the hotness of an image this often at most
+    constexpr std::chrono::seconds HOTNESS_INTERVAL(1);
+
+    // images with scores within a factor of two are freed by when they were
+    // painted
+    int hotnessTier(uint32_t score)
+    {
+        int tier = 0;
+        for (; score != 0; score >>= 1)
+        {
+            tier++;
+        }
+        return tier;
+    }
+
+    DebugHistogram decodeTime("image decode time");
+    DebugCounter urlCacheEntries("image url cache entries");
+}  // namespace
+
+ImagePriorityScope::ImagePriorityScope(ImagePriority priority)
+    : previous_(currentImagePriority)
+{
+    assertInGuiThread();
+
+    currentImagePriority = priority;
+}
+
+ImagePriorityScope::~ImagePriorityScope()
+{
+    currentImagePriority = this->previous_;
+}
+
+ImagePriority ImagePriorityScope::current()
+{
+    return currentImagePriority;
+}
+
 // IMAGE2
 Image::~Image()
 {
@@ -250,30 +548,38 @@ Image::~Image()
         return;
     }
 
+    if (!this->url_.string.isEmpty())
+    {
+        ImageExpirationPool::instance().remove(this);
+    }
+
     // run destructor of Frames in gui thread
     if (!isGuiThread())
     {
-        postToThread([frames = this->frames_.release()]() {
-            delete frames;
-        });
+        postToThread(
+            [frames = this->frames_.release()]() {
+                delete frames;
+            },
+            TaskPriority::Low);
     }
 }
 
-ImagePtr Image::fromUrl(const Url &url, qreal scale)
+ImagePtr Image::fromUrl(const Url &url, qreal scale, QSize expectedSize)
 {
-    static std::unordered_map<Url, std::weak_ptr<Image>> cache;
-    static std::mutex mutex;
+    static WeakCache<Url, Image> cache(urlCacheEntries);
 
-    std::lock_guard<std::mutex> lock(mutex);
-
-    auto shared = cache[url].lock();
+    return cache.getOrCreate(url, [&] {
+        return ImagePtr(new Image(url, scale, expectedSize));
+    });
+}
 
-    if (!shared)
-    {
-        cache[url] = shared = ImagePtr(new Image(url, scale));
-    }
+ImagePtr Image::fromUrlScaledTo(const Url &url, QSize maxSize)
+{
+    static WeakCache<Url, Image> cache(urlCacheEntries);
 
-    return shared;
+    return cache.getOrCreate(url, [&] {
+        return ImagePtr(new Image(url, 1, {}, maxSize));
+    });
 }
 
 ImagePtr Image::fromPixmap(const QPixmap &pixmap, qreal scale)
@@ -296,9 +602,11 @@ Image::Image()
 {
 }
 
-Image::Image(const Url &url, qreal scale)
+Image::Image(const Url &url, qreal scale, QSize expectedSize, QSize maxSize)
     : url_(url)
     , scale_(scale)
+    , expectedSize_(expectedSize)
+    , maxSize_(maxSize)
     , shouldLoad_(true)
     , frames_(std::make_unique<detail::Frames>())
 {
@@ -323,7 +631,7 @@ void Image::setPixmap(const QPixmap &pixmap)
     }
     else
     {
-        postToThread(setFrames);
+        postToThread(setFrames, TaskPriority::Low);
     }
 }
 
@@ -336,7 +644,7 @@ bool Image::loaded() const
 {
     assertInGuiThread();
 
-    return bool(this->frames_->current());
+    return bool(this->frames_->first());
 }
 
 boost::optional<QPixmap> Image::pixmapOrLoad() const
@@ -352,10 +660,40 @@ void Image::load() const
 {
     assertInGuiThread();
 
+    auto now = std::chrono::steady_clock::now();
+    auto priority = ImagePriorityScope::current();
+
+    // prefetching doesn't make an image hot
+    if (priority != ImagePriority::Low && !this->url_.string.isEmpty() &&
+        now - this->lastUsed_ >= HOTNESS_INTERVAL)
+    {
+        Hotness::images().hit(this->url_.string, now);
+    }
+    const_cast<Image *>(this)->lastUsed_ = now;
+    const_cast<Image *>(this)->superseded_ = false;
+
     if (this->shouldLoad_)
     {
-        const_cast<Image *>(this)->shouldLoad_ = false;
-        const_cast<Image *>(this)->actuallyLoad();
+        if (!this->url_.string.isEmpty() &&
+            !ImageLoadFailures::instance().mayLoad(this->url_.string))
+        {
+            // the url or its host failed recently, it's tried again the next
+            // time the image is painted after the window
+            return;
+        }
+
+        auto *self = const_cast<Image *>(this);
+        self->shouldLoad_ = false;
+        self->priority_ = priority;
+        self->costChannel_ = ChannelCosts::current();
+        self->actuallyLoad();
+    }
+    else if (priority == ImagePriority::High &&
+             this->priority_ == ImagePriority::Low)
+    {
+        // the image became visible while it was still waiting to be decoded
+        const_cast<Image *>(this)->priority_ = ImagePriority::High;
+        ImageDecodePool::instance().prioritize(this);
     }
 }
 
@@ -382,6 +720,10 @@ int Image::width() const
 
     if (auto pixmap = this->frames_->first())
         return int(pixmap->width() * this->scale_);
+    else if (this->expiredSize_.isValid())
+        return int(this->expiredSize_.width() * this->scale_);
+    else if (this->expectedSize_.isValid())
+        return this->expectedSize_.width();
     else
         return 16;
 }
@@ -392,59 +734,237 @@ int Image::height() const
 
     if (auto pixmap = this->frames_->first())
         return int(pixmap->height() * this->scale_);
+    else if (this->expiredSize_.isValid())
+        return int(this->expiredSize_.height() * this->scale_);
+    else if (this->expectedSize_.isValid())
+        return this->expectedSize_.height();
     else
         return 16;
 }
 
 void Image::actuallyLoad()
 {
+    // even the cache is read in the pool, it touches the disk
+    this->queueDecode([weak = weakOf(this), channel = this->costChannel_] {
+        auto shared = weak.lock();
+        if (!shared)
+            return;
+
+        ChannelCosts::Scope costs(channel, CostCategory::Images);
+        if (!shared->maxSize_.isValid())
+        {
+            if (auto frames = ImageCache::instance().load(shared->url()))
+            {
+                Image::assignParsed(weak, *frames);
+                return;
+            }
+        }
+
+        postToThread(
+            [weak] {
+                if (auto shared = weak.lock())
+                    shared->loadFromNetwork();
+            },
+            TaskPriority::Low);
+    });
+}
+
+void Image::loadFromNetwork()
+{
+    // images in view are sent before the ones loaded in the background
     NetworkRequest(this->url().string)
         .concurrent()
         .cache()
-        .onSuccess([weak = weakOf(this)](auto result) -> Outcome {
+        .priority(this->priority_ == ImagePriority::High
+                      ? NetworkRequestPriority::High
+                      : NetworkRequestPriority::Low)
+        .onSuccess([weak = weakOf(this), url = this->url().string,
+                    channel = this->costChannel_](auto result) -> Outcome {
+            ImageLoadFailures::instance().succeeded(url);
+
             auto shared = weak.lock();
             if (!shared)
                 return Failure;
 
-            auto data = result.getData();
-
-            // const cast since we are only reading from it
-            QBuffer buffer(const_cast<QByteArray *>(&data));
-            buffer.open(QIODevice::ReadOnly);
-            QImageReader reader(&buffer);
-
-            // use "double" to prevent int overflows
-            if (double(reader.size().width()) * double(reader.size().height()) *
-                    double(reader.imageCount()) * 4.0 >
-                double(Image::maxBytesRam))
-            {
-                qCDebug(chatterinoImage) << "image too large in RAM";
-
-                return Failure;
-            }
-
-            auto parsed = detail::readFrames(reader, shared->url());
-
-            postToThread(makeConvertCallback(parsed, [weak](auto frames) {
-                if (auto shared = weak.lock())
-                    shared->frames_ = std::make_unique<detail::Frames>(frames);
-            }));
+            // decoding is done in the pool, so the network threads are free
+            // to download the next image
+            shared->queueDecode([weak, channel,
+                                 data = result.getData()]() mutable {
+                auto shared = weak.lock();
+                if (!shared)
+                    return;
+
+                DebugHistogram::Timer timer(decodeTime);
+                ChannelCosts::Scope costs(channel, CostCategory::Images);
+
+                QBuffer buffer(&data);
+                buffer.open(QIODevice::ReadOnly);
+                QImageReader reader(&buffer);
+
+                auto size = reader.size();
+                const auto &maxSize = shared->maxSize_;
+                if (maxSize.isValid() && (size.width() > maxSize.width() ||
+                                          size.height() > maxSize.height()))
+                {
+                    // every frame is decoded at the size it's shown at
+                    size = size.scaled(maxSize, Qt::KeepAspectRatio);
+                    reader.setScaledSize(size);
+                }
+
+                // use "double" to prevent int overflows
+                auto frameBytes =
+                    double(size.width()) * double(size.height()) * 4.0;
+                auto frameCount = reader.imageCount();
+                if (frameCount > 1 &&
+                    frameBytes * double(frameCount) >
+                        double(Image::minBytesStreamed))
+                {
+                    // only a few frames are decoded at a time, the encoded
+                    // file is still in the network cache the next time
+                    if (frameBytes * detail::FrameStream::aheadCount >
+                        double(Image::maxBytesRam))
+                    {
+                        qCDebug(chatterinoImage) << "image too large in RAM";
+                        return;
+                    }
+
+                    std::vector<int> durations;
+                    auto parsed = detail::readStreamedFrames(
+                        reader, shared->url(), durations);
+                    if (!parsed.empty())
+                    {
+                        Image::assignStream(
+                            weak, data,
+                            maxSize.isValid() ? size : QSize(), durations,
+                            parsed);
+                    }
+                    return;
+                }
+
+                if (frameBytes * double(frameCount) >
+                    double(Image::maxBytesRam))
+                {
+                    qCDebug(chatterinoImage) << "image too large in RAM";
+                    return;
+                }
+
+                auto parsed = detail::readFrames(reader, shared->url());
+
+                Image::assignParsed(weak, parsed);
+                if (!maxSize.isValid())
+                {
+                    ImageCache::instance().store(shared->url(), data, parsed);
+                }
+            });
 
             return Success;
         })
-        .onError([weak = weakOf(this)](auto /*result*/) {
+        .onError([weak = weakOf(this), url = this->url().string](
+                     auto result) {
+            ImageLoadFailures::instance().failed(url, result.status());
+
             auto shared = weak.lock();
             if (!shared)
                 return false;
 
             // fourtf: is this the right thing to do?
             shared->empty_ = true;
+            // painting it tries again once the retry window is over
+            shared->shouldLoad_ = true;
 
             return true;
         })
         .execute();
 }
 
+void Image::queueDecode(std::function<void()> decode)
+{
+    ImageDecodePool::instance().push(
+        this, this->priority_, std::move(decode), [weak = weakOf(this)] {
+            // the decode queue was full, try again the next time the image
+            // is painted
+            postToThread(
+                [weak] {
+                    if (auto shared = weak.lock())
+                        shared->shouldLoad_ = true;
+                },
+                TaskPriority::Low);
+        });
+}
+
+void Image::assignParsed(const std::weak_ptr<Image> &weak,
+                         const QVector<detail::Frame<QImage>> &parsed)
+{
+    auto assign = [weak](auto frames) {
+        if (auto shared = weak.lock())
+        {
+            QSize previous(shared->width(), shared->height());
+
+            // a retry after a failure worked
+            shared->empty_ = false;
+            shared->frames_ = std::make_unique<detail::Frames>(frames);
+            ImageExpirationPool::instance().add(shared);
+
+            return std::exchange(shared->relayoutWhenLoaded_, false) ||
+                   previous != QSize(shared->width(), shared->height());
+        }
+        return false;
+    };
+
+    postToThread(makeConvertCallback(parsed, assign), TaskPriority::Low);
+}
+
+void Image::assignStream(const std::weak_ptr<Image> &weak,
+                         const QByteArray &data, QSize scaledSize,
+                         const std::vector<int> &durations,
+                         const QVector<detail::Frame<QImage>> &parsed)
+{
+    auto assign = [weak, data, scaledSize, durations](auto frames) {
+        if (auto shared = weak.lock())
+        {
+            QSize previous(shared->width(), shared->height());
+
+            shared->empty_ = false;
+            shared->frames_ = std::make_unique<detail::Frames>(
+                std::make_shared<detail::FrameStream>(data, scaledSize,
+                                                      durations, frames));
+            ImageExpirationPool::instance().add(shared);
+
+            return std::exchange(shared->relayoutWhenLoaded_, false) ||
+                   previous != QSize(shared->width(), shared->height());
+        }
+        return false;
+    };
+
+    postToThread(makeConvertCallback(parsed, assign), TaskPriority::Low);
+}
+
+void Image::relayoutWhenLoaded()
+{
+    assertInGuiThread();
+
+    this->relayoutWhenLoaded_ = true;
+}
+
+void Image::setSuperseded()
+{
+    assertInGuiThread();
+
+    this->superseded_ = true;
+}
+
+void Image::expire()
+{
+    assertInGuiThread();
+
+    if (auto first = this->frames_->first())
+    {
+        this->expiredSize_ = first->size();
+    }
+    this->frames_ = std::make_unique<detail::Frames>();
+    this->shouldLoad_ = true;
+}
+
 bool Image::operator==(const Image &other) const
 {
     if (this->isEmpty() && other.isEmpty())
@@ -462,4 +982,149 @@ bool Image::operator!=(const Image &other) const
     return !this->operator==(other);
 }
 
+// ImageExpirationPool
+ImageExpirationPool &ImageExpirationPool::instance()
+{
+    static ImageExpirationPool instance;
+    return instance;
+}
+
+void ImageExpirationPool::add(const ImagePtr &image)
+{
+    assertInGuiThread();
+
+    // created here since the pool can be created by an image being destroyed
+    // on another thread
+    if (!this->freeTimer_)
+    {
+        this->freeTimer_ = std::make_unique<QTimer>();
+        QObject::connect(this->freeTimer_.get(), &QTimer::timeout, [this] {
+            this->freeOld();
+        });
+        this->freeTimer_->start(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                FREE_INTERVAL));
+    }
+
+    auto bytes = image->frames_->bytes();
+    int64_t total = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto &entry = this->entries_[image.get()];
+        entry.image = image;
+        this->setBytes(this->bytes_ - entry.bytes + bytes);
+        entry.bytes = bytes;
+        total = this->bytes_;
+    }
+
+    const auto budget =
+        int64_t(std::max(1, getSettings()->imageMemoryBudget.getValue())) *
+        1024 * 1024;
+
+    // give the images that are loading right now a chance to get painted
+    if (total > budget && !this->freeQueued_)
+    {
+        this->freeQueued_ = true;
+        QTimer::singleShot(
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+                IMAGE_MIN_LIFETIME),
+            [this] {
+                this->freeOld();
+            });
+    }
+}
+
+void ImageExpirationPool::remove(Image *image)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto it = this->entries_.find(image);
+    if (it != this->entries_.end())
+    {
+        this->setBytes(this->bytes_ - it->second.bytes);
+        this->entries_.erase(it);
+    }
+}
+
+void ImageExpirationPool::freeOld()
+{
+    assertInGuiThread();
+
+    this->freeQueued_ = false;
+
+    const auto now = std::chrono::steady_clock::now();
+    const auto budget =
+        int64_t(std::max(1, getSettings()->imageMemoryBudget.getValue())) *
+        1024 * 1024;
+
+    // the images are only released once the mutex isn't held anymore, their
+    // destructor removes them from the pool
+    struct Candidate {
+        ImagePtr image;
+        int tier;
+    };
+    std::vector<Candidate> candidates;
+    int64_t total = 0;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        for (auto &[ptr, entry] : this->entries_)
+        {
+            auto image = entry.image.lock();
+            if (image && now - image->lastUsed_ > IMAGE_MIN_LIFETIME)
+            {
+                candidates.push_back({std::move(image), 0});
+            }
+        }
+        total = this->bytes_;
+    }
+
+    auto &hotness = Hotness::images();
+    for (auto &candidate : candidates)
+    {
+        candidate.tier =
+            hotnessTier(hotness.score(candidate.image->url_.string, now));
+    }
+
+    // superseded first, then the images that were painted the least lately
+    std::sort(candidates.begin(), candidates.end(),
+              [](const Candidate &a, const Candidate &b) {
+                  if (a.image->superseded_ != b.image->superseded_)
+                  {
+                      return a.image->superseded_;
+                  }
+                  if (a.tier != b.tier)
+                  {
+                      return a.tier < b.tier;
+                  }
+                  return a.image->lastUsed_ < b.image->lastUsed_;
+              });
+
+    int64_t expired = 0;
+    for (const auto &[image, tier] : candidates)
+    {
+        // hotter images that weren't painted for the lifetime can come later
+        if (total <= budget && now - image->lastUsed_ < IMAGE_LIFETIME)
+        {
+            continue;
+        }
+
+        total -= image->frames_->bytes();
+        image->expire();
+        this->remove(image.get());
+        expired++;
+    }
+
+    DebugCount::increase("expired images", expired);
+}
+
+void ImageExpirationPool::setBytes(int64_t bytes)
+{
+    MemoryUsage::increase(MemoryCategory::Images, bytes - this->bytes_);
+    this->bytes_ = bytes;
+}
+
 }  // namespace chatterino
@@ -3,17 +3,24 @@
 #include <QPixmap>
 #include <QString>
 #include <QThread>
+#include <QTimer>
 #include <QVector>
 #include <atomic>
 #include <boost/noncopyable.hpp>
 #include <boost/optional.hpp>
 #include <boost/variant.hpp>
+#include <chrono>
+#include <functional>
+#include <map>
 #include <memory>
 #include <mutex>
+#include <unordered_map>
+#include <vector>
 #include <pajlada/signals/signal.hpp>
 
 #include "common/Aliases.hpp"
 #include "common/Common.hpp"
+#include "messages/ImageDecodePool.hpp"
 
 namespace chatterino {
 namespace detail {
@@ -22,40 +29,117 @@ namespace detail {
         Image image;
         int duration;
     };
+
+    /**
+     * @brief Frames of a large animation, decoded shortly before they're
+     *        shown.
+     *
+     * Only the encoded file, the first frame and the frames right ahead of
+     * the position of the GIFTimer are kept. The next frames are decoded in
+     * the ImageDecodePool while the current ones are shown, one batch at a
+     * time. A frame that isn't decoded in time is replaced by the last one
+     * that was shown. Gui thread only.
+     */
+    class FrameStream : public std::enable_shared_from_this<FrameStream>,
+                        boost::noncopyable
+    {
+    public:
+        /// Amount of frames that are kept decoded at most
+        static constexpr int aheadCount = 8;
+
+        /// decoded are the first frames of the animation
+        FrameStream(QByteArray data, QSize scaledSize,
+                    std::vector<int> durations,
+                    const QVector<Frame<QPixmap>> &decoded);
+
+        const std::vector<int> &durations() const;
+        const QPixmap &first() const;
+        /// Returns the frame at index, or the last one that was shown while
+        /// it's still being decoded
+        QPixmap frame(int index);
+        // memory used by the encoded file and the decoded frames
+        int64_t bytes() const;
+
+    private:
+        struct Decoder;
+
+        void decode(int from, int count);
+
+        QByteArray data_;
+        const std::vector<int> durations_;
+        const QPixmap first_;
+        int64_t frameBytes_ = 0;
+
+        std::map<int, QPixmap> decoded_;
+        QPixmap shown_;
+        bool decoding_ = false;
+        // only used by the job that's decoding right now
+        std::shared_ptr<Decoder> decoder_;
+    };
+
     class Frames : boost::noncopyable
     {
     public:
         Frames();
         Frames(const QVector<Frame<QPixmap>> &frames);
+        Frames(std::shared_ptr<FrameStream> stream);
         ~Frames();
 
         bool animated() const;
-        void advance();
+        /// The frame for the current position of the GIFTimer
         boost::optional<QPixmap> current() const;
         boost::optional<QPixmap> first() const;
+        // memory used by the pixmaps of all frames
+        int64_t bytes() const;
 
     private:
-        void processOffset();
+        int currentIndex() const;
+        void setDurations(const std::vector<int> &durations);
+
         QVector<Frame<QPixmap>> items_;
-        int index_{0};
-        int durationOffset_{0};
-        pajlada::Signals::Connection gifTimerConnection_;
+        std::shared_ptr<FrameStream> stream_;
+        // end of every frame from the start of the animation, in ms
+        std::vector<uint64_t> frameEnds_;
     };
 }  // namespace detail
 
 class Image;
 using ImagePtr = std::shared_ptr<Image>;
 
+/// Images that start loading while this is alive are decoded with the given
+/// priority. Images load with high priority outside of any scope.
+/// Gui thread only.
+class ImagePriorityScope : boost::noncopyable
+{
+public:
+    explicit ImagePriorityScope(ImagePriority priority);
+    ~ImagePriorityScope();
+
+    static ImagePriority current();
+
+private:
+    ImagePriority previous_;
+};
+
 /// This class is thread safe.
 class Image : public std::enable_shared_from_this<Image>, boost::noncopyable
 {
 public:
     // Maximum amount of RAM used by the image in bytes.
     static constexpr int maxBytesRam = 20 * 1024 * 1024;
+    // Animations that take up more than this once all their frames are
+    // decoded are only decoded around the frame that's shown.
+    static constexpr int minBytesStreamed = 2 * 1024 * 1024;
 
     ~Image();
 
-    static ImagePtr fromUrl(const Url &url, qreal scale = 1);
+    // expectedSize is the size at 1x the provider says the image has, it's
+    // used for layouts until the image is loaded
+    static ImagePtr fromUrl(const Url &url, qreal scale = 1,
+                            QSize expectedSize = {});
+    // for images that are only shown up to a certain size, like link
+    // thumbnails. They are decoded scaled down to fit into maxSize.
+    static ImagePtr fromUrlScaledTo(const Url &url, QSize maxSize);
     static ImagePtr fromPixmap(const QPixmap &pixmap, qreal scale = 1);
     static ImagePtr getEmpty();
 
@@ -70,23 +154,102 @@ public:
     int height() const;
     bool animated() const;
 
+    // layouts that show another scale while this one loads are laid out
+    // again once it's loaded, so they pick it up
+    void relayoutWhenLoaded();
+    // another scale of the same set is shown in place of this one, so it's
+    // released first while the images take up more than the budget. Loading
+    // it again clears this.
+    void setSuperseded();
+
     bool operator==(const Image &image) const;
     bool operator!=(const Image &image) const;
 
 private:
     Image();
-    Image(const Url &url, qreal scale);
+    Image(const Url &url, qreal scale, QSize expectedSize,
+          QSize maxSize = {});
     Image(qreal scale);
 
     void setPixmap(const QPixmap &pixmap);
+    // loads the image from the ImageCache, or from the network otherwise
     void actuallyLoad();
+    void loadFromNetwork();
+    // runs decode in the ImageDecodePool with the priority of this image
+    void queueDecode(std::function<void()> decode);
+    // converts the frames and sets them in the gui thread, channel views are
+    // only laid out again if images turned out to have a different size
+    static void assignParsed(const std::weak_ptr<Image> &weak,
+                             const QVector<detail::Frame<QImage>> &parsed);
+    // like assignParsed, but for an animation of which only the first frames
+    // were kept
+    static void assignStream(const std::weak_ptr<Image> &weak,
+                             const QByteArray &data, QSize scaledSize,
+                             const std::vector<int> &durations,
+                             const QVector<detail::Frame<QImage>> &parsed);
+    // drops the frames, they are loaded again once the image is painted
+    void expire();
 
     const Url url_{};
     const qreal scale_{1};
+    const QSize expectedSize_{};
+    // downscaled frames aren't kept in the ImageCache
+    const QSize maxSize_{};
     std::atomic_bool empty_{false};
+    std::atomic<ImagePriority> priority_{ImagePriority::High};
 
     // gui thread only
     bool shouldLoad_{false};
+    bool relayoutWhenLoaded_{false};
+    bool superseded_{false};
+    // the channel whose painting loaded the image, it pays for decoding it
+    QString costChannel_{};
     std::unique_ptr<detail::Frames> frames_{};
+    std::chrono::steady_clock::time_point lastUsed_{};
+    // size of the first frame before the image expired, keeps layouts from
+    // jumping around until it's loaded again
+    QSize expiredSize_{};
+
+    friend class ImageExpirationPool;
+};
+
+/**
+ * @brief Unloads the frames of images that haven't been painted in a while.
+ *
+ * Images loaded from an url are added once their frames are set. Frames of
+ * images that haven't been painted for longer than the lifetime are dropped,
+ * and so are those of the images that were painted the least lately (see
+ * Hotness::images) while all frames together take up more than the budget set
+ * in the settings, starting with the superseded ones. Images that were painted
+ * in the last few seconds are always kept.
+ *
+ * add and freeOld must be called from the gui thread.
+ */
+class ImageExpirationPool : boost::noncopyable
+{
+public:
+    static ImageExpirationPool &instance();
+
+    void add(const ImagePtr &image);
+    void remove(Image *image);
+
+    void freeOld();
+
+private:
+    ImageExpirationPool() = default;
+
+    void setBytes(int64_t bytes);
+
+    struct Entry {
+        std::weak_ptr<Image> image;
+        int64_t bytes = 0;
+    };
+
+    std::mutex mutex_;
+    std::unordered_map<Image *, Entry> entries_;
+    int64_t bytes_ = 0;
+
+    std::unique_ptr<QTimer> freeTimer_;
+    bool freeQueued_ = false;
 };
 }  // namespace chatterino
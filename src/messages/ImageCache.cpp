@@ -0,0 +1,243 @@
+#include "messages/ImageCache.hpp"
+
+#include "common/QLogging.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Settings.hpp"
+
+#include <QCryptographicHash>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QSaveFile>
+
+#include <cstring>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr char MAGIC[4] = {'C', 'I', 'M', 'G'};
+    constexpr uint32_t VERSION = 1;
+    constexpr auto FORMAT = QImage::Format_ARGB32_Premultiplied;
+
+    struct FileHeader {
+        char magic[4];
+        uint32_t version;
+        uint32_t frameCount;
+    };
+
+    struct FrameHeader {
+        int32_t width;
+        int32_t height;
+        int32_t duration;
+    };
+
+    QString hash(const QByteArray &bytes)
+    {
+        return QCryptographicHash::hash(bytes, QCryptographicHash::Sha256)
+            .toHex();
+    }
+
+    QString referencePath(const QString &directory, const Url &url)
+    {
+        return directory + "/" + hash(url.string.toUtf8()) + ".ref";
+    }
+
+    void touch(QFile &file)
+    {
+        file.setFileTime(QDateTime::currentDateTime(),
+                         QFileDevice::FileModificationTime);
+    }
+
+}  // namespace
+
+ImageCache &ImageCache::instance()
+{
+    static ImageCache instance;
+    return instance;
+}
+
+boost::optional<QVector<detail::Frame<QImage>>> ImageCache::load(
+    const Url &url)
+{
+    auto directory = getPaths()->imageCacheDirectory();
+
+    QFile reference(referencePath(directory, url));
+    if (!reference.open(QIODevice::ReadOnly))
+    {
+        return boost::none;
+    }
+
+    auto entryName = QString::fromLatin1(reference.readAll());
+    if (entryName.size() != 64)
+    {
+        return boost::none;
+    }
+
+    QFile entry(directory + "/" + entryName);
+    if (!entry.open(QIODevice::ReadOnly))
+    {
+        return boost::none;
+    }
+
+    auto size = entry.size();
+    const auto *data = entry.map(0, size);
+    if (data == nullptr || size < qint64(sizeof(FileHeader)))
+    {
+        return boost::none;
+    }
+
+    FileHeader header;
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, MAGIC, sizeof(MAGIC)) != 0 ||
+        header.version != VERSION || header.frameCount == 0)
+    {
+        return boost::none;
+    }
+
+    qint64 offset = sizeof(FileHeader) + qint64(header.frameCount) *
+                                             qint64(sizeof(FrameHeader));
+    if (offset > size)
+    {
+        return boost::none;
+    }
+
+    QVector<detail::Frame<QImage>> frames;
+    frames.reserve(int(header.frameCount));
+
+    for (uint32_t i = 0; i < header.frameCount; i++)
+    {
+        FrameHeader frame;
+        std::memcpy(&frame,
+                    data + sizeof(FileHeader) + i * sizeof(FrameHeader),
+                    sizeof(frame));
+
+        auto length = qint64(frame.width) * qint64(frame.height) * 4;
+        if (frame.width <= 0 || frame.height <= 0 || offset + length > size)
+        {
+            qCDebug(chatterinoImage)
+                << "Corrupted image cache entry for" << url.string;
+            return boost::none;
+        }
+
+        // the mapping is gone once entry is closed, so the pixels are copied
+        frames.push_back(detail::Frame<QImage>{
+            QImage(data + offset, frame.width, frame.height, frame.width * 4,
+                   FORMAT)
+                .copy(),
+            frame.duration});
+        offset += length;
+    }
+
+    touch(reference);
+    touch(entry);
+
+    return frames;
+}
+
+void ImageCache::store(const Url &url, const QByteArray &data,
+                       const QVector<detail::Frame<QImage>> &frames)
+{
+    if (frames.isEmpty())
+    {
+        return;
+    }
+
+    auto directory = getPaths()->imageCacheDirectory();
+    getPaths()->createFolder(directory);
+
+    auto entryName = hash(data);
+    int64_t written = 0;
+
+    if (!QFile::exists(directory + "/" + entryName))
+    {
+        QSaveFile entry(directory + "/" + entryName);
+        if (!entry.open(QIODevice::WriteOnly))
+        {
+            return;
+        }
+
+        FileHeader header;
+        std::memcpy(header.magic, MAGIC, sizeof(MAGIC));
+        header.version = VERSION;
+        header.frameCount = uint32_t(frames.size());
+        entry.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+        for (const auto &frame : frames)
+        {
+            FrameHeader frameHeader{frame.image.width(), frame.image.height(),
+                                    frame.duration};
+            entry.write(reinterpret_cast<const char *>(&frameHeader),
+                        sizeof(frameHeader));
+        }
+
+        for (const auto &frame : frames)
+        {
+            auto image = frame.image.convertToFormat(FORMAT);
+            for (int y = 0; y < image.height(); y++)
+            {
+                entry.write(reinterpret_cast<const char *>(image.scanLine(y)),
+                            image.width() * 4);
+            }
+        }
+
+        written += entry.size();
+        if (!entry.commit())
+        {
+            return;
+        }
+    }
+
+    QSaveFile reference(referencePath(directory, url));
+    if (reference.open(QIODevice::WriteOnly))
+    {
+        reference.write(entryName.toLatin1());
+        written += reference.size();
+        reference.commit();
+    }
+
+    if ((this->bytesSinceTrim_ += written) > ImageCache::limit() / 8)
+    {
+        this->trim();
+    }
+}
+
+void ImageCache::trim()
+{
+    std::lock_guard<std::mutex> lock(this->trimMutex_);
+    this->bytesSinceTrim_ = 0;
+
+    // oldest first
+    auto files = QDir(getPaths()->imageCacheDirectory())
+                     .entryInfoList(QDir::Files, QDir::Time | QDir::Reversed);
+
+    int64_t total = 0;
+    for (const auto &file : files)
+    {
+        total += file.size();
+    }
+
+    const auto limit = ImageCache::limit();
+    for (const auto &file : files)
+    {
+        if (total <= limit)
+        {
+            break;
+        }
+
+        // references to removed entries are left behind until they're
+        // evicted themselves, loading them just fails
+        if (QFile::remove(file.absoluteFilePath()))
+        {
+            total -= file.size();
+        }
+    }
+}
+
+int64_t ImageCache::limit()
+{
+    return int64_t(std::max(1, getSettings()->imageCacheSize.getValue())) *
+           1024 * 1024;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "common/Aliases.hpp"
+#include "messages/Image.hpp"
+
+#include <QByteArray>
+#include <QImage>
+#include <QString>
+#include <QVector>
+#include <boost/noncopyable.hpp>
+#include <boost/optional.hpp>
+
+#include <atomic>
+#include <mutex>
+
+namespace chatterino {
+
+/**
+ * @brief Decoded frames of images loaded from an url, saved on disk.
+ *
+ * Entries are keyed by the hash of the downloaded file, so identical images
+ * behind different urls share one entry, and a small reference file per url
+ * points to its entry. Frames are stored uncompressed together with their
+ * sizes and durations. Entries are read through a memory mapping, loading an
+ * image from this cache needs neither the network nor an image decoder.
+ *
+ * The cache is kept below the size set in the settings by removing the least
+ * recently used files. All functions can be called from any thread.
+ */
+class ImageCache : boost::noncopyable
+{
+public:
+    static ImageCache &instance();
+
+    /// Returns the frames saved for the url, none if there aren't any
+    boost::optional<QVector<detail::Frame<QImage>>> load(const Url &url);
+
+    /// Saves the frames for the url, data is the file they were decoded from
+    void store(const Url &url, const QByteArray &data,
+               const QVector<detail::Frame<QImage>> &frames);
+
+    /// Removes the least recently used files until the cache fits its limit
+    void trim();
+
+private:
+    ImageCache() = default;
+
+    static int64_t limit();
+
+    std::mutex trimMutex_;
+    // bytes written since the cache was last trimmed, starts out high so the
+    // cache is trimmed after the first write of a session
+    std::atomic<int64_t> bytesSinceTrim_{INT64_MAX / 2};
+};
+
+}  // namespace chatterino
@@ -0,0 +1,127 @@
+#include "messages/ImageDecodePool.hpp"
+
+#include <QThread>
+
+#include <algorithm>
+
+namespace chatterino {
+
+ImageDecodePool &ImageDecodePool::instance()
+{
+    // leave some cores for the gui and the network threads
+    static ImageDecodePool pool(
+        size_t(std::clamp(QThread::idealThreadCount() / 2, 1, 4)));
+    return pool;
+}
+
+ImageDecodePool::ImageDecodePool(size_t threadCount)
+{
+    for (size_t i = 0; i < threadCount; i++)
+    {
+        this->threads_.emplace_back([this] {
+            this->run();
+        });
+    }
+}
+
+ImageDecodePool::~ImageDecodePool()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->condition_.notify_all();
+
+    for (auto &thread : this->threads_)
+    {
+        thread.join();
+    }
+}
+
+void ImageDecodePool::push(const Image *owner, ImagePriority priority,
+                           Decode decode, Dropped onDropped)
+{
+    Dropped dropped;
+    bool queued = true;
+
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        if (this->high_.size() + this->low_.size() >= maxQueuedJobs)
+        {
+            if (this->low_.empty() || priority == ImagePriority::Low)
+            {
+                // there is no job less important than this one
+                dropped = std::move(onDropped);
+                queued = false;
+            }
+            else
+            {
+                dropped = std::move(this->low_.front().onDropped);
+                this->low_.pop_front();
+            }
+        }
+
+        if (queued)
+        {
+            auto &queue =
+                priority == ImagePriority::High ? this->high_ : this->low_;
+            queue.push_back({owner, std::move(decode), std::move(onDropped)});
+        }
+    }
+
+    if (queued)
+    {
+        this->condition_.notify_one();
+    }
+
+    if (dropped)
+    {
+        dropped();
+    }
+}
+
+void ImageDecodePool::prioritize(const Image *owner)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto it = std::find_if(this->low_.begin(), this->low_.end(),
+                           [owner](const Job &job) {
+                               return job.owner == owner;
+                           });
+
+    if (it != this->low_.end())
+    {
+        this->high_.push_back(std::move(*it));
+        this->low_.erase(it);
+    }
+}
+
+void ImageDecodePool::run()
+{
+    while (true)
+    {
+        Decode decode;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->condition_.wait(lock, [this] {
+                return this->stopping_ || !this->high_.empty() ||
+                       !this->low_.empty();
+            });
+
+            if (this->stopping_)
+            {
+                return;
+            }
+
+            auto &queue = this->high_.empty() ? this->low_ : this->high_;
+            decode = std::move(queue.front().decode);
+            queue.pop_front();
+        }
+
+        decode();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,76 @@
+#pragma once
+
+#include "common/Aliases.hpp"
+
+#include <QByteArray>
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chatterino {
+
+class Image;
+
+enum class ImagePriority : uint8_t {
+    // images that aren't visible yet, e.g. emotes in the emote popup
+    Low,
+    // images that are visible right now
+    High,
+};
+
+/**
+ * @brief Decodes downloaded images on a fixed number of worker threads.
+ *
+ * High priority jobs are always taken before low priority ones. The amount of
+ * queued jobs is bounded: once the queue is full, new jobs push out the oldest
+ * low priority job, which then gets its onDropped callback called.
+ */
+class ImageDecodePool : boost::noncopyable
+{
+public:
+    using Decode = std::function<void()>;
+    using Dropped = std::function<void()>;
+
+    static constexpr size_t maxQueuedJobs = 512;
+
+    static ImageDecodePool &instance();
+
+    ImageDecodePool(size_t threadCount);
+    ~ImageDecodePool();
+
+    /**
+     * @brief Queues decode to be run on one of the worker threads.
+     *
+     * owner is only used to find the job again in prioritize. onDropped is
+     * called instead of decode if the job gets pushed out of the queue.
+     */
+    void push(const Image *owner, ImagePriority priority, Decode decode,
+              Dropped onDropped);
+
+    /// Moves the low priority job of owner (if any) to the high priority queue
+    void prioritize(const Image *owner);
+
+private:
+    struct Job {
+        const Image *owner;
+        Decode decode;
+        Dropped onDropped;
+    };
+
+    void run();
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Job> high_;
+    std::deque<Job> low_;
+    bool stopping_ = false;
+
+    std::vector<std::thread> threads_;
+};
+
+}  // namespace chatterino
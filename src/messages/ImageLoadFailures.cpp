@@ -0,0 +1,165 @@
+#include "messages/ImageLoadFailures.hpp"
+
+#include "util/DebugCount.hpp"
+
+#include <QUrl>
+
+namespace chatterino {
+
+namespace {
+
+    // urls whose window is over are forgotten once more than this failed
+    constexpr size_t maxUrls = 4096;
+
+    DebugCounter failedRequests("image requests failed");
+    DebugCounter heldBackRequests("image requests held back");
+    DebugCounter pausedHosts("image hosts paused");
+
+    bool isUrlsFault(int status)
+    {
+        // the cdn answered, there's something wrong with the url
+        return status >= 400 && status < 500 && status != 429;
+    }
+
+}  // namespace
+
+ImageLoadFailures &ImageLoadFailures::instance()
+{
+    static ImageLoadFailures instance;
+    return instance;
+}
+
+bool ImageLoadFailures::mayLoad(const QString &url, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto failure = this->urls_.find(url);
+    if (failure != this->urls_.end() && now < failure->second.retryAt)
+    {
+        heldBackRequests.increase();
+        return false;
+    }
+
+    auto host = this->hosts_.find(hostOf(url));
+    if (host != this->hosts_.end() && host->second.paused)
+    {
+        if (now < host->second.retryAt)
+        {
+            heldBackRequests.increase();
+            return false;
+        }
+
+        // this one probes the host, the others wait for its outcome
+        host->second.retryAt = now + PROBE_TIMEOUT;
+    }
+
+    return true;
+}
+
+void ImageLoadFailures::failed(const QString &url, int status,
+                               Clock::time_point now)
+{
+    failedRequests.increase();
+
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    this->prune(now);
+    auto &failure = this->urls_[url];
+    failure.retryAt = now + failure.backoff.next();
+
+    auto hostName = hostOf(url);
+    if (isUrlsFault(status))
+    {
+        // the host is fine
+        auto host = this->hosts_.find(hostName);
+        if (host != this->hosts_.end())
+        {
+            if (host->second.paused)
+            {
+                pausedHosts.decrease();
+            }
+            this->hosts_.erase(host);
+        }
+        return;
+    }
+
+    auto &host = this->hosts_[hostName];
+    host.inARow++;
+    if (host.paused || host.inARow >= HOST_FAILURES)
+    {
+        if (!host.paused)
+        {
+            host.paused = true;
+            pausedHosts.increase();
+        }
+        host.retryAt = now + host.backoff.next();
+    }
+}
+
+void ImageLoadFailures::succeeded(const QString &url)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    this->urls_.erase(url);
+
+    auto host = this->hosts_.find(hostOf(url));
+    if (host != this->hosts_.end())
+    {
+        if (host->second.paused)
+        {
+            pausedHosts.decrease();
+        }
+        this->hosts_.erase(host);
+    }
+}
+
+bool ImageLoadFailures::isPaused(const QString &url, Clock::time_point now)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto host = this->hosts_.find(hostOf(url));
+    return host != this->hosts_.end() && host->second.paused &&
+           now < host->second.retryAt;
+}
+
+void ImageLoadFailures::clear()
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    for (const auto &host : this->hosts_)
+    {
+        if (host.second.paused)
+        {
+            pausedHosts.decrease();
+        }
+    }
+    this->urls_.clear();
+    this->hosts_.clear();
+}
+
+QString ImageLoadFailures::hostOf(const QString &url)
+{
+    return QUrl(url).host();
+}
+
+void ImageLoadFailures::prune(Clock::time_point now)
+{
+    if (this->urls_.size() < maxUrls)
+    {
+        return;
+    }
+
+    for (auto it = this->urls_.begin(); it != this->urls_.end();)
+    {
+        if (it->second.retryAt <= now)
+        {
+            it = this->urls_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}  // namespace chatterino
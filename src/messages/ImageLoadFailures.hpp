@@ -0,0 +1,82 @@
+#pragma once
+
+#include "util/ExponentialBackoff.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Keeps images from sending the same failing request again and again.
+ *
+ * An url that failed may only be requested again once its retry window is
+ * over, the window doubles with every failure in a row. Failures that aren't
+ * the url's fault, like timeouts and server errors, also count for its host.
+ * After a few of those in a row the host is paused and no image is loaded
+ * from it until its own window is over. Then a single request is let
+ * through to probe it, its outcome closes or reopens the host.
+ *
+ * A failed cdn takes a fixed amount of requests this way, no matter how
+ * often the images are painted. This class is thread safe.
+ */
+class ImageLoadFailures
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // failures of an url in a row until its window stops growing
+    static constexpr unsigned URL_STEPS = 8;
+    static constexpr std::chrono::milliseconds URL_FIRST_WINDOW{2000};
+    // failures of a host in a row that pause it
+    static constexpr int HOST_FAILURES = 5;
+    static constexpr unsigned HOST_STEPS = 6;
+    static constexpr std::chrono::milliseconds HOST_FIRST_WINDOW{10000};
+    // a probe that didn't come back after this is replaced by another one
+    static constexpr std::chrono::milliseconds PROBE_TIMEOUT{30000};
+
+    static ImageLoadFailures &instance();
+
+    /// Whether a request for the url may be sent now. A paused host lets the
+    /// first caller after its window through as the probe.
+    bool mayLoad(const QString &url, Clock::time_point now = Clock::now());
+
+    /// status is the one of the NetworkResult
+    void failed(const QString &url, int status,
+                Clock::time_point now = Clock::now());
+    void succeeded(const QString &url);
+
+    /// Whether no image is loaded from the host of the url until the window
+    /// is over
+    bool isPaused(const QString &url, Clock::time_point now = Clock::now());
+
+    /// Forgets all failures
+    void clear();
+
+private:
+    struct UrlFailure {
+        ExponentialBackoff<URL_STEPS> backoff{URL_FIRST_WINDOW};
+        Clock::time_point retryAt;
+    };
+
+    struct HostFailures {
+        ExponentialBackoff<HOST_STEPS> backoff{HOST_FIRST_WINDOW};
+        int inARow = 0;
+        bool paused = false;
+        Clock::time_point retryAt;
+    };
+
+    static QString hostOf(const QString &url);
+    // drops the urls whose window is over once there are too many
+    void prune(Clock::time_point now);
+
+    std::mutex mutex_;
+    std::unordered_map<QString, UrlFailure> urls_;
+    std::unordered_map<QString, HostFailures> hosts_;
+};
+
+}  // namespace chatterino
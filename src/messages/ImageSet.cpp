@@ -2,6 +2,9 @@
 
 #include "singletons/Settings.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace chatterino {
 
 ImageSet::ImageSet()
@@ -61,7 +64,7 @@ const ImagePtr &ImageSet::getImage3() const
 const std::shared_ptr<Image> &getImagePriv(const ImageSet &set, float scale)
 {
 #ifndef CHATTERINO_TEST
-    scale *= getSettings()->emoteScale;
+    scale *= getSettings()->layoutSettings()->emoteScale;
 #endif
 
     int quality = 1;
@@ -91,19 +94,47 @@ const ImagePtr &ImageSet::getImageOrLoaded(float scale) const
     // get best image based on scale
     result->load();
 
-    // prefer other image if selected image is not loaded yet
+    const ImagePtr *images[] = {&this->imageX1_, &this->imageX2_,
+                                &this->imageX3_};
+    auto loaded = [&](int i) {
+        const auto &image = *images[i];
+        return image && !image->isEmpty() && image->loaded();
+    };
+    int wanted = int(std::find(std::begin(images), std::end(images), &result) -
+                     std::begin(images));
+
     if (result->loaded())
+    {
+        // the other scales were only needed while this one was loading
+        for (int i = 0; i < 3; i++)
+        {
+            if (i != wanted && *images[i] != result && loaded(i))
+            {
+                (*images[i])->setSuperseded();
+            }
+        }
         return result;
-    else if (this->imageX3_ && !this->imageX3_->isEmpty() &&
-             this->imageX3_->loaded())
-        return this->imageX3_;
-    else if (this->imageX2_ && !this->imageX2_->isEmpty() &&
-             this->imageX2_->loaded())
-        return this->imageX2_;
-    else if (this->imageX1_->loaded())
-        return this->imageX1_;
-    else
-        return result;
+    }
+
+    // prefer scaling a larger image down, then the closest smaller one up
+    for (int i = wanted + 1; i < 3; i++)
+    {
+        if (loaded(i))
+        {
+            result->relayoutWhenLoaded();
+            return *images[i];
+        }
+    }
+    for (int i = wanted - 1; i >= 0; i--)
+    {
+        if (loaded(i))
+        {
+            result->relayoutWhenLoaded();
+            return *images[i];
+        }
+    }
+
+    return result;
 }
 
 const ImagePtr &ImageSet::getImage(float scale) const
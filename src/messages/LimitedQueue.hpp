@@ -2,17 +2,13 @@
 
 #include "messages/LimitedQueueSnapshot.hpp"
 
-#include <QDebug>
-
+#include <algorithm>
 #include <memory>
 #include <mutex>
 #include <vector>
 
 namespace chatterino {
 
-//
-// Warning:
-// - this class is so overengineered it's not even funny anymore
 //
 // Explanation:
 // - messages can be appended until 'limit' is reached
@@ -23,13 +19,29 @@ namespace chatterino {
 // - you are able to get a "Snapshot" which captures the state of this object
 // - adding items to this class does not change the "items" of the snapshot
 //
+// Implementation:
+// - items live in fixed-size chunks which are referenced from a chunk table.
+//   Items are addressed by their absolute slot index in that table, so the
+//   queue behaves like a ring buffer that moves forward through the table
+// - a slot is only ever written while no snapshot can see it (appending
+//   writes past the end, everything else copies the affected chunk first),
+//   which means chunks can be shared with snapshots without being copied
+// - the chunk table is allocated with spare room up front and is never
+//   resized. Once the queue reaches the end of the table the live chunks are
+//   moved to a fresh table, snapshots keep referencing the old one
+// - as a result, taking a snapshot is O(1) and appending is amortized O(1)
+//
 
 template <typename T>
 class LimitedQueue
 {
 protected:
-    using Chunk = std::vector<T>;
-    using ChunkVector = std::vector<std::shared_ptr<Chunk>>;
+    using Chunk = detail::LimitedQueueChunk<T>;
+    using ChunkTable = detail::LimitedQueueChunkTable<T>;
+
+    static constexpr size_t chunkShift = detail::limitedQueueChunkShift;
+    static constexpr size_t chunkSize = detail::limitedQueueChunkSize;
+    static constexpr size_t chunkMask = detail::limitedQueueChunkMask;
 
 public:
     LimitedQueue(size_t limit = 1000)
@@ -42,12 +54,9 @@ public:
     {
         std::lock_guard<std::mutex> lock(this->mutex_);
 
-        this->chunks_ = std::make_shared<ChunkVector>();
-        auto chunk = std::make_shared<Chunk>();
-        chunk->resize(this->chunkSize_);
-        this->chunks_->push_back(chunk);
-        this->firstChunkOffset_ = 0;
-        this->lastChunkEnd_ = 0;
+        this->chunks_ = this->makeTable();
+        this->offset_ = 0;
+        this->size_ = 0;
     }
 
     // return true if an item was deleted
@@ -56,80 +65,98 @@ public:
     {
         std::lock_guard<std::mutex> lock(this->mutex_);
 
-        auto lastChunk = this->chunks_->back();
+        bool removedItem = false;
 
-        if (lastChunk->size() <= this->lastChunkEnd_)
+        if (this->size_ >= this->limit_)
         {
-            // Last chunk is full, create a new one and rebuild our chunk vector
-            auto newVector = std::make_shared<ChunkVector>();
+            deleted = this->at(0);
+            this->popFront();
+            removedItem = true;
+        }
+
+        this->append(item);
+
+        return removedItem;
+    }
+
+    // appends all items at once, returns the amount of items that were
+    // deleted at the start to make room for them
+    size_t pushBack(const std::vector<T> &items)
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        size_t removedItems = 0;
 
-            // copy chunks
-            for (auto &chunk : *this->chunks_)
+        for (const auto &item : items)
+        {
+            if (this->size_ >= this->limit_)
             {
-                newVector->push_back(chunk);
+                this->popFront();
+                removedItems++;
             }
 
-            // push back new chunk
-            auto newChunk = std::make_shared<Chunk>();
-            newChunk->resize(this->chunkSize_);
-            newVector->push_back(newChunk);
-
-            // replace current chunk vector
-            this->chunks_ = newVector;
-            this->lastChunkEnd_ = 0;
-            lastChunk = this->chunks_->back();
+            this->append(item);
         }
 
-        lastChunk->at(this->lastChunkEnd_++) = item;
-
-        return this->deleteFirstItem(deleted);
+        return removedItems;
     }
 
     // returns a vector with all the accepted items
     std::vector<T> pushFront(const std::vector<T> &items)
     {
-        std::vector<T> acceptedItems;
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        auto accepted =
+            std::min<size_t>(this->limit_ - this->size_, items.size());
 
-        if (this->space() > 0)
+        if (accepted == 0)
         {
-            std::lock_guard<std::mutex> lock(this->mutex_);
+            return {};
+        }
 
-            // create new vector to clone chunks into
-            auto newChunks = std::make_shared<ChunkVector>();
+        auto firstChunk = this->offset_ >> chunkShift;
+        auto liveChunks = this->chunkCount() - firstChunk;
+        auto firstOffset = liveChunks == 0 ? 0 : this->offset_ & chunkMask;
 
-            newChunks->resize(this->chunks_->size());
+        // amount of chunks that need to be added in front of the first one
+        auto frontChunks =
+            accepted > firstOffset
+                ? (accepted - firstOffset + chunkSize - 1) >> chunkShift
+                : 0;
 
-            // copy chunks except for first one
-            for (size_t i = 1; i < this->chunks_->size(); i++)
-            {
-                newChunks->at(i) = this->chunks_->at(i);
-            }
+        // the table is rebuilt so the slots in front of the current start
+        // can be written without being visible in any snapshot
+        auto table = this->makeTable();
 
-            // create new chunk for the first one
-            size_t offset =
-                std::min(this->space(), static_cast<qsizetype>(items.size()));
-            auto newFirstChunk = std::make_shared<Chunk>();
-            newFirstChunk->resize(this->chunks_->front()->size() + offset);
+        for (size_t i = 0; i < frontChunks; i++)
+        {
+            (*table)[i] = std::make_shared<Chunk>();
+        }
 
-            for (size_t i = 0; i < offset; i++)
-            {
-                newFirstChunk->at(i) = items[items.size() - offset + i];
-                acceptedItems.push_back(items[items.size() - offset + i]);
-            }
+        for (size_t i = 0; i < liveChunks; i++)
+        {
+            (*table)[frontChunks + i] = (*this->chunks_)[firstChunk + i];
+        }
 
-            for (size_t i = 0; i < this->chunks_->at(0)->size(); i++)
-            {
-                newFirstChunk->at(i + offset) = this->chunks_->at(0)->at(i);
-            }
+        // slots in front of the first item of the first chunk may have been
+        // visible before, so that chunk has to be copied
+        if (liveChunks != 0 && firstOffset != 0)
+        {
+            (*table)[frontChunks] =
+                std::make_shared<Chunk>(*(*table)[frontChunks]);
+        }
 
-            newChunks->at(0) = newFirstChunk;
+        this->chunks_ = table;
+        this->offset_ = (frontChunks << chunkShift) + firstOffset - accepted;
+        this->size_ += accepted;
 
-            this->chunks_ = newChunks;
+        std::vector<T> acceptedItems(items.end() - accepted, items.end());
 
-            if (this->chunks_->size() == 1)
-            {
-                this->lastChunkEnd_ += offset;
-            }
+        for (size_t i = 0; i < accepted; i++)
+        {
+            auto slot = this->offset_ + i;
+            (*(*this->chunks_)[slot >> chunkShift])[slot & chunkMask] =
+                acceptedItems[i];
         }
 
         return acceptedItems;
@@ -140,34 +167,12 @@ public:
     {
         std::lock_guard<std::mutex> lock(this->mutex_);
 
-        int x = 0;
-
-        for (size_t i = 0; i < this->chunks_->size(); i++)
+        for (size_t i = 0; i < this->size_; i++)
         {
-            auto &chunk = this->chunks_->at(i);
-
-            size_t start = i == 0 ? this->firstChunkOffset_ : 0;
-            size_t end =
-                i == chunk->size() - 1 ? this->lastChunkEnd_ : chunk->size();
-
-            for (size_t j = start; j < end; j++)
+            if (this->at(i) == item)
             {
-                if (chunk->at(j) == item)
-                {
-                    auto newChunk = std::make_shared<Chunk>();
-                    newChunk->resize(chunk->size());
-
-                    for (size_t k = 0; k < chunk->size(); k++)
-                    {
-                        newChunk->at(k) = chunk->at(k);
-                    }
-
-                    newChunk->at(j) = replacement;
-                    this->chunks_->at(i) = newChunk;
-
-                    return x;
-                }
-                x++;
+                this->replaceAt(i, replacement);
+                return int(i);
             }
         }
 
@@ -179,119 +184,175 @@ public:
     {
         std::lock_guard<std::mutex> lock(this->mutex_);
 
-        size_t x = 0;
-
-        for (size_t i = 0; i < this->chunks_->size(); i++)
+        if (index >= this->size_)
         {
-            auto &chunk = this->chunks_->at(i);
-
-            size_t start = i == 0 ? this->firstChunkOffset_ : 0;
-            size_t end =
-                i == chunk->size() - 1 ? this->lastChunkEnd_ : chunk->size();
-
-            for (size_t j = start; j < end; j++)
-            {
-                if (x == index)
-                {
-                    auto newChunk = std::make_shared<Chunk>();
-                    newChunk->resize(chunk->size());
-
-                    for (size_t k = 0; k < chunk->size(); k++)
-                    {
-                        newChunk->at(k) = chunk->at(k);
-                    }
-
-                    newChunk->at(j) = replacement;
-                    this->chunks_->at(i) = newChunk;
-
-                    return true;
-                }
-                x++;
-            }
+            return false;
         }
-        return false;
-    }
 
-    //    void insertAfter(const std::vector<T> &items, const T &index)
+        this->replaceAt(index, replacement);
+        return true;
+    }
 
     LimitedQueueSnapshot<T> getSnapshot()
     {
         std::lock_guard<std::mutex> lock(this->mutex_);
 
-        return LimitedQueueSnapshot<T>(
-            this->chunks_, this->limit_ - this->space(),
-            this->firstChunkOffset_, this->lastChunkEnd_);
+        return LimitedQueueSnapshot<T>(this->chunks_, this->offset_,
+                                       this->size_);
     }
 
     bool empty() const
     {
-        return this->limit_ - this->space() == 0;
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->size_ == 0;
     }
 
-private:
-    qsizetype space() const
+    size_t limit() const
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        return this->limit_;
+    }
+
+    // changes the limit, returns the items that were removed at the start to
+    // fit into a lower one, oldest first
+    std::vector<T> setLimit(size_t limit)
     {
-        size_t totalSize = 0;
-        for (auto &chunk : *this->chunks_)
+        std::lock_guard<std::mutex> lock(this->mutex_);
+
+        std::vector<T> removed;
+        while (this->size_ > limit)
         {
-            totalSize += chunk->size();
+            removed.push_back(this->at(0));
+            this->popFront();
         }
 
-        totalSize -= this->chunks_->back()->size() - this->lastChunkEnd_;
-        if (this->chunks_->size() != 1)
+        this->limit_ = limit;
+
+        // a higher limit can span more chunks than the table has room for
+        auto table = this->makeTable();
+        if (table->size() > this->chunks_->size())
         {
-            totalSize -= this->firstChunkOffset_;
+            auto firstChunk = this->offset_ >> chunkShift;
+            auto liveChunks = this->chunkCount() - firstChunk;
+            std::copy(this->chunks_->begin() + firstChunk,
+                      this->chunks_->begin() + firstChunk + liveChunks,
+                      table->begin());
+            this->chunks_ = table;
+            this->offset_ &= chunkMask;
         }
 
-        return this->limit_ - totalSize;
+        return removed;
     }
 
-    bool deleteFirstItem(T &deleted)
+private:
+    std::shared_ptr<ChunkTable> makeTable() const
     {
-        // determine if the first chunk should be deleted
-        if (space() > 0)
+        // room for all chunks the items can span, and the same amount again
+        // before the table has to be compacted
+        return std::make_shared<ChunkTable>(
+            2 * ((this->limit_ >> chunkShift) + 2));
+    }
+
+    size_t chunkCount() const
+    {
+        return (this->offset_ + this->size_ + chunkMask) >> chunkShift;
+    }
+
+    const T &at(size_t index) const
+    {
+        auto slot = this->offset_ + index;
+        return (*(*this->chunks_)[slot >> chunkShift])[slot & chunkMask];
+    }
+
+    // writes the item past the end, the queue must not be full
+    void append(const T &item)
+    {
+        auto slot = this->offset_ + this->size_;
+
+        // start a new chunk
+        if ((slot & chunkMask) == 0)
         {
-            return false;
+            if ((slot >> chunkShift) >= this->chunks_->size())
+            {
+                this->compact();
+                slot = this->offset_ + this->size_;
+            }
+
+            (*this->chunks_)[slot >> chunkShift] = std::make_shared<Chunk>();
         }
 
-        deleted = this->chunks_->front()->at(this->firstChunkOffset_);
+        (*(*this->chunks_)[slot >> chunkShift])[slot & chunkMask] = item;
+        this->size_++;
+    }
+
+    void popFront()
+    {
+        this->offset_++;
+        this->size_--;
 
-        // need to delete the first chunk
-        if (this->firstChunkOffset_ == this->chunks_->front()->size() - 1)
+        // the first chunk is now unused, release it unless a snapshot might
+        // still be reading from this table
+        if ((this->offset_ & chunkMask) == 0 && this->chunks_.use_count() == 1)
         {
-            // copy the chunk vector
-            auto newVector = std::make_shared<ChunkVector>();
+            (*this->chunks_)[(this->offset_ >> chunkShift) - 1].reset();
+        }
+    }
 
-            // delete first chunk
-            bool first = true;
-            for (auto &chunk : *this->chunks_)
-            {
-                if (!first)
-                {
-                    newVector->push_back(chunk);
-                }
-                first = false;
-            }
+    // moves the live chunks to the start of the table
+    void compact()
+    {
+        auto firstChunk = this->offset_ >> chunkShift;
+        auto liveChunks = this->chunkCount() - firstChunk;
 
-            this->chunks_ = newVector;
-            this->firstChunkOffset_ = 0;
+        if (this->chunks_.use_count() == 1)
+        {
+            std::move(this->chunks_->begin() + firstChunk,
+                      this->chunks_->begin() + firstChunk + liveChunks,
+                      this->chunks_->begin());
+            std::fill(this->chunks_->begin() + liveChunks,
+                      this->chunks_->end(), nullptr);
         }
         else
         {
-            this->firstChunkOffset_++;
+            auto table = this->makeTable();
+            std::copy(this->chunks_->begin() + firstChunk,
+                      this->chunks_->begin() + firstChunk + liveChunks,
+                      table->begin());
+            this->chunks_ = table;
         }
 
-        return true;
+        this->offset_ &= chunkMask;
     }
 
-    std::shared_ptr<ChunkVector> chunks_;
-    std::mutex mutex_;
+    void replaceAt(size_t index, const T &replacement)
+    {
+        auto slot = this->offset_ + index;
+        auto chunkIndex = slot >> chunkShift;
+
+        // snapshots must not see the replacement, copy whatever is shared
+        if (this->chunks_.use_count() != 1)
+        {
+            this->chunks_ = std::make_shared<ChunkTable>(*this->chunks_);
+        }
+
+        auto &chunk = (*this->chunks_)[chunkIndex];
+        if (chunk.use_count() != 1)
+        {
+            chunk = std::make_shared<Chunk>(*chunk);
+        }
+
+        (*chunk)[slot & chunkMask] = replacement;
+    }
 
-    size_t firstChunkOffset_;
-    size_t lastChunkEnd_;
-    const size_t limit_;
+    std::shared_ptr<ChunkTable> chunks_;
+    mutable std::mutex mutex_;
 
-    const size_t chunkSize_ = 100;
+    // absolute slot index of the first item in chunks_
+    size_t offset_ = 0;
+    size_t size_ = 0;
+    size_t limit_;
 };
 
 }  // namespace chatterino
@@ -1,24 +1,187 @@
 #pragma once
 
+#include <array>
 #include <cassert>
+#include <cstddef>
+#include <iterator>
 #include <memory>
 #include <vector>
 
 namespace chatterino {
 
+namespace detail {
+    // Items of a LimitedQueue are stored in chunks with a fixed power-of-two
+    // size, which lets a snapshot resolve any index with a shift and a mask.
+    constexpr size_t limitedQueueChunkShift = 6;
+    constexpr size_t limitedQueueChunkSize = size_t(1)
+                                             << limitedQueueChunkShift;
+    constexpr size_t limitedQueueChunkMask = limitedQueueChunkSize - 1;
+
+    template <typename T>
+    using LimitedQueueChunk = std::array<T, limitedQueueChunkSize>;
+
+    template <typename T>
+    using LimitedQueueChunkTable =
+        std::vector<std::shared_ptr<LimitedQueueChunk<T>>>;
+}  // namespace detail
+
 template <typename T>
 class LimitedQueueSnapshot
 {
 public:
+    /// Random access iterator over the items of a snapshot. It's a slot in
+    /// the chunk table, so stepping and jumping are constant time.
+    class const_iterator
+    {
+    public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T *;
+        using reference = const T &;
+
+        const_iterator() = default;
+
+        reference operator*() const
+        {
+            return (*(*this->chunks_)[this->slot_ >>
+                                      detail::limitedQueueChunkShift])
+                [this->slot_ & detail::limitedQueueChunkMask];
+        }
+
+        pointer operator->() const
+        {
+            return &**this;
+        }
+
+        reference operator[](difference_type n) const
+        {
+            return *(*this + n);
+        }
+
+        const_iterator &operator++()
+        {
+            this->slot_++;
+            return *this;
+        }
+
+        const_iterator operator++(int)
+        {
+            auto copy = *this;
+            this->slot_++;
+            return copy;
+        }
+
+        const_iterator &operator--()
+        {
+            this->slot_--;
+            return *this;
+        }
+
+        const_iterator operator--(int)
+        {
+            auto copy = *this;
+            this->slot_--;
+            return copy;
+        }
+
+        const_iterator &operator+=(difference_type n)
+        {
+            this->slot_ = size_t(difference_type(this->slot_) + n);
+            return *this;
+        }
+
+        const_iterator &operator-=(difference_type n)
+        {
+            return *this += -n;
+        }
+
+        friend const_iterator operator+(const_iterator it, difference_type n)
+        {
+            return it += n;
+        }
+
+        friend const_iterator operator+(difference_type n, const_iterator it)
+        {
+            return it += n;
+        }
+
+        friend const_iterator operator-(const_iterator it, difference_type n)
+        {
+            return it -= n;
+        }
+
+        friend difference_type operator-(const const_iterator &a,
+                                         const const_iterator &b)
+        {
+            return difference_type(a.slot_) - difference_type(b.slot_);
+        }
+
+        friend bool operator==(const const_iterator &a,
+                               const const_iterator &b)
+        {
+            return a.slot_ == b.slot_;
+        }
+
+        friend bool operator!=(const const_iterator &a,
+                               const const_iterator &b)
+        {
+            return a.slot_ != b.slot_;
+        }
+
+        friend bool operator<(const const_iterator &a, const const_iterator &b)
+        {
+            return a.slot_ < b.slot_;
+        }
+
+        friend bool operator>(const const_iterator &a, const const_iterator &b)
+        {
+            return a.slot_ > b.slot_;
+        }
+
+        friend bool operator<=(const const_iterator &a,
+                               const const_iterator &b)
+        {
+            return a.slot_ <= b.slot_;
+        }
+
+        friend bool operator>=(const const_iterator &a,
+                               const const_iterator &b)
+        {
+            return a.slot_ >= b.slot_;
+        }
+
+    private:
+        const_iterator(const detail::LimitedQueueChunkTable<T> *chunks,
+                       size_t slot)
+            : chunks_(chunks)
+            , slot_(slot)
+        {
+        }
+
+        const detail::LimitedQueueChunkTable<T> *chunks_ = nullptr;
+        // absolute slot in the chunk table
+        size_t slot_ = 0;
+
+        friend class LimitedQueueSnapshot;
+    };
+
+    using iterator = const_iterator;
+    using const_reverse_iterator = std::reverse_iterator<const_iterator>;
+
     LimitedQueueSnapshot() = default;
 
+    /**
+     * @param chunks the chunk table of the queue this snapshot was taken from
+     * @param offset the absolute slot index of the first item in the table
+     * @param length the amount of items in this snapshot
+     **/
     LimitedQueueSnapshot(
-        std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> chunks,
-        size_t length, size_t firstChunkOffset, size_t lastChunkEnd)
-        : chunks_(chunks)
+        std::shared_ptr<const detail::LimitedQueueChunkTable<T>> chunks,
+        size_t offset, size_t length)
+        : chunks_(std::move(chunks))
+        , offset_(offset)
         , length_(length)
-        , firstChunkOffset_(firstChunkOffset)
-        , lastChunkEnd_(lastChunkEnd)
     {
     }
 
@@ -29,32 +192,40 @@ public:
 
     T const &operator[](std::size_t index) const
     {
-        index += this->firstChunkOffset_;
+        assert(index < this->length_ && "out of range");
 
-        size_t x = 0;
+        index += this->offset_;
 
-        for (size_t i = 0; i < this->chunks_->size(); i++)
-        {
-            auto &chunk = this->chunks_->at(i);
+        return (*(*this->chunks_)[index >> detail::limitedQueueChunkShift])
+            [index & detail::limitedQueueChunkMask];
+    }
 
-            if (x <= index && x + chunk->size() > index)
-            {
-                return chunk->at(index - x);
-            }
-            x += chunk->size();
-        }
+    const_iterator begin() const
+    {
+        return const_iterator(this->chunks_.get(), this->offset_);
+    }
+
+    const_iterator end() const
+    {
+        return const_iterator(this->chunks_.get(),
+                              this->offset_ + this->length_);
+    }
 
-        assert(false && "out of range");
+    const_reverse_iterator rbegin() const
+    {
+        return const_reverse_iterator(this->end());
+    }
 
-        return this->chunks_->at(0)->at(0);
+    const_reverse_iterator rend() const
+    {
+        return const_reverse_iterator(this->begin());
     }
 
 private:
-    std::shared_ptr<std::vector<std::shared_ptr<std::vector<T>>>> chunks_;
+    std::shared_ptr<const detail::LimitedQueueChunkTable<T>> chunks_;
 
+    size_t offset_ = 0;
     size_t length_ = 0;
-    size_t firstChunkOffset_ = 0;
-    size_t lastChunkEnd_ = 0;
 };
 
 }  // namespace chatterino
@@ -6,20 +6,118 @@
 #include "singletons/Theme.hpp"
 #include "util/DebugCount.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/MemoryUsage.hpp"
+
+#include <algorithm>
 
 using SBHighlight = chatterino::ScrollbarHighlight;
 
 namespace chatterino {
 
+namespace {
+
+    DebugCounter messageCount("messages");
+
+}  // namespace
+
+BadgeSet::BadgeSet(std::vector<Badge> badges_,
+                   boost::container::flat_map<QString, QString> badgeInfos_)
+    : badges(std::move(badges_))
+    , badgeInfos(std::move(badgeInfos_))
+{
+    static const std::pair<BadgeId, BadgeFlag> knownBadges[] = {
+        {badgeId("broadcaster"), BadgeFlag::Broadcaster},
+        {badgeId("moderator"), BadgeFlag::Moderator},
+        {badgeId("vip"), BadgeFlag::Vip},
+        {badgeId("staff"), BadgeFlag::Staff},
+        {badgeId("subscriber"), BadgeFlag::Subscriber},
+        {badgeId("founder"), BadgeFlag::Founder},
+    };
+
+    this->names.reserve(int(this->badges.size()));
+    this->ids.reserve(2 * this->badges.size());
+    for (const auto &badge : this->badges)
+    {
+        this->names << badge.key_;
+        this->ids.push_back(badge.nameId_);
+        this->ids.push_back(badge.tokenId_);
+
+        for (const auto &known : knownBadges)
+        {
+            if (badge.nameId_ == known.first)
+            {
+                this->flags.set(known.second);
+            }
+        }
+    }
+
+    std::sort(this->ids.begin(), this->ids.end());
+    this->ids.erase(std::unique(this->ids.begin(), this->ids.end()),
+                    this->ids.end());
+
+    // founders that are still subscribed have both badge infos, the founder
+    // one is used
+    for (const QString &subBadge : {"subscriber", "founder"})
+    {
+        auto it = this->badgeInfos.find(subBadge);
+        if (this->names.contains(subBadge) && it != this->badgeInfos.end())
+        {
+            this->subMonths = it->second.toInt();
+        }
+    }
+}
+
+bool BadgeSet::hasId(BadgeId id) const
+{
+    return std::binary_search(this->ids.begin(), this->ids.end(), id);
+}
+
+bool BadgeSet::isSubscribed() const
+{
+    return this->flags.hasAny({BadgeFlag::Subscriber, BadgeFlag::Founder});
+}
+
 Message::Message()
     : parseTime(QTime::currentTime())
+    , serverReceivedTime(QDateTime::currentDateTime())
 {
-    DebugCount::increase("messages");
+    static const auto emptyBadgeSet = std::make_shared<const BadgeSet>();
+    this->badgeSet = emptyBadgeSet;
+
+    messageCount.increase();
 }
 
 Message::~Message()
 {
-    DebugCount::decrease("messages");
+    messageCount.decrease();
+
+    if (this->accountedBytes_ != 0)
+    {
+        MemoryUsage::decrease(MemoryCategory::Messages, this->accountedBytes_);
+    }
+}
+
+int64_t Message::bytes() const
+{
+    // the text of the elements is mostly shared with messageText
+    int64_t bytes = sizeof(Message) + int64_t(this->arena.bytes()) +
+                    int64_t(this->elements.capacity() *
+                            sizeof(ArenaPtr<MessageElement>));
+    for (const auto *string :
+         {&this->id, &this->searchText, &this->messageText, &this->loginName,
+          &this->displayName, &this->localizedName, &this->timeoutUser,
+          &this->channelName})
+    {
+        bytes += int64_t(string->capacity()) * int64_t(sizeof(QChar));
+    }
+    return bytes;
+}
+
+void Message::accountMemory()
+{
+    MemoryUsage::decrease(MemoryCategory::Messages, this->accountedBytes_);
+    this->accountedBytes_ = this->bytes();
+    MemoryUsage::increase(MemoryCategory::Messages, this->accountedBytes_);
 }
 
 SBHighlight Message::getScrollBarHighlight() const
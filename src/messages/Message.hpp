@@ -1,10 +1,14 @@
 #pragma once
 
 #include "common/FlagsEnum.hpp"
+#include "messages/MessageArena.hpp"
 #include "providers/twitch/TwitchBadge.hpp"
 #include "widgets/helper/ScrollbarHighlight.hpp"
 
+#include <QDateTime>
+#include <QStringList>
 #include <QTime>
+#include <boost/container/flat_map.hpp>
 #include <boost/noncopyable.hpp>
 #include <cinttypes>
 #include <memory>
@@ -42,6 +46,43 @@ enum class MessageFlag : uint32_t {
 };
 using MessageFlags = FlagsEnum<MessageFlag>;
 
+enum class BadgeFlag : uint16_t {
+    None = 0,
+    Broadcaster = (1 << 0),
+    Moderator = (1 << 1),
+    Vip = (1 << 2),
+    Staff = (1 << 3),
+    Subscriber = (1 << 4),
+    Founder = (1 << 5),
+};
+using BadgeFlags = FlagsEnum<BadgeFlag>;
+
+/// Badges parsed from the tags of a message. Messages with the same badge
+/// tags share one BadgeSet, so what filters and highlights read from the
+/// badges is worked out once when the set is made.
+struct BadgeSet {
+    BadgeSet() = default;
+    BadgeSet(std::vector<Badge> badges_,
+             boost::container::flat_map<QString, QString> badgeInfos_);
+
+    std::vector<Badge> badges;
+    // e.g. "subscriber" -> "12"
+    boost::container::flat_map<QString, QString> badgeInfos;
+
+    // the names of the badges, e.g. "moderator"
+    QStringList names;
+    // name and token ids of all badges, sorted
+    std::vector<BadgeId> ids;
+    BadgeFlags flags;
+    // months of the subscriber or founder badge, 0 if unknown
+    int subMonths = 0;
+
+    /// Has a subscriber or founder badge
+    bool isSubscribed() const;
+    /// Has a badge with the name or token id
+    bool hasId(BadgeId id) const;
+};
+
 struct Message : boost::noncopyable {
     Message();
     ~Message();
@@ -54,6 +95,9 @@ struct Message : boost::noncopyable {
     // This might bring race conditions with it
     mutable MessageFlags flags;
     QTime parseTime;
+    // when the server received the message, orders messages of different
+    // channels
+    QDateTime serverReceivedTime;
     QString id;
     QString searchText;
     QString messageText;
@@ -63,13 +107,26 @@ struct Message : boost::noncopyable {
     QString timeoutUser;
     QString channelName;
     QColor usernameColor;
-    std::vector<Badge> badges;
-    std::map<QString, QString> badgeInfos;
-    std::shared_ptr<QColor> highlightColor;
+    // never null
+    std::shared_ptr<const BadgeSet> badgeSet;
+    // mutable like flags, highlights of messages that were already built are
+    // checked again on the gui thread when the highlight rules change
+    mutable std::shared_ptr<QColor> highlightColor;
     uint32_t count = 1;
-    std::vector<std::unique_ptr<MessageElement>> elements;
+    // Holds the memory of the elements, so it has to be destroyed after them
+    MessageArena arena;
+    std::vector<ArenaPtr<MessageElement>> elements;
 
     ScrollbarHighlight getScrollBarHighlight() const;
+
+    /// Estimate of the memory held by the message and its elements
+    int64_t bytes() const;
+    /// Adds bytes() to the memory usage of messages until the message is
+    /// destroyed, done once it's built
+    void accountMemory();
+
+private:
+    int64_t accountedBytes_ = 0;
 };
 
 using MessagePtr = std::shared_ptr<const Message>;
@@ -0,0 +1,79 @@
+#include "messages/MessageArena.hpp"
+
+#include "util/DebugCount.hpp"
+#include "util/PoolAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+
+namespace chatterino {
+
+MessageArena::~MessageArena()
+{
+    if (this->bytes_ != 0)
+    {
+        DebugCount::decrease("message arena bytes", int64_t(this->bytes_));
+    }
+
+    while (this->chunk_ != nullptr)
+    {
+        auto *previous = this->chunk_->previous;
+        if (this->chunk_->size == firstChunkSize)
+        {
+            BlockPool<firstChunkSize>::deallocate(this->chunk_);
+        }
+        else
+        {
+            ::operator delete(this->chunk_);
+        }
+        this->chunk_ = previous;
+    }
+}
+
+void *MessageArena::allocate(size_t size, size_t alignment)
+{
+    auto align = [&] {
+        auto address = reinterpret_cast<uintptr_t>(this->cursor_);
+        return this->cursor_ + (alignment - address % alignment) % alignment;
+    };
+
+    auto *start = align();
+    if (this->cursor_ == nullptr || start + size > this->end_)
+    {
+        this->addChunk(size + alignment);
+        start = align();
+    }
+
+    this->cursor_ = start + size;
+    return start;
+}
+
+void MessageArena::addChunk(size_t minimumSize)
+{
+    // every chunk is twice as large as the previous one
+    auto size = this->chunk_ == nullptr
+                    ? firstChunkSize
+                    : std::min(this->chunk_->size * 2, maxChunkSize);
+    size = std::max(size, minimumSize + sizeof(Chunk));
+
+    // most messages fit into their first chunk
+    auto *chunk = static_cast<Chunk *>(
+        size == firstChunkSize ? BlockPool<firstChunkSize>::allocate()
+                               : ::operator new(size));
+    chunk->previous = this->chunk_;
+    chunk->size = size;
+
+    this->chunk_ = chunk;
+    this->cursor_ = reinterpret_cast<char *>(chunk + 1);
+    this->end_ = reinterpret_cast<char *>(chunk) + size;
+
+    this->bytes_ += size;
+    DebugCount::increase("message arena bytes", int64_t(size));
+}
+
+size_t MessageArena::bytes() const
+{
+    return this->bytes_;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace chatterino {
+
+/**
+ * @brief Bump allocator for the elements of a single message.
+ *
+ * Objects are placed one after another in a few chunks of growing size, the
+ * chunks are released together when the arena is destroyed. The arena
+ * doesn't run destructors, objects created in it are owned by an ArenaPtr.
+ *
+ * Not thread safe, a message is only built on one thread at a time.
+ */
+class MessageArena : boost::noncopyable
+{
+public:
+    MessageArena() = default;
+    ~MessageArena();
+
+    template <typename T, typename... Args>
+    T *create(Args &&... args)
+    {
+        void *memory = this->allocate(sizeof(T), alignof(T));
+        return new (memory) T(std::forward<Args>(args)...);
+    }
+
+    void *allocate(size_t size, size_t alignment);
+
+    /// Size of all chunks
+    size_t bytes() const;
+
+private:
+    struct Chunk {
+        Chunk *previous;
+        size_t size;
+    };
+
+    static constexpr size_t firstChunkSize = 1024;
+    static constexpr size_t maxChunkSize = 16 * 1024;
+
+    void addChunk(size_t minimumSize);
+
+    Chunk *chunk_ = nullptr;
+    char *cursor_ = nullptr;
+    char *end_ = nullptr;
+    size_t bytes_ = 0;
+};
+
+/// Destroys an object created in a MessageArena, its memory stays with the
+/// arena
+struct ArenaDestroy {
+    template <typename T>
+    void operator()(T *object) const
+    {
+        object->~T();
+    }
+};
+
+template <typename T>
+using ArenaPtr = std::unique_ptr<T, ArenaDestroy>;
+
+}  // namespace chatterino
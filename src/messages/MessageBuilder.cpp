@@ -12,6 +12,7 @@
 #include "singletons/Resources.hpp"
 #include "singletons/Theme.hpp"
 #include "util/FormatTime.hpp"
+#include "util/PoolAllocator.hpp"
 
 #include <QDateTime>
 #include <QImageReader>
@@ -174,7 +175,7 @@ std::pair<MessagePtr, MessagePtr> makeAutomodMessage(
 }
 
 MessageBuilder::MessageBuilder()
-    : message_(std::make_shared<Message>())
+    : message_(makePooledShared<Message>())
 {
 }
 
@@ -451,6 +452,11 @@ Message &MessageBuilder::message()
 
 MessagePtr MessageBuilder::release()
 {
+    if (this->message_)
+    {
+        this->message_->accountMemory();
+    }
+
     std::shared_ptr<Message> ptr;
     this->message_.swap(ptr);
     return ptr;
@@ -461,11 +467,6 @@ std::weak_ptr<Message> MessageBuilder::weakOf()
     return this->message_;
 }
 
-void MessageBuilder::append(std::unique_ptr<MessageElement> element)
-{
-    this->message().elements.push_back(std::move(element));
-}
-
 QString MessageBuilder::matchLink(const QString &string)
 {
     LinkParser linkParser(string);
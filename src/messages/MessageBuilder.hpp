@@ -58,7 +58,6 @@ public:
     MessagePtr release();
     std::weak_ptr<Message> weakOf();
 
-    void append(std::unique_ptr<MessageElement> element);
     QString matchLink(const QString &string);
     void addLink(const QString &origLink, const QString &matchedLink);
 
@@ -68,9 +67,10 @@ public:
         static_assert(std::is_base_of<MessageElement, T>::value,
                       "T must extend MessageElement");
 
-        auto unique = std::make_unique<T>(std::forward<Args>(args)...);
-        auto pointer = unique.get();
-        this->append(std::move(unique));
+        // elements are placed in the arena of the message, see MessageArena
+        auto *pointer =
+            this->message().arena.create<T>(std::forward<Args>(args)...);
+        this->message().elements.emplace_back(pointer);
         return pointer;
     }
 
@@ -0,0 +1,696 @@
+#include "messages/MessageCodec.hpp"
+
+#include "messages/Emote.hpp"
+#include "messages/Image.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+#include "util/PoolAllocator.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+namespace {
+
+    const QByteArray MAGIC("CM");
+
+    // stored in front of every element, don't change the values
+    enum class ElementType : uint8_t {
+        Text = 1,
+        Emote = 2,
+        Badge = 3,
+        ModBadge = 4,
+        VipBadge = 5,
+        FfzBadge = 6,
+        Timestamp = 7,
+        TwitchModeration = 8,
+        Linebreak = 9,
+        ScalingImage = 10,
+        Image = 11,
+    };
+
+    class Writer
+    {
+    public:
+        void varint(uint64_t value)
+        {
+            while (value >= 0x80)
+            {
+                this->data.append(char((value & 0x7f) | 0x80));
+                value >>= 7;
+            }
+            this->data.append(char(value));
+        }
+
+        void signedVarint(int64_t value)
+        {
+            // zigzag, small negative numbers stay small
+            this->varint((uint64_t(value) << 1) ^ uint64_t(value >> 63));
+        }
+
+        void string(const QString &string)
+        {
+            auto utf8 = string.toUtf8();
+            this->varint(uint64_t(utf8.size()));
+            this->data.append(utf8);
+        }
+
+        void color(const QColor &color)
+        {
+            // 0 is an invalid color
+            this->varint(color.isValid() ? uint64_t(color.rgba()) + 1 : 0);
+        }
+
+        void time(const QTime &time)
+        {
+            this->varint(
+                time.isValid() ? uint64_t(time.msecsSinceStartOfDay()) + 1 : 0);
+        }
+
+        void image(const ImagePtr &image)
+        {
+            if (!image || image->isEmpty() || image->url().string.isEmpty())
+            {
+                this->string({});
+                return;
+            }
+
+            this->string(image->url().string);
+            this->varint(uint64_t(qRound(image->scale() * 1000)));
+        }
+
+        void imageSet(const ImageSet &images)
+        {
+            this->image(images.getImage1());
+            this->image(images.getImage2());
+            this->image(images.getImage3());
+        }
+
+        void link(const Link &link)
+        {
+            this->varint(uint64_t(link.type));
+            if (link.type != Link::None)
+            {
+                this->string(link.value);
+            }
+        }
+
+        void messageColor(const MessageColor &color)
+        {
+            this->varint(uint64_t(color.getType()));
+            if (color.getType() == MessageColor::Custom)
+            {
+                this->color(color.getCustomColor());
+            }
+        }
+
+        QByteArray data;
+    };
+
+    class Reader
+    {
+    public:
+        explicit Reader(const QByteArray &data)
+            : pos_(data.constData())
+            , end_(data.constData() + data.size())
+        {
+        }
+
+        bool ok() const
+        {
+            return this->ok_;
+        }
+
+        bool atEnd() const
+        {
+            return this->pos_ == this->end_;
+        }
+
+        void fail()
+        {
+            this->ok_ = false;
+            this->pos_ = this->end_;
+        }
+
+        uint64_t varint()
+        {
+            uint64_t value = 0;
+            for (int shift = 0; shift < 64; shift += 7)
+            {
+                if (this->pos_ == this->end_)
+                {
+                    this->fail();
+                    return 0;
+                }
+
+                auto byte = uint8_t(*this->pos_++);
+                value |= uint64_t(byte & 0x7f) << shift;
+                if ((byte & 0x80) == 0)
+                {
+                    return value;
+                }
+            }
+
+            this->fail();
+            return 0;
+        }
+
+        int64_t signedVarint()
+        {
+            auto value = this->varint();
+            return int64_t(value >> 1) ^ -int64_t(value & 1);
+        }
+
+        // fails if the value is bigger than max
+        uint64_t bounded(uint64_t max)
+        {
+            auto value = this->varint();
+            if (value > max)
+            {
+                this->fail();
+                return 0;
+            }
+            return value;
+        }
+
+        // fails if the data doesn't continue with prefix
+        void expect(const QByteArray &prefix)
+        {
+            if (uint64_t(this->end_ - this->pos_) < uint64_t(prefix.size()) ||
+                QByteArray::fromRawData(this->pos_, prefix.size()) != prefix)
+            {
+                this->fail();
+                return;
+            }
+            this->pos_ += prefix.size();
+        }
+
+        QString string()
+        {
+            auto size = this->bounded(uint64_t(this->end_ - this->pos_));
+            auto string = QString::fromUtf8(this->pos_, int(size));
+            this->pos_ += size;
+            return string;
+        }
+
+        QColor color()
+        {
+            auto value = this->bounded(uint64_t(UINT32_MAX) + 1);
+            return value == 0 ? QColor() : QColor::fromRgba(QRgb(value - 1));
+        }
+
+        QTime time()
+        {
+            auto value = this->bounded(24 * 60 * 60 * 1000);
+            return value == 0 ? QTime() : QTime::fromMSecsSinceStartOfDay(
+                                              int(value - 1));
+        }
+
+        ImagePtr image()
+        {
+            auto url = this->string();
+            if (url.isEmpty())
+            {
+                return Image::getEmpty();
+            }
+
+            auto scale = this->bounded(1000 * 1000);
+            return Image::fromUrl(Url{url}, qreal(scale) / 1000);
+        }
+
+        ImageSet imageSet()
+        {
+            auto image1 = this->image();
+            auto image2 = this->image();
+            auto image3 = this->image();
+            return ImageSet(image1, image2, image3);
+        }
+
+        Link link()
+        {
+            auto type = Link::Type(this->bounded(Link::CopyToClipboard));
+            if (type == Link::None)
+            {
+                return Link();
+            }
+            return Link(type, this->string());
+        }
+
+        MessageColor messageColor()
+        {
+            auto type = MessageColor::Type(this->bounded(MessageColor::System));
+            if (type == MessageColor::Custom)
+            {
+                return MessageColor(this->color());
+            }
+            return MessageColor(type);
+        }
+
+    private:
+        const char *pos_;
+        const char *end_;
+        bool ok_ = true;
+    };
+
+    ElementType writtenType(const MessageElement *element)
+    {
+        // derived types first
+        if (dynamic_cast<const ModBadgeElement *>(element))
+        {
+            return ElementType::ModBadge;
+        }
+        if (dynamic_cast<const VipBadgeElement *>(element))
+        {
+            return ElementType::VipBadge;
+        }
+        if (dynamic_cast<const FfzBadgeElement *>(element))
+        {
+            return ElementType::FfzBadge;
+        }
+        if (dynamic_cast<const BadgeElement *>(element))
+        {
+            return ElementType::Badge;
+        }
+        if (dynamic_cast<const EmoteElement *>(element))
+        {
+            return ElementType::Emote;
+        }
+        if (dynamic_cast<const TextElement *>(element))
+        {
+            return ElementType::Text;
+        }
+        if (dynamic_cast<const TimestampElement *>(element))
+        {
+            return ElementType::Timestamp;
+        }
+        if (dynamic_cast<const TwitchModerationElement *>(element))
+        {
+            return ElementType::TwitchModeration;
+        }
+        if (dynamic_cast<const LinebreakElement *>(element))
+        {
+            return ElementType::Linebreak;
+        }
+        if (dynamic_cast<const ScalingImageElement *>(element))
+        {
+            return ElementType::ScalingImage;
+        }
+        if (dynamic_cast<const ImageElement *>(element))
+        {
+            return ElementType::Image;
+        }
+        return ElementType(0);
+    }
+
+    EmotePtr elementEmote(const MessageElement *element, ElementType type)
+    {
+        switch (type)
+        {
+            case ElementType::Emote:
+                return static_cast<const EmoteElement *>(element)->getEmote();
+            case ElementType::Badge:
+            case ElementType::ModBadge:
+            case ElementType::VipBadge:
+            case ElementType::FfzBadge:
+                return static_cast<const BadgeElement *>(element)->getEmote();
+            default:
+                return nullptr;
+        }
+    }
+
+    void writeElement(Writer &writer, const MessageElement *element,
+                      ElementType type, uint64_t emoteIndex)
+    {
+        writer.varint(uint64_t(type));
+        writer.signedVarint(int64_t(element->getFlags().value()));
+        writer.link(element->getLink());
+        writer.string(element->getTooltip());
+        writer.varint(element->hasTrailingSpace() ? 1 : 0);
+        writer.image(element->getThumbnail());
+        writer.varint(uint8_t(element->getThumbnailType()));
+
+        switch (type)
+        {
+            case ElementType::Text: {
+                const auto *text = static_cast<const TextElement *>(element);
+                writer.string(text->getWords());
+                writer.messageColor(text->getColor());
+                writer.varint(uint64_t(text->getStyle()));
+            }
+            break;
+
+            case ElementType::Emote:
+                writer.varint(emoteIndex);
+                writer.messageColor(
+                    static_cast<const EmoteElement *>(element)->getTextColor());
+                break;
+
+            case ElementType::Badge:
+            case ElementType::ModBadge:
+            case ElementType::VipBadge:
+                writer.varint(emoteIndex);
+                break;
+
+            case ElementType::FfzBadge:
+                writer.varint(emoteIndex);
+                writer.color(
+                    static_cast<const FfzBadgeElement *>(element)->getColor());
+                break;
+
+            case ElementType::Timestamp:
+                writer.time(
+                    static_cast<const TimestampElement *>(element)->getTime());
+                break;
+
+            case ElementType::ScalingImage:
+                writer.imageSet(
+                    static_cast<const ScalingImageElement *>(element)
+                        ->getImages());
+                break;
+
+            case ElementType::Image:
+                writer.image(
+                    static_cast<const ImageElement *>(element)->getImage());
+                break;
+
+            case ElementType::TwitchModeration:
+            case ElementType::Linebreak:
+                break;
+        }
+    }
+
+    // nullptr if the element is invalid
+    MessageElement *readElement(Reader &reader, Message &message,
+                                const std::vector<EmotePtr> &emotes)
+    {
+        auto type = ElementType(reader.bounded(uint64_t(ElementType::Image)));
+        auto flags =
+            MessageElementFlags(MessageElementFlag(reader.signedVarint()));
+        auto link = reader.link();
+        auto tooltip = reader.string();
+        auto trailingSpace = reader.varint() != 0;
+        auto thumbnail = reader.image();
+        auto thumbnailType =
+            MessageElement::ThumbnailType(reader.bounded(UINT8_MAX));
+
+        auto emote = [&]() -> EmotePtr {
+            auto index = reader.bounded(emotes.size());
+            if (index >= emotes.size())
+            {
+                reader.fail();
+                return nullptr;
+            }
+            return emotes[index];
+        };
+
+        auto &arena = message.arena;
+        MessageElement *element = nullptr;
+        switch (type)
+        {
+            case ElementType::Text: {
+                auto words = reader.string();
+                auto color = reader.messageColor();
+                auto style = FontStyle(
+                    reader.bounded(uint64_t(FontStyle::EndType) - 1));
+                element = arena.create<TextElement>(words, flags, color, style);
+            }
+            break;
+
+            case ElementType::Emote: {
+                auto data = emote();
+                auto color = reader.messageColor();
+                if (data)
+                {
+                    element = arena.create<EmoteElement>(data, flags, color);
+                }
+            }
+            break;
+
+            case ElementType::Badge:
+                if (auto data = emote())
+                {
+                    element = arena.create<BadgeElement>(data, flags);
+                }
+                break;
+
+            case ElementType::ModBadge:
+                if (auto data = emote())
+                {
+                    element = arena.create<ModBadgeElement>(data, flags);
+                }
+                break;
+
+            case ElementType::VipBadge:
+                if (auto data = emote())
+                {
+                    element = arena.create<VipBadgeElement>(data, flags);
+                }
+                break;
+
+            case ElementType::FfzBadge: {
+                auto data = emote();
+                auto color = reader.color();
+                if (data)
+                {
+                    element = arena.create<FfzBadgeElement>(data, flags, color);
+                }
+            }
+            break;
+
+            case ElementType::Timestamp:
+                element = arena.create<TimestampElement>(reader.time());
+                break;
+
+            case ElementType::TwitchModeration:
+                element = arena.create<TwitchModerationElement>();
+                break;
+
+            case ElementType::Linebreak:
+                element = arena.create<LinebreakElement>(flags);
+                break;
+
+            case ElementType::ScalingImage:
+                element =
+                    arena.create<ScalingImageElement>(reader.imageSet(), flags);
+                break;
+
+            case ElementType::Image:
+                element = arena.create<ImageElement>(reader.image(), flags);
+                break;
+
+            default:
+                reader.fail();
+                return nullptr;
+        }
+
+        if (element == nullptr)
+        {
+            return nullptr;
+        }
+
+        element->setLink(link);
+        element->setTooltip(tooltip);
+        element->setTrailingSpace(trailingSpace);
+        if (!thumbnail->isEmpty())
+        {
+            element->setThumbnail(thumbnail);
+            element->setThumbnailType(thumbnailType);
+        }
+        return element;
+    }
+
+    void writeBadgeSet(Writer &writer, const BadgeSet &badgeSet)
+    {
+        writer.varint(badgeSet.badges.size());
+        for (const auto &badge : badgeSet.badges)
+        {
+            writer.string(badge.key_);
+            writer.string(badge.value_);
+            writer.string(badge.extraValue_);
+            writer.signedVarint(int64_t(badge.flag_));
+        }
+
+        writer.varint(badgeSet.badgeInfos.size());
+        for (const auto &[key, value] : badgeSet.badgeInfos)
+        {
+            writer.string(key);
+            writer.string(value);
+        }
+    }
+
+    std::shared_ptr<const BadgeSet> readBadgeSet(Reader &reader)
+    {
+        std::vector<Badge> badges;
+        auto badgeCount = reader.bounded(UINT16_MAX);
+        for (uint64_t i = 0; i < badgeCount && reader.ok(); i++)
+        {
+            auto key = reader.string();
+            auto value = reader.string();
+            Badge badge(key, value);
+            badge.extraValue_ = reader.string();
+            badge.flag_ = MessageElementFlag(reader.signedVarint());
+            badges.push_back(std::move(badge));
+        }
+
+        boost::container::flat_map<QString, QString> badgeInfos;
+        auto infoCount = reader.bounded(UINT16_MAX);
+        for (uint64_t i = 0; i < infoCount && reader.ok(); i++)
+        {
+            auto key = reader.string();
+            badgeInfos[key] = reader.string();
+        }
+
+        return std::make_shared<const BadgeSet>(std::move(badges),
+                                                std::move(badgeInfos));
+    }
+
+}  // namespace
+
+QByteArray encodeMessage(const Message &message)
+{
+    Writer writer;
+    writer.data.append(MAGIC);
+    writer.varint(MESSAGE_CODEC_VERSION);
+
+    writer.varint(uint64_t(message.flags.value()));
+    writer.time(message.parseTime);
+    writer.varint(message.serverReceivedTime.isValid() ? 1 : 0);
+    if (message.serverReceivedTime.isValid())
+    {
+        writer.signedVarint(message.serverReceivedTime.toMSecsSinceEpoch());
+    }
+    writer.string(message.id);
+    writer.string(message.searchText);
+    writer.string(message.messageText);
+    writer.string(message.loginName);
+    writer.string(message.displayName);
+    writer.string(message.localizedName);
+    writer.string(message.timeoutUser);
+    writer.string(message.channelName);
+    writer.color(message.usernameColor);
+    writer.color(message.highlightColor ? *message.highlightColor : QColor());
+    writer.varint(message.count);
+    writeBadgeSet(writer, *message.badgeSet);
+
+    // emotes are written once, elements refer to them by index
+    std::vector<ElementType> types;
+    std::vector<uint64_t> emoteIndices;
+    std::vector<EmotePtr> emotes;
+    std::unordered_map<const Emote *, uint64_t> emoteIndex;
+    for (const auto &element : message.elements)
+    {
+        auto type = writtenType(element.get());
+        types.push_back(type);
+
+        auto emote = elementEmote(element.get(), type);
+        if (!emote)
+        {
+            emoteIndices.push_back(0);
+            continue;
+        }
+
+        auto it = emoteIndex.find(emote.get());
+        if (it == emoteIndex.end())
+        {
+            it = emoteIndex.emplace(emote.get(), emotes.size()).first;
+            emotes.push_back(emote);
+        }
+        emoteIndices.push_back(it->second);
+    }
+
+    writer.varint(emotes.size());
+    for (const auto &emote : emotes)
+    {
+        writer.string(emote->name.string);
+        writer.string(emote->tooltip.string);
+        writer.string(emote->homePage.string);
+        writer.imageSet(emote->images);
+    }
+
+    writer.varint(uint64_t(
+        std::count_if(types.begin(), types.end(), [](ElementType type) {
+            return type != ElementType(0);
+        })));
+    for (size_t i = 0; i < message.elements.size(); i++)
+    {
+        if (types[i] != ElementType(0))
+        {
+            writeElement(writer, message.elements[i].get(), types[i],
+                         emoteIndices[i]);
+        }
+    }
+
+    return writer.data;
+}
+
+MessagePtr decodeMessage(const QByteArray &data)
+{
+    Reader reader(data);
+    reader.expect(MAGIC);
+    if (!reader.ok() || reader.varint() != MESSAGE_CODEC_VERSION)
+    {
+        return nullptr;
+    }
+
+    auto message = makePooledShared<Message>();
+    message->flags = MessageFlags(MessageFlag(reader.bounded(UINT32_MAX)));
+    message->parseTime = reader.time();
+    if (reader.varint() != 0)
+    {
+        message->serverReceivedTime =
+            QDateTime::fromMSecsSinceEpoch(reader.signedVarint());
+    }
+    message->id = reader.string();
+    message->searchText = reader.string();
+    message->messageText = reader.string();
+    message->loginName = reader.string();
+    message->displayName = reader.string();
+    message->localizedName = reader.string();
+    message->timeoutUser = reader.string();
+    message->channelName = reader.string();
+    message->usernameColor = reader.color();
+    auto highlightColor = reader.color();
+    if (highlightColor.isValid())
+    {
+        message->highlightColor = std::make_shared<QColor>(highlightColor);
+    }
+    message->count = uint32_t(reader.bounded(UINT32_MAX));
+    message->badgeSet = readBadgeSet(reader);
+
+    std::vector<EmotePtr> emotes;
+    auto emoteCount = reader.bounded(uint64_t(data.size()));
+    for (uint64_t i = 0; i < emoteCount && reader.ok(); i++)
+    {
+        Emote emote;
+        emote.name = EmoteName{reader.string()};
+        emote.tooltip = Tooltip{reader.string()};
+        emote.homePage = Url{reader.string()};
+        emote.images = reader.imageSet();
+        emotes.push_back(std::make_shared<const Emote>(std::move(emote)));
+    }
+
+    auto elementCount = reader.bounded(uint64_t(data.size()));
+    message->elements.reserve(size_t(elementCount));
+    for (uint64_t i = 0; i < elementCount && reader.ok(); i++)
+    {
+        auto *element = readElement(reader, *message, emotes);
+        if (element == nullptr)
+        {
+            return nullptr;
+        }
+        message->elements.emplace_back(element);
+    }
+
+    if (!reader.ok() || !reader.atEnd())
+    {
+        return nullptr;
+    }
+
+    message->accountMemory();
+    return message;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QByteArray>
+
+#include <memory>
+
+namespace chatterino {
+
+struct Message;
+using MessagePtr = std::shared_ptr<const Message>;
+
+/// Version of the format written by encodeMessage, bump it whenever the
+/// format changes. Older versions aren't read, messages are rebuilt from
+/// their source then.
+constexpr int MESSAGE_CODEC_VERSION = 1;
+
+/**
+ * @brief Encodes a built message with its elements.
+ *
+ * The format is a short header with the version followed by the fields of
+ * the message, varints for numbers and UTF-8 for strings. Emotes are written
+ * once per message as names, tooltips and image urls, elements refer to them
+ * by index. Images that don't have a url, like pixmaps from the resources,
+ * are written as empty images. Elements of types the codec doesn't know are
+ * left out.
+ */
+QByteArray encodeMessage(const Message &message);
+
+/// Decodes a message written by encodeMessage. The images of emotes and
+/// badges are shared with the ones already loaded. Returns nullptr if the
+/// data is cut off, corrupt or of another version. Can be called from any
+/// thread.
+MessagePtr decodeMessage(const QByteArray &data);
+
+}  // namespace chatterino
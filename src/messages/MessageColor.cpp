@@ -33,4 +33,14 @@ const QColor &MessageColor::getColor(Theme &themeManager) const
     return _default;
 }
 
+MessageColor::Type MessageColor::getType() const
+{
+    return this->type_;
+}
+
+const QColor &MessageColor::getCustomColor() const
+{
+    return this->customColor_;
+}
+
 }  // namespace chatterino
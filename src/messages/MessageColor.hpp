@@ -13,6 +13,10 @@ struct MessageColor {
 
     const QColor &getColor(Theme &themeManager) const;
 
+    Type getType() const;
+    /// Only used if the type is Custom
+    const QColor &getCustomColor() const;
+
 private:
     Type type_;
     QColor customColor_;
@@ -5,21 +5,66 @@
 #include "messages/Emote.hpp"
 #include "messages/layouts/MessageLayoutContainer.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
+#include "messages/layouts/ModerationButtonStrip.hpp"
+#include "providers/twitch/TwitchEmotes.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "util/DebugCount.hpp"
 
+#include <mutex>
+#include <unordered_map>
+
 namespace chatterino {
 
+namespace {
+
+    DebugCounter elementCount("message elements");
+
+    // Messages of the same second share one timestamp string, and with it
+    // one cached width
+    QString formatTimestamp(const QTime &time, const QString &format)
+    {
+        // the cache starts over once it holds this many seconds
+        constexpr size_t maxCachedSeconds = 4096;
+
+        static QLocale locale("en_US");
+        static std::mutex mutex;
+        static QString cachedFormat;
+        static std::unordered_map<int, QString> cache;
+
+        // milliseconds never show up in the timestamps
+        auto second = time.msecsSinceStartOfDay() / 1000;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        if (format != cachedFormat || cache.size() >= maxCachedSeconds)
+        {
+            cachedFormat = format;
+            cache.clear();
+        }
+
+        auto it = cache.find(second);
+        if (it != cache.end())
+        {
+            return it->second;
+        }
+
+        auto text = locale.toString(time, format);
+        cache.emplace(second, text);
+        return text;
+    }
+
+}  // namespace
+
 MessageElement::MessageElement(MessageElementFlags flags)
     : flags_(flags)
 {
-    DebugCount::increase("message elements");
+    elementCount.increase();
 }
 
 MessageElement::~MessageElement()
 {
-    DebugCount::decrease("message elements");
+    elementCount.decrease();
 }
 
 MessageElement *MessageElement::setLink(const Link &link)
@@ -94,6 +139,16 @@ MessageElement *MessageElement::updateLink()
     return this;
 }
 
+void MessageElement::addCopyText(QString & /*str*/,
+                                 MessageElementFlags /*flags*/) const
+{
+}
+
+void MessageElement::prefetchImages(float /*scale*/,
+                                    MessageElementFlags /*flags*/) const
+{
+}
+
 // Empty
 EmptyElement::EmptyElement()
     : MessageElement(MessageElementFlag::None)
@@ -119,6 +174,20 @@ ImageElement::ImageElement(ImagePtr image, MessageElementFlags flags)
     //    this->setTooltip(image->getTooltip());
 }
 
+void ImageElement::prefetchImages(float /*scale*/,
+                                  MessageElementFlags flags) const
+{
+    if (flags.hasAny(this->getFlags()))
+    {
+        this->image_->load();
+    }
+}
+
+const ImagePtr &ImageElement::getImage() const
+{
+    return this->image_;
+}
+
 void ImageElement::addToContainer(MessageLayoutContainer &container,
                                   MessageElementFlags flags)
 {
@@ -144,11 +213,26 @@ EmoteElement::EmoteElement(const EmotePtr &emote, MessageElementFlags flags,
     this->setTooltip(emote->tooltip.string);
 }
 
+void EmoteElement::prefetchImages(float scale,
+                                  MessageElementFlags flags) const
+{
+    if (flags.hasAny(this->getFlags()) &&
+        flags.has(MessageElementFlag::EmoteImages))
+    {
+        this->emote_->images.getImage(scale)->load();
+    }
+}
+
 EmotePtr EmoteElement::getEmote() const
 {
     return this->emote_;
 }
 
+const MessageColor &EmoteElement::getTextColor() const
+{
+    return this->textElement_->getColor();
+}
+
 void EmoteElement::addToContainer(MessageLayoutContainer &container,
                                   MessageElementFlags flags)
 {
@@ -161,7 +245,7 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container,
             if (image->isEmpty())
                 return;
 
-            auto emoteScale = getSettings()->emoteScale.getValue();
+            auto emoteScale = container.getSettings().emoteScale;
 
             auto size =
                 QSize(int(container.getScale() * image->width() * emoteScale),
@@ -181,6 +265,28 @@ void EmoteElement::addToContainer(MessageLayoutContainer &container,
     }
 }
 
+void EmoteElement::addCopyText(QString &str, MessageElementFlags flags) const
+{
+    if (!flags.hasAny(this->getFlags()))
+    {
+        return;
+    }
+
+    // same as ImageLayoutElement::addCopyTextToString
+    if (flags.has(MessageElementFlag::EmoteImages))
+    {
+        str += TwitchEmotes::cleanUpEmoteCode(this->emote_->getCopyString());
+        if (this->hasTrailingSpace())
+        {
+            str += ' ';
+        }
+    }
+    else if (this->textElement_)
+    {
+        this->textElement_->addCopyText(str, MessageElementFlag::Misc);
+    }
+}
+
 MessageLayoutElement *EmoteElement::makeImageLayoutElement(
     const ImagePtr &image, const QSize &size)
 {
@@ -212,6 +318,15 @@ void BadgeElement::addToContainer(MessageLayoutContainer &container,
     }
 }
 
+void BadgeElement::prefetchImages(float scale,
+                                  MessageElementFlags flags) const
+{
+    if (flags.hasAny(this->getFlags()))
+    {
+        this->emote_->images.getImage(scale)->load();
+    }
+}
+
 EmotePtr BadgeElement::getEmote() const
 {
     return this->emote_;
@@ -269,6 +384,11 @@ FfzBadgeElement::FfzBadgeElement(const EmotePtr &data,
     this->color = color;
 }
 
+const QColor &FfzBadgeElement::getColor() const
+{
+    return this->color;
+}
+
 MessageLayoutElement *FfzBadgeElement::makeImageLayoutElement(
     const ImagePtr &image, const QSize &size)
 {
@@ -286,6 +406,13 @@ TextElement::TextElement(const QString &text, MessageElementFlags flags,
     , color_(color)
     , style_(style)
 {
+    // most elements are a single word, they share the string they're made of
+    if (!text.contains(' '))
+    {
+        this->words_.push_back({text, -1});
+        return;
+    }
+
     for (const auto &word : text.split(' '))
     {
         this->words_.push_back({word, -1});
@@ -293,6 +420,30 @@ TextElement::TextElement(const QString &text, MessageElementFlags flags,
     }
 }
 
+QString TextElement::getWords() const
+{
+    QString text;
+    for (const auto &word : this->words_)
+    {
+        if (&word != &this->words_.front())
+        {
+            text += ' ';
+        }
+        text += word.text;
+    }
+    return text;
+}
+
+const MessageColor &TextElement::getColor() const
+{
+    return this->color_;
+}
+
+FontStyle TextElement::getStyle() const
+{
+    return this->style_;
+}
+
 void TextElement::addToContainer(MessageLayoutContainer &container,
                                  MessageElementFlags flags)
 {
@@ -303,13 +454,14 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
         QFontMetrics metrics =
             app->fonts->getFontMetrics(this->style_, container.getScale());
 
+        // the same for all words
+        auto color = this->color_.getColor(*app->themes);
+        app->themes->normalizeColor(color);
+
         for (Word &word : this->words_)
         {
             auto getTextLayoutElement = [&](QString text, int width,
                                             bool hasTrailingSpace) {
-                auto color = this->color_.getColor(*app->themes);
-                app->themes->normalizeColor(color);
-
                 auto e = (new TextLayoutElement(
                               *this, text, QSize(width, metrics.height()),
                               color, this->style_, container.getScale()))
@@ -326,10 +478,8 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 return e;
             };
 
-            // fourtf: add again
-            //            if (word.width == -1) {
-            word.width = metrics.horizontalAdvance(word.text);
-            //            }
+            word.width = app->fonts->horizontalAdvance(
+                this->style_, container.getScale(), word.text);
 
             // see if the text fits in the current line
             if (container.fitsInLine(word.width))
@@ -355,6 +505,7 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
             // we done goofed, we need to wrap the text
             QString text = word.text;
             int textLength = text.length();
+            auto scale = container.getScale();
             int wordStart = 0;
             int width = 0;
 
@@ -365,9 +516,11 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
                 auto isSurrogate = text.size() > i + 1 &&
                                    QChar::isHighSurrogate(text[i].unicode());
 
-                auto charWidth = isSurrogate
-                                     ? metrics.horizontalAdvance(text.mid(i, 2))
-                                     : metrics.horizontalAdvance(text[i]);
+                auto charWidth =
+                    isSurrogate ? app->fonts->horizontalAdvance(
+                                      this->style_, scale, text.mid(i, 2))
+                                : app->fonts->horizontalAdvance(
+                                      this->style_, scale, text[i]);
 
                 if (!container.fitsInLine(width + charWidth))
                 {
@@ -395,38 +548,70 @@ void TextElement::addToContainer(MessageLayoutContainer &container,
     }
 }
 
+void TextElement::addCopyText(QString &str, MessageElementFlags flags) const
+{
+    if (!flags.hasAny(this->getFlags()))
+    {
+        return;
+    }
+
+    // every word is laid out with the trailing space of the element
+    for (const auto &word : this->words_)
+    {
+        str += word.text;
+        if (this->hasTrailingSpace())
+        {
+            str += ' ';
+        }
+    }
+}
+
 // TIMESTAMP
 TimestampElement::TimestampElement(QTime time)
     : MessageElement(MessageElementFlag::Timestamp)
     , time_(time)
-    , element_(this->formatTime(time))
+    , format_(getSettings()->layoutSettings()->timestampFormat)
 {
+    this->element_.reset(this->formatTime(time, this->format_));
     assert(this->element_ != nullptr);
 }
 
+QTime TimestampElement::getTime() const
+{
+    return this->time_;
+}
+
 void TimestampElement::addToContainer(MessageLayoutContainer &container,
                                       MessageElementFlags flags)
 {
     if (flags.hasAny(this->getFlags()))
     {
-        if (getSettings()->timestampFormat != this->format_)
+        const auto &format = container.getSettings().timestampFormat;
+        if (format != this->format_)
         {
-            this->format_ = getSettings()->timestampFormat.getValue();
-            this->element_.reset(this->formatTime(this->time_));
+            this->format_ = format;
+            this->element_.reset(this->formatTime(this->time_, format));
         }
 
         this->element_->addToContainer(container, flags);
     }
 }
 
-TextElement *TimestampElement::formatTime(const QTime &time)
+void TimestampElement::addCopyText(QString &str,
+                                   MessageElementFlags flags) const
 {
-    static QLocale locale("en_US");
-
-    QString format = locale.toString(time, getSettings()->timestampFormat);
+    if (flags.hasAny(this->getFlags()))
+    {
+        this->element_->addCopyText(str, flags);
+    }
+}
 
-    return new TextElement(format, MessageElementFlag::Timestamp,
-                           MessageColor::System, FontStyle::ChatMedium);
+TextElement *TimestampElement::formatTime(const QTime &time,
+                                          const QString &format)
+{
+    return new TextElement(formatTimestamp(time, format),
+                           MessageElementFlag::Timestamp, MessageColor::System,
+                           FontStyle::ChatMedium);
 }
 
 // TWITCH MODERATION
@@ -440,25 +625,12 @@ void TwitchModerationElement::addToContainer(MessageLayoutContainer &container,
 {
     if (flags.has(MessageElementFlag::ModeratorTools))
     {
-        QSize size(int(container.getScale() * 16),
-                   int(container.getScale() * 16));
-        auto actions = getCSettings().moderationActions.readOnly();
-        for (const auto &action : *actions)
+        auto strip = ModerationButtonStrip::get(container.getScale(),
+                                                container.getSpaceWidth());
+        if (strip)
         {
-            if (auto image = action.getImage())
-            {
-                container.addElement(
-                    (new ImageLayoutElement(*this, image.get(), size))
-                        ->setLink(Link(Link::UserAction, action.getAction())));
-            }
-            else
-            {
-                container.addElement(
-                    (new TextIconLayoutElement(*this, action.getLine1(),
-                                               action.getLine2(),
-                                               container.getScale(), size))
-                        ->setLink(Link(Link::UserAction, action.getAction())));
-            }
+            container.addElement(
+                new ModerationButtonsLayoutElement(*this, std::move(strip)));
         }
     }
 }
@@ -484,6 +656,20 @@ ScalingImageElement::ScalingImageElement(ImageSet images,
 {
 }
 
+void ScalingImageElement::prefetchImages(float scale,
+                                         MessageElementFlags flags) const
+{
+    if (flags.hasAny(this->getFlags()))
+    {
+        this->images_.getImage(scale)->load();
+    }
+}
+
+const ImageSet &ScalingImageElement::getImages() const
+{
+    return this->images_;
+}
+
 void ScalingImageElement::addToContainer(MessageLayoutContainer &container,
                                          MessageElementFlags flags)
 {
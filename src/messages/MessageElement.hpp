@@ -165,6 +165,12 @@ public:
 
     virtual void addToContainer(MessageLayoutContainer &container,
                                 MessageElementFlags flags) = 0;
+    /// Adds the text that copying the element laid out with flags gives,
+    /// without laying it out. Elements without text add nothing.
+    virtual void addCopyText(QString &str, MessageElementFlags flags) const;
+    /// Starts loading the images the element would show if it was laid out
+    /// with scale and flags. Elements without images load nothing.
+    virtual void prefetchImages(float scale, MessageElementFlags flags) const;
 
     pajlada::Signals::NoArgSignal linkChanged;
 
@@ -204,6 +210,9 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags) override;
+    void prefetchImages(float scale, MessageElementFlags flags) const override;
+
+    const ImagePtr &getImage() const;
 
 private:
     ImagePtr image_;
@@ -220,6 +229,12 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags) override;
+    void addCopyText(QString &str, MessageElementFlags flags) const override;
+
+    /// The words joined by spaces, what the element was made from
+    QString getWords() const;
+    const MessageColor &getColor() const;
+    FontStyle getStyle() const;
 
 private:
     MessageColor color_;
@@ -243,7 +258,11 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags_) override;
+    void addCopyText(QString &str, MessageElementFlags flags) const override;
+    void prefetchImages(float scale, MessageElementFlags flags) const override;
     EmotePtr getEmote() const;
+    /// Color of the text shown instead of the emote
+    const MessageColor &getTextColor() const;
 
 protected:
     virtual MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
@@ -261,6 +280,7 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags_) override;
+    void prefetchImages(float scale, MessageElementFlags flags) const override;
 
     EmotePtr getEmote() const;
 
@@ -298,6 +318,8 @@ public:
     FfzBadgeElement(const EmotePtr &data, MessageElementFlags flags_,
                     QColor &color);
 
+    const QColor &getColor() const;
+
 protected:
     MessageLayoutElement *makeImageLayoutElement(const ImagePtr &image,
                                                  const QSize &size) override;
@@ -313,8 +335,11 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags) override;
+    void addCopyText(QString &str, MessageElementFlags flags) const override;
 
-    TextElement *formatTime(const QTime &time);
+    TextElement *formatTime(const QTime &time, const QString &format);
+
+    QTime getTime() const;
 
 private:
     QTime time_;
@@ -351,6 +376,9 @@ public:
 
     void addToContainer(MessageLayoutContainer &container,
                         MessageElementFlags flags) override;
+    void prefetchImages(float scale, MessageElementFlags flags) const override;
+
+    const ImageSet &getImages() const;
 
 private:
     ImageSet images_;
@@ -2,22 +2,35 @@
 
 #include "Application.hpp"
 #include "common/QLogging.hpp"
+#include "controllers/highlights/HighlightMatcher.hpp"
 #include "controllers/ignores/IgnoreController.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageElement.hpp"
+#include "providers/twitch/TwitchTags.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
+#include "singletons/helper/HighlightNotifier.hpp"
+#include "util/DebugCount.hpp"
 #include "util/Helpers.hpp"
 #include "util/StreamerMode.hpp"
+#include "util/QStringHash.hpp"
+#include "util/StringPool.hpp"
 
 #include <QFileInfo>
-#include <QMediaPlayer>
+
+#include <algorithm>
+#include <mutex>
+#include <tuple>
+#include <unordered_map>
 
 namespace chatterino {
 
 namespace {
 
+    DebugCounter badgeSetHits("badge set hits");
+    DebugCounter badgeSetMisses("badge set misses");
+
     QUrl getFallbackHighlightSound()
     {
         QString path = getSettings()->pathHighlightSound;
@@ -35,32 +48,154 @@ namespace {
         }
     }
 
-    QStringList parseTagList(const QVariantMap &tags, const QString &key)
+    boost::container::flat_map<QString, QString> parseBadgeInfos(
+        const QString &tag)
     {
-        auto iterator = tags.find(key);
-        if (iterator == tags.end())
-            return QStringList{};
+        boost::container::flat_map<QString, QString> badgeInfos;
+
+        auto parsed = parseBadgesTag(tag);
+        badgeInfos.reserve(parsed.size());
+        for (const auto &badgeInfo : parsed)
+        {
+            badgeInfos.emplace(badgeInfo.name.toString(),
+                               badgeInfo.version.toString());
+        }
 
-        return iterator.value().toString().split(
-            ',', QString::SplitBehavior::SkipEmptyParts);
+        return badgeInfos;
     }
 
-    std::vector<Badge> parseBadges(const QVariantMap &tags)
+    std::vector<Badge> parseBadges(const QString &tag)
     {
         std::vector<Badge> badges;
 
-        for (QString badge : parseTagList(tags, "badges"))
+        auto parsed = parseBadgesTag(tag);
+        badges.reserve(parsed.size());
+        for (const auto &badge : parsed)
+        {
+            badges.emplace_back(badge.name.toString(),
+                                badge.version.toString());
+        }
+
+        return badges;
+    }
+
+    // Most chatters have one of a few badge combinations, messages with the
+    // same badge tags share their BadgeSet. Sets that aren't used by any
+    // message anymore are dropped when the table has doubled in size.
+    std::shared_ptr<const BadgeSet> internBadgeSet(const QVariantMap &tags)
+    {
+        static std::mutex mutex;
+        static std::unordered_map<QString, std::weak_ptr<const BadgeSet>>
+            sets;
+        static size_t purgeSize = 256;
+
+        auto badges = tags.value(QStringLiteral("badges")).toString();
+        auto badgeInfos = tags.value(QStringLiteral("badge-info")).toString();
+        auto key = badges + ' ' + badgeInfos;
+
+        std::lock_guard<std::mutex> lock(mutex);
+
+        auto &entry = sets[key];
+        if (auto set = entry.lock())
+        {
+            badgeSetHits.increase();
+            return set;
+        }
+
+        badgeSetMisses.increase();
+
+        auto set = std::make_shared<const BadgeSet>(
+            BadgeSet(parseBadges(badges), parseBadgeInfos(badgeInfos)));
+        entry = set;
+
+        if (sets.size() >= purgeSize)
         {
-            QStringList parts = badge.split('/');
-            if (parts.size() != 2)
+            for (auto it = sets.begin(); it != sets.end();)
             {
-                continue;
+                if (it->second.expired())
+                {
+                    it = sets.erase(it);
+                }
+                else
+                {
+                    it++;
+                }
             }
+            purgeSize = std::max<size_t>(256, sets.size() * 2);
+        }
+
+        return set;
+    }
+
+    struct SelfHighlight {
+        // empty if self highlights are disabled
+        QString userName;
+        bool showInMentions = false;
+        bool hasAlert = false;
+        bool hasSound = false;
+        QString soundUrl;
 
-            badges.emplace_back(parts[0], parts[1]);
+        bool operator==(const SelfHighlight &other) const
+        {
+            return std::tie(this->userName, this->showInMentions,
+                            this->hasAlert, this->hasSound, this->soundUrl) ==
+                   std::tie(other.userName, other.showInMentions,
+                            other.hasAlert, other.hasSound, other.soundUrl);
         }
+    };
 
-        return badges;
+    // The matchers are rebuilt whenever the phrases they were built from
+    // changed, SignalVector replaces its read only copy on every change.
+    std::shared_ptr<const HighlightMatcher> getUserHighlightMatcher()
+    {
+        static std::mutex mutex;
+        static std::shared_ptr<const std::vector<HighlightPhrase>> phrases;
+        static std::shared_ptr<const HighlightMatcher> matcher;
+
+        auto current = getCSettings().highlightedUsers.readOnly();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!matcher || current != phrases)
+        {
+            matcher = std::make_shared<const HighlightMatcher>(*current);
+            phrases = current;
+        }
+
+        return matcher;
+    }
+
+    std::shared_ptr<const HighlightMatcher> getMessageHighlightMatcher(
+        const SelfHighlight &selfHighlight)
+    {
+        static std::mutex mutex;
+        static std::shared_ptr<const std::vector<HighlightPhrase>> phrases;
+        static SelfHighlight builtSelfHighlight;
+        static std::shared_ptr<const HighlightMatcher> matcher;
+
+        auto current = getCSettings().highlightedMessages.readOnly();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!matcher || current != phrases ||
+            !(selfHighlight == builtSelfHighlight))
+        {
+            std::vector<HighlightPhrase> activeHighlights(*current);
+
+            if (!selfHighlight.userName.isEmpty())
+            {
+                activeHighlights.emplace_back(
+                    selfHighlight.userName, selfHighlight.showInMentions,
+                    selfHighlight.hasAlert, selfHighlight.hasSound, false,
+                    false, selfHighlight.soundUrl,
+                    ColorProvider::instance().color(ColorType::SelfHighlight));
+            }
+
+            matcher = std::make_shared<const HighlightMatcher>(
+                std::move(activeHighlights));
+            phrases = current;
+            builtSelfHighlight = selfHighlight;
+        }
+
+        return matcher;
     }
 
 }  // namespace
@@ -100,6 +235,8 @@ void SharedMessageBuilder::parse()
 
     this->parseUsername();
 
+    this->message().badgeSet = internBadgeSet(this->tags);
+
     this->message().flags.set(MessageFlag::Collapsed);
 }
 
@@ -120,44 +257,73 @@ void SharedMessageBuilder::parseUsernameColor()
 
 void SharedMessageBuilder::parseUsername()
 {
-    // username
-    this->userName = this->ircMessage->nick();
+    // username, shared with the other messages of this user
+    this->userName = StringPool::instance().intern(this->ircMessage->nick());
 
     this->message().loginName = this->userName;
 }
 
 void SharedMessageBuilder::parseHighlights()
+{
+    auto highlight = SharedMessageBuilder::checkHighlights(
+        this->ircMessage->nick(), this->originalMessage_,
+        *this->message().badgeSet,
+        this->message().flags.has(MessageFlag::Subscription),
+        this->args.isReceivedWhisper);
+
+    if (highlight.highlighted)
+    {
+        this->message().flags.set(MessageFlag::Highlighted);
+    }
+    if (highlight.showInMentions)
+    {
+        this->message().flags.set(MessageFlag::ShowInMentions);
+    }
+    if (highlight.color)
+    {
+        this->message().highlightColor = highlight.color;
+    }
+
+    this->highlightAlert_ = highlight.alert;
+    this->highlightSound_ = highlight.sound;
+    this->highlightSoundUrl_ = highlight.soundUrl;
+}
+
+HighlightResult SharedMessageBuilder::checkHighlights(
+    const QString &loginName, const QString &text, const BadgeSet &badges,
+    bool isSubscription, bool isReceivedWhisper)
 {
     auto app = getApp();
+    HighlightResult result;
 
     // Highlight because it's a subscription
-    if (this->message().flags.has(MessageFlag::Subscription) &&
-        getSettings()->enableSubHighlight)
+    const bool subHighlighted =
+        isSubscription && getSettings()->enableSubHighlight;
+    if (subHighlighted)
     {
         if (getSettings()->enableSubHighlightTaskbar)
         {
-            this->highlightAlert_ = true;
+            result.alert = true;
         }
 
         if (getSettings()->enableSubHighlightSound)
         {
-            this->highlightSound_ = true;
+            result.sound = true;
 
             // Use custom sound if set, otherwise use fallback
             if (!getSettings()->subHighlightSoundUrl.getValue().isEmpty())
             {
-                this->highlightSoundUrl_ =
+                result.soundUrl =
                     QUrl(getSettings()->subHighlightSoundUrl.getValue());
             }
             else
             {
-                this->highlightSoundUrl_ = getFallbackHighlightSound();
+                result.soundUrl = getFallbackHighlightSound();
             }
         }
 
-        this->message().flags.set(MessageFlag::Highlighted);
-        this->message().highlightColor =
-            ColorProvider::instance().color(ColorType::Subscription);
+        result.highlighted = true;
+        result.color = ColorProvider::instance().color(ColorType::Subscription);
     }
 
     // XXX: Non-common term in SharedMessageBuilder
@@ -165,38 +331,37 @@ void SharedMessageBuilder::parseHighlights()
 
     QString currentUsername = currentUser->getUserName();
 
-    if (getCSettings().isBlacklistedUser(this->ircMessage->nick()))
+    if (getCSettings().isBlacklistedUser(loginName))
     {
         // Do nothing. We ignore highlights from this user.
-        return;
+        return result;
     }
 
     // Highlight because it's a whisper
-    if (this->args.isReceivedWhisper && getSettings()->enableWhisperHighlight)
+    if (isReceivedWhisper && getSettings()->enableWhisperHighlight)
     {
         if (getSettings()->enableWhisperHighlightTaskbar)
         {
-            this->highlightAlert_ = true;
+            result.alert = true;
         }
 
         if (getSettings()->enableWhisperHighlightSound)
         {
-            this->highlightSound_ = true;
+            result.sound = true;
 
             // Use custom sound if set, otherwise use fallback
             if (!getSettings()->whisperHighlightSoundUrl.getValue().isEmpty())
             {
-                this->highlightSoundUrl_ =
+                result.soundUrl =
                     QUrl(getSettings()->whisperHighlightSoundUrl.getValue());
             }
             else
             {
-                this->highlightSoundUrl_ = getFallbackHighlightSound();
+                result.soundUrl = getFallbackHighlightSound();
             }
         }
 
-        this->message().highlightColor =
-            ColorProvider::instance().color(ColorType::Whisper);
+        result.color = ColorProvider::instance().color(ColorType::Whisper);
 
         /*
          * Do _NOT_ return yet, we might want to apply phrase/user name
@@ -205,125 +370,112 @@ void SharedMessageBuilder::parseHighlights()
     }
 
     // Highlight because of sender
-    auto userHighlights = getCSettings().highlightedUsers.readOnly();
-    for (const HighlightPhrase &userHighlight : *userHighlights)
+    auto userHighlightMatcher = getUserHighlightMatcher();
+    for (const HighlightPhrase *userHighlight :
+         userHighlightMatcher->match(loginName))
     {
-        if (!userHighlight.isMatch(this->ircMessage->nick()))
-        {
-            continue;
-        }
         qCDebug(chatterinoMessage)
-            << "Highlight because user" << this->ircMessage->nick()
-            << "sent a message";
+            << "Highlight because user" << loginName << "sent a message";
 
-        this->message().flags.set(MessageFlag::Highlighted);
-        if (!(this->message().flags.has(MessageFlag::Subscription) &&
-              getSettings()->enableSubHighlight))
+        result.highlighted = true;
+        if (!subHighlighted)
         {
-            this->message().highlightColor = userHighlight.getColor();
+            result.color = userHighlight->getColor();
         }
 
-        if (userHighlight.showInMentions())
+        if (userHighlight->showInMentions())
         {
-            this->message().flags.set(MessageFlag::ShowInMentions);
+            result.showInMentions = true;
         }
 
-        if (userHighlight.hasAlert())
+        if (userHighlight->hasAlert())
         {
-            this->highlightAlert_ = true;
+            result.alert = true;
         }
 
-        if (userHighlight.hasSound())
+        if (userHighlight->hasSound())
         {
-            this->highlightSound_ = true;
+            result.sound = true;
             // Use custom sound if set, otherwise use the fallback sound
-            if (userHighlight.hasCustomSound())
+            if (userHighlight->hasCustomSound())
             {
-                this->highlightSoundUrl_ = userHighlight.getSoundUrl();
+                result.soundUrl = userHighlight->getSoundUrl();
             }
             else
             {
-                this->highlightSoundUrl_ = getFallbackHighlightSound();
+                result.soundUrl = getFallbackHighlightSound();
             }
         }
 
-        if (this->highlightAlert_ && this->highlightSound_)
+        if (result.alert && result.sound)
         {
             /*
              * User name highlights "beat" highlight phrases: If a message has
              * all attributes (color, taskbar flashing, sound) set, highlight
              * phrases will not be checked.
              */
-            return;
+            return result;
         }
     }
 
-    if (this->ircMessage->nick() == currentUsername)
+    if (loginName == currentUsername)
     {
         // Do nothing. Highlights cannot be triggered by yourself
-        return;
+        return result;
     }
 
-    // TODO: This vector should only be rebuilt upon highlights being changed
-    // fourtf: should be implemented in the HighlightsController
-    std::vector<HighlightPhrase> activeHighlights =
-        getSettings()->highlightedMessages.cloneVector();
-
+    SelfHighlight selfHighlight;
     if (!currentUser->isAnon() && getSettings()->enableSelfHighlight &&
         currentUsername.size() > 0)
     {
-        HighlightPhrase selfHighlight(
-            currentUsername, getSettings()->showSelfHighlightInMentions,
-            getSettings()->enableSelfHighlightTaskbar,
-            getSettings()->enableSelfHighlightSound, false, false,
-            getSettings()->selfHighlightSoundUrl.getValue(),
-            ColorProvider::instance().color(ColorType::SelfHighlight));
-        activeHighlights.emplace_back(std::move(selfHighlight));
+        selfHighlight.userName = currentUsername;
+        selfHighlight.showInMentions =
+            getSettings()->showSelfHighlightInMentions;
+        selfHighlight.hasAlert = getSettings()->enableSelfHighlightTaskbar;
+        selfHighlight.hasSound = getSettings()->enableSelfHighlightSound;
+        selfHighlight.soundUrl =
+            getSettings()->selfHighlightSoundUrl.getValue();
     }
 
     // Highlight because of message
-    for (const HighlightPhrase &highlight : activeHighlights)
+    auto messageHighlightMatcher = getMessageHighlightMatcher(selfHighlight);
+    for (const HighlightPhrase *highlight :
+         messageHighlightMatcher->match(text))
     {
-        if (!highlight.isMatch(this->originalMessage_))
-        {
-            continue;
-        }
-
-        this->message().flags.set(MessageFlag::Highlighted);
-        if (!(this->message().flags.has(MessageFlag::Subscription) &&
-              getSettings()->enableSubHighlight))
+        result.highlighted = true;
+        if (!subHighlighted)
         {
-            this->message().highlightColor = highlight.getColor();
+            result.color = highlight->getColor();
         }
 
-        if (highlight.showInMentions())
+        if (highlight->showInMentions())
         {
-            this->message().flags.set(MessageFlag::ShowInMentions);
+            result.showInMentions = true;
         }
 
-        if (highlight.hasAlert())
+        if (highlight->hasAlert())
         {
-            this->highlightAlert_ = true;
+            result.alert = true;
         }
 
-        // Only set highlightSound_ if it hasn't been set by username
-        // highlights already.
-        if (highlight.hasSound() && !this->highlightSound_)
+        // Only set the sound if it hasn't been set by username highlights
+        // already.
+        if (highlight->hasSound() && !result.sound)
         {
-            this->highlightSound_ = true;
+            result.sound = true;
 
             // Use custom sound if set, otherwise use fallback sound
-            if (highlight.hasCustomSound())
+            if (highlight->hasCustomSound())
             {
-                this->highlightSoundUrl_ = highlight.getSoundUrl();
+                result.soundUrl = highlight->getSoundUrl();
             }
             else
             {
-                this->highlightSoundUrl_ = getFallbackHighlightSound();
+                result.soundUrl = getFallbackHighlightSound();
             }
         }
 
-        if (this->highlightAlert_ && this->highlightSound_)
+        if (result.alert && result.sound)
         {
             /*
              * Break once no further attributes (taskbar, sound) can be
@@ -334,56 +486,53 @@ void SharedMessageBuilder::parseHighlights()
     }
 
     // Highlight because of badge
-    auto badges = parseBadges(this->tags);
     auto badgeHighlights = getCSettings().highlightedBadges.readOnly();
     bool badgeHighlightSet = false;
     for (const HighlightBadge &highlight : *badgeHighlights)
     {
-        for (const Badge &badge : badges)
+        if (!highlight.isMatch(badges))
         {
-            if (!highlight.isMatch(badge))
-            {
-                continue;
-            }
+            continue;
+        }
 
-            if (!badgeHighlightSet)
+        if (!badgeHighlightSet)
+        {
+            result.highlighted = true;
+            if (!subHighlighted)
             {
-                this->message().flags.set(MessageFlag::Highlighted);
-                if (!(this->message().flags.has(MessageFlag::Subscription) &&
-                      getSettings()->enableSubHighlight))
-                {
-                    this->message().highlightColor = highlight.getColor();
-                }
-
-                badgeHighlightSet = true;
+                result.color = highlight.getColor();
             }
 
-            if (highlight.hasAlert())
-            {
-                this->highlightAlert_ = true;
-            }
+            badgeHighlightSet = true;
+        }
 
-            // Only set highlightSound_ if it hasn't been set by badge
-            // highlights already.
-            if (highlight.hasSound() && !this->highlightSound_)
-            {
-                this->highlightSound_ = true;
-                // Use custom sound if set, otherwise use fallback sound
-                this->highlightSoundUrl_ = highlight.hasCustomSound()
-                                               ? highlight.getSoundUrl()
-                                               : getFallbackHighlightSound();
-            }
+        if (highlight.hasAlert())
+        {
+            result.alert = true;
+        }
 
-            if (this->highlightAlert_ && this->highlightSound_)
-            {
-                /*
-                 * Break once no further attributes (taskbar, sound) can be
-                 * applied.
-                 */
-                break;
-            }
+        // Only set the sound if it hasn't been set by badge highlights
+        // already.
+        if (highlight.hasSound() && !result.sound)
+        {
+            result.sound = true;
+            // Use custom sound if set, otherwise use fallback sound
+            result.soundUrl = highlight.hasCustomSound()
+                                  ? highlight.getSoundUrl()
+                                  : getFallbackHighlightSound();
+        }
+
+        if (result.alert && result.sound)
+        {
+            /*
+             * Break once no further attributes (taskbar, sound) can be
+             * applied.
+             */
+            break;
         }
     }
+
+    return result;
 }
 
 void SharedMessageBuilder::addTextOrEmoji(EmotePtr emote)
@@ -431,22 +580,12 @@ void SharedMessageBuilder::appendChannelName()
         ->setLink(link);
 }
 
-inline QMediaPlayer *getPlayer()
+void SharedMessageBuilder::triggerHighlights()
 {
-    if (isGuiThread())
-    {
-        static auto player = new QMediaPlayer;
-        return player;
-    }
-    else
+    if (!this->highlightSound_ && !this->highlightAlert_)
     {
-        return nullptr;
+        return;
     }
-}
-
-void SharedMessageBuilder::triggerHighlights()
-{
-    static QUrl currentPlayerUrl;
 
     if (isInStreamerMode() && getSettings()->streamerModeMuteMentions)
     {
@@ -460,29 +599,9 @@ void SharedMessageBuilder::triggerHighlights()
         return;
     }
 
-    bool hasFocus = (QApplication::focusWidget() != nullptr);
-    bool resolveFocus = !hasFocus || getSettings()->highlightAlwaysPlaySound;
-
-    if (this->highlightSound_ && resolveFocus)
-    {
-        if (auto player = getPlayer())
-        {
-            // update the media player url if necessary
-            if (currentPlayerUrl != this->highlightSoundUrl_)
-            {
-                player->setMedia(this->highlightSoundUrl_);
-
-                currentPlayerUrl = this->highlightSoundUrl_;
-            }
-
-            player->play();
-        }
-    }
-
-    if (this->highlightAlert_)
-    {
-        getApp()->windows->sendAlert();
-    }
+    HighlightNotifier::notify(
+        this->highlightSound_ ? this->highlightSoundUrl_ : QUrl(),
+        this->highlightAlert_);
 }
 
 }  // namespace chatterino
@@ -8,8 +8,24 @@
 #include <QColor>
 #include <QUrl>
 
+#include <memory>
+
 namespace chatterino {
 
+struct BadgeSet;
+
+/// What the highlight rules decided for a message
+struct HighlightResult {
+    bool highlighted = false;
+    bool showInMentions = false;
+    // null if the rules don't give the message a color
+    std::shared_ptr<QColor> color;
+
+    bool alert = false;
+    bool sound = false;
+    QUrl soundUrl;
+};
+
 class SharedMessageBuilder : public MessageBuilder
 {
 public:
@@ -32,6 +48,15 @@ public:
     virtual void triggerHighlights();
     virtual MessagePtr build() = 0;
 
+    /// Checks a message against the highlight rules. Only reads thread safe
+    /// snapshots of the settings, so it can be called from any thread, also
+    /// for messages that were built before the rules changed.
+    static HighlightResult checkHighlights(const QString &loginName,
+                                           const QString &text,
+                                           const BadgeSet &badges,
+                                           bool isSubscription,
+                                           bool isReceivedWhisper);
+
 protected:
     virtual void parse();
 
@@ -4,11 +4,14 @@
 #include "debug/Benchmark.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageElement.hpp"
+#include "messages/layouts/MessageLayoutBuffers.hpp"
 #include "messages/layouts/MessageLayoutContainer.hpp"
+#include "messages/layouts/SharedMessageLayouts.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/ChannelCosts.hpp"
 #include "util/DebugCount.hpp"
 
 #include <QApplication>
@@ -17,6 +20,8 @@
 #include <QThread>
 #include <QtGlobal>
 
+#include <algorithm>
+
 #define MARGIN_LEFT (int)(8 * this->scale)
 #define MARGIN_RIGHT (int)(8 * this->scale)
 #define MARGIN_TOP (int)(4 * this->scale)
@@ -27,6 +32,9 @@ namespace chatterino {
 
 namespace {
 
+    DebugCounter layoutCount("message layout");
+    DebugCounter bufferCount("message drawing buffers");
+
     QColor blendColors(const QColor &base, const QColor &apply)
     {
         const qreal &alpha = apply.alphaF();
@@ -42,12 +50,13 @@ MessageLayout::MessageLayout(MessagePtr message)
     : message_(std::move(message))
     , container_(std::make_shared<MessageLayoutContainer>())
 {
-    DebugCount::increase("message layout");
+    layoutCount.increase();
 }
 
 MessageLayout::~MessageLayout()
 {
-    DebugCount::decrease("message layout");
+    this->deleteBuffer();
+    layoutCount.decrease();
 }
 
 const Message *MessageLayout::getMessage()
@@ -58,6 +67,11 @@ const Message *MessageLayout::getMessage()
 // Height
 int MessageLayout::getHeight() const
 {
+    if (this->released_)
+    {
+        return this->height_;
+    }
+
     return container_->getHeight();
 }
 
@@ -70,6 +84,13 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
     auto app = getApp();
 
     bool layoutRequired = false;
+    // previous layouts stay valid as long as nothing but the parameters
+    // changed
+    bool cacheValid = true;
+
+    CachedLayout previous{this->currentLayoutWidth_, this->scale_,
+                          this->currentWordFlags_, this->layoutMessageFlags_,
+                          nullptr};
 
     // check if width changed
     bool widthChanged = width != this->currentLayoutWidth_;
@@ -80,6 +101,7 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
     if (this->layoutState_ != app->windows->getGeneration())
     {
         layoutRequired = true;
+        cacheValid = false;
         this->flags.set(MessageLayoutFlag::RequiresBufferUpdate);
         this->layoutState_ = app->windows->getGeneration();
     }
@@ -89,20 +111,48 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
     this->currentWordFlags_ = flags;  // getSettings()->getWordTypeMask();
 
     // check if layout was requested manually
-    layoutRequired |= this->flags.has(MessageLayoutFlag::RequiresLayout);
-    this->flags.unset(MessageLayoutFlag::RequiresLayout);
+    if (this->flags.has(MessageLayoutFlag::RequiresLayout))
+    {
+        layoutRequired = true;
+        cacheValid = false;
+        this->flags.unset(MessageLayoutFlag::RequiresLayout);
+    }
 
     // check if dpi changed
     layoutRequired |= this->scale_ != scale;
     this->scale_ = scale;
 
+    if (this->released_)
+    {
+        layoutRequired = true;
+        cacheValid = false;
+    }
+
+    // images were loaded since the buffer was drawn
+    bool bufferOutdated =
+        this->bufferGeneration_ != app->windows->getBufferGeneration();
+    this->bufferGeneration_ = app->windows->getBufferGeneration();
+
     if (!layoutRequired)
     {
+        if (bufferOutdated)
+        {
+            this->invalidateBuffer();
+            return true;
+        }
         return false;
     }
 
-    int oldHeight = this->container_->getHeight();
-    this->actuallyLayout(width, flags);
+    int oldHeight = this->getHeight();
+    if (!cacheValid)
+    {
+        this->layoutCache_.clear();
+        this->actuallyLayout(width, flags);
+    }
+    else if (!this->swapCachedLayout(previous, width, flags))
+    {
+        this->actuallyLayout(width, flags);
+    }
     if (widthChanged || this->container_->getHeight() != oldHeight)
     {
         this->deleteBuffer();
@@ -112,10 +162,61 @@ bool MessageLayout::layout(int width, float scale, MessageElementFlags flags)
     return true;
 }
 
+// Replaces the container with a fresh one or with a cached layout for the
+// new parameters, the current one is cached. Returns true if a cached layout
+// was used.
+bool MessageLayout::swapCachedLayout(const CachedLayout &previous, int width,
+                                     MessageElementFlags flags)
+{
+    const auto messageFlags = this->message_->flags;
+
+    auto it = std::find_if(this->layoutCache_.begin(),
+                           this->layoutCache_.end(), [&](const auto &cached) {
+                               return cached.width == width &&
+                                      cached.scale == this->scale_ &&
+                                      cached.flags == flags &&
+                                      cached.messageFlags == messageFlags;
+                           });
+
+    std::shared_ptr<MessageLayoutContainer> container;
+    if (it != this->layoutCache_.end())
+    {
+        container = std::move(it->container);
+        this->layoutCache_.erase(it);
+    }
+
+    // nothing to keep if the message was never laid out
+    if (previous.width != -1)
+    {
+        auto entry = previous;
+        entry.container = std::move(this->container_);
+        this->layoutCache_.insert(this->layoutCache_.begin(), std::move(entry));
+        if (this->layoutCache_.size() > layoutCacheSize)
+        {
+            this->layoutCache_.pop_back();
+        }
+    }
+
+    if (!container)
+    {
+        this->container_ = std::make_shared<MessageLayoutContainer>();
+        return false;
+    }
+
+    this->container_ = std::move(container);
+    this->layoutMessageFlags_ = messageFlags;
+    this->updateHeight();
+
+    return true;
+}
+
 void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
 {
-    this->layoutCount_++;
+    ChannelCosts::Scope costs(this->message_->channelName,
+                              CostCategory::Layout);
+    this->released_ = false;
     auto messageFlags = this->message_->flags;
+    this->layoutMessageFlags_ = messageFlags;
 
     if (this->flags.has(MessageLayoutFlag::Expanded) ||
         (flags.has(MessageElementFlag::ModeratorTools) &&
@@ -124,38 +225,52 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
         messageFlags.unset(MessageFlag::Collapsed);
     }
 
+    // another view may show the message the same way
+    auto &shared = SharedMessageLayouts::instance();
+    SharedMessageLayouts::LayoutParams params{
+        width, this->scale_, flags, messageFlags, this->layoutState_};
+    if (auto container = shared.find(this->message_.get(), params))
+    {
+        this->container_ = std::move(container);
+        this->updateHeight();
+        return;
+    }
+
+    // containers can be shared, they're never laid out again
+    this->container_ = shared.make(this->message_.get(), params);
+    this->layoutCount_++;
+
     this->container_->begin(width, this->scale_, messageFlags);
 
-    for (const auto &element : this->message_->elements)
+    if (!this->hidesElements())
     {
-        if (getSettings()->hideModerated &&
-            this->message_->flags.has(MessageFlag::Disabled))
+        for (const auto &element : this->message_->elements)
         {
-            continue;
+            element->addToContainer(*this->container_, flags);
         }
+    }
 
-        if (getSettings()->hideModerationActions &&
-            (this->message_->flags.has(MessageFlag::Timeout) ||
-             this->message_->flags.has(MessageFlag::Untimeout)))
-        {
-            continue;
-        }
+    this->container_->end();
+    this->updateHeight();
+}
 
-        if (getSettings()->hideSimilar &&
-            this->message_->flags.has(MessageFlag::Similar))
-        {
-            continue;
-        }
+bool MessageLayout::hidesElements() const
+{
+    const auto &flags = this->message_->flags;
 
-        element->addToContainer(*this->container_, flags);
-    }
+    return (getSettings()->hideModerated && flags.has(MessageFlag::Disabled)) ||
+           (getSettings()->hideModerationActions &&
+            (flags.has(MessageFlag::Timeout) ||
+             flags.has(MessageFlag::Untimeout))) ||
+           (getSettings()->hideSimilar && flags.has(MessageFlag::Similar));
+}
 
+void MessageLayout::updateHeight()
+{
     if (this->height_ != this->container_->getHeight())
     {
         this->deleteBuffer();
     }
-
-    this->container_->end();
     this->height_ = this->container_->getHeight();
 
     // collapsed state
@@ -167,11 +282,42 @@ void MessageLayout::actuallyLayout(int width, MessageElementFlags flags)
 }
 
 // Painting
-void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
-                          Selection &selection, bool isLastReadMessage,
-                          bool isWindowFocused, bool isMentions)
+QRegion MessageLayout::paint(QPainter &painter, int width, int y,
+                             int messageIndex, Selection &selection,
+                             bool isLastReadMessage, bool isWindowFocused,
+                             bool isMentions)
 {
     auto app = getApp();
+    this->restoreLayout();
+
+    auto &shared = SharedMessageLayouts::instance();
+    SharedMessageLayouts::BufferParams bufferParams{
+        width, painter.device()->devicePixelRatioF(),
+        this->flags.has(MessageLayoutFlag::AlternateBackground),
+        this->flags.has(MessageLayoutFlag::IgnoreHighlights),
+        app->windows->getBufferGeneration()};
+
+    if (!this->bufferValid_)
+    {
+        // another view may have painted the message the same way
+        if (auto buffer =
+                shared.findBuffer(this->container_.get(), bufferParams))
+        {
+            if (buffer != this->buffer_)
+            {
+                this->deleteBuffer();
+                this->buffer_ = std::move(buffer);
+                bufferCount.increase();
+            }
+            this->bufferValid_ = true;
+        }
+        else if (this->buffer_.use_count() > 1)
+        {
+            // other views still show the buffer as it is
+            this->deleteBuffer();
+        }
+    }
+
     QPixmap *pixmap = this->buffer_.get();
 
     // create new buffer if required
@@ -189,12 +335,21 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
 
         this->buffer_ = std::shared_ptr<QPixmap>(pixmap);
         this->bufferValid_ = false;
-        DebugCount::increase("message drawing buffers");
+        bufferCount.increase();
     }
 
-    if (!this->bufferValid_ || !selection.isEmpty())
+    // may delete the buffers of other messages, never this one
+    MessageLayoutBuffers::instance().touch(this, this->bufferBytes());
+
+    if (!this->bufferValid_)
     {
         this->updateBuffer(pixmap, messageIndex, selection);
+        shared.addBuffer(this->container_.get(), bufferParams, this->buffer_);
+    }
+    else if (!selection.isEmpty())
+    {
+        // paints the same as before, a shared buffer stays the same
+        this->updateBuffer(pixmap, messageIndex, selection);
     }
 
     // draw on buffer
@@ -203,7 +358,7 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
     //    this->container.getHeight(), *pixmap);
 
     // draw gif emotes
-    this->container_->paintAnimatedElements(painter, y);
+    auto animatedRegion = this->container_->paintAnimatedElements(painter, y);
 
     // draw disabled
     if (this->message_->flags.has(MessageFlag::Disabled))
@@ -267,6 +422,8 @@ void MessageLayout::paint(QPainter &painter, int width, int y, int messageIndex,
     }
 
     this->bufferValid_ = true;
+
+    return animatedRegion;
 }
 
 void MessageLayout::updateBuffer(QPixmap *buffer, int /*messageIndex*/,
@@ -275,6 +432,9 @@ void MessageLayout::updateBuffer(QPixmap *buffer, int /*messageIndex*/,
     if (buffer->isNull())
         return;
 
+    // images loaded while drawing count for this channel as well
+    ChannelCosts::Scope costs(this->message_->channelName,
+                              CostCategory::Layout);
     auto app = getApp();
     auto settings = getSettings();
 
@@ -366,21 +526,60 @@ void MessageLayout::deleteBuffer()
 {
     if (this->buffer_ != nullptr)
     {
-        DebugCount::decrease("message drawing buffers");
+        bufferCount.decrease();
+        MessageLayoutBuffers::instance().remove(this);
 
         this->buffer_ = nullptr;
     }
 }
 
+int64_t MessageLayout::bufferBytes() const
+{
+    if (this->buffer_ == nullptr)
+    {
+        return 0;
+    }
+
+    // a shared buffer is split between the layouts using it
+    return int64_t(this->buffer_->width()) * this->buffer_->height() *
+           std::max(1, this->buffer_->depth()) / 8 /
+           std::max<long>(1, this->buffer_.use_count());
+}
+
 void MessageLayout::deleteCache()
 {
     this->deleteBuffer();
+    this->layoutCache_.clear();
 
 #ifdef XD
     this->container_->clear();
 #endif
 }
 
+void MessageLayout::releaseLayout()
+{
+    this->deleteBuffer();
+    this->layoutCache_.clear();
+
+    // never laid out, nothing to free
+    if (this->released_ || this->currentLayoutWidth_ == -1)
+    {
+        return;
+    }
+
+    this->container_ = std::make_shared<MessageLayoutContainer>();
+    this->released_ = true;
+}
+
+void MessageLayout::restoreLayout()
+{
+    if (this->released_)
+    {
+        this->actuallyLayout(this->currentLayoutWidth_,
+                             this->currentWordFlags_);
+    }
+}
+
 // Elements
 //    assert(QThread::currentThread() == QApplication::instance()->thread());
 
@@ -389,29 +588,57 @@ void MessageLayout::deleteCache()
 // fourtf: this should return a MessageLayoutItem
 const MessageLayoutElement *MessageLayout::getElementAt(QPoint point)
 {
+    this->restoreLayout();
+
     // go through all words and return the first one that contains the point.
     return this->container_->getElementAt(point);
 }
 
-int MessageLayout::getLastCharacterIndex() const
+int MessageLayout::getLastCharacterIndex()
 {
+    this->restoreLayout();
     return this->container_->getLastCharacterIndex();
 }
 
-int MessageLayout::getFirstMessageCharacterIndex() const
+int MessageLayout::getFirstMessageCharacterIndex()
 {
+    this->restoreLayout();
     return this->container_->getFirstMessageCharacterIndex();
 }
 
 int MessageLayout::getSelectionIndex(QPoint position)
 {
+    this->restoreLayout();
     return this->container_->getSelectionIndex(position);
 }
 
 void MessageLayout::addSelectionText(QString &str, int from, int to,
                                      CopyMode copymode)
 {
+    this->restoreLayout();
     this->container_->addSelectionText(str, from, to, copymode);
 }
 
+void MessageLayout::addMessageText(QString &str, CopyMode copymode) const
+{
+    if (this->hidesElements())
+    {
+        return;
+    }
+
+    for (const auto &element : this->message_->elements)
+    {
+        // same as MessageLayoutContainer::addSelectionText
+        if (copymode == CopyMode::OnlyTextAndEmotes &&
+            element->getFlags().hasAny({MessageElementFlag::Timestamp,
+                                        MessageElementFlag::Username,
+                                        MessageElementFlag::Badges}))
+        {
+            continue;
+        }
+
+        element->addCopyText(str, this->currentWordFlags_);
+    }
+}
+
 }  // namespace chatterino
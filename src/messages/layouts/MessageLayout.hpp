@@ -4,9 +4,11 @@
 #include "common/FlagsEnum.hpp"
 
 #include <QPixmap>
+#include <QRegion>
 #include <boost/noncopyable.hpp>
 #include <cinttypes>
 #include <memory>
+#include <vector>
 
 namespace chatterino {
 
@@ -20,6 +22,9 @@ class MessageLayoutElement;
 enum class MessageElementFlag : int64_t;
 using MessageElementFlags = FlagsEnum<MessageElementFlag>;
 
+enum class MessageFlag : uint32_t;
+using MessageFlags = FlagsEnum<MessageFlag>;
+
 enum class MessageLayoutFlag : uint8_t {
     RequiresBufferUpdate = 1 << 1,
     RequiresLayout = 1 << 2,
@@ -42,31 +47,65 @@ public:
 
     MessageLayoutFlags flags;
 
+    // Returns true if the message has to be painted again
     bool layout(int width, float scale_, MessageElementFlags flags);
 
     // Painting
-    void paint(QPainter &painter, int width, int y, int messageIndex,
+    /// Returns the area of the painter covered by animated images, only that
+    /// area needs to be repainted for the next animation frame
+    QRegion paint(QPainter &painter, int width, int y, int messageIndex,
                Selection &selection, bool isLastReadMessage,
                bool isWindowFocused, bool isMentions);
     void invalidateBuffer();
     void deleteBuffer();
+    /// Memory taken up by the pixmap buffer, 0 if there is none. A buffer
+    /// shared with other views is split between them.
+    int64_t bufferBytes() const;
     void deleteCache();
+    /// Frees the laid out elements of a message that is far away from the
+    /// view. The height stays as an estimate, the next layout lays the
+    /// message out again.
+    void releaseLayout();
 
     // Elements
     const MessageLayoutElement *getElementAt(QPoint point);
-    int getLastCharacterIndex() const;
-    int getFirstMessageCharacterIndex() const;
+    int getLastCharacterIndex();
+    int getFirstMessageCharacterIndex();
     int getSelectionIndex(QPoint position);
     void addSelectionText(QString &str, int from = 0, int to = INT_MAX,
                           CopyMode copymode = CopyMode::Everything);
+    /// Adds the text of the whole message as it's shown, straight from the
+    /// elements of the message, so the message isn't laid out for it.
+    /// Collapsed messages add all of their text.
+    void addMessageText(QString &str,
+                        CopyMode copymode = CopyMode::Everything) const;
 
     // Misc
     bool isDisabled() const;
 
 private:
+    // whether the settings hide all elements of the message
+    bool hidesElements() const;
+
+    // A previous layout result, which can be reused if the message is laid
+    // out with the same parameters again
+    struct CachedLayout {
+        int width;
+        float scale;
+        MessageElementFlags flags;
+        MessageFlags messageFlags;
+        std::shared_ptr<MessageLayoutContainer> container;
+    };
+
+    // amount of previous layout results that are kept around
+    static constexpr size_t layoutCacheSize = 2;
+
     // variables
     MessagePtr message_;
     std::shared_ptr<MessageLayoutContainer> container_;
+    // most recently used first, none of them is container_
+    std::vector<CachedLayout> layoutCache_;
+    MessageFlags layoutMessageFlags_;
     std::shared_ptr<QPixmap> buffer_{};
     bool bufferValid_ = false;
 
@@ -74,6 +113,7 @@ private:
 
     int currentLayoutWidth_ = -1;
     int layoutState_ = -1;
+    int bufferGeneration_ = -1;
     float scale_ = -1;
     unsigned int layoutCount_ = 0;
     unsigned int bufferUpdatedCount_ = 0;
@@ -81,9 +121,18 @@ private:
     MessageElementFlags currentWordFlags_;
 
     int collapsedHeight_ = 32;
+    // the elements were freed by releaseLayout
+    bool released_ = false;
 
     // methods
+    // lays a released message out with its last parameters, for the
+    // functions that need its elements
+    void restoreLayout();
     void actuallyLayout(int width, MessageElementFlags flags);
+    // takes over the height and the collapsed state of the container
+    void updateHeight();
+    bool swapCachedLayout(const CachedLayout &previous, int width,
+                          MessageElementFlags flags);
     void updateBuffer(QPixmap *pixmap, int messageIndex, Selection &selection);
 };
 
@@ -0,0 +1,77 @@
+#include "messages/layouts/MessageLayoutBuffers.hpp"
+
+#include "messages/layouts/MessageLayout.hpp"
+#include "singletons/Settings.hpp"
+#include "util/MemoryUsage.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+MessageLayoutBuffers &MessageLayoutBuffers::instance()
+{
+    static MessageLayoutBuffers instance;
+    return instance;
+}
+
+void MessageLayoutBuffers::touch(MessageLayout *layout, int64_t bytes)
+{
+    auto it = this->lookup_.find(layout);
+
+    if (it == this->lookup_.end())
+    {
+        this->entries_.push_front({layout, bytes});
+        this->lookup_.emplace(layout, this->entries_.begin());
+        this->setBytes(this->bytes_ + bytes);
+    }
+    else
+    {
+        auto entry = it->second;
+        this->setBytes(this->bytes_ - entry->bytes + bytes);
+        entry->bytes = bytes;
+        this->entries_.splice(this->entries_.begin(), this->entries_, entry);
+    }
+
+    this->evict();
+}
+
+void MessageLayoutBuffers::remove(MessageLayout *layout)
+{
+    auto it = this->lookup_.find(layout);
+    if (it == this->lookup_.end())
+    {
+        return;
+    }
+
+    this->setBytes(this->bytes_ - it->second->bytes);
+    this->entries_.erase(it->second);
+    this->lookup_.erase(it);
+}
+
+int64_t MessageLayoutBuffers::bytes() const
+{
+    return this->bytes_;
+}
+
+void MessageLayoutBuffers::setBytes(int64_t bytes)
+{
+    MemoryUsage::increase(MemoryCategory::LayoutBuffers, bytes - this->bytes_);
+    this->bytes_ = bytes;
+}
+
+void MessageLayoutBuffers::evict()
+{
+    const auto budget =
+        int64_t(std::max(1, getSettings()->messageBufferBudget.getValue())) *
+        1024 * 1024;
+
+    // the buffer that was just painted is always kept
+    while (this->bytes_ > budget && this->entries_.size() > 1)
+    {
+        auto *layout = this->entries_.back().layout;
+        this->remove(layout);
+        layout->deleteBuffer();
+    }
+}
+
+}  // namespace chatterino
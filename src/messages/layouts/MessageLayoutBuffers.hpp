@@ -0,0 +1,52 @@
+#pragma once
+
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <list>
+#include <unordered_map>
+
+namespace chatterino {
+
+class MessageLayout;
+
+/**
+ * @brief Keeps the pixmap buffers of all MessageLayouts within a budget.
+ *
+ * Layouts report their buffer whenever it is painted. Once all buffers
+ * together take up more than the budget set in the settings, the buffers
+ * that were painted least recently are deleted. They are recreated the next
+ * time their message is painted.
+ *
+ * Must only be used from the GUI thread.
+ */
+class MessageLayoutBuffers : boost::noncopyable
+{
+public:
+    static MessageLayoutBuffers &instance();
+
+    /// Registers the buffer of the layout as the most recently painted one
+    void touch(MessageLayout *layout, int64_t bytes);
+    /// Forgets the buffer of the layout, called once it's deleted
+    void remove(MessageLayout *layout);
+
+    int64_t bytes() const;
+
+private:
+    MessageLayoutBuffers() = default;
+
+    struct Entry {
+        MessageLayout *layout;
+        int64_t bytes;
+    };
+
+    void setBytes(int64_t bytes);
+    void evict();
+
+    // most recently painted first
+    std::list<Entry> entries_;
+    std::unordered_map<MessageLayout *, std::list<Entry>::iterator> lookup_;
+    int64_t bytes_ = 0;
+};
+
+}  // namespace chatterino
@@ -12,9 +12,10 @@
 #include <QDebug>
 #include <QPainter>
 
+#include <algorithm>
+
 #define COMPACT_EMOTES_OFFSET 4
-#define MAX_UNCOLLAPSED_LINES \
-    (getSettings()->collpseMessagesMinLines.getValue())
+#define MAX_UNCOLLAPSED_LINES (this->settings_->collapseMessagesMinLines)
 
 namespace chatterino {
 
@@ -33,6 +34,18 @@ float MessageLayoutContainer::getScale() const
     return this->scale_;
 }
 
+int MessageLayoutContainer::getSpaceWidth() const
+{
+    return this->spaceWidth_;
+}
+
+const LayoutSettings &MessageLayoutContainer::getSettings() const
+{
+    assert(this->settings_);
+
+    return *this->settings_;
+}
+
 // methods
 void MessageLayoutContainer::begin(int width, float scale, MessageFlags flags)
 {
@@ -40,6 +53,7 @@ void MessageLayoutContainer::begin(int width, float scale, MessageFlags flags)
     this->width_ = width;
     this->scale_ = scale;
     this->flags_ = flags;
+    this->settings_ = chatterino::getSettings()->layoutSettings();
     auto mediumFontMetrics =
         getApp()->fonts->getFontMetrics(FontStyle::ChatMedium, scale);
     this->textLineHeight_ = mediumFontMetrics.height();
@@ -137,7 +151,7 @@ void MessageLayoutContainer::_addElement(MessageLayoutElement *element,
 
     // compact emote offset
     bool isCompactEmote =
-        getSettings()->compactEmotes &&
+        this->settings_->compactEmotes &&
         !this->flags_.has(MessageFlag::DisableCompactEmotes) &&
         element->getCreator().getFlags().has(MessageElementFlag::EmoteImages);
 
@@ -168,7 +182,7 @@ void MessageLayoutContainer::_addElement(MessageLayoutElement *element,
         yOffset -= (this->margin.top * this->scale_);
     }
 
-    if (getSettings()->removeSpacesBetweenEmotes &&
+    if (this->settings_->removeSpacesBetweenEmotes &&
         element->getFlags().hasAny({MessageElementFlag::EmoteImages}) &&
         !isZeroWidthEmote && shouldRemoveSpaceBetweenEmotes())
     {
@@ -218,7 +232,7 @@ void MessageLayoutContainer::breakLine()
         MessageLayoutElement *element = this->elements_.at(i).get();
 
         bool isCompactEmote =
-            getSettings()->compactEmotes &&
+            this->settings_->compactEmotes &&
             !this->flags_.has(MessageFlag::DisableCompactEmotes) &&
             element->getCreator().getFlags().has(
                 MessageElementFlag::EmoteImages);
@@ -324,7 +338,7 @@ void MessageLayoutContainer::end()
 
 bool MessageLayoutContainer::canCollapse()
 {
-    return getSettings()->collpseMessagesMinLines.getValue() > 0 &&
+    return this->settings_->collapseMessagesMinLines > 0 &&
            this->flags_.has(MessageFlag::Collapsed);
 }
 
@@ -333,13 +347,58 @@ bool MessageLayoutContainer::isCollapsed()
     return this->isCollapsed_;
 }
 
+std::vector<MessageLayoutContainer::Line>::const_iterator
+    MessageLayoutContainer::lineAt(int y) const
+{
+    assert(!this->lines_.empty());
+
+    // lines are stacked without gaps, the first one reaching below y is it
+    auto line = std::upper_bound(this->lines_.begin(), this->lines_.end(), y,
+                                 [](int value, const Line &line) {
+                                     return value <= line.rect.bottom();
+                                 });
+
+    return line == this->lines_.end() ? this->lines_.end() - 1 : line;
+}
+
 MessageLayoutElement *MessageLayoutContainer::getElementAt(QPoint point)
 {
-    for (std::unique_ptr<MessageLayoutElement> &element : this->elements_)
+    if (this->lines_.empty())
     {
-        if (element->getRect().contains(point))
+        return nullptr;
+    }
+
+    auto line = this->lineAt(point.y());
+    if (auto *element = this->getElementAt(*line, point))
+    {
+        return element;
+    }
+
+    // compact emotes reach a bit into the neighbouring lines
+    if (line != this->lines_.begin())
+    {
+        if (auto *element = this->getElementAt(*(line - 1), point))
         {
-            return element.get();
+            return element;
+        }
+    }
+    if (line + 1 != this->lines_.end())
+    {
+        return this->getElementAt(*(line + 1), point);
+    }
+
+    return nullptr;
+}
+
+MessageLayoutElement *MessageLayoutContainer::getElementAt(const Line &line,
+                                                           QPoint point)
+{
+    auto end = std::min<size_t>(line.endIndex, this->elements_.size());
+    for (size_t i = line.startIndex; i < end; i++)
+    {
+        if (this->elements_[i]->getRect().contains(point))
+        {
+            return this->elements_[i].get();
         }
     }
 
@@ -360,13 +419,18 @@ void MessageLayoutContainer::paintElements(QPainter &painter)
     }
 }
 
-void MessageLayoutContainer::paintAnimatedElements(QPainter &painter,
-                                                   int yOffset)
+QRegion MessageLayoutContainer::paintAnimatedElements(QPainter &painter,
+                                                      int yOffset)
 {
+    QRegion animatedRegion;
     for (const std::unique_ptr<MessageLayoutElement> &element : this->elements_)
     {
-        element->paintAnimated(painter, yOffset);
+        if (element->paintAnimated(painter, yOffset))
+        {
+            animatedRegion += element->getRect().translated(0, yOffset);
+        }
     }
+    return animatedRegion;
 }
 
 void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
@@ -561,49 +625,24 @@ void MessageLayoutContainer::paintSelection(QPainter &painter, int messageIndex,
 // selection
 int MessageLayoutContainer::getSelectionIndex(QPoint point)
 {
-    if (this->elements_.size() == 0)
+    if (this->elements_.size() == 0 || this->lines_.empty())
     {
         return 0;
     }
 
-    auto line = this->lines_.begin();
+    auto line = this->lineAt(point.y());
 
-    for (; line != this->lines_.end(); line++)
-    {
-        if (line->rect.contains(point))
-        {
-            break;
-        }
-    }
+    int lineStart = line->startIndex;
+    int lineEnd = line + 1 == this->lines_.end() ? this->elements_.size()
+                                                 : (line + 1)->startIndex;
 
-    int lineStart = line == this->lines_.end() ? this->lines_.back().startIndex
-                                               : line->startIndex;
-    if (line != this->lines_.end())
-    {
-        line++;
-    }
-    int lineEnd =
-        line == this->lines_.end() ? this->elements_.size() : line->startIndex;
-
-    int index = 0;
+    // the characters of the lines above
+    int index = line->startCharIndex;
 
-    for (int i = 0; i < lineEnd; i++)
+    for (int i = lineStart; i < lineEnd; i++)
     {
         auto &&element = this->elements_[i];
 
-        // end of line
-        if (i == lineEnd)
-        {
-            break;
-        }
-
-        // before line
-        if (i < lineStart)
-        {
-            index += element->getSelectionIndexCount();
-            continue;
-        }
-
         // this is the word
         auto rightMargin = element->hasTrailingSpace() ? this->spaceWidth_ : 0;
 
@@ -2,6 +2,7 @@
 
 #include <QPoint>
 #include <QRect>
+#include <QRegion>
 #include <memory>
 #include <vector>
 
@@ -14,6 +15,7 @@ class QPainter;
 
 namespace chatterino {
 
+struct LayoutSettings;
 enum class MessageFlag : uint32_t;
 using MessageFlags = FlagsEnum<MessageFlag>;
 
@@ -52,6 +54,10 @@ struct MessageLayoutContainer {
     int getHeight() const;
     int getWidth() const;
     float getScale() const;
+    /// The width of a space between two elements
+    int getSpaceWidth() const;
+    // the settings the layout was made with, valid after begin
+    const LayoutSettings &getSettings() const;
 
     // methods
     void begin(int width_, float scale_, MessageFlags flags_);
@@ -68,7 +74,8 @@ struct MessageLayoutContainer {
 
     // painting
     void paintElements(QPainter &painter);
-    void paintAnimatedElements(QPainter &painter, int yOffset);
+    /// Returns the area covered by the animated images that were painted
+    QRegion paintAnimatedElements(QPainter &painter, int yOffset);
     void paintSelection(QPainter &painter, int messageIndex,
                         Selection &selection, int yOffset);
 
@@ -92,6 +99,9 @@ private:
     // helpers
     void _addElement(MessageLayoutElement *element, bool forceAdd = false);
     bool canCollapse();
+    // the line whose rect contains y, lines_ must not be empty
+    std::vector<Line>::const_iterator lineAt(int y) const;
+    MessageLayoutElement *getElementAt(const Line &line, QPoint point);
 
     // variables
     float scale_ = 1.f;
@@ -109,6 +119,7 @@ private:
     int dotdotdotWidth_ = 0;
     bool canAddMessages_ = true;
     bool isCollapsed_ = false;
+    std::shared_ptr<const LayoutSettings> settings_;
 
     std::vector<std::unique_ptr<MessageLayoutElement>> elements_;
     std::vector<Line> lines_;
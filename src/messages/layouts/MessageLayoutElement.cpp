@@ -4,6 +4,8 @@
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
 #include "messages/MessageElement.hpp"
+#include "messages/layouts/ModerationButtonStrip.hpp"
+#include "messages/layouts/ScaledPixmaps.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
 #include "singletons/Theme.hpp"
 #include "util/DebugCount.hpp"
@@ -13,6 +15,12 @@
 
 namespace chatterino {
 
+namespace {
+
+    DebugCounter layoutElementCount("message layout elements");
+
+}  // namespace
+
 const QRect &MessageLayoutElement::getRect() const
 {
     return this->rect_;
@@ -23,12 +31,12 @@ MessageLayoutElement::MessageLayoutElement(MessageElement &creator,
     : creator_(creator)
 {
     this->rect_.setSize(size);
-    DebugCount::increase("message layout elements");
+    layoutElementCount.increase();
 }
 
 MessageLayoutElement::~MessageLayoutElement()
 {
-    DebugCount::decrease("message layout elements");
+    layoutElementCount.decrease();
 }
 
 MessageElement &MessageLayoutElement::getCreator() const
@@ -80,6 +88,11 @@ const Link &MessageLayoutElement::getLink() const
     return this->link_;
 }
 
+const Link &MessageLayoutElement::getLinkAt(const QPoint &abs) const
+{
+    return this->link_;
+}
+
 const QString &MessageLayoutElement::getText() const
 {
     return this->text_;
@@ -109,8 +122,8 @@ void ImageLayoutElement::addCopyTextToString(QString &str, int from,
         dynamic_cast<EmoteElement *>(&this->getCreator());
     if (emoteElement)
     {
-        str += emoteElement->getEmote()->getCopyString();
-        str = TwitchEmotes::cleanUpEmoteCode(str);
+        str += TwitchEmotes::cleanUpEmoteCode(
+            emoteElement->getEmote()->getCopyString());
         if (this->hasTrailingSpace())
         {
             str += " ";
@@ -133,16 +146,15 @@ void ImageLayoutElement::paint(QPainter &painter)
     auto pixmap = this->image_->pixmapOrLoad();
     if (pixmap && !this->image_->animated())
     {
-        // fourtf: make it use qreal values
-        painter.drawPixmap(QRectF(this->getRect()), *pixmap, QRectF());
+        ScaledPixmaps::instance().draw(painter, this->getRect(), *pixmap);
     }
 }
 
-void ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
+bool ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
 {
     if (this->image_ == nullptr)
     {
-        return;
+        return false;
     }
 
     if (this->image_->animated())
@@ -151,9 +163,12 @@ void ImageLayoutElement::paintAnimated(QPainter &painter, int yOffset)
         {
             auto rect = this->getRect();
             rect.moveTop(rect.y() + yOffset);
-            painter.drawPixmap(QRectF(rect), *pixmap, QRectF());
+            ScaledPixmaps::instance().draw(painter, rect, *pixmap);
+            return true;
         }
     }
+
+    return false;
 }
 
 int ImageLayoutElement::getMouseOverIndex(const QPoint &abs) const
@@ -200,8 +215,7 @@ void ImageWithBackgroundLayoutElement::paint(QPainter &painter)
     {
         painter.fillRect(QRectF(this->getRect()), this->color_);
 
-        // fourtf: make it use qreal values
-        painter.drawPixmap(QRectF(this->getRect()), *pixmap, QRectF());
+        ScaledPixmaps::instance().draw(painter, this->getRect(), *pixmap);
     }
 }
 
@@ -248,17 +262,25 @@ void TextLayoutElement::paint(QPainter &painter)
 {
     auto app = getApp();
 
-    painter.setPen(this->color_);
+    auto font = app->fonts->getFont(this->style_, this->scale_);
+
+    // the text can still change after the element was created
+    if (this->staticText_.text() != this->getText())
+    {
+        this->staticText_.setText(this->getText());
+        this->staticText_.setTextFormat(Qt::PlainText);
+        this->staticText_.prepare(QTransform(), font);
+    }
 
-    painter.setFont(app->fonts->getFont(this->style_, this->scale_));
+    painter.setPen(this->color_);
+    painter.setFont(font);
 
-    painter.drawText(
-        QRectF(this->getRect().x(), this->getRect().y(), 10000, 10000),
-        this->getText(), QTextOption(Qt::AlignLeft | Qt::AlignTop));
+    painter.drawStaticText(this->getRect().topLeft(), this->staticText_);
 }
 
-void TextLayoutElement::paintAnimated(QPainter &, int)
+bool TextLayoutElement::paintAnimated(QPainter &, int)
 {
+    return false;
 }
 
 int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
@@ -270,13 +292,13 @@ int TextLayoutElement::getMouseOverIndex(const QPoint &abs) const
 
     auto app = getApp();
 
-    auto metrics = app->fonts->getFontMetrics(this->style_, this->scale_);
     auto x = this->getRect().left();
 
     for (auto i = 0; i < this->getText().size(); i++)
     {
         auto &&text = this->getText();
-        auto width = metrics.horizontalAdvance(this->getText()[i]);
+        auto width = app->fonts->horizontalAdvance(this->style_, this->scale_,
+                                                   this->getText()[i]);
 
         if (x + width > abs.x())
         {
@@ -303,9 +325,6 @@ int TextLayoutElement::getXFromIndex(int index)
 {
     auto app = getApp();
 
-    QFontMetrics metrics =
-        app->fonts->getFontMetrics(this->style_, this->scale_);
-
     if (index <= 0)
     {
         return this->getRect().left();
@@ -315,7 +334,8 @@ int TextLayoutElement::getXFromIndex(int index)
         int x = 0;
         for (int i = 0; i < index; i++)
         {
-            x += metrics.horizontalAdvance(this->getText()[i]);
+            x += app->fonts->horizontalAdvance(this->style_, this->scale_,
+                                               this->getText()[i]);
         }
         return x + this->getRect().left();
     }
@@ -325,81 +345,58 @@ int TextLayoutElement::getXFromIndex(int index)
     }
 }
 
-// TEXT ICON
-TextIconLayoutElement::TextIconLayoutElement(MessageElement &creator,
-                                             const QString &_line1,
-                                             const QString &_line2,
-                                             float _scale, const QSize &size)
-    : MessageLayoutElement(creator, size)
-    , scale(_scale)
-    , line1(_line1)
-    , line2(_line2)
+//
+// MODERATION BUTTONS
+//
+
+ModerationButtonsLayoutElement::ModerationButtonsLayoutElement(
+    MessageElement &creator, std::shared_ptr<ModerationButtonStrip> strip)
+    : MessageLayoutElement(creator, strip->size())
+    , strip_(std::move(strip))
 {
 }
 
-void TextIconLayoutElement::addCopyTextToString(QString &str, int from,
-                                                int to) const
+const Link &ModerationButtonsLayoutElement::getLinkAt(const QPoint &abs) const
 {
+    return this->strip_->linkAt(abs.x() - this->getRect().x());
 }
 
-int TextIconLayoutElement::getSelectionIndexCount() const
+void ModerationButtonsLayoutElement::addCopyTextToString(QString &str,
+                                                         int from,
+                                                         int to) const
 {
-    return this->trailingSpace ? 2 : 1;
 }
 
-void TextIconLayoutElement::paint(QPainter &painter)
+int ModerationButtonsLayoutElement::getSelectionIndexCount() const
 {
-    auto app = getApp();
-
-    QFont font = app->fonts->getFont(FontStyle::Tiny, this->scale);
-
-    painter.setPen(app->themes->messages.textColors.system);
-    painter.setFont(font);
-
-    QTextOption option;
-    option.setAlignment(Qt::AlignHCenter);
+    return this->trailingSpace ? 2 : 1;
+}
 
-    if (this->line2.isEmpty())
-    {
-        QRect _rect(this->getRect());
-        painter.drawText(_rect, this->line1, option);
-    }
-    else
-    {
-        painter.drawText(
-            QPoint(this->getRect().x(),
-                   this->getRect().y() + this->getRect().height() / 2),
-            this->line1);
-        painter.drawText(QPoint(this->getRect().x(),
-                                this->getRect().y() + this->getRect().height()),
-                         this->line2);
-    }
+void ModerationButtonsLayoutElement::paint(QPainter &painter)
+{
+    this->strip_->paint(painter, this->getRect().topLeft());
 }
 
-void TextIconLayoutElement::paintAnimated(QPainter &painter, int yOffset)
+bool ModerationButtonsLayoutElement::paintAnimated(QPainter &painter,
+                                                   int yOffset)
 {
+    auto topLeft = this->getRect().topLeft();
+    topLeft.ry() += yOffset;
+    return this->strip_->paintAnimated(painter, topLeft);
 }
 
-int TextIconLayoutElement::getMouseOverIndex(const QPoint &abs) const
+int ModerationButtonsLayoutElement::getMouseOverIndex(const QPoint &abs) const
 {
     return 0;
 }
 
-int TextIconLayoutElement::getXFromIndex(int index)
+int ModerationButtonsLayoutElement::getXFromIndex(int index)
 {
     if (index <= 0)
     {
         return this->getRect().left();
     }
-    else if (index == 1)
-    {
-        // fourtf: remove space width
-        return this->getRect().right();
-    }
-    else
-    {
-        return this->getRect().right();
-    }
+    return this->getRect().right();
 }
 
 }  // namespace chatterino
@@ -2,6 +2,7 @@
 
 #include <QPoint>
 #include <QRect>
+#include <QStaticText>
 #include <QString>
 #include <boost/noncopyable.hpp>
 #include <climits>
@@ -18,6 +19,7 @@ class QPainter;
 namespace chatterino {
 class MessageElement;
 class Image;
+class ModerationButtonStrip;
 using ImagePtr = std::shared_ptr<Image>;
 enum class FontStyle : uint8_t;
 
@@ -42,11 +44,15 @@ public:
                                      int to = INT_MAX) const = 0;
     virtual int getSelectionIndexCount() const = 0;
     virtual void paint(QPainter &painter) = 0;
-    virtual void paintAnimated(QPainter &painter, int yOffset) = 0;
+    /// Returns true if an animated image was painted
+    virtual bool paintAnimated(QPainter &painter, int yOffset) = 0;
     virtual int getMouseOverIndex(const QPoint &abs) const = 0;
     virtual int getXFromIndex(int index) = 0;
 
     const Link &getLink() const;
+    /// The link at a point within the element, getLink unless it has more
+    /// than one
+    virtual const Link &getLinkAt(const QPoint &abs) const;
     const QString &getText() const;
     FlagsEnum<MessageElementFlag> getFlags() const;
 
@@ -73,7 +79,7 @@ protected:
                              int to = INT_MAX) const override;
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
-    void paintAnimated(QPainter &painter, int yOffset) override;
+    bool paintAnimated(QPainter &painter, int yOffset) override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
@@ -108,7 +114,7 @@ protected:
                              int to = INT_MAX) const override;
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
-    void paintAnimated(QPainter &painter, int yOffset) override;
+    bool paintAnimated(QPainter &painter, int yOffset) override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
@@ -116,30 +122,33 @@ protected:
     FontStyle style_;
     float scale_;
 
+    // keeps the shaped glyphs between paints, prepared on the first paint
+    QStaticText staticText_;
+
     pajlada::Signals::SignalHolder managedConnections_;
 };
 
-// TEXT ICON
-// two lines of text (characters) in the size of a normal chat badge
-class TextIconLayoutElement : public MessageLayoutElement
+// MODERATION BUTTONS
+// all moderation buttons of a message, drawn from a strip shared by messages
+class ModerationButtonsLayoutElement : public MessageLayoutElement
 {
 public:
-    TextIconLayoutElement(MessageElement &creator_, const QString &line1,
-                          const QString &line2, float scale, const QSize &size);
+    ModerationButtonsLayoutElement(
+        MessageElement &creator, std::shared_ptr<ModerationButtonStrip> strip);
+
+    const Link &getLinkAt(const QPoint &abs) const override;
 
 protected:
     void addCopyTextToString(QString &str, int from = 0,
                              int to = INT_MAX) const override;
     int getSelectionIndexCount() const override;
     void paint(QPainter &painter) override;
-    void paintAnimated(QPainter &painter, int yOffset) override;
+    bool paintAnimated(QPainter &painter, int yOffset) override;
     int getMouseOverIndex(const QPoint &abs) const override;
     int getXFromIndex(int index) override;
 
 private:
-    float scale;
-    QString line1;
-    QString line2;
+    std::shared_ptr<ModerationButtonStrip> strip_;
 };
 
 }  // namespace chatterino
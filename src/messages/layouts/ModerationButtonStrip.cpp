@@ -0,0 +1,233 @@
+#include "messages/layouts/ModerationButtonStrip.hpp"
+
+#include "Application.hpp"
+#include "controllers/moderationactions/ModerationAction.hpp"
+#include "messages/Image.hpp"
+#include "messages/layouts/ScaledPixmaps.hpp"
+#include "singletons/Fonts.hpp"
+#include "singletons/Settings.hpp"
+#include "singletons/Theme.hpp"
+
+#include <QPainter>
+#include <QTextOption>
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    // one per scale and spacing the chat is shown at
+    constexpr size_t MAX_STRIPS = 8;
+
+    // the size of a chat badge
+    constexpr int BUTTON_SIZE = 16;
+
+    void paintTextIcon(QPainter &painter, const QRect &rect,
+                       const QString &line1, const QString &line2)
+    {
+        if (line2.isEmpty())
+        {
+            QTextOption option;
+            option.setAlignment(Qt::AlignHCenter);
+            painter.drawText(rect, line1, option);
+        }
+        else
+        {
+            painter.drawText(QPoint(rect.x(), rect.y() + rect.height() / 2),
+                             line1);
+            painter.drawText(QPoint(rect.x(), rect.y() + rect.height()),
+                             line2);
+        }
+    }
+
+}  // namespace
+
+std::shared_ptr<ModerationButtonStrip> ModerationButtonStrip::get(
+    float scale, int spacing)
+{
+    auto actions = getCSettings().moderationActions.readOnly();
+    if (actions->empty())
+    {
+        return nullptr;
+    }
+
+    auto color = getApp()->themes->messages.textColors.system;
+    auto font = getApp()->fonts->getFont(FontStyle::Tiny, scale);
+
+    // most recently used first
+    static std::vector<std::shared_ptr<ModerationButtonStrip>> strips;
+
+    // the ones made for other actions or another theme are outdated
+    strips.erase(std::remove_if(strips.begin(), strips.end(),
+                                [&](const auto &strip) {
+                                    return strip->actions_ != actions ||
+                                           strip->color_ != color;
+                                }),
+                 strips.end());
+
+    auto it =
+        std::find_if(strips.begin(), strips.end(), [&](const auto &strip) {
+            return strip->scale_ == scale && strip->spacing_ == spacing;
+        });
+    if (it != strips.end() && (*it)->font_ == font)
+    {
+        std::rotate(strips.begin(), it, it + 1);
+        return strips.front();
+    }
+    if (it != strips.end())
+    {
+        strips.erase(it);
+    }
+
+    std::shared_ptr<ModerationButtonStrip> strip(new ModerationButtonStrip(
+        std::move(actions), scale, spacing, color, font));
+    strips.insert(strips.begin(), strip);
+    if (strips.size() > MAX_STRIPS)
+    {
+        strips.pop_back();
+    }
+    return strip;
+}
+
+ModerationButtonStrip::ModerationButtonStrip(Actions actions, float scale,
+                                             int spacing, QColor color,
+                                             QFont font)
+    : actions_(std::move(actions))
+    , scale_(scale)
+    , spacing_(spacing)
+    , buttonSize_(int(scale * BUTTON_SIZE))
+    , color_(color)
+    , font_(std::move(font))
+{
+    this->links_.reserve(this->actions_->size());
+    for (const auto &action : *this->actions_)
+    {
+        this->links_.emplace_back(Link::UserAction, action.getAction());
+    }
+}
+
+QSize ModerationButtonStrip::size() const
+{
+    return {this->buttonX(this->links_.size()) - this->spacing_,
+            this->buttonSize_};
+}
+
+const Link &ModerationButtonStrip::linkAt(int x) const
+{
+    static const Link empty;
+
+    auto stride = this->buttonSize_ + this->spacing_;
+    if (x < 0 || stride <= 0)
+    {
+        return empty;
+    }
+
+    auto index = size_t(x / stride);
+    if (index >= this->links_.size() || x % stride >= this->buttonSize_)
+    {
+        return empty;
+    }
+    return this->links_[index];
+}
+
+void ModerationButtonStrip::paint(QPainter &painter, const QPoint &topLeft)
+{
+    // images that failed to load don't make it draw again on every paint
+    auto ratio = painter.device()->devicePixelRatioF();
+    if (this->pixmap_.isNull() || this->pixmap_.devicePixelRatioF() != ratio ||
+        (!this->complete_ && this->loadedImages() > this->loadedImages_))
+    {
+        this->render(ratio);
+    }
+
+    painter.drawPixmap(topLeft, this->pixmap_);
+}
+
+bool ModerationButtonStrip::paintAnimated(QPainter &painter,
+                                          const QPoint &topLeft)
+{
+    bool painted = false;
+    for (size_t i = 0; i < this->actions_->size(); i++)
+    {
+        const auto &image = (*this->actions_)[i].getImage();
+        if (!image || !(*image)->animated())
+        {
+            continue;
+        }
+
+        if (auto pixmap = (*image)->pixmapOrLoad())
+        {
+            QRect rect(topLeft.x() + this->buttonX(i), topLeft.y(),
+                       this->buttonSize_, this->buttonSize_);
+            ScaledPixmaps::instance().draw(painter, rect, *pixmap);
+            painted = true;
+        }
+    }
+    return painted;
+}
+
+int ModerationButtonStrip::buttonX(size_t index) const
+{
+    return int(index) * (this->buttonSize_ + this->spacing_);
+}
+
+size_t ModerationButtonStrip::loadedImages() const
+{
+    return size_t(std::count_if(this->actions_->begin(), this->actions_->end(),
+                                [](const auto &action) {
+                                    const auto &image = action.getImage();
+                                    return image && (*image)->pixmapOrLoad();
+                                }));
+}
+
+void ModerationButtonStrip::render(qreal ratio)
+{
+    auto size = this->size();
+    QPixmap pixmap(qRound(size.width() * ratio), qRound(size.height() * ratio));
+    pixmap.setDevicePixelRatio(ratio);
+    pixmap.fill(Qt::transparent);
+
+    QPainter painter(&pixmap);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.setPen(this->color_);
+    painter.setFont(this->font_);
+
+    size_t loaded = 0;
+    bool complete = true;
+    for (size_t i = 0; i < this->actions_->size(); i++)
+    {
+        const auto &action = (*this->actions_)[i];
+        QRect rect(this->buttonX(i), 0, this->buttonSize_, this->buttonSize_);
+
+        if (const auto &image = action.getImage())
+        {
+            auto pixmap = (*image)->pixmapOrLoad();
+            if (!pixmap)
+            {
+                // drawn once it's loaded
+                complete = false;
+                continue;
+            }
+
+            loaded++;
+            // animated ones are drawn on every paint instead
+            if (!(*image)->animated())
+            {
+                painter.drawPixmap(QRectF(rect), *pixmap, QRectF());
+            }
+        }
+        else
+        {
+            paintTextIcon(painter, rect, action.getLine1(), action.getLine2());
+        }
+    }
+
+    painter.end();
+
+    this->pixmap_ = std::move(pixmap);
+    this->complete_ = complete;
+    this->loadedImages_ = loaded;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "messages/Link.hpp"
+
+#include <QColor>
+#include <QFont>
+#include <QPixmap>
+#include <QSize>
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <vector>
+
+class QPainter;
+class QPoint;
+
+namespace chatterino {
+
+class ModerationAction;
+
+/**
+ * @brief The moderation buttons of a message, drawn once and shared by every
+ * message laid out at the same scale.
+ *
+ * All buttons have the same size and gap, so the button under a point is
+ * found arithmetically. Animated images are the only buttons drawn on every
+ * paint. Strips are made again once the moderation actions, the theme or
+ * the font change.
+ *
+ * Must only be used from the GUI thread.
+ */
+class ModerationButtonStrip : boost::noncopyable
+{
+public:
+    /// The strip of the current moderation actions, nullptr if there are none
+    static std::shared_ptr<ModerationButtonStrip> get(float scale,
+                                                      int spacing);
+
+    QSize size() const;
+    /// The link of the button at x, relative to the left of the strip, an
+    /// empty link between buttons
+    const Link &linkAt(int x) const;
+
+    void paint(QPainter &painter, const QPoint &topLeft);
+    /// Returns true if an animated image was painted
+    bool paintAnimated(QPainter &painter, const QPoint &topLeft);
+
+private:
+    using Actions = std::shared_ptr<const std::vector<ModerationAction>>;
+
+    ModerationButtonStrip(Actions actions, float scale, int spacing,
+                          QColor color, QFont font);
+
+    // the left of the button at index, relative to the left of the strip
+    int buttonX(size_t index) const;
+    size_t loadedImages() const;
+    void render(qreal ratio);
+
+    Actions actions_;
+    std::vector<Link> links_;
+    float scale_;
+    int spacing_;
+    int buttonSize_;
+    QColor color_;
+    QFont font_;
+
+    QPixmap pixmap_;
+    // set once all images were loaded and drawn
+    bool complete_ = false;
+    size_t loadedImages_ = 0;
+};
+
+}  // namespace chatterino
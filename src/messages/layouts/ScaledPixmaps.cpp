@@ -0,0 +1,93 @@
+#include "messages/layouts/ScaledPixmaps.hpp"
+
+#include "util/MemoryUsage.hpp"
+
+#include <QPainter>
+#include <QRect>
+
+#include <algorithm>
+
+namespace chatterino {
+namespace {
+    // enough for a few thousand emotes at a typical scale
+    constexpr int64_t BUDGET_BYTES = 32 * 1024 * 1024;
+
+    int64_t pixmapBytes(const QPixmap &pixmap)
+    {
+        return int64_t(pixmap.width()) * pixmap.height() *
+               std::max(1, pixmap.depth()) / 8;
+    }
+}  // namespace
+
+ScaledPixmaps &ScaledPixmaps::instance()
+{
+    static ScaledPixmaps instance;
+    return instance;
+}
+
+void ScaledPixmaps::draw(QPainter &painter, const QRect &rect,
+                         const QPixmap &pixmap)
+{
+    auto ratio = painter.device()->devicePixelRatioF();
+    QSize size(qRound(rect.width() * ratio), qRound(rect.height() * ratio));
+
+    if (size.isEmpty() || pixmap.isNull() || painter.transform().isScaling())
+    {
+        painter.drawPixmap(QRectF(rect), pixmap, QRectF());
+        return;
+    }
+
+    painter.drawPixmap(rect.topLeft(), this->get(pixmap, size, ratio));
+}
+
+int64_t ScaledPixmaps::bytes() const
+{
+    return this->bytes_;
+}
+
+const QPixmap &ScaledPixmaps::get(const QPixmap &pixmap, QSize size,
+                                  qreal ratio)
+{
+    if (pixmap.size() == size && pixmap.devicePixelRatioF() == ratio)
+    {
+        return pixmap;
+    }
+
+    Key key{pixmap.cacheKey(), size.width(), size.height()};
+    auto it = this->lookup_.find(key);
+    if (it != this->lookup_.end())
+    {
+        this->entries_.splice(this->entries_.begin(), this->entries_,
+                              it->second);
+        return it->second->pixmap;
+    }
+
+    auto scaled =
+        pixmap.scaled(size, Qt::IgnoreAspectRatio, Qt::SmoothTransformation);
+    scaled.setDevicePixelRatio(ratio);
+    auto bytes = pixmapBytes(scaled);
+
+    this->entries_.push_front({key, std::move(scaled), bytes});
+    this->lookup_.emplace(key, this->entries_.begin());
+    this->bytes_ += bytes;
+    MemoryUsage::increase(MemoryCategory::Images, bytes);
+
+    this->evict();
+
+    return this->entries_.front().pixmap;
+}
+
+void ScaledPixmaps::evict()
+{
+    // the pixmap that was just scaled is always kept
+    while (this->bytes_ > BUDGET_BYTES && this->entries_.size() > 1)
+    {
+        auto &entry = this->entries_.back();
+        this->bytes_ -= entry.bytes;
+        MemoryUsage::increase(MemoryCategory::Images, -entry.bytes);
+        this->lookup_.erase(entry.key);
+        this->entries_.pop_back();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,76 @@
+#pragma once
+
+#include <QPixmap>
+#include <QSize>
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+
+class QPainter;
+class QRect;
+
+namespace chatterino {
+
+/**
+ * @brief Copies of emote and badge pixmaps scaled to the size they are drawn
+ * at.
+ *
+ * Drawing a pixmap into a rect of another size scales it on every paint.
+ * Images are drawn at a few sizes only, one per emote scale, so the scaled
+ * copies are kept and drawn without any transform. The least recently drawn
+ * copies are removed once they take up more than a fixed budget.
+ *
+ * Must only be used from the GUI thread.
+ */
+class ScaledPixmaps : boost::noncopyable
+{
+public:
+    static ScaledPixmaps &instance();
+
+    /// Draws pixmap into rect, scaled for the device of painter
+    void draw(QPainter &painter, const QRect &rect, const QPixmap &pixmap);
+
+    int64_t bytes() const;
+
+private:
+    ScaledPixmaps() = default;
+
+    struct Key {
+        qint64 cacheKey;
+        int width;
+        int height;
+
+        bool operator==(const Key &other) const
+        {
+            return this->cacheKey == other.cacheKey &&
+                   this->width == other.width && this->height == other.height;
+        }
+    };
+
+    struct KeyHash {
+        size_t operator()(const Key &key) const
+        {
+            return std::hash<qint64>()(key.cacheKey) ^
+                   (size_t(key.width) << 16) ^ size_t(key.height);
+        }
+    };
+
+    struct Entry {
+        Key key;
+        QPixmap pixmap;
+        int64_t bytes;
+    };
+
+    const QPixmap &get(const QPixmap &pixmap, QSize size, qreal ratio);
+    void evict();
+
+    // most recently drawn first
+    std::list<Entry> entries_;
+    std::unordered_map<Key, std::list<Entry>::iterator, KeyHash> lookup_;
+    int64_t bytes_ = 0;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,143 @@
+#include "messages/layouts/SharedMessageLayouts.hpp"
+
+#include "messages/layouts/MessageLayoutContainer.hpp"
+#include "util/DebugCount.hpp"
+
+#include <QPixmap>
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    DebugCounter sharedLayoutCount("shared message layouts");
+
+}  // namespace
+
+bool SharedMessageLayouts::LayoutParams::operator==(
+    const LayoutParams &other) const
+{
+    return this->width == other.width && this->scale == other.scale &&
+           this->flags == other.flags &&
+           this->messageFlags == other.messageFlags &&
+           this->generation == other.generation;
+}
+
+bool SharedMessageLayouts::BufferParams::operator==(
+    const BufferParams &other) const
+{
+    return this->width == other.width &&
+           this->devicePixelRatio == other.devicePixelRatio &&
+           this->alternateBackground == other.alternateBackground &&
+           this->ignoreHighlights == other.ignoreHighlights &&
+           this->generation == other.generation;
+}
+
+SharedMessageLayouts &SharedMessageLayouts::instance()
+{
+    static SharedMessageLayouts instance;
+    return instance;
+}
+
+std::shared_ptr<MessageLayoutContainer> SharedMessageLayouts::find(
+    const Message *message, const LayoutParams &params)
+{
+    auto it = this->layouts_.find(message);
+    if (it == this->layouts_.end())
+    {
+        return nullptr;
+    }
+
+    for (const auto &layout : it->second)
+    {
+        if (layout.params == params)
+        {
+            return layout.container.lock();
+        }
+    }
+
+    return nullptr;
+}
+
+std::shared_ptr<MessageLayoutContainer> SharedMessageLayouts::make(
+    const Message *message, const LayoutParams &params)
+{
+    auto container = std::shared_ptr<MessageLayoutContainer>(
+        new MessageLayoutContainer, [message](MessageLayoutContainer *c) {
+            SharedMessageLayouts::instance().remove(message, c);
+            delete c;
+        });
+
+    this->layouts_[message].push_back({params, container});
+    sharedLayoutCount.increase();
+
+    return container;
+}
+
+std::shared_ptr<QPixmap> SharedMessageLayouts::findBuffer(
+    const MessageLayoutContainer *container, const BufferParams &params)
+{
+    auto it = this->buffers_.find(container);
+    if (it == this->buffers_.end())
+    {
+        return nullptr;
+    }
+
+    for (const auto &buffer : it->second)
+    {
+        if (buffer.params == params)
+        {
+            return buffer.pixmap.lock();
+        }
+    }
+
+    return nullptr;
+}
+
+void SharedMessageLayouts::addBuffer(const MessageLayoutContainer *container,
+                                     const BufferParams &params,
+                                     const std::shared_ptr<QPixmap> &buffer)
+{
+    auto &buffers = this->buffers_[container];
+
+    // replaces the buffer with the same parameters, deleted buffers and the
+    // ones of older generations are of no use
+    buffers.erase(std::remove_if(buffers.begin(), buffers.end(),
+                                 [&](const Buffer &b) {
+                                     return b.pixmap.expired() ||
+                                            b.params == params ||
+                                            b.params.generation !=
+                                                params.generation;
+                                 }),
+                  buffers.end());
+    buffers.push_back({params, buffer});
+}
+
+void SharedMessageLayouts::remove(const Message *message,
+                                  const MessageLayoutContainer *container)
+{
+    this->buffers_.erase(container);
+
+    auto it = this->layouts_.find(message);
+    if (it == this->layouts_.end())
+    {
+        return;
+    }
+
+    auto &layouts = it->second;
+    auto before = layouts.size();
+    layouts.erase(std::remove_if(layouts.begin(), layouts.end(),
+                                 [&](const Layout &layout) {
+                                     return layout.container.expired();
+                                 }),
+                  layouts.end());
+    sharedLayoutCount.decrease(int64_t(before - layouts.size()));
+
+    if (layouts.empty())
+    {
+        this->layouts_.erase(it);
+    }
+}
+
+}  // namespace chatterino
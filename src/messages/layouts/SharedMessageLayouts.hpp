@@ -0,0 +1,115 @@
+#pragma once
+
+#include "common/FlagsEnum.hpp"
+
+#include <QtGlobal>
+#include <boost/noncopyable.hpp>
+
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+class QPixmap;
+
+namespace chatterino {
+
+struct Message;
+struct MessageLayoutContainer;
+
+enum class MessageElementFlag : int64_t;
+using MessageElementFlags = FlagsEnum<MessageElementFlag>;
+
+enum class MessageFlag : uint32_t;
+using MessageFlags = FlagsEnum<MessageFlag>;
+
+/**
+ * @brief Laid out messages and their buffers shared between views.
+ *
+ * A message shown in several splits of the same width, for example one
+ * filtered and one unfiltered split of a channel, has a MessageLayout in
+ * each of them. The layouts look up the elements another layout of the
+ * message made with the same parameters and the buffer painted from them
+ * with the same background, so the message is laid out and painted once.
+ *
+ * Only weak references are kept, a layout or buffer is forgotten once no
+ * MessageLayout uses it anymore. Shared buffers must not be painted on, a
+ * layout that has to paint its buffer again uses a new one.
+ *
+ * Must only be used from the GUI thread.
+ */
+class SharedMessageLayouts : boost::noncopyable
+{
+public:
+    /// What a message was laid out with, layouts with the same parameters
+    /// have the same elements
+    struct LayoutParams {
+        int width;
+        float scale;
+        MessageElementFlags flags;
+        // the flags of the message as laid out, in expanded messages
+        // Collapsed is unset
+        MessageFlags messageFlags;
+        // generation of the windows, see WindowManager::getGeneration
+        int generation;
+
+        bool operator==(const LayoutParams &other) const;
+    };
+
+    /// What a buffer was painted with besides the elements
+    struct BufferParams {
+        int width;
+        qreal devicePixelRatio;
+        bool alternateBackground;
+        bool ignoreHighlights;
+        // see WindowManager::getBufferGeneration
+        int generation;
+
+        bool operator==(const BufferParams &other) const;
+    };
+
+    static SharedMessageLayouts &instance();
+
+    /// Returns the elements another layout of the message made with the
+    /// parameters, nullptr if there are none
+    std::shared_ptr<MessageLayoutContainer> find(const Message *message,
+                                                 const LayoutParams &params);
+    /// Returns an empty container which is found by the parameters from now
+    /// on, the caller has to lay the message out in it right away
+    std::shared_ptr<MessageLayoutContainer> make(const Message *message,
+                                                 const LayoutParams &params);
+
+    /// Returns the buffer another layout painted from the container with the
+    /// parameters, nullptr if there is none
+    std::shared_ptr<QPixmap> findBuffer(const MessageLayoutContainer *container,
+                                        const BufferParams &params);
+    /// Shares the buffer that was just painted from the container
+    void addBuffer(const MessageLayoutContainer *container,
+                   const BufferParams &params,
+                   const std::shared_ptr<QPixmap> &buffer);
+
+private:
+    SharedMessageLayouts() = default;
+
+    struct Layout {
+        LayoutParams params;
+        std::weak_ptr<MessageLayoutContainer> container;
+    };
+
+    struct Buffer {
+        BufferParams params;
+        std::weak_ptr<QPixmap> pixmap;
+    };
+
+    // called once no layout uses the container anymore
+    void remove(const Message *message,
+                const MessageLayoutContainer *container);
+
+    // a message rarely has more than a few layouts, they're looked up
+    // linearly
+    std::unordered_map<const Message *, std::vector<Layout>> layouts_;
+    std::unordered_map<const MessageLayoutContainer *, std::vector<Buffer>>
+        buffers_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,187 @@
+#include "messages/search/MessageTokenIndex.hpp"
+
+#include "messages/Message.hpp"
+
+#include <QRegularExpression>
+
+#include <algorithm>
+#include <iterator>
+
+namespace chatterino {
+
+namespace {
+
+    void insertPosition(std::deque<int64_t> &positions, int64_t position)
+    {
+        // messages are mostly added at the end
+        if (positions.empty() || positions.back() < position)
+        {
+            positions.push_back(position);
+            return;
+        }
+
+        auto it =
+            std::lower_bound(positions.begin(), positions.end(), position);
+        if (it == positions.end() || *it != position)
+        {
+            positions.insert(it, position);
+        }
+    }
+
+    void erasePosition(std::deque<int64_t> &positions, int64_t position)
+    {
+        // and mostly removed from the start
+        if (!positions.empty() && positions.front() == position)
+        {
+            positions.pop_front();
+            return;
+        }
+
+        auto it =
+            std::lower_bound(positions.begin(), positions.end(), position);
+        if (it != positions.end() && *it == position)
+        {
+            positions.erase(it);
+        }
+    }
+
+    // merges the sorted position lists
+    std::vector<int64_t> collect(
+        const std::vector<const std::deque<int64_t> *> &lists)
+    {
+        std::vector<int64_t> positions;
+        for (const auto *list : lists)
+        {
+            positions.insert(positions.end(), list->begin(), list->end());
+        }
+
+        if (lists.size() > 1)
+        {
+            std::sort(positions.begin(), positions.end());
+            positions.erase(std::unique(positions.begin(), positions.end()),
+                            positions.end());
+        }
+
+        return positions;
+    }
+
+    void uniqueKeys(std::vector<QString> &keys)
+    {
+        std::sort(keys.begin(), keys.end());
+        keys.erase(std::unique(keys.begin(), keys.end()), keys.end());
+    }
+
+}  // namespace
+
+void MessageTokenIndex::add(const Message &message, int64_t position)
+{
+    for (const auto &word : words(message))
+    {
+        insertPosition(this->words_[word], position);
+    }
+
+    for (const auto &author : authors(message))
+    {
+        insertPosition(this->authors_[author], position);
+    }
+}
+
+void MessageTokenIndex::remove(const Message &message, int64_t position)
+{
+    auto removeFrom = [position](auto &map, const std::vector<QString> &keys) {
+        for (const auto &key : keys)
+        {
+            auto it = map.find(key);
+            if (it == map.end())
+            {
+                continue;
+            }
+
+            erasePosition(it->second, position);
+            if (it->second.empty())
+            {
+                map.erase(it);
+            }
+        }
+    };
+
+    removeFrom(this->words_, words(message));
+    removeFrom(this->authors_, authors(message));
+}
+
+std::vector<int64_t> MessageTokenIndex::findSubstring(
+    const QString &text) const
+{
+    auto folded = text.toCaseFolded();
+
+    // a substring without whitespace can't span words, so the words that
+    // contain it are the ones to look at
+    std::vector<const Postings *> lists;
+    for (const auto &[word, positions] : this->words_)
+    {
+        if (word.contains(folded))
+        {
+            lists.push_back(&positions);
+        }
+    }
+
+    return collect(lists);
+}
+
+std::vector<int64_t> MessageTokenIndex::findAuthors(
+    const QStringList &names) const
+{
+    std::vector<const Postings *> lists;
+    for (const auto &name : names)
+    {
+        auto it = this->authors_.find(name.toCaseFolded());
+        if (it != this->authors_.end())
+        {
+            lists.push_back(&it->second);
+        }
+    }
+
+    return collect(lists);
+}
+
+std::vector<int64_t> MessageTokenIndex::intersect(
+    const std::vector<int64_t> &a, const std::vector<int64_t> &b)
+{
+    std::vector<int64_t> positions;
+    std::set_intersection(a.begin(), a.end(), b.begin(), b.end(),
+                          std::back_inserter(positions));
+    return positions;
+}
+
+std::vector<QString> MessageTokenIndex::words(const Message &message)
+{
+    static QRegularExpression whitespace(R"(\s+)");
+
+    std::vector<QString> words;
+    for (const auto &word : message.searchText.toCaseFolded().split(
+             whitespace, QString::SkipEmptyParts))
+    {
+        words.push_back(word);
+    }
+
+    // a word that is repeated still only has the position once
+    uniqueKeys(words);
+    return words;
+}
+
+std::vector<QString> MessageTokenIndex::authors(const Message &message)
+{
+    std::vector<QString> authors;
+    for (const auto *name : {&message.loginName, &message.displayName})
+    {
+        if (!name->isEmpty())
+        {
+            authors.push_back(name->toCaseFolded());
+        }
+    }
+
+    uniqueKeys(authors);
+    return authors;
+}
+
+}  // namespace chatterino
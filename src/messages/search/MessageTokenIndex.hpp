@@ -0,0 +1,54 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+struct Message;
+
+/**
+ * @brief Inverted index from the words and authors of messages to the
+ *        positions of the messages in a channel.
+ *
+ * Words are the whitespace separated parts of `Message::searchText`, authors
+ * are the login and display names. Both are case folded, lookups match them
+ * the same way SubstringPredicate and AuthorPredicate do.
+ *
+ * Lookups only narrow the messages down, the predicates still have to check
+ * the messages that are found. Not thread safe.
+ */
+class MessageTokenIndex
+{
+public:
+    void add(const Message &message, int64_t position);
+    void remove(const Message &message, int64_t position);
+
+    /// Returns the sorted positions of the messages whose searchText
+    /// contains the text, which must not contain whitespace
+    std::vector<int64_t> findSubstring(const QString &text) const;
+    /// Returns the sorted positions of the messages sent by any of the names
+    std::vector<int64_t> findAuthors(const QStringList &names) const;
+
+    static std::vector<int64_t> intersect(const std::vector<int64_t> &a,
+                                          const std::vector<int64_t> &b);
+
+private:
+    // sorted positions of the messages with the token
+    using Postings = std::deque<int64_t>;
+
+    static std::vector<QString> words(const Message &message);
+    static std::vector<QString> authors(const Message &message);
+
+    std::unordered_map<QString, Postings> words_;
+    std::unordered_map<QString, Postings> authors_;
+};
+
+}  // namespace chatterino
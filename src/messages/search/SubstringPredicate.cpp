@@ -1,5 +1,7 @@
 #include "messages/search/SubstringPredicate.hpp"
 
+#include "util/CaseInsensitive.hpp"
+
 namespace chatterino {
 
 SubstringPredicate::SubstringPredicate(const QString &search)
@@ -9,7 +11,7 @@ SubstringPredicate::SubstringPredicate(const QString &search)
 
 bool SubstringPredicate::appliesTo(const Message &message)
 {
-    return message.searchText.contains(this->search_, Qt::CaseInsensitive);
+    return containsIgnoreCase(message.searchText, this->search_);
 }
 
 }  // namespace chatterino
@@ -6,11 +6,110 @@
 #include "messages/Image.hpp"
 #include "messages/Link.hpp"
 #include "singletons/Settings.hpp"
+#include "util/QStringHash.hpp"
 
+#include "lrucache/lrucache.hpp"
+
+#include <QPointer>
 #include <QString>
 
+#include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
+
 namespace chatterino {
 
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void(QString, Link, ImagePtr)>;
+
+    // the same links get posted over and over again in big chats
+    constexpr size_t CACHE_SIZE = 500;
+    constexpr auto CACHE_TTL = std::chrono::minutes(10);
+
+    struct LinkInfo {
+        QString tooltip;
+        // the link the resolver followed the url to, empty if it failed
+        QString resolvedLink;
+        // shared by all messages with the link
+        ImagePtr thumbnail;
+        Clock::time_point expiresAt;
+    };
+
+    struct Waiter {
+        QPointer<QObject> caller;
+        bool hasCaller;
+        Callback callback;
+    };
+
+    struct State {
+        std::mutex mutex;
+        cache::lru_cache<QString, LinkInfo> cache{CACHE_SIZE};
+        // the callbacks of the lookups that are running, the first one sent
+        // the request
+        std::unordered_map<QString, std::vector<Waiter>> waiting;
+    };
+
+    State &state()
+    {
+        static State state;
+        return state;
+    }
+
+    void invoke(const LinkInfo &info, const QString &url,
+                const Callback &callback)
+    {
+        auto linkString = url;
+        if (getSettings()->unshortLinks && !info.resolvedLink.isEmpty())
+        {
+            linkString = info.resolvedLink;
+        }
+
+        callback(info.tooltip, Link(Link::Url, linkString), info.thumbnail);
+    }
+
+    void finish(const QString &url, const LinkInfo *info)
+    {
+        std::vector<Waiter> waiters;
+        {
+            std::lock_guard<std::mutex> lock(state().mutex);
+
+            if (info)
+            {
+                state().cache.put(url, *info);
+            }
+
+            auto it = state().waiting.find(url);
+            if (it != state().waiting.end())
+            {
+                waiters = std::move(it->second);
+                state().waiting.erase(it);
+            }
+        }
+
+        for (const auto &waiter : waiters)
+        {
+            if (waiter.hasCaller && waiter.caller.isNull())
+            {
+                continue;
+            }
+
+            if (info)
+            {
+                invoke(*info, url, waiter.callback);
+            }
+            else
+            {
+                waiter.callback("No link info found", Link(Link::Url, url),
+                                nullptr);
+            }
+        }
+    }
+
+}  // namespace
+
 void LinkResolver::getLinkInfo(
     const QString url, QObject *caller,
     std::function<void(QString, Link, ImagePtr)> successCallback)
@@ -20,41 +119,69 @@ void LinkResolver::getLinkInfo(
         successCallback("No link info loaded", Link(Link::Url, url), nullptr);
         return;
     }
+
+    {
+        std::unique_lock<std::mutex> lock(state().mutex);
+
+        auto &cache = state().cache;
+        if (cache.exists(url))
+        {
+            auto info = cache.get(url);
+            if (Clock::now() < info.expiresAt)
+            {
+                lock.unlock();
+                invoke(info, url, successCallback);
+                return;
+            }
+        }
+
+        // only the first lookup of a url sends a request
+        auto &waiters = state().waiting[url];
+        waiters.push_back({caller, caller != nullptr, successCallback});
+        if (waiters.size() > 1)
+        {
+            return;
+        }
+    }
+
     // Uncomment to test crashes
     // QTimer::singleShot(3000, [=]() {
     NetworkRequest(Env::get().linkResolverUrl.arg(QString::fromUtf8(
                        QUrl::toPercentEncoding(url, "", "/:"))))
-        .caller(caller)
         .timeout(30000)
-        .onSuccess(
-            [successCallback, url](NetworkResult result) mutable -> Outcome {
-                auto root = result.parseJson();
-                auto statusCode = root.value("status").toInt();
-                QString response = QString();
-                QString linkString = url;
-                ImagePtr thumbnail = nullptr;
-                if (statusCode == 200)
-                {
-                    response = root.value("tooltip").toString();
-                    thumbnail =
-                        Image::fromUrl({root.value("thumbnail").toString()});
-                    if (getSettings()->unshortLinks)
-                    {
-                        linkString = root.value("link").toString();
-                    }
-                }
-                else
-                {
-                    response = root.value("message").toString();
-                }
-                successCallback(QUrl::fromPercentEncoding(response.toUtf8()),
-                                Link(Link::Url, linkString), thumbnail);
-
-                return Success;
-            })
-        .onError([successCallback, url](auto /*result*/) {
-            successCallback("No link info found", Link(Link::Url, url),
-                            nullptr);
+        .onSuccess([url](NetworkResult result) -> Outcome {
+            auto root = result.parseJson();
+            auto statusCode = root.value("status").toInt();
+
+            LinkInfo info;
+            info.expiresAt = Clock::now() + CACHE_TTL;
+            if (statusCode == 200)
+            {
+                info.tooltip = root.value("tooltip").toString();
+                // thumbnails are only shown in tooltips, at most at the
+                // thumbnail size
+                auto thumbnailSize = getSettings()->thumbnailSize.getValue();
+                Url thumbnail{root.value("thumbnail").toString()};
+                info.thumbnail =
+                    thumbnailSize > 0
+                        ? Image::fromUrlScaledTo(
+                              thumbnail, QSize(thumbnailSize, thumbnailSize))
+                        : Image::fromUrl(thumbnail);
+                info.resolvedLink = root.value("link").toString();
+            }
+            else
+            {
+                info.tooltip = root.value("message").toString();
+            }
+            info.tooltip = QUrl::fromPercentEncoding(info.tooltip.toUtf8());
+
+            finish(url, &info);
+
+            return Success;
+        })
+        .onError([url](auto /*result*/) {
+            // not cached, the next lookup tries again
+            finish(url, nullptr);
         })
         .execute();
     // });
@@ -11,6 +11,9 @@ namespace chatterino {
 class LinkResolver
 {
 public:
+    /// Resolved links are cached for a while and concurrent lookups of the
+    /// same url share one request. The callback is called right away if the
+    /// link is cached.
     static void getLinkInfo(
         const QString url, QObject *caller,
         std::function<void(QString, Link, ImagePtr)> callback);
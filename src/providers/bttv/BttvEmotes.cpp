@@ -15,6 +15,12 @@
 namespace chatterino {
 namespace {
 
+    // Emote sets rarely change, reconnects and restarts within these reuse
+    // the cached responses. Manual refreshes always revalidate them.
+    constexpr std::chrono::seconds GLOBAL_EMOTES_TTL = std::chrono::hours(1);
+    constexpr std::chrono::seconds CHANNEL_EMOTES_TTL =
+        std::chrono::minutes(10);
+
     const QString CHANNEL_HAS_NO_EMOTES(
         "This channel has no BetterTTV channel emotes.");
 
@@ -38,10 +44,10 @@ namespace {
     }
     EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
     {
-        static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-        static std::mutex mutex;
+        static DebugCounter entries("bttv emote cache entries");
+        static WeakEmoteCache cache(entries);
 
-        return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+        return cachedOrMakeEmotePtr(std::move(emote), cache, id);
     }
     std::pair<Outcome, EmoteMap> parseGlobalEmotes(
         const QJsonArray &jsonEmotes, const EmoteMap &currentEmotes)
@@ -143,12 +149,12 @@ void BttvEmotes::loadEmotes()
 {
     NetworkRequest(QString(globalEmoteApiUrl))
         .timeout(30000)
+        .cache(GLOBAL_EMOTES_TTL)
         .onSuccess([this](auto result) -> Outcome {
             auto emotes = this->global_.get();
             auto pair = parseGlobalEmotes(result.parseJsonArray(), *emotes);
             if (pair.first)
-                this->global_.set(
-                    std::make_shared<EmoteMap>(std::move(pair.second)));
+                this->global_.set(makeEmoteMapPtr(std::move(pair.second)));
             return pair.first;
         })
         .execute();
@@ -162,6 +168,7 @@ void BttvEmotes::loadChannel(std::weak_ptr<Channel> channel,
 {
     NetworkRequest(QString(bttvChannelEmoteApiUrl) + channelId)
         .timeout(20000)
+        .cache(manualRefresh ? std::chrono::seconds(0) : CHANNEL_EMOTES_TTL)
         .onSuccess([callback = std::move(callback), channel,
                     &channelDisplayName,
                     manualRefresh](auto result) -> Outcome {
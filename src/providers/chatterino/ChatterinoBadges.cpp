@@ -21,12 +21,17 @@ ChatterinoBadges::ChatterinoBadges()
 
 boost::optional<EmotePtr> ChatterinoBadges::getBadge(const UserId &id)
 {
-    std::shared_lock lock(this->mutex_);
+    auto badges = std::atomic_load(&this->badges_);
+    if (!badges)
+    {
+        return boost::none;
+    }
 
-    auto it = badgeMap.find(id.string);
-    if (it != badgeMap.end())
+    bool ok = false;
+    auto it = badges->badgeMap.find(id.string.toULongLong(&ok));
+    if (ok && it != badges->badgeMap.end())
     {
-        return emotes[it->second];
+        return badges->emotes[it->second];
     }
     return boost::none;
 }
@@ -39,8 +44,7 @@ void ChatterinoBadges::loadChatterinoBadges()
         .concurrent()
         .onSuccess([this](auto result) -> Outcome {
             auto jsonRoot = result.parseJson();
-
-            std::unique_lock lock(this->mutex_);
+            auto badges = std::make_shared<Badges>();
 
             int index = 0;
             for (const auto &jsonBadge_ : jsonRoot.value("badges").toArray())
@@ -53,16 +57,24 @@ void ChatterinoBadges::loadChatterinoBadges()
                              Url{jsonBadge.value("image3").toString()}},
                     Tooltip{jsonBadge.value("tooltip").toString()}, Url{}};
 
-                emotes.push_back(
+                badges->emotes.push_back(
                     std::make_shared<const Emote>(std::move(emote)));
 
                 for (const auto &user : jsonBadge.value("users").toArray())
                 {
-                    badgeMap[user.toString()] = index;
+                    bool ok = false;
+                    auto userId = user.toString().toULongLong(&ok);
+                    if (ok)
+                    {
+                        badges->badgeMap[userId] = index;
+                    }
                 }
                 ++index;
             }
 
+            std::shared_ptr<const Badges> published = std::move(badges);
+            std::atomic_store(&this->badges_, std::move(published));
+
             return Success;
         })
         .execute();
@@ -2,8 +2,8 @@
 
 #include <boost/optional.hpp>
 #include <common/Singleton.hpp>
+#include <cstdint>
 #include <memory>
-#include <shared_mutex>
 #include <unordered_map>
 #include <vector>
 #include "common/Aliases.hpp"
@@ -25,10 +25,15 @@ public:
 private:
     void loadChatterinoBadges();
 
-    std::shared_mutex mutex_;
+    // Replaced as a whole when the badges are loaded, so the lookups for
+    // every message don't need a lock
+    struct Badges {
+        // numeric user id to the index of the badge
+        std::unordered_map<uint64_t, int> badgeMap;
+        std::vector<EmotePtr> emotes;
+    };
 
-    std::unordered_map<QString, int> badgeMap;
-    std::vector<EmotePtr> emotes;
+    std::shared_ptr<const Badges> badges_;
 };
 
 }  // namespace chatterino
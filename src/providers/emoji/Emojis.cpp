@@ -4,211 +4,315 @@
 #include "messages/Emote.hpp"
 #include "singletons/Settings.hpp"
 
-#include <rapidjson/error/en.h>
-#include <rapidjson/error/error.h>
-#include <rapidjson/rapidjson.h>
 #include <QFile>
+#include <QResource>
+#include <QtEndian>
 #include <boost/variant.hpp>
+
+#include <algorithm>
+#include <array>
+#include <cstring>
 #include <memory>
 #include "common/QLogging.hpp"
 
 namespace chatterino {
 namespace {
 
-    auto toneNames = std::map<QString, QString>{
-        {"1F3FB", "tone1"}, {"1F3FC", "tone2"}, {"1F3FD", "tone3"},
-        {"1F3FE", "tone4"}, {"1F3FF", "tone5"},
-    };
+    // The layout of the table is described in tools/generate-emoji-data.py
+    constexpr quint32 TABLE_VERSION = 1;
+    constexpr quint32 HEADER_SIZE = 36;
+    constexpr quint32 EMOJI_SIZE = 36;
+    constexpr quint32 SHORT_CODE_SIZE = 12;
 
-    void parseEmoji(const std::shared_ptr<EmojiData> &emojiData,
-                    const rapidjson::Value &unparsedEmoji,
-                    QString shortCode = QString())
+    const std::array<QString, 4> capabilityNames{"Apple", "Google", "Twitter",
+                                                 "Facebook"};
+
+    bool isUncompressed(const QResource &resource)
     {
-        std::array<uint32_t, 9> unicodeBytes;
+#if QT_VERSION >= QT_VERSION_CHECK(5, 13, 0)
+        return resource.compressionAlgorithm() == QResource::NoCompression;
+#else
+        return !resource.isCompressed();
+#endif
+    }
 
-        struct {
-            bool apple;
-            bool google;
-            bool twitter;
-            bool facebook;
-        } capabilities;
+    // The table lives until the program exits, so the strings of the emojis
+    // can point into it instead of copying it
+    const QByteArray &emojiTable()
+    {
+        static const QByteArray table = [] {
+            QResource resource(":/emoji.bin");
+            if (resource.isValid() && isUncompressed(resource) &&
+                reinterpret_cast<quintptr>(resource.data()) %
+                        alignof(char16_t) ==
+                    0)
+            {
+                return QByteArray::fromRawData(
+                    reinterpret_cast<const char *>(resource.data()),
+                    int(resource.size()));
+            }
+
+            QFile file(":/emoji.bin");
+            file.open(QFile::ReadOnly);
+            return file.readAll();
+        }();
+
+        return table;
+    }
 
-        if (!shortCode.isEmpty())
+    class EmojiTable
+    {
+    public:
+        explicit EmojiTable(const QByteArray &table)
+            : data_(reinterpret_cast<const uchar *>(table.constData()))
+            , size_(quint32(table.size()))
         {
-            emojiData->shortCodes.push_back(shortCode);
         }
-        else
+
+        quint32 read(quint64 offset) const
         {
-            const auto &shortCodes = unparsedEmoji["short_names"];
-            for (const auto &_shortCode : shortCodes.GetArray())
+            if (offset + 4 > this->size_)
             {
-                emojiData->shortCodes.emplace_back(_shortCode.GetString());
+                return 0;
             }
+            return qFromLittleEndian<quint32>(this->data_ + offset);
         }
 
-        rj::getSafe(unparsedEmoji, "non_qualified",
-                    emojiData->nonQualifiedCode);
-        rj::getSafe(unparsedEmoji, "unified", emojiData->unifiedCode);
-
-        rj::getSafe(unparsedEmoji, "has_img_apple", capabilities.apple);
-        rj::getSafe(unparsedEmoji, "has_img_google", capabilities.google);
-        rj::getSafe(unparsedEmoji, "has_img_twitter", capabilities.twitter);
-        rj::getSafe(unparsedEmoji, "has_img_facebook", capabilities.facebook);
-
-        if (capabilities.apple)
+        bool isValid() const
         {
-            emojiData->capabilities.insert("Apple");
+            if (this->size_ < HEADER_SIZE ||
+                std::memcmp(this->data_, "C2EM", 4) != 0 ||
+                this->read(4) != TABLE_VERSION)
+            {
+                return false;
+            }
+
+            auto emojisEnd =
+                this->emojiOffset() + quint64(EMOJI_SIZE) * this->emojiCount();
+            auto shortCodesEnd =
+                this->shortCodeOffset() +
+                quint64(SHORT_CODE_SIZE) * this->shortCodeCount();
+            auto sortedEnd =
+                this->sortedOffset() + 4ULL * this->shortCodeCount();
+            auto stringsEnd = this->stringOffset() + 2ULL * this->read(32);
+
+            return emojisEnd <= this->size_ && shortCodesEnd <= this->size_ &&
+                   sortedEnd <= this->size_ && stringsEnd <= this->size_ &&
+                   this->stringOffset() % alignof(char16_t) == 0;
         }
-        if (capabilities.google)
+
+        quint32 emojiCount() const
         {
-            emojiData->capabilities.insert("Google");
+            return this->read(8);
         }
-        if (capabilities.twitter)
+        quint32 emojiOffset() const
         {
-            emojiData->capabilities.insert("Twitter");
+            return this->read(12);
         }
-        if (capabilities.facebook)
+        quint32 shortCodeCount() const
         {
-            emojiData->capabilities.insert("Facebook");
+            return this->read(16);
         }
-
-        QStringList unicodeCharacters;
-        if (!emojiData->nonQualifiedCode.isEmpty())
+        quint32 shortCodeOffset() const
         {
-            unicodeCharacters =
-                emojiData->nonQualifiedCode.toLower().split('-');
+            return this->read(20);
         }
-        else
+        quint32 sortedOffset() const
         {
-            unicodeCharacters = emojiData->unifiedCode.toLower().split('-');
+            return this->read(24);
         }
-        if (unicodeCharacters.length() < 1)
+        quint32 stringOffset() const
         {
-            return;
+            return this->read(28);
         }
 
-        int numUnicodeBytes = 0;
-
-        for (const QString &unicodeCharacter : unicodeCharacters)
-        {
-            unicodeBytes.at(numUnicodeBytes++) =
-                QString(unicodeCharacter).toUInt(nullptr, 16);
-        }
-
-        emojiData->value =
-            QString::fromUcs4(unicodeBytes.data(), numUnicodeBytes);
-    }
-
-    // getToneNames takes a tones and returns their names in the same order
-    // The format of the tones is: "1F3FB-1F3FB" or "1F3FB"
-    // The output of the tone names is: "tone1-tone1" or "tone1"
-    QString getToneNames(const QString &tones)
-    {
-        auto toneParts = tones.split('-');
-        QStringList toneNameResults;
-        for (const auto &tonePart : toneParts)
+        /// Reads the (offset, length) reference to a string at offset
+        QString string(quint64 offset) const
         {
-            auto toneNameIt = toneNames.find(tonePart);
-            if (toneNameIt == toneNames.end())
+            auto start = this->read(offset);
+            auto length = this->read(offset + 4);
+            if (quint64(start) + length > this->read(32))
             {
-                qDebug() << "Tone with key" << tonePart
-                         << "does not exist in tone names map";
-                continue;
+                return {};
             }
 
-            toneNameResults.append(toneNameIt->second);
+            const auto *units = this->data_ + this->stringOffset() + 2 * start;
+#if Q_BYTE_ORDER == Q_LITTLE_ENDIAN
+            return QString::fromRawData(reinterpret_cast<const QChar *>(units),
+                                        int(length));
+#else
+            QString string(int(length), Qt::Uninitialized);
+            for (quint32 i = 0; i < length; i++)
+            {
+                string[int(i)] =
+                    QChar(qFromLittleEndian<quint16>(units + 2 * i));
+            }
+            return string;
+#endif
         }
 
-        assert(!toneNameResults.isEmpty());
+    private:
+        const uchar *data_;
+        quint32 size_;
+    };
 
-        return toneNameResults.join('-');
+    // The characters in [-+\w], \w only matches ASCII characters there
+    bool isShortCodeCharacter(QChar c)
+    {
+        auto u = c.unicode();
+        return (u >= 'a' && u <= 'z') || (u >= 'A' && u <= 'Z') ||
+               (u >= '0' && u <= '9') || u == '_' || u == '-' || u == '+';
     }
 
 }  // namespace
 
 void Emojis::load()
 {
-    this->loadEmojis();
-
-    this->sortEmojis();
+    this->loadEmojiData();
 
     this->loadEmojiSet();
 }
 
+void Emojis::loadEmojiData()
+{
+    this->loadEmojis();
+}
+
 void Emojis::loadEmojis()
 {
-    // Current version: https://github.com/iamcal/emoji-data/blob/v14.0.0/emoji.json (Emoji version 14.0 (2022))
-    QFile file(":/emoji.json");
-    file.open(QFile::ReadOnly);
-    QTextStream s1(&file);
-    QString data = s1.readAll();
-    rapidjson::Document root;
-    rapidjson::ParseResult result = root.Parse(data.toUtf8(), data.length());
-
-    if (result.Code() != rapidjson::kParseErrorNone)
+    // Generated from https://github.com/iamcal/emoji-data/blob/v14.0.0/emoji.json (Emoji version 14.0 (2022))
+    EmojiTable table(emojiTable());
+
+    if (!table.isValid())
     {
-        qCWarning(chatterinoEmoji)
-            << "JSON parse error:" << rapidjson::GetParseError_En(result.Code())
-            << "(" << result.Offset() << ")";
+        qCWarning(chatterinoEmoji) << "Invalid emoji table";
         return;
     }
 
-    for (const auto &unparsedEmoji : root.GetArray())
+    std::vector<std::shared_ptr<EmojiData>> emojis;
+    emojis.reserve(table.emojiCount());
+
+    for (quint32 i = 0; i < table.emojiCount(); i++)
     {
+        auto offset = table.emojiOffset() + quint64(EMOJI_SIZE) * i;
         auto emojiData = std::make_shared<EmojiData>();
-        parseEmoji(emojiData, unparsedEmoji);
 
-        for (const auto &shortCode : emojiData->shortCodes)
+        emojiData->value = table.string(offset);
+        emojiData->unifiedCode = table.string(offset + 8);
+        emojiData->nonQualifiedCode = table.string(offset + 16);
+
+        auto firstShortCode = table.read(offset + 24);
+        auto shortCodeCount = table.read(offset + 28);
+        for (quint32 j = 0; j < shortCodeCount &&
+                            firstShortCode + j < table.shortCodeCount();
+             j++)
         {
-            this->emojiShortCodeToEmoji_.insert(shortCode, emojiData);
-            this->shortCodes.emplace_back(shortCode);
+            emojiData->shortCodes.push_back(
+                table.string(table.shortCodeOffset() +
+                             quint64(SHORT_CODE_SIZE) * (firstShortCode + j)));
         }
 
-        this->emojiFirstByte_[emojiData->value.at(0)].append(emojiData);
+        auto capabilities = table.read(offset + 32);
+        for (size_t j = 0; j < capabilityNames.size(); j++)
+        {
+            if (capabilities & (1U << j))
+            {
+                emojiData->capabilities.insert(capabilityNames[j]);
+            }
+        }
+
+        if (emojiData->shortCodes.empty())
+        {
+            qCWarning(chatterinoEmoji)
+                << "Emoji without short code" << emojiData->unifiedCode;
+            emojiData->shortCodes.push_back(emojiData->unifiedCode);
+        }
+
+        this->addToTrie(emojiData);
 
         this->emojis.insert(emojiData->unifiedCode, emojiData);
+        emojis.push_back(std::move(emojiData));
+    }
 
-        if (unparsedEmoji.HasMember("skin_variations"))
+    // The short codes are already sorted, if two emojis share a short code
+    // the last one is used
+    this->shortCodes.reserve(table.shortCodeCount());
+    for (quint32 i = 0; i < table.shortCodeCount(); i++)
+    {
+        auto offset = table.shortCodeOffset() +
+                      quint64(SHORT_CODE_SIZE) *
+                          table.read(table.sortedOffset() + 4ULL * i);
+        auto shortCode = table.string(offset);
+        auto emojiIndex = table.read(offset + 8);
+        if (emojiIndex >= emojis.size())
         {
-            for (const auto &skinVariation :
-                 unparsedEmoji["skin_variations"].GetObject())
-            {
-                auto toneName = getToneNames(skinVariation.name.GetString());
-                const auto &variation = skinVariation.value;
+            continue;
+        }
+
+        this->shortCodes.push_back(shortCode);
 
-                auto variationEmojiData = std::make_shared<EmojiData>();
+        auto &lookup = this->emojiShortCodeToEmoji_;
+        if (!lookup.empty() && lookup.back().first == shortCode)
+        {
+            lookup.back().second = emojis[emojiIndex];
+        }
+        else
+        {
+            lookup.emplace_back(shortCode, emojis[emojiIndex]);
+        }
+    }
+}
 
-                parseEmoji(variationEmojiData, variation,
-                           emojiData->shortCodes[0] + "_" + toneName);
+void Emojis::addToTrie(const std::shared_ptr<EmojiData> &emoji)
+{
+    if (emoji->value.isEmpty())
+    {
+        return;
+    }
 
-                this->emojiShortCodeToEmoji_.insert(
-                    variationEmojiData->shortCodes[0], variationEmojiData);
-                this->shortCodes.push_back(variationEmojiData->shortCodes[0]);
+    uint32_t node = 0;
 
-                this->emojiFirstByte_[variationEmojiData->value.at(0)].append(
-                    variationEmojiData);
+    for (auto c : emoji->value)
+    {
+        auto child = this->findInTrie(node, c.unicode());
 
-                this->emojis.insert(variationEmojiData->unifiedCode,
-                                    variationEmojiData);
-            }
+        if (child == 0)
+        {
+            child = uint32_t(this->trie_.size());
+            this->trie_.emplace_back();
+
+            auto &next = this->trie_[node].next;
+            auto it = std::lower_bound(
+                next.begin(), next.end(), c.unicode(),
+                [](const auto &edge, char16_t value) {
+                    return edge.first < value;
+                });
+            next.insert(it, {c.unicode(), child});
         }
+
+        node = child;
+    }
+
+    // Keep the first emoji if two of them have the same value
+    if (!this->trie_[node].emoji)
+    {
+        this->trie_[node].emoji = emoji;
     }
 }
 
-void Emojis::sortEmojis()
+uint32_t Emojis::findInTrie(uint32_t node, char16_t c) const
 {
-    for (auto &p : this->emojiFirstByte_)
+    const auto &next = this->trie_[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c,
+                               [](const auto &edge, char16_t value) {
+                                   return edge.first < value;
+                               });
+
+    if (it != next.end() && it->first == c)
     {
-        std::stable_sort(p.begin(), p.end(),
-                         [](const auto &lhs, const auto &rhs) {
-                             return lhs->value.length() > rhs->value.length();
-                         });
+        return it->second;
     }
-
-    auto &p = this->shortCodes;
-    std::stable_sort(p.begin(), p.end(), [](const auto &lhs, const auto &rhs) {
-        return lhs < rhs;
-    });
+    return 0;
 }
 
 void Emojis::loadEmojiSet()
@@ -273,87 +377,53 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
     auto result = std::vector<boost::variant<EmotePtr, QString>>();
     int lastParsedEmojiEndIndex = 0;
 
-    for (auto i = 0; i < text.length(); ++i)
-    {
-        const QChar character = text.at(i);
-
-        if (character.isLowSurrogate())
-        {
-            continue;
-        }
-
-        auto it = this->emojiFirstByte_.find(character);
-        if (it == this->emojiFirstByte_.end())
-        {
-            // No emoji starts with this character
-            continue;
-        }
-
-        const auto &possibleEmojis = it.value();
-
-        int remainingCharacters = text.length() - i - 1;
-
-        std::shared_ptr<EmojiData> matchedEmoji;
+    const auto *data = text.utf16();
+    const int length = text.length();
 
+    for (int i = 0; i < length;)
+    {
+        // Walk down the trie as far as the text allows, remembering the
+        // longest emoji on the way
+        const EmojiData *matchedEmoji = nullptr;
         int matchedEmojiLength = 0;
+        uint32_t node = 0;
 
-        for (const std::shared_ptr<EmojiData> &emoji : possibleEmojis)
+        for (int j = i; j < length; ++j)
         {
-            int emojiExtraCharacters = emoji->value.length() - 1;
-            if (emojiExtraCharacters > remainingCharacters)
-            {
-                // It cannot be this emoji, there's not enough space for it
-                continue;
-            }
-
-            bool match = true;
-
-            for (int j = 1; j < emoji->value.length(); ++j)
+            node = this->findInTrie(node, data[j]);
+            if (node == 0)
             {
-                if (text.at(i + j) != emoji->value.at(j))
-                {
-                    match = false;
-
-                    break;
-                }
+                break;
             }
 
-            if (match)
+            if (const auto &emoji = this->trie_[node].emoji)
             {
-                matchedEmoji = emoji;
-                matchedEmojiLength = emoji->value.length();
-
-                break;
+                matchedEmoji = emoji.get();
+                matchedEmojiLength = j - i + 1;
             }
         }
 
-        if (matchedEmojiLength == 0)
+        if (matchedEmoji == nullptr)
         {
+            ++i;
             continue;
         }
 
-        int currentParsedEmojiFirstIndex = i;
-        int currentParsedEmojiEndIndex = i + (matchedEmojiLength);
-
-        int charactersFromLastParsedEmoji =
-            currentParsedEmojiFirstIndex - lastParsedEmojiEndIndex;
-
-        if (charactersFromLastParsedEmoji > 0)
+        if (i > lastParsedEmojiEndIndex)
         {
             // Add characters inbetween emojis
-            result.emplace_back(text.mid(lastParsedEmojiEndIndex,
-                                         charactersFromLastParsedEmoji));
+            result.emplace_back(
+                text.mid(lastParsedEmojiEndIndex, i - lastParsedEmojiEndIndex));
         }
 
         // Push the emoji as a word to parsedWords
         result.emplace_back(matchedEmoji->emote);
 
-        lastParsedEmojiEndIndex = currentParsedEmojiEndIndex;
-
-        i += matchedEmojiLength - 1;
+        i += matchedEmojiLength;
+        lastParsedEmojiEndIndex = i;
     }
 
-    if (lastParsedEmojiEndIndex < text.length())
+    if (lastParsedEmojiEndIndex < length)
     {
         // Add remaining characters
         result.emplace_back(text.mid(lastParsedEmojiEndIndex));
@@ -364,35 +434,65 @@ std::vector<boost::variant<EmotePtr, QString>> Emojis::parse(
 
 QString Emojis::replaceShortCodes(const QString &text)
 {
-    QString ret(text);
-    auto it = this->findShortCodesRegex_.globalMatch(text);
+    // Same as replacing every match of :([-+\w]+): that is a known short
+    // code, the result is only copied once something was replaced
+    QString ret;
+    QString shortCode;
+    int lastReplacedEndIndex = 0;
 
-    int32_t offset = 0;
+    const int length = text.length();
 
-    while (it.hasNext())
+    for (int i = 0; i < length;)
     {
-        auto match = it.next();
-
-        auto capturedString = match.captured();
-
-        QString matchString =
-            capturedString.toLower().mid(1, capturedString.size() - 2);
+        if (text[i] != ':')
+        {
+            ++i;
+            continue;
+        }
 
-        auto emojiIt = this->emojiShortCodeToEmoji_.constFind(matchString);
+        int end = i + 1;
+        while (end < length && isShortCodeCharacter(text[end]))
+        {
+            ++end;
+        }
 
-        if (emojiIt == this->emojiShortCodeToEmoji_.constEnd())
+        if (end == i + 1 || end == length || text[end] != ':')
         {
+            // text[end] could start the next short code
+            i = end;
             continue;
         }
 
-        auto emojiData = emojiIt.value();
+        shortCode.resize(0);
+        for (int j = i + 1; j < end; ++j)
+        {
+            shortCode.append(text[j].toLower());
+        }
 
-        ret.replace(offset + match.capturedStart(), match.capturedLength(),
-                    emojiData->value);
+        const auto &lookup = this->emojiShortCodeToEmoji_;
+        auto emojiIt = std::lower_bound(
+            lookup.begin(), lookup.end(), shortCode,
+            [](const auto &entry, const QString &value) {
+                return entry.first < value;
+            });
+        if (emojiIt != lookup.end() && emojiIt->first == shortCode)
+        {
+            ret.append(text.constData() + lastReplacedEndIndex,
+                       i - lastReplacedEndIndex);
+            ret.append(emojiIt->second->value);
+            lastReplacedEndIndex = end + 1;
+        }
 
-        offset += emojiData->value.size() - match.capturedLength();
+        i = end + 1;
+    }
+
+    if (lastReplacedEndIndex == 0)
+    {
+        return text;
     }
 
+    ret.append(text.constData() + lastReplacedEndIndex,
+               length - lastReplacedEndIndex);
     return ret;
 }
 
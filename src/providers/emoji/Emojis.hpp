@@ -3,7 +3,6 @@
 #include "util/ConcurrentMap.hpp"
 
 #include <QMap>
-#include <QRegularExpression>
 #include <boost/variant.hpp>
 #include <map>
 #include <set>
@@ -40,6 +39,11 @@ class Emojis
 public:
     void initialize();
     void load();
+    /// Reads the emojis from the table generated by
+    /// tools/generate-emoji-data.py, doesn't need the gui thread
+    void loadEmojiData();
+    /// Sets the images of the emojis to the emoji set from the settings
+    void loadEmojiSet();
     std::vector<boost::variant<EmotePtr, QString>> parse(const QString &text);
 
     EmojiMap emojis;
@@ -48,18 +52,25 @@ public:
 
 private:
     void loadEmojis();
-    void sortEmojis();
-    void loadEmojiSet();
-
-    /// Emojis
-    QRegularExpression findShortCodesRegex_{":([-+\\w]+):"};
-
-    // shortCodeToEmoji maps strings like "sunglasses" to its emoji
-    QMap<QString, std::shared_ptr<EmojiData>> emojiShortCodeToEmoji_;
 
-    // Maps the first character of the emoji unicode string to a vector of
-    // possible emojis
-    QMap<QChar, QVector<std::shared_ptr<EmojiData>>> emojiFirstByte_;
+    void addToTrie(const std::shared_ptr<EmojiData> &emoji);
+    /// Returns the child of node for the code unit c, or 0 if there is none
+    uint32_t findInTrie(uint32_t node, char16_t c) const;
+
+    // maps strings like "sunglasses" to its emoji, sorted by the short code
+    std::vector<std::pair<QString, std::shared_ptr<EmojiData>>>
+        emojiShortCodeToEmoji_;
+
+    // Trie over the UTF-16 code units of all emoji values, node 0 is the
+    // root. Used by parse to find the longest emoji at every position in a
+    // single pass.
+    struct TrieNode {
+        // sorted by code unit
+        std::vector<std::pair<char16_t, uint32_t>> next;
+        // set if the path to this node spells out an emoji
+        std::shared_ptr<EmojiData> emoji;
+    };
+    std::vector<TrieNode> trie_{1};
 };
 
 }  // namespace chatterino
@@ -5,8 +5,6 @@
 #include <QJsonValue>
 #include <QThread>
 #include <QUrl>
-#include <map>
-#include <shared_mutex>
 #include "common/NetworkRequest.hpp"
 #include "common/Outcome.hpp"
 #include "messages/Emote.hpp"
@@ -20,29 +18,34 @@ void FfzBadges::initialize(Settings &settings, Paths &paths)
 
 boost::optional<EmotePtr> FfzBadges::getBadge(const UserId &id)
 {
-    std::shared_lock lock(this->mutex_);
+    auto badges = std::atomic_load(&this->badges_);
+    if (!badges)
+    {
+        return boost::none;
+    }
 
-    auto it = this->badgeMap.find(id.string);
-    if (it != this->badgeMap.end())
+    bool ok = false;
+    auto it = badges->badgeMap.find(id.string.toULongLong(&ok));
+    if (ok && it != badges->badgeMap.end())
     {
-        return this->badges[it->second];
+        return badges->badges[it->second];
     }
     return boost::none;
 }
 boost::optional<QColor> FfzBadges::getBadgeColor(const UserId &id)
 {
-    std::shared_lock lock(this->mutex_);
-
-    auto badgeIt = this->badgeMap.find(id.string);
-    if (badgeIt != this->badgeMap.end())
+    auto badges = std::atomic_load(&this->badges_);
+    if (!badges)
     {
-        auto colorIt = this->colorMap.find(badgeIt->second);
-        if (colorIt != this->colorMap.end())
-        {
-            return colorIt->second;
-        }
         return boost::none;
     }
+
+    bool ok = false;
+    auto it = badges->badgeMap.find(id.string.toULongLong(&ok));
+    if (ok && it != badges->badgeMap.end())
+    {
+        return badges->colors[it->second];
+    }
     return boost::none;
 }
 
@@ -52,9 +55,9 @@ void FfzBadges::loadFfzBadges()
 
     NetworkRequest(url)
         .onSuccess([this](auto result) -> Outcome {
-            std::unique_lock lock(this->mutex_);
-
             auto jsonRoot = result.parseJson();
+            auto badges = std::make_shared<Badges>();
+
             int index = 0;
             for (const auto &jsonBadge_ : jsonRoot.value("badges").toArray())
             {
@@ -70,10 +73,10 @@ void FfzBadges::loadFfzBadges()
                             jsonUrls.value("4").toString()}},
                     Tooltip{jsonBadge.value("title").toString()}, Url{}};
 
-                this->badges.push_back(
+                badges->badges.push_back(
                     std::make_shared<const Emote>(std::move(emote)));
-                this->colorMap[index] =
-                    QColor(jsonBadge.value("color").toString());
+                badges->colors.emplace_back(
+                    jsonBadge.value("color").toString());
 
                 auto badgeId = QString::number(jsonBadge.value("id").toInt());
                 for (const auto &user : jsonRoot.value("users")
@@ -81,11 +84,14 @@ void FfzBadges::loadFfzBadges()
                                             .value(badgeId)
                                             .toArray())
                 {
-                    this->badgeMap[QString::number(user.toInt())] = index;
+                    badges->badgeMap[uint64_t(user.toInt())] = index;
                 }
                 ++index;
             }
 
+            std::shared_ptr<const Badges> published = std::move(badges);
+            std::atomic_store(&this->badges_, std::move(published));
+
             return Success;
         })
         .execute();
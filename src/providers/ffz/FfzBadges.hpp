@@ -6,9 +6,9 @@
 #include "common/Aliases.hpp"
 #include "util/QStringHash.hpp"
 
-#include <map>
+#include <cstdint>
 #include <memory>
-#include <shared_mutex>
+#include <unordered_map>
 #include <vector>
 
 #include <QColor>
@@ -30,11 +30,16 @@ public:
 private:
     void loadFfzBadges();
 
-    std::shared_mutex mutex_;
+    // Replaced as a whole when the badges are loaded, so the lookups for
+    // every message don't need a lock
+    struct Badges {
+        // numeric user id to the index of the badge
+        std::unordered_map<uint64_t, int> badgeMap;
+        std::vector<EmotePtr> badges;
+        std::vector<QColor> colors;
+    };
 
-    std::unordered_map<QString, int> badgeMap;
-    std::vector<EmotePtr> badges;
-    std::unordered_map<int, QColor> colorMap;
+    std::shared_ptr<const Badges> badges_;
 };
 
 }  // namespace chatterino
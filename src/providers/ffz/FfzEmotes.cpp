@@ -13,6 +13,11 @@
 namespace chatterino {
 namespace {
 
+    // same as the BTTV ones
+    constexpr std::chrono::seconds GLOBAL_EMOTES_TTL = std::chrono::hours(1);
+    constexpr std::chrono::seconds CHANNEL_EMOTES_TTL =
+        std::chrono::minutes(10);
+
     const QString CHANNEL_HAS_NO_EMOTES(
         "This channel has no FrankerFaceZ channel emotes.");
 
@@ -28,29 +33,34 @@ namespace {
 
         return {"https:" + emote.toString()};
     }
-    void fillInEmoteData(const QJsonObject &urls, const EmoteName &name,
+    void fillInEmoteData(const QJsonObject &jsonEmote, const EmoteName &name,
                          const QString &tooltip, Emote &emoteData)
     {
+        auto urls = jsonEmote.value("urls").toObject();
         auto url1x = getEmoteLink(urls, "1");
         auto url2x = getEmoteLink(urls, "2");
         auto url3x = getEmoteLink(urls, "4");
 
+        // the size at 1x, invalid if it's missing
+        QSize size(jsonEmote.value("width").toInt(-1),
+                   jsonEmote.value("height").toInt(-1));
+
         //, code, tooltip
         emoteData.name = name;
-        emoteData.images =
-            ImageSet{Image::fromUrl(url1x, 1),
-                     url2x.string.isEmpty() ? Image::getEmpty()
-                                            : Image::fromUrl(url2x, 0.5),
-                     url3x.string.isEmpty() ? Image::getEmpty()
-                                            : Image::fromUrl(url3x, 0.25)};
+        emoteData.images = ImageSet{
+            Image::fromUrl(url1x, 1, size),
+            url2x.string.isEmpty() ? Image::getEmpty()
+                                   : Image::fromUrl(url2x, 0.5, size),
+            url3x.string.isEmpty() ? Image::getEmpty()
+                                   : Image::fromUrl(url3x, 0.25, size)};
         emoteData.tooltip = {tooltip};
     }
     EmotePtr cachedOrMake(Emote &&emote, const EmoteId &id)
     {
-        static std::unordered_map<EmoteId, std::weak_ptr<const Emote>> cache;
-        static std::mutex mutex;
+        static DebugCounter entries("ffz emote cache entries");
+        static WeakEmoteCache cache(entries);
 
-        return cachedOrMakeEmotePtr(std::move(emote), cache, mutex, id);
+        return cachedOrMakeEmotePtr(std::move(emote), cache, id);
     }
     std::pair<Outcome, EmoteMap> parseGlobalEmotes(
         const QJsonObject &jsonRoot, const EmoteMap &currentEmotes)
@@ -69,10 +79,9 @@ namespace {
                 auto name = EmoteName{jsonEmote.value("name").toString()};
                 auto id =
                     EmoteId{QString::number(jsonEmote.value("id").toInt())};
-                auto urls = jsonEmote.value("urls").toObject();
 
                 auto emote = Emote();
-                fillInEmoteData(urls, name,
+                fillInEmoteData(jsonEmote, name,
                                 name.string + "<br>Global FFZ Emote", emote);
                 emote.homePage =
                     Url{QString("https://www.frankerfacez.com/emoticon/%1-%2")
@@ -139,10 +148,9 @@ namespace {
                                               .toObject()
                                               .value("display_name")
                                               .toString()};
-                auto urls = jsonEmote.value("urls").toObject();
 
                 Emote emote;
-                fillInEmoteData(urls, name,
+                fillInEmoteData(jsonEmote, name,
                                 QString("%1<br>Channel FFZ Emote<br>By: %2")
                                     .arg(name.string)
                                     .arg(author.string),
@@ -186,12 +194,12 @@ void FfzEmotes::loadEmotes()
     NetworkRequest(url)
 
         .timeout(30000)
+        .cache(GLOBAL_EMOTES_TTL)
         .onSuccess([this](auto result) -> Outcome {
             auto emotes = this->emotes();
             auto pair = parseGlobalEmotes(result.parseJson(), *emotes);
             if (pair.first)
-                this->global_.set(
-                    std::make_shared<EmoteMap>(std::move(pair.second)));
+                this->global_.set(makeEmoteMapPtr(std::move(pair.second)));
             return pair.first;
         })
         .execute();
@@ -210,6 +218,7 @@ void FfzEmotes::loadChannel(
     NetworkRequest("https://api.frankerfacez.com/v1/room/id/" + channelId)
 
         .timeout(20000)
+        .cache(manualRefresh ? std::chrono::seconds(0) : CHANNEL_EMOTES_TTL)
         .onSuccess([emoteCallback = std::move(emoteCallback),
                     modBadgeCallback = std::move(modBadgeCallback),
                     vipBadgeCallback = std::move(vipBadgeCallback), channel,
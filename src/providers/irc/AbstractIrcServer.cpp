@@ -1,13 +1,19 @@
 #include "AbstractIrcServer.hpp"
 
+#include "Application.hpp"
 #include "common/Channel.hpp"
 #include "common/Common.hpp"
 #include "common/QLogging.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
+#include "singletons/WindowManager.hpp"
+#include "util/DebugCount.hpp"
 
 #include <QCoreApplication>
+#include <QTimer>
+
+#include <algorithm>
 
 namespace chatterino {
 
@@ -15,9 +21,17 @@ const int RECONNECT_BASE_INTERVAL = 2000;
 // 60 falloff counter means it will try to reconnect at most every 60*2 seconds
 const int MAX_FALLOFF_COUNTER = 60;
 
-// Ratelimits for joinBucket_
-const int JOIN_RATELIMIT_BUDGET = 18;
-const int JOIN_RATELIMIT_COOLDOWN = 12500;
+// Channels per read connection before another one is opened. The last
+// connection takes all channels once the limit of connections is reached.
+const size_t CHANNELS_PER_READ_CONNECTION = 100;
+const size_t MAX_READ_CONNECTIONS = 10;
+
+namespace {
+
+    DebugCounter readConnects("IRC read connects");
+    DebugCounter disconnects("IRC disconnects");
+
+}  // namespace
 
 AbstractIrcServer::AbstractIrcServer()
 {
@@ -27,16 +41,10 @@ AbstractIrcServer::AbstractIrcServer()
     this->writeConnection_->moveToThread(
         QCoreApplication::instance()->thread());
 
-    // Apply a leaky bucket rate limiting to JOIN messages
-    auto actuallyJoin = [&](QString message) {
-        if (!this->channels.contains(message))
-        {
-            return;
-        }
-        this->readConnection_->sendRaw("JOIN #" + message);
-    };
-    this->joinBucket_.reset(new RatelimitBucket(
-        JOIN_RATELIMIT_BUDGET, JOIN_RATELIMIT_COOLDOWN, actuallyJoin, this));
+    this->joinTimer_.setSingleShot(true);
+    QObject::connect(&this->joinTimer_, &QTimer::timeout, this, [this] {
+        this->sendJoins();
+    });
 
     QObject::connect(this->writeConnection_.get(),
                      &Communi::IrcConnection::messageReceived, this,
@@ -54,30 +62,45 @@ AbstractIrcServer::AbstractIrcServer()
             this->writeConnection_->smartReconnect.invoke();
         });
 
-    // Listen to read connection message signals
-    this->readConnection_.reset(new IrcConnection);
-    this->readConnection_->moveToThread(QCoreApplication::instance()->thread());
+    this->createReadConnection();
+}
 
-    QObject::connect(this->readConnection_.get(),
-                     &Communi::IrcConnection::messageReceived, this,
-                     [this](auto msg) {
+IrcConnection *AbstractIrcServer::createReadConnection()
+{
+    auto *connection = new IrcConnection;
+    this->readConnections_.emplace_back(connection);
+    connection->moveToThread(QCoreApplication::instance()->thread());
+
+    // Listen to read connection message signals
+    QObject::connect(connection, &Communi::IrcConnection::messageReceived,
+                     this, [this](Communi::IrcMessage *msg) {
+                         // the server echoes our own joins once they're done
+                         if (msg->type() == Communi::IrcMessage::Join &&
+                             msg->isOwn())
+                         {
+                             auto *join =
+                                 static_cast<Communi::IrcJoinMessage *>(msg);
+                             this->joinQueue_.confirmed(
+                                 this->cleanChannelName(join->channel()),
+                                 JoinQueue::Clock::now());
+                         }
                          this->readConnectionMessageReceived(msg);
                      });
-    QObject::connect(this->readConnection_.get(),
+    QObject::connect(connection,
                      &Communi::IrcConnection::privateMessageReceived, this,
                      [this](auto msg) {
                          this->privateMessageReceived(msg);
                      });
-    QObject::connect(this->readConnection_.get(),
-                     &Communi::IrcConnection::connected, this, [this] {
-                         this->onReadConnected(this->readConnection_.get());
+    QObject::connect(connection, &Communi::IrcConnection::connected, this,
+                     [this, connection] {
+                         this->onReadConnected(connection);
                      });
-    QObject::connect(this->readConnection_.get(),
-                     &Communi::IrcConnection::disconnected, this, [this] {
-                         this->onDisconnected();
+    QObject::connect(connection, &Communi::IrcConnection::disconnected, this,
+                     [this, connection] {
+                         this->onDisconnected(connection);
                      });
     this->connections_.managedConnect(
-        this->readConnection_->connectionLost, [this](bool timeout) {
+        connection->connectionLost, [this, connection](bool timeout) {
             qCDebug(chatterinoIrc)
                 << "Read connection reconnect requested. Timeout:" << timeout;
             if (timeout)
@@ -87,8 +110,154 @@ AbstractIrcServer::AbstractIrcServer()
                 this->addGlobalSystemMessage(
                     "Server connection timed out, reconnecting");
             }
-            this->readConnection_->smartReconnect.invoke();
+            connection->smartReconnect.invoke();
         });
+
+    // connections opened later are set up like the first one
+    if (this->initialized_)
+    {
+        this->initializeConnectionSignals(connection, ConnectionType::Read);
+
+        // initializeConnection opens the connection, which takes
+        // connectionMutex_ that the caller holds
+        QTimer::singleShot(0, this, [this, connection] {
+            if (this->mainReadConnection()->isActive())
+            {
+                this->initializeConnection(connection, ConnectionType::Read);
+            }
+        });
+    }
+
+    return connection;
+}
+
+IrcConnection *AbstractIrcServer::readConnectionFor(const QString &channelName)
+{
+    if (!this->hasSeparateWriteConnection())
+    {
+        return this->readConnections_.front().get();
+    }
+
+    auto it = this->channelReadConnections_.find(channelName);
+    if (it != this->channelReadConnections_.end())
+    {
+        return it->second;
+    }
+
+    std::unordered_map<IrcConnection *, size_t> channelCounts;
+    for (const auto &entry : this->channelReadConnections_)
+    {
+        channelCounts[entry.second]++;
+    }
+
+    IrcConnection *emptiest = nullptr;
+    size_t emptiestCount = 0;
+    for (const auto &connection : this->readConnections_)
+    {
+        auto count = channelCounts[connection.get()];
+        if (emptiest == nullptr || count < emptiestCount)
+        {
+            emptiest = connection.get();
+            emptiestCount = count;
+        }
+    }
+
+    if (emptiestCount >= CHANNELS_PER_READ_CONNECTION &&
+        this->readConnections_.size() < MAX_READ_CONNECTIONS)
+    {
+        emptiest = this->createReadConnection();
+    }
+
+    this->channelReadConnections_.emplace(channelName, emptiest);
+    return emptiest;
+}
+
+bool AbstractIrcServer::isReadConnectionOf(IrcConnection *connection,
+                                           const QString &channelName) const
+{
+    if (!this->hasSeparateWriteConnection())
+    {
+        return true;
+    }
+
+    auto it = this->channelReadConnections_.find(channelName);
+    return it != this->channelReadConnections_.end() &&
+           it->second == connection;
+}
+
+IrcConnection *AbstractIrcServer::mainReadConnection() const
+{
+    return this->readConnections_.front().get();
+}
+
+void AbstractIrcServer::setJoinLimit(JoinQueue::Limit limit)
+{
+    this->joinQueue_.setLimit(limit);
+}
+
+void AbstractIrcServer::queueJoin(const QString &channelName)
+{
+    this->joinQueue_.push(channelName);
+
+    // The joins are sent from the event loop, so the ones queued together
+    // share a line and the priorities can be looked up without the locks
+    // the caller holds
+    if (!this->joinTimer_.isActive() || this->joinTimer_.remainingTime() > 0)
+    {
+        this->joinTimer_.start(0);
+    }
+}
+
+void AbstractIrcServer::sendJoins()
+{
+    auto now = JoinQueue::Clock::now();
+
+    if (auto expired = this->joinQueue_.expire(now); expired > 0)
+    {
+        qCDebug(chatterinoIrc)
+            << expired << "joins weren't confirmed in time, slowing down to"
+            << this->joinQueue_.rate() << "joins";
+    }
+
+    auto joins =
+        this->joinQueue_.takeSendable(now, [this](const QString &channelName) {
+            return getApp()->windows->loadPriority(
+                this->getChannelOrEmpty(channelName).get());
+        });
+
+    if (!joins.empty())
+    {
+        std::lock_guard<std::mutex> lock(this->connectionMutex_);
+
+        // one line per read connection
+        std::unordered_map<IrcConnection *, QStringList> lines;
+        for (const auto &channelName : joins)
+        {
+            // channels of connections that aren't connected yet are joined
+            // once they are, see onReadConnected
+            auto *connection = this->readConnectionFor(channelName);
+            if (!this->channels.contains(channelName) ||
+                !connection->isConnected())
+            {
+                this->joinQueue_.remove(channelName);
+                continue;
+            }
+            lines[connection].append("#" + channelName);
+        }
+
+        for (const auto &line : lines)
+        {
+            line.first->sendRaw("JOIN " + line.second.join(','));
+        }
+    }
+
+    if (auto wake = this->joinQueue_.nextWakeTime(now))
+    {
+        auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+                      *wake - now)
+                      .count();
+        this->joinTimer_.start(int(std::max<decltype(ms)>(ms, 0)));
+    }
 }
 
 void AbstractIrcServer::initializeIrc()
@@ -99,12 +268,15 @@ void AbstractIrcServer::initializeIrc()
     {
         this->initializeConnectionSignals(this->writeConnection_.get(),
                                           ConnectionType::Write);
-        this->initializeConnectionSignals(this->readConnection_.get(),
-                                          ConnectionType::Read);
+        for (const auto &connection : this->readConnections_)
+        {
+            this->initializeConnectionSignals(connection.get(),
+                                              ConnectionType::Read);
+        }
     }
     else
     {
-        this->initializeConnectionSignals(this->readConnection_.get(),
+        this->initializeConnectionSignals(this->mainReadConnection(),
                                           ConnectionType::Both);
     }
 
@@ -120,11 +292,14 @@ void AbstractIrcServer::connect()
     if (this->hasSeparateWriteConnection())
     {
         this->initializeConnection(this->writeConnection_.get(), Write);
-        this->initializeConnection(this->readConnection_.get(), Read);
+        for (const auto &connection : this->readConnections_)
+        {
+            this->initializeConnection(connection.get(), Read);
+        }
     }
     else
     {
-        this->initializeConnection(this->readConnection_.get(), Both);
+        this->initializeConnection(this->mainReadConnection(), Both);
     }
 }
 
@@ -138,7 +313,14 @@ void AbstractIrcServer::open(ConnectionType type)
     }
     if (type & Read)
     {
-        this->readConnection_->open();
+        for (const auto &connection : this->readConnections_)
+        {
+            // connections opened later may already be on their way
+            if (!connection->isActive())
+            {
+                connection->open();
+            }
+        }
     }
 }
 
@@ -165,7 +347,10 @@ void AbstractIrcServer::disconnect()
 {
     std::lock_guard<std::mutex> locker(this->connectionMutex_);
 
-    this->readConnection_->close();
+    for (const auto &connection : this->readConnections_)
+    {
+        connection->close();
+    }
     if (this->hasSeparateWriteConnection())
     {
         this->writeConnection_->close();
@@ -188,7 +373,7 @@ void AbstractIrcServer::sendRawMessage(const QString &rawMessage)
     }
     else
     {
-        this->readConnection_->sendRaw(rawMessage);
+        this->mainReadConnection()->sendRaw(rawMessage);
     }
 }
 
@@ -225,23 +410,31 @@ ChannelPtr AbstractIrcServer::getOrAddChannel(const QString &dirtyChannelName)
         qCDebug(chatterinoIrc) << "[AbstractIrcServer::addChannel]"
                                << channelName << "was destroyed";
         this->channels.remove(channelName);
+        this->joinQueue_.remove(channelName);
 
-        if (this->readConnection_)
+        std::lock_guard<std::mutex> lock(this->connectionMutex_);
+        if (this->isReadConnectionOf(this->mainReadConnection(), channelName))
+        {
+            this->mainReadConnection()->sendRaw("PART #" + channelName);
+        }
+        else
         {
-            this->readConnection_->sendRaw("PART #" + channelName);
+            auto it = this->channelReadConnections_.find(channelName);
+            if (it != this->channelReadConnections_.end())
+            {
+                it->second->sendRaw("PART #" + channelName);
+            }
         }
+        this->channelReadConnections_.erase(channelName);
     });
 
     // join IRC channel
     {
         std::lock_guard<std::mutex> lock2(this->connectionMutex_);
 
-        if (this->readConnection_)
+        if (this->readConnectionFor(channelName)->isConnected())
         {
-            if (this->readConnection_->isConnected())
-            {
-                this->joinBucket_->send(channelName);
-            }
+            this->queueJoin(channelName);
         }
     }
 
@@ -291,33 +484,49 @@ std::vector<std::weak_ptr<Channel>> AbstractIrcServer::getChannels()
 
 void AbstractIrcServer::onReadConnected(IrcConnection *connection)
 {
-    (void)connection;
+    readConnects.increase();
 
     std::lock_guard lock(this->channelMutex);
 
-    // join channels
-    for (auto &&weak : this->channels)
+    // the channels of this connection
+    std::vector<ChannelPtr> channels;
     {
-        if (auto channel = weak.lock())
+        std::lock_guard<std::mutex> lock2(this->connectionMutex_);
+        for (auto &&weak : this->channels)
         {
-            this->joinBucket_->send(channel->getName());
+            auto channel = weak.lock();
+            if (channel &&
+                this->isReadConnectionOf(connection, channel->getName()))
+            {
+                channels.push_back(std::move(channel));
+            }
         }
     }
 
+    // join channels, the ones that are looked at first
+    std::vector<std::pair<LoadPriority, QString>> joins;
+    for (const auto &channel : channels)
+    {
+        joins.emplace_back(getApp()->windows->loadPriority(channel.get()),
+                           channel->getName());
+    }
+    std::stable_sort(joins.begin(), joins.end(),
+                     [](const auto &a, const auto &b) {
+                         return a.first < b.first;
+                     });
+    for (auto &&join : joins)
+    {
+        this->queueJoin(join.second);
+    }
+
     // connected/disconnected message
     auto connectedMsg = makeSystemMessage("connected");
     connectedMsg->flags.set(MessageFlag::ConnectedMessage);
     auto reconnected = makeSystemMessage("reconnected");
     reconnected->flags.set(MessageFlag::ConnectedMessage);
 
-    for (std::weak_ptr<Channel> &weak : this->channels.values())
+    for (const auto &chan : channels)
     {
-        std::shared_ptr<Channel> chan = weak.lock();
-        if (!chan)
-        {
-            continue;
-        }
-
         LimitedQueueSnapshot<MessagePtr> snapshot = chan->getMessageSnapshot();
 
         bool replaceMessage =
@@ -341,9 +550,15 @@ void AbstractIrcServer::onWriteConnected(IrcConnection *connection)
     (void)connection;
 }
 
-void AbstractIrcServer::onDisconnected()
+void AbstractIrcServer::onDisconnected(IrcConnection *connection)
 {
+    disconnects.increase();
+
+    // the joins that are on their way are sent again on reconnect
+    this->joinQueue_.forgetPending();
+
     std::lock_guard<std::mutex> lock(this->channelMutex);
+    std::lock_guard<std::mutex> lock2(this->connectionMutex_);
 
     MessageBuilder b(systemMessage, "disconnected");
     b->flags.set(MessageFlag::DisconnectedMessage);
@@ -352,12 +567,13 @@ void AbstractIrcServer::onDisconnected()
     for (std::weak_ptr<Channel> &weak : this->channels.values())
     {
         std::shared_ptr<Channel> chan = weak.lock();
-        if (!chan)
+        if (!chan || !this->isReadConnectionOf(connection, chan->getName()))
         {
             continue;
         }
 
         chan->addMessage(disconnectedMsg);
+        this->onChannelDisconnected(chan, connection);
     }
 }
 
@@ -379,7 +595,7 @@ QString AbstractIrcServer::cleanChannelName(const QString &dirtyChannelName)
 void AbstractIrcServer::addFakeMessage(const QString &data)
 {
     auto fakeMessage = Communi::IrcMessage::fromData(
-        data.toUtf8(), this->readConnection_.get());
+        data.toUtf8(), this->mainReadConnection());
 
     if (fakeMessage->command() == "PRIVMSG")
     {
@@ -8,7 +8,11 @@
 
 #include "common/Common.hpp"
 #include "providers/irc/IrcConnection2.hpp"
-#include "util/RatelimitBucket.hpp"
+#include "providers/irc/JoinQueue.hpp"
+#include "util/QStringHash.hpp"
+
+#include <unordered_map>
+#include <vector>
 
 namespace chatterino {
 
@@ -70,7 +74,11 @@ protected:
 
     virtual void onReadConnected(IrcConnection *connection);
     virtual void onWriteConnected(IrcConnection *connection);
-    virtual void onDisconnected();
+    virtual void onDisconnected(IrcConnection *connection);
+    // Called by onDisconnected for each channel of the connection, with
+    // channelMutex and connectionMutex_ held
+    virtual void onChannelDisconnected(const ChannelPtr &channel,
+                                       IrcConnection *connection){};
 
     virtual std::shared_ptr<Channel> getCustomChannel(
         const QString &channelName);
@@ -80,18 +88,44 @@ protected:
 
     void open(ConnectionType type);
 
+    // The connection that messages which didn't come from a connection, like
+    // fake or replayed ones, are parsed with
+    IrcConnection *mainReadConnection() const;
+
+    void setJoinLimit(JoinQueue::Limit limit);
+
     QMap<QString, std::weak_ptr<Channel>> channels;
     std::mutex channelMutex;
 
 private:
     void initConnection();
 
+    IrcConnection *createReadConnection();
+    // Returns the read connection the channel is joined with, the one with
+    // the fewest channels for new ones. Opens a new connection once all are
+    // full. connectionMutex_ must be held.
+    IrcConnection *readConnectionFor(const QString &channelName);
+    // Whether the channel is joined with the connection, for servers with a
+    // single read connection it's always true
+    bool isReadConnectionOf(IrcConnection *connection,
+                            const QString &channelName) const;
+
+    // Joins the channel once the join limits allow it, batched with the
+    // other channels queued until then
+    void queueJoin(const QString &channelName);
+    void sendJoins();
+
     QObjectPtr<IrcConnection> writeConnection_ = nullptr;
-    QObjectPtr<IrcConnection> readConnection_ = nullptr;
 
-    // Our rate limiting bucket for the Twitch join rate limits
-    // https://dev.twitch.tv/docs/irc/guide#rate-limits
-    QObjectPtr<RatelimitBucket> joinBucket_;
+    // Servers with a separate write connection spread their channels over
+    // several read connections, so a single connection doesn't have to
+    // carry all of them. The first one always exists.
+    std::vector<QObjectPtr<IrcConnection>> readConnections_;
+    std::unordered_map<QString, IrcConnection *> channelReadConnections_;
+
+    // Gui thread only, sendJoins runs whenever joinTimer_ fires
+    JoinQueue joinQueue_;
+    QTimer joinTimer_;
 
     QTimer reconnectTimer_;
     int falloffCounter_ = 1;
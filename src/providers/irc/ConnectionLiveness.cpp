@@ -0,0 +1,102 @@
+#include "providers/irc/ConnectionLiveness.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+constexpr std::chrono::milliseconds ConnectionLiveness::MIN_IDLE;
+constexpr std::chrono::milliseconds ConnectionLiveness::MAX_IDLE;
+constexpr std::chrono::milliseconds ConnectionLiveness::MIN_PONG_TIMEOUT;
+constexpr std::chrono::milliseconds ConnectionLiveness::MAX_PONG_TIMEOUT;
+
+namespace {
+
+    // moving averages, single outliers don't matter much
+    ConnectionLiveness::Clock::duration average(
+        const boost::optional<ConnectionLiveness::Clock::duration> &current,
+        ConnectionLiveness::Clock::duration sample)
+    {
+        return current ? (*current * 7 + sample) / 8 : sample;
+    }
+
+}  // namespace
+
+void ConnectionLiveness::reset(Clock::time_point now)
+{
+    this->lastReceived_ = now;
+    this->waitingForTraffic_ = false;
+    this->pingSentAt_ = boost::none;
+    // the round trip and gaps of the new connection can differ
+    this->gap_ = boost::none;
+    this->roundTrip_ = boost::none;
+}
+
+void ConnectionLiveness::received(Clock::time_point now)
+{
+    // pauses we pinged in aren't a normal gap
+    if (!this->waitingForTraffic_)
+    {
+        this->gap_ = average(this->gap_, now - this->lastReceived_);
+    }
+    this->lastReceived_ = now;
+    this->waitingForTraffic_ = false;
+}
+
+void ConnectionLiveness::pingSent(Clock::time_point now)
+{
+    this->waitingForTraffic_ = true;
+    this->pingSentAt_ = now;
+}
+
+void ConnectionLiveness::pongReceived(Clock::time_point now)
+{
+    if (this->pingSentAt_)
+    {
+        this->roundTrip_ = average(this->roundTrip_, now - *this->pingSentAt_);
+        this->pingSentAt_ = boost::none;
+    }
+    this->received(now);
+}
+
+ConnectionLiveness::Action ConnectionLiveness::check(
+    Clock::time_point now) const
+{
+    if (this->waitingForTraffic_)
+    {
+        return now - *this->pingSentAt_ >= this->pongTimeout() ? Action::Dead
+                                                               : Action::None;
+    }
+
+    return now - this->lastReceived_ >= this->idleTimeout() ? Action::SendPing
+                                                            : Action::None;
+}
+
+ConnectionLiveness::Clock::time_point ConnectionLiveness::nextCheck() const
+{
+    if (this->waitingForTraffic_)
+    {
+        return *this->pingSentAt_ + this->pongTimeout();
+    }
+    return this->lastReceived_ + this->idleTimeout();
+}
+
+ConnectionLiveness::Clock::duration ConnectionLiveness::idleTimeout() const
+{
+    if (!this->gap_)
+    {
+        return MAX_IDLE;
+    }
+    return std::clamp<Clock::duration>(*this->gap_ * 4, MIN_IDLE, MAX_IDLE);
+}
+
+ConnectionLiveness::Clock::duration ConnectionLiveness::pongTimeout() const
+{
+    if (!this->roundTrip_)
+    {
+        return MAX_PONG_TIMEOUT;
+    }
+    return std::clamp<Clock::duration>(*this->roundTrip_ * 4, MIN_PONG_TIMEOUT,
+                                       MAX_PONG_TIMEOUT);
+}
+
+}  // namespace chatterino
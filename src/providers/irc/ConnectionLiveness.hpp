@@ -0,0 +1,66 @@
+#pragma once
+
+#include <boost/optional.hpp>
+
+#include <chrono>
+
+namespace chatterino {
+
+/**
+ * @brief Decides when a connection that went quiet is pinged and when it's
+ *        considered dead.
+ *
+ * A connection is pinged once it has been quiet for a few times its usual
+ * gap between messages, so busy connections are checked after half a
+ * second of silence and quiet ones after a few seconds. It's dead if the
+ * PONG doesn't come back within a few round trips. Any traffic counts as a
+ * sign of life.
+ *
+ * Only models the timing, sending and timers are up to the caller.
+ */
+class ConnectionLiveness
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Action {
+        None,
+        SendPing,
+        // the connection has to be reconnected
+        Dead,
+    };
+
+    // how long a connection may be quiet before it's pinged
+    static constexpr std::chrono::milliseconds MIN_IDLE{500};
+    static constexpr std::chrono::milliseconds MAX_IDLE{5000};
+    // how long a PONG may take, MAX_PONG_TIMEOUT before the first round trip
+    // was measured
+    static constexpr std::chrono::milliseconds MIN_PONG_TIMEOUT{750};
+    static constexpr std::chrono::milliseconds MAX_PONG_TIMEOUT{5000};
+
+    /// Starts over for a connection that was just opened
+    void reset(Clock::time_point now);
+
+    void received(Clock::time_point now);
+    void pingSent(Clock::time_point now);
+    /// The PONG of our own PING, also counts as received traffic
+    void pongReceived(Clock::time_point now);
+
+    Action check(Clock::time_point now) const;
+    /// When check has to be called next
+    Clock::time_point nextCheck() const;
+
+    Clock::duration idleTimeout() const;
+    Clock::duration pongTimeout() const;
+
+private:
+    Clock::time_point lastReceived_;
+    // set from pingSent until any traffic arrives
+    bool waitingForTraffic_ = false;
+    boost::optional<Clock::time_point> pingSentAt_;
+
+    boost::optional<Clock::duration> gap_;
+    boost::optional<Clock::duration> roundTrip_;
+};
+
+}  // namespace chatterino
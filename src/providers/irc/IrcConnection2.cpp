@@ -3,6 +3,10 @@
 #include "common/QLogging.hpp"
 #include "common/Version.hpp"
 
+#include <QDateTime>
+
+#include <algorithm>
+
 namespace chatterino {
 
 namespace {
@@ -25,7 +29,7 @@ IrcConnection::IrcConnection(QObject *parent)
         [this](QAbstractSocket::SocketState state) {
             if (state == QAbstractSocket::UnconnectedState)
             {
-                this->pingTimer_.stop();
+                this->livenessTimer_.stop();
 
                 // The socket will enter unconnected state both in case of
                 // socket error (including failures to connect) and regular
@@ -65,50 +69,35 @@ IrcConnection::IrcConnection(QObject *parent)
         }
     });
 
-    // Send ping every x seconds
-    this->pingTimer_.setInterval(5000);
-    this->pingTimer_.start();
-    QObject::connect(&this->pingTimer_, &QTimer::timeout, [this] {
-        if (this->isConnected())
-        {
-            if (this->recentlyReceivedMessage_.load())
-            {
-                // If we're still receiving messages, all is well
-                this->recentlyReceivedMessage_ = false;
-                this->waitingForPong_ = false;
-                return;
-            }
-
-            if (this->waitingForPong_.load())
-            {
-                // The remote server did not send a PONG fast enough; close the
-                // connection
-                this->close();
-                this->connectionLost.invoke(true);
-            }
-            else
-            {
-                this->sendRaw("PING " + payload);
-                this->waitingForPong_ = true;
-            }
-        }
+    // Ping once the connection went quiet, see ConnectionLiveness
+    this->livenessTimer_.setSingleShot(true);
+    this->livenessTimer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->livenessTimer_, &QTimer::timeout, [this] {
+        this->checkLiveness();
     });
 
     QObject::connect(this, &Communi::IrcConnection::connected, this, [this] {
-        this->pingTimer_.start();
+        this->liveness_.reset(ConnectionLiveness::Clock::now());
+        this->checkLiveness();
     });
 
     QObject::connect(this, &Communi::IrcConnection::pongMessageReceived,
                      [this](Communi::IrcPongMessage *message) {
                          if (message->argument() == payload)
                          {
-                             this->waitingForPong_ = false;
+                             this->liveness_.pongReceived(
+                                 ConnectionLiveness::Clock::now());
                          }
                      });
 
     QObject::connect(this, &Communi::IrcConnection::messageReceived,
                      [this](Communi::IrcMessage *message) {
-                         this->recentlyReceivedMessage_ = true;
+                         // the timer isn't moved for every message, it
+                         // checks again when it fires too early
+                         this->liveness_.received(
+                             ConnectionLiveness::Clock::now());
+                         this->lastReceivedAt_ =
+                             QDateTime::currentMSecsSinceEpoch();
 
                          if (message->command() == "372")  // MOTD
                          {
@@ -126,8 +115,6 @@ IrcConnection::~IrcConnection()
 void IrcConnection::open()
 {
     this->expectConnectionLoss_ = false;
-    this->waitingForPong_ = false;
-    this->recentlyReceivedMessage_ = false;
     Communi::IrcConnection::open();
 }
 
@@ -137,4 +124,48 @@ void IrcConnection::close()
     Communi::IrcConnection::close();
 }
 
+qint64 IrcConnection::lastReceivedAt() const
+{
+    return this->lastReceivedAt_;
+}
+
+void IrcConnection::checkLiveness()
+{
+    if (!this->isConnected())
+    {
+        return;
+    }
+
+    auto now = ConnectionLiveness::Clock::now();
+    switch (this->liveness_.check(now))
+    {
+        case ConnectionLiveness::Action::SendPing: {
+            this->sendRaw("PING " + payload);
+            this->liveness_.pingSent(now);
+            break;
+        }
+
+        case ConnectionLiveness::Action::Dead: {
+            qCDebug(chatterinoIrc)
+                << "No PONG within"
+                << std::chrono::duration_cast<std::chrono::milliseconds>(
+                       this->liveness_.pongTimeout())
+                       .count()
+                << "ms, reconnecting";
+            // The remote server did not send a PONG fast enough; close the
+            // connection
+            this->close();
+            this->connectionLost.invoke(true);
+            return;
+        }
+
+        case ConnectionLiveness::Action::None:
+            break;
+    }
+
+    auto delay = std::chrono::duration_cast<std::chrono::milliseconds>(
+        this->liveness_.nextCheck() - now);
+    this->livenessTimer_.start(int(std::max<qint64>(delay.count(), 0)));
+}
+
 }  // namespace chatterino
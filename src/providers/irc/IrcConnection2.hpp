@@ -1,5 +1,6 @@
 #pragma once
 
+#include "providers/irc/ConnectionLiveness.hpp"
 #include "util/ExponentialBackoff.hpp"
 
 #include <pajlada/signals/signal.hpp>
@@ -26,19 +27,23 @@ public:
     virtual void open();
     virtual void close();
 
+    /// Wall clock time of the last message received, in ms since the epoch.
+    /// After the connection was lost, everything since may have been missed.
+    qint64 lastReceivedAt() const;
+
 private:
-    QTimer pingTimer_;
+    void checkLiveness();
+
+    // fires when liveness_ has to be checked next
+    QTimer livenessTimer_;
     QTimer reconnectTimer_;
-    std::atomic<bool> recentlyReceivedMessage_{true};
+    ConnectionLiveness liveness_;
+    qint64 lastReceivedAt_ = 0;
 
     // Reconnect with a base delay of 1 second and max out at 1 second * (2^(5-1)) (i.e. 16 seconds)
     ExponentialBackoff<5> reconnectBackoff_{std::chrono::milliseconds{1000}};
 
     std::atomic<bool> expectConnectionLoss_{false};
-
-    // waitingForPong_ is set to true when we send a PING message, and back to
-    // false when we receive the matching PONG response
-    std::atomic<bool> waitingForPong_{false};
 };
 
 }  // namespace chatterino
@@ -58,8 +58,9 @@ MessagePtr IrcMessageBuilder::build()
     // PUSH ELEMENTS
     this->appendChannelName();
 
+    this->message().serverReceivedTime = calculateMessageTime(this->ircMessage);
     this->emplace<TimestampElement>(
-        calculateMessageTimestamp(this->ircMessage));
+        this->message().serverReceivedTime.time());
 
     this->appendUsername();
 
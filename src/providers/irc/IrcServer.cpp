@@ -178,31 +178,62 @@ void IrcServer::privateMessageReceived(Communi::IrcPrivateMessage *message)
     auto target = message->target();
     target = target.startsWith('#') ? target.mid(1) : target;
 
-    if (auto channel = this->getChannelOrEmpty(target); !channel->isEmpty())
+    auto channel = this->getChannelOrEmpty(target);
+    if (channel->isEmpty())
     {
-        MessageParseArgs args;
-        IrcMessageBuilder builder(channel.get(), message, args);
+        return;
+    }
 
-        if (!builder.isIgnored())
-        {
-            auto msg = builder.build();
+    // the connection deletes the message once this returns
+    std::shared_ptr<Communi::IrcMessage> clone(message->clone(),
+                                               [](Communi::IrcMessage *m) {
+                                                   m->deleteLater();
+                                               });
+
+    // same as for twitch: the builder only reads thread safe snapshots, the
+    // message is added on the gui thread in the order it was received in
+    this->buildQueue_.run(
+        channel->getName(), [channel, clone]() -> OrderedWorkQueue::Result {
+            MessageParseArgs args;
+            auto builder = std::make_shared<IrcMessageBuilder>(
+                channel.get(),
+                static_cast<Communi::IrcPrivateMessage *>(clone.get()), args);
+
+            if (builder->isIgnored())
+            {
+                qCDebug(chatterinoIrc) << "message ignored :rage:";
+                return {};
+            }
+
+            auto msg = builder->build();
 
-            channel->addMessage(msg);
-            builder.triggerHighlights();
-            const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
-            const auto showInMentions =
-                msg->flags.has(MessageFlag::ShowInMentions);
+            return [channel, builder, msg] {
+                channel->addMessage(msg);
+                builder->triggerHighlights();
+
+                const auto highlighted =
+                    msg->flags.has(MessageFlag::Highlighted);
+                const auto showInMentions =
+                    msg->flags.has(MessageFlag::ShowInMentions);
+
+                if (highlighted && showInMentions)
+                {
+                    getApp()->twitch->mentionsChannel->collect(msg);
+                }
+            };
+        });
+}
 
-            if (highlighted && showInMentions)
+void IrcServer::addInOrder(const ChannelPtr &channel, MessagePtr message)
+{
+    this->buildQueue_.runAfter(
+        channel->getName(),
+        [weak = std::weak_ptr<Channel>(channel), message] {
+            if (auto shared = weak.lock())
             {
-                getApp()->twitch->mentionsChannel->addMessage(msg);
+                shared->addMessage(message);
             }
-        }
-        else
-        {
-            qCDebug(chatterinoIrc) << "message ignored :rage:";
-        }
-    }
+        });
 }
 
 void IrcServer::readConnectionMessageReceived(Communi::IrcMessage *message)
@@ -222,7 +253,7 @@ void IrcServer::readConnectionMessageReceived(Communi::IrcMessage *message)
                 {
                     if (message->nick() == this->data_->nick)
                     {
-                        shared->addMessage(makeSystemMessage("joined"));
+                        this->addInOrder(shared, makeSystemMessage("joined"));
                     }
                     else
                     {
@@ -246,7 +277,7 @@ void IrcServer::readConnectionMessageReceived(Communi::IrcMessage *message)
                 {
                     if (message->nick() == this->data_->nick)
                     {
-                        shared->addMessage(makeSystemMessage("parted"));
+                        this->addInOrder(shared, makeSystemMessage("parted"));
                     }
                     else
                     {
@@ -2,6 +2,7 @@
 
 #include "providers/irc/AbstractIrcServer.hpp"
 #include "providers/irc/IrcAccount.hpp"
+#include "util/OrderedWorkQueue.hpp"
 
 namespace chatterino {
 
@@ -33,8 +34,16 @@ protected:
     void readConnectionMessageReceived(Communi::IrcMessage *message) override;
 
 private:
+    /// Adds the message once the messages received before it in the channel
+    /// were built and added
+    void addInOrder(const ChannelPtr &channel, MessagePtr message);
+
     // pointer so we don't have to circle include Irc2.hpp
     IrcServerData *data_;
+
+    // Messages are built on the thread pool, they are added to their
+    // channels in the order they were received in
+    OrderedWorkQueue buildQueue_;
 };
 
 }  // namespace chatterino
@@ -0,0 +1,230 @@
+#include "providers/irc/JoinQueue.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+constexpr JoinQueue::Limit JoinQueue::UNVERIFIED;
+constexpr JoinQueue::Limit JoinQueue::VERIFIED;
+constexpr std::chrono::seconds JoinQueue::INITIAL_CONFIRM_TIMEOUT;
+constexpr std::chrono::seconds JoinQueue::MIN_CONFIRM_TIMEOUT;
+constexpr std::chrono::seconds JoinQueue::MAX_CONFIRM_TIMEOUT;
+
+JoinQueue::JoinQueue(Limit limit)
+    : limit_(limit)
+    , rate_(limit.joins)
+{
+}
+
+void JoinQueue::setLimit(Limit limit)
+{
+    this->limit_ = limit;
+    this->rate_ = limit.joins;
+    this->confirmedAtRate_ = 0;
+}
+
+void JoinQueue::push(const QString &channel)
+{
+    if (this->pending_.count(channel) != 0 ||
+        std::find(this->queued_.begin(), this->queued_.end(), channel) !=
+            this->queued_.end())
+    {
+        return;
+    }
+
+    this->queued_.push_back(channel);
+}
+
+void JoinQueue::remove(const QString &channel)
+{
+    this->queued_.erase(
+        std::remove(this->queued_.begin(), this->queued_.end(), channel),
+        this->queued_.end());
+    this->pending_.erase(channel);
+}
+
+std::vector<QString> JoinQueue::takeSendable(Clock::time_point now,
+                                             const PriorityOf &priorityOf)
+{
+    this->forget(now);
+
+    std::vector<QString> channels;
+    if (this->queued_.empty() || this->sent_.size() >= this->rate_)
+    {
+        return channels;
+    }
+
+    std::vector<std::pair<LoadPriority, QString>> queued;
+    queued.reserve(this->queued_.size());
+    for (auto &channel : this->queued_)
+    {
+        queued.emplace_back(priorityOf(channel), std::move(channel));
+    }
+    this->queued_.clear();
+    std::stable_sort(queued.begin(), queued.end(),
+                     [](const auto &a, const auto &b) {
+                         return a.first < b.first;
+                     });
+
+    // "JOIN #a,#b", a channel that's too long on its own still gets a line
+    int lineLength = 4;
+    auto budget = this->rate_ - this->sent_.size();
+    for (auto &entry : queued)
+    {
+        auto &channel = entry.second;
+        auto length = 2 + channel.toUtf8().size();
+        if (channels.size() < budget &&
+            (channels.empty() || lineLength + length <= MAX_LINE_LENGTH))
+        {
+            lineLength += length;
+            this->pending_.emplace(channel, now);
+            this->sent_.push_back(now);
+            channels.push_back(std::move(channel));
+        }
+        else
+        {
+            this->queued_.push_back(std::move(channel));
+        }
+    }
+
+    return channels;
+}
+
+void JoinQueue::confirmed(const QString &channel, Clock::time_point now)
+{
+    auto it = this->pending_.find(channel);
+    if (it == this->pending_.end())
+    {
+        return;
+    }
+
+    auto roundTrip = now - it->second;
+    this->pending_.erase(it);
+
+    // a moving average, single slow joins don't matter much
+    this->roundTrip_ =
+        this->roundTrip_ ? (*this->roundTrip_ * 3 + roundTrip) / 4 : roundTrip;
+
+    if (this->rate_ < this->limit_.joins &&
+        ++this->confirmedAtRate_ >= this->rate_)
+    {
+        this->rate_++;
+        this->confirmedAtRate_ = 0;
+    }
+}
+
+size_t JoinQueue::expire(Clock::time_point now)
+{
+    auto timeout = this->confirmTimeout();
+
+    std::vector<std::pair<Clock::time_point, QString>> expired;
+    for (auto it = this->pending_.begin(); it != this->pending_.end();)
+    {
+        if (now - it->second >= timeout)
+        {
+            expired.emplace_back(it->second, it->first);
+            it = this->pending_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+    if (expired.empty())
+    {
+        return 0;
+    }
+
+    // the joins go back to the front in the order they were sent in
+    std::sort(expired.begin(), expired.end());
+    for (auto it = expired.rbegin(); it != expired.rend(); ++it)
+    {
+        this->queued_.push_front(std::move(it->second));
+    }
+
+    this->rate_ = std::max<size_t>(1, this->rate_ / 2);
+    this->confirmedAtRate_ = 0;
+    return expired.size();
+}
+
+void JoinQueue::forgetPending()
+{
+    this->pending_.clear();
+}
+
+boost::optional<JoinQueue::Clock::time_point> JoinQueue::nextWakeTime(
+    Clock::time_point now) const
+{
+    boost::optional<Clock::time_point> wake;
+    auto earliest = [&](Clock::time_point time) {
+        if (!wake || time < *wake)
+        {
+            wake = time;
+        }
+    };
+
+    if (!this->queued_.empty())
+    {
+        // the sends of the window that are still counted
+        auto windowStart = now - this->limit_.window;
+        auto counted = std::count_if(this->sent_.begin(), this->sent_.end(),
+                                     [&](const auto &time) {
+                                         return time > windowStart;
+                                     });
+        if (size_t(counted) < this->rate_)
+        {
+            earliest(now);
+        }
+        else
+        {
+            // the one that has to leave the window for a new join
+            earliest(this->sent_[this->sent_.size() - this->rate_] +
+                     this->limit_.window);
+        }
+    }
+
+    auto timeout = this->confirmTimeout();
+    for (const auto &pending : this->pending_)
+    {
+        earliest(pending.second + timeout);
+    }
+
+    return wake;
+}
+
+size_t JoinQueue::size() const
+{
+    return this->queued_.size();
+}
+
+size_t JoinQueue::pendingCount() const
+{
+    return this->pending_.size();
+}
+
+size_t JoinQueue::rate() const
+{
+    return this->rate_;
+}
+
+JoinQueue::Clock::duration JoinQueue::confirmTimeout() const
+{
+    if (!this->roundTrip_)
+    {
+        return INITIAL_CONFIRM_TIMEOUT;
+    }
+    return std::clamp<Clock::duration>(*this->roundTrip_ * 4,
+                                       MIN_CONFIRM_TIMEOUT,
+                                       MAX_CONFIRM_TIMEOUT);
+}
+
+void JoinQueue::forget(Clock::time_point now)
+{
+    while (!this->sent_.empty() &&
+           now - this->sent_.front() >= this->limit_.window)
+    {
+        this->sent_.pop_front();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,111 @@
+#pragma once
+
+#include "common/ChannelLoadScheduler.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Holds back the JOINs of a server until its join rate limit allows
+ *        them, and batches them into as few lines as possible.
+ *
+ * Channels are joined in the order of their LoadPriority, then in the order
+ * they were queued. Every join that was sent is expected to be confirmed by
+ * the server echoing it. The round trip of the confirmations sets how long
+ * a join may take, joins that take longer are queued again and the rate is
+ * halved. It grows back by one join for every rate's worth of confirmations
+ * until it reaches the limit again.
+ *
+ * Only models the limits, sending and timers are up to the caller.
+ */
+class JoinQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    struct Limit {
+        size_t joins;
+        Clock::duration window;
+    };
+
+    // Twitch allows 20 joins in 10 seconds, 2000 for verified bots. One is
+    // kept in reserve and the window has some margin for clocks that are
+    // slightly off.
+    // https://dev.twitch.tv/docs/irc/guide#rate-limits
+    static constexpr Limit UNVERIFIED{19, std::chrono::milliseconds(10500)};
+    static constexpr Limit VERIFIED{1999, std::chrono::milliseconds(10500)};
+
+    // IRC lines are at most 512 bytes including the CRLF
+    static constexpr int MAX_LINE_LENGTH = 510;
+
+    // how long a join may take before the first round trip was measured
+    static constexpr std::chrono::seconds INITIAL_CONFIRM_TIMEOUT{10};
+    static constexpr std::chrono::seconds MIN_CONFIRM_TIMEOUT{5};
+    static constexpr std::chrono::seconds MAX_CONFIRM_TIMEOUT{30};
+
+    using PriorityOf = std::function<LoadPriority(const QString &channel)>;
+
+    explicit JoinQueue(Limit limit = UNVERIFIED);
+
+    /// Also resets the rate to the new limit
+    void setLimit(Limit limit);
+
+    /// Queues a join unless the channel is already queued or being joined
+    void push(const QString &channel);
+    /// Forgets a channel that doesn't have to be joined anymore
+    void remove(const QString &channel);
+
+    /// Removes and returns the channels that can be joined now, as many as
+    /// fit into one "JOIN #a,#b" line. They count against the limit right
+    /// away and wait for their confirmation. priorityOf is asked for the
+    /// current priority of every queued channel.
+    std::vector<QString> takeSendable(Clock::time_point now,
+                                      const PriorityOf &priorityOf);
+
+    void confirmed(const QString &channel, Clock::time_point now);
+
+    /// Queues the joins that weren't confirmed in time again, in front of
+    /// the others. Returns how many there were.
+    size_t expire(Clock::time_point now);
+
+    /// Stops waiting for the confirmations of all sent joins, e.g. because
+    /// their connection was lost and they're joined again on reconnect
+    void forgetPending();
+
+    /// The time the next join can be sent or the next sent one expires at,
+    /// boost::none if there are neither
+    boost::optional<Clock::time_point> nextWakeTime(
+        Clock::time_point now) const;
+
+    size_t size() const;
+    size_t pendingCount() const;
+    /// Joins per window that are currently sent
+    size_t rate() const;
+
+private:
+    Clock::duration confirmTimeout() const;
+    void forget(Clock::time_point now);
+
+    Limit limit_;
+    size_t rate_;
+    // confirmations since the rate last grew
+    size_t confirmedAtRate_ = 0;
+    boost::optional<Clock::duration> roundTrip_;
+
+    std::deque<QString> queued_;
+    // sent joins that weren't confirmed yet, with the time they were sent
+    std::unordered_map<QString, Clock::time_point> pending_;
+    // send times of the joins of the last window, oldest first
+    std::deque<Clock::time_point> sent_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,115 @@
+#include "providers/twitch/ChannelEmoteIndex.hpp"
+
+#include "Application.hpp"
+#include "providers/bttv/BttvEmotes.hpp"
+#include "providers/ffz/FfzEmotes.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <QSet>
+
+namespace chatterino {
+
+namespace {
+
+    const QSet<QString> zeroWidthEmotes{
+        "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
+        "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
+    };
+
+}  // namespace
+
+ChannelEmoteIndex::ChannelEmoteIndex(
+    std::shared_ptr<const EmoteMap> ffzChannel,
+    std::shared_ptr<const EmoteMap> bttvChannel,
+    std::shared_ptr<const EmoteMap> ffzGlobal,
+    std::shared_ptr<const EmoteMap> bttvGlobal)
+    : ffzChannel_(std::move(ffzChannel))
+    , bttvChannel_(std::move(bttvChannel))
+    , ffzGlobal_(std::move(ffzGlobal))
+    , bttvGlobal_(std::move(bttvGlobal))
+{
+    auto add = [this](const std::shared_ptr<const EmoteMap> &emotes,
+                      MessageElementFlag flag, bool checkZeroWidth) {
+        if (!emotes)
+        {
+            return;
+        }
+
+        for (const auto &[name, emote] : *emotes)
+        {
+            auto flags = MessageElementFlags(flag);
+            if (checkZeroWidth && zeroWidthEmotes.contains(name.string))
+            {
+                flags.set(MessageElementFlag::ZeroWidthEmote);
+            }
+
+            // emplace doesn't replace emotes of a map with higher precedence
+            this->entries_.emplace(name, Entry{emote, flags});
+        }
+    };
+
+    size_t total = 0;
+    for (const auto *emotes : {&this->ffzChannel_, &this->bttvChannel_,
+                               &this->ffzGlobal_, &this->bttvGlobal_})
+    {
+        total += *emotes ? (*emotes)->size() : 0;
+    }
+    this->entries_.reserve(total);
+
+    // Emote order:
+    //  - FrankerFaceZ Channel
+    //  - BetterTTV Channel
+    //  - FrankerFaceZ Global
+    //  - BetterTTV Global
+    add(this->ffzChannel_, MessageElementFlag::FfzEmote, false);
+    add(this->bttvChannel_, MessageElementFlag::BttvEmote, false);
+    add(this->ffzGlobal_, MessageElementFlag::FfzEmote, false);
+    add(this->bttvGlobal_, MessageElementFlag::BttvEmote, true);
+}
+
+const ChannelEmoteIndex::Entry *ChannelEmoteIndex::find(
+    const EmoteName &name) const
+{
+    auto it = this->entries_.find(name);
+    if (it == this->entries_.end())
+    {
+        return nullptr;
+    }
+    return &it->second;
+}
+
+bool ChannelEmoteIndex::isBuiltFrom(
+    const std::shared_ptr<const EmoteMap> &ffzChannel,
+    const std::shared_ptr<const EmoteMap> &bttvChannel,
+    const std::shared_ptr<const EmoteMap> &ffzGlobal,
+    const std::shared_ptr<const EmoteMap> &bttvGlobal) const
+{
+    return this->ffzChannel_ == ffzChannel &&
+           this->bttvChannel_ == bttvChannel &&
+           this->ffzGlobal_ == ffzGlobal && this->bttvGlobal_ == bttvGlobal;
+}
+
+std::shared_ptr<const ChannelEmoteIndex> ChannelEmoteIndex::current(
+    Atomic<std::shared_ptr<const ChannelEmoteIndex>> &cache,
+    const std::shared_ptr<const EmoteMap> &ffzChannel,
+    const std::shared_ptr<const EmoteMap> &bttvChannel)
+{
+    auto *app = getApp();
+    auto ffzGlobal = app->twitch->getFfzEmotes().emotes();
+    auto bttvGlobal = app->twitch->getBttvEmotes().emotes();
+
+    auto index = cache.get();
+    if (index &&
+        index->isBuiltFrom(ffzChannel, bttvChannel, ffzGlobal, bttvGlobal))
+    {
+        return index;
+    }
+
+    index = std::make_shared<const ChannelEmoteIndex>(
+        ffzChannel, bttvChannel, std::move(ffzGlobal), std::move(bttvGlobal));
+    cache.set(index);
+
+    return index;
+}
+
+}  // namespace chatterino
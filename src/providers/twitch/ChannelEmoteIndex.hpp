@@ -0,0 +1,65 @@
+#pragma once
+
+#include "common/Aliases.hpp"
+#include "common/Atomic.hpp"
+#include "messages/Emote.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <memory>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief All third party emotes usable in a channel merged into one map.
+ *
+ * Every name maps to the emote that wins by the usual precedence
+ * (FrankerFaceZ channel, BetterTTV channel, FrankerFaceZ global, BetterTTV
+ * global), so a word only has to be looked up once. The index is immutable,
+ * a new one is built whenever one of the maps it was built from is replaced.
+ */
+class ChannelEmoteIndex
+{
+public:
+    struct Entry {
+        EmotePtr emote;
+        MessageElementFlags flags;
+    };
+
+    ChannelEmoteIndex(std::shared_ptr<const EmoteMap> ffzChannel,
+                      std::shared_ptr<const EmoteMap> bttvChannel,
+                      std::shared_ptr<const EmoteMap> ffzGlobal,
+                      std::shared_ptr<const EmoteMap> bttvGlobal);
+
+    /// Returns the emote that should be used for name, nullptr if there is
+    /// none. The returned entry lives as long as the index.
+    const Entry *find(const EmoteName &name) const;
+
+    /**
+     * @brief Returns an index for the given channel emotes and the current
+     *        global emotes.
+     *
+     * The index in cache is reused if it was built from the same maps,
+     * otherwise a new one is built and stored in cache.
+     */
+    static std::shared_ptr<const ChannelEmoteIndex> current(
+        Atomic<std::shared_ptr<const ChannelEmoteIndex>> &cache,
+        const std::shared_ptr<const EmoteMap> &ffzChannel,
+        const std::shared_ptr<const EmoteMap> &bttvChannel);
+
+private:
+    bool isBuiltFrom(const std::shared_ptr<const EmoteMap> &ffzChannel,
+                     const std::shared_ptr<const EmoteMap> &bttvChannel,
+                     const std::shared_ptr<const EmoteMap> &ffzGlobal,
+                     const std::shared_ptr<const EmoteMap> &bttvGlobal) const;
+
+    // the maps this index was built from, only compared by identity
+    std::shared_ptr<const EmoteMap> ffzChannel_;
+    std::shared_ptr<const EmoteMap> bttvChannel_;
+    std::shared_ptr<const EmoteMap> ffzGlobal_;
+    std::shared_ptr<const EmoteMap> bttvGlobal_;
+
+    std::unordered_map<EmoteName, Entry> entries_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,98 @@
+#include "providers/twitch/HeadlessChannels.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <QFile>
+
+#include <unordered_set>
+
+namespace chatterino {
+
+HeadlessChannels::HeadlessChannels(QString path)
+    : path_(std::move(path))
+{
+    assertInGuiThread();
+
+    QObject::connect(&this->watcher_, &QFileSystemWatcher::fileChanged,
+                     [this] {
+                         this->reload();
+                     });
+
+    this->reload();
+}
+
+size_t HeadlessChannels::count() const
+{
+    return this->channels_.size();
+}
+
+void HeadlessChannels::reload()
+{
+    QFile file(this->path_);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        // the channels stay joined while the file is being replaced
+        qCWarning(chatterinoApp)
+            << "Could not read the headless channels file" << this->path_;
+        return;
+    }
+
+    std::unordered_set<QString> names;
+    while (!file.atEnd())
+    {
+        auto line = QString::fromUtf8(file.readLine()).trimmed().toLower();
+        if (line.startsWith('#'))
+        {
+            line = line.mid(1);
+        }
+        if (!line.isEmpty() && !line.startsWith(';'))
+        {
+            names.insert(line);
+        }
+    }
+
+    // the channels are parted once nothing holds on to them anymore
+    size_t parted = 0;
+    for (auto it = this->channels_.begin(); it != this->channels_.end();)
+    {
+        if (names.count(it->first) == 0)
+        {
+            it = this->channels_.erase(it);
+            parted++;
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    size_t joined = 0;
+    for (const auto &name : names)
+    {
+        if (this->channels_.count(name) != 0)
+        {
+            continue;
+        }
+
+        auto channel = getApp()->twitch->getOrAddChannel(name);
+        channel->setMessageLimit(messageLimit);
+        this->channels_.emplace(name, std::move(channel));
+        joined++;
+    }
+
+    qCInfo(chatterinoApp) << "Headless: joined" << joined << "and parted"
+                          << parted << "channels," << this->channels_.size()
+                          << "in total";
+
+    // editors often replace the file, which ends the watch
+    if (!this->watcher_.files().contains(this->path_))
+    {
+        this->watcher_.addPath(this->path_);
+    }
+}
+
+}  // namespace chatterino
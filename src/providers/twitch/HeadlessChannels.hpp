@@ -0,0 +1,46 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QFileSystemWatcher>
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <memory>
+#include <unordered_map>
+
+namespace chatterino {
+
+class Channel;
+using ChannelPtr = std::shared_ptr<Channel>;
+
+/**
+ * @brief Keeps the channels of a headless run joined.
+ *
+ * The file holds one channel name per line, empty lines and lines starting
+ * with ';' are skipped. Channels are joined when they're added to the file and
+ * parted when they're removed from it. Nothing shows the messages of these
+ * channels, they're only built and logged, so every channel keeps only a few
+ * of them.
+ *
+ * Gui thread only.
+ */
+class HeadlessChannels : boost::noncopyable
+{
+public:
+    /// Messages kept per channel, for timeouts and deletions of recent ones
+    static constexpr size_t messageLimit = 50;
+
+    explicit HeadlessChannels(QString path);
+
+    size_t count() const;
+
+private:
+    void reload();
+
+    const QString path_;
+    QFileSystemWatcher watcher_;
+    std::unordered_map<QString, ChannelPtr> channels_;
+};
+
+}  // namespace chatterino
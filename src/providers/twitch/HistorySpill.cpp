@@ -0,0 +1,278 @@
+#include "providers/twitch/HistorySpill.hpp"
+
+#include "common/QLogging.hpp"
+#include "util/CombinePath.hpp"
+
+#include <QDateTime>
+#include <QDir>
+#include <QSaveFile>
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+
+namespace chatterino {
+
+namespace {
+
+    // about twice as many twitch messages as the recent-messages api keeps,
+    // files are cut down to half of this
+    constexpr qint64 MAX_FILE_SIZE = 2 * 1024 * 1024;
+    constexpr qint64 COMPACTED_FILE_SIZE = MAX_FILE_SIZE / 2;
+
+    constexpr auto FLUSH_INTERVAL = std::chrono::seconds(1);
+
+    const QByteArray RECEIVED_TAG("rm-received-ts=");
+
+    // 0 if the line has no received time
+    qint64 receivedTime(const QByteArray &line)
+    {
+        if (!line.startsWith('@'))
+        {
+            return 0;
+        }
+
+        auto tagsEnd = line.indexOf(' ');
+        for (auto pos = line.indexOf(RECEIVED_TAG);
+             pos != -1 && (tagsEnd == -1 || pos < tagsEnd);
+             pos = line.indexOf(RECEIVED_TAG, pos + 1))
+        {
+            if (line[pos - 1] != '@' && line[pos - 1] != ';')
+            {
+                continue;
+            }
+
+            auto start = pos + RECEIVED_TAG.size();
+            auto end = start;
+            while (end < line.size() && line[end] >= '0' && line[end] <= '9')
+            {
+                end++;
+            }
+            return line.mid(start, end - start).toLongLong();
+        }
+
+        return 0;
+    }
+
+}  // namespace
+
+HistorySpill::HistorySpill(QString directory)
+    : directory_(std::move(directory))
+    , thread_([this] {
+        this->run();
+    })
+{
+}
+
+HistorySpill::~HistorySpill()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->condition_.notify_one();
+
+    this->thread_.join();
+}
+
+void HistorySpill::append(const QString &channelName,
+                          const Communi::IrcMessage &message)
+{
+    auto line = message.toData();
+    while (line.endsWith('\n') || line.endsWith('\r'))
+    {
+        line.chop(1);
+    }
+    if (line.isEmpty() || line.contains('\n'))
+    {
+        return;
+    }
+
+    if (!message.tags().contains("rm-received-ts"))
+    {
+        auto tag = RECEIVED_TAG +
+                   QByteArray::number(QDateTime::currentMSecsSinceEpoch());
+        if (line.startsWith('@'))
+        {
+            line.insert(1, tag + ';');
+        }
+        else
+        {
+            line.prepend('@' + tag + ' ');
+        }
+    }
+
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->queue_.push_back({channelName, std::move(line)});
+}
+
+std::vector<QByteArray> HistorySpill::load(const QString &channelName,
+                                           qint64 beforeMs,
+                                           size_t limit) const
+{
+    QFile file(this->filePath(channelName));
+    if (!file.open(QIODevice::ReadOnly) || file.size() == 0)
+    {
+        return {};
+    }
+
+    auto size = file.size();
+    const auto *data = reinterpret_cast<const char *>(file.map(0, size));
+    QByteArray fallback;
+    if (data == nullptr)
+    {
+        fallback = file.readAll();
+        data = fallback.constData();
+        size = fallback.size();
+    }
+
+    std::vector<QByteArray> lines;
+
+    // the last line might not be written completely yet
+    auto end = size;
+    while (end > 0 && data[end - 1] != '\n')
+    {
+        end--;
+    }
+
+    while (end > 0 && lines.size() < limit)
+    {
+        auto start = end - 1;
+        while (start > 0 && data[start - 1] != '\n')
+        {
+            start--;
+        }
+
+        QByteArray line(data + start, int(end - 1 - start));
+        end = start;
+
+        if (line.isEmpty() || receivedTime(line) >= beforeMs)
+        {
+            continue;
+        }
+        lines.push_back(std::move(line));
+    }
+
+    std::reverse(lines.begin(), lines.end());
+    return lines;
+}
+
+QString HistorySpill::filePath(const QString &channelName) const
+{
+    return combinePath(this->directory_, channelName + ".irc");
+}
+
+void HistorySpill::run()
+{
+    std::vector<Entry> entries;
+
+    while (true)
+    {
+        bool stopping = false;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->condition_.wait_for(lock, FLUSH_INTERVAL, [this] {
+                return this->stopping_;
+            });
+
+            std::swap(entries, this->queue_);
+            stopping = this->stopping_;
+        }
+
+        // every file is written once per batch
+        std::unordered_map<QString, QByteArray> batches;
+        for (auto &entry : entries)
+        {
+            auto &batch = batches[entry.channelName];
+            batch.append(entry.line);
+            batch.append('\n');
+        }
+        entries.clear();
+
+        for (const auto &[channelName, data] : batches)
+        {
+            this->write(channelName, data);
+        }
+
+        if (stopping)
+        {
+            this->files_.clear();
+            return;
+        }
+    }
+}
+
+void HistorySpill::write(const QString &channelName, const QByteArray &data)
+{
+    auto it = this->files_.find(channelName);
+    if (it == this->files_.end())
+    {
+        QDir().mkpath(this->directory_);
+
+        auto file = std::make_unique<QFile>(this->filePath(channelName));
+        if (!file->open(QIODevice::WriteOnly | QIODevice::Append))
+        {
+            qCWarning(chatterinoTwitch)
+                << "Failed to open message history file" << file->fileName();
+            return;
+        }
+        it = this->files_.emplace(channelName, std::move(file)).first;
+    }
+
+    auto &file = *it->second;
+    file.write(data);
+    file.flush();
+
+    if (file.size() > MAX_FILE_SIZE)
+    {
+        this->compact(channelName);
+    }
+}
+
+void HistorySpill::compact(const QString &channelName)
+{
+    // closed so it can be replaced, it's opened again by the next write
+    this->files_.erase(channelName);
+
+    QByteArray newest;
+    {
+        QFile file(this->filePath(channelName));
+        if (!file.open(QIODevice::ReadOnly))
+        {
+            return;
+        }
+
+        auto size = file.size();
+        const auto *data = reinterpret_cast<const char *>(file.map(0, size));
+        if (data == nullptr || size <= COMPACTED_FILE_SIZE)
+        {
+            return;
+        }
+
+        // starts after the first newline so no line is cut in half
+        auto offset = size - COMPACTED_FILE_SIZE;
+        const auto *newline = static_cast<const char *>(
+            std::memchr(data + offset, '\n', size_t(size - offset)));
+        if (newline == nullptr)
+        {
+            return;
+        }
+
+        newest = QByteArray(newline + 1, int(data + size - newline - 1));
+    }
+
+    QSaveFile file(this->filePath(channelName));
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        return;
+    }
+    file.write(newest);
+    if (!file.commit())
+    {
+        qCWarning(chatterinoTwitch)
+            << "Failed to compact message history file" << file.fileName();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,71 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <IrcMessage>
+#include <QByteArray>
+#include <QFile>
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Keeps the recent chat of every channel on disk between restarts.
+ *
+ * Every channel has a file in the directory with the raw IRC lines of its
+ * messages, one per line, in the format of the recent-messages API. The time
+ * a line was received is kept in its rm-received-ts tag. Lines are appended
+ * on a background thread in batches, files that grew too big are cut down to
+ * their newest lines. Reading maps the file, only its end is looked at.
+ */
+class HistorySpill : boost::noncopyable
+{
+public:
+    explicit HistorySpill(QString directory);
+    /// Writes everything that's still queued
+    ~HistorySpill();
+
+    /// Queues the raw line of message for the file of channelName
+    void append(const QString &channelName,
+                const Communi::IrcMessage &message);
+
+    /// Returns the newest lines of channelName that were received before
+    /// beforeMs, up to limit, oldest first. Can be called from any thread.
+    std::vector<QByteArray> load(const QString &channelName,
+                                 qint64 beforeMs, size_t limit) const;
+
+private:
+    struct Entry {
+        QString channelName;
+        QByteArray line;
+    };
+
+    QString filePath(const QString &channelName) const;
+
+    void run();
+    void write(const QString &channelName, const QByteArray &data);
+    // Rewrites the file with only its newest lines
+    void compact(const QString &channelName);
+
+    const QString directory_;
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<Entry> queue_;
+    bool stopping_ = false;
+
+    // writer thread only
+    std::unordered_map<QString, std::unique_ptr<QFile>> files_;
+
+    std::thread thread_;
+};
+
+}  // namespace chatterino
@@ -3,6 +3,7 @@
 #include "Application.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "controllers/ignores/IgnoreController.hpp"
 #include "messages/LimitedQueue.hpp"
 #include "messages/Message.hpp"
 #include "providers/twitch/TwitchAccountManager.hpp"
@@ -13,9 +14,11 @@
 #include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/DebugCount.hpp"
 #include "util/FormatTime.hpp"
 #include "util/Helpers.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/Similarity.hpp"
 
 #include <IrcMessage>
 
@@ -24,6 +27,8 @@
 namespace {
 using namespace chatterino;
 
+DebugCounter ignoredMessages("ignored messages");
+
 // Message types below are the ones that might contain special user's message on USERNOTICE
 static const QSet<QString> specialMessageTypes{
     "sub",            //
@@ -70,57 +75,19 @@ MessagePtr generateBannedMessage(bool confirmedBan)
 }  // namespace
 namespace chatterino {
 
-static float relativeSimilarity(const QString &str1, const QString &str2)
+bool IrcMessageHandler::isSimilar(
+    MessagePtr msg, const LimitedQueueSnapshot<MessagePtr> &messages,
+    float threshold)
 {
-    // Longest Common Substring Problem
-    std::vector<std::vector<int>> tree(str1.size(),
-                                       std::vector<int>(str2.size(), 0));
-    int z = 0;
-
-    for (int i = 0; i < str1.size(); ++i)
-    {
-        for (int j = 0; j < str2.size(); ++j)
-        {
-            if (str1[i] == str2[j])
-            {
-                if (i == 0 || j == 0)
-                {
-                    tree[i][j] = 1;
-                }
-                else
-                {
-                    tree[i][j] = tree[i - 1][j - 1] + 1;
-                }
-                if (tree[i][j] > z)
-                {
-                    z = tree[i][j];
-                }
-            }
-            else
-            {
-                tree[i][j] = 0;
-            }
-        }
-    }
-
-    // ensure that no div by 0
-    return z == 0 ? 0.f
-                  : float(z) /
-                        std::max<int>(1, std::max(str1.size(), str2.size()));
-};
-
-float IrcMessageHandler::similarity(
-    MessagePtr msg, const LimitedQueueSnapshot<MessagePtr> &messages)
-{
-    float similarityPercent = 0.0f;
     int checked = 0;
-    for (int i = 1; i <= messages.size(); ++i)
+    // newest first
+    for (auto it = messages.rbegin(); it != messages.rend(); ++it)
     {
         if (checked >= getSettings()->hideSimilarMaxMessagesToCheck)
         {
             break;
         }
-        const auto &prevMsg = messages[messages.size() - i];
+        const auto &prevMsg = *it;
         if (prevMsg->parseTime.secsTo(QTime::currentTime()) >=
             getSettings()->hideSimilarMaxDelay)
         {
@@ -132,11 +99,13 @@ float IrcMessageHandler::similarity(
             continue;
         }
         ++checked;
-        similarityPercent = std::max(
-            similarityPercent,
-            relativeSimilarity(msg->messageText, prevMsg->messageText));
+        if (chatterino::isSimilar(msg->messageText, prevMsg->messageText,
+                                  threshold))
+        {
+            return true;
+        }
     }
-    return similarityPercent;
+    return false;
 }
 
 void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
@@ -152,8 +121,8 @@ void IrcMessageHandler::setSimilarityFlags(MessagePtr msg, ChannelPtr chan)
             return;
         }
 
-        if (IrcMessageHandler::similarity(msg, chan->getMessageSnapshot()) >
-            getSettings()->similarityPercentage)
+        if (IrcMessageHandler::isSimilar(msg, chan->getMessageSnapshot(),
+                                         getSettings()->similarityPercentage))
         {
             msg->flags.set(MessageFlag::Similar, true);
             if (getSettings()->colorSimilarDisabled)
@@ -246,7 +215,7 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
                                    const QString &target,
                                    const QString &content,
                                    TwitchIrcServer &server, bool isSub,
-                                   bool isAction)
+                                   bool isAction, bool waitForReward)
 {
     QString channelName;
     if (!trimChannelName(target, channelName))
@@ -275,63 +244,112 @@ void IrcMessageHandler::addMessage(Communi::IrcMessage *_message,
     auto channel = dynamic_cast<TwitchChannel *>(chan.get());
 
     const auto &tags = _message->tags();
+
+    // checked on the raw message, ignored messages aren't copied or built
+    if (!isSub && isIgnoredMessage({
+                      /*.message = */ content,
+                      /*.twitchUserID = */
+                      tags.value(QStringLiteral("user-id")).toString(),
+                      /*.isMod = */ chan->isMod(),
+                      /*.isBroadcaster = */ chan->isBroadcaster(),
+                  }))
+    {
+        ignoredMessages.increase();
+        return;
+    }
     if (const auto &it = tags.find("custom-reward-id"); it != tags.end())
     {
         const auto rewardId = it.value().toString();
-        if (!channel->isChannelPointRewardKnown(rewardId))
+        if (waitForReward && !channel->isChannelPointRewardKnown(rewardId))
         {
             // Need to wait for pubsub reward notification
-            auto clone = _message->clone();
-            channel->channelPointRewardAdded.connect(
-                [=, &server](ChannelPointReward reward) {
-                    if (reward.id == rewardId)
-                    {
-                        this->addMessage(clone, target, content, server, isSub,
-                                         isAction);
-                        clone->deleteLater();
-                        return true;
-                    }
-                    return false;
+            std::shared_ptr<Communi::IrcMessage> clone(
+                _message->clone(), [](Communi::IrcMessage *m) {
+                    m->deleteLater();
+                });
+            channel->waitForChannelPointReward(
+                rewardId, [=, &server](bool known) {
+                    // shown without the reward if it didn't arrive in time
+                    this->addMessage(clone.get(), target, content, server,
+                                     isSub, isAction, known);
                 });
             return;
         }
-        args.channelPointRewardId = rewardId;
+        if (waitForReward)
+        {
+            args.channelPointRewardId = rewardId;
+        }
     }
 
-    TwitchMessageBuilder builder(chan.get(), _message, args, content, isAction);
+    // the connection deletes the message once this returns
+    std::shared_ptr<Communi::IrcMessage> clone(_message->clone(),
+                                               [](Communi::IrcMessage *m) {
+                                                   m->deleteLater();
+                                               });
 
-    if (isSub || !builder.isIgnored())
-    {
-        if (isSub)
-        {
-            builder->flags.set(MessageFlag::Subscription);
-            builder->flags.unset(MessageFlag::Highlighted);
-        }
-        auto msg = builder.build();
+    // emote lookup, highlights and link parsing only read thread safe
+    // snapshots, the message is added on the gui thread
+    this->buildQueue_.run(
+        channelName, [=, &server]() -> OrderedWorkQueue::Result {
+            auto builder = std::make_shared<TwitchMessageBuilder>(
+                chan.get(), clone.get(), args, content, isAction);
 
-        IrcMessageHandler::setSimilarityFlags(msg, chan);
+            if (isSub)
+            {
+                (*builder)->flags.set(MessageFlag::Subscription);
+                (*builder)->flags.unset(MessageFlag::Highlighted);
+            }
+            auto msg = builder->build();
 
-        if (!msg->flags.has(MessageFlag::Similar) ||
-            (!getSettings()->hideSimilar &&
-             getSettings()->shownSimilarTriggerHighlights))
-        {
-            builder.triggerHighlights();
-        }
+            return [=, &server] {
+                IrcMessageHandler::setSimilarityFlags(msg, chan);
 
-        const auto highlighted = msg->flags.has(MessageFlag::Highlighted);
-        const auto showInMentions = msg->flags.has(MessageFlag::ShowInMentions);
+                if (!msg->flags.has(MessageFlag::Similar) ||
+                    (!getSettings()->hideSimilar &&
+                     getSettings()->shownSimilarTriggerHighlights))
+                {
+                    builder->triggerHighlights();
+                }
 
-        if (highlighted && showInMentions)
-        {
-            server.mentionsChannel->addMessage(msg);
-        }
+                const auto highlighted =
+                    msg->flags.has(MessageFlag::Highlighted);
+                const auto showInMentions =
+                    msg->flags.has(MessageFlag::ShowInMentions);
 
-        chan->addMessage(msg);
-        if (auto chatters = dynamic_cast<ChannelChatters *>(chan.get()))
-        {
-            chatters->addRecentChatter(msg->displayName);
-        }
+                if (highlighted && showInMentions)
+                {
+                    server.mentionsChannel->collect(msg);
+                }
+
+                chan->addMessage(msg);
+                if (auto chatters = dynamic_cast<ChannelChatters *>(chan.get()))
+                {
+                    chatters->addRecentChatter(msg->displayName);
+                }
+            };
+        });
+}
+
+void IrcMessageHandler::handleInOrder(
+    Communi::IrcMessage *message,
+    std::function<void(Communi::IrcMessage *)> handle)
+{
+    QString channelName;
+    if (message->parameters().isEmpty() ||
+        !trimChannelName(message->parameter(0), channelName) ||
+        !this->buildQueue_.hasPending(channelName))
+    {
+        handle(message);
+        return;
     }
+
+    std::shared_ptr<Communi::IrcMessage> clone(message->clone(),
+                                               [](Communi::IrcMessage *m) {
+                                                   m->deleteLater();
+                                               });
+    this->buildQueue_.runAfter(channelName, [clone, handle] {
+        handle(clone.get());
+    });
 }
 
 void IrcMessageHandler::handleRoomStateMessage(Communi::IrcMessage *message)
@@ -439,14 +457,8 @@ void IrcMessageHandler::handleClearChatMessage(Communi::IrcMessage *message)
         MessageBuilder(timeoutMessage, username, durationInSeconds, false,
                        calculateMessageTimestamp(message))
             .release();
+    // the views lay out the disabled messages again
     chan->addOrReplaceTimeout(timeoutMsg);
-
-    // refresh all
-    getApp()->windows->repaintVisibleChatWidgets(chan.get());
-    if (getSettings()->hideModerated)
-    {
-        getApp()->windows->forceLayoutChannelViews();
-    }
 }
 
 void IrcMessageHandler::handleClearMessageMessage(Communi::IrcMessage *message)
@@ -483,7 +495,7 @@ void IrcMessageHandler::handleClearMessageMessage(Communi::IrcMessage *message)
     if (msg == nullptr)
         return;
 
-    msg->flags.set(MessageFlag::Disabled);
+    chan->deleteMessage(targetID);
     if (!getSettings()->hideDeletionActions)
     {
         MessageBuilder builder;
@@ -586,10 +598,10 @@ void IrcMessageHandler::handleWhisperMessage(Communi::IrcMessage *message)
 
     if (_message->flags.has(MessageFlag::Highlighted))
     {
-        getApp()->twitch->mentionsChannel->addMessage(_message);
+        getApp()->twitch->mentionsChannel->collect(_message);
     }
 
-    c->addMessage(_message);
+    c->collect(_message);
 
     auto overrideFlags = boost::optional<MessageFlags>(_message->flags);
     overrideFlags->set(MessageFlag::DoNotTriggerNotification);
@@ -905,11 +917,16 @@ void IrcMessageHandler::handleJoinMessage(Communi::IrcMessage *message)
         return;
     }
 
-    if (message->nick() !=
-            getApp()->accounts->twitch.getCurrent()->getUserName() &&
-        getSettings()->showJoins.getValue())
+    if (message->nick() ==
+        getApp()->accounts->twitch.getCurrent()->getUserName())
+    {
+        // messages arrive again from here on
+        twitchChannel->loadMissedMessages();
+    }
+    else
     {
-        twitchChannel->addJoinedUser(message->nick());
+        twitchChannel->addJoinedUser(message->nick(),
+                                     getSettings()->showJoins.getValue());
     }
 }
 
@@ -926,10 +943,10 @@ void IrcMessageHandler::handlePartMessage(Communi::IrcMessage *message)
 
     const auto selfAccountName =
         getApp()->accounts->twitch.getCurrent()->getUserName();
-    if (message->nick() != selfAccountName &&
-        getSettings()->showParts.getValue())
+    if (message->nick() != selfAccountName)
     {
-        twitchChannel->addPartedUser(message->nick());
+        twitchChannel->addPartedUser(message->nick(),
+                                     getSettings()->showParts.getValue());
     }
 
     if (message->nick() == selfAccountName)
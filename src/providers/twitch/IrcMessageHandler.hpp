@@ -3,6 +3,9 @@
 #include <IrcMessage>
 #include "common/Channel.hpp"
 #include "messages/Message.hpp"
+#include "util/OrderedWorkQueue.hpp"
+
+#include <functional>
 
 namespace chatterino {
 
@@ -51,14 +54,28 @@ public:
     void handleJoinMessage(Communi::IrcMessage *message);
     void handlePartMessage(Communi::IrcMessage *message);
 
-    static float similarity(MessagePtr msg,
-                            const LimitedQueueSnapshot<MessagePtr> &messages);
+    /// Calls handle with the message once all messages that were received
+    /// before it in its channel were added. The message may be a copy.
+    void handleInOrder(Communi::IrcMessage *message,
+                       std::function<void(Communi::IrcMessage *)> handle);
+
+    /// Whether msg is more similar than threshold to one of the recent
+    /// messages that are checked according to the settings
+    static bool isSimilar(MessagePtr msg,
+                          const LimitedQueueSnapshot<MessagePtr> &messages,
+                          float threshold);
     static void setSimilarityFlags(MessagePtr message, ChannelPtr channel);
 
 private:
+    /// waitForReward is false for messages that already waited for their
+    /// channel point reward, they're shown without it
     void addMessage(Communi::IrcMessage *message, const QString &target,
                     const QString &content, TwitchIrcServer &server,
-                    bool isResub, bool isAction);
+                    bool isResub, bool isAction, bool waitForReward = true);
+
+    // Messages are built on the thread pool, they are added to their
+    // channels in the order they were received in
+    OrderedWorkQueue buildQueue_;
 };
 
 }  // namespace chatterino
@@ -0,0 +1,261 @@
+#include "providers/twitch/IrcReplay.hpp"
+
+#include "Application.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "providers/twitch/PubsubClient.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+
+#include <QFile>
+
+#include <algorithm>
+#include <deque>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr int TICK_INTERVAL = 16;
+    // a tick that comes this much later than the previous one missed
+    // at least one frame
+    constexpr qint64 FRAME_US = TICK_INTERVAL * 1000;
+
+    // Returns the tmi-sent-ts tag of a raw line in milliseconds, -1 if it
+    // doesn't have one
+    qint64 sentTimestamp(const QByteArray &line)
+    {
+        if (!line.startsWith('@'))
+        {
+            return -1;
+        }
+
+        auto tagsEnd = line.indexOf(' ');
+        auto tags = line.left(tagsEnd);
+
+        static const QByteArray key = "tmi-sent-ts=";
+        auto start = tags.indexOf(key);
+        if (start == -1 || (start != 1 && tags[start - 1] != ';'))
+        {
+            return -1;
+        }
+        start += key.size();
+
+        auto end = tags.indexOf(';', start);
+        bool ok = false;
+        auto timestamp = tags.mid(start, end == -1 ? -1 : end - start)
+                             .toLongLong(&ok);
+        return ok ? timestamp : -1;
+    }
+
+}  // namespace
+
+QString IrcReplay::Stats::summary() const
+{
+    auto lineCount = std::max(this->lines, 1);
+    auto seconds = std::max<qint64>(this->durationMs, 1) / 1000.0;
+
+    return QString("Replayed %1 lines in %2 s (%3 lines/s). "
+                   "Ingest latency: %4 ms average, %5 ms max. "
+                   "Build: %6 us per line. "
+                   "Layout: %7 ms in %8 layouts. "
+                   "Dropped frames: %9")
+        .arg(this->lines)
+        .arg(seconds, 0, 'f', 1)
+        .arg(this->lines / seconds, 0, 'f', 0)
+        .arg(this->totalLatencyUs / lineCount / 1000.0, 0, 'f', 2)
+        .arg(this->maxLatencyUs / 1000.0, 0, 'f', 2)
+        .arg(this->buildUs / lineCount)
+        .arg(this->layoutUs / 1000.0, 0, 'f', 1)
+        .arg(this->layouts)
+        .arg(this->droppedFrames);
+}
+
+IrcReplay::IrcReplay()
+{
+    this->timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+        this->tick();
+    });
+}
+
+IrcReplay &IrcReplay::instance()
+{
+    static IrcReplay instance;
+    return instance;
+}
+
+QString IrcReplay::start(const QString &path, double linesPerSecond,
+                         double speed, FinishedCallback finished)
+{
+    assertInGuiThread();
+
+    if (this->isRunning())
+    {
+        return "A replay is already running";
+    }
+
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return QString("Could not open %1").arg(path);
+    }
+
+    this->lines_.clear();
+    qint64 firstTimestamp = -1;
+    qint64 lastDueUs = 0;
+
+    while (!file.atEnd())
+    {
+        auto data = file.readLine().trimmed();
+        if (data.isEmpty())
+        {
+            continue;
+        }
+
+        qint64 dueUs = 0;
+        if (linesPerSecond > 0)
+        {
+            dueUs = qint64(this->lines_.size() * 1000000 / linesPerSecond);
+        }
+        else
+        {
+            // lines without a timestamp go out together with the one
+            // before them
+            auto timestamp = sentTimestamp(data);
+            if (timestamp != -1 && firstTimestamp == -1)
+            {
+                firstTimestamp = timestamp;
+            }
+            dueUs = timestamp == -1
+                        ? lastDueUs
+                        : qint64((timestamp - firstTimestamp) * 1000 / speed);
+            // logs aren't always sorted by their timestamps
+            dueUs = std::max(dueUs, lastDueUs);
+        }
+
+        lastDueUs = dueUs;
+        this->lines_.push_back({std::move(data), dueUs});
+    }
+
+    if (this->lines_.empty())
+    {
+        return QString("%1 doesn't contain any lines").arg(path);
+    }
+
+    return this->start(std::move(this->lines_), std::move(finished));
+}
+
+QString IrcReplay::start(std::vector<Line> lines, FinishedCallback finished)
+{
+    assertInGuiThread();
+
+    if (this->isRunning())
+    {
+        return "A replay is already running";
+    }
+
+    if (lines.empty())
+    {
+        return "There are no lines to replay";
+    }
+
+    this->lines_ = std::move(lines);
+    this->next_ = 0;
+    this->stats_ = {};
+    this->finished_ = std::move(finished);
+    this->lastTickUs_ = 0;
+    this->elapsed_.start();
+    this->timer_.start(TICK_INTERVAL);
+
+    return "";
+}
+
+void IrcReplay::stop()
+{
+    if (this->isRunning())
+    {
+        this->finish();
+    }
+}
+
+bool IrcReplay::isRunning() const
+{
+    return this->timer_.isActive();
+}
+
+void IrcReplay::addLayoutTime(qint64 nsecs)
+{
+    if (this->isRunning())
+    {
+        this->stats_.layoutUs += nsecs / 1000;
+        this->stats_.layouts++;
+    }
+}
+
+void IrcReplay::tick()
+{
+    auto nowUs = this->elapsed_.nsecsElapsed() / 1000;
+
+    auto gapUs = nowUs - this->lastTickUs_;
+    if (gapUs > 2 * FRAME_US)
+    {
+        this->stats_.droppedFrames += int(gapUs / FRAME_US) - 1;
+    }
+    this->lastTickUs_ = nowUs;
+
+    std::deque<QByteArray> due;
+    int pubsubLines = 0;
+    while (this->next_ < this->lines_.size() &&
+           this->lines_[this->next_].dueUs <= nowUs)
+    {
+        auto &line = this->lines_[this->next_];
+
+        auto latencyUs = nowUs - line.dueUs;
+        this->stats_.totalLatencyUs += latencyUs;
+        this->stats_.maxLatencyUs =
+            std::max(this->stats_.maxLatencyUs, latencyUs);
+
+        if (line.pubsub)
+        {
+            // handled on the PubSub processing thread like real messages
+            getApp()->twitch->pubsub->addFakeMessage(line.data.toStdString());
+            pubsubLines++;
+        }
+        else
+        {
+            due.push_back(std::move(line.data));
+        }
+        this->next_++;
+    }
+
+    if (!due.empty() || pubsubLines != 0)
+    {
+        QElapsedTimer build;
+        build.start();
+        getApp()->twitch->replayLines(due);
+        this->stats_.buildUs += build.nsecsElapsed() / 1000;
+        this->stats_.lines += int(due.size()) + pubsubLines;
+    }
+    else if (this->next_ == this->lines_.size())
+    {
+        // one tick after the last lines, so their layouts are included
+        this->finish();
+    }
+}
+
+void IrcReplay::finish()
+{
+    this->timer_.stop();
+    this->stats_.durationMs = this->elapsed_.elapsed();
+
+    this->lines_.clear();
+    this->lines_.shrink_to_fit();
+
+    auto finished = std::move(this->finished_);
+    this->finished_ = nullptr;
+    if (finished)
+    {
+        finished(this->stats_);
+    }
+}
+
+}  // namespace chatterino
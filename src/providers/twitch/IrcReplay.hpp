@@ -0,0 +1,92 @@
+#pragma once
+
+#include <QByteArray>
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Plays a captured IRC log into TwitchIrcServer as if it was received
+ *        from TMI, to measure how the message pipeline holds up under load.
+ *
+ * The log holds one raw IRC line per line, generated loads can also contain
+ * PubSub messages. Lines are replayed either at a
+ * fixed rate or at a multiple of their original pace, which is taken from
+ * their tmi-sent-ts tags. Once the log is through, a summary with the ingest
+ * latency, build and layout times and the number of dropped frames is handed
+ * to the finished callback.
+ *
+ * Gui thread only.
+ */
+class IrcReplay
+{
+public:
+    struct Stats {
+        int lines = 0;
+        qint64 durationMs = 0;
+
+        // how far behind their scheduled time lines were handed to the server
+        qint64 totalLatencyUs = 0;
+        qint64 maxLatencyUs = 0;
+
+        // parsing, building and adding the messages to their channels
+        qint64 buildUs = 0;
+        // layouts of the channel views while the replay was running
+        qint64 layoutUs = 0;
+        int layouts = 0;
+
+        // frames the event loop was too busy for
+        int droppedFrames = 0;
+
+        QString summary() const;
+    };
+
+    struct Line {
+        QByteArray data;
+        // when the line is due, relative to the start of the replay
+        qint64 dueUs;
+        // the line is a PubSub message instead of a raw IRC line
+        bool pubsub = false;
+    };
+
+    using FinishedCallback = std::function<void(const Stats &)>;
+
+    static IrcReplay &instance();
+
+    /// Returns an error message if the log couldn't be loaded. A positive
+    /// linesPerSecond replays at that fixed rate, otherwise the original
+    /// pace is sped up by speed.
+    QString start(const QString &path, double linesPerSecond, double speed,
+                  FinishedCallback finished);
+    /// Replays lines that were made up instead of read from a log, they
+    /// must be sorted by when they're due
+    QString start(std::vector<Line> lines, FinishedCallback finished);
+    void stop();
+    bool isRunning() const;
+
+    /// Called by the channel views for every layout they perform
+    void addLayoutTime(qint64 nsecs);
+
+private:
+    IrcReplay();
+
+    void tick();
+    void finish();
+
+    QTimer timer_;
+    QElapsedTimer elapsed_;
+    qint64 lastTickUs_ = 0;
+
+    std::vector<Line> lines_;
+    size_t next_ = 0;
+
+    Stats stats_;
+    FinishedCallback finished_;
+};
+
+}  // namespace chatterino
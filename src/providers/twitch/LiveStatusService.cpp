@@ -0,0 +1,172 @@
+#include "providers/twitch/LiveStatusService.hpp"
+
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "providers/twitch/api/HelixBatcher.hpp"
+#include "util/QStringHash.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    // only the parts that are shown somewhere count as a change
+    bool sameStream(const HelixStream &a, const HelixStream &b)
+    {
+        return a.id == b.id && a.gameId == b.gameId &&
+               a.gameName == b.gameName && a.type == b.type &&
+               a.title == b.title && a.viewerCount == b.viewerCount &&
+               a.startedAt == b.startedAt;
+    }
+
+}  // namespace
+
+LiveStatusService::LiveStatusService()
+{
+    QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+        this->poll();
+    });
+    this->timer_.start(POLL_INTERVAL);
+}
+
+LiveStatusService &LiveStatusService::instance()
+{
+    static LiveStatusService instance;
+    return instance;
+}
+
+void LiveStatusService::watch(const QString &userLogin, const void *owner,
+                              Callback callback)
+{
+    assertInGuiThread();
+
+    auto login = userLogin.toLower();
+    if (login.isEmpty())
+    {
+        return;
+    }
+
+    auto it = this->channels_.find(login);
+    bool added = it == this->channels_.end();
+    if (added)
+    {
+        it = this->channels_.emplace(login, Entry{}).first;
+    }
+
+    auto &entry = it->second;
+    auto watcher = std::find_if(entry.watchers.begin(), entry.watchers.end(),
+                                [owner](const auto &watcher) {
+                                    return watcher.owner == owner;
+                                });
+    if (watcher != entry.watchers.end())
+    {
+        watcher->callback = std::move(callback);
+    }
+    else
+    {
+        entry.watchers.push_back({owner, std::move(callback)});
+    }
+
+    if (added)
+    {
+        this->fetch(login);
+    }
+    else if (entry.known)
+    {
+        // copied, the callback might unwatch
+        auto live = entry.live;
+        auto stream = entry.stream;
+        auto watcherCallback = entry.watchers.back().callback;
+        watcherCallback(live, stream);
+    }
+}
+
+void LiveStatusService::unwatch(const QString &userLogin, const void *owner)
+{
+    assertInGuiThread();
+
+    auto it = this->channels_.find(userLogin.toLower());
+    if (it == this->channels_.end())
+    {
+        return;
+    }
+
+    auto &watchers = it->second.watchers;
+    watchers.erase(std::remove_if(watchers.begin(), watchers.end(),
+                                  [owner](const auto &watcher) {
+                                      return watcher.owner == owner;
+                                  }),
+                   watchers.end());
+
+    if (watchers.empty())
+    {
+        this->channels_.erase(it);
+    }
+}
+
+void LiveStatusService::refresh(const QString &userLogin)
+{
+    auto login = userLogin.toLower();
+    if (this->channels_.count(login) != 0)
+    {
+        this->fetch(login);
+    }
+}
+
+void LiveStatusService::poll()
+{
+    qCDebug(chatterinoTwitch)
+        << "Refreshing live status of" << this->channels_.size() << "channels";
+
+    // the batcher sends these in as few requests as possible
+    for (const auto &channel : this->channels_)
+    {
+        this->fetch(channel.first);
+    }
+}
+
+void LiveStatusService::fetch(const QString &login)
+{
+    HelixBatcher::instance().getStreamByName(
+        login,
+        [this, login](bool live, const auto &stream) {
+            this->update(login, live, stream);
+        },
+        [login] {
+            qCWarning(chatterinoTwitch)
+                << "Failed to fetch live status for" << login;
+        });
+}
+
+void LiveStatusService::update(const QString &login, bool live,
+                               const HelixStream &stream)
+{
+    auto it = this->channels_.find(login);
+    if (it == this->channels_.end())
+    {
+        // nobody is watching it anymore
+        return;
+    }
+
+    auto &entry = it->second;
+    if (entry.known && entry.live == live &&
+        (!live || sameStream(entry.stream, stream)))
+    {
+        return;
+    }
+
+    entry.known = true;
+    entry.live = live;
+    entry.stream = live ? stream : HelixStream();
+
+    // copied, the callbacks might watch and unwatch channels
+    auto watchers = entry.watchers;
+    auto current = entry.stream;
+    for (const auto &watcher : watchers)
+    {
+        watcher.callback(live, current);
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,66 @@
+#pragma once
+
+#include "providers/twitch/api/Helix.hpp"
+
+#include <QString>
+#include <QTimer>
+
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Polls the live status of all watched Twitch channels.
+ *
+ * Every channel is polled once per round no matter how many watchers it has,
+ * all of them are looked up in the same batch. Watchers are only called when
+ * the status of their channel changed since the last poll and once with the
+ * first known status.
+ *
+ * Gui thread only.
+ */
+class LiveStatusService
+{
+public:
+    static constexpr int POLL_INTERVAL = 60 * 1000;
+
+    using Callback = std::function<void(bool live, const HelixStream &stream)>;
+
+    static LiveStatusService &instance();
+
+    // Polls userLogin until owner stops watching it, an owner watches every
+    // channel at most once. The callback is called right away if the status
+    // is already known.
+    void watch(const QString &userLogin, const void *owner, Callback callback);
+    void unwatch(const QString &userLogin, const void *owner);
+
+    // Polls userLogin now instead of waiting for the next round
+    void refresh(const QString &userLogin);
+
+private:
+    LiveStatusService();
+
+    struct Watcher {
+        const void *owner;
+        Callback callback;
+    };
+
+    struct Entry {
+        std::vector<Watcher> watchers;
+        bool known = false;
+        bool live = false;
+        HelixStream stream;
+    };
+
+    void poll();
+    void fetch(const QString &login);
+    void update(const QString &login, bool live, const HelixStream &stream);
+
+    // keyed by the lowercase login
+    std::unordered_map<QString, Entry> channels_;
+    QTimer timer_;
+};
+
+}  // namespace chatterino
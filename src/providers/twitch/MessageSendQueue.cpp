@@ -0,0 +1,186 @@
+#include "providers/twitch/MessageSendQueue.hpp"
+
+#include <QSet>
+
+#include <algorithm>
+#include <unordered_set>
+
+namespace chatterino {
+
+constexpr std::chrono::seconds MessageSendQueue::WINDOW;
+constexpr size_t MessageSendQueue::LOW_LIMIT;
+constexpr size_t MessageSendQueue::HIGH_LIMIT;
+constexpr std::chrono::milliseconds MessageSendQueue::LOW_CHANNEL_GAP;
+constexpr std::chrono::milliseconds MessageSendQueue::HIGH_CHANNEL_GAP;
+
+bool MessageSendQueue::isModerationCommand(const QString &message)
+{
+    static const QSet<QString> commands{
+        "ban", "unban", "timeout", "untimeout", "delete", "clear", "slow",
+        "slowoff", "followers", "followersoff", "subscribers", "subscribersoff",
+        "emoteonly", "emoteonlyoff", "uniquechat", "uniquechatoff", "r9kbeta",
+        "r9kbetaoff", "mod", "unmod", "vip", "unvip",
+    };
+
+    if (!message.startsWith('/') && !message.startsWith('.'))
+    {
+        return false;
+    }
+
+    auto end = message.indexOf(' ');
+    auto command = message.mid(1, end == -1 ? -1 : end - 1).toLower();
+
+    return commands.contains(command);
+}
+
+void MessageSendQueue::push(Entry entry)
+{
+    this->lanes_[size_t(entry.priority)].push_back(std::move(entry));
+}
+
+std::vector<MessageSendQueue::Entry> MessageSendQueue::takeSendable(
+    Clock::time_point now)
+{
+    this->forget(now);
+
+    std::vector<Entry> sendable;
+
+    // Sending one message can hold back others, so the lanes are searched
+    // again after each one
+    bool sent = true;
+    while (sent)
+    {
+        sent = false;
+
+        for (auto &lane : this->lanes_)
+        {
+            // channels with an older message waiting in this lane
+            std::unordered_set<QString> waiting;
+
+            for (auto it = lane.begin(); it != lane.end(); ++it)
+            {
+                if (waiting.count(it->channel) != 0)
+                {
+                    continue;
+                }
+
+                if (this->sendTime(*it, now) > now)
+                {
+                    waiting.insert(it->channel);
+                    continue;
+                }
+
+                (it->highRateLimit ? this->highSent_ : this->lowSent_)
+                    .push_back(now);
+                this->lastChannelSend_[it->channel] = now;
+
+                sendable.push_back(std::move(*it));
+                lane.erase(it);
+                sent = true;
+                break;
+            }
+
+            if (sent)
+            {
+                break;
+            }
+        }
+    }
+
+    return sendable;
+}
+
+boost::optional<MessageSendQueue::Clock::time_point>
+    MessageSendQueue::nextSendTime(Clock::time_point now) const
+{
+    boost::optional<Clock::time_point> next;
+
+    for (const auto &lane : this->lanes_)
+    {
+        std::unordered_set<QString> waiting;
+
+        for (const auto &entry : lane)
+        {
+            if (!waiting.insert(entry.channel).second)
+            {
+                continue;
+            }
+
+            auto time = this->sendTime(entry, now);
+            if (!next || time < *next)
+            {
+                next = time;
+            }
+        }
+    }
+
+    return next;
+}
+
+size_t MessageSendQueue::size() const
+{
+    return this->lanes_[0].size() + this->lanes_[1].size();
+}
+
+size_t MessageSendQueue::size(const QString &channel) const
+{
+    size_t count = 0;
+    for (const auto &lane : this->lanes_)
+    {
+        count += size_t(std::count_if(lane.begin(), lane.end(),
+                                      [&](const Entry &entry) {
+                                          return entry.channel == channel;
+                                      }));
+    }
+
+    return count;
+}
+
+MessageSendQueue::Clock::time_point MessageSendQueue::sendTime(
+    const Entry &entry, Clock::time_point now) const
+{
+    auto time = now;
+
+    const auto &sent = entry.highRateLimit ? this->highSent_ : this->lowSent_;
+    auto limit = entry.highRateLimit ? HIGH_LIMIT : LOW_LIMIT;
+    if (sent.size() >= limit)
+    {
+        // once the oldest message that still counts leaves the window
+        time = std::max(time, sent[sent.size() - limit] + WINDOW);
+    }
+
+    auto last = this->lastChannelSend_.find(entry.channel);
+    if (last != this->lastChannelSend_.end())
+    {
+        auto gap = entry.highRateLimit ? HIGH_CHANNEL_GAP : LOW_CHANNEL_GAP;
+        time = std::max(time, last->second + gap);
+    }
+
+    return time;
+}
+
+void MessageSendQueue::forget(Clock::time_point now)
+{
+    for (auto *sent : {&this->lowSent_, &this->highSent_})
+    {
+        while (!sent->empty() && sent->front() + WINDOW <= now)
+        {
+            sent->pop_front();
+        }
+    }
+
+    for (auto it = this->lastChannelSend_.begin();
+         it != this->lastChannelSend_.end();)
+    {
+        if (it->second + LOW_CHANNEL_GAP <= now)
+        {
+            it = this->lastChannelSend_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+}  // namespace chatterino
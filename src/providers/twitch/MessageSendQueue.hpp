@@ -0,0 +1,84 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <boost/optional.hpp>
+
+#include <chrono>
+#include <deque>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Holds back outgoing chat messages until Twitch's rate limits allow
+ *        them to be sent.
+ *
+ * In 30 seconds Twitch accepts 20 messages in channels where the user isn't
+ * a moderator or VIP and 100 in channels where they are. Messages of the same
+ * channel are also spaced out a bit. Moderation commands skip ahead of the
+ * chat messages waiting in the queue, but messages of a channel are never
+ * reordered otherwise.
+ *
+ * Only models the limits, sending and timers are up to the caller.
+ */
+class MessageSendQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum class Priority {
+        Moderation,
+        Chat,
+    };
+
+    struct Entry {
+        QString channel;
+        QString message;
+        // the user is a moderator or VIP in the channel
+        bool highRateLimit = false;
+        Priority priority = Priority::Chat;
+    };
+
+    // Time window of the limits, with a bit of margin for clocks that are
+    // slightly off
+    static constexpr std::chrono::seconds WINDOW{32};
+    // Twitch allows 20 and 100, one is kept in reserve
+    static constexpr size_t LOW_LIMIT = 19;
+    static constexpr size_t HIGH_LIMIT = 99;
+    static constexpr std::chrono::milliseconds LOW_CHANNEL_GAP{1100};
+    static constexpr std::chrono::milliseconds HIGH_CHANNEL_GAP{100};
+
+    static bool isModerationCommand(const QString &message);
+
+    void push(Entry entry);
+
+    /// Removes and returns the messages that can be sent now, in the order
+    /// they have to be sent in. They count against the limits right away.
+    std::vector<Entry> takeSendable(Clock::time_point now);
+
+    /// Returns the time the next queued message can be sent at, boost::none
+    /// if nothing is queued
+    boost::optional<Clock::time_point> nextSendTime(
+        Clock::time_point now) const;
+
+    size_t size() const;
+    size_t size(const QString &channel) const;
+
+private:
+    Clock::time_point sendTime(const Entry &entry,
+                               Clock::time_point now) const;
+    void forget(Clock::time_point now);
+
+    // queued messages of each priority, oldest first
+    std::deque<Entry> lanes_[2];
+
+    // send times of the last WINDOW, oldest first
+    std::deque<Clock::time_point> lowSent_;
+    std::deque<Clock::time_point> highSent_;
+    std::unordered_map<QString, Clock::time_point> lastChannelSend_;
+};
+
+}  // namespace chatterino
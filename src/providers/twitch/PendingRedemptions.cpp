@@ -0,0 +1,71 @@
+#include "providers/twitch/PendingRedemptions.hpp"
+
+#include <vector>
+
+namespace chatterino {
+
+void PendingRedemptions::add(const QString &rewardId, Callback callback,
+                             Clock::time_point now)
+{
+    this->expire(now);
+
+    this->entries_.push_back({rewardId, now, std::move(callback)});
+
+    if (this->entries_.size() > MAX_PENDING)
+    {
+        auto oldest = std::move(this->entries_.front());
+        this->entries_.pop_front();
+        oldest.callback(false);
+    }
+}
+
+void PendingRedemptions::rewardAdded(const QString &rewardId)
+{
+    // callbacks can add entries, so they only run once they're taken out
+    std::vector<Callback> ready;
+    for (auto it = this->entries_.begin(); it != this->entries_.end();)
+    {
+        if (it->rewardId == rewardId)
+        {
+            ready.push_back(std::move(it->callback));
+            it = this->entries_.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+
+    for (const auto &callback : ready)
+    {
+        callback(true);
+    }
+}
+
+void PendingRedemptions::expire(Clock::time_point now)
+{
+    std::vector<Callback> expired;
+    while (!this->entries_.empty() &&
+           now - this->entries_.front().added >= TIMEOUT)
+    {
+        expired.push_back(std::move(this->entries_.front().callback));
+        this->entries_.pop_front();
+    }
+
+    for (const auto &callback : expired)
+    {
+        callback(false);
+    }
+}
+
+size_t PendingRedemptions::size() const
+{
+    return this->entries_.size();
+}
+
+bool PendingRedemptions::empty() const
+{
+    return this->entries_.empty();
+}
+
+}  // namespace chatterino
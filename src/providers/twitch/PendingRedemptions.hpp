@@ -0,0 +1,54 @@
+#pragma once
+
+#include <QString>
+
+#include <chrono>
+#include <deque>
+#include <functional>
+
+namespace chatterino {
+
+/**
+ * @brief Messages that redeemed a reward which PubSub hasn't told us about
+ *        yet.
+ *
+ * IRC only has the id of the reward, its title, cost and image come from
+ * PubSub, which can arrive before or after the message. Waiting messages
+ * are kept in the order they arrived in. They give up once they waited for
+ * TIMEOUT, and the oldest one gives up if there are more than MAX_PENDING,
+ * so a channel without PubSub doesn't keep its messages forever.
+ *
+ * Gui thread only.
+ */
+class PendingRedemptions
+{
+public:
+    using Clock = std::chrono::steady_clock;
+    /// Gets true once the reward is known, false if it gave up waiting
+    using Callback = std::function<void(bool)>;
+
+    static constexpr size_t MAX_PENDING = 64;
+    static constexpr std::chrono::milliseconds TIMEOUT{10000};
+
+    void add(const QString &rewardId, Callback callback, Clock::time_point now);
+
+    /// Runs the callbacks waiting for the reward, oldest first
+    void rewardAdded(const QString &rewardId);
+    /// Runs the callbacks that waited for TIMEOUT
+    void expire(Clock::time_point now);
+
+    size_t size() const;
+    bool empty() const;
+
+private:
+    struct Entry {
+        QString rewardId;
+        Clock::time_point added;
+        Callback callback;
+    };
+
+    // oldest first
+    std::deque<Entry> entries_;
+};
+
+}  // namespace chatterino
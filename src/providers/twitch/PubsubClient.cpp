@@ -1,6 +1,7 @@
 #include "providers/twitch/PubsubClient.hpp"
 
 #include "providers/twitch/PubsubActions.hpp"
+#include "debug/Trace.hpp"
 #include "providers/twitch/PubsubHelpers.hpp"
 #include "singletons/Settings.hpp"
 #include "util/DebugCount.hpp"
@@ -9,6 +10,8 @@
 
 #include <rapidjson/error/en.h>
 
+#include <algorithm>
+#include <chrono>
 #include <exception>
 #include <iostream>
 #include <thread>
@@ -27,6 +30,106 @@ static const char *pingPayload = "{\"type\":\"PING\"}";
 static std::map<QString, RequestMessage> sentListens;
 static std::map<QString, RequestMessage> sentUnlistens;
 
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+
+    DebugCounter queuedMessages("PubSub queued messages");
+    // decompressed, compare with the traffic of the process to see what
+    // compression saves
+    DebugCounter payloadBytes("PubSub payload bytes");
+
+    // whether the server accepted permessage-deflate for the connection
+    bool isCompressed(WebsocketClient &client, WebsocketHandle hdl)
+    {
+        WebsocketErrorCode ec;
+        auto connection = client.get_con_from_hdl(std::move(hdl), ec);
+        if (ec)
+        {
+            return false;
+        }
+        const auto &extensions =
+            connection->get_response_header("Sec-WebSocket-Extensions");
+        return extensions.find("permessage-deflate") != std::string::npos;
+    }
+
+    enum class TopicKind {
+        Whispers,
+        ModeratorActions,
+        PointRewards,
+        Automod,
+        Unknown,
+    };
+
+    struct TopicType {
+        TopicKind kind;
+        QLatin1String prefix;
+
+        // their counts are the numbers of handled messages
+        std::shared_ptr<DebugHistogram> queueLatency;
+        std::shared_ptr<DebugHistogram> handlingTime;
+    };
+
+    TopicType makeTopicType(TopicKind kind, const char *prefix,
+                            const QString &name)
+    {
+        return {kind, QLatin1String(prefix),
+                std::make_shared<DebugHistogram>(
+                    QString("PubSub %1 queue latency").arg(name)),
+                std::make_shared<DebugHistogram>(
+                    QString("PubSub %1 handling time").arg(name))};
+    }
+
+    const TopicType &findTopicType(const QString &topic)
+    {
+        static const std::vector<TopicType> types{
+            makeTopicType(TopicKind::Whispers, "whispers.", "whispers"),
+            makeTopicType(TopicKind::ModeratorActions,
+                          "chat_moderator_actions.", "moderator actions"),
+            makeTopicType(TopicKind::PointRewards,
+                          "community-points-channel-v1.", "point rewards"),
+            makeTopicType(TopicKind::Automod, "automod-queue.", "automod"),
+        };
+        static const TopicType unknown =
+            makeTopicType(TopicKind::Unknown, "", "unknown topic");
+
+        for (const auto &type : types)
+        {
+            if (topic.startsWith(type.prefix))
+            {
+                return type;
+            }
+        }
+
+        return unknown;
+    }
+
+    // Counts the handled messages of a topic, their time in the processing
+    // queue and the time it took to handle them
+    class TopicStats
+    {
+    public:
+        TopicStats(const TopicType &type, Clock::time_point received)
+            : type_(type)
+            , received_(received)
+            , started_(Clock::now())
+        {
+        }
+
+        ~TopicStats()
+        {
+            this->type_.queueLatency->record(this->started_ - this->received_);
+            this->type_.handlingTime->record(Clock::now() - this->started_);
+        }
+
+    private:
+        const TopicType &type_;
+        const Clock::time_point received_;
+        const Clock::time_point started_;
+    };
+
+}  // namespace
+
 namespace detail {
 
     PubSubClient::PubSubClient(WebsocketClient &websocketClient,
@@ -52,11 +155,17 @@ namespace detail {
         this->started_ = false;
     }
 
+    bool PubSubClient::canListen(int topicCount) const
+    {
+        return !this->closing_ &&
+               this->numListens_ + topicCount <= MAX_PUBSUB_LISTENS;
+    }
+
     bool PubSubClient::listen(rapidjson::Document &message)
     {
         int numRequestedListens = message["data"]["topics"].Size();
 
-        if (this->numListens_ + numRequestedListens > MAX_PUBSUB_LISTENS)
+        if (!this->canListen(numRequestedListens))
         {
             // This PubSubClient is already at its peak listens
             return false;
@@ -65,10 +174,13 @@ namespace detail {
         DebugCount::increase("PubSub topic pending listens",
                              numRequestedListens);
 
+        QString authToken;
+        rj::getSafe(message["data"], "auth_token", authToken);
+
         for (const auto &topic : message["data"]["topics"].GetArray())
         {
             this->listeners_.emplace_back(
-                Listener{topic.GetString(), false, false, false});
+                Listener{topic.GetString(), false, false, false, authToken});
         }
 
         auto nonce = generateUuid();
@@ -100,6 +212,22 @@ namespace detail {
             }
         }
 
+        this->unlisten(topics);
+    }
+
+    std::vector<Listener> PubSubClient::takeListeners()
+    {
+        auto listeners = std::move(this->listeners_);
+        this->listeners_.clear();
+
+        DebugCount::decrease("PubSub topic listening", this->numListens_);
+        this->numListens_ = 0;
+
+        return listeners;
+    }
+
+    void PubSubClient::unlisten(const std::vector<QString> &topics)
+    {
         if (topics.empty())
         {
             return;
@@ -142,6 +270,26 @@ namespace detail {
         return false;
     }
 
+    int PubSubClient::numListens() const
+    {
+        return this->numListens_;
+    }
+
+    void PubSubClient::close()
+    {
+        this->closing_ = true;
+
+        WebsocketErrorCode ec;
+        this->websocketClient_.close(this->handle_,
+                                     websocketpp::close::status::going_away,
+                                     "", ec);
+        if (ec)
+        {
+            qCDebug(chatterinoPubsub)
+                << "Error closing connection:" << ec.message().c_str();
+        }
+    }
+
     void PubSubClient::ping()
     {
         assert(this->started_);
@@ -865,6 +1013,8 @@ PubSub::PubSub()
         bind(&PubSub::onConnectionOpen, this, ::_1));
     this->websocketClient.set_close_handler(
         bind(&PubSub::onConnectionClose, this, ::_1));
+    this->websocketClient.set_fail_handler(
+        bind(&PubSub::onConnectionFail, this, ::_1));
 
     // Add an initial client
     this->addClient();
@@ -886,16 +1036,84 @@ void PubSub::addClient()
     {
         qCDebug(chatterinoPubsub)
             << "Unable to establish connection:" << ec.message().c_str();
+        this->addingClient = false;
         return;
     }
 
     this->websocketClient.connect(con);
 }
 
+void PubSub::scheduleAddClient()
+{
+    runAfter(this->websocketClient.get_io_service(),
+             this->connectBackoff.next(), [this](auto timer) {
+                 this->addClient();
+             });
+}
+
+void PubSub::relisten(const std::vector<detail::Listener> &listeners)
+{
+    for (const auto &listener : listeners)
+    {
+        auto message =
+            createListenMessage({listener.topic}, listener.authToken);
+        if (this->tryListen(message))
+        {
+            continue;
+        }
+
+        this->requests.emplace_back(
+            std::make_unique<rapidjson::Document>(std::move(message)));
+        DebugCount::increase("PubSub topic backlog");
+    }
+}
+
+void PubSub::rebalance()
+{
+    std::vector<std::shared_ptr<detail::PubSubClient>> clients;
+    int freeListens = 0;
+    for (const auto &p : this->clients)
+    {
+        if (p.second->canListen(0))
+        {
+            clients.push_back(p.second);
+            freeListens += MAX_PUBSUB_LISTENS - p.second->numListens();
+        }
+    }
+
+    std::sort(clients.begin(), clients.end(), [](const auto &a, const auto &b) {
+        return a->numListens() < b->numListens();
+    });
+
+    // emptiest first, as long as the others have room for its topics
+    for (const auto &client : clients)
+    {
+        auto count = client->numListens();
+        auto freeElsewhere = freeListens - (MAX_PUBSUB_LISTENS - count);
+        if (freeElsewhere < count)
+        {
+            break;
+        }
+
+        auto listeners = client->takeListeners();
+        client->close();
+        this->relisten(listeners);
+
+        freeListens = freeElsewhere - count;
+        DebugCount::increase("PubSub rebalanced topics", count);
+    }
+}
+
 void PubSub::start()
 {
     this->mainThread.reset(
         new std::thread(std::bind(&PubSub::runThread, this)));
+
+    this->processingWork = std::make_unique<boost::asio::io_service::work>(
+        this->processingService);
+    this->processingThread = std::make_unique<std::thread>([this] {
+        this->processingService.run();
+    });
 }
 
 void PubSub::listenToWhispers(std::shared_ptr<TwitchAccount> account)
@@ -929,6 +1147,8 @@ void PubSub::unlistenAllModerationActions()
         const auto &client = p.second;
         client->unlistenPrefix("chat_moderator_actions.");
     }
+
+    this->rebalance();
 }
 
 void PubSub::listenToChannelModerationActions(
@@ -1018,16 +1238,22 @@ void PubSub::listen(rapidjson::Document &&msg)
 
 bool PubSub::tryListen(rapidjson::Document &msg)
 {
+    int topicCount = msg["data"]["topics"].Size();
+
+    // the fullest connection that has room, so topics are packed into as few
+    // connections as possible
+    detail::PubSubClient *best = nullptr;
     for (const auto &p : this->clients)
     {
         const auto &client = p.second;
-        if (client->listen(msg))
+        if (client->canListen(topicCount) &&
+            (best == nullptr || client->numListens() > best->numListens()))
         {
-            return true;
+            best = client.get();
         }
     }
 
-    return false;
+    return best != nullptr && best->listen(msg);
 }
 
 bool PubSub::isListeningToTopic(const QString &topic)
@@ -1047,53 +1273,82 @@ bool PubSub::isListeningToTopic(const QString &topic)
 void PubSub::onMessage(websocketpp::connection_hdl hdl,
                        WebsocketMessagePtr websocketMessage)
 {
-    const auto &payload =
-        QString::fromStdString(websocketMessage->get_payload());
+    queuedMessages.increase();
+    payloadBytes.increase(int64_t(websocketMessage->get_payload().size()));
+
+    this->processingService.post(
+        [this, hdl, websocketMessage, received = Clock::now()] {
+            queuedMessages.decrease();
+            this->processMessage(hdl, websocketMessage->get_payload(),
+                                 received);
+        });
+}
 
-    rapidjson::Document msg;
+void PubSub::addFakeMessage(const std::string &payload)
+{
+    queuedMessages.increase();
 
-    rapidjson::ParseResult res = msg.Parse(payload.toUtf8());
+    this->processingService.post([this, payload, received = Clock::now()] {
+        queuedMessages.decrease();
+        this->processMessage({}, payload, received);
+    });
+}
+
+void PubSub::processMessage(websocketpp::connection_hdl hdl,
+                            const std::string &payload,
+                            std::chrono::steady_clock::time_point received)
+{
+    CHATTERINO_TRACE_SCOPE("PubSub::processMessage");
+
+    auto msg = std::make_shared<rapidjson::Document>();
+
+    rapidjson::ParseResult res = msg->Parse(payload.data(), payload.size());
 
     if (!res)
     {
         qCDebug(chatterinoPubsub)
             << QString("Error parsing message '%1' from PubSub: %2")
-                   .arg(payload, rapidjson::GetParseError_En(res.Code()));
+                   .arg(QString::fromStdString(payload),
+                        rapidjson::GetParseError_En(res.Code()));
         return;
     }
 
-    if (!msg.IsObject())
+    if (!msg->IsObject())
     {
         qCDebug(chatterinoPubsub)
             << QString("Error parsing message '%1' from PubSub. Root object is "
                        "not an object")
-                   .arg(payload);
+                   .arg(QString::fromStdString(payload));
         return;
     }
 
     QString type;
 
-    if (!rj::getSafe(msg, "type", type))
+    if (!rj::getSafe(*msg, "type", type))
     {
         qCDebug(chatterinoPubsub)
             << "Missing required string member `type` in message root";
         return;
     }
 
+    // responses and pongs belong to the connections, which are only touched
+    // on the websocket thread
     if (type == "RESPONSE")
     {
-        this->handleResponse(msg);
+        this->websocketClient.get_io_service().post([this, msg] {
+            this->handleResponse(*msg);
+        });
     }
     else if (type == "MESSAGE")
     {
-        if (!msg.HasMember("data"))
+        if (!msg->HasMember("data"))
         {
             qCDebug(chatterinoPubsub)
                 << "Missing required object member `data` in message root";
             return;
         }
 
-        const auto &data = msg["data"];
+        const auto &data = (*msg)["data"];
 
         if (!data.IsObject())
         {
@@ -1101,19 +1356,21 @@ void PubSub::onMessage(websocketpp::connection_hdl hdl,
             return;
         }
 
-        this->handleMessageResponse(data);
+        this->handleMessageResponse(data, received);
     }
     else if (type == "PONG")
     {
-        auto clientIt = this->clients.find(hdl);
+        this->websocketClient.get_io_service().post([this, hdl] {
+            auto clientIt = this->clients.find(hdl);
 
-        // If this assert goes off, there's something wrong with the connection
-        // creation/preserving code KKona
-        assert(clientIt != this->clients.end());
-
-        auto &client = *clientIt;
+            // the connection can close while the pong waits to be handled
+            if (clientIt == this->clients.end())
+            {
+                return;
+            }
 
-        client.second->handlePong();
+            clientIt->second->handlePong();
+        });
     }
     else
     {
@@ -1124,7 +1381,12 @@ void PubSub::onMessage(websocketpp::connection_hdl hdl,
 void PubSub::onConnectionOpen(WebsocketHandle hdl)
 {
     DebugCount::increase("PubSub connections");
+    if (isCompressed(this->websocketClient, hdl))
+    {
+        DebugCount::increase("PubSub compressed connections");
+    }
     this->addingClient = false;
+    this->connectBackoff.reset();
 
     auto client =
         std::make_shared<detail::PubSubClient>(this->websocketClient, hdl);
@@ -1160,6 +1422,10 @@ void PubSub::onConnectionOpen(WebsocketHandle hdl)
 void PubSub::onConnectionClose(WebsocketHandle hdl)
 {
     DebugCount::decrease("PubSub connections");
+    if (isCompressed(this->websocketClient, hdl))
+    {
+        DebugCount::decrease("PubSub compressed connections");
+    }
     auto clientIt = this->clients.find(hdl);
 
     // If this assert goes off, there's something wrong with the connection
@@ -1169,12 +1435,37 @@ void PubSub::onConnectionClose(WebsocketHandle hdl)
     auto &client = clientIt->second;
 
     client->stop();
+    auto listeners = client->takeListeners();
 
     this->clients.erase(clientIt);
 
+    // topics of connections that dropped are listened to again, those of
+    // connections closed by a rebalance were already moved
+    if (!listeners.empty())
+    {
+        DebugCount::increase("PubSub reconnects");
+        this->relisten(listeners);
+    }
+
+    if (!this->requests.empty())
+    {
+        this->scheduleAddClient();
+    }
+
     this->connected.invoke();
 }
 
+void PubSub::onConnectionFail(WebsocketHandle hdl)
+{
+    DebugCount::increase("PubSub failed connections");
+    this->addingClient = false;
+
+    if (!this->requests.empty())
+    {
+        this->scheduleAddClient();
+    }
+}
+
 PubSub::WebsocketContextPtr PubSub::onTLSInit(websocketpp::connection_hdl hdl)
 {
     WebsocketContextPtr ctx(
@@ -1255,7 +1546,9 @@ void PubSub::handleUnlistenResponse(const RequestMessage &msg, bool failed)
     }
 }
 
-void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
+void PubSub::handleMessageResponse(
+    const rapidjson::Value &outerData,
+    std::chrono::steady_clock::time_point received)
 {
     QString topic;
     qCDebug(chatterinoPubsub) << rj::stringify(outerData);
@@ -1267,6 +1560,9 @@ void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
         return;
     }
 
+    const auto &topicType = findTopicType(topic);
+    TopicStats stats(topicType, received);
+
     QString payload;
 
     if (!rj::getSafe(outerData, "message", payload))
@@ -1287,7 +1583,7 @@ void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
         return;
     }
 
-    if (topic.startsWith("whispers."))
+    if (topicType.kind == TopicKind::Whispers)
     {
         QString whisperType;
 
@@ -1315,7 +1611,7 @@ void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
             return;
         }
     }
-    else if (topic.startsWith("chat_moderator_actions."))
+    else if (topicType.kind == TopicKind::ModeratorActions)
     {
         auto topicParts = topic.split(".");
         assert(topicParts.length() == 3);
@@ -1379,7 +1675,7 @@ void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
             handlerIt->second(data, topicParts[2]);
         }
     }
-    else if (topic.startsWith("community-points-channel-v1."))
+    else if (topicType.kind == TopicKind::PointRewards)
     {
         QString pointEventType;
         if (!rj::getSafe(msg, "type", pointEventType))
@@ -1410,7 +1706,7 @@ void PubSub::handleMessageResponse(const rapidjson::Value &outerData)
                 << "Invalid point event type:" << pointEventType;
         }
     }
-    else if (topic.startsWith("automod-queue."))
+    else if (topicType.kind == TopicKind::Automod)
     {
         auto topicParts = topic.split(".");
         assert(topicParts.length() == 3);
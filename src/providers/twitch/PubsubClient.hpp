@@ -4,13 +4,18 @@
 #include "providers/twitch/PubsubActions.hpp"
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
+#include "util/ExponentialBackoff.hpp"
 
 #include <rapidjson/document.h>
 #include <QString>
 #include <pajlada/signals/signal.hpp>
 #include <websocketpp/client.hpp>
 #include <websocketpp/config/asio_client.hpp>
-#include <websocketpp/extensions/permessage_deflate/disabled.hpp>
+#ifdef CHATTERINO_PUBSUB_DEFLATE
+#    include <websocketpp/extensions/permessage_deflate/enabled.hpp>
+#else
+#    include <websocketpp/extensions/permessage_deflate/disabled.hpp>
+#endif
 #include <websocketpp/logger/basic.hpp>
 
 #include <atomic>
@@ -32,12 +37,34 @@ struct chatterinoconfig : public websocketpp::config::asio_tls_client {
         concurrency_type, websocketpp::log::alevel>
         alog_type;
 
+#ifdef CHATTERINO_PUBSUB_DEFLATE
+    // Compression is offered to the server; if the server doesn't accept
+    // it, frames stay uncompressed. Moderation topics send many small,
+    // similar frames, so keeping the context between messages is what
+    // makes it pay off.
+    struct permessage_deflate_config {
+        typedef asio_tls_client::request_type request_type;
+
+        // lets the server reset the context after every message to save
+        // memory on its side, which costs compression
+        static const bool allow_disabling_context_takeover = true;
+        // smallest LZ77 window the server may make us use for our frames,
+        // 8 to 15. Smaller windows take less memory on each connection and
+        // compress worse.
+        static const uint8_t minimum_outgoing_window_bits = 8;
+    };
+
+    typedef websocketpp::extensions::permessage_deflate::enabled<
+        permessage_deflate_config>
+        permessage_deflate_type;
+#else
     struct permessage_deflate_config {
     };
 
     typedef websocketpp::extensions::permessage_deflate::disabled<
         permessage_deflate_config>
         permessage_deflate_type;
+#endif
 };
 
 using WebsocketClient = websocketpp::client<chatterinoconfig>;
@@ -59,6 +86,8 @@ namespace detail {
         bool authed;
         bool persistent;
         bool confirmed = false;
+        // sent again when the topic moves to another connection
+        QString authToken;
     };
 
     class PubSubClient : public std::enable_shared_from_this<PubSubClient>
@@ -70,16 +99,24 @@ namespace detail {
         void start();
         void stop();
 
+        bool canListen(int topicCount) const;
         bool listen(rapidjson::Document &message);
         void unlistenPrefix(const QString &prefix);
+        // Unlistens all topics and returns them, so they can be listened to
+        // on another connection
+        std::vector<Listener> takeListeners();
 
         void handlePong();
 
         bool isListeningToTopic(const QString &topic);
+        int numListens() const;
+
+        void close();
 
     private:
         void ping();
         bool send(const char *payload);
+        void unlisten(const std::vector<QString> &topics);
 
         WebsocketClient &websocketClient_;
         WebsocketHandle handle_;
@@ -89,6 +126,8 @@ namespace detail {
 
         std::atomic<bool> awaitingPong_{false};
         std::atomic<bool> started_{false};
+        // closed by a rebalance, doesn't take new topics
+        std::atomic<bool> closing_{false};
     };
 
 }  // namespace detail
@@ -107,6 +146,13 @@ class PubSub
     WebsocketClient websocketClient;
     std::unique_ptr<std::thread> mainThread;
 
+    // Messages are parsed and handled on their own thread, so the websocket
+    // thread only does I/O. It's a single thread so the messages of a topic
+    // are still handled in order.
+    boost::asio::io_service processingService;
+    std::unique_ptr<boost::asio::io_service::work> processingWork;
+    std::unique_ptr<std::thread> processingThread;
+
 public:
     PubSub();
 
@@ -167,6 +213,9 @@ public:
 
     std::vector<std::unique_ptr<rapidjson::Document>> requests;
 
+    /// Handles payload as if it was received from one of the connections
+    void addFakeMessage(const std::string &payload);
+
 private:
     void listenToTopic(const QString &topic,
                        std::shared_ptr<TwitchAccount> account);
@@ -178,6 +227,17 @@ private:
 
     void addClient();
     std::atomic<bool> addingClient{false};
+    // Connections are opened one at a time. Failed attempts and
+    // reconnects wait longer each time, so connections that drop together
+    // don't all reconnect at once.
+    ExponentialBackoff<5> connectBackoff{std::chrono::milliseconds(1000)};
+    void scheduleAddClient();
+
+    // Listens to the topics on the other connections, or on new ones
+    void relisten(const std::vector<detail::Listener> &listeners);
+    // Moves the topics of the emptiest connections into the others and
+    // closes the ones that end up empty
+    void rebalance();
 
     State state = State::Connected;
 
@@ -194,14 +254,19 @@ private:
         channelTermsActionHandlers;
 
     void onMessage(websocketpp::connection_hdl hdl, WebsocketMessagePtr msg);
+    void processMessage(websocketpp::connection_hdl hdl,
+                        const std::string &payload,
+                        std::chrono::steady_clock::time_point received);
     void onConnectionOpen(websocketpp::connection_hdl hdl);
     void onConnectionClose(websocketpp::connection_hdl hdl);
+    void onConnectionFail(websocketpp::connection_hdl hdl);
     WebsocketContextPtr onTLSInit(websocketpp::connection_hdl hdl);
 
     void handleResponse(const rapidjson::Document &msg);
     void handleListenResponse(const RequestMessage &msg, bool failed);
     void handleUnlistenResponse(const RequestMessage &msg, bool failed);
-    void handleMessageResponse(const rapidjson::Value &data);
+    void handleMessageResponse(const rapidjson::Value &data,
+                               std::chrono::steady_clock::time_point received);
 
     void runThread();
 };
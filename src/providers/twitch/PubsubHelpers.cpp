@@ -53,6 +53,13 @@ bool getTargetUserName(const rapidjson::Value &data, ActionUser &user)
 
 rapidjson::Document createListenMessage(const std::vector<QString> &topicsVec,
                                         std::shared_ptr<TwitchAccount> account)
+{
+    return createListenMessage(topicsVec,
+                               account ? account->getOAuthToken() : QString());
+}
+
+rapidjson::Document createListenMessage(const std::vector<QString> &topicsVec,
+                                        const QString &authToken)
 {
     rapidjson::Document msg(rapidjson::kObjectType);
     auto &a = msg.GetAllocator();
@@ -61,9 +68,9 @@ rapidjson::Document createListenMessage(const std::vector<QString> &topicsVec,
 
     rapidjson::Value data(rapidjson::kObjectType);
 
-    if (account)
+    if (!authToken.isEmpty())
     {
-        rj::set(data, "auth_token", account->getOAuthToken(), a);
+        rj::set(data, "auth_token", authToken, a);
     }
 
     rapidjson::Value topics(rapidjson::kArrayType);
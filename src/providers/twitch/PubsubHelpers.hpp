@@ -21,6 +21,9 @@ bool getTargetUserName(const rapidjson::Value &data, ActionUser &user);
 
 rapidjson::Document createListenMessage(const std::vector<QString> &topicsVec,
                                         std::shared_ptr<TwitchAccount> account);
+// Topics without auth are listened to with an empty authToken
+rapidjson::Document createListenMessage(const std::vector<QString> &topicsVec,
+                                        const QString &authToken);
 rapidjson::Document createUnlistenMessage(
     const std::vector<QString> &topicsVec);
 
@@ -0,0 +1,346 @@
+#include "providers/twitch/SyntheticLoad.hpp"
+
+#include "Application.hpp"
+#include "controllers/accounts/AccountController.hpp"
+#include "providers/twitch/TwitchAccount.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+
+#include <algorithm>
+#include <map>
+#include <random>
+#include <utility>
+
+namespace chatterino {
+
+namespace {
+
+    struct TwitchEmote {
+        const char *name;
+        const char *id;
+    };
+
+    // global emotes, so they're found in every channel
+    const TwitchEmote EMOTES[] = {
+        {"Kappa", "25"},     {"Kreygasm", "41"}, {"BibleThump", "86"},
+        {"PogChamp", "88"},  {"Keepo", "1902"},  {"LUL", "425618"},
+    };
+
+    const char *const WORDS[] = {
+        "hype", "lets",  "go",   "this", "is",   "insane", "what",
+        "a",    "play",  "gg",   "no",   "way",  "clip",   "it",
+        "chat", "so",    "good", "wow",  "huge", "again",  "ez",
+    };
+
+    const char *const COLORS[] = {
+        "#FF0000", "#0000FF", "#008000", "#B22222", "#FF7F50",
+        "#9ACD32", "#FF4500", "#2E8B57", "#DAA520", "#1E90FF",
+    };
+
+    const char *const BADGES[] = {
+        "", "subscriber/0", "subscriber/12", "moderator/1", "vip/1",
+        "premium/1",
+    };
+
+    // messages are written by this many different users
+    constexpr int USER_COUNT = 1000;
+
+    template <typename T, size_t N>
+    const T &pick(std::mt19937 &random, const T (&items)[N])
+    {
+        return items[random() % N];
+    }
+
+    struct Generator {
+        const SyntheticLoad &load;
+        const QString &highlightName;
+        std::mt19937 random;
+        std::uniform_real_distribution<double> chance{0, 1};
+        const qint64 startMs = QDateTime::currentMSecsSinceEpoch();
+        size_t number = 0;
+
+        bool happens(double share)
+        {
+            return share > 0 && this->chance(this->random) < share;
+        }
+
+        QByteArray makeMessage(const SyntheticLoadChannel &channel,
+                               int user, qint64 dueUs)
+        {
+            auto login = QString("loaduser%1").arg(user);
+
+            QString text;
+            std::map<QString, QStringList> emotes;
+            auto append = [&](const QString &word) {
+                if (!text.isEmpty())
+                {
+                    text += ' ';
+                }
+                text += word;
+            };
+            auto appendEmote = [&] {
+                const auto &emote = pick(this->random, EMOTES);
+                auto start = text.isEmpty() ? 0 : text.size() + 1;
+                append(emote.name);
+                emotes[emote.id].append(
+                    QString("%1-%2").arg(start).arg(text.size() - 1));
+            };
+
+            auto cheer = this->happens(this->load.cheers);
+            if (cheer)
+            {
+                append("Cheer100");
+            }
+
+            auto withEmotes = this->happens(this->load.emotes);
+            auto wordCount = 3 + int(this->random() % 10);
+            for (int i = 0; i < wordCount; i++)
+            {
+                if (withEmotes && this->random() % 3 == 0)
+                {
+                    appendEmote();
+                }
+                else
+                {
+                    append(pick(this->random, WORDS));
+                }
+            }
+            if (withEmotes && emotes.empty())
+            {
+                appendEmote();
+            }
+
+            if (this->happens(this->load.links))
+            {
+                append(QString("https://chatterino.com/load/%1")
+                           .arg(this->number));
+            }
+            if (this->happens(this->load.highlights) &&
+                !this->highlightName.isEmpty())
+            {
+                append("@" + this->highlightName);
+            }
+
+            QStringList emotesTag;
+            for (const auto &[id, ranges] : emotes)
+            {
+                emotesTag.append(id + ":" + ranges.join(','));
+            }
+
+            // ids only have to be unique
+            auto id = QString("00000000-0000-4000-8000-%1")
+                          .arg(this->number++, 12, 10, QChar('0'));
+
+            QString line = "@badge-info=;badges=" +
+                           QString(pick(this->random, BADGES)) +
+                           (cheer ? ";bits=100" : "") +
+                           ";color=" + pick(this->random, COLORS) +
+                           ";display-name=" + login +
+                           ";emotes=" + emotesTag.join('/') +
+                           ";flags=;id=" + id + ";mod=0;room-id=" +
+                           channel.roomId + ";subscriber=0;tmi-sent-ts=" +
+                           QString::number(this->sentMs(dueUs)) +
+                           ";turbo=0;user-id=" + userId(user) +
+                           ";user-type= :" + login + "!" + login + "@" +
+                           login + ".tmi.twitch.tv PRIVMSG #" + channel.name +
+                           " :" + text;
+            return line.toUtf8();
+        }
+
+        QByteArray makeTimeout(const SyntheticLoadChannel &channel, int user,
+                               qint64 dueUs)
+        {
+            QString line = "@ban-duration=10;room-id=" + channel.roomId +
+                           ";target-user-id=" + userId(user) +
+                           ";tmi-sent-ts=" +
+                           QString::number(this->sentMs(dueUs)) +
+                           " :tmi.twitch.tv CLEARCHAT #" + channel.name +
+                           " :" + QString("loaduser%1").arg(user);
+            return line.toUtf8();
+        }
+
+        // a timeout by a moderator, as it's sent on the moderation topic
+        QByteArray makePubSubTimeout(const SyntheticLoadChannel &channel,
+                                     int user)
+        {
+            QJsonObject data{
+                {"type", "chat_login_moderation"},
+                {"moderation_action", "timeout"},
+                {"args",
+                 QJsonArray{QString("loaduser%1").arg(user), "10",
+                            "synthetic load"}},
+                {"created_by", "loadmod"},
+                {"created_by_user_id", "1"},
+                {"target_user_id", userId(user)},
+                {"target_user_login", QString("loaduser%1").arg(user)},
+            };
+            QJsonObject message{
+                {"type", "moderation_action"},
+                {"data", data},
+            };
+            QJsonObject root{
+                {"type", "MESSAGE"},
+                {"data",
+                 QJsonObject{
+                     {"topic",
+                      "chat_moderator_actions.1." + channel.roomId},
+                     {"message", QString::fromUtf8(
+                                     QJsonDocument(message).toJson(
+                                         QJsonDocument::Compact))},
+                 }},
+            };
+            return QJsonDocument(root).toJson(QJsonDocument::Compact);
+        }
+
+        qint64 sentMs(qint64 dueUs) const
+        {
+            return this->startMs + dueUs / 1000;
+        }
+
+        static QString userId(int user)
+        {
+            return QString::number(900000000 + user);
+        }
+    };
+
+    // name and member of the shares that can be set
+    const std::pair<const char *, double SyntheticLoad::*> SHARES[] = {
+        {"emotes", &SyntheticLoad::emotes},
+        {"links", &SyntheticLoad::links},
+        {"cheers", &SyntheticLoad::cheers},
+        {"highlights", &SyntheticLoad::highlights},
+        {"timeouts", &SyntheticLoad::timeouts},
+        {"pubsub", &SyntheticLoad::pubsub},
+    };
+
+}  // namespace
+
+QString SyntheticLoad::parse(const QStringList &options)
+{
+    for (const auto &option : options)
+    {
+        auto parts = option.split('=');
+        bool ok = false;
+        auto value = parts.size() == 2 ? parts[1].toDouble(&ok) : 0.0;
+        if (!ok || value < 0)
+        {
+            return QString("Invalid option %1, use for example rate=500 or "
+                           "emotes=0.5")
+                .arg(option);
+        }
+
+        const auto &key = parts[0];
+        if (key == "rate" && value > 0)
+        {
+            this->messagesPerSecond = value;
+            continue;
+        }
+        if (key == "seconds" && value > 0)
+        {
+            this->seconds = value;
+            continue;
+        }
+        if (key == "seed")
+        {
+            this->seed = uint32_t(value);
+            continue;
+        }
+
+        auto share = std::find_if(std::begin(SHARES), std::end(SHARES),
+                                  [&](const auto &share) {
+                                      return key == share.first;
+                                  });
+        if (share == std::end(SHARES) || value > 1)
+        {
+            return QString("Invalid option %1, known options are rate, "
+                           "seconds, seed and the shares emotes, links, "
+                           "cheers, highlights, timeouts and pubsub "
+                           "between 0 and 1")
+                .arg(option);
+        }
+        this->*(share->second) = value;
+    }
+
+    return "";
+}
+
+std::vector<IrcReplay::Line> generateSyntheticLoad(
+    const SyntheticLoad &load,
+    const std::vector<SyntheticLoadChannel> &channels,
+    const QString &highlightName)
+{
+    std::vector<IrcReplay::Line> lines;
+    if (channels.empty() || load.messagesPerSecond <= 0)
+    {
+        return lines;
+    }
+
+    Generator generator{load, highlightName, std::mt19937(load.seed)};
+
+    auto perChannel = size_t(load.messagesPerSecond * load.seconds);
+    lines.reserve(
+        std::min(perChannel * channels.size(), SyntheticLoad::maxLines));
+
+    // the channels take turns, so the lines are sorted by when they're due
+    for (size_t i = 0; i < perChannel; i++)
+    {
+        auto dueUs = qint64(double(i) * 1000000 / load.messagesPerSecond);
+
+        for (const auto &channel : channels)
+        {
+            if (lines.size() >= SyntheticLoad::maxLines)
+            {
+                return lines;
+            }
+
+            auto user = int(generator.random() % USER_COUNT);
+            lines.push_back(
+                {generator.makeMessage(channel, user, dueUs), dueUs});
+
+            if (generator.happens(load.timeouts))
+            {
+                lines.push_back(
+                    {generator.makeTimeout(channel, user, dueUs), dueUs});
+            }
+            if (generator.happens(load.pubsub))
+            {
+                lines.push_back(
+                    {generator.makePubSubTimeout(channel, user), dueUs, true});
+            }
+        }
+    }
+
+    return lines;
+}
+
+QString startSyntheticLoad(const SyntheticLoad &load,
+                           const std::vector<ChannelPtr> &channels,
+                           IrcReplay::FinishedCallback finished)
+{
+    std::vector<SyntheticLoadChannel> targets;
+    for (const auto &channel : channels)
+    {
+        auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
+        if (twitchChannel != nullptr && !twitchChannel->roomId().isEmpty())
+        {
+            targets.push_back(
+                {twitchChannel->getName(), twitchChannel->roomId()});
+        }
+    }
+
+    if (targets.empty())
+    {
+        return "There are no joined Twitch channels to generate load for";
+    }
+
+    auto lines = generateSyntheticLoad(
+        load, targets,
+        getApp()->accounts->twitch.getCurrent()->getUserName());
+    return IrcReplay::instance().start(std::move(lines), std::move(finished));
+}
+
+}  // namespace chatterino
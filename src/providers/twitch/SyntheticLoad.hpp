@@ -0,0 +1,65 @@
+#pragma once
+
+#include "providers/twitch/IrcReplay.hpp"
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+namespace chatterino {
+
+class Channel;
+using ChannelPtr = std::shared_ptr<Channel>;
+
+/**
+ * @brief Made up chat traffic, to see how a machine and a layout hold up under
+ *        the load of a big event before it happens.
+ *
+ * Every channel gets messagesPerSecond messages. The shares are chances per
+ * message, a message can have emotes, a link, a cheer and a mention of the
+ * user at once. Timeouts and PubSub timeouts hit the author of the message
+ * they follow.
+ */
+struct SyntheticLoad {
+    static constexpr size_t maxLines = 1000000;
+
+    double messagesPerSecond = 100;
+    double seconds = 60;
+
+    double emotes = 0.5;
+    double links = 0.05;
+    double cheers = 0.02;
+    double highlights = 0.01;
+    double timeouts = 0.01;
+    double pubsub = 0.005;
+
+    uint32_t seed = 1;
+
+    /// Applies options like "rate=500 seconds=30 emotes=0.8", returns an
+    /// error message if one of them isn't known or out of range
+    QString parse(const QStringList &options);
+};
+
+struct SyntheticLoadChannel {
+    QString name;
+    QString roomId;
+};
+
+/// Generates the lines of load for channels, sorted by when they're due.
+/// highlightName is mentioned by the messages that highlight, at most
+/// SyntheticLoad::maxLines are generated.
+std::vector<IrcReplay::Line> generateSyntheticLoad(
+    const SyntheticLoad &load,
+    const std::vector<SyntheticLoadChannel> &channels,
+    const QString &highlightName);
+
+/// Replays load into the Twitch channels among channels, mentioning the
+/// current user. Returns an error message if it couldn't be started.
+QString startSyntheticLoad(const SyntheticLoad &load,
+                           const std::vector<ChannelPtr> &channels,
+                           IrcReplay::FinishedCallback finished);
+
+}  // namespace chatterino
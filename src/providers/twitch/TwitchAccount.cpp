@@ -5,6 +5,7 @@
 #include "Application.hpp"
 #include "common/Channel.hpp"
 #include "common/Env.hpp"
+#include "common/NetworkCache.hpp"
 #include "common/NetworkRequest.hpp"
 #include "common/Outcome.hpp"
 #include "common/QLogging.hpp"
@@ -17,17 +18,68 @@
 #include "providers/twitch/TwitchUser.hpp"
 #include "providers/twitch/api/Helix.hpp"
 #include "singletons/Emotes.hpp"
+#include "util/PostToThread.hpp"
 #include "util/QStringHash.hpp"
 #include "util/RapidjsonHelpers.hpp"
 
+#include <QDateTime>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QtConcurrent>
+
+#include <algorithm>
+#include <chrono>
+#include <iterator>
+#include <unordered_set>
+
 namespace chatterino {
 
+namespace {
+    // the contents of emote sets hardly ever change, they're taken from the
+    // cache for this long before IVR is asked again
+    constexpr std::chrono::seconds EMOTE_SET_TTL = std::chrono::hours(24);
+
+    QString emoteSetCacheKey(const QString &setId)
+    {
+        return "ivr-emote-set-" + setId;
+    }
+
+    // blocks of accounts that were switched away from stay valid this long
+    constexpr qint64 BLOCKS_TTL_MS = 10 * 60 * 1000;
+
+    // the blocks loaded at the last start, in the format of Helix
+    QString blocksCacheKey(const QString &userId)
+    {
+        return "helix-blocks-" + userId;
+    }
+
+    QByteArray serializeBlocks(const std::set<TwitchUser> &users)
+    {
+        QJsonArray array;
+        for (const auto &user : users)
+        {
+            array.append(QJsonObject{
+                {"user_id", user.id},
+                {"user_login", user.name},
+                {"display_name", user.displayName},
+            });
+        }
+        return QJsonDocument(array).toJson(QJsonDocument::Compact);
+    }
+}  // namespace
+
+// the blocks of a load from Helix, pages are added as they arrive
+struct TwitchAccount::BlocksLoad {
+    std::set<TwitchUser> users;
+    bool pageArrived = false;
+};
+
 std::vector<QStringList> getEmoteSetBatches(QStringList emoteSetKeys)
 {
     // splitting emoteSetKeys to batches of 100, because Ivr API endpoint accepts a maximum of 100 emotesets at once
     constexpr int batchSize = 100;
 
-    int batchCount = (emoteSetKeys.size() / batchSize) + 1;
+    int batchCount = (emoteSetKeys.size() + batchSize - 1) / batchSize;
 
     std::vector<QStringList> batches;
     batches.reserve(batchCount);
@@ -124,24 +176,100 @@ bool TwitchAccount::isAnon() const
 
 void TwitchAccount::loadBlocks()
 {
+    if (this->isAnon_ || (this->blocksLoaded_.isValid() &&
+                          !this->blocksLoaded_.hasExpired(BLOCKS_TTL_MS)))
+    {
+        return;
+    }
+
+    if (this->blocksLoad_)
+    {
+        // still loading
+        return;
+    }
+
+    auto load = std::make_shared<BlocksLoad>();
+    auto firstLoad = !this->blocksLoaded_.isValid();
+    this->blocksLoad_ = load;
+
+    if (firstLoad)
+    {
+        // the blocks of the last start apply until Helix sent the first page
+        QtConcurrent::run([this, load, key = blocksCacheKey(this->userId_)] {
+            auto entry = NetworkCache::instance().get(key);
+            if (!entry)
+            {
+                return;
+            }
+
+            std::vector<TwitchUser> users;
+            auto array = QJsonDocument::fromJson(entry->body).array();
+            for (const auto &value : array)
+            {
+                users.emplace_back();
+                users.back().fromHelixBlock(HelixBlock(value.toObject()));
+            }
+
+            postToThread([this, load, users = std::move(users)] {
+                if (this->blocksLoad_ != load || load->pageArrived)
+                {
+                    return;
+                }
+
+                auto ignores = this->ignores_.access();
+                ignores->insert(users.begin(), users.end());
+                this->publishBlockedUserIds(*ignores);
+            });
+        });
+    }
+
     getHelix()->loadBlocks(
-        getApp()->accounts->twitch.getCurrent()->userId_,
-        [this](std::vector<HelixBlock> blocks) {
-            auto ignores = this->ignores_.access();
-            auto userIds = this->ignoresUserIds_.access();
-            ignores->clear();
-            userIds->clear();
+        this->userId_,
+        [this, load](std::vector<HelixBlock> blocks) {
+            if (this->blocksLoad_ != load)
+            {
+                return;
+            }
+            load->pageArrived = true;
 
+            // every page takes effect right away, users that were unblocked
+            // are only dropped once the last page arrived
+            auto ignores = this->ignores_.access();
             for (const HelixBlock &block : blocks)
             {
                 TwitchUser blockedUser;
                 blockedUser.fromHelixBlock(block);
+                load->users.insert(blockedUser);
                 ignores->insert(blockedUser);
-                userIds->insert(blockedUser.id);
             }
+            this->publishBlockedUserIds(*ignores);
         },
-        [] {
+        [this, load] {
+            if (this->blocksLoad_ != load)
+            {
+                return;
+            }
+            this->blocksLoad_.reset();
+            this->blocksLoaded_.start();
+
+            {
+                auto ignores = this->ignores_.access();
+                *ignores = load->users;
+                this->publishBlockedUserIds(*ignores);
+            }
+
+            QtConcurrent::run([key = blocksCacheKey(this->userId_), load] {
+                auto entry = std::make_shared<NetworkCacheEntry>();
+                entry->body = serializeBlocks(load->users);
+                NetworkCache::instance().put(key, std::move(entry));
+            });
+        },
+        [this, load] {
             qCWarning(chatterinoTwitch) << "Fetching blocks failed!";
+            if (this->blocksLoad_ == load)
+            {
+                this->blocksLoad_.reset();
+            }
         });
 }
 
@@ -155,10 +283,13 @@ void TwitchAccount::blockUser(QString userId, std::function<void()> onSuccess,
             blockedUser.id = userId;
             {
                 auto ignores = this->ignores_.access();
-                auto userIds = this->ignoresUserIds_.access();
 
                 ignores->insert(blockedUser);
-                userIds->insert(blockedUser.id);
+                this->publishBlockedUserIds(*ignores);
+            }
+            if (this->blocksLoad_)
+            {
+                this->blocksLoad_->users.insert(blockedUser);
             }
             onSuccess();
         },
@@ -175,10 +306,13 @@ void TwitchAccount::unblockUser(QString userId, std::function<void()> onSuccess,
             ignoredUser.id = userId;
             {
                 auto ignores = this->ignores_.access();
-                auto userIds = this->ignoresUserIds_.access();
 
                 ignores->erase(ignoredUser);
-                userIds->erase(ignoredUser.id);
+                this->publishBlockedUserIds(*ignores);
+            }
+            if (this->blocksLoad_)
+            {
+                this->blocksLoad_->users.erase(ignoredUser);
             }
             onSuccess();
         },
@@ -191,10 +325,34 @@ SharedAccessGuard<const std::set<TwitchUser>> TwitchAccount::accessBlocks()
     return this->ignores_.accessConst();
 }
 
-SharedAccessGuard<const std::set<QString>> TwitchAccount::accessBlockedUserIds()
-    const
+bool TwitchAccount::isBlocked(const QString &userId) const
+{
+    auto ids = this->blockedUserIds_.get();
+    if (!ids || ids->empty())
+    {
+        return false;
+    }
+
+    bool ok = false;
+    auto id = userId.toULongLong(&ok);
+    return ok && ids->count(id) != 0;
+}
+
+void TwitchAccount::publishBlockedUserIds(const std::set<TwitchUser> &ignores)
 {
-    return this->ignoresUserIds_.accessConst();
+    auto ids = std::make_shared<std::unordered_set<uint64_t>>();
+    ids->reserve(ignores.size());
+    for (const auto &user : ignores)
+    {
+        bool ok = false;
+        auto id = user.id.toULongLong(&ok);
+        if (ok)
+        {
+            ids->insert(id);
+        }
+    }
+
+    this->blockedUserIds_.set(std::move(ids));
 }
 
 void TwitchAccount::loadEmotes(std::weak_ptr<Channel> weakChannel)
@@ -209,14 +367,9 @@ void TwitchAccount::loadEmotes(std::weak_ptr<Channel> weakChannel)
         return;
     }
 
-    {
-        auto emoteData = this->emotes_.access();
-        emoteData->emoteSets.clear();
-        emoteData->emotes.clear();
-        qCDebug(chatterinoTwitch) << "Cleared emotes!";
-    }
-
-    this->loadUserstateEmotes(weakChannel);
+    // the loaded sets stay until the new ones are ready
+    this->loadEmoteSets(this->userstateEmoteSets_, true,
+                        std::move(weakChannel));
 }
 
 bool TwitchAccount::setUserstateEmoteSets(QStringList newEmoteSets)
@@ -241,23 +394,24 @@ void TwitchAccount::loadUserstateEmotes(std::weak_ptr<Channel> weakChannel)
         return;
     }
 
-    QStringList newEmoteSetKeys, existingEmoteSetKeys;
-
-    auto emoteData = this->emotes_.access();
-    auto userEmoteSets = emoteData->emoteSets;
-
-    // get list of already fetched emote sets
-    for (const auto &userEmoteSet : userEmoteSets)
+    QStringList newEmoteSetKeys;
     {
-        existingEmoteSetKeys.push_back(userEmoteSet->key);
-    }
+        auto emoteData = this->emotes_.accessConst();
 
-    // filter out emote sets from userstate message, which are not in fetched emote set list
-    for (const auto &emoteSetKey : qAsConst(this->userstateEmoteSets_))
-    {
-        if (!existingEmoteSetKeys.contains(emoteSetKey))
+        std::unordered_set<QString> existingEmoteSetKeys;
+        for (const auto &userEmoteSet : emoteData->emoteSets)
         {
-            newEmoteSetKeys.push_back(emoteSetKey);
+            existingEmoteSetKeys.insert(userEmoteSet->key);
+        }
+
+        // filter out emote sets from userstate message, which are not in
+        // fetched emote set list
+        for (const auto &emoteSetKey : qAsConst(this->userstateEmoteSets_))
+        {
+            if (existingEmoteSetKeys.count(emoteSetKey) == 0)
+            {
+                newEmoteSetKeys.push_back(emoteSetKey);
+            }
         }
     }
 
@@ -267,98 +421,236 @@ void TwitchAccount::loadUserstateEmotes(std::weak_ptr<Channel> weakChannel)
         return;
     }
 
-    // requesting emotes
-    auto batches = getEmoteSetBatches(newEmoteSetKeys);
-    for (int i = 0; i < batches.size(); i++)
+    this->loadEmoteSets(newEmoteSetKeys, false, std::move(weakChannel));
+}
+
+struct TwitchAccount::LoadedEmoteSet {
+    std::shared_ptr<EmoteSet> set;
+    // follower emotes can only be used in the channel of the set
+    QString channelId;
+    std::vector<std::pair<EmoteName, EmotePtr>> emotes;
+    std::vector<std::pair<EmoteName, EmotePtr>> localEmotes;
+};
+
+// sets loaded from the cache and the IVR batches that are still running
+struct TwitchAccount::EmoteSetLoad {
+    bool replace = false;
+    std::weak_ptr<Channel> weakChannel;
+
+    std::mutex mutex;
+    std::vector<LoadedEmoteSet> sets;
+    size_t pendingBatches = 0;
+};
+
+TwitchAccount::LoadedEmoteSet TwitchAccount::parseEmoteSet(
+    const QJsonObject &object)
+{
+    IvrEmoteSet ivrEmoteSet(object);
+
+    LoadedEmoteSet loaded;
+    loaded.set = std::make_shared<EmoteSet>();
+    loaded.set->key = ivrEmoteSet.setId;
+    loaded.set->channelName = ivrEmoteSet.login;
+    loaded.set->text = ivrEmoteSet.displayName;
+    loaded.channelId = ivrEmoteSet.channelId;
+
+    for (const auto &emoteObj : ivrEmoteSet.emotes)
     {
-        qCDebug(chatterinoTwitch)
-            << QString(
-                   "Loading %1 emotesets from IVR; batch %2/%3 (%4 sets): %5")
-                   .arg(newEmoteSetKeys.size())
-                   .arg(i + 1)
-                   .arg(batches.size())
-                   .arg(batches.at(i).size())
-                   .arg(batches.at(i).join(","));
-        getIvr()->getBulkEmoteSets(
-            batches.at(i).join(","),
-            [this, weakChannel](QJsonArray emoteSetArray) {
-                auto emoteData = this->emotes_.access();
-                auto localEmoteData = this->localEmotes_.access();
-                for (auto emoteSet_ : emoteSetArray)
-                {
-                    auto emoteSet = std::make_shared<EmoteSet>();
+        IvrEmote ivrEmote(emoteObj.toObject());
 
-                    IvrEmoteSet ivrEmoteSet(emoteSet_.toObject());
+        auto id = EmoteId{ivrEmote.id};
+        auto code =
+            EmoteName{TwitchEmotes::cleanUpEmoteCode(ivrEmote.code)};
 
-                    QString setKey = ivrEmoteSet.setId;
-                    emoteSet->key = setKey;
+        loaded.set->emotes.push_back(TwitchEmote{id, code});
 
-                    // check if the emoteset is already in emoteData
-                    auto isAlreadyFetched =
-                        std::find_if(emoteData->emoteSets.begin(),
-                                     emoteData->emoteSets.end(),
-                                     [setKey](std::shared_ptr<EmoteSet> set) {
-                                         return (set->key == setKey);
-                                     });
-                    if (isAlreadyFetched != emoteData->emoteSets.end())
-                    {
-                        continue;
-                    }
+        auto emote = getApp()->emotes->twitch.getOrCreateEmote(id, code);
 
-                    emoteSet->channelName = ivrEmoteSet.login;
-                    emoteSet->text = ivrEmoteSet.displayName;
+        // Follower emotes can be only used in their origin channel
+        if (ivrEmote.emoteType == "FOLLOWER")
+        {
+            loaded.set->local = true;
+            loaded.localEmotes.emplace_back(code, emote);
+        }
+        else
+        {
+            loaded.emotes.emplace_back(code, emote);
+        }
+    }
+    std::sort(loaded.set->emotes.begin(), loaded.set->emotes.end(),
+              [](const TwitchEmote &l, const TwitchEmote &r) {
+                  return l.name.string < r.name.string;
+              });
 
-                    for (const auto &emoteObj : ivrEmoteSet.emotes)
-                    {
-                        IvrEmote ivrEmote(emoteObj.toObject());
+    return loaded;
+}
 
-                        auto id = EmoteId{ivrEmote.id};
-                        auto code = EmoteName{
-                            TwitchEmotes::cleanUpEmoteCode(ivrEmote.code)};
+void TwitchAccount::loadEmoteSets(QStringList keys, bool replace,
+                                  std::weak_ptr<Channel> weakChannel)
+{
+    auto load = std::make_shared<EmoteSetLoad>();
+    load->replace = replace;
+    load->weakChannel = std::move(weakChannel);
 
-                        emoteSet->emotes.push_back(TwitchEmote{id, code});
+    QtConcurrent::run([this, load, keys = std::move(keys)] {
+        QStringList missingKeys;
+        for (const auto &key : keys)
+        {
+            auto entry = NetworkCache::instance().get(emoteSetCacheKey(key));
+            if (entry && entry->isFresh(true))
+            {
+                auto object = QJsonDocument::fromJson(entry->body).object();
+                if (!object.isEmpty())
+                {
+                    load->sets.push_back(parseEmoteSet(object));
+                    continue;
+                }
+            }
+            missingKeys.push_back(key);
+        }
 
-                        auto emote =
-                            getApp()->emotes->twitch.getOrCreateEmote(id, code);
+        if (missingKeys.isEmpty())
+        {
+            this->publishEmoteSets(std::move(load->sets), load->replace,
+                                   load->weakChannel);
+            return;
+        }
 
-                        // Follower emotes can be only used in their origin channel
-                        if (ivrEmote.emoteType == "FOLLOWER")
-                        {
-                            emoteSet->local = true;
+        auto batches = getEmoteSetBatches(missingKeys);
+        load->pendingBatches = batches.size();
 
-                            // EmoteMap for target channel wasn't initialized yet, doing it now
-                            if (localEmoteData->find(ivrEmoteSet.channelId) ==
-                                localEmoteData->end())
+        postToThread([this, load, batches = std::move(batches),
+                      count = missingKeys.size()] {
+            for (size_t i = 0; i < batches.size(); i++)
+            {
+                qCDebug(chatterinoTwitch)
+                    << QString("Loading %1 emotesets from IVR; batch %2/%3 "
+                               "(%4 sets): %5")
+                           .arg(count)
+                           .arg(i + 1)
+                           .arg(batches.size())
+                           .arg(batches.at(i).size())
+                           .arg(batches.at(i).join(","));
+                getIvr()->getBulkEmoteSets(
+                    batches.at(i).join(","),
+                    [this, load](QJsonArray emoteSetArray) {
+                        QtConcurrent::run([this, load, emoteSetArray] {
+                            auto freshUntil =
+                                QDateTime::currentDateTimeUtc().addSecs(
+                                    EMOTE_SET_TTL.count());
+
+                            std::vector<LoadedEmoteSet> sets;
+                            for (auto emoteSet : emoteSetArray)
                             {
-                                localEmoteData->emplace(ivrEmoteSet.channelId,
-                                                        EmoteMap());
+                                auto object = emoteSet.toObject();
+                                sets.push_back(parseEmoteSet(object));
+
+                                auto entry =
+                                    std::make_shared<NetworkCacheEntry>();
+                                entry->body = QJsonDocument(object).toJson(
+                                    QJsonDocument::Compact);
+                                entry->freshUntil = freshUntil;
+                                NetworkCache::instance().put(
+                                    emoteSetCacheKey(sets.back().set->key),
+                                    std::move(entry));
                             }
 
-                            localEmoteData->at(ivrEmoteSet.channelId)
-                                .emplace(code, emote);
-                        }
-                        else
-                        {
-                            emoteData->emotes.emplace(code, emote);
-                        }
-                    }
-                    std::sort(emoteSet->emotes.begin(), emoteSet->emotes.end(),
-                              [](const TwitchEmote &l, const TwitchEmote &r) {
-                                  return l.name.string < r.name.string;
-                              });
-                    emoteData->emoteSets.emplace_back(emoteSet);
-                }
+                            this->finishEmoteSetBatch(load, std::move(sets));
+                        });
+                    },
+                    [this, load] {
+                        // fetching emotes failed, ivr API might be down
+                        this->finishEmoteSetBatch(load, {});
+                    });
+            }
+        });
+    });
+}
 
-                if (auto channel = weakChannel.lock(); channel != nullptr)
-                {
-                    channel->addMessage(makeSystemMessage(
-                        "Twitch subscriber emotes reloaded."));
-                }
-            },
-            [] {
-                // fetching emotes failed, ivr API might be down
-            });
+void TwitchAccount::finishEmoteSetBatch(
+    const std::shared_ptr<EmoteSetLoad> &load,
+    std::vector<LoadedEmoteSet> sets)
+{
+    std::vector<LoadedEmoteSet> allSets;
+    {
+        std::lock_guard<std::mutex> lock(load->mutex);
+        std::move(sets.begin(), sets.end(), std::back_inserter(load->sets));
+
+        if (--load->pendingBatches != 0)
+        {
+            return;
+        }
+        allSets = std::move(load->sets);
+    }
+
+    this->publishEmoteSets(std::move(allSets), load->replace,
+                           load->weakChannel);
+}
+
+void TwitchAccount::publishEmoteSets(std::vector<LoadedEmoteSet> sets,
+                                     bool replace,
+                                     const std::weak_ptr<Channel> &weakChannel)
+{
+    auto addSets = [&sets](TwitchAccountEmoteData &data) {
+        std::unordered_set<QString> loadedKeys;
+        for (const auto &set : data.emoteSets)
+        {
+            loadedKeys.insert(set->key);
+        }
+
+        for (auto &loaded : sets)
+        {
+            if (!loadedKeys.insert(loaded.set->key).second)
+            {
+                continue;
+            }
+
+            data.emoteSets.push_back(loaded.set);
+            for (auto &[name, emote] : loaded.emotes)
+            {
+                data.emotes.emplace(name, emote);
+            }
+        }
     };
+
+    if (replace)
+    {
+        // readers only ever see the old or the new sets
+        TwitchAccountEmoteData data;
+        addSets(data);
+        *this->emotes_.access() = std::move(data);
+    }
+    else
+    {
+        addSets(*this->emotes_.access());
+    }
+
+    {
+        auto localEmoteData = this->localEmotes_.access();
+        for (auto &loaded : sets)
+        {
+            if (loaded.localEmotes.empty())
+            {
+                continue;
+            }
+
+            auto &localEmotes = (*localEmoteData)[loaded.channelId];
+            for (auto &[name, emote] : loaded.localEmotes)
+            {
+                localEmotes.emplace(name, emote);
+            }
+        }
+    }
+
+    this->emotesGeneration_++;
+
+    postToThread([weakChannel] {
+        if (auto channel = weakChannel.lock(); channel != nullptr)
+        {
+            channel->addMessage(
+                makeSystemMessage("Twitch subscriber emotes reloaded."));
+        }
+    });
 }
 
 SharedAccessGuard<const TwitchAccount::TwitchAccountEmoteData>
@@ -373,6 +665,11 @@ SharedAccessGuard<const std::unordered_map<QString, EmoteMap>>
     return this->localEmotes_.accessConst();
 }
 
+uint64_t TwitchAccount::emotesGeneration() const
+{
+    return this->emotesGeneration_;
+}
+
 // AutoModActions
 void TwitchAccount::autoModAllow(const QString msgID, ChannelPtr channel)
 {
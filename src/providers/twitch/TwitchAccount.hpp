@@ -12,11 +12,15 @@
 #include <rapidjson/document.h>
 #include <QColor>
 #include <QElapsedTimer>
+#include <QJsonObject>
 #include <QString>
 
+#include <atomic>
 #include <functional>
 #include <mutex>
 #include <set>
+#include <unordered_set>
+#include <vector>
 
 namespace chatterino {
 
@@ -102,13 +106,20 @@ public:
 
     bool isAnon() const;
 
+    // Loads the blocked users, unless they were loaded in the last few
+    // minutes. Switching back to an account reuses them, blocks made from
+    // here are kept up to date anyway. The blocks of the last start apply
+    // until the first page arrived, every page takes effect as it arrives.
     void loadBlocks();
     void blockUser(QString userId, std::function<void()> onSuccess,
                    std::function<void()> onFailure);
     void unblockUser(QString userId, std::function<void()> onSuccess,
                      std::function<void()> onFailure);
 
-    SharedAccessGuard<const std::set<QString>> accessBlockedUserIds() const;
+    /// Whether the user with the numeric id userId is blocked. It's checked
+    /// for every message, so the lookup runs on a published snapshot of the
+    /// ids and only locks to copy the pointer to it.
+    bool isBlocked(const QString &userId) const;
     SharedAccessGuard<const std::set<TwitchUser>> accessBlocks() const;
 
     void loadEmotes(std::weak_ptr<Channel> weakChannel = {});
@@ -121,13 +132,31 @@ public:
     SharedAccessGuard<const TwitchAccountEmoteData> accessEmotes() const;
     SharedAccessGuard<const std::unordered_map<QString, EmoteMap>>
         accessLocalEmotes() const;
+    // changes whenever the global or local emotes change
+    uint64_t emotesGeneration() const;
 
     // Automod actions
     void autoModAllow(const QString msgID, ChannelPtr channel);
     void autoModDeny(const QString msgID, ChannelPtr channel);
 
 private:
+    struct LoadedEmoteSet;
+    struct EmoteSetLoad;
+    struct BlocksLoad;
+
     void loadEmoteSetData(std::shared_ptr<EmoteSet> emoteSet);
+    // Loads the emote sets of keys in the thread pool, from the cache while
+    // they're fresh and from IVR otherwise. If replace is set, they replace
+    // all loaded sets at once, otherwise they're added to them.
+    void loadEmoteSets(QStringList keys, bool replace,
+                       std::weak_ptr<Channel> weakChannel);
+    void finishEmoteSetBatch(const std::shared_ptr<EmoteSetLoad> &load,
+                             std::vector<LoadedEmoteSet> sets);
+    void publishEmoteSets(std::vector<LoadedEmoteSet> sets, bool replace,
+                          const std::weak_ptr<Channel> &weakChannel);
+    static LoadedEmoteSet parseEmoteSet(const QJsonObject &object);
+    // replaces the ids checked by isBlocked with the ones of ignores
+    void publishBlockedUserIds(const std::set<TwitchUser> &ignores);
 
     QString oauthClient_;
     QString oauthToken_;
@@ -139,11 +168,18 @@ private:
     mutable std::mutex ignoresMutex_;
     QStringList userstateEmoteSets_;
     UniqueAccess<std::set<TwitchUser>> ignores_;
-    UniqueAccess<std::set<QString>> ignoresUserIds_;
+    // never changed once published, a new set replaces it
+    Atomic<std::shared_ptr<const std::unordered_set<uint64_t>>>
+        blockedUserIds_;
+    // gui thread only
+    QElapsedTimer blocksLoaded_;
+    // the load of the blocks that's running, gui thread only
+    std::shared_ptr<BlocksLoad> blocksLoad_;
 
     //    std::map<UserId, TwitchAccountEmoteData> emotes;
     UniqueAccess<TwitchAccountEmoteData> emotes_;
     UniqueAccess<std::unordered_map<QString, EmoteMap>> localEmotes_;
+    std::atomic<uint64_t> emotesGeneration_{0};
 };
 
 }  // namespace chatterino
@@ -1,7 +1,11 @@
 #include "providers/twitch/TwitchBadge.hpp"
 
+#include "util/QStringHash.hpp"
+
 #include <QSet>
 
+#include <mutex>
+
 namespace chatterino {
 
 // set of badge IDs that should be given specific flags.
@@ -11,9 +15,23 @@ const QSet<QString> predictions{"predictions"};
 const QSet<QString> channelAuthority{"moderator", "vip", "broadcaster"};
 const QSet<QString> subBadges{"subscriber", "founder"};
 
+BadgeId badgeId(const QString &nameOrToken)
+{
+    static std::mutex mutex;
+    static std::unordered_map<QString, BadgeId> ids;
+
+    auto lower = nameOrToken.toLower();
+
+    std::lock_guard<std::mutex> lock(mutex);
+    return ids.emplace(std::move(lower), BadgeId(ids.size())).first->second;
+}
+
 Badge::Badge(QString key, QString value)
     : key_(std::move(key))
     , value_(std::move(value))
+    , token_(makeToken(this->key_, this->value_))
+    , nameId_(badgeId(this->key_))
+    , tokenId_(badgeId(this->token_))
 {
     if (globalAuthority.contains(this->key_))
     {
@@ -33,4 +51,9 @@ Badge::Badge(QString key, QString value)
     }
 }
 
+QString Badge::makeToken(const QString &key, const QString &value)
+{
+    return key + '/' + value;
+}
+
 }  // namespace chatterino
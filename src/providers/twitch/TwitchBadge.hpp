@@ -1,11 +1,26 @@
 #pragma once
 
 #include "messages/MessageElement.hpp"
+#include "util/QStringHash.hpp"
 
 #include <QString>
 
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
 namespace chatterino {
 
+struct Emote;
+using EmotePtr = std::shared_ptr<const Emote>;
+
+/// Small number standing for a badge name like "bits" or a token like
+/// "bits/100", badges are matched by comparing these. The same string in any
+/// case always gets the same id. Ids are never freed, there are only a few
+/// thousand distinct badges.
+using BadgeId = uint32_t;
+BadgeId badgeId(const QString &nameOrToken);
+
 class Badge
 {
 public:
@@ -14,8 +29,16 @@ public:
     QString key_;           // e.g. bits
     QString value_;         // e.g. 100
     QString extraValue_{};  // e.g. 5 (the number of months subscribed)
+    QString token_;         // e.g. bits/100, the key in a BadgeTable
     MessageElementFlag flag_{
         MessageElementFlag::BadgeVanity};  // badge slot it takes up
+    BadgeId nameId_;
+    BadgeId tokenId_;
+
+    static QString makeToken(const QString &key, const QString &value);
 };
 
+/// Badge emotes keyed by Badge::token_
+using BadgeTable = std::unordered_map<QString, EmotePtr, QStringHash>;
+
 }  // namespace chatterino
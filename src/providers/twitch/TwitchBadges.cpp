@@ -32,10 +32,12 @@ void TwitchBadges::loadTwitchBadges()
     url.setQuery(urlQuery);
 
     NetworkRequest(url)
+        .cache(std::chrono::hours(1))
         .onSuccess([this](auto result) -> Outcome {
             {
                 auto root = result.parseJson();
                 auto badgeSets = this->badgeSets_.access();
+                auto table = std::make_shared<BadgeTable>();
 
                 auto jsonSets = root.value("badge_sets").toObject();
                 for (auto sIt = jsonSets.begin(); sIt != jsonSets.end(); ++sIt)
@@ -49,28 +51,35 @@ void TwitchBadges::loadTwitchBadges()
                     {
                         auto versionObj = vIt.value().toObject();
 
+                        // all twitch badges are 18x18 at 1x
+                        const QSize size(18, 18);
+
                         auto emote = Emote{
                             {""},
                             ImageSet{
                                 Image::fromUrl({versionObj.value("image_url_1x")
                                                     .toString()},
-                                               1),
+                                               1, size),
                                 Image::fromUrl({versionObj.value("image_url_2x")
                                                     .toString()},
-                                               .5),
+                                               .5, size),
                                 Image::fromUrl({versionObj.value("image_url_4x")
                                                     .toString()},
-                                               .25),
+                                               .25, size),
                             },
                             Tooltip{versionObj.value("title").toString()},
                             Url{versionObj.value("click_url").toString()}};
                         // "title"
                         // "clickAction"
 
-                        (*badgeSets)[key][vIt.key()] =
-                            std::make_shared<Emote>(emote);
+                        auto shared = std::make_shared<const Emote>(emote);
+                        (*badgeSets)[key][vIt.key()] = shared;
+                        (*table)[Badge::makeToken(key, vIt.key())] = shared;
                     }
                 }
+
+                std::shared_ptr<const BadgeTable> published = std::move(table);
+                std::atomic_store(&this->table_, std::move(published));
             }
             this->loaded();
             return Success;
@@ -123,6 +132,11 @@ boost::optional<EmotePtr> TwitchBadges::badge(const QString &set,
     return boost::none;
 }
 
+std::shared_ptr<const BadgeTable> TwitchBadges::table() const
+{
+    return std::atomic_load(&this->table_);
+}
+
 boost::optional<EmotePtr> TwitchBadges::badge(const QString &set) const
 {
     auto badgeSets = this->badgeSets_.access();
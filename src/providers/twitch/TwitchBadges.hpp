@@ -7,6 +7,7 @@
 
 #include "common/UniqueAccess.hpp"
 #include "messages/Image.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
 #include "util/DisplayBadge.hpp"
 #include "util/QStringHash.hpp"
 
@@ -38,6 +39,8 @@ public:
                                     const QString &version) const;
     // Get first matching badge with name, regardless of version
     boost::optional<EmotePtr> badge(const QString &set) const;
+    // All badges, replaced as a whole once they are loaded
+    std::shared_ptr<const BadgeTable> table() const;
 
     void getBadgeIcon(const QString &name, BadgeIconCallback callback);
     void getBadgeIcon(const DisplayBadge &badge, BadgeIconCallback callback);
@@ -65,6 +68,7 @@ private:
     UniqueAccess<
         std::unordered_map<QString, std::unordered_map<QString, EmotePtr>>>
         badgeSets_;  // "bits": { "100": ... "500": ...
+    std::shared_ptr<const BadgeTable> table_;
 };
 
 }  // namespace chatterino
@@ -1,42 +1,66 @@
 #include "providers/twitch/TwitchChannel.hpp"
 
 #include "Application.hpp"
+#include "common/Args.hpp"
+#include "common/ChannelLoadScheduler.hpp"
 #include "common/Common.hpp"
 #include "common/Env.hpp"
 #include "common/NetworkRequest.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/notifications/NotificationController.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "messages/Message.hpp"
 #include "providers/bttv/BttvEmotes.hpp"
 #include "providers/bttv/LoadBttvChannelEmote.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/twitch/IrcMessageHandler.hpp"
+#include "providers/twitch/LiveStatusService.hpp"
 #include "providers/twitch/PubsubClient.hpp"
+#include "providers/twitch/TwitchBadges.hpp"
 #include "providers/twitch/TwitchCommon.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/TwitchMessageBuilder.hpp"
 #include "providers/twitch/api/Helix.hpp"
+#include "providers/twitch/api/HelixBatcher.hpp"
 #include "singletons/Emotes.hpp"
+#include "singletons/Logging.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Toasts.hpp"
 #include "singletons/WindowManager.hpp"
 #include "util/FormatTime.hpp"
+#include "util/JsonDocument.hpp"
 #include "util/PostToThread.hpp"
 #include "util/QStringHash.hpp"
+#include "util/StringPool.hpp"
 #include "widgets/Window.hpp"
 
 #include <rapidjson/document.h>
+#include <rapidjson/reader.h>
 #include <IrcConnection>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QJsonValue>
 #include <QThread>
 #include <QTimer>
+#include <QtConcurrent>
+
+#include <utility>
 
 namespace chatterino {
 namespace {
     constexpr char MAGIC_MESSAGE_SUFFIX[] = u8" \U000E0000";
     constexpr int TITLE_REFRESH_PERIOD = 10000;
     constexpr int CLIP_CREATION_COOLDOWN = 5000;
+    // completing a user name refreshes chatter lists older than this
+    constexpr int CHATTERS_COMPLETION_REFRESH_AGE = 60 * 1000;
+    // same as the message limit of a channel
+    constexpr size_t DORMANT_LINE_LIMIT = 1000;
+    // the clocks of the message history service and ours may be off by this
+    // much, messages it returns twice are recognized by their id
+    constexpr qint64 MISSED_MESSAGES_SLACK_MS = 2000;
+    constexpr int MISSED_MESSAGES_TIMEOUT_MS = 10000;
+    constexpr std::chrono::seconds BADGES_TTL = std::chrono::hours(1);
     const QString CLIPS_LINK("https://clips.twitch.tv/%1");
     const QString CLIPS_FAILURE_CLIPS_DISABLED_TEXT(
         "Failed to create a clip - the streamer has clips disabled entirely or "
@@ -93,54 +117,280 @@ namespace {
         return newMessage;
     }
 
-    // parseRecentMessages takes a json object and returns a vector of
-    // Communi IrcMessages
-    auto parseRecentMessages(const QJsonObject &jsonRoot, ChannelPtr channel)
+    // Parses a single raw IRC line of the recent-messages API
+    std::unique_ptr<Communi::IrcMessage> parseRecentMessage(QString content)
+    {
+        content.replace(COMBINED_FIXER, ZERO_WIDTH_JOINER);
+
+        std::unique_ptr<Communi::IrcMessage> message(
+            Communi::IrcMessage::fromData(content.toUtf8(), nullptr));
+
+        if (message->command() == "CLEARCHAT")
+        {
+            message.reset(convertClearchatToNotice(message.get()));
+        }
+
+        return message;
+    }
+
+    // Reads a recent-messages response like
+    // {"messages": ["@tags :raw irc line", ...], "error_code": "..."}
+    // with rapidjson's SAX reader, without building a document first
+    class RecentMessagesHandler
+        : public rapidjson::BaseReaderHandler<rapidjson::UTF8<>,
+                                              RecentMessagesHandler>
+    {
+    public:
+        std::vector<std::unique_ptr<Communi::IrcMessage>> messages;
+        QString errorCode;
+
+        bool String(const char *str, rapidjson::SizeType length, bool)
+        {
+            if (this->depth_ == 2 && this->inMessages_)
+            {
+                this->messages.push_back(parseRecentMessage(
+                    QString::fromUtf8(str, int(length))));
+            }
+            else if (this->depth_ == 1 && this->key_ == "error_code")
+            {
+                this->errorCode = QString::fromUtf8(str, int(length));
+            }
+            return true;
+        }
+
+        bool Key(const char *str, rapidjson::SizeType length, bool)
+        {
+            if (this->depth_ == 1)
+            {
+                this->key_ = QByteArray(str, int(length));
+            }
+            return true;
+        }
+
+        bool StartObject()
+        {
+            this->depth_++;
+            return true;
+        }
+
+        bool EndObject(rapidjson::SizeType)
+        {
+            this->depth_--;
+            return true;
+        }
+
+        bool StartArray()
+        {
+            this->depth_++;
+            this->inMessages_ = this->depth_ == 2 && this->key_ == "messages";
+            return true;
+        }
+
+        bool EndArray(rapidjson::SizeType)
+        {
+            if (this->depth_ == 2)
+            {
+                this->inMessages_ = false;
+            }
+            this->depth_--;
+            return true;
+        }
+
+    private:
+        int depth_ = 0;
+        QByteArray key_;
+        bool inMessages_ = false;
+    };
+
+    // History is added to the channel in chunks of this many messages, so
+    // the gui stays responsive in between
+    constexpr size_t HISTORY_CHUNK_SIZE = 100;
+
+    // the rm-received-ts tag, 0 if the message doesn't have one
+    qint64 receivedTime(const Communi::IrcMessage &message)
+    {
+        return message.tags().value("rm-received-ts").toLongLong();
+    }
+
+    // Builds the history, newest messages first, and adds it to the start of
+    // the channel in chunks. Returns the date of the newest message.
+    QDate addHistoryAtStart(
+        const ChannelPtr &shared,
+        const std::vector<std::unique_ptr<Communi::IrcMessage>> &messages,
+        QDate lastDate)
     {
-        QJsonArray jsonMessages = jsonRoot.value("messages").toArray();
-        std::vector<Communi::IrcMessage *> messages;
+        // a date separator goes in front of the first message of every day
+        std::vector<boost::optional<QDate>> separators(messages.size());
+        auto currentDate = lastDate;
+        for (size_t i = 0; i < messages.size(); i++)
+        {
+            const auto &tags = messages[i]->tags();
+            auto it = tags.find("rm-received-ts");
+            if (it == tags.end())
+            {
+                continue;
+            }
 
-        if (jsonMessages.empty())
-            return messages;
+            auto date = QDateTime::fromMSecsSinceEpoch(it->toLongLong()).date();
+            if (date != currentDate)
+            {
+                currentDate = date;
+                separators[i] = date;
+            }
+        }
 
-        for (const auto jsonMessage : jsonMessages)
+        // The newest messages are built and added first, they are the ones
+        // that are visible. Older chunks are added in front of them.
+        auto &messageHandler = IrcMessageHandler::instance();
+        for (size_t end = messages.size(); end > 0;)
         {
-            auto content = jsonMessage.toString();
-            content.replace(COMBINED_FIXER, ZERO_WIDTH_JOINER);
+            auto begin =
+                end > HISTORY_CHUNK_SIZE ? end - HISTORY_CHUNK_SIZE : 0;
 
-            auto message =
-                Communi::IrcMessage::fromData(content.toUtf8(), nullptr);
+            std::vector<MessagePtr> chunk;
+            chunk.reserve(end - begin);
 
-            if (message->command() == "CLEARCHAT")
+            for (size_t i = begin; i < end; i++)
             {
-                message = convertClearchatToNotice(message);
+                if (separators[i])
+                {
+                    auto msg = makeSystemMessage(
+                        QLocale().toString(*separators[i], QLocale::LongFormat),
+                        QTime(0, 0));
+                    msg->flags.set(MessageFlag::RecentMessage);
+                    chunk.emplace_back(msg);
+                }
+
+                for (auto builtMessage : messageHandler.parseMessage(
+                         shared.get(), messages[i].get()))
+                {
+                    builtMessage->flags.set(MessageFlag::RecentMessage);
+                    chunk.emplace_back(builtMessage);
+                }
             }
 
-            messages.emplace_back(std::move(message));
+            postToThread([shared, chunk = std::move(chunk)]() mutable {
+                shared->addMessagesAtStart(chunk);
+            });
+
+            end = begin;
         }
 
-        return messages;
+        return currentDate;
+    }
+
+    // Appends the history that was missed, e.g. since the kept history of
+    // the last session ended. That's only possible while no messages were
+    // added since, otherwise gapText is shown instead.
+    void appendMissedHistory(
+        const ChannelPtr &shared,
+        const std::vector<std::unique_ptr<Communi::IrcMessage>> &messages,
+        QDate lastDate, int64_t addedMessageCount, QString gapText)
+    {
+        std::vector<MessagePtr> missed;
+        auto &messageHandler = IrcMessageHandler::instance();
+        for (const auto &message : messages)
+        {
+            auto date =
+                QDateTime::fromMSecsSinceEpoch(receivedTime(*message)).date();
+            if (date != lastDate)
+            {
+                lastDate = date;
+                auto separator = makeSystemMessage(
+                    QLocale().toString(date, QLocale::LongFormat), QTime(0, 0));
+                separator->flags.set(MessageFlag::RecentMessage);
+                missed.emplace_back(separator);
+            }
+
+            for (auto builtMessage :
+                 messageHandler.parseMessage(shared.get(), message.get()))
+            {
+                builtMessage->flags.set(MessageFlag::RecentMessage);
+                missed.emplace_back(builtMessage);
+            }
+        }
+
+        postToThread([shared, lastDate, addedMessageCount,
+                      gapText = std::move(gapText),
+                      missed = std::move(missed)] {
+            if (missed.empty())
+            {
+                return;
+            }
+
+            if (shared->addedMessageCount() != addedMessageCount)
+            {
+                shared->addMessage(makeSystemMessage(gapText));
+                return;
+            }
+
+            shared->lastDate_ = lastDate;
+            for (const auto &message : missed)
+            {
+                // the message may have been received before all was missed
+                if (!message->id.isEmpty() && shared->findMessage(message->id))
+                {
+                    continue;
+                }
+
+                // history isn't logged, like when it's added at the start
+                auto flags = boost::optional<MessageFlags>(message->flags);
+                flags->set(MessageFlag::DoNotLog);
+                shared->addMessage(message, flags);
+            }
+        });
     }
-    std::pair<Outcome, std::unordered_set<QString>> parseChatters(
-        const QJsonObject &jsonRoot)
+
+    // returns the sorted logins, interned so the same user in multiple
+    // channels (or refreshes) shares one string
+    // The chatter list is always downloaded as a whole. Lists of big channels
+    // are large and only a few of their chatters are kept anyway, channels
+    // that are offline change slowly.
+    int chattersRefreshInterval(int chatterCount, bool live)
     {
-        static QStringList categories = {"broadcaster", "vips",   "moderators",
-                                         "staff",       "admins", "global_mods",
-                                         "viewers"};
+        int minutes = chatterCount < 1000 ? 5 : chatterCount < 10000 ? 10 : 20;
+        if (!live)
+        {
+            minutes *= 2;
+        }
+        return minutes * 60 * 1000;
+    }
 
-        auto usernames = std::unordered_set<QString>();
+    std::pair<Outcome, std::vector<QString>> parseChatters(
+        const rapidjson::Value &jsonRoot)
+    {
+        static const char *categories[] = {
+            "broadcaster", "vips",        "moderators", "staff",
+            "admins",      "global_mods", "viewers"};
 
-        // parse json
-        QJsonObject jsonCategories = jsonRoot.value("chatters").toObject();
+        auto usernames = std::vector<QString>();
+        auto &pool = StringPool::instance();
 
-        for (const auto &category : categories)
+        const auto *jsonCategories = rj::member(jsonRoot, "chatters");
+        if (jsonCategories == nullptr)
         {
-            for (auto jsonCategory : jsonCategories.value(category).toArray())
+            return {Failure, {}};
+        }
+
+        for (const auto *category : categories)
+        {
+            const auto *jsonCategory = rj::member(*jsonCategories, category);
+            if (jsonCategory == nullptr || !jsonCategory->IsArray())
+            {
+                continue;
+            }
+
+            usernames.reserve(usernames.size() + jsonCategory->Size());
+            for (const auto &jsonChatter : jsonCategory->GetArray())
             {
-                usernames.insert(jsonCategory.toString());
+                usernames.push_back(pool.intern(rj::toString(jsonChatter)));
             }
         }
 
+        std::sort(usernames.begin(), usernames.end());
+        usernames.erase(std::unique(usernames.begin(), usernames.end()),
+                        usernames.end());
+
         return {Success, std::move(usernames)};
     }
 }  // namespace
@@ -174,27 +424,22 @@ TwitchChannel::TwitchChannel(const QString &name)
         this->refreshPubsub();
     });
 
-    // room id loaded -> refresh live status
+    // room id loaded
     this->roomIdChanged.connect([this]() {
         this->refreshPubsub();
         this->refreshTitle();
-        this->refreshLiveStatus();
-        this->refreshBadges();
-        this->refreshCheerEmotes();
-        this->refreshFFZChannelEmotes(false);
-        this->refreshBTTVChannelEmotes(false);
+        this->scheduleRoomLoads();
     });
 
     // timers
+    // started by refreshChatters, the interval depends on the channel
+    this->chattersListTimer_.setSingleShot(true);
     QObject::connect(&this->chattersListTimer_, &QTimer::timeout, [=] {
         this->refreshChatters();
     });
-    this->chattersListTimer_.start(5 * 60 * 1000);
 
-    QObject::connect(&this->liveStatusTimer_, &QTimer::timeout, [=] {
-        this->refreshLiveStatus();
-    });
-    this->liveStatusTimer_.start(60 * 1000);
+    // live status, polled together with all other channels
+    this->watchLiveStatus();
 
     // debugging
 #if 0
@@ -204,11 +449,19 @@ TwitchChannel::TwitchChannel(const QString &name)
 #endif
 }
 
+TwitchChannel::~TwitchChannel()
+{
+    LiveStatusService::instance().unwatch(this->getName(), this);
+}
+
 void TwitchChannel::initialize()
 {
     this->fetchDisplayName();
-    this->refreshChatters();
-    this->refreshBadges();
+    if (!getArgs().headless)
+    {
+        this->refreshChatters();
+        this->refreshBadges();
+    }
 }
 
 bool TwitchChannel::isEmpty() const
@@ -242,25 +495,86 @@ void TwitchChannel::setLocalizedName(const QString &name)
 }
 
 void TwitchChannel::refreshBTTVChannelEmotes(bool manualRefresh)
+{
+    this->loadBTTVChannelEmotes(manualRefresh, nullptr);
+}
+
+void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
+{
+    this->loadFFZChannelEmotes(manualRefresh, nullptr);
+}
+
+void TwitchChannel::scheduleRoomLoads()
+{
+    // emotes and badges are only needed to show messages
+    if (getArgs().headless)
+    {
+        return;
+    }
+
+    auto &scheduler = ChannelLoadScheduler::instance();
+    auto priority = getApp()->windows->loadPriority(this);
+    auto weak = weakOf<Channel>(this);
+
+    scheduler.enqueue(
+        ChannelLoadScheduler::Resource::Emotes, priority,
+        [this, weak](auto done) {
+            if (weak.expired())
+            {
+                done();
+                return;
+            }
+
+            auto guard = ChannelLoadScheduler::doneOnDestroy(done);
+            this->loadFFZChannelEmotes(false, guard);
+            this->loadBTTVChannelEmotes(false, guard);
+        });
+
+    scheduler.enqueue(
+        ChannelLoadScheduler::Resource::Badges, priority,
+        [this, weak](auto done) {
+            if (weak.expired())
+            {
+                done();
+                return;
+            }
+
+            auto guard = ChannelLoadScheduler::doneOnDestroy(done);
+            this->refreshBadges(guard);
+            this->refreshCheerEmotes(guard);
+        });
+}
+
+void TwitchChannel::loadBTTVChannelEmotes(bool manualRefresh,
+                                          std::shared_ptr<void> loadGuard)
 {
     BttvEmotes::loadChannel(
         weakOf<Channel>(this), this->roomId(), this->getLocalizedName(),
-        [this, weak = weakOf<Channel>(this)](auto &&emoteMap) {
+        [this, weak = weakOf<Channel>(this),
+         loadGuard = std::move(loadGuard)](auto &&emoteMap) {
             if (auto shared = weak.lock())
-                this->bttvEmotes_.set(
-                    std::make_shared<EmoteMap>(std::move(emoteMap)));
+            {
+                this->bttvEmotes_.set(makeEmoteMapPtr(std::move(emoteMap)));
+                // build the new index now instead of on the next message
+                this->emoteIndex();
+            }
         },
         manualRefresh);
 }
 
-void TwitchChannel::refreshFFZChannelEmotes(bool manualRefresh)
+void TwitchChannel::loadFFZChannelEmotes(bool manualRefresh,
+                                         std::shared_ptr<void> loadGuard)
 {
     FfzEmotes::loadChannel(
         weakOf<Channel>(this), this->roomId(),
-        [this, weak = weakOf<Channel>(this)](auto &&emoteMap) {
+        [this, weak = weakOf<Channel>(this),
+         loadGuard = std::move(loadGuard)](auto &&emoteMap) {
             if (auto shared = weak.lock())
-                this->ffzEmotes_.set(
-                    std::make_shared<EmoteMap>(std::move(emoteMap)));
+            {
+                this->ffzEmotes_.set(makeEmoteMapPtr(std::move(emoteMap)));
+                // build the new index now instead of on the next message
+                this->emoteIndex();
+            }
         },
         [this, weak = weakOf<Channel>(this)](auto &&modBadge) {
             if (auto shared = weak.lock())
@@ -295,35 +609,65 @@ void TwitchChannel::addChannelPointReward(const ChannelPointReward &reward)
         return;
     }
 
-    bool result;
+    if (this->isChannelPointRewardKnown(reward.id))
     {
-        auto channelPointRewards = this->channelPointRewards_.access();
-        result = channelPointRewards->try_emplace(reward.id, reward).second;
-    }
-    if (result)
-    {
-        this->channelPointRewardAdded.invoke(reward);
+        return;
     }
+
+    // only the gui thread writes, so nothing is added in between
+    using Rewards = std::unordered_map<QString, ChannelPointReward>;
+    auto rewards = this->channelPointRewards_.get();
+    auto updated = rewards ? std::make_shared<Rewards>(*rewards)
+                           : std::make_shared<Rewards>();
+    updated->emplace(reward.id, reward);
+    this->channelPointRewards_.set(std::move(updated));
+
+    this->pendingRedemptions_.rewardAdded(reward.id);
 }
 
-bool TwitchChannel::isChannelPointRewardKnown(const QString &rewardId)
+bool TwitchChannel::isChannelPointRewardKnown(const QString &rewardId) const
 {
-    const auto &pointRewards = this->channelPointRewards_.accessConst();
-    const auto &it = pointRewards->find(rewardId);
-    return it != pointRewards->end();
+    auto rewards = this->channelPointRewards_.get();
+    return rewards && rewards->count(rewardId) != 0;
 }
 
 boost::optional<ChannelPointReward> TwitchChannel::channelPointReward(
     const QString &rewardId) const
 {
-    auto rewards = this->channelPointRewards_.accessConst();
-    auto it = rewards->find(rewardId);
+    auto rewards = this->channelPointRewards_.get();
+    if (!rewards)
+        return boost::none;
 
+    auto it = rewards->find(rewardId);
     if (it == rewards->end())
         return boost::none;
     return it->second;
 }
 
+void TwitchChannel::waitForChannelPointReward(
+    const QString &rewardId, PendingRedemptions::Callback callback)
+{
+    assertInGuiThread();
+
+    if (this->isChannelPointRewardKnown(rewardId))
+    {
+        callback(true);
+        return;
+    }
+
+    this->pendingRedemptions_.add(rewardId, std::move(callback),
+                                  PendingRedemptions::Clock::now());
+
+    auto timeout = int(PendingRedemptions::TIMEOUT.count()) + 1;
+    QTimer::singleShot(timeout, [weak = weakOf<Channel>(this)] {
+        if (auto channel = weak.lock())
+        {
+            static_cast<TwitchChannel *>(channel.get())
+                ->pendingRedemptions_.expire(PendingRedemptions::Clock::now());
+        }
+    });
+}
+
 void TwitchChannel::sendMessage(const QString &message)
 {
     auto app = getApp();
@@ -500,6 +844,182 @@ void TwitchChannel::setRoomId(const QString &id)
     }
 }
 
+bool TwitchChannel::isDormant() const
+{
+    return this->dormant_;
+}
+
+void TwitchChannel::setDormant(bool dormant)
+{
+    assertInGuiThread();
+
+    if (this->dormant_ == dormant)
+    {
+        return;
+    }
+    this->dormant_ = dormant;
+
+    if (dormant)
+    {
+        LiveStatusService::instance().unwatch(this->getName(), this);
+        this->chattersListTimer_.stop();
+        return;
+    }
+
+    this->watchLiveStatus();
+    LiveStatusService::instance().refresh(this->getName());
+    this->refreshChatters();
+
+    auto lines = std::move(this->dormantLines_);
+    this->dormantLines_.clear();
+
+    if (this->loadHistoryOnWake_)
+    {
+        this->loadHistoryOnWake_ = false;
+        this->loadRecentMessages();
+        return;
+    }
+
+    getApp()->twitch->replayLines(lines);
+}
+
+bool TwitchChannel::keepsLines() const
+{
+    return this->dormant_ || this->loadingMissed_;
+}
+
+void TwitchChannel::loadMissedMessages()
+{
+    assertInGuiThread();
+
+    auto since = std::exchange(this->missedSince_, 0);
+    if (since == 0 || this->loadingMissed_ ||
+        !getSettings()->loadTwitchMessageHistoryOnConnect)
+    {
+        return;
+    }
+
+    // The kept lines of dormant channels are from before the missed ones,
+    // they'd end up after them
+    if (this->dormant_)
+    {
+        return;
+    }
+
+    // everything received from now on is kept and added after the missed
+    // messages
+    this->loadingMissed_ = true;
+    auto from = since - MISSED_MESSAGES_SLACK_MS;
+    auto until = QDateTime::currentMSecsSinceEpoch();
+
+    QUrl url(Env::get().recentMessagesApiUrl.arg(this->getName()));
+    QUrlQuery urlQuery(url);
+    if (!urlQuery.hasQueryItem("limit"))
+    {
+        urlQuery.addQueryItem(
+            "limit", QString::number(getSettings()->twitchMessageHistoryLimit));
+    }
+    urlQuery.addQueryItem("after", QString::number(from));
+    urlQuery.addQueryItem("before", QString::number(until));
+    url.setQuery(urlQuery);
+
+    auto weak = weakOf<Channel>(this);
+    auto finish = [weak] {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            return;
+        }
+
+        auto *channel = static_cast<TwitchChannel *>(shared.get());
+        channel->loadingMissed_ = false;
+        if (channel->dormant_)
+        {
+            // replayed once it wakes up
+            return;
+        }
+
+        auto lines = std::move(channel->dormantLines_);
+        channel->dormantLines_.clear();
+        getApp()->twitch->replayLines(lines);
+    };
+
+    auto load = [weak, url, from, until, finish,
+                 lastDate = this->lastDate_](auto done) {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            done();
+            return;
+        }
+
+        NetworkRequest(url)
+            .concurrent()
+            .timeout(MISSED_MESSAGES_TIMEOUT_MS)
+            .onSuccess([weak, done, finish, from, until, lastDate,
+                        addedCount = shared->addedMessageCount()](
+                           NetworkResult result) -> Outcome {
+                auto shared = weak.lock();
+                if (!shared)
+                {
+                    postToThread(done);
+                    return Failure;
+                }
+
+                RecentMessagesHandler handler;
+                rapidjson::Reader reader;
+                rapidjson::StringStream stream(result.getData().constData());
+                reader.Parse(stream, handler);
+
+                // in case the service doesn't know the range
+                auto &messages = handler.messages;
+                messages.erase(
+                    std::remove_if(messages.begin(), messages.end(),
+                                   [from, until](const auto &message) {
+                                       auto time = receivedTime(*message);
+                                       return time <= from || time > until;
+                                   }),
+                    messages.end());
+
+                appendMissedHistory(shared, messages, lastDate, addedCount,
+                                    "There may be gaps in the messages since "
+                                    "the connection was lost.");
+                postToThread([finish, done] {
+                    finish();
+                    done();
+                });
+                return Success;
+            })
+            .onError([weak, done, finish](NetworkResult result) {
+                postToThread([weak, done, finish, status = result.status()] {
+                    if (auto shared = weak.lock())
+                    {
+                        shared->addMessage(makeSystemMessage(
+                            QString("The messages missed while disconnected "
+                                    "couldn't be loaded (Error %1)")
+                                .arg(status)));
+                    }
+                    finish();
+                    done();
+                });
+            })
+            .execute();
+    };
+
+    ChannelLoadScheduler::instance().enqueue(
+        ChannelLoadScheduler::Resource::History,
+        getApp()->windows->loadPriority(this), std::move(load));
+}
+
+void TwitchChannel::keepDormantLine(QByteArray line)
+{
+    this->dormantLines_.push_back(std::move(line));
+    if (this->dormantLines_.size() > DORMANT_LINE_LIMIT)
+    {
+        this->dormantLines_.pop_front();
+    }
+}
+
 SharedAccessGuard<const TwitchChannel::RoomModes>
     TwitchChannel::accessRoomModes() const
 {
@@ -554,6 +1074,12 @@ std::shared_ptr<const EmoteMap> TwitchChannel::ffzEmotes() const
     return this->ffzEmotes_.get();
 }
 
+std::shared_ptr<const ChannelEmoteIndex> TwitchChannel::emoteIndex() const
+{
+    return ChannelEmoteIndex::current(this->emoteIndex_, this->ffzEmotes_.get(),
+                                      this->bttvEmotes_.get());
+}
+
 const QString &TwitchChannel::subscriptionUrl()
 {
     return this->subscriptionUrl_;
@@ -611,7 +1137,7 @@ void TwitchChannel::setLive(bool newLiveStatus)
                 MessageBuilder builder2;
                 TwitchMessageBuilder::liveMessage(this->getDisplayName(),
                                                   &builder2);
-                getApp()->twitch->liveChannel->addMessage(builder2.release());
+                getApp()->twitch->liveChannel->collect(builder2.release());
 
                 // Notify on all channels with a ping sound
                 if (getSettings()->notificationOnAnyChannel &&
@@ -632,16 +1158,15 @@ void TwitchChannel::setLive(bool newLiveStatus)
                 // "delete" old 'CHANNEL is live' message
                 LimitedQueueSnapshot<MessagePtr> snapshot =
                     getApp()->twitch->liveChannel->getMessageSnapshot();
-                int snapshotLength = snapshot.size();
-
-                // MSVC hates this code if the parens are not there
-                int end = (std::max)(0, snapshotLength - 200);
+                // only the last 200 messages are searched
+                auto searched = (std::min)(snapshot.size(), size_t(200));
+                auto end = snapshot.rbegin() + std::ptrdiff_t(searched);
                 auto liveMessageSearchText =
                     QString("%1 is live!").arg(this->getDisplayName());
 
-                for (int i = snapshotLength - 1; i >= end; --i)
+                for (auto it = snapshot.rbegin(); it != end; ++it)
                 {
-                    auto &s = snapshot[i];
+                    const auto &s = *it;
 
                     if (s->messageText == liveMessageSearchText)
                     {
@@ -696,31 +1221,12 @@ void TwitchChannel::refreshTitle()
         });
 }
 
-void TwitchChannel::refreshLiveStatus()
+void TwitchChannel::watchLiveStatus()
 {
-    auto roomID = this->roomId();
-
-    if (roomID.isEmpty())
-    {
-        qCDebug(chatterinoTwitch) << "[TwitchChannel" << this->getName()
-                                  << "] Refreshing live status (Missing ID)";
-        this->setLive(false);
-        return;
-    }
-
-    getHelix()->getStreamById(
-        roomID,
-        [this, weak = weakOf<Channel>(this)](bool live, const auto &stream) {
-            ChannelPtr shared = weak.lock();
-            if (!shared)
-            {
-                return;
-            }
-
+    // unwatched in the destructor, so this outlives the callback
+    LiveStatusService::instance().watch(
+        this->getName(), this, [this](bool live, const auto &stream) {
             this->parseLiveStatus(live, stream);
-        },
-        [] {
-            // failure
         });
 }
 
@@ -760,6 +1266,24 @@ void TwitchChannel::loadRecentMessages()
         return;
     }
 
+    if (this->dormant_)
+    {
+        this->loadHistoryOnWake_ = true;
+        return;
+    }
+
+    if (getSettings()->persistMessageHistory && !this->spillLoaded_)
+    {
+        this->spillLoaded_ = true;
+        this->loadSpilledHistory();
+        return;
+    }
+
+    // only the first load after the kept history comes after it
+    auto spilledUntil = this->spilledUntil_;
+    auto spilledCount = this->spilledCount_;
+    this->spilledUntil_ = 0;
+
     QUrl url(Env::get().recentMessagesApiUrl.arg(this->getName()));
     QUrlQuery urlQuery(url);
     if (!urlQuery.hasQueryItem("limit"))
@@ -771,80 +1295,167 @@ void TwitchChannel::loadRecentMessages()
 
     auto weak = weakOf<Channel>(this);
 
-    NetworkRequest(url)
-        .onSuccess([this, weak](NetworkResult result) -> Outcome {
-            auto shared = weak.lock();
-            if (!shared)
-                return Failure;
+    auto load = [weak, url, spilledUntil, spilledCount](auto done) {
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            done();
+            return;
+        }
 
-            auto root = result.parseJson();
-            auto messages = parseRecentMessages(root, shared);
+        NetworkRequest(url)
+            .concurrent()
+            .onSuccess([weak, done, lastDate = shared->lastDate_, spilledUntil,
+                        spilledCount](NetworkResult result) -> Outcome {
+                auto shared = weak.lock();
+                if (!shared)
+                {
+                    postToThread(done);
+                    return Failure;
+                }
 
-            auto &handler = IrcMessageHandler::instance();
+                RecentMessagesHandler handler;
+                rapidjson::Reader reader;
+                rapidjson::StringStream stream(result.getData().constData());
+                reader.Parse(stream, handler);
 
-            std::vector<MessagePtr> allBuiltMessages;
+                auto &messages = handler.messages;
 
-            for (auto message : messages)
-            {
-                if (message->tags().contains("rm-received-ts"))
+                if (spilledUntil > 0)
                 {
-                    QDate msgDate = QDateTime::fromMSecsSinceEpoch(
-                                        message->tags()
-                                            .value("rm-received-ts")
-                                            .toLongLong())
-                                        .date();
-                    if (msgDate != shared.get()->lastDate_)
-                    {
-                        shared.get()->lastDate_ = msgDate;
-                        auto msg = makeSystemMessage(
-                            QLocale().toString(msgDate, QLocale::LongFormat),
-                            QTime(0, 0));
-                        msg->flags.set(MessageFlag::RecentMessage);
-                        allBuiltMessages.emplace_back(msg);
-                    }
+                    // the older messages were kept from the last session
+                    messages.erase(
+                        std::remove_if(messages.begin(), messages.end(),
+                                       [spilledUntil](const auto &message) {
+                                           return receivedTime(*message) <=
+                                                  spilledUntil;
+                                       }),
+                        messages.end());
+
+                    appendMissedHistory(
+                        shared, messages, lastDate, spilledCount,
+                        "There may be gaps in the message history since the "
+                        "last session.");
+                    postToThread(done);
+                    return Success;
                 }
 
-                for (auto builtMessage :
-                     handler.parseMessage(shared.get(), message))
-                {
-                    builtMessage->flags.set(MessageFlag::RecentMessage);
-                    allBuiltMessages.emplace_back(builtMessage);
-                }
-            }
+                auto currentDate =
+                    addHistoryAtStart(shared, messages, lastDate);
 
-            postToThread([this, shared, root,
-                          messages = std::move(allBuiltMessages)]() mutable {
-                shared->addMessagesAtStart(messages);
+                postToThread([shared, done, currentDate,
+                              errorCode = std::move(handler.errorCode),
+                              hasMessages = !messages.empty()] {
+                    shared->lastDate_ = currentDate;
 
-                // Notify user about a possible gap in logs if it returned some messages
-                // but isn't currently joined to a channel
-                if (QString errorCode = root.value("error_code").toString();
-                    !errorCode.isEmpty())
-                {
-                    qCDebug(chatterinoTwitch)
-                        << QString("rm error_code=%1, channel=%2")
-                               .arg(errorCode, this->getName());
-                    if (errorCode == "channel_not_joined" && !messages.empty())
+                    // Notify user about a possible gap in logs if it returned
+                    // some messages but isn't currently joined to a channel
+                    if (!errorCode.isEmpty())
                     {
-                        shared->addMessage(makeSystemMessage(
-                            "Message history service recovering, there may be "
-                            "gaps in the message history."));
+                        qCDebug(chatterinoTwitch)
+                            << QString("rm error_code=%1, channel=%2")
+                                   .arg(errorCode, shared->getName());
+                        if (errorCode == "channel_not_joined" && hasMessages)
+                        {
+                            shared->addMessage(makeSystemMessage(
+                                "Message history service recovering, there "
+                                "may be gaps in the message history."));
+                        }
                     }
+
+                    done();
+                });
+
+                return Success;
+            })
+            .onError([weak, done](NetworkResult result) {
+                done();
+
+                auto shared = weak.lock();
+                if (!shared)
+                    return;
+
+                shared->addMessage(makeSystemMessage(
+                    QString("Message history service unavailable (Error %1)")
+                        .arg(result.status())));
+
+                if (getSettings()->logCompressed)
+                {
+                    QtConcurrent::run([weak] {
+                        auto shared = weak.lock();
+                        if (!shared)
+                            return;
+
+                        auto to = Logging::sessionStart();
+                        auto messages = Logging::loadHistory(
+                            shared->getName(), to.addDays(-1), to, {},
+                            size_t(getSettings()->twitchMessageHistoryLimit));
+
+                        postToThread([shared, messages = std::move(messages)] {
+                            shared->addMessagesAtStart(messages);
+                        });
+                    });
                 }
-            });
+            })
+            .execute();
+    };
 
-            return Success;
-        })
-        .onError([weak](NetworkResult result) {
+    ChannelLoadScheduler::instance().enqueue(
+        ChannelLoadScheduler::Resource::History,
+        getApp()->windows->loadPriority(this), std::move(load));
+}
+
+void TwitchChannel::loadSpilledHistory()
+{
+    auto *spill = getApp()->twitch->historySpill();
+    if (spill == nullptr)
+    {
+        this->loadRecentMessages();
+        return;
+    }
+
+    auto limit = size_t(getSettings()->twitchMessageHistoryLimit.getValue());
+
+    QtConcurrent::run([weak = weakOf<Channel>(this), spill,
+                       name = this->getName(), lastDate = this->lastDate_,
+                       limit] {
+        // lines of this session are already in the channel
+        auto lines = spill->load(
+            name, Logging::sessionStart().toMSecsSinceEpoch(), limit);
+
+        auto shared = weak.lock();
+        if (!shared)
+        {
+            return;
+        }
+
+        std::vector<std::unique_ptr<Communi::IrcMessage>> messages;
+        messages.reserve(lines.size());
+        for (const auto &line : lines)
+        {
+            messages.push_back(parseRecentMessage(QString::fromUtf8(line)));
+        }
+
+        auto until = messages.empty() ? 0 : receivedTime(*messages.back());
+        auto date = addHistoryAtStart(shared, messages, lastDate);
+
+        postToThread([weak, until, date] {
             auto shared = weak.lock();
             if (!shared)
+            {
                 return;
+            }
 
-            shared->addMessage(makeSystemMessage(
-                QString("Message history service unavailable (Error %1)")
-                    .arg(result.status())));
-        })
-        .execute();
+            auto *channel = static_cast<TwitchChannel *>(shared.get());
+            if (until > 0)
+            {
+                channel->lastDate_ = date;
+                channel->spilledUntil_ = until;
+                channel->spilledCount_ = channel->addedMessageCount();
+            }
+            channel->loadRecentMessages();
+        });
+    });
 }
 
 void TwitchChannel::refreshPubsub()
@@ -859,10 +1470,34 @@ void TwitchChannel::refreshPubsub()
     getApp()->twitch->pubsub->listenToChannelPointRewards(roomId, account);
 }
 
+void TwitchChannel::refreshChattersForCompletion()
+{
+    if (this->dormant_ ||
+        (this->chattersRefreshedTimer_.isValid() &&
+         this->chattersRefreshedTimer_.elapsed() <
+             CHATTERS_COMPLETION_REFRESH_AGE))
+    {
+        return;
+    }
+
+    this->refreshChatters();
+}
+
 void TwitchChannel::refreshChatters()
 {
-    // setting?
+    if (this->dormant_)
+    {
+        return;
+    }
+
     const auto streamStatus = this->accessStreamStatus();
+
+    // the next refresh, also if this one is skipped
+    this->chattersListTimer_.start(
+        chattersRefreshInterval(this->chatterCount_, streamStatus->live));
+    this->chattersRefreshedTimer_.restart();
+
+    // setting?
     const auto viewerCount = static_cast<int>(streamStatus->viewerCount);
     if (getSettings()->onlyFetchChattersForSmallerStreamers)
     {
@@ -886,10 +1521,12 @@ void TwitchChannel::refreshChatters()
                     return Failure;
                 }
 
-                auto data = result.parseJson();
-                this->chatterCount_ = data.value("chatter_count").toInt();
+                // the lists of big channels are megabytes
+                JsonDocument document(result.getData());
+                this->chatterCount_ =
+                    rj::integer(document.root(), "chatter_count");
 
-                auto pair = parseChatters(std::move(data));
+                auto pair = parseChatters(document.root());
                 if (pair.first)
                 {
                     this->updateOnlineChatters(pair.second);
@@ -902,7 +1539,7 @@ void TwitchChannel::refreshChatters()
 
 void TwitchChannel::fetchDisplayName()
 {
-    getHelix()->getUserByName(
+    HelixBatcher::instance().getUserByName(
         this->getName(),
         [weak = weakOf<Channel>(this)](const auto &user) {
             auto shared = weak.lock();
@@ -927,19 +1564,20 @@ void TwitchChannel::fetchDisplayName()
         [] {});
 }
 
-void TwitchChannel::refreshBadges()
+void TwitchChannel::refreshBadges(std::shared_ptr<void> loadGuard)
 {
     auto url = Url{"https://badges.twitch.tv/v1/badges/channels/" +
                    this->roomId() + "/display?language=en"};
     NetworkRequest(url.string)
+        .cache(BADGES_TTL)
 
-        .onSuccess([this,
-                    weak = weakOf<Channel>(this)](auto result) -> Outcome {
+        .onSuccess([this, weak = weakOf<Channel>(this),
+                    loadGuard = std::move(loadGuard)](auto result) -> Outcome {
             auto shared = weak.lock();
             if (!shared)
                 return Failure;
 
-            auto badgeSets = this->badgeSets_.access();
+            auto badges = std::make_shared<BadgeTable>();
 
             auto jsonRoot = result.parseJson();
 
@@ -947,8 +1585,6 @@ void TwitchChannel::refreshBadges()
             for (auto jsonBadgeSet = _.begin(); jsonBadgeSet != _.end();
                  jsonBadgeSet++)
             {
-                auto &versions = (*badgeSets)[jsonBadgeSet.key()];
-
                 auto _set = jsonBadgeSet->toObject()["versions"].toObject();
                 for (auto jsonVersion_ = _set.begin();
                      jsonVersion_ != _set.end(); jsonVersion_++)
@@ -966,20 +1602,25 @@ void TwitchChannel::refreshBadges()
                         Tooltip{jsonVersion["description"].toString()},
                         Url{jsonVersion["clickURL"].toString()}});
 
-                    versions.emplace(jsonVersion_.key(), emote);
+                    auto token = Badge::makeToken(jsonBadgeSet.key(),
+                                                  jsonVersion_.key());
+                    badges->emplace(token, emote);
                 };
             }
 
+            this->channelBadges_.set(std::move(badges));
+            this->mergeBadges(TwitchBadges::instance()->table());
+
             return Success;
         })
         .execute();
 }
 
-void TwitchChannel::refreshCheerEmotes()
+void TwitchChannel::refreshCheerEmotes(std::shared_ptr<void> loadGuard)
 {
     getHelix()->getCheermotes(
         this->roomId(),
-        [this, weak = weakOf<Channel>(this)](
+        [this, weak = weakOf<Channel>(this), loadGuard = std::move(loadGuard)](
             const std::vector<HelixCheermoteSet> &cheermoteSets) -> Outcome {
             auto shared = weak.lock();
             if (!shared)
@@ -987,14 +1628,12 @@ void TwitchChannel::refreshCheerEmotes()
                 return Failure;
             }
 
-            std::vector<CheerEmoteSet> emoteSets;
+            CheerEmotes cheerEmotes;
 
             for (const auto &set : cheermoteSets)
             {
                 auto cheerEmoteSet = CheerEmoteSet();
-                cheerEmoteSet.regex = QRegularExpression(
-                    "^" + set.prefix + "([1-9][0-9]*)$",
-                    QRegularExpression::CaseInsensitiveOption);
+                cheerEmoteSet.prefix = set.prefix;
 
                 for (const auto &tier : set.tiers)
                 {
@@ -1002,7 +1641,6 @@ void TwitchChannel::refreshCheerEmotes()
 
                     cheerEmote.color = QColor(tier.color);
                     cheerEmote.minBits = tier.minBits;
-                    cheerEmote.regex = cheerEmoteSet.regex;
 
                     // TODO(pajlada): We currently hardcode dark here :|
                     // We will continue to do so for now since we haven't had to
@@ -1039,10 +1677,10 @@ void TwitchChannel::refreshCheerEmotes()
                               return lhs.minBits > rhs.minBits;
                           });
 
-                emoteSets.emplace_back(std::move(cheerEmoteSet));
+                cheerEmotes.add(std::move(cheerEmoteSet));
             }
 
-            *this->cheerEmoteSets_.access() = std::move(emoteSets);
+            *this->cheerEmotes_.access() = std::move(cheerEmotes);
 
             return Success;
         },
@@ -1165,20 +1803,48 @@ void TwitchChannel::createClip()
         });
 }
 
-boost::optional<EmotePtr> TwitchChannel::twitchBadge(
-    const QString &set, const QString &version) const
+boost::optional<EmotePtr> TwitchChannel::twitchBadge(const Badge &badge) const
 {
-    auto badgeSets = this->badgeSets_.access();
-    auto it = badgeSets->find(set);
-    if (it != badgeSets->end())
+    auto merged = std::atomic_load(&this->mergedBadges_);
+    auto global = TwitchBadges::instance()->table();
+
+    // either of the tables changed since they were merged
+    if (!merged || merged->global != global ||
+        merged->channel != this->channelBadges_.get())
     {
-        auto it2 = it->second.find(version);
-        if (it2 != it->second.end())
+        merged = this->mergeBadges(std::move(global));
+    }
+
+    auto it = merged->badges.find(badge.token_);
+    if (it != merged->badges.end())
+    {
+        return it->second;
+    }
+    return boost::none;
+}
+
+std::shared_ptr<const TwitchChannel::MergedBadges> TwitchChannel::mergeBadges(
+    std::shared_ptr<const BadgeTable> global) const
+{
+    auto merged = std::make_shared<MergedBadges>();
+    merged->channel = this->channelBadges_.get();
+    merged->global = std::move(global);
+
+    if (merged->global)
+    {
+        merged->badges = *merged->global;
+    }
+    if (merged->channel)
+    {
+        for (const auto &badge : *merged->channel)
         {
-            return it2->second;
+            merged->badges[badge.first] = badge.second;
         }
     }
-    return boost::none;
+
+    std::shared_ptr<const MergedBadges> published = std::move(merged);
+    std::atomic_store(&this->mergedBadges_, published);
+    return published;
 }
 
 boost::optional<EmotePtr> TwitchChannel::ffzCustomModBadge() const
@@ -1191,31 +1857,13 @@ boost::optional<EmotePtr> TwitchChannel::ffzCustomVipBadge() const
     return this->ffzCustomVipBadge_.get();
 }
 
-boost::optional<CheerEmote> TwitchChannel::cheerEmote(const QString &string)
+boost::optional<CheerEmote> TwitchChannel::cheerEmote(const QString &string,
+                                                      int &bits)
 {
-    auto sets = this->cheerEmoteSets_.access();
-    for (const auto &set : *sets)
+    auto cheerEmotes = this->cheerEmotes_.access();
+    if (const auto *emote = cheerEmotes->find(string, bits))
     {
-        auto match = set.regex.match(string);
-        if (!match.hasMatch())
-        {
-            continue;
-        }
-        QString amount = match.captured(1);
-        bool ok = false;
-        int bitAmount = amount.toInt(&ok);
-        if (!ok)
-        {
-            qCDebug(chatterinoTwitch)
-                << "Error parsing bit amount in cheerEmote";
-        }
-        for (const auto &emote : set.cheerEmotes)
-        {
-            if (bitAmount >= emote.minBits)
-            {
-                return emote;
-            }
-        }
+        return *emote;
     }
     return boost::none;
 }
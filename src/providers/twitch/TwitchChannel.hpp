@@ -8,6 +8,8 @@
 #include "common/Outcome.hpp"
 #include "common/UniqueAccess.hpp"
 #include "providers/twitch/ChannelPointReward.hpp"
+#include "providers/twitch/PendingRedemptions.hpp"
+#include "providers/twitch/TwitchBadge.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
 #include "providers/twitch/api/Helix.hpp"
 #include "util/QStringHash.hpp"
@@ -18,6 +20,8 @@
 #include <boost/optional.hpp>
 #include <pajlada/signals/signalholder.hpp>
 
+#include <atomic>
+#include <deque>
 #include <mutex>
 #include <unordered_map>
 
@@ -44,6 +48,7 @@ enum class HighlightState;
 struct Emote;
 using EmotePtr = std::shared_ptr<const Emote>;
 class EmoteMap;
+class ChannelEmoteIndex;
 
 class TwitchBadges;
 class FfzEmotes;
@@ -73,6 +78,8 @@ public:
         int slowMode = 0;
     };
 
+    ~TwitchChannel() override;
+
     void initialize();
 
     // Channel methods
@@ -89,11 +96,30 @@ public:
     void refreshTitle();
     void createClip();
 
+    /**
+     * Dormant channels are only shown in tabs that aren't selected, see
+     * WindowManager::updateDormantChannels. Instead of building messages they
+     * keep the raw IRC lines they receive, and they don't poll Helix. Waking
+     * up replays the kept lines.
+     */
+    bool isDormant() const;
+    void setDormant(bool dormant);
+    void keepDormantLine(QByteArray line);
+    /// Dormant, or loading the messages missed while it was disconnected.
+    /// The lines it receives meanwhile are kept like dormant ones.
+    bool keepsLines() const;
+
+    /// Called once the channel is joined, loads the messages it missed while
+    /// its connection was lost from the recent-messages API
+    void loadMissedMessages();
+
     // Data
     const QString &subscriptionUrl();
     const QString &channelUrl();
     const QString &popoutPlayerUrl();
     int chatterCount();
+    // Refreshes the chatter list sooner if it is used for a completion
+    void refreshChattersForCompletion();
     virtual bool isLive() const override;
     QString roomId() const;
     SharedAccessGuard<const RoomModes> accessRoomModes() const;
@@ -104,6 +130,8 @@ public:
     boost::optional<EmotePtr> ffzEmote(const EmoteName &name) const;
     std::shared_ptr<const EmoteMap> bttvEmotes() const;
     std::shared_ptr<const EmoteMap> ffzEmotes() const;
+    /// Channel and global third party emotes merged into one index
+    std::shared_ptr<const ChannelEmoteIndex> emoteIndex() const;
 
     virtual void refreshBTTVChannelEmotes(bool manualRefresh);
     virtual void refreshFFZChannelEmotes(bool manualRefresh);
@@ -111,11 +139,14 @@ public:
     // Badges
     boost::optional<EmotePtr> ffzCustomModBadge() const;
     boost::optional<EmotePtr> ffzCustomVipBadge() const;
-    boost::optional<EmotePtr> twitchBadge(const QString &set,
-                                          const QString &version) const;
+    /// The badge of the channel, or the global one if the channel doesn't
+    /// override it
+    boost::optional<EmotePtr> twitchBadge(const Badge &badge) const;
 
     // Cheers
-    boost::optional<CheerEmote> cheerEmote(const QString &string);
+    /// Finds the cheermote for a word like "Cheer100" and sets bits to its
+    /// amount
+    boost::optional<CheerEmote> cheerEmote(const QString &string, int &bits);
 
     // Signals
     pajlada::Signals::NoArgSignal roomIdChanged;
@@ -124,12 +155,17 @@ public:
     pajlada::Signals::NoArgSignal roomModesChanged;
 
     // Channel point rewards
-    pajlada::Signals::SelfDisconnectingSignal<ChannelPointReward>
-        channelPointRewardAdded;
     void addChannelPointReward(const ChannelPointReward &reward);
-    bool isChannelPointRewardKnown(const QString &rewardId);
+    /// Can be called from any thread
+    bool isChannelPointRewardKnown(const QString &rewardId) const;
+    /// Can be called from any thread
     boost::optional<ChannelPointReward> channelPointReward(
         const QString &rewardId) const;
+    /// Runs callback with true once the reward is known, right away if it
+    /// already is, or with false if it didn't arrive in time. Gui thread
+    /// only.
+    void waitForChannelPointReward(const QString &rewardId,
+                                   PendingRedemptions::Callback callback);
 
 private:
     struct NameOptions {
@@ -142,13 +178,23 @@ protected:
 
 private:
     // Methods
-    void refreshLiveStatus();
+    void watchLiveStatus();
     void parseLiveStatus(bool live, const HelixStream &stream);
     void refreshPubsub();
     void refreshChatters();
-    void refreshBadges();
-    void refreshCheerEmotes();
+    // Queues the loads that need the room id, see ChannelLoadScheduler
+    void scheduleRoomLoads();
+    // loadGuard is held until the request finished
+    void loadBTTVChannelEmotes(bool manualRefresh,
+                               std::shared_ptr<void> loadGuard);
+    void loadFFZChannelEmotes(bool manualRefresh,
+                              std::shared_ptr<void> loadGuard);
+    void refreshBadges(std::shared_ptr<void> loadGuard = nullptr);
+    void refreshCheerEmotes(std::shared_ptr<void> loadGuard = nullptr);
     void loadRecentMessages();
+    // Adds the history kept from the last session, then loads the recent
+    // messages that were missed since
+    void loadSpilledHistory();
     void fetchDisplayName();
 
     void setLive(bool newLiveStatus);
@@ -167,34 +213,66 @@ private:
     const QString subscriptionUrl_;
     const QString channelUrl_;
     const QString popoutPlayerUrl_;
-    int chatterCount_;
+    int chatterCount_ = 0;
     UniqueAccess<StreamStatus> streamStatus_;
     UniqueAccess<RoomModes> roomModes_;
 
 protected:
     Atomic<std::shared_ptr<const EmoteMap>> bttvEmotes_;
     Atomic<std::shared_ptr<const EmoteMap>> ffzEmotes_;
+    mutable Atomic<std::shared_ptr<const ChannelEmoteIndex>> emoteIndex_;
     Atomic<boost::optional<EmotePtr>> ffzCustomModBadge_;
     Atomic<boost::optional<EmotePtr>> ffzCustomVipBadge_;
 
 private:
     // Badges
-    UniqueAccess<std::map<QString, std::map<QString, EmotePtr>>>
-        badgeSets_;  // "subscribers": { "0": ... "3": ... "6": ...
-    UniqueAccess<std::vector<CheerEmoteSet>> cheerEmoteSets_;
-    UniqueAccess<std::map<QString, ChannelPointReward>> channelPointRewards_;
-
-    bool mod_ = false;
-    bool vip_ = false;
-    bool staff_ = false;
+    struct MergedBadges {
+        // the tables the badges were merged from
+        std::shared_ptr<const BadgeTable> channel;
+        std::shared_ptr<const BadgeTable> global;
+        BadgeTable badges;
+    };
+    std::shared_ptr<const MergedBadges> mergeBadges(
+        std::shared_ptr<const BadgeTable> global) const;
+
+    Atomic<std::shared_ptr<const BadgeTable>> channelBadges_;
+    mutable std::shared_ptr<const MergedBadges> mergedBadges_;
+    UniqueAccess<CheerEmotes> cheerEmotes_;
+    // replaced as a whole when a reward is added, so lookups from the
+    // builders only hold the lock while they copy the pointer
+    Atomic<std::shared_ptr<
+        const std::unordered_map<QString, ChannelPointReward>>>
+        channelPointRewards_;
+    PendingRedemptions pendingRedemptions_;
+
+    // read by the message builder on the thread pool
+    std::atomic<bool> mod_{false};
+    std::atomic<bool> vip_{false};
+    std::atomic<bool> staff_{false};
     UniqueAccess<QString> roomID_;
 
     // --
     QString lastSentMessage_;
     QObject lifetimeGuard_;
-    QTimer liveStatusTimer_;
     QTimer chattersListTimer_;
+    bool dormant_ = false;
+    std::deque<QByteArray> dormantLines_;
+    // the history gets loaded once the channel wakes up, it contains the
+    // dormant lines as well
+    bool loadHistoryOnWake_ = false;
+    // the history of the last session is only loaded once
+    bool spillLoaded_ = false;
+    // received time of the newest message of the last session and the
+    // amount of messages added when its history was added, 0 if the next
+    // load doesn't continue it
+    qint64 spilledUntil_ = 0;
+    int64_t spilledCount_ = 0;
+    // the last message received before the connection was lost, in ms since
+    // the epoch, 0 if it wasn't lost since the channel was joined
+    qint64 missedSince_ = 0;
+    bool loadingMissed_ = false;
     QElapsedTimer titleRefreshedTimer_;
+    QElapsedTimer chattersRefreshedTimer_;
     QElapsedTimer clipCreationTimer_;
     bool isClipCreationInProgress{false};
 
@@ -1,22 +1,42 @@
 #include "providers/twitch/TwitchEmotes.hpp"
 
 #include "common/NetworkRequest.hpp"
+#include "common/QLogging.hpp"
 #include "debug/Benchmark.hpp"
 #include "messages/Emote.hpp"
 #include "messages/Image.hpp"
+#include "util/DebugCount.hpp"
 #include "util/RapidjsonHelpers.hpp"
 
+#include <array>
+
 namespace chatterino {
 
+namespace {
+
+    DebugCounter cacheEntries("twitch emote cache entries");
+
+    // The same emotes are looked up over and over, so every thread first
+    // looks in a small table of its own and only locks a shard of the cache
+    // if the emote isn't there. Slots are picked by the hash of the id, a
+    // newer emote simply replaces the one in its slot.
+    struct RecentEmote {
+        const TwitchEmotes *owner = nullptr;
+        EmoteId id;
+        std::weak_ptr<const Emote> emote;
+    };
+    constexpr size_t RECENT_EMOTE_SLOTS = 256;
+    thread_local std::array<RecentEmote, RECENT_EMOTE_SLOTS> recentEmotes;
+
+}  // namespace
+
 TwitchEmotes::TwitchEmotes()
+    : twitchEmotesCache_(cacheEntries)
 {
 }
 
 QString TwitchEmotes::cleanUpEmoteCode(const QString &dirtyEmoteCode)
 {
-    auto cleanCode = dirtyEmoteCode;
-    cleanCode.detach();
-
     static QMap<QString, QString> emoteNameReplacements{
         {"[oO](_|\\.)[oO]", "O_o"}, {"\\&gt\\;\\(", "&gt;("},
         {"\\&lt\\;3", "&lt;3"},     {"\\:-?(o|O)", ":O"},
@@ -30,10 +50,10 @@ QString TwitchEmotes::cleanUpEmoteCode(const QString &dirtyEmoteCode)
     auto it = emoteNameReplacements.find(dirtyEmoteCode);
     if (it != emoteNameReplacements.end())
     {
-        cleanCode = it.value();
+        return it.value();
     }
 
-    return cleanCode;
+    return dirtyEmoteCode;
 }
 
 // id is used for lookup
@@ -41,26 +61,35 @@ QString TwitchEmotes::cleanUpEmoteCode(const QString &dirtyEmoteCode)
 EmotePtr TwitchEmotes::getOrCreateEmote(const EmoteId &id,
                                         const EmoteName &name_)
 {
-    auto name = TwitchEmotes::cleanUpEmoteCode(name_.string);
+    auto &recent = recentEmotes[std::hash<EmoteId>()(id) % RECENT_EMOTE_SLOTS];
+    if (recent.owner == this && recent.id == id)
+    {
+        if (auto emote = recent.emote.lock())
+        {
+            return emote;
+        }
+    }
 
     // search in cache or create new emote
-    auto cache = this->twitchEmotesCache_.access();
-    auto shared = (*cache)[id].lock();
+    auto emote = this->twitchEmotesCache_.getOrCreate(id, [&] {
+        // the name and urls are only made for emotes that aren't cached
+        auto name = TwitchEmotes::cleanUpEmoteCode(name_.string);
+        // all twitch emotes are 28x28 at 1x
+        const QSize size(28, 28);
 
-    if (!shared)
-    {
-        (*cache)[id] = shared = std::make_shared<Emote>(Emote{
+        return std::make_shared<const Emote>(Emote{
             EmoteName{name},
             ImageSet{
-                Image::fromUrl(getEmoteLink(id, "1.0"), 1),
-                Image::fromUrl(getEmoteLink(id, "2.0"), 0.5),
-                Image::fromUrl(getEmoteLink(id, "3.0"), 0.25),
+                Image::fromUrl(getEmoteLink(id, "1.0"), 1, size),
+                Image::fromUrl(getEmoteLink(id, "2.0"), 0.5, size),
+                Image::fromUrl(getEmoteLink(id, "3.0"), 0.25, size),
             },
             Tooltip{name.toHtmlEscaped() + "<br>Twitch Emote"},
         });
-    }
+    });
 
-    return shared;
+    recent = {this, id, emote};
+    return emote;
 }
 
 Url TwitchEmotes::getEmoteLink(const EmoteId &id, const QString &emoteScale)
@@ -70,4 +99,69 @@ Url TwitchEmotes::getEmoteLink(const EmoteId &id, const QString &emoteScale)
                 .replace("{scale}", emoteScale)};
 }
 
+void CheerEmotes::add(CheerEmoteSet &&set)
+{
+    // the first set of a prefix wins, like the first matching regex did
+    this->byPrefix_.emplace(set.prefix.toLower(), this->sets_.size());
+    this->sets_.emplace_back(std::move(set));
+}
+
+const CheerEmote *CheerEmotes::find(const QString &word, int &bits) const
+{
+    auto isDigit = [](QChar c) {
+        return c >= '0' && c <= '9';
+    };
+
+    int digits = word.size();
+    while (digits > 0 && isDigit(word[digits - 1]))
+    {
+        digits--;
+    }
+    if (digits == word.size())
+    {
+        return nullptr;
+    }
+
+    // prefixes can end with digits, so each start of the amount within the
+    // digits is tried, the earliest set wins
+    const CheerEmoteSet *found = nullptr;
+    int amountStart = 0;
+    for (int split = std::max(digits, 1); split < word.size(); split++)
+    {
+        if (word[split] == '0')
+        {
+            continue;
+        }
+
+        auto it = this->byPrefix_.find(word.left(split).toLower());
+        if (it != this->byPrefix_.end() &&
+            (found == nullptr || &this->sets_[it->second] < found))
+        {
+            found = &this->sets_[it->second];
+            amountStart = split;
+        }
+    }
+    if (found == nullptr)
+    {
+        return nullptr;
+    }
+
+    bool ok = false;
+    bits = word.midRef(amountStart).toInt(&ok);
+    if (!ok)
+    {
+        qCDebug(chatterinoTwitch) << "Error parsing bit amount in cheerEmote";
+        return nullptr;
+    }
+
+    for (const auto &emote : found->cheerEmotes)
+    {
+        if (bits >= emote.minBits)
+        {
+            return &emote;
+        }
+    }
+    return nullptr;
+}
+
 }  // namespace chatterino
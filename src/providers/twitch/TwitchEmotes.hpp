@@ -6,9 +6,11 @@
 #include <unordered_map>
 
 #include "common/Aliases.hpp"
-#include "common/UniqueAccess.hpp"
+#include "util/QStringHash.hpp"
+#include "util/WeakCache.hpp"
 
 #include <memory>
+#include <vector>
 
 // NB: "default" can be replaced with "static" to always get a non-animated
 // variant
@@ -22,17 +24,34 @@ using EmotePtr = std::shared_ptr<const Emote>;
 struct CheerEmote {
     QColor color;
     int minBits;
-    QRegularExpression regex;
 
     EmotePtr animatedEmote;
     EmotePtr staticEmote;
 };
 
 struct CheerEmoteSet {
-    QRegularExpression regex;
+    QString prefix;
+    /// Sorted by their minBits, highest first
     std::vector<CheerEmote> cheerEmotes;
 };
 
+/// The cheermote sets of a channel with a table of their lowercase prefixes
+class CheerEmotes
+{
+public:
+    void add(CheerEmoteSet &&set);
+
+    /// Finds the cheermote for a word like "Cheer100", the prefix is case
+    /// insensitive and the amount must not start with 0. Sets bits to the
+    /// amount. Returns nullptr if the word isn't a cheer.
+    const CheerEmote *find(const QString &word, int &bits) const;
+
+private:
+    std::vector<CheerEmoteSet> sets_;
+    // index of the set in sets_, by its lowercase prefix
+    std::unordered_map<QString, size_t> byPrefix_;
+};
+
 class TwitchEmotes
 {
 public:
@@ -43,8 +62,7 @@ public:
 
 private:
     Url getEmoteLink(const EmoteId &id, const QString &emoteScale);
-    UniqueAccess<std::unordered_map<EmoteId, std::weak_ptr<Emote>>>
-        twitchEmotesCache_;
+    WeakCache<EmoteId, const Emote> twitchEmotesCache_;
 
     std::mutex mutex_;
 };
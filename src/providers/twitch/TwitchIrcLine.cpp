@@ -0,0 +1,235 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <cstring>
+
+namespace chatterino {
+
+TwitchIrcLine::TwitchIrcLine(QByteArray data)
+    : data_(std::move(data))
+{
+}
+
+boost::optional<TwitchIrcLine> TwitchIrcLine::parse(QByteArray line)
+{
+    TwitchIrcLine result(std::move(line));
+
+    const char *data = result.data_.constData();
+    int size = result.data_.size();
+    while (size > 0 && (data[size - 1] == '\r' || data[size - 1] == '\n'))
+    {
+        size--;
+    }
+
+    int i = 0;
+    auto skipSpaces = [&] {
+        while (i < size && data[i] == ' ')
+        {
+            i++;
+        }
+    };
+    // the span from i up to the next space
+    auto word = [&] {
+        Span span{i, 0};
+        while (i < size && data[i] != ' ')
+        {
+            i++;
+        }
+        span.length = i - span.start;
+        return span;
+    };
+
+    // @key=value;key2=value2
+    if (i < size && data[i] == '@')
+    {
+        i++;
+        while (i < size && data[i] != ' ')
+        {
+            Tag tag;
+            tag.key.start = i;
+            while (i < size && data[i] != '=' && data[i] != ';' &&
+                   data[i] != ' ')
+            {
+                i++;
+            }
+            tag.key.length = i - tag.key.start;
+
+            if (i < size && data[i] == '=')
+            {
+                i++;
+                tag.value.start = i;
+                while (i < size && data[i] != ';' && data[i] != ' ')
+                {
+                    i++;
+                }
+                tag.value.length = i - tag.value.start;
+            }
+
+            if (tag.key.length > 0)
+            {
+                result.tags_.push_back(tag);
+            }
+            if (i < size && data[i] == ';')
+            {
+                i++;
+            }
+        }
+        skipSpaces();
+    }
+
+    // :nick!user@host
+    if (i < size && data[i] == ':')
+    {
+        i++;
+        result.prefix_ = word();
+        skipSpaces();
+    }
+
+    result.command_ = word();
+    if (result.command_.length == 0)
+    {
+        return boost::none;
+    }
+
+    while (true)
+    {
+        skipSpaces();
+        if (i >= size)
+        {
+            break;
+        }
+
+        // the trailing parameter takes the rest of the line
+        if (data[i] == ':')
+        {
+            result.params_.push_back({i + 1, size - i - 1});
+            break;
+        }
+        result.params_.push_back(word());
+    }
+
+    return result;
+}
+
+const QByteArray &TwitchIrcLine::data() const
+{
+    return this->data_;
+}
+
+QByteArray TwitchIrcLine::command() const
+{
+    return this->data_.mid(this->command_.start, this->command_.length);
+}
+
+bool TwitchIrcLine::isCommand(QLatin1String command) const
+{
+    return this->equals(this->command_, command);
+}
+
+QString TwitchIrcLine::nick() const
+{
+    const char *data = this->data_.constData() + this->prefix_.start;
+    int length = 0;
+    while (length < this->prefix_.length && data[length] != '!' &&
+           data[length] != '@')
+    {
+        length++;
+    }
+    return QString::fromUtf8(data, length);
+}
+
+int TwitchIrcLine::parameterCount() const
+{
+    return int(this->params_.size());
+}
+
+QString TwitchIrcLine::parameter(int index) const
+{
+    if (index < 0 || index >= this->parameterCount())
+    {
+        return {};
+    }
+
+    const auto &span = this->params_[size_t(index)];
+    return QString::fromUtf8(this->data_.constData() + span.start,
+                             span.length);
+}
+
+bool TwitchIrcLine::hasTag(QLatin1String key) const
+{
+    return this->findTag(key) != nullptr;
+}
+
+QString TwitchIrcLine::tag(QLatin1String key) const
+{
+    if (const auto *tag = this->findTag(key))
+    {
+        return this->decode(tag->value);
+    }
+    return {};
+}
+
+bool TwitchIrcLine::equals(const Span &span, QLatin1String text) const
+{
+    return span.length == text.size() &&
+           std::memcmp(this->data_.constData() + span.start, text.data(),
+                       size_t(span.length)) == 0;
+}
+
+QString TwitchIrcLine::decode(const Span &span) const
+{
+    const char *data = this->data_.constData() + span.start;
+    if (std::memchr(data, '\\', size_t(span.length)) == nullptr)
+    {
+        return QString::fromUtf8(data, span.length);
+    }
+
+    // see https://ircv3.net/specs/extensions/message-tags#escaping-values
+    QByteArray unescaped;
+    unescaped.reserve(span.length);
+    for (int i = 0; i < span.length; i++)
+    {
+        if (data[i] != '\\')
+        {
+            unescaped += data[i];
+            continue;
+        }
+
+        // a trailing backslash is dropped
+        if (++i == span.length)
+        {
+            break;
+        }
+        switch (data[i])
+        {
+            case ':':
+                unescaped += ';';
+                break;
+            case 's':
+                unescaped += ' ';
+                break;
+            case 'r':
+                unescaped += '\r';
+                break;
+            case 'n':
+                unescaped += '\n';
+                break;
+            default:
+                unescaped += data[i];
+        }
+    }
+    return QString::fromUtf8(unescaped);
+}
+
+const TwitchIrcLine::Tag *TwitchIrcLine::findTag(QLatin1String key) const
+{
+    for (const auto &tag : this->tags_)
+    {
+        if (this->equals(tag.key, key))
+        {
+            return &tag;
+        }
+    }
+    return nullptr;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <QByteArray>
+#include <QLatin1String>
+#include <QString>
+#include <boost/container/small_vector.hpp>
+#include <boost/optional.hpp>
+
+namespace chatterino {
+
+/**
+ * @brief A raw IRC line from Twitch, split into its tags, prefix, command and
+ *        parameters in one pass over the UTF-8 data.
+ *
+ * Only the positions of the parts are kept, they're decoded when they're
+ * asked for. Communi messages are QObjects that decode all tags into a
+ * QVariantMap, so lines that are only kept or dropped are looked at with this
+ * before one is made for them.
+ */
+class TwitchIrcLine
+{
+public:
+    /// Returns nothing if line has no command
+    static boost::optional<TwitchIrcLine> parse(QByteArray line);
+
+    const QByteArray &data() const;
+
+    /// e.g. "PRIVMSG" or "001"
+    QByteArray command() const;
+    bool isCommand(QLatin1String command) const;
+
+    /// The nick of the prefix, like "forsen" in
+    /// ":forsen!forsen@forsen.tmi.twitch.tv", or the server name
+    QString nick() const;
+
+    int parameterCount() const;
+    /// Empty if there's no parameter at index
+    QString parameter(int index) const;
+
+    bool hasTag(QLatin1String key) const;
+    /// The unescaped value of the tag, empty if there's no such tag
+    QString tag(QLatin1String key) const;
+
+private:
+    struct Span {
+        int start = 0;
+        int length = 0;
+    };
+    struct Tag {
+        Span key;
+        Span value;
+    };
+
+    explicit TwitchIrcLine(QByteArray data);
+
+    bool equals(const Span &span, QLatin1String text) const;
+    QString decode(const Span &span) const;
+    const Tag *findTag(QLatin1String key) const;
+
+    QByteArray data_;
+    boost::container::small_vector<Tag, 24> tags_;
+    Span prefix_;
+    Span command_;
+    boost::container::small_vector<Span, 4> params_;
+};
+
+}  // namespace chatterino
@@ -8,6 +8,7 @@
 #include "common/Env.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Message.hpp"
 #include "messages/MessageBuilder.hpp"
 #include "providers/twitch/IrcMessageHandler.hpp"
@@ -15,6 +16,10 @@
 #include "providers/twitch/TwitchAccount.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchHelpers.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
+#include "singletons/Paths.hpp"
+#include "singletons/Settings.hpp"
+#include "util/CombinePath.hpp"
 #include "util/PostToThread.hpp"
 
 #include <QMetaEnum>
@@ -25,15 +30,23 @@ using namespace std::chrono_literals;
 namespace chatterino {
 
 TwitchIrcServer::TwitchIrcServer()
-    : whispersChannel(new Channel("/whispers", Channel::Type::TwitchWhispers))
-    , mentionsChannel(new Channel("/mentions", Channel::Type::TwitchMentions))
+    : whispersChannel(std::make_shared<AggregateChannel>(
+          "/whispers", Channel::Type::TwitchWhispers))
+    , mentionsChannel(std::make_shared<AggregateChannel>(
+          "/mentions", Channel::Type::TwitchMentions))
     , watchingChannel(Channel::getEmpty(), Channel::Type::TwitchWatching)
-    , liveChannel(new Channel("/live", Channel::Type::TwitchLive))
+    , liveChannel(std::make_shared<AggregateChannel>("/live",
+                                                     Channel::Type::TwitchLive))
 {
     this->initializeIrc();
 
     this->pubsub = new PubSub;
 
+    this->sendQueueTimer_.setSingleShot(true);
+    QObject::connect(&this->sendQueueTimer_, &QTimer::timeout, this, [this] {
+        this->flushSendQueue();
+    });
+
     // getSettings()->twitchSeperateWriteConnection.connect([this](auto, auto) {
     // this->connect(); },
     //                                                     this->signalHolder_,
@@ -42,12 +55,29 @@ TwitchIrcServer::TwitchIrcServer()
 
 void TwitchIrcServer::initialize(Settings &settings, Paths &paths)
 {
+    this->historySpill_ = std::make_unique<HistorySpill>(
+        combinePath(paths.cacheDirectory(), "history"));
+
     getApp()->accounts->twitch.currentUserChanged.connect([this]() {
+        if (this->reconnectQueued_)
+        {
+            return;
+        }
+        this->reconnectQueued_ = true;
+
         postToThread([this] {
+            this->reconnectQueued_ = false;
             this->connect();
         });
     });
 
+    settings.twitchVerifiedBot.connect(
+        [this](bool verified) {
+            this->setJoinLimit(verified ? JoinQueue::VERIFIED
+                                        : JoinQueue::UNVERIFIED);
+        },
+        this->signalHolder_);
+
     this->bttv.loadEmotes();
     this->ffz.loadEmotes();
 }
@@ -118,9 +148,110 @@ std::shared_ptr<Channel> TwitchIrcServer::createChannel(
 void TwitchIrcServer::privateMessageReceived(
     Communi::IrcPrivateMessage *message)
 {
+    CHATTERINO_TRACE_SCOPE("TwitchIrcServer::privateMessageReceived");
+
+    if (this->keepForDormantChannel(message))
+    {
+        return;
+    }
+
+    this->spillMessage(message->target(), *message);
     IrcMessageHandler::instance().handlePrivMessage(message, *this);
 }
 
+bool TwitchIrcServer::keepForDormantChannel(Communi::IrcMessage *message)
+{
+    auto channel = std::dynamic_pointer_cast<TwitchChannel>(
+        this->getChannelOrEmpty(message->parameter(0)));
+    if (!channel || !channel->keepsLines())
+    {
+        return false;
+    }
+
+    channel->keepDormantLine(message->toData());
+    return true;
+}
+
+bool TwitchIrcServer::keepForDormantChannel(const TwitchIrcLine &line)
+{
+    // the commands the live handlers keep for dormant channels
+    if (!line.isCommand(QLatin1String("PRIVMSG")) &&
+        !line.isCommand(QLatin1String("CLEARCHAT")) &&
+        !line.isCommand(QLatin1String("CLEARMSG")) &&
+        !line.isCommand(QLatin1String("USERNOTICE")))
+    {
+        return false;
+    }
+
+    auto channel = std::dynamic_pointer_cast<TwitchChannel>(
+        this->getChannelOrEmpty(line.parameter(0)));
+    if (!channel || !channel->keepsLines())
+    {
+        return false;
+    }
+
+    channel->keepDormantLine(line.data());
+    return true;
+}
+
+void TwitchIrcServer::onChannelDisconnected(const ChannelPtr &channel,
+                                            IrcConnection *connection)
+{
+    auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
+    // the first loss counts if it's lost again before it's joined
+    if (twitchChannel != nullptr && twitchChannel->missedSince_ == 0)
+    {
+        twitchChannel->missedSince_ = connection->lastReceivedAt();
+    }
+}
+
+HistorySpill *TwitchIrcServer::historySpill()
+{
+    return this->historySpill_.get();
+}
+
+void TwitchIrcServer::spillMessage(const QString &channelName,
+                                   const Communi::IrcMessage &message)
+{
+    if (!this->historySpill_ || !getSettings()->persistMessageHistory)
+    {
+        return;
+    }
+
+    auto name = this->cleanChannelName(channelName);
+    if (!name.isEmpty())
+    {
+        this->historySpill_->append(name, message);
+    }
+}
+
+void TwitchIrcServer::replayLines(const std::deque<QByteArray> &lines)
+{
+    for (const auto &line : lines)
+    {
+        // lines of channels that are dormant again are only kept, they don't
+        // need a Communi message
+        auto parsed = TwitchIrcLine::parse(line);
+        if (!parsed || this->keepForDormantChannel(*parsed))
+        {
+            continue;
+        }
+
+        std::unique_ptr<Communi::IrcMessage> message(
+            Communi::IrcMessage::fromData(line, this->mainReadConnection()));
+
+        if (message->type() == Communi::IrcMessage::Type::Private)
+        {
+            this->privateMessageReceived(
+                static_cast<Communi::IrcPrivateMessage *>(message.get()));
+        }
+        else
+        {
+            this->readConnectionMessageReceived(message.get());
+        }
+    }
+}
+
 void TwitchIrcServer::readConnectionMessageReceived(
     Communi::IrcMessage *message)
 {
@@ -155,17 +286,33 @@ void TwitchIrcServer::readConnectionMessageReceived(
         // Received ROOMSTATE upon JOINing a channel
         handler.handleRoomStateMessage(message);
     }
+    else if ((command == "CLEARCHAT" || command == "CLEARMSG" ||
+              command == "USERNOTICE") &&
+             this->keepForDormantChannel(message))
+    {
+        return;
+    }
     else if (command == "CLEARCHAT")
     {
-        handler.handleClearChatMessage(message);
+        this->spillMessage(message->parameter(0), *message);
+        // these refer to or add chat messages, so they must not overtake the
+        // messages that are still being built
+        handler.handleInOrder(message, [&handler](auto *msg) {
+            handler.handleClearChatMessage(msg);
+        });
     }
     else if (command == "CLEARMSG")
     {
-        handler.handleClearMessageMessage(message);
+        handler.handleInOrder(message, [&handler](auto *msg) {
+            handler.handleClearMessageMessage(msg);
+        });
     }
     else if (command == "USERNOTICE")
     {
-        handler.handleUserNoticeMessage(message, *this);
+        this->spillMessage(message->parameter(0), *message);
+        handler.handleInOrder(message, [this, &handler](auto *msg) {
+            handler.handleUserNoticeMessage(msg, *this);
+        });
     }
     else if (command == "NOTICE")
     {
@@ -310,61 +457,56 @@ bool TwitchIrcServer::hasSeparateWriteConnection() const
 void TwitchIrcServer::onMessageSendRequested(TwitchChannel *channel,
                                              const QString &message, bool &sent)
 {
+    // messages beyond this wait for a minute or more, which is rather a
+    // macro gone wrong than something the user still wants to be sent
+    constexpr size_t maxQueuedMessages = 20;
+
     sent = false;
 
+    auto now = std::chrono::steady_clock::now();
+    if (this->sendQueue_.size(channel->getName()) >= maxQueuedMessages)
     {
-        std::lock_guard<std::mutex> guard(this->lastMessageMutex_);
-
-        //        std::queue<std::chrono::steady_clock::time_point>
-        auto &lastMessage = channel->hasHighRateLimit()
-                                ? this->lastMessageMod_
-                                : this->lastMessagePleb_;
-        size_t maxMessageCount = channel->hasHighRateLimit() ? 99 : 19;
-        auto minMessageOffset = (channel->hasHighRateLimit() ? 100ms : 1100ms);
-
-        auto now = std::chrono::steady_clock::now();
-
-        // check if you are sending messages too fast
-        if (!lastMessage.empty() && lastMessage.back() + minMessageOffset > now)
+        if (this->lastErrorTimeAmount_ + 30s < now)
         {
-            if (this->lastErrorTimeSpeed_ + 30s < now)
-            {
-                auto errorMessage =
-                    makeSystemMessage("You are sending messages too quickly.");
+            auto errorMessage =
+                makeSystemMessage("You are sending too many messages.");
 
-                channel->addMessage(errorMessage);
+            channel->addMessage(errorMessage);
 
-                this->lastErrorTimeSpeed_ = now;
-            }
-            return;
-        }
-
-        // remove messages older than 30 seconds
-        while (!lastMessage.empty() && lastMessage.front() + 32s < now)
-        {
-            lastMessage.pop();
+            this->lastErrorTimeAmount_ = now;
         }
+        return;
+    }
 
-        // check if you are sending too many messages
-        if (lastMessage.size() >= maxMessageCount)
-        {
-            if (this->lastErrorTimeAmount_ + 30s < now)
-            {
-                auto errorMessage =
-                    makeSystemMessage("You are sending too many messages.");
+    this->sendQueue_.push({channel->getName(), message,
+                           channel->hasHighRateLimit(),
+                           MessageSendQueue::isModerationCommand(message)
+                               ? MessageSendQueue::Priority::Moderation
+                               : MessageSendQueue::Priority::Chat});
+    this->flushSendQueue();
+    this->sendQueueChanged.invoke(
+        channel->getName(), int(this->sendQueue_.size(channel->getName())));
 
-                channel->addMessage(errorMessage);
+    sent = true;
+}
 
-                this->lastErrorTimeAmount_ = now;
-            }
-            return;
-        }
+void TwitchIrcServer::flushSendQueue()
+{
+    auto now = std::chrono::steady_clock::now();
 
-        lastMessage.push(now);
+    for (const auto &entry : this->sendQueue_.takeSendable(now))
+    {
+        this->sendMessage(entry.channel, entry.message);
+        this->sendQueueChanged.invoke(
+            entry.channel, int(this->sendQueue_.size(entry.channel)));
     }
 
-    this->sendMessage(channel->getName(), message);
-    sent = true;
+    if (auto next = this->sendQueue_.nextSendTime(now))
+    {
+        auto wait =
+            std::chrono::duration_cast<std::chrono::milliseconds>(*next - now);
+        this->sendQueueTimer_.start(int(std::max<int64_t>(wait.count(), 1)));
+    }
 }
 
 const BttvEmotes &TwitchIrcServer::getBttvEmotes() const
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "common/AggregateChannel.hpp"
 #include "common/Atomic.hpp"
 #include "common/Channel.hpp"
 #include "common/Singleton.hpp"
@@ -7,10 +8,14 @@
 #include "providers/bttv/BttvEmotes.hpp"
 #include "providers/ffz/FfzEmotes.hpp"
 #include "providers/irc/AbstractIrcServer.hpp"
+#include "providers/twitch/HistorySpill.hpp"
+#include "providers/twitch/MessageSendQueue.hpp"
+
+#include <QTimer>
 
 #include <chrono>
+#include <deque>
 #include <memory>
-#include <queue>
 
 namespace chatterino {
 
@@ -18,6 +23,7 @@ class Settings;
 class Paths;
 class PubSub;
 class TwitchChannel;
+class TwitchIrcLine;
 
 class TwitchIrcServer final : public AbstractIrcServer, public Singleton
 {
@@ -33,16 +39,29 @@ public:
 
     Atomic<QString> lastUserThatWhisperedMe;
 
-    const ChannelPtr whispersChannel;
-    const ChannelPtr mentionsChannel;
-    const ChannelPtr liveChannel;
+    const std::shared_ptr<AggregateChannel> whispersChannel;
+    const std::shared_ptr<AggregateChannel> mentionsChannel;
+    const std::shared_ptr<AggregateChannel> liveChannel;
     IndirectChannel watchingChannel;
 
     PubSub *pubsub;
 
+    // channel name, number of the messages that wait for the rate limits
+    pajlada::Signals::Signal<QString, int> sendQueueChanged;
+
     const BttvEmotes &getBttvEmotes() const;
     const FfzEmotes &getFfzEmotes() const;
 
+    // Handles raw IRC lines as if they were received just now, used for the
+    // lines kept by dormant channels
+    void replayLines(const std::deque<QByteArray> &lines);
+
+    // Keeps the chat of the channels between restarts, null until initialized
+    HistorySpill *historySpill();
+    // Adds the message to the kept chat of its channel if that's enabled
+    void spillMessage(const QString &channelName,
+                      const Communi::IrcMessage &message);
+
 protected:
     virtual void initializeConnection(IrcConnection *connection,
                                       ConnectionType type) override;
@@ -62,19 +81,35 @@ protected:
     virtual QString cleanChannelName(const QString &dirtyChannelName) override;
     virtual bool hasSeparateWriteConnection() const override;
 
+    virtual void onChannelDisconnected(const ChannelPtr &channel,
+                                       IrcConnection *connection) override;
+
 private:
+    // Keeps the message if it's for a dormant channel or one that loads the
+    // messages it missed, returns true if it shouldn't be handled now
+    bool keepForDormantChannel(Communi::IrcMessage *message);
+    // same for a raw line, before a Communi message is made for it
+    bool keepForDormantChannel(const TwitchIrcLine &line);
+
     void onMessageSendRequested(TwitchChannel *channel, const QString &message,
                                 bool &sent);
 
-    std::mutex lastMessageMutex_;
-    std::queue<std::chrono::steady_clock::time_point> lastMessagePleb_;
-    std::queue<std::chrono::steady_clock::time_point> lastMessageMod_;
-    std::chrono::steady_clock::time_point lastErrorTimeSpeed_;
+    // Sends the queued messages the rate limits allow and waits for the
+    // next one
+    void flushSendQueue();
+
+    MessageSendQueue sendQueue_;
+    QTimer sendQueueTimer_;
     std::chrono::steady_clock::time_point lastErrorTimeAmount_;
 
     BttvEmotes bttv;
     FfzEmotes ffz;
 
+    std::unique_ptr<HistorySpill> historySpill_;
+
+    // account changes in quick succession only reconnect once
+    bool reconnectQueued_ = false;
+
     pajlada::Signals::SignalHolder signalHolder_;
 };
 
@@ -2,21 +2,32 @@
 
 #include "Application.hpp"
 #include "controllers/accounts/AccountController.hpp"
+#include "debug/AssertInGuiThread.hpp"
 #include "controllers/ignores/IgnoreController.hpp"
+#include "controllers/ignores/IgnoreMatcher.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
+#include "controllers/nicknames/NicknameMatcher.hpp"
 #include "messages/Message.hpp"
+#include "providers/twitch/ChannelEmoteIndex.hpp"
 #include "providers/chatterino/ChatterinoBadges.hpp"
 #include "providers/ffz/FfzBadges.hpp"
 #include "providers/twitch/TwitchBadges.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
+#include "providers/twitch/TwitchTags.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/Resources.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/ChannelCosts.hpp"
+#include "util/DebugCount.hpp"
 #include "util/Helpers.hpp"
+#include "util/Hotness.hpp"
 #include "util/IrcHelpers.hpp"
+#include "util/PostToThread.hpp"
+#include "util/QStringHash.hpp"
+#include "util/StringPool.hpp"
 #include "widgets/Window.hpp"
 
 #include <QApplication>
@@ -25,6 +36,9 @@
 #include <QMediaPlayer>
 #include <QStringRef>
 #include <boost/variant.hpp>
+
+#include <mutex>
+#include <unordered_map>
 #include "common/QLogging.hpp"
 
 namespace {
@@ -37,62 +51,13 @@ const QRegularExpression mentionRegex("^@" + regexHelpString);
 // if findAllUsernames setting is enabled, matches strings like in the examples above, but without @ symbol at the beginning
 const QRegularExpression allUsernamesMentionRegex("^" + regexHelpString);
 
-const QSet<QString> zeroWidthEmotes{
-    "SoSnowy",  "IceCold",   "SantaHat", "TopHat",
-    "ReinDeer", "CandyCane", "cvMask",   "cvHazmat",
-};
-
 }  // namespace
 
 namespace chatterino {
 
 namespace {
 
-    QStringList parseTagList(const QVariantMap &tags, const QString &key)
-    {
-        auto iterator = tags.find(key);
-        if (iterator == tags.end())
-            return QStringList{};
-
-        return iterator.value().toString().split(
-            ',', QString::SplitBehavior::SkipEmptyParts);
-    }
-
-    std::map<QString, QString> parseBadgeInfos(const QVariantMap &tags)
-    {
-        std::map<QString, QString> badgeInfos;
-
-        for (QString badgeInfo : parseTagList(tags, "badge-info"))
-        {
-            QStringList parts = badgeInfo.split('/');
-            if (parts.size() != 2)
-            {
-                continue;
-            }
-
-            badgeInfos.emplace(parts[0], parts[1]);
-        }
-
-        return badgeInfos;
-    }
-
-    std::vector<Badge> parseBadges(const QVariantMap &tags)
-    {
-        std::vector<Badge> badges;
-
-        for (QString badge : parseTagList(tags, "badges"))
-        {
-            QStringList parts = badge.split('/');
-            if (parts.size() != 2)
-            {
-                continue;
-            }
-
-            badges.emplace_back(parts[0], parts[1]);
-        }
-
-        return badges;
-    }
+    DebugHistogram buildTime("message build time");
 
 }  // namespace
 
@@ -116,7 +81,8 @@ bool TwitchMessageBuilder::isIgnored() const
 {
     return isIgnoredMessage({
         /*.message = */ this->originalMessage_,
-        /*.twitchUserID = */ this->tags.value("user-id").toString(),
+        /*.twitchUserID = */
+        this->tags.value(QStringLiteral("user-id")).toString(),
         /*.isMod = */ this->channel->isMod(),
         /*.isBroadcaster = */ this->channel->isBroadcaster(),
     });
@@ -135,8 +101,12 @@ void TwitchMessageBuilder::triggerHighlights()
 
 MessagePtr TwitchMessageBuilder::build()
 {
+    DebugHistogram::Timer timer(buildTime);
+    ChannelCosts::Scope costs(this->channel->getName(),
+                              CostCategory::Building);
+
     // PARSE
-    this->userId_ = this->ircMessage->tag("user-id").toString();
+    this->userId_ = this->ircMessage->tag(QStringLiteral("user-id")).toString();
 
     this->parse();
 
@@ -166,29 +136,31 @@ MessagePtr TwitchMessageBuilder::build()
 
     this->appendChannelName();
 
-    if (this->tags.contains("rm-deleted"))
+    if (this->tags.contains(QStringLiteral("rm-deleted")))
     {
         this->message().flags.set(MessageFlag::Disabled);
     }
 
-    this->historicalMessage_ = this->tags.contains("historical");
+    this->historicalMessage_ =
+        this->tags.contains(QStringLiteral("historical"));
 
-    if (this->tags.contains("msg-id") &&
-        this->tags["msg-id"].toString().split(';').contains(
+    if (this->tags.contains(QStringLiteral("msg-id")) &&
+        this->tags[QStringLiteral("msg-id")].toString().split(';').contains(
             "highlighted-message"))
     {
         this->message().flags.set(MessageFlag::RedeemedHighlight);
     }
 
-    if (this->tags.contains("first-msg") &&
-        this->tags["first-msg"].toString() == "1")
+    if (this->tags.contains(QStringLiteral("first-msg")) &&
+        this->tags[QStringLiteral("first-msg")].toString() == "1")
     {
         this->message().flags.set(MessageFlag::FirstMessage);
     }
 
     // timestamp
+    this->message().serverReceivedTime = calculateMessageTime(this->ircMessage);
     this->emplace<TimestampElement>(
-        calculateMessageTimestamp(this->ircMessage));
+        this->message().serverReceivedTime.time());
 
     if (this->shouldAddModerationElements())
     {
@@ -203,7 +175,7 @@ MessagePtr TwitchMessageBuilder::build()
     this->appendUsername();
 
     //    QString bits;
-    auto iterator = this->tags.find("bits");
+    auto iterator = this->tags.find(QStringLiteral("bits"));
     if (iterator != this->tags.end())
     {
         this->hasBits_ = true;
@@ -214,21 +186,30 @@ MessagePtr TwitchMessageBuilder::build()
     // Twitch emotes
     std::vector<TwitchEmoteOccurence> twitchEmotes;
 
-    iterator = this->tags.find("emotes");
+    iterator = this->tags.find(QStringLiteral("emotes"));
     if (iterator != this->tags.end())
     {
-        QStringList emoteString = iterator.value().toString().split('/');
-        std::vector<int> correctPositions;
-        for (int i = 0; i < this->originalMessage_.size(); ++i)
+        // the parsed emotes point into this string
+        auto emotesTag = iterator.value().toString();
+        auto emotes = parseEmotesTag(emotesTag);
+
+        if (!emotes.empty())
         {
-            if (!this->originalMessage_.at(i).isLowSurrogate())
+            std::vector<int> correctPositions;
+            correctPositions.reserve(size_t(this->originalMessage_.size()));
+            for (int i = 0; i < this->originalMessage_.size(); ++i)
             {
-                correctPositions.push_back(i);
+                if (!this->originalMessage_.at(i).isLowSurrogate())
+                {
+                    correctPositions.push_back(i);
+                }
+            }
+
+            twitchEmotes.reserve(emotes.size());
+            for (const auto &emote : emotes)
+            {
+                this->appendTwitchEmote(emote, twitchEmotes, correctPositions);
             }
-        }
-        for (QString emote : emoteString)
-        {
-            this->appendTwitchEmote(emote, twitchEmotes, correctPositions);
         }
     }
 
@@ -246,16 +227,18 @@ MessagePtr TwitchMessageBuilder::build()
                        twitchEmotes.end());
 
     // words
-    QStringList splits = this->originalMessage_.split(' ');
-
-    this->addWords(splits, twitchEmotes);
+    this->addWords(this->originalMessage_, twitchEmotes);
 
     this->message().messageText = this->originalMessage_;
     this->message().searchText = this->message().localizedName + " " +
                                  this->userName + ": " + this->originalMessage_;
 
     // highlights
-    this->parseHighlights();
+    {
+        ChannelCosts::Scope highlightCosts(this->channel->getName(),
+                                           CostCategory::Highlights);
+        this->parseHighlights();
+    }
 
     // highlighting incoming whispers if requested per setting
     if (this->args.isReceivedWhisper && getSettings()->highlightInlineWhispers)
@@ -269,7 +252,7 @@ MessagePtr TwitchMessageBuilder::build()
 }
 
 bool doesWordContainATwitchEmote(
-    int cursor, const QString &word,
+    int cursor, QStringView word,
     const std::vector<TwitchEmoteOccurence> &twitchEmotes,
     std::vector<TwitchEmoteOccurence>::const_iterator &currentTwitchEmoteIt)
 {
@@ -294,15 +277,25 @@ bool doesWordContainATwitchEmote(
 }
 
 void TwitchMessageBuilder::addWords(
-    const QStringList &words,
-    const std::vector<TwitchEmoteOccurence> &twitchEmotes)
+    const QString &text, const std::vector<TwitchEmoteOccurence> &twitchEmotes)
 {
     // cursor currently indicates what character index we're currently operating in the full list of words
     int cursor = 0;
     auto currentTwitchEmoteIt = twitchEmotes.begin();
 
-    for (auto word : words)
+    // the words are views into text, only the parts that end up in elements
+    // are copied into strings
+    qsizetype wordStart = 0;
+    while (wordStart <= text.size())
     {
+        qsizetype wordEnd = text.indexOf(' ', wordStart);
+        if (wordEnd < 0)
+        {
+            wordEnd = text.size();
+        }
+        auto word = QStringView(text).mid(wordStart, wordEnd - wordStart);
+        wordStart = wordEnd + 1;
+
         if (word.isEmpty())
         {
             cursor++;
@@ -320,6 +313,7 @@ void TwitchMessageBuilder::addWords(
                 this->emplace<EmoteElement>(currentTwitchEmote.ptr,
                                             MessageElementFlag::TwitchEmote,
                                             this->textColor_);
+                Hotness::emotes().hit(currentTwitchEmote.name.string);
 
                 auto len = currentTwitchEmote.name.string.length();
                 cursor += len;
@@ -344,8 +338,9 @@ void TwitchMessageBuilder::addWords(
             // Emote is not at the start
 
             // 1. Add text before the emote
-            QString preText = word.left(currentTwitchEmote.start - cursor);
-            for (auto &variant : getApp()->emotes->emojis.parse(preText))
+            auto preText = word.left(currentTwitchEmote.start - cursor);
+            for (auto &variant :
+                 getApp()->emotes->emojis.parse(preText.toString()))
             {
                 boost::apply_visitor(
                     [&](auto &&arg) {
@@ -365,7 +360,7 @@ void TwitchMessageBuilder::addWords(
         }
 
         // split words
-        for (auto &variant : getApp()->emotes->emojis.parse(word))
+        for (auto &variant : getApp()->emotes->emojis.parse(word.toString()))
         {
             boost::apply_visitor(
                 [&](auto &&arg) {
@@ -498,7 +493,7 @@ void TwitchMessageBuilder::addTextOrEmoji(const QString &string_)
 
 void TwitchMessageBuilder::parseMessageID()
 {
-    auto iterator = this->tags.find("id");
+    auto iterator = this->tags.find(QStringLiteral("id"));
 
     if (iterator != this->tags.end())
     {
@@ -513,7 +508,7 @@ void TwitchMessageBuilder::parseRoomID()
         return;
     }
 
-    auto iterator = this->tags.find("room-id");
+    auto iterator = this->tags.find(QStringLiteral("room-id"));
 
     if (iterator != std::end(this->tags))
     {
@@ -521,14 +516,30 @@ void TwitchMessageBuilder::parseRoomID()
 
         if (this->twitchChannel->roomId().isEmpty())
         {
-            this->twitchChannel->setRoomId(this->roomID_);
+            // changing the room id reloads emotes and recent messages, which
+            // has to happen on the gui thread
+            if (isGuiThread())
+            {
+                this->twitchChannel->setRoomId(this->roomID_);
+            }
+            else
+            {
+                postToThread([weak = this->twitchChannel->weak_from_this(),
+                              roomId = this->roomID_] {
+                    if (auto channel = weak.lock())
+                    {
+                        static_cast<TwitchChannel *>(channel.get())
+                            ->setRoomId(roomId);
+                    }
+                });
+            }
         }
     }
 }
 
 void TwitchMessageBuilder::parseUsernameColor()
 {
-    const auto iterator = this->tags.find("color");
+    const auto iterator = this->tags.find(QStringLiteral("color"));
     if (iterator != this->tags.end())
     {
         if (const auto color = iterator.value().toString(); !color.isEmpty())
@@ -539,10 +550,12 @@ void TwitchMessageBuilder::parseUsernameColor()
         }
     }
 
-    if (getSettings()->colorizeNicknames && this->tags.contains("user-id"))
+    if (getSettings()->colorizeNicknames &&
+        this->tags.contains(QStringLiteral("user-id")))
     {
         this->usernameColor_ =
-            getRandomColor(this->tags.value("user-id").toString());
+            getRandomColor(this->tags.value(QStringLiteral("user-id"))
+                               .toString());
         this->message().usernameColor = this->usernameColor_;
     }
 }
@@ -553,7 +566,8 @@ void TwitchMessageBuilder::parseUsername()
 
     if (this->userName.isEmpty() || this->args.trimSubscriberUsername)
     {
-        this->userName = this->tags.value(QLatin1String("login")).toString();
+        this->userName = StringPool::instance().intern(
+            this->tags.value(QLatin1String("login")).toString());
     }
 
     // display name
@@ -564,6 +578,7 @@ void TwitchMessageBuilder::parseUsername()
     //    }
 
     this->message().loginName = this->userName;
+    Hotness::chatters().hit(this->userName);
     if (this->twitchChannel != nullptr)
     {
         this->twitchChannel->setUserColor(this->userName, this->usernameColor_);
@@ -585,11 +600,11 @@ void TwitchMessageBuilder::appendUsername()
     this->message().loginName = username;
     QString localizedName;
 
-    auto iterator = this->tags.find("display-name");
+    auto iterator = this->tags.find(QStringLiteral("display-name"));
     if (iterator != this->tags.end())
     {
-        QString displayName =
-            parseTagString(iterator.value().toString()).trimmed();
+        QString displayName = StringPool::instance().intern(
+            parseTagString(iterator.value().toString()).trimmed());
 
         if (QString::compare(displayName, this->userName,
                              Qt::CaseInsensitive) == 0)
@@ -645,15 +660,7 @@ void TwitchMessageBuilder::appendUsername()
         break;
     }
 
-    auto nicknames = getCSettings().nicknames.readOnly();
-
-    for (const auto &nickname : *nicknames)
-    {
-        if (nickname.match(usernameText))
-        {
-            break;
-        }
-    }
+    getNicknameMatcher()->replace(usernameText);
 
     if (this->args.isSentWhisper)
     {
@@ -701,7 +708,17 @@ void TwitchMessageBuilder::appendUsername()
 void TwitchMessageBuilder::runIgnoreReplaces(
     std::vector<TwitchEmoteOccurence> &twitchEmotes)
 {
-    auto phrases = getCSettings().ignoredMessages.readOnly();
+    auto matcher = getIgnoreMatcher();
+    const auto &phrases = matcher->phrases();
+
+    // Phrases before the first candidate can't match, the message only
+    // changes once a phrase was applied
+    auto first = matcher->firstReplaceCandidate(this->originalMessage_);
+    if (first == phrases.size())
+    {
+        return;
+    }
+
     auto removeEmotesInRange = [](int pos, int len,
                                   auto &twitchEmotes) mutable {
         auto it = std::partition(
@@ -767,8 +784,10 @@ void TwitchMessageBuilder::runIgnoreReplaces(
         }
     };
 
-    for (const auto &phrase : *phrases)
+    for (auto phraseIt = phrases.begin() + first; phraseIt != phrases.end();
+         ++phraseIt)
     {
+        const auto &phrase = *phraseIt;
         if (phrase.isBlock())
         {
             continue;
@@ -918,97 +937,55 @@ void TwitchMessageBuilder::runIgnoreReplaces(
 }
 
 void TwitchMessageBuilder::appendTwitchEmote(
-    const QString &emote, std::vector<TwitchEmoteOccurence> &vec,
-    std::vector<int> &correctPositions)
+    const TagEmote &emote, std::vector<TwitchEmoteOccurence> &vec,
+    const std::vector<int> &correctPositions)
 {
-    auto app = getApp();
-    if (!emote.contains(':'))
+    if (size_t(emote.end) >= correctPositions.size())
     {
         return;
     }
 
-    auto parameters = emote.split(':');
+    auto start = correctPositions[size_t(emote.start)];
+    auto end = correctPositions[size_t(emote.end)];
 
-    if (parameters.length() < 2)
+    if (start >= end)
     {
         return;
     }
 
-    auto id = EmoteId{parameters.at(0)};
-
-    auto occurences = parameters.at(1).split(',');
-
-    for (QString occurence : occurences)
+    auto id = EmoteId{emote.id.toString()};
+    auto name = EmoteName{this->originalMessage_.mid(start, end - start + 1)};
+    TwitchEmoteOccurence emoteOccurence{
+        start, end, getApp()->emotes->twitch.getOrCreateEmote(id, name), name};
+    if (emoteOccurence.ptr == nullptr)
     {
-        auto coords = occurence.split('-');
-
-        if (coords.length() < 2)
-        {
-            return;
-        }
-
-        auto start = correctPositions[coords.at(0).toUInt()];
-        auto end = correctPositions[coords.at(1).toUInt()];
-
-        if (start >= end || start < 0 || end > this->originalMessage_.length())
-        {
-            return;
-        }
-
-        auto name =
-            EmoteName{this->originalMessage_.mid(start, end - start + 1)};
-        TwitchEmoteOccurence emoteOccurence{
-            start, end, app->emotes->twitch.getOrCreateEmote(id, name), name};
-        if (emoteOccurence.ptr == nullptr)
-        {
-            qCDebug(chatterinoTwitch)
-                << "nullptr" << emoteOccurence.name.string;
-        }
-        vec.push_back(std::move(emoteOccurence));
+        qCDebug(chatterinoTwitch) << "nullptr" << emoteOccurence.name.string;
     }
+    vec.push_back(std::move(emoteOccurence));
 }
 
 Outcome TwitchMessageBuilder::tryAppendEmote(const EmoteName &name)
 {
-    auto *app = getApp();
-
-    const auto &globalBttvEmotes = app->twitch->getBttvEmotes();
-    const auto &globalFfzEmotes = app->twitch->getFfzEmotes();
-
-    auto flags = MessageElementFlags();
-    auto emote = boost::optional<EmotePtr>{};
-
-    // Emote order:
-    //  - FrankerFaceZ Channel
-    //  - BetterTTV Channel
-    //  - FrankerFaceZ Global
-    //  - BetterTTV Global
-    if (this->twitchChannel && (emote = this->twitchChannel->ffzEmote(name)))
+    if (!this->emoteIndex_)
     {
-        flags = MessageElementFlag::FfzEmote;
-    }
-    else if (this->twitchChannel &&
-             (emote = this->twitchChannel->bttvEmote(name)))
-    {
-        flags = MessageElementFlag::BttvEmote;
-    }
-    else if ((emote = globalFfzEmotes.emote(name)))
-    {
-        flags = MessageElementFlag::FfzEmote;
-    }
-    else if ((emote = globalBttvEmotes.emote(name)))
-    {
-        flags = MessageElementFlag::BttvEmote;
-
-        if (zeroWidthEmotes.contains(name.string))
+        if (this->twitchChannel)
+        {
+            this->emoteIndex_ = this->twitchChannel->emoteIndex();
+        }
+        else
         {
-            flags.set(MessageElementFlag::ZeroWidthEmote);
+            // e.g. whispers, only global emotes can be used
+            static Atomic<std::shared_ptr<const ChannelEmoteIndex>> globalIndex;
+            this->emoteIndex_ =
+                ChannelEmoteIndex::current(globalIndex, nullptr, nullptr);
         }
     }
 
-    if (emote)
+    if (const auto *entry = this->emoteIndex_->find(name))
     {
-        this->emplace<EmoteElement>(emote.get(), flags, this->textColor_);
+        this->emplace<EmoteElement>(entry->emote, entry->flags,
+                                    this->textColor_);
+        Hotness::emotes().hit(name.string);
         return Success;
     }
 
@@ -1018,19 +995,7 @@ Outcome TwitchMessageBuilder::tryAppendEmote(const EmoteName &name)
 boost::optional<EmotePtr> TwitchMessageBuilder::getTwitchBadge(
     const Badge &badge)
 {
-    if (auto channelBadge =
-            this->twitchChannel->twitchBadge(badge.key_, badge.value_))
-    {
-        return channelBadge;
-    }
-
-    if (auto globalBadge =
-            TwitchBadges::instance()->badge(badge.key_, badge.value_))
-    {
-        return globalBadge;
-    }
-
-    return boost::none;
+    return this->twitchChannel->twitchBadge(badge);
 }
 
 void TwitchMessageBuilder::appendTwitchBadges()
@@ -1040,10 +1005,10 @@ void TwitchMessageBuilder::appendTwitchBadges()
         return;
     }
 
-    auto badgeInfos = parseBadgeInfos(this->tags);
-    auto badges = parseBadges(this->tags);
+    const auto &badgeSet = this->message().badgeSet;
+    const auto &badgeInfos = badgeSet->badgeInfos;
 
-    for (const auto &badge : badges)
+    for (const auto &badge : badgeSet->badges)
     {
         auto badgeEmote = this->getTwitchBadge(badge);
         if (!badgeEmote)
@@ -1106,7 +1071,7 @@ void TwitchMessageBuilder::appendTwitchBadges()
             if (badgeInfoIt != badgeInfos.end())
             {
                 auto predictionText =
-                    badgeInfoIt->second
+                    QString(badgeInfoIt->second)
                         .replace("\\s", " ")  // standard IRC escapes
                         .replace("\\:", ";")
                         .replace("\\\\", "\\")
@@ -1120,9 +1085,6 @@ void TwitchMessageBuilder::appendTwitchBadges()
         this->emplace<BadgeElement>(badgeEmote.get(), badge.flag_)
             ->setTooltip(tooltip);
     }
-
-    this->message().badges = badges;
-    this->message().badgeInfos = badgeInfos;
 }
 
 void TwitchMessageBuilder::appendChatterinoBadges()
@@ -1153,7 +1115,8 @@ Outcome TwitchMessageBuilder::tryParseCheermote(const QString &string)
         return Failure;
     }
 
-    auto cheerOpt = this->twitchChannel->cheerEmote(string);
+    int cheerValue = 0;
+    auto cheerOpt = this->twitchChannel->cheerEmote(string, cheerValue);
 
     if (!cheerOpt)
     {
@@ -1161,14 +1124,6 @@ Outcome TwitchMessageBuilder::tryParseCheermote(const QString &string)
     }
 
     auto &cheerEmote = *cheerOpt;
-    auto match = cheerEmote.regex.match(string);
-
-    if (!match.hasMatch())
-    {
-        return Failure;
-    }
-
-    int cheerValue = match.captured(1).toInt();
 
     if (getSettings()->stackBits)
     {
@@ -1225,7 +1180,7 @@ Outcome TwitchMessageBuilder::tryParseCheermote(const QString &string)
     }
     if (cheerEmote.color != QColor())
     {
-        this->emplace<TextElement>(match.captured(1),
+        this->emplace<TextElement>(QString::number(cheerValue),
                                    MessageElementFlag::BitsAmount,
                                    cheerEmote.color);
     }
@@ -1241,7 +1196,7 @@ bool TwitchMessageBuilder::shouldAddModerationElements() const
         return false;
     }
 
-    if (this->tags.value("user-type").toString() == "mod" &&
+    if (this->tags.value(QStringLiteral("user-type")).toString() == "mod" &&
         !this->args.isStaffOrBroadcaster)
     {
         // You cannot timeout moderators UNLESS you are Twitch Staff or the broadcaster of the channel
@@ -1462,9 +1417,16 @@ void TwitchMessageBuilder::deletionMessage(const DeleteAction &action,
 void TwitchMessageBuilder::listOfUsersSystemMessage(QString prefix,
                                                     QStringList users,
                                                     Channel *channel,
-                                                    MessageBuilder *builder)
+                                                    MessageBuilder *builder,
+                                                    size_t more)
 {
     QString text = prefix + users.join(", ");
+    QString moreText;
+    if (more > 0)
+    {
+        moreText = QString("and %1 more").arg(more);
+        text += " " + moreText;
+    }
 
     builder->message().messageText = text;
     builder->message().searchText = text;
@@ -1478,6 +1440,8 @@ void TwitchMessageBuilder::listOfUsersSystemMessage(QString prefix,
     auto tc = dynamic_cast<TwitchChannel *>(channel);
     for (const QString &username : users)
     {
+        // the last user is only followed by a space if there are more
+        bool trailingSpace = more > 0 && &username == &users.back();
         if (!isFirst)
         {
             // this is used to add the ", " after each but the last entry
@@ -1501,12 +1465,18 @@ void TwitchMessageBuilder::listOfUsersSystemMessage(QString prefix,
             ->emplace<TextElement>(username, MessageElementFlag::BoldUsername,
                                    color, FontStyle::ChatMediumBold)
             ->setLink({Link::UserInfo, username})
-            ->setTrailingSpace(false);
+            ->setTrailingSpace(trailingSpace);
         builder
             ->emplace<TextElement>(username,
                                    MessageElementFlag::NonBoldUsername, color)
             ->setLink({Link::UserInfo, username})
-            ->setTrailingSpace(false);
+            ->setTrailingSpace(trailingSpace);
+    }
+
+    if (!moreText.isEmpty())
+    {
+        builder->emplace<TextElement>(moreText, MessageElementFlag::Text,
+                                      MessageColor::System);
     }
 }
 
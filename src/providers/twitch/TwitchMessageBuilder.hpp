@@ -18,6 +18,8 @@ using EmotePtr = std::shared_ptr<const Emote>;
 
 class Channel;
 class TwitchChannel;
+class ChannelEmoteIndex;
+struct TagEmote;
 
 struct TwitchEmoteOccurence {
     int start;
@@ -64,9 +66,12 @@ public:
                                 MessageBuilder *builder);
     static void deletionMessage(const DeleteAction &action,
                                 MessageBuilder *builder);
+    /// more is the amount of users that aren't listed, appended as
+    /// "and N more"
     static void listOfUsersSystemMessage(QString prefix, QStringList users,
                                          Channel *channel,
-                                         MessageBuilder *builder);
+                                         MessageBuilder *builder,
+                                         size_t more = 0);
 
 private:
     void parseUsernameColor() override;
@@ -78,12 +83,12 @@ private:
     void runIgnoreReplaces(std::vector<TwitchEmoteOccurence> &twitchEmotes);
 
     boost::optional<EmotePtr> getTwitchBadge(const Badge &badge);
-    void appendTwitchEmote(const QString &emote,
+    void appendTwitchEmote(const TagEmote &emote,
                            std::vector<TwitchEmoteOccurence> &vec,
-                           std::vector<int> &correctPositions);
+                           const std::vector<int> &correctPositions);
     Outcome tryAppendEmote(const EmoteName &name) override;
 
-    void addWords(const QStringList &words,
+    void addWords(const QString &text,
                   const std::vector<TwitchEmoteOccurence> &twitchEmotes);
     void addTextOrEmoji(EmotePtr emote) override;
     void addTextOrEmoji(const QString &value) override;
@@ -104,6 +109,9 @@ private:
 
     QString userId_;
     bool senderIsBroadcaster{};
+
+    // looked up on the first word that could be an emote
+    std::shared_ptr<const ChannelEmoteIndex> emoteIndex_;
 };
 
 }  // namespace chatterino
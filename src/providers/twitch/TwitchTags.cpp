@@ -0,0 +1,115 @@
+#include "providers/twitch/TwitchTags.hpp"
+
+namespace chatterino {
+namespace {
+
+    // Calls f with every non-empty part of value between separators
+    template <typename F>
+    void forEachPart(QStringView value, QChar separator, F &&f)
+    {
+        int start = 0;
+        for (int i = 0; i <= value.size(); i++)
+        {
+            if (i == value.size() || value[i] == separator)
+            {
+                if (i > start)
+                {
+                    f(value.mid(start, i - start));
+                }
+                start = i + 1;
+            }
+        }
+    }
+
+    int indexOf(QStringView value, QChar c)
+    {
+        for (int i = 0; i < value.size(); i++)
+        {
+            if (value[i] == c)
+            {
+                return i;
+            }
+        }
+        return -1;
+    }
+
+    // Returns -1 if value isn't a non-negative number
+    int parseIndex(QStringView value)
+    {
+        if (value.isEmpty() || value.size() > 9)
+        {
+            return -1;
+        }
+
+        int result = 0;
+        for (auto c : value)
+        {
+            if (c.unicode() < '0' || c.unicode() > '9')
+            {
+                return -1;
+            }
+            result = result * 10 + (c.unicode() - '0');
+        }
+        return result;
+    }
+
+}  // namespace
+
+TagBadges parseBadgesTag(QStringView value)
+{
+    TagBadges badges;
+
+    forEachPart(value, ',', [&](QStringView item) {
+        auto slash = indexOf(item, '/');
+        if (slash == -1)
+        {
+            return;
+        }
+
+        auto version = item.mid(slash + 1);
+        if (indexOf(version, '/') != -1)
+        {
+            return;
+        }
+
+        badges.push_back({item.left(slash), version});
+    });
+
+    return badges;
+}
+
+TagEmotes parseEmotesTag(QStringView value)
+{
+    TagEmotes emotes;
+
+    forEachPart(value, '/', [&](QStringView emote) {
+        auto colon = indexOf(emote, ':');
+        if (colon <= 0)
+        {
+            return;
+        }
+
+        auto id = emote.left(colon);
+
+        forEachPart(emote.mid(colon + 1), ',', [&](QStringView occurence) {
+            auto dash = indexOf(occurence, '-');
+            if (dash == -1)
+            {
+                return;
+            }
+
+            auto start = parseIndex(occurence.left(dash));
+            auto end = parseIndex(occurence.mid(dash + 1));
+            if (start == -1 || end == -1)
+            {
+                return;
+            }
+
+            emotes.push_back({id, start, end});
+        });
+    });
+
+    return emotes;
+}
+
+}  // namespace chatterino
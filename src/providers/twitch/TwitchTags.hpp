@@ -0,0 +1,35 @@
+#pragma once
+
+#include <QStringView>
+#include <boost/container/small_vector.hpp>
+
+namespace chatterino {
+
+// The parsed items point into the tag value they were parsed from, that
+// string has to outlive them.
+
+/// A "name/version" item of the badges or badge-info tag
+struct TagBadge {
+    QStringView name;
+    QStringView version;
+};
+using TagBadges = boost::container::small_vector<TagBadge, 4>;
+
+/// Parses a badges or badge-info tag like "moderator/1,subscriber/12".
+/// Malformed items are skipped.
+TagBadges parseBadgesTag(QStringView value);
+
+/// A single occurence of an emote in the emotes tag. The positions are
+/// inclusive and count code points, not UTF-16 code units.
+struct TagEmote {
+    QStringView id;
+    int start;
+    int end;
+};
+using TagEmotes = boost::container::small_vector<TagEmote, 8>;
+
+/// Parses an emotes tag like "25:0-4,12-16/1902:6-10" in the order the
+/// occurences appear in the tag. Malformed occurences are skipped.
+TagEmotes parseEmotesTag(QStringView value);
+
+}  // namespace chatterino
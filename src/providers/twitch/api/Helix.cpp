@@ -27,28 +27,33 @@ void Helix::fetchUsers(QStringList userIds, QStringList userLogins,
 
     // TODO: set on success and on error
     this->makeRequest("users", urlQuery)
-        .onSuccess([successCallback, failureCallback](auto result) -> Outcome {
-            auto root = result.parseJson();
-            auto data = root.value("data");
+        .onSuccess([this, successCallback,
+                    failureCallback](auto result) -> Outcome {
+            this->updateRatelimit("users", result);
 
-            if (!data.isArray())
+            JsonDocument document(result.getData());
+            const auto *data = rj::member(document.root(), "data");
+
+            if (data == nullptr || !data->IsArray())
             {
                 failureCallback();
                 return Failure;
             }
 
             std::vector<HelixUser> users;
+            users.reserve(data->Size());
 
-            for (const auto &jsonUser : data.toArray())
+            for (const auto &jsonUser : data->GetArray())
             {
-                users.emplace_back(jsonUser.toObject());
+                users.emplace_back(jsonUser);
             }
 
             successCallback(users);
 
             return Success;
         })
-        .onError([failureCallback](auto /*result*/) {
+        .onError([this, failureCallback](auto result) {
+            this->updateRatelimit("users", result);
             // TODO: make better xd
             failureCallback();
         })
@@ -161,28 +166,33 @@ void Helix::fetchStreams(
 
     // TODO: set on success and on error
     this->makeRequest("streams", urlQuery)
-        .onSuccess([successCallback, failureCallback](auto result) -> Outcome {
-            auto root = result.parseJson();
-            auto data = root.value("data");
+        .onSuccess([this, successCallback,
+                    failureCallback](auto result) -> Outcome {
+            this->updateRatelimit("streams", result);
 
-            if (!data.isArray())
+            JsonDocument document(result.getData());
+            const auto *data = rj::member(document.root(), "data");
+
+            if (data == nullptr || !data->IsArray())
             {
                 failureCallback();
                 return Failure;
             }
 
             std::vector<HelixStream> streams;
+            streams.reserve(data->Size());
 
-            for (const auto &jsonStream : data.toArray())
+            for (const auto &jsonStream : data->GetArray())
             {
-                streams.emplace_back(jsonStream.toObject());
+                streams.emplace_back(jsonStream);
             }
 
             successCallback(streams);
 
             return Success;
         })
-        .onError([failureCallback](auto /*result*/) {
+        .onError([this, failureCallback](auto result) {
+            this->updateRatelimit("streams", result);
             // TODO: make better xd
             failureCallback();
         })
@@ -479,40 +489,28 @@ void Helix::createStreamMarker(
 };
 
 void Helix::loadBlocks(QString userId,
-                       ResultCallback<std::vector<HelixBlock>> successCallback,
+                       ResultCallback<std::vector<HelixBlock>> pageCallback,
+                       std::function<void()> finishedCallback,
                        HelixFailureCallback failureCallback)
 {
     QUrlQuery urlQuery;
     urlQuery.addQueryItem("broadcaster_id", userId);
     urlQuery.addQueryItem("first", "100");
 
-    this->makeRequest("users/blocks", urlQuery)
-        .onSuccess([successCallback, failureCallback](auto result) -> Outcome {
-            auto root = result.parseJson();
-            auto data = root.value("data");
-
-            if (!data.isArray())
-            {
-                failureCallback();
-                return Failure;
-            }
-
+    this->paginate(
+        "users/blocks", urlQuery,
+        [pageCallback](const QJsonArray &data) {
             std::vector<HelixBlock> ignores;
+            ignores.reserve(size_t(data.size()));
 
-            for (const auto &jsonStream : data.toArray())
+            for (const auto &jsonStream : data)
             {
                 ignores.emplace_back(jsonStream.toObject());
             }
 
-            successCallback(ignores);
-
-            return Success;
-        })
-        .onError([failureCallback](auto /*result*/) {
-            // TODO: make better xd
-            failureCallback();
-        })
-        .execute();
+            pageCallback(ignores);
+        },
+        std::move(finishedCallback), std::move(failureCallback));
 }
 
 void Helix::blockUser(QString targetUserId,
@@ -767,6 +765,59 @@ void Helix::getChannelEmotes(
         .execute();
 }
 
+void Helix::paginate(QString url, QUrlQuery urlQuery,
+                     std::function<void(const QJsonArray &)> pageCallback,
+                     std::function<void()> finishedCallback,
+                     HelixFailureCallback failureCallback, int pagesLeft)
+{
+    this->makeRequest(url, urlQuery)
+        .onSuccess([this, url, urlQuery, pageCallback, finishedCallback,
+                    failureCallback, pagesLeft](auto result) -> Outcome {
+            auto root = result.parseJson();
+            auto data = root.value("data");
+
+            if (!data.isArray())
+            {
+                failureCallback();
+                return Failure;
+            }
+
+            auto page = data.toArray();
+            pageCallback(page);
+
+            auto cursor = root.value("pagination")
+                              .toObject()
+                              .value("cursor")
+                              .toString();
+            if (page.isEmpty() || cursor.isEmpty())
+            {
+                finishedCallback();
+                return Success;
+            }
+            if (pagesLeft <= 1)
+            {
+                qCWarning(chatterinoTwitch)
+                    << "Stopped paging through" << url << "after"
+                    << MAX_PAGES << "pages";
+                finishedCallback();
+                return Success;
+            }
+
+            // the cursor of a page is only known once it arrived
+            auto nextQuery = urlQuery;
+            nextQuery.removeAllQueryItems("after");
+            nextQuery.addQueryItem("after", cursor);
+            this->paginate(url, nextQuery, pageCallback, finishedCallback,
+                           failureCallback, pagesLeft - 1);
+
+            return Success;
+        })
+        .onError([failureCallback](auto /*result*/) {
+            failureCallback();
+        })
+        .execute();
+}
+
 NetworkRequest Helix::makeRequest(QString url, QUrlQuery urlQuery)
 {
     assert(!url.startsWith("/"));
@@ -785,6 +836,15 @@ NetworkRequest Helix::makeRequest(QString url, QUrlQuery urlQuery)
         // return boost::none;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(this->ratelimitMutex_);
+        auto it = this->ratelimits_.find(url);
+        if (it != this->ratelimits_.end() && it->second.remaining > 0)
+        {
+            it->second.remaining--;
+        }
+    }
+
     const QString baseUrl("https://api.twitch.tv/helix/");
 
     QUrl fullUrl(baseUrl + url);
@@ -798,6 +858,36 @@ NetworkRequest Helix::makeRequest(QString url, QUrlQuery urlQuery)
         .header("Authorization", "Bearer " + this->oauthToken);
 }
 
+HelixRatelimit Helix::ratelimit(const QString &endpoint) const
+{
+    std::lock_guard<std::mutex> lock(this->ratelimitMutex_);
+
+    auto it = this->ratelimits_.find(endpoint);
+    if (it == this->ratelimits_.end())
+    {
+        return {};
+    }
+    return it->second;
+}
+
+void Helix::updateRatelimit(const QString &endpoint,
+                            const NetworkResult &result)
+{
+    bool remainingOk = false;
+    auto remaining = result.header("Ratelimit-Remaining").toInt(&remainingOk);
+    bool resetOk = false;
+    auto reset = result.header("Ratelimit-Reset").toLongLong(&resetOk);
+    if (!remainingOk || !resetOk)
+    {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(this->ratelimitMutex_);
+    auto &ratelimit = this->ratelimits_[endpoint];
+    ratelimit.remaining = remaining;
+    ratelimit.reset = QDateTime::fromSecsSinceEpoch(reset, Qt::UTC);
+}
+
 void Helix::update(QString clientId, QString oauthToken)
 {
     this->clientId = std::move(clientId);
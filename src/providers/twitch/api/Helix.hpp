@@ -3,7 +3,10 @@
 #include "common/Aliases.hpp"
 #include "common/NetworkRequest.hpp"
 #include "providers/twitch/TwitchEmotes.hpp"
+#include "util/JsonDocument.hpp"
+#include "util/QStringHash.hpp"
 
+#include <QDateTime>
 #include <QJsonArray>
 #include <QString>
 #include <QStringList>
@@ -13,6 +16,8 @@
 #include <boost/optional.hpp>
 
 #include <functional>
+#include <mutex>
+#include <unordered_map>
 #include <vector>
 
 namespace chatterino {
@@ -30,14 +35,14 @@ struct HelixUser {
     QString profileImageUrl;
     int viewCount;
 
-    explicit HelixUser(QJsonObject jsonObject)
-        : id(jsonObject.value("id").toString())
-        , login(jsonObject.value("login").toString())
-        , displayName(jsonObject.value("display_name").toString())
-        , createdAt(jsonObject.value("created_at").toString())
-        , description(jsonObject.value("description").toString())
-        , profileImageUrl(jsonObject.value("profile_image_url").toString())
-        , viewCount(jsonObject.value("view_count").toInt())
+    explicit HelixUser(const rapidjson::Value &json)
+        : id(rj::string(json, "id"))
+        , login(rj::string(json, "login"))
+        , displayName(rj::string(json, "display_name"))
+        , createdAt(rj::string(json, "created_at"))
+        , description(rj::string(json, "description"))
+        , profileImageUrl(rj::string(json, "profile_image_url"))
+        , viewCount(rj::integer(json, "view_count"))
     {
     }
 };
@@ -113,19 +118,19 @@ struct HelixStream {
     {
     }
 
-    explicit HelixStream(QJsonObject jsonObject)
-        : id(jsonObject.value("id").toString())
-        , userId(jsonObject.value("user_id").toString())
-        , userLogin(jsonObject.value("user_login").toString())
-        , userName(jsonObject.value("user_name").toString())
-        , gameId(jsonObject.value("game_id").toString())
-        , gameName(jsonObject.value("game_name").toString())
-        , type(jsonObject.value("type").toString())
-        , title(jsonObject.value("title").toString())
-        , viewerCount(jsonObject.value("viewer_count").toInt())
-        , startedAt(jsonObject.value("started_at").toString())
-        , language(jsonObject.value("language").toString())
-        , thumbnailUrl(jsonObject.value("thumbnail_url").toString())
+    explicit HelixStream(const rapidjson::Value &json)
+        : id(rj::string(json, "id"))
+        , userId(rj::string(json, "user_id"))
+        , userLogin(rj::string(json, "user_login"))
+        , userName(rj::string(json, "user_name"))
+        , gameId(rj::string(json, "game_id"))
+        , gameName(rj::string(json, "game_name"))
+        , type(rj::string(json, "type"))
+        , title(rj::string(json, "title"))
+        , viewerCount(rj::integer(json, "viewer_count"))
+        , startedAt(rj::string(json, "started_at"))
+        , language(rj::string(json, "language"))
+        , thumbnailUrl(rj::string(json, "thumbnail_url"))
     {
     }
 };
@@ -323,6 +328,20 @@ enum class HelixAutoModMessageError {
     MessageNotFound,
 };
 
+// Budget of a Helix endpoint, taken from the Ratelimit-Remaining and
+// Ratelimit-Reset headers of its last response
+struct HelixRatelimit {
+    // -1 until the first response arrived
+    int remaining = -1;
+    QDateTime reset;
+
+    bool canSend() const
+    {
+        return this->remaining != 0 ||
+               this->reset <= QDateTime::currentDateTimeUtc();
+    }
+};
+
 class Helix final : boost::noncopyable
 {
 public:
@@ -391,8 +410,11 @@ public:
         std::function<void(HelixStreamMarkerError)> failureCallback);
 
     // https://dev.twitch.tv/docs/api/reference#get-user-block-list
+    // pageCallback gets every page as it arrives, finishedCallback is called
+    // after the last one
     void loadBlocks(QString userId,
-                    ResultCallback<std::vector<HelixBlock>> successCallback,
+                    ResultCallback<std::vector<HelixBlock>> pageCallback,
+                    std::function<void()> finishedCallback,
                     HelixFailureCallback failureCallback);
 
     // https://dev.twitch.tv/docs/api/reference#block-user
@@ -435,13 +457,31 @@ public:
 
     void update(QString clientId, QString oauthToken);
 
+    // Requests sent since the last response are already subtracted
+    HelixRatelimit ratelimit(const QString &endpoint) const;
+
     static void initialize();
 
 private:
+    // pages are requested until this many arrived, 100k entries of 100
+    static constexpr int MAX_PAGES = 1000;
+
     NetworkRequest makeRequest(QString url, QUrlQuery urlQuery);
+    // Requests the pages of a paginated endpoint one after another and hands
+    // every one to pageCallback as it arrives. Stops at the first failure,
+    // the pages that arrived until then stay delivered.
+    void paginate(QString url, QUrlQuery urlQuery,
+                  std::function<void(const QJsonArray &)> pageCallback,
+                  std::function<void()> finishedCallback,
+                  HelixFailureCallback failureCallback,
+                  int pagesLeft = MAX_PAGES);
+    void updateRatelimit(const QString &endpoint, const NetworkResult &result);
 
     QString clientId;
     QString oauthToken;
+
+    mutable std::mutex ratelimitMutex_;
+    std::unordered_map<QString, HelixRatelimit> ratelimits_;
 };
 
 Helix *getHelix();
@@ -0,0 +1,288 @@
+#include "providers/twitch/api/HelixBatcher.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+
+#include <QTimer>
+
+#include <algorithm>
+#include <unordered_map>
+
+namespace chatterino {
+
+namespace {
+
+    // Catches the lookups of channels that were opened together and of a
+    // whole live status poll in one batch
+    constexpr int BATCH_DELAY = 1000;
+    // Wait a bit longer than the reset for clocks that are slightly off
+    constexpr int RESET_MARGIN = 1000;
+
+}  // namespace
+
+template <typename T>
+class HelixBatcher::Batch
+{
+public:
+    // Called with nullptr if Helix didn't return anything for the id or login
+    using Callback = std::function<void(const T *)>;
+    using Fetch = std::function<void(QStringList, QStringList,
+                                     ResultCallback<std::vector<T>>,
+                                     HelixFailureCallback)>;
+    using Key = std::function<QString(const T &)>;
+
+    Batch(QString endpoint, Fetch fetch, Key id, Key login)
+        : endpoint_(std::move(endpoint))
+        , fetch_(std::move(fetch))
+        , id_(std::move(id))
+        , login_(std::move(login))
+    {
+        this->timer_.setSingleShot(true);
+        QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+            this->flush();
+        });
+    }
+
+    void addId(const QString &id, Callback callback,
+               HelixFailureCallback failureCallback)
+    {
+        this->ids_[id].push_back(
+            {std::move(callback), std::move(failureCallback)});
+        this->schedule();
+    }
+
+    void addLogin(const QString &login, Callback callback,
+                  HelixFailureCallback failureCallback)
+    {
+        this->logins_[login.toLower()].push_back(
+            {std::move(callback), std::move(failureCallback)});
+        this->schedule();
+    }
+
+private:
+    struct Waiter {
+        Callback callback;
+        HelixFailureCallback failureCallback;
+    };
+    using Waiters = std::unordered_map<QString, std::vector<Waiter>>;
+
+    static std::shared_ptr<Waiters> take(Waiters &from, int count)
+    {
+        auto taken = std::make_shared<Waiters>();
+        while (count > 0 && !from.empty())
+        {
+            taken->insert(from.extract(from.begin()));
+            count--;
+        }
+        return taken;
+    }
+
+    static void resolve(const Waiters &waiters,
+                        const std::unordered_map<QString, const T *> &results)
+    {
+        for (const auto &entry : waiters)
+        {
+            auto it = results.find(entry.first);
+            const T *result = it == results.end() ? nullptr : it->second;
+
+            for (const auto &waiter : entry.second)
+            {
+                waiter.callback(result);
+            }
+        }
+    }
+
+    void schedule()
+    {
+        assertInGuiThread();
+
+        // also keeps waiting for the ratelimit to reset
+        if (!this->timer_.isActive())
+        {
+            this->timer_.start(BATCH_DELAY);
+        }
+    }
+
+    void flush()
+    {
+        while (!this->ids_.empty() || !this->logins_.empty())
+        {
+            auto ratelimit = getHelix()->ratelimit(this->endpoint_);
+            if (!ratelimit.canSend())
+            {
+                auto wait = QDateTime::currentDateTimeUtc().msecsTo(
+                    ratelimit.reset);
+                this->timer_.start(int(std::max<qint64>(wait, 0)) +
+                                   RESET_MARGIN);
+                return;
+            }
+
+            auto ids = take(this->ids_, MAX_BATCH_SIZE);
+            auto logins =
+                take(this->logins_, MAX_BATCH_SIZE - int(ids->size()));
+            this->send(std::move(ids), std::move(logins));
+        }
+    }
+
+    void send(std::shared_ptr<Waiters> ids, std::shared_ptr<Waiters> logins)
+    {
+        QStringList idList;
+        for (const auto &entry : *ids)
+        {
+            idList.push_back(entry.first);
+        }
+
+        QStringList loginList;
+        for (const auto &entry : *logins)
+        {
+            loginList.push_back(entry.first);
+        }
+
+        this->fetch_(
+            idList, loginList,
+            [this, ids, logins](const std::vector<T> &results) {
+                std::unordered_map<QString, const T *> byId;
+                std::unordered_map<QString, const T *> byLogin;
+                for (const auto &result : results)
+                {
+                    byId.emplace(this->id_(result), &result);
+                    byLogin.emplace(this->login_(result).toLower(), &result);
+                }
+
+                resolve(*ids, byId);
+                resolve(*logins, byLogin);
+            },
+            [ids, logins] {
+                for (const auto *waiters : {ids.get(), logins.get()})
+                {
+                    for (const auto &entry : *waiters)
+                    {
+                        for (const auto &waiter : entry.second)
+                        {
+                            waiter.failureCallback();
+                        }
+                    }
+                }
+            });
+    }
+
+    const QString endpoint_;
+    const Fetch fetch_;
+    const Key id_;
+    const Key login_;
+
+    Waiters ids_;
+    Waiters logins_;
+    QTimer timer_;
+};
+
+HelixBatcher::HelixBatcher()
+    : streams_(std::make_unique<Batch<HelixStream>>(
+          "streams",
+          [](auto ids, auto logins, auto successCallback,
+             auto failureCallback) {
+              getHelix()->fetchStreams(std::move(ids), std::move(logins),
+                                       std::move(successCallback),
+                                       std::move(failureCallback));
+          },
+          [](const HelixStream &stream) {
+              return stream.userId;
+          },
+          [](const HelixStream &stream) {
+              return stream.userLogin;
+          }))
+    , users_(std::make_unique<Batch<HelixUser>>(
+          "users",
+          [](auto ids, auto logins, auto successCallback,
+             auto failureCallback) {
+              getHelix()->fetchUsers(std::move(ids), std::move(logins),
+                                     std::move(successCallback),
+                                     std::move(failureCallback));
+          },
+          [](const HelixUser &user) {
+              return user.id;
+          },
+          [](const HelixUser &user) {
+              return user.login;
+          }))
+{
+}
+
+HelixBatcher::~HelixBatcher() = default;
+
+HelixBatcher &HelixBatcher::instance()
+{
+    static HelixBatcher instance;
+    return instance;
+}
+
+void HelixBatcher::getStreamById(
+    const QString &userId, ResultCallback<bool, HelixStream> successCallback,
+    HelixFailureCallback failureCallback)
+{
+    this->streams_->addId(
+        userId,
+        [successCallback = std::move(successCallback)](const auto *stream) {
+            if (stream == nullptr)
+            {
+                successCallback(false, HelixStream());
+                return;
+            }
+            successCallback(true, *stream);
+        },
+        std::move(failureCallback));
+}
+
+void HelixBatcher::getStreamByName(
+    const QString &userLogin, ResultCallback<bool, HelixStream> successCallback,
+    HelixFailureCallback failureCallback)
+{
+    this->streams_->addLogin(
+        userLogin,
+        [successCallback = std::move(successCallback)](const auto *stream) {
+            if (stream == nullptr)
+            {
+                successCallback(false, HelixStream());
+                return;
+            }
+            successCallback(true, *stream);
+        },
+        std::move(failureCallback));
+}
+
+void HelixBatcher::getUserById(const QString &userId,
+                               ResultCallback<HelixUser> successCallback,
+                               HelixFailureCallback failureCallback)
+{
+    this->users_->addId(
+        userId,
+        [successCallback = std::move(successCallback),
+         failureCallback](const auto *user) {
+            if (user == nullptr)
+            {
+                failureCallback();
+                return;
+            }
+            successCallback(*user);
+        },
+        failureCallback);
+}
+
+void HelixBatcher::getUserByName(const QString &userLogin,
+                                 ResultCallback<HelixUser> successCallback,
+                                 HelixFailureCallback failureCallback)
+{
+    this->users_->addLogin(
+        userLogin,
+        [successCallback = std::move(successCallback),
+         failureCallback](const auto *user) {
+            if (user == nullptr)
+            {
+                failureCallback();
+                return;
+            }
+            successCallback(*user);
+        },
+        failureCallback);
+}
+
+}  // namespace chatterino
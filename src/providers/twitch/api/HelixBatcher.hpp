@@ -0,0 +1,54 @@
+#pragma once
+
+#include "providers/twitch/api/Helix.hpp"
+
+#include <QString>
+
+#include <memory>
+
+namespace chatterino {
+
+/**
+ * @brief Combines single stream and user lookups into batched Helix requests.
+ *
+ * Lookups are collected for a short while and then sent with up to 100 ids
+ * and logins per request, the results are handed back to each caller. Batches
+ * wait for the Ratelimit-Reset of their endpoint once its budget is used up.
+ *
+ * The callbacks are the same as the ones of the Helix functions with the
+ * same name. Gui thread only.
+ */
+class HelixBatcher
+{
+public:
+    // Helix accepts up to 100 ids and logins combined
+    static constexpr int MAX_BATCH_SIZE = 100;
+
+    static HelixBatcher &instance();
+
+    void getStreamById(const QString &userId,
+                       ResultCallback<bool, HelixStream> successCallback,
+                       HelixFailureCallback failureCallback);
+    void getStreamByName(const QString &userLogin,
+                         ResultCallback<bool, HelixStream> successCallback,
+                         HelixFailureCallback failureCallback);
+
+    void getUserById(const QString &userId,
+                     ResultCallback<HelixUser> successCallback,
+                     HelixFailureCallback failureCallback);
+    void getUserByName(const QString &userLogin,
+                       ResultCallback<HelixUser> successCallback,
+                       HelixFailureCallback failureCallback);
+
+private:
+    HelixBatcher();
+    ~HelixBatcher();
+
+    template <typename T>
+    class Batch;
+
+    std::unique_ptr<Batch<HelixStream>> streams_;
+    std::unique_ptr<Batch<HelixUser>> users_;
+};
+
+}  // namespace chatterino
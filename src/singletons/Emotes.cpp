@@ -9,9 +9,14 @@ Emotes::Emotes()
 {
 }
 
+void Emotes::load(Paths & /*paths*/)
+{
+    this->emojis.loadEmojiData();
+}
+
 void Emotes::initialize(Settings &settings, Paths &paths)
 {
-    this->emojis.load();
+    this->emojis.loadEmojiSet();
 
     this->gifTimer.initialize();
 }
@@ -18,6 +18,7 @@ class Emotes final : public Singleton
 public:
     Emotes();
 
+    virtual void load(Paths &paths) override;
     virtual void initialize(Settings &settings, Paths &paths) override;
 
     bool isIgnoredEmote(const QString &emote);
@@ -26,6 +26,10 @@
 
 namespace chatterino {
 namespace {
+    // Words are mostly the same few emote names and common words, the cache
+    // starts over once this many different ones were measured
+    constexpr size_t MAX_CACHED_TEXTS = 16384;
+
     int getBoldness()
     {
 #ifdef CHATTERINO
@@ -36,6 +40,43 @@ namespace {
     }
 }  // namespace
 
+FontMetricsSnapshot::FontMetricsSnapshot(std::vector<QFont> fonts,
+                                         float scale, uint64_t generation)
+    : fonts_(std::move(fonts))
+    , scale_(scale)
+    , generation_(generation)
+{
+    assert(this->fonts_.size() == size_t(FontStyle::EndType));
+}
+
+const QFont &FontMetricsSnapshot::font(FontStyle type) const
+{
+    assert(type < FontStyle::EndType);
+
+    return this->fonts_[size_t(type)];
+}
+
+QFontMetrics FontMetricsSnapshot::metrics(FontStyle type) const
+{
+    return QFontMetrics(this->font(type));
+}
+
+int FontMetricsSnapshot::horizontalAdvance(FontStyle type,
+                                           const QString &text) const
+{
+    return this->metrics(type).horizontalAdvance(text);
+}
+
+float FontMetricsSnapshot::scale() const
+{
+    return this->scale_;
+}
+
+uint64_t FontMetricsSnapshot::generation() const
+{
+    return this->generation_;
+}
+
 Fonts *Fonts::instance = nullptr;
 
 Fonts::Fonts()
@@ -53,11 +94,7 @@ void Fonts::initialize(Settings &, Paths &)
         [this]() {
             assertInGuiThread();
 
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
-            this->fontChanged.invoke();
+            this->invalidate();
         },
         false);
 
@@ -65,11 +102,7 @@ void Fonts::initialize(Settings &, Paths &)
         [this]() {
             assertInGuiThread();
 
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
-            this->fontChanged.invoke();
+            this->invalidate();
         },
         false);
 
@@ -81,16 +114,24 @@ void Fonts::initialize(Settings &, Paths &)
             // REMOVED
             getApp()->windows->incGeneration();
 
-            for (auto &map : this->fontsByType_)
-            {
-                map.clear();
-            }
-            this->fontChanged.invoke();
+            this->invalidate();
         },
         false);
 #endif
 }
 
+void Fonts::invalidate()
+{
+    for (auto &map : this->fontsByType_)
+    {
+        map.clear();
+    }
+    this->snapshots_.clear();
+    this->generation_++;
+
+    this->fontChanged.invoke();
+}
+
 QFont Fonts::getFont(FontStyle type, float scale)
 {
     return this->getOrCreateFontData(type, scale).font;
@@ -101,6 +142,77 @@ QFontMetrics Fonts::getFontMetrics(FontStyle type, float scale)
     return this->getOrCreateFontData(type, scale).metrics;
 }
 
+int Fonts::horizontalAdvance(FontStyle type, float scale, const QString &text)
+{
+    auto &data = this->getOrCreateFontData(type, scale);
+
+    if (text.size() == 1)
+    {
+        return this->horizontalAdvance(type, scale, text[0]);
+    }
+
+    auto it = data.textAdvances.find(text);
+    if (it != data.textAdvances.end())
+    {
+        return it->second;
+    }
+
+    if (data.textAdvances.size() >= MAX_CACHED_TEXTS)
+    {
+        data.textAdvances.clear();
+    }
+
+    auto advance = data.metrics.horizontalAdvance(text);
+    data.textAdvances.emplace(text, advance);
+    return advance;
+}
+
+int Fonts::horizontalAdvance(FontStyle type, float scale, QChar character)
+{
+    auto &data = this->getOrCreateFontData(type, scale);
+
+    auto code = character.unicode();
+    if (code >= data.asciiAdvances.size())
+    {
+        return data.metrics.horizontalAdvance(character);
+    }
+
+    auto &advance = data.asciiAdvances[code];
+    if (advance == -1)
+    {
+        advance = data.metrics.horizontalAdvance(character);
+    }
+    return advance;
+}
+
+std::shared_ptr<const FontMetricsSnapshot> Fonts::getSnapshot(float scale)
+{
+    assertInGuiThread();
+
+    auto it = this->snapshots_.find(scale);
+    if (it != this->snapshots_.end())
+    {
+        return it->second;
+    }
+
+    std::vector<QFont> fonts;
+    fonts.reserve(size_t(FontStyle::EndType));
+    for (size_t i = 0; i < size_t(FontStyle::EndType); i++)
+    {
+        fonts.push_back(this->getFont(FontStyle(i), scale));
+    }
+
+    auto snapshot = std::make_shared<const FontMetricsSnapshot>(
+        std::move(fonts), scale, this->generation_);
+    this->snapshots_.emplace(scale, snapshot);
+    return snapshot;
+}
+
+uint64_t Fonts::generation() const
+{
+    return this->generation_;
+}
+
 Fonts::FontData &Fonts::getOrCreateFontData(FontStyle type, float scale)
 {
     assertInGuiThread();
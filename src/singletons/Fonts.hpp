@@ -2,6 +2,7 @@
 
 #include "common/ChatterinoSetting.hpp"
 #include "common/Singleton.hpp"
+#include "util/QStringHash.hpp"
 
 #include <QFont>
 #include <QFontDatabase>
@@ -10,6 +11,7 @@
 #include <pajlada/signals/signal.hpp>
 
 #include <array>
+#include <memory>
 #include <unordered_map>
 
 namespace chatterino {
@@ -39,6 +41,35 @@ enum class FontStyle : uint8_t {
     ChatEnd = ChatVeryLarge,
 };
 
+/**
+ * @brief The fonts of all styles at one scale, frozen at the time it was
+ *        taken from Fonts.
+ *
+ * Unlike Fonts it can be used from any thread, for example to measure text
+ * while messages are built. QFontMetrics must not be shared between threads,
+ * so each thread should get its own with metrics() and keep it while it
+ * measures. Snapshots don't follow font changes, compare the generation with
+ * Fonts::generation() to find stale ones.
+ */
+class FontMetricsSnapshot
+{
+public:
+    FontMetricsSnapshot(std::vector<QFont> fonts, float scale,
+                        uint64_t generation);
+
+    const QFont &font(FontStyle type) const;
+    QFontMetrics metrics(FontStyle type) const;
+    int horizontalAdvance(FontStyle type, const QString &text) const;
+
+    float scale() const;
+    uint64_t generation() const;
+
+private:
+    const std::vector<QFont> fonts_;
+    const float scale_;
+    const uint64_t generation_;
+};
+
 class Fonts final : public Singleton
 {
 public:
@@ -51,6 +82,17 @@ public:
     QFont getFont(FontStyle type, float scale);
     QFontMetrics getFontMetrics(FontStyle type, float scale);
 
+    // Same as getFontMetrics(type, scale).horizontalAdvance(text) but the
+    // results are cached until the font changes.
+    int horizontalAdvance(FontStyle type, float scale, const QString &text);
+    int horizontalAdvance(FontStyle type, float scale, QChar character);
+
+    /// Returns the fonts of all styles at the scale for use outside of the
+    /// gui thread. The snapshot is shared until the font changes.
+    std::shared_ptr<const FontMetricsSnapshot> getSnapshot(float scale);
+    /// Increased every time the font changes
+    uint64_t generation() const;
+
     QStringSetting chatFontFamily;
     IntSetting chatFontSize;
 
@@ -63,10 +105,15 @@ private:
             : font(_font)
             , metrics(_font)
         {
+            this->asciiAdvances.fill(-1);
         }
 
         const QFont font;
         const QFontMetrics metrics;
+
+        // advances of the ascii characters, -1 if not measured yet
+        std::array<int, 128> asciiAdvances;
+        std::unordered_map<QString, int> textAdvances;
     };
 
     struct ChatFontData {
@@ -84,8 +131,12 @@ private:
 
     FontData &getOrCreateFontData(FontStyle type, float scale);
     FontData createFontData(FontStyle type, float scale);
+    void invalidate();
 
     std::vector<std::unordered_map<float, FontData>> fontsByType_;
+    std::unordered_map<float, std::shared_ptr<const FontMetricsSnapshot>>
+        snapshots_;
+    uint64_t generation_ = 0;
 };
 
 Fonts *getFonts();
@@ -1,8 +1,13 @@
 #include "singletons/Logging.hpp"
 
 #include "Application.hpp"
+#include "common/Args.hpp"
+#include "messages/Message.hpp"
+#include "messages/MessageBuilder.hpp"
+#include "messages/MessageElement.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
+#include "singletons/helper/CompressedLog.hpp"
 
 #include <QDir>
 #include <QStandardPaths>
@@ -11,13 +16,46 @@
 
 namespace chatterino {
 
+namespace {
+
+    const QDateTime SESSION_START = QDateTime::currentDateTime();
+
+    MessagePtr makeLogMessage(const QString &channelName,
+                              const LogEntry &entry)
+    {
+        MessageBuilder builder;
+
+        builder.emplace<TimestampElement>(entry.time.time());
+        for (const auto &word :
+             entry.text.split(' ', QString::SkipEmptyParts))
+        {
+            builder.emplace<TextElement>(word, MessageElementFlag::Text,
+                                         MessageColor::Text);
+        }
+
+        builder->flags.set(MessageFlag::RecentMessage);
+        builder->flags.set(MessageFlag::DoNotTriggerNotification);
+        builder->parseTime = entry.time.time();
+        builder->serverReceivedTime = entry.time;
+        builder->loginName = entry.login;
+        builder->displayName = entry.login;
+        builder->channelName = channelName;
+        builder->messageText = entry.text;
+        builder->searchText = entry.text;
+
+        return builder.release();
+    }
+
+}  // namespace
+
 void Logging::initialize(Settings &settings, Paths &paths)
 {
 }
 
 void Logging::addMessage(const QString &channelName, MessagePtr message)
 {
-    if (!getSettings()->enableLogging)
+    // logging is all a headless run is for
+    if (!getSettings()->enableLogging && !getArgs().headless)
     {
         return;
     }
@@ -25,7 +63,7 @@ void Logging::addMessage(const QString &channelName, MessagePtr message)
     auto it = this->loggingChannels_.find(channelName);
     if (it == this->loggingChannels_.end())
     {
-        auto channel = new LoggingChannel(channelName);
+        auto channel = new LoggingChannel(channelName, this->writer_);
         channel->addMessage(message);
         this->loggingChannels_.emplace(
             channelName, std::unique_ptr<LoggingChannel>(std::move(channel)));
@@ -36,4 +74,62 @@ void Logging::addMessage(const QString &channelName, MessagePtr message)
     }
 }
 
+QDateTime Logging::sessionStart()
+{
+    return SESSION_START;
+}
+
+std::vector<MessagePtr> Logging::loadHistory(const QString &channelName,
+                                             const QDateTime &from,
+                                             const QDateTime &to,
+                                             const QStringList &logins,
+                                             size_t limit)
+{
+    auto logPath = getSettings()->logPath.getValue();
+    QDir directory((logPath.isEmpty() ? getPaths()->messageLogDirectory
+                                      : logPath) +
+                   QDir::separator() +
+                   LoggingChannel::subDirectoryFor(channelName));
+
+    QStringList lowercaseLogins;
+    for (const auto &login : logins)
+    {
+        lowercaseLogins.append(login.toLower());
+    }
+
+    std::vector<LogEntry> entries;
+
+    // one file per day, newest first
+    for (auto date = to.date(); date >= from.date() && entries.size() < limit;
+         date = date.addDays(-1))
+    {
+        auto path = directory.filePath(channelName + "-" +
+                                       date.toString("yyyy-MM-dd") + ".clog");
+        if (!QFile::exists(path))
+        {
+            continue;
+        }
+
+        auto dayEntries =
+            CompressedLogReader(path).read(from.toMSecsSinceEpoch(),
+                                           to.toMSecsSinceEpoch(),
+                                           lowercaseLogins);
+        entries.insert(entries.begin(), dayEntries.begin(), dayEntries.end());
+    }
+
+    if (entries.size() > limit)
+    {
+        entries.erase(entries.begin(), entries.end() - limit);
+    }
+
+    std::vector<MessagePtr> messages;
+    messages.reserve(entries.size());
+    for (const auto &entry : entries)
+    {
+        messages.push_back(makeLogMessage(channelName, entry));
+    }
+
+    return messages;
+}
+
 }  // namespace chatterino
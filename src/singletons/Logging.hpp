@@ -3,6 +3,7 @@
 #include "common/Singleton.hpp"
 
 #include "messages/Message.hpp"
+#include "singletons/helper/LogWriter.hpp"
 #include "singletons/helper/LoggingChannel.hpp"
 
 #include <memory>
@@ -22,7 +23,29 @@ public:
 
     void addMessage(const QString &channelName, MessagePtr message);
 
+    /// When this session started, everything logged before is only in the logs
+    static QDateTime sessionStart();
+
+    /**
+     * @brief Loads messages of channelName from its compressed logs.
+     *
+     * Only the blocks of the logs that can contain matching messages are
+     * decompressed. Can be called from any thread, it reads from the disk.
+     *
+     * @param logins    only load messages of these logins, all if empty
+     * @param limit     the maximum amount of messages, the newest are kept
+     * @return          the messages, oldest first
+     */
+    static std::vector<MessagePtr> loadHistory(const QString &channelName,
+                                               const QDateTime &from,
+                                               const QDateTime &to,
+                                               const QStringList &logins,
+                                               size_t limit);
+
 private:
+    // declared first so it outlives the channels, which queue their closing
+    // lines on destruction
+    LogWriter writer_;
     std::map<QString, std::unique_ptr<LoggingChannel>> loggingChannels_;
 };
 
@@ -0,0 +1,179 @@
+#include "singletons/MetricsExporter.hpp"
+
+#include "Application.hpp"
+#include "common/Channel.hpp"
+#include "common/QLogging.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+#include "singletons/Settings.hpp"
+#include "util/DebugCount.hpp"
+
+#include <QSaveFile>
+#include <QTcpServer>
+#include <QTcpSocket>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr int FILE_INTERVAL = 15 * 1000;
+    constexpr int LAG_INTERVAL = 100;
+
+    // how much later than planned the lag timer fired
+    DebugHistogram eventLoopLag("gui event loop lag");
+
+    QString escapeLabel(QString value)
+    {
+        return value.replace('\\', "\\\\")
+            .replace('"', "\\\"")
+            .replace('\n', "\\n");
+    }
+
+    QString metricName(const QString &name)
+    {
+        QString result;
+        for (auto c : name.toLower())
+        {
+            auto isAscii = c.isLetterOrNumber() && c.unicode() < 128;
+            result += isAscii ? c : QChar('_');
+        }
+        return result;
+    }
+
+}  // namespace
+
+MetricsExporter::MetricsExporter() = default;
+
+MetricsExporter::~MetricsExporter() = default;
+
+void MetricsExporter::initialize(Settings &settings, Paths & /*paths*/)
+{
+    this->file_ = settings.metricsFile;
+    auto port = settings.metricsPort.getValue();
+
+    if (this->file_.isEmpty() && port <= 0)
+    {
+        return;
+    }
+
+    this->lagTimer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->lagTimer_, &QTimer::timeout, [this] {
+        this->checkLag();
+    });
+    this->sinceLagCheck_.start();
+    this->lagTimer_.start(LAG_INTERVAL);
+
+    if (!this->file_.isEmpty())
+    {
+        QObject::connect(&this->fileTimer_, &QTimer::timeout, [this] {
+            this->writeFile();
+        });
+        this->fileTimer_.start(FILE_INTERVAL);
+    }
+
+    if (port > 0)
+    {
+        this->server_ = std::make_unique<QTcpServer>();
+        if (!this->server_->listen(QHostAddress::LocalHost, quint16(port)))
+        {
+            qCWarning(chatterinoApp)
+                << "Metrics can't listen on port" << port << ":"
+                << this->server_->errorString();
+            this->server_.reset();
+            return;
+        }
+
+        QObject::connect(this->server_.get(), &QTcpServer::newConnection,
+                         [this] {
+                             this->serve();
+                         });
+    }
+}
+
+QString MetricsExporter::render()
+{
+    QString text;
+
+    text += "# TYPE chatterino_debug_count gauge\n";
+    for (const auto &value : DebugCount::values())
+    {
+        text += QString("chatterino_debug_count{name=\"%1\"} %2\n")
+                    .arg(escapeLabel(value.name))
+                    .arg(value.value);
+    }
+
+    for (const auto *histogram : DebugCount::histograms())
+    {
+        auto name = "chatterino_" + metricName(histogram->name()) + "_seconds";
+        auto snapshot = histogram->snapshot();
+
+        text += "# TYPE " + name + " summary\n";
+        for (auto quantile : {0.5, 0.9, 0.99})
+        {
+            text += QString("%1{quantile=\"%2\"} %3\n")
+                        .arg(name)
+                        .arg(quantile)
+                        .arg(snapshot.percentile(quantile) / 1e6);
+        }
+        text += QString("%1_sum %2\n").arg(name).arg(snapshot.sum / 1e6);
+        text += QString("%1_count %2\n").arg(name).arg(snapshot.count);
+    }
+
+    text += "# TYPE chatterino_channel_messages_total counter\n";
+    getApp()->twitch->forEachChannel([&text](ChannelPtr channel) {
+        text +=
+            QString("chatterino_channel_messages_total{channel=\"%1\"} %2\n")
+                .arg(escapeLabel(channel->getName()))
+                .arg(channel->addedMessageCount());
+    });
+
+    return text;
+}
+
+void MetricsExporter::writeFile()
+{
+    QSaveFile file(this->file_);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        qCWarning(chatterinoApp) << "Failed to write metrics to" << this->file_;
+        return;
+    }
+
+    file.write(render().toUtf8());
+    file.commit();
+}
+
+void MetricsExporter::serve()
+{
+    while (auto *socket = this->server_->nextPendingConnection())
+    {
+        QObject::connect(socket, &QTcpSocket::disconnected, socket,
+                         &QObject::deleteLater);
+
+        // answers once the request headers are through, whatever they ask for
+        QObject::connect(socket, &QTcpSocket::readyRead, socket, [socket] {
+            while (socket->canReadLine())
+            {
+                if (socket->readLine().trimmed().isEmpty())
+                {
+                    auto body = render().toUtf8();
+                    socket->write("HTTP/1.0 200 OK\r\n"
+                                  "Content-Type: text/plain; version=0.0.4\r\n"
+                                  "Content-Length: " +
+                                  QByteArray::number(body.size()) +
+                                  "\r\n\r\n" + body);
+                    socket->disconnectFromHost();
+                    return;
+                }
+            }
+        });
+    }
+}
+
+void MetricsExporter::checkLag()
+{
+    auto elapsed = this->sinceLagCheck_.restart();
+    eventLoopLag.record(
+        std::chrono::milliseconds(std::max<qint64>(elapsed - LAG_INTERVAL, 0)));
+}
+
+}  // namespace chatterino
@@ -0,0 +1,50 @@
+#pragma once
+
+#include "common/Singleton.hpp"
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+
+#include <memory>
+
+class QTcpServer;
+
+namespace chatterino {
+
+/**
+ * @brief Exports the debug counts and histograms, the message counts of the
+ *        channels and the event loop lag in the Prometheus text format.
+ *
+ * Opt-in through the metricsFile and metricsPort settings. The file is
+ * rewritten periodically so the textfile collector of the node exporter can
+ * pick it up, the port answers every HTTP request on localhost with the
+ * current metrics.
+ *
+ * Gui thread only.
+ */
+class MetricsExporter final : public Singleton
+{
+public:
+    MetricsExporter();
+    ~MetricsExporter() override;
+
+    void initialize(Settings &settings, Paths &paths) override;
+
+    /// All metrics in the Prometheus text format
+    static QString render();
+
+private:
+    void writeFile();
+    void serve();
+    void checkLag();
+
+    QString file_;
+    QTimer fileTimer_;
+    std::unique_ptr<QTcpServer> server_;
+
+    QTimer lagTimer_;
+    QElapsedTimer sinceLagCheck_;
+};
+
+}  // namespace chatterino
@@ -26,10 +26,13 @@ namespace ipc = boost::interprocess;
 #    include "widgets/AttachedWindow.hpp"
 #endif
 
+#include <algorithm>
 #include <iostream>
 
 #define EXTENSION_ID "glknmaideaikkmemifbfkhnomoknepka"
 #define MESSAGE_SIZE 1024
+// messages that arrive this long after another one are handled together
+#define BATCH_DELAY_MS 50
 
 namespace chatterino {
 
@@ -155,27 +158,55 @@ void NativeMessagingServer::ReceiverThread::run()
         ipc::message_queue messageQueue(ipc::open_or_create, "chatterino_gui",
                                         100, MESSAGE_SIZE);
 
+        auto buf = std::make_unique<char[]>(MESSAGE_SIZE);
+
         while (true)
         {
+            Batch batch;
+
             try
             {
-                auto buf = std::make_unique<char[]>(MESSAGE_SIZE);
                 auto retSize = ipc::message_queue::size_type();
                 auto priority = static_cast<unsigned int>(0);
 
                 messageQueue.receive(buf.get(), MESSAGE_SIZE, retSize,
                                      priority);
-
-                auto document = QJsonDocument::fromJson(
-                    QByteArray::fromRawData(buf.get(), retSize));
-
-                this->handleMessage(document.object());
+                this->handleMessage(
+                    QJsonDocument::fromJson(
+                        QByteArray::fromRawData(buf.get(), int(retSize)))
+                        .object(),
+                    batch);
+
+                // switching tabs sends a burst of messages, only the last
+                // state of each window is applied
+                auto deadline =
+                    boost::posix_time::microsec_clock::universal_time() +
+                    boost::posix_time::milliseconds(BATCH_DELAY_MS);
+                while (messageQueue.timed_receive(buf.get(), MESSAGE_SIZE,
+                                                  retSize, priority, deadline))
+                {
+                    this->handleMessage(
+                        QJsonDocument::fromJson(
+                            QByteArray::fromRawData(buf.get(), int(retSize)))
+                            .object(),
+                        batch);
+                }
             }
             catch (ipc::interprocess_exception &ex)
             {
                 qCDebug(chatterinoNativeMessage)
                     << "received from gui process:" << ex.what();
             }
+
+            if (!batch.empty())
+            {
+                postToThread([batch = std::move(batch)] {
+                    for (const auto &work : batch)
+                    {
+                        work.second();
+                    }
+                });
+            }
         }
     }
     catch (ipc::interprocess_exception &ex)
@@ -187,8 +218,22 @@ void NativeMessagingServer::ReceiverThread::run()
     }
 }
 
+void NativeMessagingServer::ReceiverThread::addToBatch(
+    Batch &batch, const QString &key, std::function<void()> work)
+{
+    auto it = std::find_if(batch.begin(), batch.end(), [&](const auto &item) {
+        return item.first == key;
+    });
+    if (it != batch.end())
+    {
+        batch.erase(it);
+    }
+
+    batch.emplace_back(key, std::move(work));
+}
+
 void NativeMessagingServer::ReceiverThread::handleMessage(
-    const QJsonObject &root)
+    const QJsonObject &root, Batch &batch)
 {
     auto app = getApp();
     QString action = root.value("action").toString();
@@ -237,7 +282,12 @@ void NativeMessagingServer::ReceiverThread::handleMessage(
 
         if (_type == "twitch")
         {
-            postToThread([=] {
+#ifdef USEWINSDK
+            auto key = args.winId;
+#else
+            QString key;
+#endif
+            addToBatch(batch, key, [=] {
                 if (!name.isEmpty())
                 {
                     app->twitch->watchingChannel.reset(
@@ -276,7 +326,7 @@ void NativeMessagingServer::ReceiverThread::handleMessage(
         }
 
 #ifdef USEWINSDK
-        postToThread([winId] {
+        addToBatch(batch, winId, [winId] {
             qCDebug(chatterinoNativeMessage) << "NW detach";
             AttachedWindow::detach(winId);
         });
@@ -5,6 +5,10 @@
 #include <boost/optional.hpp>
 #include <common/Atomic.hpp>
 
+#include <functional>
+#include <utility>
+#include <vector>
+
 namespace chatterino {
 
 class Application;
@@ -34,7 +38,13 @@ private:
         void run() override;
 
     private:
-        void handleMessage(const QJsonObject &root);
+        // the latest work for the gui of every window, in the order the
+        // windows changed in
+        using Batch = std::vector<std::pair<QString, std::function<void()>>>;
+
+        void handleMessage(const QJsonObject &root, Batch &batch);
+        static void addToBatch(Batch &batch, const QString &key,
+                               std::function<void()> work);
     };
 
     ReceiverThread thread;
@@ -63,6 +63,11 @@ QString Paths::cacheDirectory()
     return path;
 }
 
+QString Paths::imageCacheDirectory()
+{
+    return this->cacheDirectory() + "/images";
+}
+
 void Paths::initAppFilePathHash()
 {
     this->applicationFilePathHash =
@@ -35,6 +35,8 @@ public:
     bool isPortable();
 
     QString cacheDirectory();
+    // Decoded images, see ImageCache. Same as <cacheDirectory>/images
+    QString imageCacheDirectory();
 
 private:
     void initAppFilePathHash();
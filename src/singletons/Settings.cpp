@@ -1,20 +1,83 @@
 #include "singletons/Settings.hpp"
 
 #include "Application.hpp"
+#include "common/Args.hpp"
+#include "controllers/highlights/HighlightBlacklistMatcher.hpp"
 #include "controllers/highlights/HighlightBlacklistUser.hpp"
 #include "controllers/highlights/HighlightPhrase.hpp"
 #include "controllers/ignores/IgnorePhrase.hpp"
 #include "singletons/Paths.hpp"
 #include "singletons/Resources.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/CombinePath.hpp"
 #include "util/PersistSignalVector.hpp"
+#include "util/SettingsWriter.hpp"
 #include "util/WindowsHelper.hpp"
 
+#include <QtConcurrent>
+
+#include <mutex>
+#include <unordered_set>
+
 namespace chatterino {
 
+namespace {
+
+    // SignalVector replaces its read only copy on every change
+    std::shared_ptr<const std::unordered_set<QString>> getMutedChannelSet(
+        SignalVector<QString> &mutedChannels)
+    {
+        static std::mutex mutex;
+        static std::shared_ptr<const std::vector<QString>> channels;
+        static std::shared_ptr<const std::unordered_set<QString>> set;
+
+        auto current = mutedChannels.readOnly();
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (!set || current != channels)
+        {
+            auto lowercase = std::make_shared<std::unordered_set<QString>>();
+            for (const auto &channel : *current)
+            {
+                lowercase->insert(channel.toLower());
+            }
+            set = std::move(lowercase);
+            channels = current;
+        }
+
+        return set;
+    }
+
+}  // namespace
+
+ListSettingsFile::ListSettingsFile(const QString &settingsDirectory)
+    : path_(combinePath(settingsDirectory, "lists.json"))
+    , manager_(std::make_shared<pajlada::Settings::SettingManager>())
+{
+    this->manager_->setPath(qPrintable(this->path_));
+    this->manager_->setBackupEnabled(true);
+    this->manager_->setBackupSlots(9);
+
+    this->loaded_ = QtConcurrent::run([manager = this->manager_] {
+        manager->load();
+    });
+}
+
+const QString &ListSettingsFile::listsPath() const
+{
+    return this->path_;
+}
+
+const std::shared_ptr<pajlada::Settings::SettingManager>
+    &ListSettingsFile::listsManager()
+{
+    this->loaded_.waitForFinished();
+    return this->manager_;
+}
+
 ConcurrentSettings *concurrentInstance_{};
 
-ConcurrentSettings::ConcurrentSettings()
+ConcurrentSettings::ConcurrentSettings(ListSettingsFile &lists)
     // NOTE: these do not get deleted
     : highlightedMessages(*new SignalVector<HighlightPhrase>())
     , highlightedUsers(*new SignalVector<HighlightPhrase>())
@@ -26,16 +89,25 @@ ConcurrentSettings::ConcurrentSettings()
     , nicknames(*new SignalVector<Nickname>())
     , moderationActions(*new SignalVector<ModerationAction>)
 {
-    persist(this->highlightedMessages, "/highlighting/highlights");
-    persist(this->blacklistedUsers, "/highlighting/blacklist");
-    persist(this->highlightedBadges, "/highlighting/badges");
-    persist(this->highlightedUsers, "/highlighting/users");
-    persist(this->ignoredMessages, "/ignore/phrases");
-    persist(this->mutedChannels, "/pings/muted");
-    persist(this->filterRecords, "/filtering/filters");
-    persist(this->nicknames, "/nicknames");
+    const auto &manager = lists.listsManager();
+    auto save = [manager, path = lists.listsPath()] {
+        if (!getArgs().dontSaveSettings)
+        {
+            SettingsWriter::instance().queue(manager, path);
+        }
+    };
+
+    persist(this->highlightedMessages, "/highlighting/highlights", manager,
+            save);
+    persist(this->blacklistedUsers, "/highlighting/blacklist", manager, save);
+    persist(this->highlightedBadges, "/highlighting/badges", manager, save);
+    persist(this->highlightedUsers, "/highlighting/users", manager, save);
+    persist(this->ignoredMessages, "/ignore/phrases", manager, save);
+    persist(this->mutedChannels, "/pings/muted", manager, save);
+    persist(this->filterRecords, "/filtering/filters", manager, save);
+    persist(this->nicknames, "/nicknames", manager, save);
     // tagged users?
-    persist(this->moderationActions, "/moderation/actions");
+    persist(this->moderationActions, "/moderation/actions", manager, save);
 }
 
 bool ConcurrentSettings::isHighlightedUser(const QString &username)
@@ -53,29 +125,14 @@ bool ConcurrentSettings::isHighlightedUser(const QString &username)
 
 bool ConcurrentSettings::isBlacklistedUser(const QString &username)
 {
-    auto items = this->blacklistedUsers.readOnly();
-
-    for (const auto &blacklistedUser : *items)
-    {
-        if (blacklistedUser.isMatch(username))
-            return true;
-    }
-
-    return false;
+    return getHighlightBlacklistMatcher()->isMatch(username);
 }
 
 bool ConcurrentSettings::isMutedChannel(const QString &channelName)
 {
-    auto items = this->mutedChannels.readOnly();
+    auto channels = getMutedChannelSet(this->mutedChannels);
 
-    for (const auto &channel : *items)
-    {
-        if (channelName.toLower() == channel.toLower())
-        {
-            return true;
-        }
-    }
-    return false;
+    return channels->find(channelName.toLower()) != channels->end();
 }
 
 void ConcurrentSettings::mute(const QString &channelName)
@@ -121,11 +178,24 @@ ConcurrentSettings &getCSettings()
 Settings *Settings::instance_ = nullptr;
 
 Settings::Settings(const QString &settingsDirectory)
-    : ABSettings(settingsDirectory)
+    : ListSettingsFile(settingsDirectory)
+    , ABSettings(settingsDirectory)
+    , ConcurrentSettings(static_cast<ListSettingsFile &>(*this))
+    , settingsPath_(combinePath(settingsDirectory, "settings.json"))
 {
     instance_ = this;
     concurrentInstance_ = this;
 
+    this->layoutSettingsListener_.addSetting(this->compactEmotes);
+    this->layoutSettingsListener_.addSetting(this->removeSpacesBetweenEmotes);
+    this->layoutSettingsListener_.addSetting(this->collpseMessagesMinLines);
+    this->layoutSettingsListener_.addSetting(this->emoteScale);
+    this->layoutSettingsListener_.addSetting(this->timestampFormat);
+    this->layoutSettingsListener_.setCB([this] {
+        this->updateLayoutSettings();
+    });
+    this->updateLayoutSettings();
+
 #ifdef USEWINSDK
     this->autorun = isRegisteredForStartup();
     this->autorun.connect(
@@ -141,6 +211,32 @@ Settings &Settings::instance()
     return *instance_;
 }
 
+void Settings::queueSave()
+{
+    SettingsWriter::instance().queue(
+        pajlada::Settings::SettingManager::getInstance(), this->settingsPath_);
+}
+
+std::shared_ptr<const LayoutSettings> Settings::layoutSettings() const
+{
+    return std::atomic_load(&this->layoutSettings_);
+}
+
+void Settings::updateLayoutSettings()
+{
+    auto settings = std::make_shared<LayoutSettings>();
+    settings->compactEmotes = this->compactEmotes.getValue();
+    settings->removeSpacesBetweenEmotes =
+        this->removeSpacesBetweenEmotes.getValue();
+    settings->collapseMessagesMinLines =
+        this->collpseMessagesMinLines.getValue();
+    settings->emoteScale = this->emoteScale.getValue();
+    settings->timestampFormat = this->timestampFormat.getValue();
+
+    std::shared_ptr<const LayoutSettings> published = std::move(settings);
+    std::atomic_store(&this->layoutSettings_, std::move(published));
+}
+
 Settings *getSettings()
 {
     return &Settings::instance();
@@ -15,6 +15,8 @@
 #include "util/StreamerMode.hpp"
 #include "widgets/Notebook.hpp"
 
+#include <QFuture>
+
 using TimeoutButton = std::pair<QString, int>;
 
 namespace chatterino {
@@ -25,11 +27,29 @@ class IgnorePhrase;
 class FilterRecord;
 class Nickname;
 
+/// lists.json, the large lists of ConcurrentSettings are kept there so
+/// settings.json stays small. Settings derives from it first, so it's parsed
+/// on a background thread while settings.json is parsed.
+class ListSettingsFile
+{
+public:
+    explicit ListSettingsFile(const QString &settingsDirectory);
+
+    const QString &listsPath() const;
+    /// Waits until lists.json is parsed
+    const std::shared_ptr<pajlada::Settings::SettingManager> &listsManager();
+
+private:
+    QString path_;
+    std::shared_ptr<pajlada::Settings::SettingManager> manager_;
+    QFuture<void> loaded_;
+};
+
 /// Settings which are availlable for reading on all threads.
 class ConcurrentSettings
 {
 public:
-    ConcurrentSettings();
+    explicit ConcurrentSettings(ListSettingsFile &lists);
 
     SignalVector<HighlightPhrase> &highlightedMessages;
     SignalVector<HighlightPhrase> &highlightedUsers;
@@ -58,9 +78,21 @@ enum UsernameDisplayMode : int {
     LocalizedName = 2,             // Localized name
     UsernameAndLocalizedName = 3,  // Username (Localized name)
 };
+/// Copies of the settings that are read for every element while messages are
+/// laid out. Available for reading on all threads.
+struct LayoutSettings {
+    bool compactEmotes = true;
+    bool removeSpacesBetweenEmotes = false;
+    int collapseMessagesMinLines = 0;
+    float emoteScale = 1.f;
+    QString timestampFormat;
+};
+
 /// Settings which are availlable for reading and writing on the gui thread.
 // These settings are still accessed concurrently in the code but it is bad practice.
-class Settings : public ABSettings, public ConcurrentSettings
+class Settings : public ListSettingsFile,
+                 public ABSettings,
+                 public ConcurrentSettings
 {
     static Settings *instance_;
 
@@ -69,6 +101,14 @@ public:
 
     static Settings &instance();
 
+    /// Saves settings.json soon, off the gui thread. The lists are saved
+    /// whenever they change.
+    void queueSave();
+
+    /// The current values of the layout settings. A new snapshot is
+    /// published whenever one of them changes, old ones stay unchanged.
+    std::shared_ptr<const LayoutSettings> layoutSettings() const;
+
     /// Appearance
     BoolSetting showTimestamps = {"/appearance/messages/showTimestamps", true};
     BoolSetting animationsWhenFocused = {
@@ -308,6 +348,11 @@ public:
     BoolSetting enableLogging = {"/logging/enabled", false};
 
     QStringSetting logPath = {"/logging/path", ""};
+    // in milliseconds, how long lines are collected before they're written
+    IntSetting logFlushInterval = {"/logging/flushInterval", 1000};
+    BoolSetting logSyncToDisk = {"/logging/syncToDisk", false};
+    // write compressed, indexed logs, see CompressedLogWriter
+    BoolSetting logCompressed = {"/logging/compressed", false};
 
     QStringSetting pathHighlightSound = {"/highlighting/highlightSoundPath",
                                          ""};
@@ -361,10 +406,14 @@ public:
 
     /// Misc
     BoolSetting betaUpdates = {"/misc/beta", false};
+#ifdef Q_OS_WIN
+    BoolSetting prefetchUpdates = {"/misc/prefetchUpdates", true};
+#endif
 #ifdef Q_OS_LINUX
     BoolSetting useKeyring = {"/misc/useKeyring", true};
 #endif
     BoolSetting enableExperimentalIrc = {"/misc/experimentalIrc", false};
+    BoolSetting openGLRendering = {"/misc/openGLRendering", false};
 
     IntSetting startUpNotification = {"/misc/startUpNotification", 0};
     QStringSetting currentVersion = {"/misc/currentVersion", ""};
@@ -375,11 +424,33 @@ public:
         "/misc/twitch/messageHistoryLimit",
         800,
     };
+    IntSetting twitchMessageHistoryConcurrentLoads = {
+        "/misc/twitch/messageHistoryConcurrentLoads",
+        4,
+    };
+    /// Keep the recent chat of channels on disk and show it on startup before
+    /// the message history is loaded, see HistorySpill
+    BoolSetting persistMessageHistory = {"/misc/twitch/persistMessageHistory",
+                                         false};
+    /// The account is a verified bot, which Twitch lets join channels much
+    /// faster. There's no way to ask Twitch, so it has to be set by hand.
+    BoolSetting twitchVerifiedBot = {"/misc/twitch/verifiedBot", false};
 
     IntSetting emotesTooltipPreview = {"/misc/emotesTooltipPreview", 1};
+    // in MiB, shared by the drawing buffers of all messages
+    IntSetting messageBufferBudget = {"/misc/messageBufferBudget", 256};
+    BoolSetting dormantHiddenChannels = {"/misc/dormantHiddenChannels", false};
+    // in MiB, 0 for no budget. Once the messages of all channels take more,
+    // channels that are only shown in tabs that aren't selected keep fewer
+    // messages, see WindowManager::updateMessageLimits
+    IntSetting messageMemoryBudget = {"/misc/messageMemoryBudget", 0};
+    // in MiB, shared by the frames of all images loaded from an url
+    IntSetting imageMemoryBudget = {"/misc/imageMemoryBudget", 512};
     BoolSetting openLinksIncognito = {"/misc/openLinksIncognito", 0};
 
     QStringSetting cachePath = {"/cache/path", ""};
+    // in MiB, see ImageCache
+    IntSetting imageCacheSize = {"/cache/imageCacheSize", 1024};
     BoolSetting restartOnCrash = {"/misc/restartOnCrash", false};
     BoolSetting attachExtensionToAnyProcess = {
         "/misc/attachExtensionToAnyProcess", false};
@@ -387,10 +458,18 @@ public:
     BoolSetting informOnTabVisibilityToggle = {"/misc/askOnTabVisibilityToggle",
                                                true};
     BoolSetting lockNotebookLayout = {"/misc/lockNotebookLayout", false};
+    // Prometheus metrics for monitoring, off while empty and 0. The file is
+    // rewritten every 15 seconds, the port only listens on localhost.
+    QStringSetting metricsFile = {"/misc/metrics/file", ""};
+    IntSetting metricsPort = {"/misc/metrics/port", 0};
 
     /// Debug
     BoolSetting showUnhandledIrcMessages = {"/debug/showUnhandledIrcMessages",
                                             false};
+    // Logs whenever the gui thread is blocked for longer than the deadline (ms)
+    BoolSetting eventLoopWatchdog = {"/debug/eventLoopWatchdog", false};
+    IntSetting eventLoopWatchdogDeadline = {
+        "/debug/eventLoopWatchdogDeadline", 50};
 
     /// UI
     // Purely QOL settings are here (like last item in a list).
@@ -428,6 +507,11 @@ public:
 
 private:
     void updateModerationActions();
+    void updateLayoutSettings();
+
+    QString settingsPath_;
+    std::shared_ptr<const LayoutSettings> layoutSettings_;
+    pajlada::SettingListener layoutSettingsListener_;
 };
 
 }  // namespace chatterino
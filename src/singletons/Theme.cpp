@@ -12,6 +12,14 @@
 
 namespace chatterino {
 
+namespace {
+
+    // most of them are username colors, the cache starts over once this many
+    // different ones were normalized
+    constexpr size_t MAX_NORMALIZED_COLORS = 4096;
+
+}  // namespace
+
 Theme::Theme()
 {
     this->update();
@@ -34,6 +42,11 @@ void Theme::actuallyUpdate(double hue, double multiplier)
 {
     BaseTheme::actuallyUpdate(hue, multiplier);
 
+    {
+        std::lock_guard<std::mutex> lock(this->normalizedColorsMutex_);
+        this->normalizedColors_.clear();
+    }
+
     auto getColor = [multiplier](double h, double s, double l, double a = 1.0) {
         return QColor::fromHslF(h, s, ((l - 0.5) * multiplier) + 0.5, a);
     };
@@ -99,6 +112,28 @@ void Theme::actuallyUpdate(double hue, double multiplier)
 }
 
 void Theme::normalizeColor(QColor &color)
+{
+    auto rgba = color.rgba();
+
+    std::lock_guard<std::mutex> lock(this->normalizedColorsMutex_);
+
+    auto it = this->normalizedColors_.find(rgba);
+    if (it != this->normalizedColors_.end())
+    {
+        color = QColor::fromRgba(it->second);
+        return;
+    }
+
+    if (this->normalizedColors_.size() >= MAX_NORMALIZED_COLORS)
+    {
+        this->normalizedColors_.clear();
+    }
+
+    this->actuallyNormalizeColor(color);
+    this->normalizedColors_.emplace(rgba, color.rgba());
+}
+
+void Theme::actuallyNormalizeColor(QColor &color) const
 {
     if (this->isLightTheme())
     {
@@ -9,6 +9,9 @@
 #include <pajlada/settings/setting.hpp>
 #include <singletons/Settings.hpp>
 
+#include <mutex>
+#include <unordered_map>
+
 namespace chatterino {
 
 class WindowManager;
@@ -54,10 +57,16 @@ public:
         QPixmap copy;
     } buttons;
 
+    // thread safe, the results are cached until the theme changes
     void normalizeColor(QColor &color);
 
 private:
     void actuallyUpdate(double hue, double multiplier) override;
+    void actuallyNormalizeColor(QColor &color) const;
+
+    // rgba colors and their normalized ones
+    std::mutex normalizedColorsMutex_;
+    std::unordered_map<QRgb, QRgb> normalizedColors_;
 
     pajlada::Signals::NoArgSignal repaintVisibleChatWidgets_;
 
@@ -9,6 +9,7 @@
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "providers/twitch/api/Helix.hpp"
 #include "singletons/Paths.hpp"
+#include "util/PostToThread.hpp"
 #include "util/StreamLink.hpp"
 #include "widgets/helper/CommonTexts.hpp"
 
@@ -66,17 +67,25 @@ QString Toasts::findStringFromReaction(
     return Toasts::findStringFromReaction(static_cast<ToastReaction>(i));
 }
 
+Toasts::~Toasts()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->condition_.notify_one();
+
+    if (this->thread_.joinable())
+    {
+        this->thread_.join();
+    }
+}
+
 void Toasts::sendChannelNotification(const QString &channelName, Platform p)
 {
-#ifdef Q_OS_WIN
     auto sendChannelNotification = [this, channelName, p] {
-        this->sendWindowsNotification(channelName, p);
-    };
-#else
-    auto sendChannelNotification = [] {
-        // Unimplemented for OSX and Linux
+        this->enqueue(channelName, p);
     };
-#endif
     // Fetch user profile avatar
     if (p == Platform::Twitch)
     {
@@ -104,6 +113,60 @@ void Toasts::sendChannelNotification(const QString &channelName, Platform p)
     }
 }
 
+void Toasts::enqueue(const QString &channelName, Platform p)
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->queue_.push(channelName, p, ToastQueue::Clock::now());
+
+        if (!this->thread_.joinable())
+        {
+            this->thread_ = std::thread([this] {
+                this->run();
+            });
+        }
+    }
+    this->condition_.notify_one();
+}
+
+void Toasts::run()
+{
+#ifdef Q_OS_WIN
+    CoInitializeEx(nullptr, COINIT_MULTITHREADED);
+#endif
+
+    std::unique_lock<std::mutex> lock(this->mutex_);
+    while (!this->stopping_)
+    {
+        if (this->queue_.empty())
+        {
+            this->condition_.wait(lock);
+            continue;
+        }
+
+        auto toast = this->queue_.take(ToastQueue::Clock::now());
+        if (!toast)
+        {
+            // later toasts can only be merged into this one, they don't
+            // make it due earlier
+            this->condition_.wait_until(lock, this->queue_.nextDue());
+            continue;
+        }
+
+        lock.unlock();
+#ifdef Q_OS_WIN
+        this->sendWindowsNotification(*toast);
+#else
+        // Unimplemented for OSX and Linux
+#endif
+        lock.lock();
+    }
+
+#ifdef Q_OS_WIN
+    CoUninitialize();
+#endif
+}
+
 #ifdef Q_OS_WIN
 
 class CustomHandler : public WinToastLib::IWinToastHandler
@@ -119,6 +182,15 @@ public:
     {
     }
     void toastActivated() const
+    {
+        // called from a thread of the notification api
+        postToThread([channelName = this->channelName_,
+                      platform = this->platform_] {
+            CustomHandler::activate(channelName, platform);
+        });
+    }
+
+    static void activate(const QString &channelName, Platform platform)
     {
         QString link;
         auto toastReaction =
@@ -127,23 +199,23 @@ public:
         switch (toastReaction)
         {
             case ToastReaction::OpenInBrowser:
-                if (platform_ == Platform::Twitch)
+                if (platform == Platform::Twitch)
                 {
-                    link = "http://www.twitch.tv/" + channelName_;
+                    link = "http://www.twitch.tv/" + channelName;
                 }
                 QDesktopServices::openUrl(QUrl(link));
                 break;
             case ToastReaction::OpenInPlayer:
-                if (platform_ == Platform::Twitch)
+                if (platform == Platform::Twitch)
                 {
                     link =
                         "https://player.twitch.tv/?parent=twitch.tv&channel=" +
-                        channelName_;
+                        channelName;
                 }
                 QDesktopServices::openUrl(QUrl(link));
                 break;
             case ToastReaction::OpenInStreamlink: {
-                openStreamlinkForChannel(channelName_);
+                openStreamlinkForChannel(channelName);
                 break;
             }
                 // the fourth and last option is "don't open"
@@ -164,11 +236,15 @@ public:
     }
 };
 
-void Toasts::sendWindowsNotification(const QString &channelName, Platform p)
+void Toasts::sendWindowsNotification(const ToastQueue::Toast &toast)
 {
+    // a summary shows and opens the channel that went live first
+    const auto &channelName = toast.channels.front().name;
+    auto p = toast.channels.front().platform;
+
     WinToastLib::WinToastTemplate templ = WinToastLib::WinToastTemplate(
         WinToastLib::WinToastTemplate::ImageAndText03);
-    QString str = channelName + " is live!";
+    QString str = toast.text();
     std::string utf8_text = str.toUtf8().constData();
     std::wstring widestr = std::wstring(utf8_text.begin(), utf8_text.end());
 
@@ -2,9 +2,14 @@
 
 #include "Application.hpp"
 #include "common/Singleton.hpp"
+#include "singletons/helper/ToastQueue.hpp"
 
 #include <pajlada/settings/setting.hpp>
 
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+
 namespace chatterino {
 
 enum class Platform : uint8_t;
@@ -16,9 +21,14 @@ enum class ToastReaction {
     DontOpen = 3
 };
 
+/// Toasts are shown from a thread of their own, so the gui doesn't wait on
+/// the platform's notification api. Channels that go live at the same time
+/// are merged into one toast, see ToastQueue.
 class Toasts final : public Singleton
 {
 public:
+    ~Toasts() override;
+
     void sendChannelNotification(const QString &channelName, Platform p);
     static QString findStringFromReaction(const ToastReaction &reaction);
     static QString findStringFromReaction(
@@ -28,8 +38,19 @@ public:
     static bool isEnabled();
 
 private:
+    // queues the toast once the avatar is on disk
+    void enqueue(const QString &channelName, Platform p);
+    void run();
+
 #ifdef Q_OS_WIN
-    void sendWindowsNotification(const QString &channelName, Platform p);
+    void sendWindowsNotification(const ToastQueue::Toast &toast);
 #endif
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    ToastQueue queue_;
+    bool stopping_ = false;
+    // started with the first toast
+    std::thread thread_;
 };
 }  // namespace chatterino
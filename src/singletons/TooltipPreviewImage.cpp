@@ -5,6 +5,9 @@
 #include "widgets/TooltipWidget.hpp"
 
 namespace chatterino {
+namespace {
+    constexpr int LOAD_DELAY_MS = 100;
+}  // namespace
 
 TooltipPreviewImage &TooltipPreviewImage::instance()
 {
@@ -29,10 +32,27 @@ TooltipPreviewImage::TooltipPreviewImage()
             this->refreshTooltipWidgetPixmap();
         }
     });
+
+    this->connections_.managedConnect(TooltipWidget::instance()->hidden, [&] {
+        // drops the frames of images only loaded for the preview
+        this->image_ = nullptr;
+        this->attemptRefresh = false;
+        this->loadTimer_.stop();
+    });
+
+    this->loadTimer_.setSingleShot(true);
+    this->loadTimer_.setInterval(LOAD_DELAY_MS);
+    QObject::connect(&this->loadTimer_, &QTimer::timeout, [this] {
+        this->refreshTooltipWidgetPixmap();
+    });
 }
 
 void TooltipPreviewImage::setImage(ImagePtr image)
 {
+    if (image != this->image_)
+    {
+        this->loadTimer_.start();
+    }
     this->image_ = std::move(image);
 
     this->refreshTooltipWidgetPixmap();
@@ -52,7 +72,10 @@ void TooltipPreviewImage::refreshTooltipWidgetPixmap()
 
     if (this->image_ && !tooltipWidget->isHidden())
     {
-        if (auto pixmap = this->image_->pixmapOrLoad())
+        auto pixmap = this->image_->loaded() || !this->loadTimer_.isActive()
+                          ? this->image_->pixmapOrLoad()
+                          : boost::none;
+        if (pixmap)
         {
             if (this->imageWidth_ != 0 && this->imageHeight_)
             {
@@ -2,6 +2,7 @@
 
 #include "messages/Image.hpp"
 
+#include <QTimer>
 #include <pajlada/signals/signalholder.hpp>
 
 namespace chatterino {
@@ -25,6 +26,10 @@ private:
 
     pajlada::Signals::SignalHolder connections_;
 
+    // images that aren't loaded yet only start loading once the mouse
+    // rested on them for a moment, not for everything it passes over
+    QTimer loadTimer_;
+
     // attemptRefresh is set to true in case we want to preview an image that has not loaded yet (if pixmapOrLoad fails)
     bool attemptRefresh{false};
 
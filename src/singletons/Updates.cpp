@@ -9,12 +9,18 @@
 #include "util/CombinePath.hpp"
 #include "util/PostToThread.hpp"
 
+#include <QCryptographicHash>
 #include <QDesktopServices>
+#include <QFile>
+#include <QFileInfo>
 #include <QMessageBox>
+#include <QNetworkReply>
 #include <QProcess>
 #include <QRegularExpression>
 #include "common/QLogging.hpp"
 
+#include <memory>
+
 namespace chatterino {
 namespace {
     QString currentBranch()
@@ -53,6 +59,175 @@ namespace {
 
         return false;
     }
+
+    // Bytes that are read from the partial file at once to hash it
+    constexpr qint64 HASH_CHUNK_SIZE = 1024 * 1024;
+
+    // Used on the network thread while the reply is received
+    struct Download {
+        QFile file;
+        QCryptographicHash hash{QCryptographicHash::Sha256};
+        qint64 expectedSize = -1;
+        bool started = false;
+        bool failed = false;
+        bool writeFailed = false;
+    };
+
+    // Called once the first data of the reply arrived
+    void startWriting(Download &download, QNetworkReply *reply)
+    {
+        download.started = true;
+
+        auto status =
+            reply->attribute(QNetworkRequest::HttpStatusCodeAttribute).toInt();
+        if (status != 200 && status != 206)
+        {
+            // the body is an error page, onError reports it
+            download.failed = true;
+            return;
+        }
+
+        // the server didn't resume, the partial file is restarted
+        bool resumed = status == 206;
+        if (!download.file.open(resumed ? QIODevice::ReadWrite
+                                        : QIODevice::ReadWrite |
+                                              QIODevice::Truncate))
+        {
+            download.failed = true;
+            download.writeFailed = true;
+            return;
+        }
+
+        // the hash has to include what was downloaded before
+        while (resumed && !download.file.atEnd())
+        {
+            download.hash.addData(download.file.read(HASH_CHUNK_SIZE));
+        }
+        download.file.seek(download.file.size());
+
+        auto length = reply->header(QNetworkRequest::ContentLengthHeader);
+        if (length.isValid())
+        {
+            download.expectedSize = download.file.size() + length.toLongLong();
+        }
+    }
+
+    void writeChunk(Download &download, QNetworkReply *reply)
+    {
+        if (!download.started)
+        {
+            startWriting(download, reply);
+        }
+        auto chunk = reply->readAll();
+        if (download.failed)
+        {
+            return;
+        }
+
+        if (download.file.write(chunk) != chunk.size())
+        {
+            download.failed = true;
+            download.writeFailed = true;
+            return;
+        }
+        download.hash.addData(chunk);
+    }
+
+    enum class DownloadResult {
+        Done,
+        Failed,
+        WriteFailed,
+    };
+
+    /**
+     * @brief Downloads url to path, streaming it to disk while it's received.
+     *
+     * The data goes to path with a ".part" suffix first. If a previous
+     * download left one behind, only the missing bytes are requested with a
+     * Range header. Once the download is complete and its size and sha256
+     * match, the partial file is renamed to path. expectedHash may be empty
+     * if it isn't known.
+     */
+    void downloadFile(const QString &url, const QString &path,
+                      const QByteArray &expectedHash,
+                      std::function<void(DownloadResult)> onDone)
+    {
+        auto partPath = path + ".part";
+        auto download = std::make_shared<Download>();
+        download->file.setFileName(partPath);
+
+        auto request = NetworkRequest(url).timeout(600000);
+        auto existing = QFileInfo(partPath).size();
+        if (existing > 0)
+        {
+            qCDebug(chatterinoUpdate) << "Resuming update download at"
+                                      << existing << "bytes";
+            request = std::move(request).header(
+                "Range", QString("bytes=%1-").arg(existing));
+        }
+
+        std::move(request)
+            .onReplyCreated([download](QNetworkReply *reply) {
+                QObject::connect(reply, &QNetworkReply::readyRead, reply,
+                                 [download, reply] {
+                                     writeChunk(*download, reply);
+                                 });
+                // connected before the reply is handled, so everything is
+                // written once onSuccess runs
+                QObject::connect(reply, &QNetworkReply::finished, reply,
+                                 [download, reply] {
+                                     writeChunk(*download, reply);
+                                     download->file.close();
+                                 });
+            })
+            .onError([onDone, partPath](NetworkResult result) {
+                qCDebug(chatterinoUpdate)
+                    << "Failed to download the update:" << result.status();
+                // the partial file is kept for the next try, unless the
+                // server refused to resume it
+                if (result.status() == 416)
+                {
+                    QFile::remove(partPath);
+                }
+                onDone(DownloadResult::Failed);
+            })
+            .onSuccess([download, onDone, path,
+                        expectedHash](auto) -> Outcome {
+                if (download->failed)
+                {
+                    onDone(download->writeFailed ? DownloadResult::WriteFailed
+                                                 : DownloadResult::Failed);
+                    return Failure;
+                }
+
+                auto partPath = download->file.fileName();
+                auto size = QFileInfo(partPath).size();
+                auto hash = download->hash.result().toHex();
+                if ((download->expectedSize != -1 &&
+                     size != download->expectedSize) ||
+                    (!expectedHash.isEmpty() &&
+                     hash != expectedHash.toLower()))
+                {
+                    qCDebug(chatterinoUpdate)
+                        << "Downloaded update doesn't match, size" << size
+                        << "sha256" << hash;
+                    QFile::remove(partPath);
+                    onDone(DownloadResult::Failed);
+                    return Failure;
+                }
+
+                QFile::remove(path);
+                if (!QFile::rename(partPath, path))
+                {
+                    onDone(DownloadResult::WriteFailed);
+                    return Failure;
+                }
+
+                onDone(DownloadResult::Done);
+                return Success;
+            })
+            .execute();
+    }
 }  // namespace
 
 Updates::Updates()
@@ -104,130 +279,111 @@ void Updates::installUpdates()
     box->exec();
     QDesktopServices::openUrl(this->updateGuideLink_);
 #elif defined Q_OS_WIN
-    if (getPaths()->isPortable())
+    QMessageBox *box =
+        new QMessageBox(QMessageBox::Information, "Chatterino Update",
+                        "Chatterino is downloading the update "
+                        "in the background and will run the "
+                        "updater once it is finished.");
+    box->setAttribute(Qt::WA_DeleteOnClose);
+    box->show();
+
+    this->installWhenDownloaded_ = true;
+    this->setStatus_(Downloading);
+    if (!this->downloadedFile_.isEmpty())
     {
-        QMessageBox *box =
-            new QMessageBox(QMessageBox::Information, "Chatterino Update",
-                            "Chatterino is downloading the update "
-                            "in the background and will run the "
-                            "updater once it is finished.");
-        box->setAttribute(Qt::WA_DeleteOnClose);
-        box->show();
-
-        NetworkRequest(this->updatePortable_)
-            .timeout(600000)
-            .onError([this](NetworkResult) {
-                this->setStatus_(DownloadFailed);
-
-                postToThread([] {
-                    QMessageBox *box = new QMessageBox(
-                        QMessageBox::Information, "Chatterino Update",
-                        "Failed while trying to download the update.");
-                    box->setAttribute(Qt::WA_DeleteOnClose);
-                    box->show();
-                    box->raise();
-                });
-            })
-            .onSuccess([this](auto result) -> Outcome {
-                QByteArray object = result.getData();
-                auto filename =
-                    combinePath(getPaths()->miscDirectory, "update.zip");
+        this->runUpdate_();
+    }
+    else if (!this->isDownloading_)
+    {
+        this->downloadUpdate_();
+    }
+#endif
+}
 
-                QFile file(filename);
-                file.open(QIODevice::Truncate | QIODevice::WriteOnly);
+void Updates::downloadUpdate_()
+{
+    bool portable = getPaths()->isPortable();
+    auto url = portable ? this->updatePortable_ : this->updateExe_;
+    auto hash = portable ? this->updatePortableHash_ : this->updateExeHash_;
+    auto filename = combinePath(getPaths()->miscDirectory,
+                                portable ? "update.zip" : "Update.exe");
 
-                if (file.write(object) == -1)
-                {
-                    this->setStatus_(WriteFileFailed);
-                    return Failure;
-                }
-                file.flush();
-                file.close();
+    this->isDownloading_ = true;
+    downloadFile(url, filename, hash, [this, filename](DownloadResult result) {
+        this->isDownloading_ = false;
+
+        if (result == DownloadResult::Done)
+        {
+            this->downloadedFile_ = filename;
+            if (this->installWhenDownloaded_)
+            {
+                this->runUpdate_();
+            }
+            return;
+        }
 
-                QProcess::startDetached(
-                    combinePath(QCoreApplication::applicationDirPath(),
-                                "updater.1/ChatterinoUpdater.exe"),
-                    {filename, "restart"});
+        // failed prefetches are retried once the user installs the update
+        if (!this->installWhenDownloaded_)
+        {
+            return;
+        }
 
-                QApplication::exit(0);
-                return Success;
-            })
-            .execute();
-        this->setStatus_(Downloading);
-    }
-    else
-    {
-        QMessageBox *box =
-            new QMessageBox(QMessageBox::Information, "Chatterino Update",
-                            "Chatterino is downloading the update "
-                            "in the background and will run the "
-                            "updater once it is finished.");
+        if (result == DownloadResult::WriteFailed)
+        {
+            this->setStatus_(WriteFileFailed);
+            QMessageBox *box = new QMessageBox(
+                QMessageBox::Information, "Chatterino Update",
+                "Failed to save the update file. This could be due to "
+                "window settings or antivirus software.\n\nTry manually "
+                "downloading the update.");
+            box->setAttribute(Qt::WA_DeleteOnClose);
+            box->exec();
+
+            QDesktopServices::openUrl(this->updateExe_);
+            return;
+        }
+
+        this->setStatus_(DownloadFailed);
+        QMessageBox *box = new QMessageBox(
+            QMessageBox::Information, "Chatterino Update",
+            "Failed to download the update. \n\nTry manually "
+            "downloading the update.");
         box->setAttribute(Qt::WA_DeleteOnClose);
-        box->show();
-
-        NetworkRequest(this->updateExe_)
-            .timeout(600000)
-            .onError([this](NetworkResult) {
-                this->setStatus_(DownloadFailed);
-
-                QMessageBox *box = new QMessageBox(
-                    QMessageBox::Information, "Chatterino Update",
-                    "Failed to download the update. \n\nTry manually "
-                    "downloading the update.");
-                box->setAttribute(Qt::WA_DeleteOnClose);
-                box->exec();
-            })
-            .onSuccess([this](auto result) -> Outcome {
-                QByteArray object = result.getData();
-                auto filename =
-                    combinePath(getPaths()->miscDirectory, "Update.exe");
+        box->exec();
+    });
+}
 
-                QFile file(filename);
-                file.open(QIODevice::Truncate | QIODevice::WriteOnly);
+void Updates::runUpdate_()
+{
+    if (getPaths()->isPortable())
+    {
+        QProcess::startDetached(
+            combinePath(QCoreApplication::applicationDirPath(),
+                        "updater.1/ChatterinoUpdater.exe"),
+            {this->downloadedFile_, "restart"});
 
-                if (file.write(object) == -1)
-                {
-                    this->setStatus_(WriteFileFailed);
-                    QMessageBox *box = new QMessageBox(
-                        QMessageBox::Information, "Chatterino Update",
-                        "Failed to save the update file. This could be due to "
-                        "window settings or antivirus software.\n\nTry "
-                        "manually "
-                        "downloading the update.");
-                    box->setAttribute(Qt::WA_DeleteOnClose);
-                    box->exec();
-
-                    QDesktopServices::openUrl(this->updateExe_);
-                    return Failure;
-                }
-                file.flush();
-                file.close();
+        QApplication::exit(0);
+        return;
+    }
 
-                if (QProcess::startDetached(filename))
-                {
-                    QApplication::exit(0);
-                }
-                else
-                {
-                    QMessageBox *box = new QMessageBox(
-                        QMessageBox::Information, "Chatterino Update",
-                        "Failed to execute update binary. This could be due to "
-                        "window "
-                        "settings or antivirus software.\n\nTry manually "
-                        "downloading "
-                        "the update.");
-                    box->setAttribute(Qt::WA_DeleteOnClose);
-                    box->exec();
-
-                    QDesktopServices::openUrl(this->updateExe_);
-                }
+    if (QProcess::startDetached(this->downloadedFile_))
+    {
+        QApplication::exit(0);
+    }
+    else
+    {
+        QMessageBox *box = new QMessageBox(
+            QMessageBox::Information, "Chatterino Update",
+            "Failed to execute update binary. This could be due to "
+            "window "
+            "settings or antivirus software.\n\nTry manually "
+            "downloading "
+            "the update.");
+        box->setAttribute(Qt::WA_DeleteOnClose);
+        box->exec();
 
-                return Success;
-            })
-            .execute();
-        this->setStatus_(Downloading);
+        QDesktopServices::openUrl(this->updateExe_);
     }
-#endif
 }
 
 void Updates::checkForUpdates()
@@ -282,6 +438,9 @@ void Updates::checkForUpdates()
                 return Failure;
             }
             this->updateExe_ = updateExe_val.toString();
+            // optional, the download is only checked against it if it's there
+            this->updateExeHash_ =
+                object.value("updateexe_sha256").toString().toLatin1();
 
 #    ifdef Q_OS_WIN
             /// Windows portable
@@ -293,6 +452,8 @@ void Updates::checkForUpdates()
                 return Failure;
             }
             this->updatePortable_ = portable_val.toString();
+            this->updatePortableHash_ =
+                object.value("portable_download_sha256").toString().toLatin1();
 #    endif
 
 #elif defined Q_OS_LINUX
@@ -314,6 +475,14 @@ void Updates::checkForUpdates()
                 this->setStatus_(UpdateAvailable);
                 this->isDowngrade_ =
                     isDowngradeOf(this->onlineVersion_, this->currentVersion_);
+
+#ifdef Q_OS_WIN
+                if (getSettings()->prefetchUpdates && !this->isDownloading_ &&
+                    this->downloadedFile_.isEmpty())
+                {
+                    this->downloadUpdate_();
+                }
+#endif
             }
             else
             {
@@ -45,8 +45,19 @@ private:
     QString updateExe_;
     QString updatePortable_;
     QString updateGuideLink_;
+    // hex encoded sha256 of the downloads, empty if the server didn't send one
+    QByteArray updateExeHash_;
+    QByteArray updatePortableHash_;
+
+    bool isDownloading_{};
+    // set once the download is finished and verified
+    QString downloadedFile_;
+    // false while the update is only prefetched
+    bool installWhenDownloaded_{};
 
     void setStatus_(Status status);
+    void downloadUpdate_();
+    void runUpdate_();
 };
 
 }  // namespace chatterino
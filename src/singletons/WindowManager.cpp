@@ -8,18 +8,23 @@
 #include <QMessageBox>
 #include <QSaveFile>
 #include <QScreen>
+#include <QtConcurrent>
 #include <boost/optional.hpp>
 #include <chrono>
+#include <unordered_map>
+#include <unordered_set>
 
 #include <QMessageBox>
 #include "Application.hpp"
 #include "common/Args.hpp"
 #include "common/QLogging.hpp"
 #include "debug/AssertInGuiThread.hpp"
+#include "debug/StartupProfiler.hpp"
 #include "messages/MessageElement.hpp"
 #include "providers/irc/Irc2.hpp"
 #include "providers/irc/IrcChannel2.hpp"
 #include "providers/irc/IrcServer.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Fonts.hpp"
 #include "singletons/Paths.hpp"
@@ -27,11 +32,14 @@
 #include "singletons/Theme.hpp"
 #include "util/Clamp.hpp"
 #include "util/CombinePath.hpp"
+#include "util/DebugCount.hpp"
+#include "util/MemoryUsage.hpp"
 #include "widgets/AccountSwitchPopup.hpp"
 #include "widgets/FramelessEmbedWindow.hpp"
 #include "widgets/Notebook.hpp"
 #include "widgets/Window.hpp"
 #include "widgets/dialogs/SettingsDialog.hpp"
+#include "widgets/helper/ChannelView.hpp"
 #include "widgets/helper/NotebookTab.hpp"
 #include "widgets/splits/Split.hpp"
 #include "widgets/splits/SplitContainer.hpp"
@@ -39,6 +47,11 @@
 namespace chatterino {
 namespace {
 
+    // messages kept by channels in hidden tabs while over the budget
+    constexpr size_t HIDDEN_MESSAGE_LIMIT = 100;
+
+    DebugCounter limitedChannels("channels with fewer messages");
+
     boost::optional<bool> &shouldMoveOutOfBoundsWindow()
     {
         static boost::optional<bool> x;
@@ -121,8 +134,8 @@ WindowManager::WindowManager()
 
     this->saveTimer->setSingleShot(true);
 
-    QObject::connect(this->saveTimer, &QTimer::timeout, [] {
-        getApp()->windows->save();
+    QObject::connect(this->saveTimer, &QTimer::timeout, [this] {
+        this->saveInBackground();
     });
 
     this->miscUpdateTimer_.start(100);
@@ -130,6 +143,19 @@ WindowManager::WindowManager()
     QObject::connect(&this->miscUpdateTimer_, &QTimer::timeout, [this] {
         this->miscUpdate.invoke();
     });
+
+    this->dormancyTimer_.setSingleShot(true);
+    this->dormancyTimer_.setInterval(0);
+    QObject::connect(&this->dormancyTimer_, &QTimer::timeout, [this] {
+        this->updateDormantChannels();
+        this->updateMessageLimits();
+    });
+
+    // the memory of the messages only changes gradually
+    this->messageLimitTimer_.start(10000);
+    QObject::connect(&this->messageLimitTimer_, &QTimer::timeout, [this] {
+        this->updateMessageLimits();
+    });
 }
 
 WindowManager::~WindowManager() = default;
@@ -213,6 +239,20 @@ void WindowManager::forceLayoutChannelViews()
     this->layoutChannelViews(nullptr);
 }
 
+void WindowManager::layoutAfterSettingChange(
+    const std::function<void()> &change)
+{
+    auto previousFlags = this->wordFlags_;
+    change();
+
+    // wordFlagsChanged already queued the layouts, messages are laid out for
+    // the new flags as they're shown
+    if (this->wordFlags_ == previousFlags)
+    {
+        this->forceLayoutChannelViews();
+    }
+}
+
 void WindowManager::repaintVisibleChatWidgets(Channel *channel)
 {
     this->layoutRequested.invoke(channel);
@@ -285,6 +325,47 @@ void WindowManager::select(SplitContainer *container)
     this->selectSplitContainer.invoke(container);
 }
 
+bool WindowManager::scrollToMessage(const ChannelPtr &channel,
+                                    const QString &messageID)
+{
+    assertInGuiThread();
+
+    std::vector<Split *> splits;
+    for (Window *window : this->windows_)
+    {
+        auto &notebook = window->getNotebook();
+        for (int i = 0; i < notebook.getPageCount(); i++)
+        {
+            auto *tab = dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+            if (tab == nullptr)
+            {
+                continue;
+            }
+
+            bool isSelected = notebook.getSelectedPage() == tab;
+            for (auto *split : tab->getSplits())
+            {
+                if (split->getChannel() == channel)
+                {
+                    splits.insert(isSelected ? splits.begin() : splits.end(),
+                                  split);
+                }
+            }
+        }
+    }
+
+    for (auto *split : splits)
+    {
+        if (split->getChannelView().scrollToMessage(messageID))
+        {
+            this->select(split);
+            return true;
+        }
+    }
+
+    return false;
+}
+
 QPoint WindowManager::emotePopupPos()
 {
     return this->emotePopupPos_;
@@ -295,6 +376,14 @@ void WindowManager::setEmotePopupPos(QPoint pos)
     this->emotePopupPos_ = pos;
 }
 
+void WindowManager::load(Paths & /*paths*/)
+{
+    if (!getArgs().customChannelLayout)
+    {
+        this->loadedLayout_ = this->loadWindowLayoutFromFile();
+    }
+}
+
 void WindowManager::initialize(Settings &settings, Paths &paths)
 {
     assertInGuiThread();
@@ -306,6 +395,7 @@ void WindowManager::initialize(Settings &settings, Paths &paths)
     assert(!this->initialized_);
 
     {
+        StartupProfiler::Phase phase("restore window layout");
         WindowLayout windowLayout;
 
         if (getArgs().customChannelLayout)
@@ -314,7 +404,7 @@ void WindowManager::initialize(Settings &settings, Paths &paths)
         }
         else
         {
-            windowLayout = this->loadWindowLayoutFromFile();
+            windowLayout = std::move(this->loadedLayout_);
         }
 
         this->emotePopupPos_ = windowLayout.emotePopupPos_;
@@ -345,6 +435,10 @@ void WindowManager::initialize(Settings &settings, Paths &paths)
         this->layoutChannelViews();
     });
 
+    settings.dormantHiddenChannels.connect([this](auto, auto) {
+        this->queueDormancyUpdate();
+    });
+
     settings.emoteScale.connect([this](auto, auto) {
         this->forceLayoutChannelViews();
     });
@@ -353,28 +447,33 @@ void WindowManager::initialize(Settings &settings, Paths &paths)
         this->forceLayoutChannelViews();
     });
     settings.alternateMessages.connect([this](auto, auto) {
-        this->forceLayoutChannelViews();
+        this->invalidateBuffers();
     });
     settings.separateMessages.connect([this](auto, auto) {
-        this->forceLayoutChannelViews();
+        this->invalidateBuffers();
     });
     settings.collpseMessagesMinLines.connect([this](auto, auto) {
         this->forceLayoutChannelViews();
     });
     settings.enableRedeemedHighlight.connect([this](auto, auto) {
-        this->forceLayoutChannelViews();
+        this->invalidateBuffers();
     });
 
     this->initialized_ = true;
 }
 
 void WindowManager::save()
+{
+    this->saveInBackground();
+    this->pendingSave_.waitForFinished();
+}
+
+void WindowManager::saveInBackground()
 {
     if (getArgs().dontSaveSettings)
     {
         return;
     }
-    qCDebug(chatterinoWindowmanager) << "[WindowManager] Saving";
     assertInGuiThread();
     QJsonDocument document;
 
@@ -444,20 +543,34 @@ void WindowManager::save()
     obj.insert("windows", windowArr);
     document.setObject(obj);
 
-    // save file
-    QSaveFile file(this->windowLayoutFilePath);
-    file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+    // most saves are queued by changes that don't end up in the file
+    if (document == this->savedLayout_)
+    {
+        return;
+    }
+    this->savedLayout_ = document;
 
-    QJsonDocument::JsonFormat format =
+    qCDebug(chatterinoWindowmanager) << "[WindowManager] Saving";
+
+    // writes must not overtake each other
+    this->pendingSave_.waitForFinished();
+    this->pendingSave_ = QtConcurrent::run(
+        [document = std::move(document), path = this->windowLayoutFilePath] {
+            // save file
+            QSaveFile file(path);
+            file.open(QIODevice::WriteOnly | QIODevice::Truncate);
+
+            QJsonDocument::JsonFormat format =
 #ifdef _DEBUG
-        QJsonDocument::JsonFormat::Compact
+                QJsonDocument::JsonFormat::Compact
 #else
-        (QJsonDocument::JsonFormat)0
+                (QJsonDocument::JsonFormat)0
 #endif
-        ;
+                ;
 
-    file.write(document.toJson(format));
-    file.commit();
+            file.write(document.toJson(format));
+            file.commit();
+        });
 }
 
 void WindowManager::sendAlert()
@@ -609,7 +722,7 @@ IndirectChannel WindowManager::decodeChannel(const SplitDescriptor &descriptor)
     }
     else if (descriptor.type_ == "mentions")
     {
-        return app->twitch->mentionsChannel;
+        return ChannelPtr(app->twitch->mentionsChannel);
     }
     else if (descriptor.type_ == "watching")
     {
@@ -617,11 +730,11 @@ IndirectChannel WindowManager::decodeChannel(const SplitDescriptor &descriptor)
     }
     else if (descriptor.type_ == "whispers")
     {
-        return app->twitch->whispersChannel;
+        return ChannelPtr(app->twitch->whispersChannel);
     }
     else if (descriptor.type_ == "live")
     {
-        return app->twitch->liveChannel;
+        return ChannelPtr(app->twitch->liveChannel);
     }
     else if (descriptor.type_ == "irc")
     {
@@ -642,6 +755,180 @@ void WindowManager::closeAll()
     }
 }
 
+LoadPriority WindowManager::loadPriority(const Channel *channel) const
+{
+    auto priority = LoadPriority::Hidden;
+
+    for (Window *window : this->windows_)
+    {
+        if (window->isMinimized())
+        {
+            continue;
+        }
+
+        auto &notebook = window->getNotebook();
+        for (int i = 0; i < notebook.getPageCount(); i++)
+        {
+            auto *tab = dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+            if (tab == nullptr)
+            {
+                continue;
+            }
+
+            for (auto *split : tab->getSplits())
+            {
+                if (split->getChannel().get() != channel)
+                {
+                    continue;
+                }
+
+                if (notebook.getSelectedPage() == tab)
+                {
+                    return LoadPriority::SelectedTab;
+                }
+                priority = LoadPriority::VisibleWindow;
+            }
+        }
+    }
+
+    return priority;
+}
+
+void WindowManager::updateDormantChannels()
+{
+    assertInGuiThread();
+
+    this->dormancyTimer_.stop();
+
+    std::unordered_set<TwitchChannel *> awake;
+    std::vector<std::shared_ptr<TwitchChannel>> hidden;
+
+    if (getSettings()->dormantHiddenChannels)
+    {
+        for (Window *window : this->windows_)
+        {
+            auto &notebook = window->getNotebook();
+            for (int i = 0; i < notebook.getPageCount(); i++)
+            {
+                auto *tab =
+                    dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+                if (tab == nullptr)
+                {
+                    continue;
+                }
+
+                bool isSelected = notebook.getSelectedPage() == tab;
+                for (auto *split : tab->getSplits())
+                {
+                    auto channel = std::dynamic_pointer_cast<TwitchChannel>(
+                        split->getChannel());
+                    if (!channel)
+                    {
+                        continue;
+                    }
+
+                    if (isSelected)
+                    {
+                        awake.insert(channel.get());
+                    }
+                    else
+                    {
+                        hidden.push_back(std::move(channel));
+                    }
+                }
+            }
+        }
+    }
+
+    std::unordered_set<TwitchChannel *> dormant;
+    for (const auto &channel : hidden)
+    {
+        if (awake.count(channel.get()) == 0)
+        {
+            dormant.insert(channel.get());
+        }
+    }
+
+    for (const auto &weak : this->dormantChannels_)
+    {
+        auto channel = weak.lock();
+        if (channel && dormant.count(channel.get()) == 0)
+        {
+            channel->setDormant(false);
+        }
+    }
+
+    this->dormantChannels_.clear();
+    for (const auto &channel : hidden)
+    {
+        // a channel can be in multiple hidden splits
+        if (dormant.erase(channel.get()) != 0)
+        {
+            channel->setDormant(true);
+            this->dormantChannels_.push_back(channel);
+        }
+    }
+}
+
+void WindowManager::updateMessageLimits()
+{
+    assertInGuiThread();
+
+    auto budget =
+        int64_t(getSettings()->messageMemoryBudget.getValue()) * 1024 * 1024;
+    bool overBudget =
+        budget > 0 && MemoryUsage::bytes(MemoryCategory::Messages) > budget;
+
+    // whether a split of the channel is in a selected tab
+    std::unordered_map<ChannelPtr, bool> channels;
+    for (Window *window : this->windows_)
+    {
+        auto &notebook = window->getNotebook();
+        for (int i = 0; i < notebook.getPageCount(); i++)
+        {
+            auto *tab = dynamic_cast<SplitContainer *>(notebook.getPageAt(i));
+            if (tab == nullptr)
+            {
+                continue;
+            }
+
+            bool isSelected = notebook.getSelectedPage() == tab;
+            for (auto *split : tab->getSplits())
+            {
+                channels[split->getChannel()] |= isSelected;
+            }
+        }
+    }
+
+    int64_t limited = 0;
+    for (const auto &[channel, visible] : channels)
+    {
+        auto limit = channel->getMessageLimit();
+        if (visible || budget <= 0)
+        {
+            limit = Channel::DEFAULT_MESSAGE_LIMIT;
+        }
+        else if (overBudget)
+        {
+            limit = HIDDEN_MESSAGE_LIMIT;
+        }
+
+        // the projections and views of the channel follow it
+        channel->setMessageLimit(limit);
+        if (limit < Channel::DEFAULT_MESSAGE_LIMIT)
+        {
+            limited++;
+        }
+    }
+
+    limitedChannels.increase(limited - limitedChannels.value());
+}
+
+void WindowManager::queueDormancyUpdate()
+{
+    this->dormancyTimer_.start();
+}
+
 int WindowManager::getGeneration() const
 {
     return this->generation_;
@@ -652,6 +939,17 @@ void WindowManager::incGeneration()
     this->generation_++;
 }
 
+int WindowManager::getBufferGeneration() const
+{
+    return this->bufferGeneration_;
+}
+
+void WindowManager::invalidateBuffers()
+{
+    this->bufferGeneration_++;
+    this->layoutChannelViews(nullptr);
+}
+
 WindowLayout WindowManager::loadWindowLayoutFromFile() const
 {
     return WindowLayout::loadFromFile(this->windowLayoutFilePath);
@@ -1,7 +1,11 @@
 #pragma once
 
+#include <QFuture>
+#include <QJsonDocument>
+#include <functional>
 #include <memory>
 #include "common/Channel.hpp"
+#include "common/ChannelLoadScheduler.hpp"
 #include "common/FlagsEnum.hpp"
 #include "common/Singleton.hpp"
 #include "common/WindowDescriptors.hpp"
@@ -15,6 +19,7 @@ class Settings;
 class Paths;
 class Window;
 class SplitContainer;
+class TwitchChannel;
 
 enum class MessageElementFlag : int64_t;
 using MessageElementFlags = FlagsEnum<MessageElementFlag>;
@@ -50,8 +55,13 @@ public:
 
     // Force all channel views to redo their layout
     // This is called, for example, when the emote scale or timestamp format has
-    // changed
+    // changed. Changes that only affect the colors of messages should call
+    // invalidateBuffers instead, it keeps the layouts.
     void forceLayoutChannelViews();
+    // Runs change, which sets a setting, and lays out the channel views for
+    // it. Settings that only toggle word flags keep the cached layouts of the
+    // messages, see wordFlagsChanged.
+    void layoutAfterSettingChange(const std::function<void()> &change);
     void repaintVisibleChatWidgets(Channel *channel = nullptr);
     void repaintGifEmotes();
 
@@ -62,16 +72,43 @@ public:
     void select(Split *split);
     void select(SplitContainer *container);
 
+    // Selects a split of the channel and scrolls to the message in it,
+    // splits in selected tabs are preferred. Returns false if no split shows
+    // the message.
+    bool scrollToMessage(const ChannelPtr &channel, const QString &messageID);
+
     QPoint emotePopupPos();
     void setEmotePopupPos(QPoint pos);
 
+    virtual void load(Paths &paths) override;
     virtual void initialize(Settings &settings, Paths &paths) override;
+    // Saves the window layout and waits until it's written
     virtual void save() override;
     void closeAll();
 
+    // How soon the channel is going to be seen, based on which splits show
+    // it. Used to load the selected tabs first on startup.
+    LoadPriority loadPriority(const Channel *channel) const;
+
+    // Makes the Twitch channels that are only shown in tabs that aren't
+    // selected dormant and wakes up all others, see TwitchChannel::setDormant
+    void updateDormantChannels();
+    // Channels that are only shown in tabs that aren't selected are cut down
+    // to their newest messages once all messages take more memory than the
+    // budget. They keep all of them again once they're shown. Runs
+    // periodically and after tab changes.
+    void updateMessageLimits();
+    // Calls updateDormantChannels once control returns to the event loop
+    void queueDormancyUpdate();
+
     int getGeneration() const;
     void incGeneration();
 
+    // Message buffers drawn before the call are drawn again, without laying
+    // out the messages
+    int getBufferGeneration() const;
+    void invalidateBuffers();
+
     MessageElementFlags getWordFlags();
     void updateWordTypeMask();
 
@@ -108,17 +145,24 @@ private:
     // Load window layout from the window-layout.json file
     WindowLayout loadWindowLayoutFromFile() const;
 
+    // Encodes the window layout and writes it in the background if it
+    // changed since the last save
+    void saveInBackground();
+
     // Apply a window layout for this window manager.
     void applyWindowLayout(const WindowLayout &layout);
 
     // Contains the full path to the window layout file, e.g. /home/pajlada/.local/share/Chatterino/Settings/window-layout.json
     const QString windowLayoutFilePath;
+    // read from the file in load, applied in initialize
+    WindowLayout loadedLayout_;
 
     bool initialized_ = false;
 
     QPoint emotePopupPos_;
 
     std::atomic<int> generation_{0};
+    std::atomic<int> bufferGeneration_{0};
 
     std::vector<Window *> windows_;
 
@@ -130,7 +174,13 @@ private:
     pajlada::SettingListener wordFlagsListener_;
 
     QTimer *saveTimer;
+    // the layout that was written last and the write that may still run
+    QJsonDocument savedLayout_;
+    QFuture<void> pendingSave_;
     QTimer miscUpdateTimer_;
+    QTimer dormancyTimer_;
+    QTimer messageLimitTimer_;
+    std::vector<std::weak_ptr<TwitchChannel>> dormantChannels_;
 };
 
 }  // namespace chatterino
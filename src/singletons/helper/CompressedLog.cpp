@@ -0,0 +1,221 @@
+#include "singletons/helper/CompressedLog.hpp"
+
+#include "common/QLogging.hpp"
+
+#include <QDataStream>
+
+#include <algorithm>
+
+#ifdef Q_OS_WIN
+#    include <io.h>
+#else
+#    include <unistd.h>
+#endif
+
+namespace chatterino {
+
+namespace {
+
+    // uncompressed size at which a block is written
+    constexpr int MAX_BLOCK_SIZE = 64 * 1024;
+    // a block is written after this many seconds even if it's small
+    constexpr int MAX_BLOCK_AGE = 60;
+
+    constexpr int COMPRESSION_LEVEL = 6;
+
+}  // namespace
+
+void syncToDisk(QFile &file)
+{
+#ifdef Q_OS_WIN
+    _commit(file.handle());
+#else
+    fsync(file.handle());
+#endif
+}
+
+bool CompressedLogWriter::open(const QString &path)
+{
+    this->data_.setFileName(path);
+    this->index_.setFileName(path + ".idx");
+
+    if (!this->data_.open(QIODevice::Append) ||
+        !this->index_.open(QIODevice::Append))
+    {
+        qCDebug(chatterinoHelper) << "Unable to open compressed log" << path;
+        this->data_.close();
+        this->index_.close();
+        return false;
+    }
+
+    return true;
+}
+
+bool CompressedLogWriter::isOpen() const
+{
+    return this->data_.isOpen();
+}
+
+void CompressedLogWriter::append(const QDateTime &time, const QString &login,
+                                 const QString &text)
+{
+    auto ms = time.toMSecsSinceEpoch();
+
+    if (this->block_.isEmpty())
+    {
+        this->firstTime_ = ms;
+        this->blockStarted_ = QDateTime::currentDateTime();
+    }
+    this->lastTime_ = ms;
+
+    // one entry per line: time, login and text separated by tabs
+    this->block_.append(QByteArray::number(ms));
+    this->block_.append('\t');
+    this->block_.append(login.toUtf8());
+    this->block_.append('\t');
+    this->block_.append(QString(text).replace('\n', ' ').toUtf8());
+    this->block_.append('\n');
+
+    if (!login.isEmpty())
+    {
+        this->logins_.insert(login.toLower());
+    }
+}
+
+void CompressedLogWriter::flush(bool force, bool sync)
+{
+    if (this->block_.isEmpty() || !this->isOpen())
+    {
+        return;
+    }
+
+    if (!force && this->block_.size() < MAX_BLOCK_SIZE &&
+        this->blockStarted_.secsTo(QDateTime::currentDateTime()) <
+            MAX_BLOCK_AGE)
+    {
+        return;
+    }
+
+    auto compressed = qCompress(this->block_, COMPRESSION_LEVEL);
+    auto offset = quint64(this->data_.size());
+
+    this->data_.write(compressed);
+    this->data_.flush();
+
+    QStringList logins = this->logins_.values();
+    logins.sort();
+
+    // the index record is only written once its block is complete, so a
+    // crash can at most lose the record of the last block
+    QByteArray record;
+    QDataStream stream(&record, QIODevice::WriteOnly);
+    stream << offset << quint32(compressed.size()) << this->firstTime_
+           << this->lastTime_ << logins;
+    this->index_.write(record);
+    this->index_.flush();
+
+    if (sync)
+    {
+        syncToDisk(this->data_);
+        syncToDisk(this->index_);
+    }
+
+    this->block_.clear();
+    this->logins_.clear();
+}
+
+void CompressedLogWriter::close(bool sync)
+{
+    this->flush(true, sync);
+    this->data_.close();
+    this->index_.close();
+}
+
+CompressedLogReader::CompressedLogReader(const QString &path)
+    : path_(path)
+{
+    QFile index(path + ".idx");
+    if (!index.open(QIODevice::ReadOnly))
+    {
+        return;
+    }
+
+    auto dataSize = quint64(QFile(path).size());
+
+    QDataStream stream(&index);
+    while (!stream.atEnd())
+    {
+        Block block;
+        stream >> block.offset >> block.size >> block.firstTime >>
+            block.lastTime >> block.logins;
+
+        if (stream.status() != QDataStream::Ok ||
+            block.offset + block.size > dataSize)
+        {
+            break;
+        }
+
+        this->blocks_.push_back(std::move(block));
+    }
+}
+
+std::vector<LogEntry> CompressedLogReader::read(
+    qint64 from, qint64 to, const QStringList &logins) const
+{
+    std::vector<LogEntry> entries;
+
+    QFile data(this->path_);
+    if (!data.open(QIODevice::ReadOnly))
+    {
+        return entries;
+    }
+
+    for (const auto &block : this->blocks_)
+    {
+        if (block.lastTime < from || block.firstTime > to)
+        {
+            continue;
+        }
+
+        if (!logins.isEmpty() &&
+            std::none_of(logins.begin(), logins.end(),
+                         [&](const QString &login) {
+                             return std::binary_search(block.logins.begin(),
+                                                       block.logins.end(),
+                                                       login);
+                         }))
+        {
+            continue;
+        }
+
+        data.seek(qint64(block.offset));
+        auto lines = qUncompress(data.read(block.size)).split('\n');
+
+        for (const auto &line : lines)
+        {
+            auto firstTab = line.indexOf('\t');
+            auto secondTab = line.indexOf('\t', firstTab + 1);
+            if (firstTab < 0 || secondTab < 0)
+            {
+                continue;
+            }
+
+            auto time = line.left(firstTab).toLongLong();
+            auto login = QString::fromUtf8(
+                line.mid(firstTab + 1, secondTab - firstTab - 1));
+
+            if (time < from || time > to ||
+                (!logins.isEmpty() && !logins.contains(login.toLower())))
+            {
+                continue;
+            }
+
+            entries.push_back({QDateTime::fromMSecsSinceEpoch(time), login,
+                               QString::fromUtf8(line.mid(secondTab + 1))});
+        }
+    }
+
+    return entries;
+}
+
+}  // namespace chatterino
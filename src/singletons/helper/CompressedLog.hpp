@@ -0,0 +1,86 @@
+#pragma once
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QSet>
+#include <QString>
+#include <QStringList>
+
+#include <vector>
+
+namespace chatterino {
+
+/// Forces everything written to file onto the disk
+void syncToDisk(QFile &file);
+
+struct LogEntry {
+    QDateTime time;
+    QString login;
+    QString text;
+};
+
+/**
+ * @brief Writes a log file made of compressed blocks.
+ *
+ * Lines are collected into blocks which are compressed on their own. For every
+ * block a record with its position, its time range and the logins that sent
+ * messages in it is appended to a sidecar index file (path + ".idx"), so a
+ * reader only has to decompress the blocks it's interested in.
+ */
+class CompressedLogWriter
+{
+public:
+    bool open(const QString &path);
+    bool isOpen() const;
+
+    void append(const QDateTime &time, const QString &login,
+                const QString &text);
+
+    /// Writes the current block if it's large or old enough, or if force is
+    /// set. sync forces the files to be written to disk.
+    void flush(bool force, bool sync);
+    void close(bool sync);
+
+private:
+    QFile data_;
+    QFile index_;
+
+    QByteArray block_;
+    qint64 firstTime_ = 0;
+    qint64 lastTime_ = 0;
+    QSet<QString> logins_;
+    // when the first line of the current block was added
+    QDateTime blockStarted_;
+};
+
+/**
+ * @brief Reads a log file written by CompressedLogWriter.
+ *
+ * Only the index is read on construction. Blocks are decompressed in read,
+ * and only if they can contain matching entries.
+ */
+class CompressedLogReader
+{
+public:
+    explicit CompressedLogReader(const QString &path);
+
+    /// Entries sent between from and to (both in ms since epoch). If logins
+    /// isn't empty, only entries of those (lowercase) logins are returned.
+    std::vector<LogEntry> read(qint64 from, qint64 to,
+                               const QStringList &logins) const;
+
+private:
+    struct Block {
+        quint64 offset;
+        quint32 size;
+        qint64 firstTime;
+        qint64 lastTime;
+        QStringList logins;
+    };
+
+    QString path_;
+    std::vector<Block> blocks_;
+};
+
+}  // namespace chatterino
@@ -11,6 +11,9 @@ void GIFTimer::initialize()
     this->timer.setInterval(30);
 
     getSettings()->animateEmotes.connect([this](bool enabled, auto) {
+        this->enabled_ = enabled;
+        this->idleTicks_ = 0;
+
         if (enabled)
             this->timer.start();
         else
@@ -22,10 +25,27 @@ void GIFTimer::initialize()
             qApp->activeWindow() == nullptr)
             return;
 
+        // nothing animated was painted since the last few ticks
+        if (++this->idleTicks_ > maxIdleTicks)
+        {
+            this->timer.stop();
+            return;
+        }
+
         this->position_ += gifFrameLength;
         this->signal.invoke();
         getApp()->windows->repaintGifEmotes();
     });
 }
 
+void GIFTimer::animatedImagePainted()
+{
+    this->idleTicks_ = 0;
+
+    if (this->enabled_ && !this->timer.isActive())
+    {
+        this->timer.start();
+    }
+}
+
 }  // namespace chatterino
@@ -7,6 +7,13 @@ namespace chatterino {
 
 constexpr long unsigned gifFrameLength = 33;
 
+/**
+ * @brief Clock of all animated images.
+ *
+ * Frames of animated images are picked from position() when they are
+ * painted. The timer only runs while animated images are being painted, it
+ * stops a few ticks after the last one wasn't painted anymore.
+ */
 class GIFTimer
 {
 public:
@@ -18,9 +25,18 @@ public:
         return this->position_;
     }
 
+    /// Called whenever an animated image is painted, keeps the animations
+    /// going. Gui thread only.
+    void animatedImagePainted();
+
 private:
+    // ticks without any painted animated image until the timer stops
+    static constexpr int maxIdleTicks = 3;
+
     QTimer timer;
     long unsigned position_{};
+    bool enabled_{false};
+    int idleTicks_{0};
 };
 
 }  // namespace chatterino
@@ -0,0 +1,112 @@
+#include "singletons/helper/HighlightNotifier.hpp"
+
+#include "Application.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "singletons/Settings.hpp"
+#include "singletons/WindowManager.hpp"
+#include "util/PostToThread.hpp"
+#include "util/QStringHash.hpp"
+
+#include <QApplication>
+#include <QMediaPlayer>
+
+#include <algorithm>
+
+namespace chatterino {
+
+HighlightNotifier &HighlightNotifier::instance()
+{
+    // never deleted, highlights can still arrive while the app shuts down
+    static auto *instance = new HighlightNotifier;
+    return *instance;
+}
+
+HighlightNotifier::HighlightNotifier()
+{
+    this->timer_.setSingleShot(true);
+    QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+        this->flush();
+    });
+}
+
+void HighlightNotifier::notify(const QUrl &soundUrl, bool alert)
+{
+    if (isGuiThread())
+    {
+        HighlightNotifier::instance().request(soundUrl, alert);
+        return;
+    }
+
+    postToThread([soundUrl, alert] {
+        HighlightNotifier::instance().request(soundUrl, alert);
+    });
+}
+
+void HighlightNotifier::request(const QUrl &soundUrl, bool alert)
+{
+    if (!soundUrl.isEmpty())
+    {
+        this->pendingSound_ = soundUrl;
+    }
+    this->pendingAlert_ = this->pendingAlert_ || alert;
+
+    if (this->timer_.isActive())
+    {
+        return;
+    }
+
+    // the highlights that arrive until the event loop runs again are
+    // handled together as well
+    auto wait = 0;
+    if (this->sinceFlush_.isValid())
+    {
+        wait = std::max<int>(0, INTERVAL_MS - this->sinceFlush_.elapsed());
+    }
+    this->timer_.start(wait);
+}
+
+void HighlightNotifier::flush()
+{
+    this->sinceFlush_.start();
+
+    if (!this->pendingSound_.isEmpty())
+    {
+        bool hasFocus = QApplication::focusWidget() != nullptr;
+        if (!hasFocus || getSettings()->highlightAlwaysPlaySound)
+        {
+            this->play(this->pendingSound_);
+        }
+        this->pendingSound_.clear();
+    }
+
+    if (this->pendingAlert_)
+    {
+        getApp()->windows->sendAlert();
+        this->pendingAlert_ = false;
+    }
+}
+
+void HighlightNotifier::play(const QUrl &url)
+{
+    auto key = url.toString();
+    auto it = this->players_.find(key);
+    if (it == this->players_.end())
+    {
+        if (this->players_.size() >= MAX_PLAYERS)
+        {
+            for (auto &player : this->players_)
+            {
+                player.second->deleteLater();
+            }
+            this->players_.clear();
+        }
+
+        auto *player = new QMediaPlayer;
+        player->setMedia(url);
+        it = this->players_.emplace(key, player).first;
+    }
+
+    it->second->play();
+}
+
+}  // namespace chatterino
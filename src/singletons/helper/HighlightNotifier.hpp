@@ -0,0 +1,56 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QString>
+#include <QTimer>
+#include <QUrl>
+#include <boost/noncopyable.hpp>
+
+#include <unordered_map>
+
+class QMediaPlayer;
+
+namespace chatterino {
+
+/**
+ * @brief Plays the sounds and flashes the taskbar for highlighted messages.
+ *
+ * Requests are coalesced: all highlights that arrive within an interval
+ * result in at most one sound and one alert. The first highlight after a
+ * quiet interval is handled right away, later ones at the end of the
+ * interval with the sound of the latest. The sounds are kept loaded in a
+ * player per url, so playing one again doesn't read the file again.
+ */
+class HighlightNotifier : boost::noncopyable
+{
+public:
+    /// Requests the sound (none if empty) and the taskbar alert, the sound
+    /// is only played if the window doesn't have focus or the settings say
+    /// so. Can be called from any thread.
+    static void notify(const QUrl &soundUrl, bool alert);
+
+private:
+    HighlightNotifier();
+
+    // gui thread only, it owns a timer
+    static HighlightNotifier &instance();
+
+    void request(const QUrl &soundUrl, bool alert);
+
+    void flush();
+    void play(const QUrl &url);
+
+    static constexpr int INTERVAL_MS = 1000;
+    // players kept loaded, custom sounds rarely add up to more than this
+    static constexpr size_t MAX_PLAYERS = 8;
+
+    QUrl pendingSound_;
+    bool pendingAlert_ = false;
+
+    QTimer timer_;
+    QElapsedTimer sinceFlush_;
+
+    std::unordered_map<QString, QMediaPlayer *> players_;
+};
+
+}  // namespace chatterino
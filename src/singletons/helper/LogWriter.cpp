@@ -0,0 +1,236 @@
+#include "singletons/helper/LogWriter.hpp"
+
+#include "common/QLogging.hpp"
+#include "singletons/Settings.hpp"
+
+#include <QDir>
+
+#include <algorithm>
+#include <chrono>
+
+namespace chatterino {
+
+namespace {
+
+    QByteArray endline("\n");
+
+    QString generateDateString(const QDateTime &now)
+    {
+        return now.toString("yyyy-MM-dd");
+    }
+
+    QString generateOpeningString(const QDateTime &now)
+    {
+        QString ret = QLatin1Literal("# Start logging at ");
+
+        ret.append(now.toString("yyyy-MM-dd HH:mm:ss "));
+        ret.append(now.timeZoneAbbreviation());
+        ret.append(endline);
+
+        return ret;
+    }
+
+    QString generateClosingString(
+        const QDateTime &now = QDateTime::currentDateTime())
+    {
+        QString ret = QLatin1Literal("# Stop logging at ");
+
+        ret.append(now.toString("yyyy-MM-dd HH:mm:ss"));
+        ret.append(now.timeZoneAbbreviation());
+        ret.append(endline);
+
+        return ret;
+    }
+
+}  // namespace
+
+LogWriter::LogWriter()
+    : thread_([this] {
+        this->run();
+    })
+{
+}
+
+LogWriter::~LogWriter()
+{
+    {
+        std::lock_guard<std::mutex> lock(this->mutex_);
+        this->stopping_ = true;
+    }
+    this->condition_.notify_one();
+
+    this->thread_.join();
+}
+
+void LogWriter::append(const QString &directory, const QString &channelName,
+                       const QDateTime &time, const QString &login,
+                       const QString &line)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    // a null line means close, empty lines still have to be written
+    this->queue_.push_back({directory, channelName, time, login,
+                            line.isNull() ? QString("") : line});
+}
+
+void LogWriter::close(const QString &directory, const QString &channelName)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+    this->queue_.push_back(
+        {directory, channelName, QDateTime(), QString(), QString()});
+}
+
+void LogWriter::run()
+{
+    std::vector<Entry> entries;
+
+    while (true)
+    {
+        bool stopping = false;
+
+        {
+            std::unique_lock<std::mutex> lock(this->mutex_);
+            this->condition_.wait_for(
+                lock,
+                std::chrono::milliseconds(
+                    std::max(10, getSettings()->logFlushInterval.getValue())),
+                [this] {
+                    return this->stopping_;
+                });
+
+            std::swap(entries, this->queue_);
+            stopping = this->stopping_;
+        }
+
+        this->process(entries);
+        entries.clear();
+
+        bool sync = getSettings()->logSyncToDisk;
+        for (auto &[key, file] : this->files_)
+        {
+            this->flush(*file, sync);
+        }
+
+        if (stopping)
+        {
+            for (auto &[key, file] : this->files_)
+            {
+                this->closeFile(*file);
+            }
+            this->files_.clear();
+            return;
+        }
+    }
+}
+
+void LogWriter::process(std::vector<Entry> &entries)
+{
+    for (auto &entry : entries)
+    {
+        auto &file = this->files_[{entry.directory, entry.channelName}];
+
+        if (entry.line.isNull())
+        {
+            if (file)
+            {
+                this->closeFile(*file);
+            }
+            this->files_.erase({entry.directory, entry.channelName});
+            continue;
+        }
+
+        if (!file)
+        {
+            file = std::make_unique<File>();
+        }
+
+        auto dateString = generateDateString(entry.time);
+        if (dateString != file->dateString)
+        {
+            this->open(*file, entry, dateString);
+        }
+
+        if (file->compressed.isOpen())
+        {
+            file->compressed.append(entry.time, entry.login, entry.line);
+        }
+        else if (file->handle.isOpen())
+        {
+            file->pending.append('[');
+            file->pending.append(entry.time.toString("HH:mm:ss").toUtf8());
+            file->pending.append("] ");
+            file->pending.append(entry.line.toUtf8());
+            file->pending.append(endline);
+        }
+    }
+}
+
+void LogWriter::open(File &file, const Entry &entry, const QString &dateString)
+{
+    this->closeFile(file);
+
+    file.dateString = dateString;
+
+    if (!QDir().mkpath(entry.directory))
+    {
+        qCDebug(chatterinoHelper) << "Unable to create logging path";
+        return;
+    }
+
+    // Open file handle to log file of current date
+    QString fileName = entry.directory + QDir::separator() +
+                       entry.channelName + "-" + dateString;
+    if (getSettings()->logCompressed)
+    {
+        fileName += ".clog";
+        qCDebug(chatterinoHelper) << "Logging to" << fileName;
+        file.compressed.open(fileName);
+        return;
+    }
+
+    fileName += ".log";
+    qCDebug(chatterinoHelper) << "Logging to" << fileName;
+    file.handle.setFileName(fileName);
+
+    if (file.handle.open(QIODevice::Append))
+    {
+        file.pending.append(generateOpeningString(entry.time).toUtf8());
+    }
+}
+
+void LogWriter::closeFile(File &file)
+{
+    if (file.compressed.isOpen())
+    {
+        file.compressed.close(getSettings()->logSyncToDisk);
+    }
+
+    if (!file.handle.isOpen())
+    {
+        return;
+    }
+
+    file.pending.append(generateClosingString().toUtf8());
+    this->flush(file, getSettings()->logSyncToDisk);
+    file.handle.close();
+}
+
+void LogWriter::flush(File &file, bool sync)
+{
+    file.compressed.flush(false, sync);
+
+    if (file.pending.isEmpty() || !file.handle.isOpen())
+    {
+        return;
+    }
+
+    file.handle.write(file.pending);
+    file.handle.flush();
+    file.pending.clear();
+
+    if (sync)
+    {
+        syncToDisk(file.handle);
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,81 @@
+#pragma once
+
+#include "singletons/helper/CompressedLog.hpp"
+
+#include <QByteArray>
+#include <QDateTime>
+#include <QFile>
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <condition_variable>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Writes the log files of all LoggingChannels on a background thread.
+ *
+ * Lines are queued from the gui thread and written in batches, every flush
+ * interval the writer appends everything queued for a file in one write.
+ * Log files are opened, rolled over at midnight and closed (with the usual
+ * opening and closing lines) on the writer thread as well.
+ *
+ * Files opened while /logging/compressed is set are written in the format of
+ * CompressedLogWriter instead of plain text.
+ */
+class LogWriter : boost::noncopyable
+{
+public:
+    LogWriter();
+    /// Writes everything that's still queued and closes all files
+    ~LogWriter();
+
+    /// Queues line for the log of channelName in directory, time decides which
+    /// day's file it goes into. login is the sender of the message, if any.
+    void append(const QString &directory, const QString &channelName,
+                const QDateTime &time, const QString &login,
+                const QString &line);
+    /// Queues closing the current log file of channelName in directory
+    void close(const QString &directory, const QString &channelName);
+
+private:
+    struct Entry {
+        QString directory;
+        QString channelName;
+        QDateTime time;
+        QString login;
+        // null if the file should be closed
+        QString line;
+    };
+
+    struct File {
+        QFile handle;
+        QString dateString;
+        QByteArray pending;
+        // used instead of handle for compressed logs
+        CompressedLogWriter compressed;
+    };
+
+    void run();
+    void process(std::vector<Entry> &entries);
+    void open(File &file, const Entry &entry, const QString &dateString);
+    void closeFile(File &file);
+    void flush(File &file, bool sync);
+
+    std::mutex mutex_;
+    std::condition_variable condition_;
+    std::vector<Entry> queue_;
+    bool stopping_ = false;
+
+    // writer thread only, keyed by directory and channel name
+    std::map<std::pair<QString, QString>, std::unique_ptr<File>> files_;
+
+    std::thread thread_;
+};
+
+}  // namespace chatterino
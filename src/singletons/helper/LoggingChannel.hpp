@@ -2,44 +2,37 @@
 
 #include "messages/Message.hpp"
 
-#include <QDateTime>
-#include <QFile>
 #include <QString>
 #include <boost/noncopyable.hpp>
+#include <pajlada/signals/signalholder.hpp>
 
 #include <memory>
 
 namespace chatterino {
 
 class Logging;
+class LogWriter;
 
 class LoggingChannel : boost::noncopyable
 {
-    explicit LoggingChannel(const QString &_channelName);
+    explicit LoggingChannel(const QString &_channelName, LogWriter &writer);
 
 public:
     ~LoggingChannel();
     void addMessage(MessagePtr message);
 
-private:
-    void openLogFile();
-
-    QString generateOpeningString(
-        const QDateTime &now = QDateTime::currentDateTime()) const;
-    QString generateClosingString(
-        const QDateTime &now = QDateTime::currentDateTime()) const;
-
-    void appendLine(const QString &line);
+    /// Directory of the logs of channelName, relative to the log path
+    static QString subDirectoryFor(const QString &channelName);
 
-    QString generateDateString(const QDateTime &now);
+private:
+    QString directory() const;
 
     const QString channelName;
     QString baseDirectory;
     QString subDirectory;
 
-    QFile fileHandle;
-
-    QString dateString;
+    LogWriter &writer_;
+    pajlada::Signals::SignalHolder managedConnections_;
 
     friend class Logging;
 };
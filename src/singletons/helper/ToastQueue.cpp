@@ -0,0 +1,97 @@
+#include "singletons/helper/ToastQueue.hpp"
+
+#include <QStringList>
+
+#include <algorithm>
+
+namespace chatterino {
+
+QString ToastQueue::Toast::text() const
+{
+    if (this->channels.size() == 1)
+    {
+        return this->channels.front().name + " is live!";
+    }
+
+    QStringList names;
+    for (size_t i = 0;
+         i < std::min(this->channels.size(), MAX_NAMED_CHANNELS); i++)
+    {
+        names.append(this->channels[i].name);
+    }
+
+    if (this->channels.size() > MAX_NAMED_CHANNELS)
+    {
+        return QString("%1 and %2 more are live!")
+            .arg(names.join(", "))
+            .arg(this->channels.size() - MAX_NAMED_CHANNELS);
+    }
+
+    auto last = names.takeLast();
+    return QString("%1 and %2 are live!").arg(names.join(", "), last);
+}
+
+void ToastQueue::push(const QString &channelName, Platform platform,
+                      Clock::time_point now)
+{
+    auto queued = std::any_of(this->pending_.begin(), this->pending_.end(),
+                              [&](const Channel &channel) {
+                                  return channel.name == channelName &&
+                                         channel.platform == platform;
+                              });
+    if (queued)
+    {
+        return;
+    }
+
+    if (this->pending_.empty())
+    {
+        this->firstPushed_ = now;
+    }
+    this->pending_.push_back({channelName, platform});
+}
+
+bool ToastQueue::empty() const
+{
+    return this->pending_.empty();
+}
+
+ToastQueue::Clock::time_point ToastQueue::nextDue() const
+{
+    auto due = this->firstPushed_ + MERGE_DELAY;
+    if (this->tokens_ > 0)
+    {
+        return due;
+    }
+    return std::max(due, this->refilled_ + REFILL_INTERVAL);
+}
+
+boost::optional<ToastQueue::Toast> ToastQueue::take(Clock::time_point now)
+{
+    this->refill(now);
+    if (this->pending_.empty() || now < this->nextDue())
+    {
+        return boost::none;
+    }
+
+    if (this->tokens_ == BURST)
+    {
+        this->refilled_ = now;
+    }
+    this->tokens_--;
+
+    Toast toast;
+    std::swap(toast.channels, this->pending_);
+    return toast;
+}
+
+void ToastQueue::refill(Clock::time_point now)
+{
+    while (this->tokens_ < BURST && now >= this->refilled_ + REFILL_INTERVAL)
+    {
+        this->tokens_++;
+        this->refilled_ += REFILL_INTERVAL;
+    }
+}
+
+}  // namespace chatterino
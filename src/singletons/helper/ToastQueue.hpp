@@ -0,0 +1,72 @@
+#pragma once
+
+#include <boost/optional.hpp>
+#include <QString>
+
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace chatterino {
+
+enum class Platform : uint8_t;
+
+/**
+ * @brief Decides when the queued live notifications are shown and which of
+ *        them are merged.
+ *
+ * A notification waits a moment for others to arrive, all that are queued
+ * by then are shown as one. Toasts are rate limited with a small burst, the
+ * channels that go live while the limit is reached pile up into a single
+ * summary. A channel that's already queued isn't queued again.
+ *
+ * Only models the timing, not thread safe.
+ */
+class ToastQueue
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // how long a notification waits for others to merge with
+    static constexpr std::chrono::milliseconds MERGE_DELAY{1000};
+    // toasts that can be shown right after another, one more becomes
+    // available every REFILL_INTERVAL
+    static constexpr int BURST = 3;
+    static constexpr std::chrono::milliseconds REFILL_INTERVAL{10000};
+    // channels named in a summary, the others are only counted
+    static constexpr size_t MAX_NAMED_CHANNELS = 3;
+
+    struct Channel {
+        QString name;
+        Platform platform;
+    };
+
+    struct Toast {
+        // in the order they went live
+        std::vector<Channel> channels;
+
+        /// "forsen is live!", or a summary for several channels
+        QString text() const;
+    };
+
+    void push(const QString &channelName, Platform platform,
+              Clock::time_point now);
+
+    bool empty() const;
+    /// When take returns the next toast, only valid if it isn't empty
+    Clock::time_point nextDue() const;
+    /// The next toast if it's due
+    boost::optional<Toast> take(Clock::time_point now);
+
+private:
+    void refill(Clock::time_point now);
+
+    std::vector<Channel> pending_;
+    Clock::time_point firstPushed_;
+
+    int tokens_ = BURST;
+    // when the last token was added, or the first one was taken from full
+    Clock::time_point refilled_;
+};
+
+}  // namespace chatterino
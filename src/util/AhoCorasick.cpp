@@ -0,0 +1,95 @@
+#include "util/AhoCorasick.hpp"
+
+#include <algorithm>
+#include <queue>
+
+namespace chatterino {
+
+AhoCorasick::AhoCorasick()
+    : nodes_(1)
+{
+}
+
+int AhoCorasick::find(int node, char16_t c) const
+{
+    const auto &next = this->nodes_[node].next;
+    auto it = std::lower_bound(next.begin(), next.end(), c,
+                               [](const auto &edge, char16_t value) {
+                                   return edge.first < value;
+                               });
+
+    if (it != next.end() && it->first == c)
+    {
+        return it->second;
+    }
+    return -1;
+}
+
+void AhoCorasick::add(const QString &pattern, size_t id)
+{
+    int node = 0;
+
+    for (auto c : pattern)
+    {
+        auto child = this->find(node, c.unicode());
+
+        if (child < 0)
+        {
+            child = int(this->nodes_.size());
+            this->nodes_.emplace_back();
+            this->nodes_[child].depth = this->nodes_[node].depth + 1;
+
+            auto &next = this->nodes_[node].next;
+            auto it = std::lower_bound(next.begin(), next.end(),
+                                       std::make_pair(c.unicode(), 0));
+            next.insert(it, {c.unicode(), child});
+        }
+
+        node = child;
+    }
+
+    this->nodes_[node].ids.push_back(id);
+}
+
+void AhoCorasick::build()
+{
+    std::queue<int> queue;
+
+    for (const auto &edge : this->nodes_[0].next)
+    {
+        this->nodes_[edge.second].fail = 0;
+        queue.push(edge.second);
+    }
+
+    while (!queue.empty())
+    {
+        auto node = queue.front();
+        queue.pop();
+
+        for (const auto &[c, child] : this->nodes_[node].next)
+        {
+            auto fail = this->nodes_[node].fail;
+            while (fail != 0 && this->find(fail, c) < 0)
+            {
+                fail = this->nodes_[fail].fail;
+            }
+
+            auto target = this->find(fail, c);
+            auto childFail = target >= 0 ? target : 0;
+
+            this->nodes_[child].fail = childFail;
+            this->nodes_[child].output = this->nodes_[childFail].ids.empty()
+                                             ? this->nodes_[childFail].output
+                                             : childFail;
+
+            queue.push(child);
+        }
+    }
+}
+
+bool AhoCorasick::empty() const
+{
+    return this->nodes_.size() == 1;
+}
+
+}  // namespace chatterino
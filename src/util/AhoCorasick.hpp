@@ -0,0 +1,78 @@
+#pragma once
+
+#include <QString>
+
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Finds all occurrences of a set of patterns in a single pass over a
+ *        subject.
+ *
+ * Patterns are compared by UTF-16 code units, fold both sides for case
+ * insensitive matching. build() has to be called after the last pattern was
+ * added and before searching.
+ */
+class AhoCorasick
+{
+public:
+    AhoCorasick();
+
+    /// id is passed to the search callback for matches of pattern
+    void add(const QString &pattern, size_t id);
+    void build();
+    bool empty() const;
+
+    /// Calls onMatch(id, start, end) for every occurrence
+    template <typename F>
+    void search(const QString &subject, F &&onMatch) const;
+
+private:
+    struct Node {
+        std::vector<std::pair<char16_t, int>> next;
+        std::vector<size_t> ids;
+        int fail = 0;
+        // closest node in the fail chain which has ids, or -1
+        int output = -1;
+        int depth = 0;
+    };
+
+    int find(int node, char16_t c) const;
+
+    std::vector<Node> nodes_;
+};
+
+template <typename F>
+void AhoCorasick::search(const QString &subject, F &&onMatch) const
+{
+    int state = 0;
+
+    for (int i = 0; i < subject.size(); i++)
+    {
+        auto c = subject[i].unicode();
+
+        while (state != 0 && this->find(state, c) < 0)
+        {
+            state = this->nodes_[state].fail;
+        }
+
+        auto next = this->find(state, c);
+        state = next >= 0 ? next : 0;
+
+        auto node =
+            this->nodes_[state].ids.empty() ? this->nodes_[state].output : state;
+        while (node > 0)
+        {
+            const auto &output = this->nodes_[node];
+            for (auto id : output.ids)
+            {
+                onMatch(id, i + 1 - output.depth, i + 1);
+            }
+            node = output.output;
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,333 @@
+#include "util/CaseInsensitive.hpp"
+
+#include <QString>
+
+#include <algorithm>
+
+#if defined(__SSE2__) || defined(_M_X64) || \
+    (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#    define CHATTERINO_CASE_SSE2
+#    include <emmintrin.h>
+#elif defined(__ARM_NEON) && defined(__aarch64__)
+#    define CHATTERINO_CASE_NEON
+#    include <arm_neon.h>
+#endif
+
+namespace chatterino {
+
+namespace {
+
+    using Unit = char16_t;
+
+    // code units per vector
+    constexpr qsizetype BLOCK = 8;
+
+    enum class Compared {
+        Equal,
+        Different,
+        // a unit isn't ASCII, Qt has to compare it
+        NotAscii,
+    };
+
+    const Unit *unitsOf(QStringView string)
+    {
+        return reinterpret_cast<const Unit *>(string.utf16());
+    }
+
+    // for Qt's functions, without copying the view
+    QString rawString(QStringView string)
+    {
+        return QString::fromRawData(string.data(), int(string.size()));
+    }
+
+    Unit foldAscii(Unit c)
+    {
+        return c >= 'A' && c <= 'Z' ? Unit(c | 0x20) : c;
+    }
+
+#if defined(CHATTERINO_CASE_SSE2)
+
+    __m128i load(const Unit *units)
+    {
+        return _mm_loadu_si128(reinterpret_cast<const __m128i *>(units));
+    }
+
+    bool allAscii(__m128i units)
+    {
+        auto high = _mm_and_si128(units, _mm_set1_epi16(short(0xff80)));
+        return _mm_movemask_epi8(_mm_cmpeq_epi16(
+                   high, _mm_setzero_si128())) == 0xffff;
+    }
+
+    // units above 0x7fff are negative here, they stay as they are
+    __m128i fold(__m128i units)
+    {
+        auto upper =
+            _mm_and_si128(_mm_cmpgt_epi16(units, _mm_set1_epi16('A' - 1)),
+                          _mm_cmplt_epi16(units, _mm_set1_epi16('Z' + 1)));
+        return _mm_or_si128(units, _mm_and_si128(upper, _mm_set1_epi16(0x20)));
+    }
+
+    bool isAsciiBlock(const Unit *units)
+    {
+        return allAscii(load(units));
+    }
+
+    Compared compareBlock(const Unit *a, const Unit *b)
+    {
+        auto va = load(a);
+        auto vb = load(b);
+        if (!allAscii(_mm_or_si128(va, vb)))
+        {
+            return Compared::NotAscii;
+        }
+        return _mm_movemask_epi8(_mm_cmpeq_epi16(fold(va), fold(vb))) ==
+                       0xffff
+                   ? Compared::Equal
+                   : Compared::Different;
+    }
+
+    // bit i is set if unit i folds to c
+    unsigned matchBlock(const Unit *units, Unit c)
+    {
+        auto equal =
+            _mm_cmpeq_epi16(fold(load(units)), _mm_set1_epi16(short(c)));
+        return unsigned(
+            _mm_movemask_epi8(_mm_packs_epi16(equal, _mm_setzero_si128())));
+    }
+
+#elif defined(CHATTERINO_CASE_NEON)
+
+    uint16x8_t load(const Unit *units)
+    {
+        return vld1q_u16(reinterpret_cast<const uint16_t *>(units));
+    }
+
+    bool allAscii(uint16x8_t units)
+    {
+        return vmaxvq_u16(units) < 0x80;
+    }
+
+    uint16x8_t fold(uint16x8_t units)
+    {
+        auto upper = vandq_u16(vcgeq_u16(units, vdupq_n_u16('A')),
+                               vcleq_u16(units, vdupq_n_u16('Z')));
+        return vorrq_u16(units, vandq_u16(upper, vdupq_n_u16(0x20)));
+    }
+
+    bool isAsciiBlock(const Unit *units)
+    {
+        return allAscii(load(units));
+    }
+
+    Compared compareBlock(const Unit *a, const Unit *b)
+    {
+        auto va = load(a);
+        auto vb = load(b);
+        if (!allAscii(vorrq_u16(va, vb)))
+        {
+            return Compared::NotAscii;
+        }
+        return vminvq_u16(vceqq_u16(fold(va), fold(vb))) == 0xffff
+                   ? Compared::Equal
+                   : Compared::Different;
+    }
+
+    unsigned matchBlock(const Unit *units, Unit c)
+    {
+        static const uint16_t bits[BLOCK] = {1, 2, 4, 8, 16, 32, 64, 128};
+        auto equal = vceqq_u16(fold(load(units)), vdupq_n_u16(c));
+        return vaddvq_u16(vandq_u16(equal, vld1q_u16(bits)));
+    }
+
+#else
+
+    bool isAsciiBlock(const Unit *units)
+    {
+        Unit all = 0;
+        for (qsizetype i = 0; i < BLOCK; i++)
+        {
+            all |= units[i];
+        }
+        return all < 0x80;
+    }
+
+    Compared compareBlock(const Unit *a, const Unit *b)
+    {
+        if (!isAsciiBlock(a) || !isAsciiBlock(b))
+        {
+            return Compared::NotAscii;
+        }
+        for (qsizetype i = 0; i < BLOCK; i++)
+        {
+            if (foldAscii(a[i]) != foldAscii(b[i]))
+            {
+                return Compared::Different;
+            }
+        }
+        return Compared::Equal;
+    }
+
+    unsigned matchBlock(const Unit *units, Unit c)
+    {
+        unsigned matches = 0;
+        for (qsizetype i = 0; i < BLOCK; i++)
+        {
+            if (foldAscii(units[i]) == c)
+            {
+                matches |= 1U << i;
+            }
+        }
+        return matches;
+    }
+
+#endif
+
+    // Compares the first count units of a and b. A mismatch before the first
+    // unit that isn't ASCII is Different, since all units up to it line up.
+    Compared compareAscii(const Unit *a, const Unit *b, qsizetype count)
+    {
+        qsizetype i = 0;
+        for (; i + BLOCK <= count; i += BLOCK)
+        {
+            auto compared = compareBlock(a + i, b + i);
+            if (compared != Compared::Equal)
+            {
+                return compared;
+            }
+        }
+        for (; i < count; i++)
+        {
+            if (a[i] >= 0x80 || b[i] >= 0x80)
+            {
+                return Compared::NotAscii;
+            }
+            if (foldAscii(a[i]) != foldAscii(b[i]))
+            {
+                return Compared::Different;
+            }
+        }
+        return Compared::Equal;
+    }
+
+}  // namespace
+
+bool isAscii(QStringView string)
+{
+    const auto *units = unitsOf(string);
+    auto size = string.size();
+
+    qsizetype i = 0;
+    for (; i + BLOCK <= size; i += BLOCK)
+    {
+        if (!isAsciiBlock(units + i))
+        {
+            return false;
+        }
+    }
+    for (; i < size; i++)
+    {
+        if (units[i] >= 0x80)
+        {
+            return false;
+        }
+    }
+    return true;
+}
+
+bool equalsIgnoreCase(QStringView a, QStringView b)
+{
+    switch (compareAscii(unitsOf(a), unitsOf(b), std::min(a.size(), b.size())))
+    {
+        case Compared::Equal:
+            // the rest of the longer one can't fold to nothing
+            return a.size() == b.size();
+        case Compared::Different:
+            return false;
+        case Compared::NotAscii:
+        default:
+            return QString::compare(rawString(a), rawString(b),
+                                    Qt::CaseInsensitive) == 0;
+    }
+}
+
+bool startsWithIgnoreCase(QStringView string, QStringView prefix)
+{
+    // Qt compares the lengths first as well
+    if (prefix.size() > string.size())
+    {
+        return false;
+    }
+
+    switch (compareAscii(unitsOf(string), unitsOf(prefix), prefix.size()))
+    {
+        case Compared::Equal:
+            return true;
+        case Compared::Different:
+            return false;
+        case Compared::NotAscii:
+        default:
+            return rawString(string).startsWith(rawString(prefix),
+                                                Qt::CaseInsensitive);
+    }
+}
+
+qsizetype indexOfIgnoreCase(QStringView haystack, QStringView needle,
+                            qsizetype from)
+{
+    // units that aren't ASCII can fold to ASCII letters, e.g. the Kelvin
+    // sign to 'k', so only ASCII in both is searched here
+    if (from < 0 || !isAscii(needle) || !isAscii(haystack))
+    {
+        return rawString(haystack).indexOf(rawString(needle), int(from),
+                                           Qt::CaseInsensitive);
+    }
+
+    auto size = haystack.size();
+    auto needleSize = needle.size();
+    if (needleSize == 0)
+    {
+        return from <= size ? from : -1;
+    }
+
+    const auto *units = unitsOf(haystack);
+    const auto *needleUnits = unitsOf(needle);
+    auto first = foldAscii(needleUnits[0]);
+    // the last index needle can start at
+    auto last = size - needleSize;
+
+    auto matchesAt = [&](qsizetype i) {
+        return compareAscii(units + i + 1, needleUnits + 1, needleSize - 1) ==
+               Compared::Equal;
+    };
+
+    // the first unit is looked for in whole blocks, the rest of needle is
+    // only compared where it matched
+    qsizetype i = from;
+    for (; i + BLOCK - 1 <= last; i += BLOCK)
+    {
+        auto matches = matchBlock(units + i, first);
+        for (qsizetype bit = 0; matches != 0; bit++, matches >>= 1)
+        {
+            if ((matches & 1) != 0 && matchesAt(i + bit))
+            {
+                return i + bit;
+            }
+        }
+    }
+    for (; i <= last; i++)
+    {
+        if (foldAscii(units[i]) == first && matchesAt(i))
+        {
+            return i;
+        }
+    }
+    return -1;
+}
+
+bool containsIgnoreCase(QStringView haystack, QStringView needle)
+{
+    return indexOfIgnoreCase(haystack, needle) != -1;
+}
+
+}  // namespace chatterino
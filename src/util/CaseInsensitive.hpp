@@ -0,0 +1,25 @@
+#pragma once
+
+#include <QStringView>
+
+namespace chatterino {
+
+// Case insensitive comparisons with the same results as QString's with
+// Qt::CaseInsensitive, except that null and empty strings are the same.
+// Chat is mostly ASCII, so strings that are ASCII are compared eight code
+// units at a time with SSE2 or NEON, anything else goes through Qt's Unicode
+// case folding.
+
+/// Whether all code units of string are below 0x80
+bool isAscii(QStringView string);
+
+bool equalsIgnoreCase(QStringView a, QStringView b);
+bool startsWithIgnoreCase(QStringView string, QStringView prefix);
+
+/// Index of the first occurrence of needle at or after from, -1 if there's
+/// none. A negative from counts from the end like in QString::indexOf.
+qsizetype indexOfIgnoreCase(QStringView haystack, QStringView needle,
+                            qsizetype from = 0);
+bool containsIgnoreCase(QStringView haystack, QStringView needle);
+
+}  // namespace chatterino
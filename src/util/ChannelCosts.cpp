@@ -0,0 +1,247 @@
+#include "util/ChannelCosts.hpp"
+
+#include "util/FormatTime.hpp"
+#include "util/QStringHash.hpp"
+
+#include <algorithm>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace chatterino {
+
+namespace {
+
+    using Clock = std::chrono::steady_clock;
+    using Costs = std::array<int64_t, ChannelCosts::CATEGORY_COUNT>;
+
+    struct Ledger {
+        std::mutex mutex;
+        std::unordered_map<QString, Costs> costs;
+    };
+
+    struct Ledgers {
+        std::mutex mutex;
+        // threads that exited keep their ledger in here
+        std::vector<std::shared_ptr<Ledger>> all;
+        Clock::time_point since = Clock::now();
+    };
+
+    Ledgers &ledgers()
+    {
+        static Ledgers instance;
+        return instance;
+    }
+
+    Ledger &threadLedger()
+    {
+        thread_local std::shared_ptr<Ledger> ledger = [] {
+            auto ledger = std::make_shared<Ledger>();
+
+            auto &ledgers = chatterino::ledgers();
+            std::lock_guard<std::mutex> lock(ledgers.mutex);
+            ledgers.all.push_back(ledger);
+            return ledger;
+        }();
+        return *ledger;
+    }
+
+    std::vector<std::shared_ptr<Ledger>> allLedgers()
+    {
+        auto &ledgers = chatterino::ledgers();
+        std::lock_guard<std::mutex> lock(ledgers.mutex);
+        return ledgers.all;
+    }
+
+    thread_local ChannelCosts::Scope *innermostScope = nullptr;
+
+    QString formatNanoseconds(int64_t nanoseconds)
+    {
+        return QString("%1 ms").arg(double(nanoseconds) / 1e6, 0, 'f', 1);
+    }
+
+    const std::array<CostCategory, ChannelCosts::CATEGORY_COUNT> categories{
+        CostCategory::Building, CostCategory::Highlights,
+        CostCategory::Filters,  CostCategory::Layout,
+        CostCategory::Images,
+    };
+
+}  // namespace
+
+ChannelCosts::Scope::Scope(QString channel, CostCategory category)
+    : channel_(std::move(channel))
+    , category_(category)
+    , start_(Clock::now())
+    , outer_(innermostScope)
+{
+    innermostScope = this;
+}
+
+ChannelCosts::Scope::~Scope()
+{
+    auto elapsed = Clock::now() - this->start_;
+
+    innermostScope = this->outer_;
+    if (this->outer_ != nullptr)
+    {
+        this->outer_->nested_ += elapsed;
+    }
+
+    ChannelCosts::add(this->channel_, this->category_,
+                      std::chrono::duration_cast<std::chrono::nanoseconds>(
+                          elapsed - this->nested_));
+}
+
+int64_t ChannelCosts::ChannelCost::total() const
+{
+    int64_t total = 0;
+    for (auto nanoseconds : this->nanoseconds)
+    {
+        total += nanoseconds;
+    }
+    return total;
+}
+
+void ChannelCosts::add(const QString &channel, CostCategory category,
+                       std::chrono::nanoseconds duration)
+{
+    if (channel.isEmpty())
+    {
+        return;
+    }
+
+    auto &ledger = threadLedger();
+    std::lock_guard<std::mutex> lock(ledger.mutex);
+    ledger.costs[channel][size_t(category)] += duration.count();
+}
+
+QString ChannelCosts::current()
+{
+    if (innermostScope == nullptr)
+    {
+        return QString();
+    }
+    return innermostScope->channel_;
+}
+
+std::vector<ChannelCosts::ChannelCost> ChannelCosts::channels()
+{
+    std::unordered_map<QString, Costs> merged;
+    for (const auto &ledger : allLedgers())
+    {
+        std::lock_guard<std::mutex> lock(ledger->mutex);
+        for (const auto &[channel, costs] : ledger->costs)
+        {
+            auto &total = merged[channel];
+            for (size_t i = 0; i < CATEGORY_COUNT; i++)
+            {
+                total[i] += costs[i];
+            }
+        }
+    }
+
+    std::vector<ChannelCost> channels;
+    channels.reserve(merged.size());
+    for (const auto &[channel, costs] : merged)
+    {
+        channels.push_back({channel, costs});
+    }
+
+    std::sort(channels.begin(), channels.end(),
+              [](const auto &a, const auto &b) {
+                  return a.total() > b.total();
+              });
+    return channels;
+}
+
+void ChannelCosts::reset()
+{
+    for (const auto &ledger : allLedgers())
+    {
+        std::lock_guard<std::mutex> lock(ledger->mutex);
+        ledger->costs.clear();
+    }
+
+    auto &ledgers = chatterino::ledgers();
+    std::lock_guard<std::mutex> lock(ledgers.mutex);
+    ledgers.since = Clock::now();
+}
+
+QStringList ChannelCosts::snapshot(size_t maxChannels)
+{
+    Clock::time_point since;
+    {
+        auto &ledgers = chatterino::ledgers();
+        std::lock_guard<std::mutex> lock(ledgers.mutex);
+        since = ledgers.since;
+    }
+
+    auto channels = ChannelCosts::channels();
+
+    Costs totals{};
+    for (const auto &channel : channels)
+    {
+        for (size_t i = 0; i < CATEGORY_COUNT; i++)
+        {
+            totals[i] += channel.nanoseconds[i];
+        }
+    }
+
+    auto describe = [](const Costs &costs) {
+        QStringList parts;
+        for (auto category : categories)
+        {
+            auto nanoseconds = costs[size_t(category)];
+            parts.append(QString("%1 %2").arg(name(category),
+                                              formatNanoseconds(nanoseconds)));
+        }
+        return parts.join(", ");
+    };
+
+    // formatTime is empty for 0
+    auto seconds = std::max<int64_t>(
+        std::chrono::duration_cast<std::chrono::seconds>(Clock::now() - since)
+            .count(),
+        1);
+    QStringList lines;
+    lines.append(QString("CPU time of the last %1: %2 (%3)")
+                     .arg(formatTime(int(seconds)),
+                          formatNanoseconds(ChannelCost{{}, totals}.total()),
+                          describe(totals)));
+
+    for (size_t i = 0; i < std::min(channels.size(), maxChannels); i++)
+    {
+        const auto &channel = channels[i];
+        lines.append(QString("%1: %2 (%3)")
+                         .arg(channel.name,
+                              formatNanoseconds(channel.total()),
+                              describe(channel.nanoseconds)));
+    }
+    if (channels.size() > maxChannels)
+    {
+        lines.append(QString("and %1 cheaper channels")
+                         .arg(channels.size() - maxChannels));
+    }
+
+    return lines;
+}
+
+QString ChannelCosts::name(CostCategory category)
+{
+    switch (category)
+    {
+        case CostCategory::Building:
+            return "building";
+        case CostCategory::Highlights:
+            return "highlights";
+        case CostCategory::Filters:
+            return "filters";
+        case CostCategory::Layout:
+            return "layout";
+        case CostCategory::Images:
+            return "images";
+    }
+    return {};
+}
+
+}  // namespace chatterino
@@ -0,0 +1,80 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <vector>
+
+namespace chatterino {
+
+enum class CostCategory {
+    Building,
+    Highlights,
+    Filters,
+    Layout,
+    Images,
+};
+
+/**
+ * @brief The CPU time spent on each channel, to find the ones that are worth
+ * making dormant.
+ *
+ * Every thread adds to its own ledger, so recording only takes a lock that
+ * nobody else wants, except while a snapshot is made. Scopes can be nested,
+ * the time of the inner ones doesn't count for the outer ones.
+ */
+class ChannelCosts
+{
+public:
+    static constexpr size_t CATEGORY_COUNT = 5;
+
+    /// Adds the time from its creation until it's destroyed to the cost of a
+    /// channel, nothing for an empty name
+    class Scope
+    {
+    public:
+        Scope(QString channel, CostCategory category);
+        ~Scope();
+
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+    private:
+        friend class ChannelCosts;
+
+        QString channel_;
+        CostCategory category_;
+        std::chrono::steady_clock::time_point start_;
+        // of the scopes nested in this one
+        std::chrono::steady_clock::duration nested_{};
+        Scope *outer_;
+    };
+
+    struct ChannelCost {
+        QString name;
+        std::array<int64_t, CATEGORY_COUNT> nanoseconds{};
+
+        int64_t total() const;
+    };
+
+    static void add(const QString &channel, CostCategory category,
+                    std::chrono::nanoseconds duration);
+    /// The channel of the innermost scope of this thread, empty outside of
+    /// one. Work that is done later for it, like decoding an image that's
+    /// loaded while it's painted, can be added to it.
+    static QString current();
+
+    /// The costs since the start or the last reset, the largest first
+    static std::vector<ChannelCost> channels();
+    static void reset();
+
+    /// Lines with the totals and the most expensive channels
+    static QStringList snapshot(size_t maxChannels);
+
+    static QString name(CostCategory category);
+};
+
+}  // namespace chatterino
@@ -0,0 +1,58 @@
+#include "util/CombinedRegex.hpp"
+
+namespace chatterino {
+
+namespace {
+
+    // Constructs which refer to capture groups by number, recurse into the
+    // pattern or could swallow the closing parenthesis of the group the
+    // pattern is wrapped in. These would change their meaning inside a
+    // combined regex.
+    const QRegularExpression UNCOMBINABLE_REGEX(
+        R"(\\[1-9gkQ]|\(\?(P|\||R|&|[+-]?[0-9]|[a-zA-Z-]*x))");
+
+}  // namespace
+
+bool CombinedRegex::canCombine(const QString &pattern)
+{
+    return !UNCOMBINABLE_REGEX.match(pattern).hasMatch();
+}
+
+void CombinedRegex::add(const QString &pattern, bool caseSensitive)
+{
+    this->patterns_.append((caseSensitive ? "(?-i:" : "(?i:") + pattern + ")");
+}
+
+bool CombinedRegex::build()
+{
+    if (this->patterns_.isEmpty())
+    {
+        return true;
+    }
+
+    this->regex_ =
+        QRegularExpression(this->patterns_.join('|'),
+                           QRegularExpression::UseUnicodePropertiesOption);
+    this->patterns_.clear();
+
+    if (!this->regex_.isValid())
+    {
+        this->regex_ = QRegularExpression();
+        return false;
+    }
+
+    this->regex_.optimize();
+    return true;
+}
+
+bool CombinedRegex::empty() const
+{
+    return this->regex_.pattern().isEmpty();
+}
+
+bool CombinedRegex::hasMatch(const QString &subject) const
+{
+    return !this->empty() && this->regex_.match(subject).hasMatch();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,36 @@
+#pragma once
+
+#include <QRegularExpression>
+#include <QString>
+#include <QStringList>
+
+namespace chatterino {
+
+/**
+ * @brief One alternation of several regex patterns, used to rule out a match
+ *        of all of them with a single evaluation.
+ *
+ * A match of the combined regex only means that at least one of the patterns
+ * might match, the patterns still have to be checked on their own then.
+ */
+class CombinedRegex
+{
+public:
+    /// Returns false for patterns that would change their meaning inside the
+    /// combined regex, these have to be checked on their own.
+    static bool canCombine(const QString &pattern);
+
+    void add(const QString &pattern, bool caseSensitive);
+
+    /// Returns false if the combined regex is invalid and can't be used
+    bool build();
+
+    bool empty() const;
+    bool hasMatch(const QString &subject) const;
+
+private:
+    QStringList patterns_;
+    QRegularExpression regex_;
+};
+
+}  // namespace chatterino
@@ -1,16 +1,28 @@
 #pragma once
 
-#include <QMap>
-#include <QMutex>
-#include <QMutexLocker>
+#include "util/QStringHash.hpp"
 
+#include <algorithm>
+#include <array>
 #include <functional>
-#include <map>
 #include <memory>
+#include <mutex>
+#include <shared_mutex>
+#include <unordered_map>
+#include <utility>
+#include <vector>
 
 namespace chatterino {
 
-template <typename TKey, typename TValue>
+/**
+ * @brief Hash map that can be used from several threads at once.
+ *
+ * The keys are spread over shards with their own read-write lock, readers
+ * never wait for each other and only wait for writers to the same shard.
+ * each visits the entries in the order of their keys and locks all shards
+ * while doing so, it's meant for rare passes over the whole map.
+ */
+template <typename TKey, typename TValue, size_t ShardCount = 16>
 class ConcurrentMap
 {
 public:
@@ -18,85 +30,144 @@ public:
 
     bool tryGet(const TKey &name, TValue &value) const
     {
-        QMutexLocker lock(&this->mutex_);
+        const auto &shard = this->shardOf(name);
+        std::shared_lock<std::shared_mutex> lock(shard.mutex);
 
-        auto a = this->data_.find(name);
-        if (a == this->data_.end())
+        auto a = shard.data.find(name);
+        if (a == shard.data.end())
         {
             return false;
         }
 
-        value = a.value();
+        value = a->second;
 
         return true;
     }
 
     TValue getOrAdd(const TKey &name, std::function<TValue()> addLambda)
     {
-        QMutexLocker lock(&this->mutex_);
+        auto &shard = this->shardOf(name);
 
-        auto a = this->data_.find(name);
-        if (a == this->data_.end())
+        {
+            std::shared_lock<std::shared_mutex> lock(shard.mutex);
+
+            auto a = shard.data.find(name);
+            if (a != shard.data.end())
+            {
+                return a->second;
+            }
+        }
+
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
+
+        // another thread might have added it in the meantime
+        auto a = shard.data.find(name);
+        if (a == shard.data.end())
         {
             TValue value = addLambda();
-            this->data_.insert(name, value);
+            shard.data.emplace(name, value);
             return value;
         }
 
-        return a.value();
+        return a->second;
     }
 
     TValue &operator[](const TKey &name)
     {
-        QMutexLocker lock(&this->mutex_);
+        auto &shard = this->shardOf(name);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-        return this->data_[name];
+        return shard.data[name];
     }
 
     void clear()
     {
-        QMutexLocker lock(&this->mutex_);
+        for (auto &shard : this->shards_)
+        {
+            std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-        this->data_.clear();
+            shard.data.clear();
+        }
     }
 
     void insert(const TKey &name, const TValue &value)
     {
-        QMutexLocker lock(&this->mutex_);
+        auto &shard = this->shardOf(name);
+        std::unique_lock<std::shared_mutex> lock(shard.mutex);
 
-        this->data_.insert(name, value);
+        shard.data.insert_or_assign(name, value);
     }
 
     void each(
         std::function<void(const TKey &name, const TValue &value)> func) const
     {
-        QMutexLocker lock(&this->mutex_);
-
-        QMapIterator<TKey, TValue> it(this->data_);
+        std::vector<std::shared_lock<std::shared_mutex>> locks;
+        locks.reserve(ShardCount);
+        for (const auto &shard : this->shards_)
+        {
+            locks.emplace_back(shard.mutex);
+        }
 
-        while (it.hasNext())
+        for (const auto *entry : this->sortedEntries())
         {
-            it.next();
-            func(it.key(), it.value());
+            func(entry->first, entry->second);
         }
     }
 
     void each(std::function<void(const TKey &name, TValue &value)> func)
     {
-        QMutexLocker lock(&this->mutex_);
-
-        QMutableMapIterator<TKey, TValue> it(this->data_);
+        std::vector<std::unique_lock<std::shared_mutex>> locks;
+        locks.reserve(ShardCount);
+        for (auto &shard : this->shards_)
+        {
+            locks.emplace_back(shard.mutex);
+        }
 
-        while (it.hasNext())
+        for (const auto *entry : this->sortedEntries())
         {
-            it.next();
-            func(it.key(), it.value());
+            func(entry->first, const_cast<TValue &>(entry->second));
         }
     }
 
 private:
-    mutable QMutex mutex_;
-    QMap<TKey, TValue> data_;
+    using Entry = std::pair<const TKey, TValue>;
+
+    struct Shard {
+        mutable std::shared_mutex mutex;
+        std::unordered_map<TKey, TValue> data;
+    };
+
+    Shard &shardOf(const TKey &name)
+    {
+        return this->shards_[std::hash<TKey>()(name) % ShardCount];
+    }
+
+    const Shard &shardOf(const TKey &name) const
+    {
+        return this->shards_[std::hash<TKey>()(name) % ShardCount];
+    }
+
+    // all shards have to be locked
+    std::vector<const Entry *> sortedEntries() const
+    {
+        std::vector<const Entry *> entries;
+        for (const auto &shard : this->shards_)
+        {
+            for (const auto &entry : shard.data)
+            {
+                entries.push_back(&entry);
+            }
+        }
+
+        std::sort(entries.begin(), entries.end(),
+                  [](const Entry *l, const Entry *r) {
+                      return l->first < r->first;
+                  });
+
+        return entries;
+    }
+
+    std::array<Shard, ShardCount> shards_;
 };
 
 }  // namespace chatterino
@@ -1,7 +1,185 @@
 #include "DebugCount.hpp"
 
+#include <algorithm>
+
 namespace chatterino {
 
+namespace {
+
+    // values below this get a bucket each
+    constexpr int64_t LINEAR_LIMIT = 8;
+    constexpr int SUB_BUCKET_BITS = 3;
+
+    int highestBit(uint64_t value)
+    {
+        int bit = 0;
+        while ((value >> (bit + 1)) != 0)
+        {
+            bit++;
+        }
+        return bit;
+    }
+
+}  // namespace
+
 UniqueAccess<QMap<QString, int64_t>> DebugCount::counts_;
 
+DebugCount::Registry &DebugCount::registry()
+{
+    static Registry registry;
+    return registry;
+}
+
+std::vector<DebugCount::Value> DebugCount::values()
+{
+    std::vector<Value> values;
+    {
+        auto counts = counts_.access();
+        for (auto it = counts->begin(); it != counts->end(); it++)
+        {
+            values.push_back({it.key(), it.value()});
+        }
+    }
+    {
+        auto &registry = DebugCount::registry();
+        std::lock_guard<std::mutex> lock(registry.mutex);
+        for (const auto *counter : registry.counters)
+        {
+            values.push_back({counter->name(), counter->value()});
+        }
+    }
+
+    std::sort(values.begin(), values.end(), [](const auto &a, const auto &b) {
+        return a.name < b.name;
+    });
+    return values;
+}
+
+std::vector<const DebugHistogram *> DebugCount::histograms()
+{
+    auto &registry = DebugCount::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+
+    auto histograms = registry.histograms;
+    std::sort(histograms.begin(), histograms.end(),
+              [](const auto *a, const auto *b) {
+                  return a->name() < b->name();
+              });
+    return histograms;
+}
+
+DebugCounter::DebugCounter(QString name)
+    : name_(std::move(name))
+{
+    auto &registry = DebugCount::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.counters.push_back(this);
+}
+
+int64_t DebugCounter::value() const
+{
+    int64_t value = 0;
+    for (const auto &slot : this->slots_)
+    {
+        value += slot.value.load(std::memory_order_relaxed);
+    }
+    return value;
+}
+
+const QString &DebugCounter::name() const
+{
+    return this->name_;
+}
+
+DebugHistogram::DebugHistogram(QString name)
+    : name_(std::move(name))
+{
+    auto &registry = DebugCount::registry();
+    std::lock_guard<std::mutex> lock(registry.mutex);
+    registry.histograms.push_back(this);
+}
+
+size_t DebugHistogram::bucketOf(int64_t microseconds)
+{
+    if (microseconds < LINEAR_LIMIT)
+    {
+        return size_t(std::max<int64_t>(microseconds, 0));
+    }
+
+    auto bit = highestBit(uint64_t(microseconds));
+    auto subBucket =
+        size_t(microseconds >> (bit - SUB_BUCKET_BITS)) % size_t(LINEAR_LIMIT);
+    auto bucket =
+        size_t(bit - SUB_BUCKET_BITS + 1) * size_t(LINEAR_LIMIT) + subBucket;
+
+    return std::min(bucket, BUCKETS - 1);
+}
+
+int64_t DebugHistogram::upperBoundOf(size_t bucket)
+{
+    if (bucket < size_t(LINEAR_LIMIT))
+    {
+        return int64_t(bucket);
+    }
+
+    auto bit = int(bucket / LINEAR_LIMIT) + SUB_BUCKET_BITS - 1;
+    auto subBucket = int64_t(bucket % LINEAR_LIMIT);
+    auto width = int64_t(1) << (bit - SUB_BUCKET_BITS);
+
+    return (LINEAR_LIMIT + subBucket) * width + width - 1;
+}
+
+DebugHistogram::Snapshot DebugHistogram::snapshot() const
+{
+    Snapshot snapshot;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        snapshot.buckets[i] = this->buckets_[i].load(std::memory_order_relaxed);
+        snapshot.count += snapshot.buckets[i];
+    }
+    snapshot.sum = this->sum_.load(std::memory_order_relaxed);
+    return snapshot;
+}
+
+const QString &DebugHistogram::name() const
+{
+    return this->name_;
+}
+
+int64_t DebugHistogram::Snapshot::percentile(double p) const
+{
+    if (this->count == 0)
+    {
+        return 0;
+    }
+
+    // the rank of the value, counting from 1
+    auto rank = std::max<int64_t>(int64_t(p * double(this->count) + 0.5), 1);
+
+    int64_t seen = 0;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        seen += this->buckets[i];
+        if (seen >= rank)
+        {
+            return upperBoundOf(i);
+        }
+    }
+
+    return upperBoundOf(BUCKETS - 1);
+}
+
+DebugHistogram::Snapshot DebugHistogram::Snapshot::since(
+    const Snapshot &other) const
+{
+    Snapshot difference;
+    for (size_t i = 0; i < BUCKETS; i++)
+    {
+        difference.buckets[i] = this->buckets[i] - other.buckets[i];
+    }
+    difference.count = this->count - other.count;
+    difference.sum = this->sum - other.sum;
+    return difference;
+}
+
 }  // namespace chatterino
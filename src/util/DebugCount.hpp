@@ -2,17 +2,168 @@
 
 #include <common/UniqueAccess.hpp>
 
+#include <array>
+#include <atomic>
+#include <chrono>
 #include <mutex>
 #include <typeinfo>
+#include <vector>
 
 #include <QMap>
 #include <QString>
 
 namespace chatterino {
 
+/**
+ * @brief Counter for hot paths, bumping it doesn't take a lock.
+ *
+ * Updates are spread over a few cache lines by thread, so threads that count
+ * at the same time rarely touch the same atomic. Counters register themselves
+ * with DebugCount and have to stay alive until the program exits, so define
+ * them as statics.
+ */
+class DebugCounter
+{
+public:
+    explicit DebugCounter(QString name);
+
+    DebugCounter(const DebugCounter &) = delete;
+    DebugCounter &operator=(const DebugCounter &) = delete;
+
+    void increase(int64_t amount = 1)
+    {
+        this->slots_[threadSlot()].value.fetch_add(amount,
+                                                   std::memory_order_relaxed);
+    }
+
+    void decrease(int64_t amount = 1)
+    {
+        this->slots_[threadSlot()].value.fetch_sub(amount,
+                                                   std::memory_order_relaxed);
+    }
+
+    int64_t value() const;
+    const QString &name() const;
+
+private:
+    static constexpr size_t SLOTS = 8;
+
+    static size_t threadSlot()
+    {
+        static std::atomic<size_t> next{0};
+        thread_local size_t slot =
+            next.fetch_add(1, std::memory_order_relaxed) % SLOTS;
+        return slot;
+    }
+
+    struct alignas(64) Slot {
+        std::atomic<int64_t> value{0};
+    };
+
+    const QString name_;
+    std::array<Slot, SLOTS> slots_;
+};
+
+/**
+ * @brief Distribution of durations in microseconds, recorded without a lock.
+ *
+ * The buckets are log-linear like the ones of HdrHistogram: every power of
+ * two is split into 8 buckets, so percentiles are within 12.5% of the
+ * recorded values. Durations above half an hour land in the last bucket.
+ *
+ * Registers itself like DebugCounter and has to outlive its users as well.
+ */
+class DebugHistogram
+{
+public:
+    static constexpr size_t BUCKETS = 30 * 8;
+
+    struct Snapshot {
+        int64_t count = 0;
+        // of the recorded values, in microseconds
+        int64_t sum = 0;
+        std::array<int64_t, BUCKETS> buckets{};
+
+        /// Upper bound of the bucket that holds the percentile, 0 <= p <= 1
+        int64_t percentile(double p) const;
+        /// What was recorded between other and this
+        Snapshot since(const Snapshot &other) const;
+    };
+
+    /// Records the time from its start, its creation by default, until it's
+    /// destroyed
+    class Timer
+    {
+    public:
+        explicit Timer(DebugHistogram &histogram,
+                       std::chrono::steady_clock::time_point start =
+                           std::chrono::steady_clock::now())
+            : histogram_(histogram)
+            , start_(start)
+        {
+        }
+
+        ~Timer()
+        {
+            this->histogram_.record(
+                std::chrono::steady_clock::now() - this->start_);
+        }
+
+        Timer(const Timer &) = delete;
+        Timer &operator=(const Timer &) = delete;
+
+    private:
+        DebugHistogram &histogram_;
+        std::chrono::steady_clock::time_point start_;
+    };
+
+    explicit DebugHistogram(QString name);
+
+    DebugHistogram(const DebugHistogram &) = delete;
+    DebugHistogram &operator=(const DebugHistogram &) = delete;
+
+    void record(int64_t microseconds)
+    {
+        this->buckets_[bucketOf(microseconds)].fetch_add(
+            1, std::memory_order_relaxed);
+        this->sum_.fetch_add(microseconds, std::memory_order_relaxed);
+    }
+
+    template <typename Rep, typename Period>
+    void record(std::chrono::duration<Rep, Period> duration)
+    {
+        this->record(int64_t(
+            std::chrono::duration_cast<std::chrono::microseconds>(duration)
+                .count()));
+    }
+
+    Snapshot snapshot() const;
+    const QString &name() const;
+
+    static size_t bucketOf(int64_t microseconds);
+    static int64_t upperBoundOf(size_t bucket);
+
+private:
+    const QString name_;
+    std::array<std::atomic<int64_t>, BUCKETS> buckets_{};
+    std::atomic<int64_t> sum_{0};
+};
+
+/**
+ * @brief Counts of objects and events, shown in the DebugPopup.
+ *
+ * The functions taking a name look it up in a map behind a mutex, which is
+ * fine for rare events and names that are only known at runtime. Hot paths
+ * use a static DebugCounter instead.
+ */
 class DebugCount
 {
 public:
+    struct Value {
+        QString name;
+        int64_t value;
+    };
+
     static void increase(const QString &name)
     {
         auto counts = counts_.access();
@@ -71,24 +222,32 @@ public:
         }
     }
 
+    /// Values of the named counts and the DebugCounters, sorted by name
+    static std::vector<Value> values();
+    static std::vector<const DebugHistogram *> histograms();
+
     static QString getDebugText()
     {
-        auto counts = counts_.access();
-
         QString text;
-        for (auto it = counts->begin(); it != counts->end(); it++)
+        for (const auto &value : values())
         {
-            text += it.key() + ": " + QString::number(it.value()) + "\n";
+            text += value.name + ": " + QString::number(value.value) + "\n";
         }
         return text;
     }
 
-    QString toString()
-    {
-        return "";
-    }
-
 private:
+    friend class DebugCounter;
+    friend class DebugHistogram;
+
+    struct Registry {
+        std::mutex mutex;
+        std::vector<const DebugCounter *> counters;
+        std::vector<const DebugHistogram *> histograms;
+    };
+
+    static Registry &registry();
+
     static UniqueAccess<QMap<QString, int64_t>> counts_;
 };
 
@@ -0,0 +1,169 @@
+#include "util/FrameScheduler.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+
+#include <QGuiApplication>
+#include <QScreen>
+
+#include <algorithm>
+
+namespace chatterino {
+namespace {
+    // time a frame may spend on background work, including what layouts and
+    // paints took
+    constexpr qint64 BUDGET_NS = 4'000'000;
+}  // namespace
+
+FrameScheduler &FrameScheduler::instance()
+{
+    static FrameScheduler instance;
+    return instance;
+}
+
+FrameScheduler::FrameScheduler()
+{
+    this->timer_.setSingleShot(true);
+    this->timer_.setTimerType(Qt::PreciseTimer);
+    QObject::connect(&this->timer_, &QTimer::timeout, [this] {
+        this->runFrame();
+    });
+    this->clock_.start();
+}
+
+void FrameScheduler::request(QObject *owner, FrameStage stage,
+                             std::function<void()> task)
+{
+    assertInGuiThread();
+
+    auto &requests = this->stages_[size_t(stage)];
+    auto it = requests.lookup.find(owner);
+    if (it != requests.lookup.end())
+    {
+        auto &request = requests.requests[it->second];
+        request.owner = owner;
+        request.task = std::move(task);
+        return;
+    }
+
+    requests.lookup.emplace(owner, requests.requests.size());
+    requests.requests.push_back({owner, owner, std::move(task)});
+    this->schedule();
+}
+
+void FrameScheduler::requestBackground(QObject *owner,
+                                       std::function<bool()> task)
+{
+    assertInGuiThread();
+
+    auto it = std::find_if(this->background_.begin(), this->background_.end(),
+                           [owner](const auto &request) {
+                               return request.key == owner;
+                           });
+    if (it != this->background_.end())
+    {
+        it->owner = owner;
+        it->task = std::move(task);
+        return;
+    }
+
+    this->background_.push_back({owner, owner, std::move(task)});
+    this->schedule();
+}
+
+void FrameScheduler::cancelBackground(QObject *owner)
+{
+    this->background_.erase(
+        std::remove_if(this->background_.begin(), this->background_.end(),
+                       [owner](const auto &request) {
+                           return request.key == owner;
+                       }),
+        this->background_.end());
+}
+
+bool FrameScheduler::hasTimeLeft() const
+{
+    return !this->running_ || this->frame_.nsecsElapsed() < BUDGET_NS;
+}
+
+int FrameScheduler::frameInterval() const
+{
+    auto *screen = QGuiApplication::primaryScreen();
+    if (screen == nullptr || screen->refreshRate() <= 1)
+    {
+        return 16;
+    }
+    return std::max(1, int(1000 / screen->refreshRate()));
+}
+
+void FrameScheduler::schedule()
+{
+    if (this->timer_.isActive() || this->running_)
+    {
+        return;
+    }
+
+    auto interval = qint64(this->frameInterval());
+    this->timer_.start(int(interval - this->clock_.elapsed() % interval));
+}
+
+void FrameScheduler::runFrame()
+{
+    this->running_ = true;
+    this->frame_.start();
+
+    // tasks may request more work, layouts in particular request paints,
+    // those requested for a later stage still run in this frame
+    for (auto &stage : this->stages_)
+    {
+        auto requests = std::move(stage.requests);
+        stage.requests.clear();
+        stage.lookup.clear();
+
+        for (auto &request : requests)
+        {
+            if (request.owner)
+            {
+                request.task();
+            }
+        }
+    }
+
+    // what's left of a task goes behind the ones that didn't run yet
+    auto count = this->background_.size();
+    for (size_t i = 0; i < count && !this->background_.empty() &&
+                       this->hasTimeLeft();
+         i++)
+    {
+        auto request = std::move(this->background_.front());
+        this->background_.pop_front();
+        if (!request.owner || !request.task())
+        {
+            continue;
+        }
+
+        // the task may have requested itself again while it ran
+        auto requeued = std::any_of(this->background_.begin(),
+                                    this->background_.end(),
+                                    [&](const auto &other) {
+                                        return other.key == request.key;
+                                    });
+        if (!requeued)
+        {
+            this->background_.push_back(std::move(request));
+        }
+    }
+
+    this->running_ = false;
+
+    bool pending = !this->background_.empty();
+    for (auto &stage : this->stages_)
+    {
+        pending = pending || !stage.requests.empty();
+    }
+    if (pending)
+    {
+        this->schedule();
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QTimer>
+#include <boost/noncopyable.hpp>
+
+#include <array>
+#include <deque>
+#include <functional>
+#include <unordered_map>
+#include <vector>
+
+namespace chatterino {
+
+enum class FrameStage {
+    /// Coalesced input, e.g. mouse moves, runs before the layouts it causes
+    Input,
+    /// Runs before the paints, so they see the new layouts of the same frame
+    Layout,
+    Paint,
+};
+
+/**
+ * @brief Runs the layout and paint work of the chat widgets once per frame.
+ *
+ * Requests are collected until the next frame, at the refresh rate of the
+ * primary screen. Repeated requests of the same widget and stage are merged,
+ * only the latest task runs. A frame runs all input tasks, then all layout
+ * tasks, then all paint tasks, then background tasks for as long as the
+ * frame's budget allows. Background tasks that didn't finish continue in the
+ * next frame, the ones that got no time go first then. Tasks of deleted
+ * widgets are dropped.
+ *
+ * Must only be used from the GUI thread.
+ */
+class FrameScheduler : boost::noncopyable
+{
+public:
+    static FrameScheduler &instance();
+
+    void request(QObject *owner, FrameStage stage, std::function<void()> task);
+
+    /// task returns true if it has work left and should run again in the
+    /// next frame. It should check hasTimeLeft between its steps.
+    void requestBackground(QObject *owner, std::function<bool()> task);
+    void cancelBackground(QObject *owner);
+
+    /// Whether the frame that's currently being run is within its budget
+    bool hasTimeLeft() const;
+
+    /// Milliseconds between two frames
+    int frameInterval() const;
+
+private:
+    FrameScheduler();
+
+    template <typename T>
+    struct Request {
+        QPointer<QObject> owner;
+        // the address, QPointer forgets it once the owner is deleted
+        QObject *key;
+        std::function<T> task;
+    };
+
+    struct Stage {
+        std::vector<Request<void()>> requests;
+        std::unordered_map<QObject *, size_t> lookup;
+    };
+
+    void schedule();
+    void runFrame();
+
+    std::array<Stage, 3> stages_;
+    std::deque<Request<bool()>> background_;
+
+    QTimer timer_;
+    // frames are aligned to multiples of the interval since it started
+    QElapsedTimer clock_;
+    QElapsedTimer frame_;
+    bool running_ = false;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,158 @@
+#include "util/GuiTaskQueue.hpp"
+
+#include "debug/EventLoopWatchdog.hpp"
+#include "util/DebugCount.hpp"
+
+#include <QCoreApplication>
+#include <QElapsedTimer>
+#include <QEvent>
+
+namespace chatterino {
+
+namespace {
+
+    // long enough to get through bursts of small tasks at once, short enough
+    // to not delay input noticeably
+    constexpr qint64 TIME_SLICE_MS = 8;
+
+    DebugCounter queuedTasks("gui tasks queued");
+    DebugCounter drainSlices("gui task slices");
+
+    QEvent::Type drainEventType()
+    {
+        static auto type = QEvent::Type(QEvent::registerEventType());
+        return type;
+    }
+
+}  // namespace
+
+GuiTaskQueue &GuiTaskQueue::instance()
+{
+    // never deleted, tasks can be pushed until the process exits
+    static auto *instance = new GuiTaskQueue;
+    return *instance;
+}
+
+GuiTaskQueue::GuiTaskQueue()
+{
+    // the first task might be pushed from any thread
+    if (auto *app = QCoreApplication::instance())
+    {
+        this->moveToThread(app->thread());
+    }
+}
+
+void GuiTaskQueue::Queue::push(Task *task)
+{
+    task->next.store(nullptr, std::memory_order_relaxed);
+    auto *previous = this->head_.exchange(task, std::memory_order_acq_rel);
+    previous->next.store(task, std::memory_order_release);
+}
+
+GuiTaskQueue::Task *GuiTaskQueue::Queue::pop()
+{
+    auto *tail = this->tail_;
+    auto *next = tail->next.load(std::memory_order_acquire);
+
+    if (tail == &this->stub_)
+    {
+        if (next == nullptr)
+        {
+            return nullptr;
+        }
+        this->tail_ = next;
+        tail = next;
+        next = next->next.load(std::memory_order_acquire);
+    }
+
+    if (next != nullptr)
+    {
+        this->tail_ = next;
+        return tail;
+    }
+
+    if (tail != this->head_.load(std::memory_order_acquire))
+    {
+        return nullptr;
+    }
+
+    // tail is the last task, the stub takes its place so it can be taken
+    this->push(&this->stub_);
+
+    next = tail->next.load(std::memory_order_acquire);
+    if (next != nullptr)
+    {
+        this->tail_ = next;
+        return tail;
+    }
+
+    return nullptr;
+}
+
+void GuiTaskQueue::push(Task *task, TaskPriority priority)
+{
+    queuedTasks.increase();
+    this->queues_[size_t(priority)].push(task);
+    this->schedule();
+}
+
+void GuiTaskQueue::schedule()
+{
+    if (!this->scheduled_.exchange(true, std::memory_order_acq_rel))
+    {
+        QCoreApplication::postEvent(this, new QEvent(drainEventType()));
+    }
+}
+
+void GuiTaskQueue::customEvent(QEvent *event)
+{
+    if (event->type() == drainEventType())
+    {
+        this->drain();
+    }
+}
+
+void GuiTaskQueue::drain()
+{
+    // tasks pushed from now on post the event again
+    this->scheduled_.exchange(false, std::memory_order_acq_rel);
+    drainSlices.increase();
+
+    QElapsedTimer timer;
+    timer.start();
+
+    while (true)
+    {
+        Task *task = nullptr;
+        for (auto &queue : this->queues_)
+        {
+            task = queue.pop();
+            if (task != nullptr)
+            {
+                break;
+            }
+        }
+
+        if (task == nullptr)
+        {
+            return;
+        }
+
+        {
+            EventLoopWatchdog::CallbackScope scope(task->file, task->line);
+            task->run();
+        }
+        delete task;
+        queuedTasks.decrease();
+
+        if (timer.elapsed() >= TIME_SLICE_MS)
+        {
+            // the rest is run once the events that arrived in the meantime
+            // were handled
+            this->schedule();
+            return;
+        }
+    }
+}
+
+}  // namespace chatterino
@@ -0,0 +1,106 @@
+#pragma once
+
+#include <QObject>
+
+#include <array>
+#include <atomic>
+#include <type_traits>
+#include <utility>
+
+namespace chatterino {
+
+enum class TaskPriority {
+    /// Results the user is waiting for
+    High,
+    Normal,
+    /// Results that only have to arrive eventually, like decoded images
+    Low,
+};
+
+/**
+ * @brief Functions posted to the gui thread, see postToThread.
+ *
+ * Any thread can push tasks without taking a lock. The gui thread runs them
+ * from a single posted event, higher priorities first and tasks of the same
+ * priority in the order they were pushed. It stops after a time slice and
+ * posts the event again for the rest, so a flood of tasks can't keep input
+ * and paint events from being handled.
+ */
+class GuiTaskQueue : public QObject
+{
+public:
+    static GuiTaskQueue &instance();
+
+    template <typename F>
+    void push(F &&fun, TaskPriority priority, const char *file, int line)
+    {
+        auto *task = new FunctionTask<typename std::decay<F>::type>(
+            std::forward<F>(fun));
+        task->file = file;
+        task->line = line;
+        this->push(task, priority);
+    }
+
+protected:
+    void customEvent(QEvent *event) override;
+
+private:
+    // a node of the intrusive queue, the stub of the queue is a plain Task
+    struct Task {
+        virtual ~Task() = default;
+        virtual void run()
+        {
+        }
+
+        std::atomic<Task *> next{nullptr};
+        const char *file{};
+        int line{};
+    };
+
+    template <typename F>
+    struct FunctionTask : Task {
+        explicit FunctionTask(F &&fun)
+            : fun(std::move(fun))
+        {
+        }
+        explicit FunctionTask(const F &fun)
+            : fun(fun)
+        {
+        }
+
+        void run() override
+        {
+            this->fun();
+        }
+
+        F fun;
+    };
+
+    // Multiple producer, single consumer queue by Dmitry Vyukov. Producers
+    // only swap the head, the consumer owns the tail.
+    class Queue
+    {
+    public:
+        void push(Task *task);
+        // nullptr if it's empty or a producer is in the middle of pushing,
+        // that producer posts the drain event afterwards
+        Task *pop();
+
+    private:
+        Task stub_;
+        std::atomic<Task *> head_{&stub_};
+        Task *tail_{&stub_};
+    };
+
+    GuiTaskQueue();
+
+    void push(Task *task, TaskPriority priority);
+    void schedule();
+    void drain();
+
+    std::array<Queue, 3> queues_;
+    // true while a drain event is posted and hasn't started running
+    std::atomic<bool> scheduled_{false};
+};
+
+}  // namespace chatterino
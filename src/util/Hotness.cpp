@@ -0,0 +1,127 @@
+#include "util/Hotness.hpp"
+
+#include <QHash>
+
+#include <algorithm>
+#include <limits>
+
+namespace chatterino {
+
+namespace {
+
+    constexpr uint32_t countOf(uint64_t counter, uint32_t period)
+    {
+        auto elapsed = period - uint32_t(counter >> 32);
+        if (elapsed >= 32)
+        {
+            return 0;
+        }
+        return uint32_t(counter) >> elapsed;
+    }
+
+    static_assert(Hotness::WIDTH > 0 &&
+                      (Hotness::WIDTH & (Hotness::WIDTH - 1)) == 0 &&
+                      Hotness::WIDTH <= (1 << 16),
+                  "the rows are indexed with 16 bits of the hash");
+    static_assert(Hotness::DEPTH <= 4, "a 64 bit hash has 4 rows of bits");
+
+}  // namespace
+
+Hotness::Hotness()
+    : start_(Clock::now())
+{
+    for (auto &counter : this->counters_)
+    {
+        counter.store(0, std::memory_order_relaxed);
+    }
+}
+
+Hotness &Hotness::emotes()
+{
+    static Hotness instance;
+    return instance;
+}
+
+Hotness &Hotness::images()
+{
+    static Hotness instance;
+    return instance;
+}
+
+Hotness &Hotness::chatters()
+{
+    static Hotness instance;
+    return instance;
+}
+
+void Hotness::hit(const QString &key)
+{
+    this->hit(key, Clock::now());
+}
+
+void Hotness::hit(const QString &key, Clock::time_point now)
+{
+    auto period = this->period(now);
+
+    for (auto slot : this->slots(key))
+    {
+        auto &counter = this->counters_[slot];
+
+        auto current = counter.load(std::memory_order_relaxed);
+        uint64_t next = 0;
+        do
+        {
+            auto count = countOf(current, period);
+            if (count < std::numeric_limits<uint32_t>::max())
+            {
+                count++;
+            }
+            next = (uint64_t(period) << 32) | count;
+        } while (!counter.compare_exchange_weak(current, next,
+                                                std::memory_order_relaxed));
+    }
+}
+
+uint32_t Hotness::score(const QString &key) const
+{
+    return this->score(key, Clock::now());
+}
+
+uint32_t Hotness::score(const QString &key, Clock::time_point now) const
+{
+    auto period = this->period(now);
+
+    auto score = std::numeric_limits<uint32_t>::max();
+    for (auto slot : this->slots(key))
+    {
+        const auto &counter = this->counters_[slot];
+        score = std::min(
+            score, countOf(counter.load(std::memory_order_relaxed), period));
+    }
+    return score;
+}
+
+uint32_t Hotness::period(Clock::time_point now) const
+{
+    if (now < this->start_)
+    {
+        return 0;
+    }
+    return uint32_t((now - this->start_) / HALF_LIFE);
+}
+
+std::array<size_t, Hotness::DEPTH> Hotness::slots(const QString &key) const
+{
+    // every row takes other bits of the mixed hash
+    auto mixed = uint64_t(qHash(key)) * 0x9e3779b97f4a7c15ULL;
+
+    std::array<size_t, DEPTH> slots{};
+    for (size_t row = 0; row < DEPTH; row++)
+    {
+        auto index = size_t(mixed >> (64 - 16 * (row + 1))) & (WIDTH - 1);
+        slots[row] = row * WIDTH + index;
+    }
+    return slots;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+
+namespace chatterino {
+
+/**
+ * @brief How often keys were seen lately, shared by the caches and
+ *        completions that rank by it.
+ *
+ * The counts are a count-min sketch: a hit increments one counter per row
+ * picked by the hash of the key and the score is the smallest of them, so
+ * keys sharing counters can only be overestimated. Counters halve every
+ * HALF_LIFE, each one keeps the period it was last decayed in next to its
+ * count, so nothing has to sweep the table. Fixed size, no matter how many
+ * keys are seen.
+ *
+ * Thread safe, counters are updated with relaxed atomics.
+ */
+class Hotness : boost::noncopyable
+{
+public:
+    using Clock = std::chrono::steady_clock;
+
+    // counters per row, a power of two
+    static constexpr size_t WIDTH = 2048;
+    static constexpr size_t DEPTH = 2;
+    static constexpr std::chrono::seconds HALF_LIFE{300};
+
+    Hotness();
+
+    /// Emote names in messages
+    static Hotness &emotes();
+    /// Urls of images that are painted, once a second at most
+    static Hotness &images();
+    /// Lower case logins of users that send messages
+    static Hotness &chatters();
+
+    void hit(const QString &key);
+    void hit(const QString &key, Clock::time_point now);
+
+    /// About the hits of the key, halved for every HALF_LIFE since
+    uint32_t score(const QString &key) const;
+    uint32_t score(const QString &key, Clock::time_point now) const;
+
+private:
+    uint32_t period(Clock::time_point now) const;
+    std::array<size_t, DEPTH> slots(const QString &key) const;
+
+    const Clock::time_point start_;
+    // the period in the upper 32 bits, the count in the lower ones
+    std::array<std::atomic<uint64_t>, WIDTH * DEPTH> counters_;
+};
+
+}  // namespace chatterino
@@ -7,59 +7,70 @@ namespace chatterino {
 
 inline QString parseTagString(const QString &input)
 {
-    QString output = input;
-    output.detach();
+    // most values don't contain any escapes and are returned without a copy
+    auto escape = input.indexOf('\\');
+    if (escape == -1)
+    {
+        return input;
+    }
+
+    QString output;
+    output.reserve(input.length());
+    output.append(input.constData(), escape);
 
-    auto length = output.length();
+    auto length = input.length();
 
-    for (int i = 0; i < length - 1; i++)
+    for (int i = escape; i < length; i++)
     {
-        if (output[i] == '\\')
+        QChar c = input[i];
+
+        // a trailing backslash is kept
+        if (c != '\\' || i == length - 1)
         {
-            QChar c = output[i + 1];
-
-            switch (c.cell())
-            {
-                case 'n': {
-                    output.replace(i, 2, '\n');
-                }
-                break;
-
-                case 'r': {
-                    output.replace(i, 2, '\r');
-                }
-                break;
-
-                case 's': {
-                    output.replace(i, 2, ' ');
-                }
-                break;
-
-                case '\\': {
-                    output.replace(i, 2, '\\');
-                }
-                break;
-
-                case ':': {
-                    output.replace(i, 2, ';');
-                }
-                break;
-
-                default: {
-                    output.remove(i, 1);
-                }
-                break;
+            output.append(c);
+            continue;
+        }
+
+        QChar next = input[++i];
+
+        switch (next.unicode())
+        {
+            case 'n': {
+                output.append('\n');
+            }
+            break;
+
+            case 'r': {
+                output.append('\r');
+            }
+            break;
+
+            case 's': {
+                output.append(' ');
+            }
+            break;
+
+            case '\\': {
+                output.append('\\');
             }
+            break;
 
-            i++;
-            length--;
+            case ':': {
+                output.append(';');
+            }
+            break;
+
+            default: {
+                output.append(next);
+            }
+            break;
         }
     }
 
     return output;
 }
 
-inline QTime calculateMessageTimestamp(const Communi::IrcMessage *message)
+inline QDateTime calculateMessageTime(const Communi::IrcMessage *message)
 {
     // Check if message is from recent-messages API
     if (message->tags().contains("historical"))
@@ -72,14 +83,14 @@ inline QTime calculateMessageTimestamp(const Communi::IrcMessage *message)
             ts = message->tags().value("tmi-sent-ts").toLongLong();
         }
 
-        return QDateTime::fromMSecsSinceEpoch(ts).time();
+        return QDateTime::fromMSecsSinceEpoch(ts);
     }
 
     // If present, handle tmi-sent-ts tag and use it as timestamp
     if (message->tags().contains("tmi-sent-ts"))
     {
         auto ts = message->tags().value("tmi-sent-ts").toLongLong();
-        return QDateTime::fromMSecsSinceEpoch(ts).time();
+        return QDateTime::fromMSecsSinceEpoch(ts);
     }
 
     // Some IRC Servers might have server-time tag containing UTC date in ISO format, use it as timestamp
@@ -90,11 +101,16 @@ inline QTime calculateMessageTimestamp(const Communi::IrcMessage *message)
 
         auto date = QDateTime::fromString(timedate, Qt::ISODate);
         date.setTimeSpec(Qt::TimeSpec::UTC);
-        return date.toLocalTime().time();
+        return date.toLocalTime();
     }
 
     // Fallback to current time
-    return QTime::currentTime();
+    return QDateTime::currentDateTime();
+}
+
+inline QTime calculateMessageTimestamp(const Communi::IrcMessage *message)
+{
+    return calculateMessageTime(message).time();
 }
 
 }  // namespace chatterino
@@ -0,0 +1,94 @@
+#include "util/JsonDocument.hpp"
+
+#include "common/QLogging.hpp"
+
+#include <rapidjson/error/en.h>
+
+namespace chatterino {
+
+JsonDocument::JsonDocument(QByteArray data)
+    : buffer_(std::move(data))
+{
+    // data() detaches, the document modifies its own copy
+    this->document_.ParseInsitu(this->buffer_.data());
+
+    if (this->document_.HasParseError())
+    {
+        qCWarning(chatterinoCommon)
+            << "JSON parse error:"
+            << rapidjson::GetParseError_En(this->document_.GetParseError())
+            << "(" << this->document_.GetErrorOffset() << ")";
+        this->document_.SetNull();
+        return;
+    }
+
+    this->valid_ = true;
+}
+
+bool JsonDocument::isValid() const
+{
+    return this->valid_;
+}
+
+const rapidjson::Value &JsonDocument::root() const
+{
+    return this->document_;
+}
+
+namespace rj {
+
+    const rapidjson::Value *member(const rapidjson::Value &value,
+                                   const char *key)
+    {
+        if (!value.IsObject())
+        {
+            return nullptr;
+        }
+
+        auto it = value.FindMember(key);
+        return it == value.MemberEnd() ? nullptr : &it->value;
+    }
+
+    QString string(const rapidjson::Value &value, const char *key)
+    {
+        auto *found = member(value, key);
+        return found ? toString(*found) : QString();
+    }
+
+    QLatin1String latin1(const rapidjson::Value &value, const char *key)
+    {
+        auto *found = member(value, key);
+        if (found == nullptr || !found->IsString())
+        {
+            return QLatin1String();
+        }
+
+        return QLatin1String(found->GetString(),
+                             int(found->GetStringLength()));
+    }
+
+    int integer(const rapidjson::Value &value, const char *key)
+    {
+        auto *found = member(value, key);
+        return found && found->IsInt() ? found->GetInt() : 0;
+    }
+
+    bool boolean(const rapidjson::Value &value, const char *key)
+    {
+        auto *found = member(value, key);
+        return found && found->IsBool() && found->GetBool();
+    }
+
+    QString toString(const rapidjson::Value &value)
+    {
+        if (!value.IsString())
+        {
+            return QString();
+        }
+
+        return QString::fromUtf8(value.GetString(),
+                                 int(value.GetStringLength()));
+    }
+
+}  // namespace rj
+}  // namespace chatterino
@@ -0,0 +1,52 @@
+#pragma once
+
+#include <rapidjson/document.h>
+#include <QByteArray>
+#include <QLatin1String>
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+namespace chatterino {
+
+/**
+ * @brief A json document parsed in situ from a copy of the data.
+ *
+ * The strings of the document point into the copy, so parsing only allocates
+ * the values and reading a string only allocates the QString it's turned
+ * into. Prefer this to QJsonDocument for large responses.
+ */
+class JsonDocument : boost::noncopyable
+{
+public:
+    explicit JsonDocument(QByteArray data);
+
+    /// False if the data wasn't valid json, the root is null then
+    bool isValid() const;
+    const rapidjson::Value &root() const;
+
+private:
+    QByteArray buffer_;
+    rapidjson::Document document_;
+    bool valid_ = false;
+};
+
+namespace rj {
+
+    /// Returns the member of the object, nullptr if value isn't an object or
+    /// doesn't have the member
+    const rapidjson::Value *member(const rapidjson::Value &value,
+                                   const char *key);
+
+    /// Members that are missing or of another type are returned as the
+    /// default value
+    QString string(const rapidjson::Value &value, const char *key);
+    /// For ascii values like ids. Only valid while the document exists,
+    /// doesn't allocate
+    QLatin1String latin1(const rapidjson::Value &value, const char *key);
+    int integer(const rapidjson::Value &value, const char *key);
+    bool boolean(const rapidjson::Value &value, const char *key);
+
+    QString toString(const rapidjson::Value &value);
+
+}  // namespace rj
+}  // namespace chatterino
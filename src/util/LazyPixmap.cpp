@@ -0,0 +1,24 @@
+#include "util/LazyPixmap.hpp"
+
+namespace chatterino {
+
+LazyPixmap::LazyPixmap(const char *path)
+    : path_(path)
+{
+}
+
+const QPixmap &LazyPixmap::get() const
+{
+    std::call_once(this->loaded_, [this] {
+        this->pixmap_ = QPixmap(this->path_);
+    });
+
+    return this->pixmap_;
+}
+
+LazyPixmap::operator const QPixmap &() const
+{
+    return this->get();
+}
+
+}  // namespace chatterino
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <QPixmap>
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+
+namespace chatterino {
+
+/**
+ * @brief A pixmap of the resources that's only decoded when it's first used.
+ *
+ * Converts to the pixmap, so it can be used like one. Like every QPixmap it
+ * should be used from the GUI thread first.
+ */
+class LazyPixmap : boost::noncopyable
+{
+public:
+    explicit LazyPixmap(const char *path);
+
+    const QPixmap &get() const;
+    operator const QPixmap &() const;
+
+private:
+    const char *path_;
+
+    mutable std::once_flag loaded_;
+    mutable QPixmap pixmap_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,160 @@
+#include "util/MemoryUsage.hpp"
+
+#include "Application.hpp"
+#include "common/ChannelChatters.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "messages/Emote.hpp"
+#include "messages/Message.hpp"
+#include "providers/twitch/TwitchChannel.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+#include "util/DebugCount.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    DebugCounter messageBytes("bytes: messages");
+    DebugCounter layoutBufferBytes("bytes: message drawing buffers");
+    DebugCounter imageBytes("bytes: image frames");
+    DebugCounter emoteMapBytes("bytes: emote maps");
+    DebugCounter chatterBytes("bytes: chatter lists");
+
+    DebugCounter &counter(MemoryCategory category)
+    {
+        switch (category)
+        {
+            case MemoryCategory::Messages:
+                return messageBytes;
+            case MemoryCategory::LayoutBuffers:
+                return layoutBufferBytes;
+            case MemoryCategory::Images:
+                return imageBytes;
+            case MemoryCategory::EmoteMaps:
+                return emoteMapBytes;
+            case MemoryCategory::Chatters:
+                return chatterBytes;
+        }
+        return messageBytes;
+    }
+
+    const std::vector<MemoryCategory> categories{
+        MemoryCategory::Messages,  MemoryCategory::LayoutBuffers,
+        MemoryCategory::Images,    MemoryCategory::EmoteMaps,
+        MemoryCategory::Chatters,
+    };
+
+}  // namespace
+
+void MemoryUsage::increase(MemoryCategory category, int64_t bytes)
+{
+    counter(category).increase(bytes);
+}
+
+void MemoryUsage::decrease(MemoryCategory category, int64_t bytes)
+{
+    counter(category).decrease(bytes);
+}
+
+int64_t MemoryUsage::bytes(MemoryCategory category)
+{
+    return counter(category).value();
+}
+
+QString MemoryUsage::name(MemoryCategory category)
+{
+    // drops the "bytes: " prefix
+    return counter(category).name().mid(7);
+}
+
+std::vector<MemoryUsage::ChannelUsage> MemoryUsage::channels()
+{
+    assertInGuiThread();
+
+    std::vector<ChannelUsage> channels;
+
+    getApp()->twitch->forEachChannelAndSpecialChannels(
+        [&](ChannelPtr channel) {
+            ChannelUsage usage;
+            usage.name = channel->getName();
+
+            auto snapshot = channel->getMessageSnapshot();
+            usage.messages = int64_t(snapshot.size());
+            usage.messageLimit = int64_t(channel->getMessageLimit());
+            for (const auto &message : snapshot)
+            {
+                usage.messageBytes += message->bytes();
+            }
+
+            if (auto *chatters = dynamic_cast<ChannelChatters *>(channel.get()))
+            {
+                usage.chatterBytes = chatters->accessChatters()->bytes();
+            }
+
+            if (auto *twitch = dynamic_cast<TwitchChannel *>(channel.get()))
+            {
+                usage.emoteBytes = twitch->bttvEmotes()->bytes() +
+                                   twitch->ffzEmotes()->bytes();
+            }
+
+            channels.push_back(std::move(usage));
+        });
+
+    std::sort(channels.begin(), channels.end(),
+              [](const auto &a, const auto &b) {
+                  return a.total() > b.total();
+              });
+    return channels;
+}
+
+QStringList MemoryUsage::snapshot(size_t maxChannels)
+{
+    QStringList lines;
+
+    int64_t total = 0;
+    QStringList categoryTotals;
+    for (auto category : categories)
+    {
+        total += bytes(category);
+        categoryTotals.append(
+            QString("%1 %2").arg(name(category), formatBytes(bytes(category))));
+    }
+    lines.append(QString("Memory: %1 (%2)")
+                     .arg(formatBytes(total), categoryTotals.join(", ")));
+
+    auto channels = MemoryUsage::channels();
+    for (size_t i = 0; i < std::min(channels.size(), maxChannels); i++)
+    {
+        const auto &channel = channels[i];
+        lines.append(QString("%1: %2/%3 messages %4, chatters %5, emotes %6")
+                         .arg(channel.name)
+                         .arg(channel.messages)
+                         .arg(channel.messageLimit)
+                         .arg(formatBytes(channel.messageBytes),
+                              formatBytes(channel.chatterBytes),
+                              formatBytes(channel.emoteBytes)));
+    }
+    if (channels.size() > maxChannels)
+    {
+        lines.append(QString("and %1 smaller channels")
+                         .arg(channels.size() - maxChannels));
+    }
+
+    return lines;
+}
+
+QString MemoryUsage::formatBytes(int64_t bytes)
+{
+    if (bytes < 1024)
+    {
+        return QString("%1 B").arg(bytes);
+    }
+    if (bytes < 1024 * 1024)
+    {
+        return QString("%1 KiB").arg(bytes / 1024.0, 0, 'f', 1);
+    }
+    return QString("%1 MiB").arg(bytes / (1024.0 * 1024.0), 0, 'f', 1);
+}
+
+}  // namespace chatterino
@@ -0,0 +1,61 @@
+#pragma once
+
+#include <QString>
+#include <QStringList>
+
+#include <cstdint>
+#include <vector>
+
+namespace chatterino {
+
+enum class MemoryCategory {
+    Messages,
+    LayoutBuffers,
+    Images,
+    EmoteMaps,
+    Chatters,
+};
+
+/**
+ * @brief Estimates of the memory used by the larger subsystems.
+ *
+ * The owners of the memory report what they allocate and free, the totals
+ * are DebugCounters named "bytes: <category>", so they show up in the
+ * DebugPopup and the metrics as well. The numbers are estimates of the
+ * payload, allocator overhead isn't included.
+ */
+class MemoryUsage
+{
+public:
+    struct ChannelUsage {
+        QString name;
+        int64_t messages = 0;
+        int64_t messageLimit = 0;
+        int64_t messageBytes = 0;
+        int64_t chatterBytes = 0;
+        int64_t emoteBytes = 0;
+
+        int64_t total() const
+        {
+            return this->messageBytes + this->chatterBytes + this->emoteBytes;
+        }
+    };
+
+    static void increase(MemoryCategory category, int64_t bytes);
+    static void decrease(MemoryCategory category, int64_t bytes);
+    static int64_t bytes(MemoryCategory category);
+    static QString name(MemoryCategory category);
+
+    /// What the open channels hold, the largest first. Messages that are in
+    /// several channels, like mentions, count for each of them. Walks all
+    /// messages, so this is for debugging only. Has to be called from the
+    /// gui thread.
+    static std::vector<ChannelUsage> channels();
+
+    /// Lines with the totals and the largest channels
+    static QStringList snapshot(size_t maxChannels);
+
+    static QString formatBytes(int64_t bytes);
+};
+
+}  // namespace chatterino
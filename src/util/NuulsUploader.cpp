@@ -6,18 +6,27 @@
 #include "singletons/Paths.hpp"
 #include "singletons/Settings.hpp"
 #include "util/CombinePath.hpp"
+#include "util/PostToThread.hpp"
 
 #include <QBuffer>
 #include <QHttpMultiPart>
 #include <QJsonArray>
 #include <QJsonDocument>
 #include <QMimeDatabase>
-#include <QMutex>
-#include <QSaveFile>
+#include <QNetworkReply>
 #include "common/QLogging.hpp"
 
+#include <algorithm>
+#include <deque>
+
 #define UPLOAD_DELAY 2000
 // Delay between uploads in milliseconds
+#define MAX_PARALLEL_UPLOADS 2
+// How many uploads run at the same time
+#define PROGRESS_MIN_SIZE (1024 * 1024)
+// Uploads smaller than this in bytes don't report their progress
+#define LOG_TAIL_SIZE 256
+// How many bytes at the end of the log are searched for its closing bracket
 
 namespace {
 
@@ -39,9 +48,41 @@ boost::optional<QByteArray> convertToPng(QImage image)
 }  // namespace
 
 namespace chatterino {
+struct PendingUpload {
+    RawImageData imageData;
+    ChannelPtr channel;
+    ResizingTextEdit *textEdit;
+};
+
 // These variables are only used from the main thread.
-static auto uploadMutex = QMutex();
-static std::queue<RawImageData> uploadQueue;
+static std::deque<PendingUpload> uploadQueue;
+static int activeUploads = 0;
+
+void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
+                        ResizingTextEdit &textEdit);
+
+// starts queued uploads until MAX_PARALLEL_UPLOADS are running
+void startUploads()
+{
+    while (activeUploads < MAX_PARALLEL_UPLOADS && !uploadQueue.empty())
+    {
+        auto next = std::move(uploadQueue.front());
+        uploadQueue.pop_front();
+        activeUploads++;
+        uploadImageToNuuls(std::move(next.imageData), next.channel,
+                           *next.textEdit);
+    }
+}
+
+void finishUpload()
+{
+    activeUploads--;
+    if (!uploadQueue.empty())
+    {
+        // the delay is there not to spam the remote server
+        QTimer::singleShot(UPLOAD_DELAY, startUploads);
+    }
+}
 
 // logging information on successful uploads to a json file
 void logToFile(const QString originalFilePath, QString imageLink,
@@ -53,24 +94,15 @@ void logToFile(const QString originalFilePath, QString imageLink,
                          : getSettings()->logPath),
                     "ImageUploader.json");
 
-    //reading existing logs
-    QFile logReadFile(logFileName);
-    bool isLogFileOkay =
-        logReadFile.open(QIODevice::ReadWrite | QIODevice::Text);
+    QFile logFile(logFileName);
+    bool isLogFileOkay = logFile.open(QIODevice::ReadWrite);
     if (!isLogFileOkay)
     {
         channel->addMessage(makeSystemMessage(
             QString("Failed to open log file with links at ") + logFileName));
         return;
     }
-    auto logs = logReadFile.readAll();
-    if (logs.isEmpty())
-    {
-        logs = QJsonDocument(QJsonArray()).toJson();
-    }
-    logReadFile.close();
 
-    //writing new data to logs
     QJsonObject newLogEntry;
     newLogEntry["channelName"] = channel->getName();
     newLogEntry["deletionLink"] =
@@ -85,12 +117,30 @@ void logToFile(const QString originalFilePath, QString imageLink,
     // image link
     // local path to an image (can be empty)
     // timestamp
-    QSaveFile logSaveFile(logFileName);
-    logSaveFile.open(QIODevice::WriteOnly | QIODevice::Text);
-    QJsonArray entries = QJsonDocument::fromJson(logs).array();
-    entries.push_back(newLogEntry);
-    logSaveFile.write(QJsonDocument(entries).toJson());
-    logSaveFile.commit();
+    auto entry = QJsonDocument(newLogEntry).toJson(QJsonDocument::Compact);
+
+    // The log stays a json array. Instead of reading and rewriting all of it,
+    // only its closing bracket is looked for and overwritten by the new entry.
+    auto tailStart = std::max<qint64>(0, logFile.size() - LOG_TAIL_SIZE);
+    logFile.seek(tailStart);
+    auto tail = logFile.read(LOG_TAIL_SIZE);
+    auto closing = tail.lastIndexOf(']');
+    if (closing == -1)
+    {
+        logFile.resize(0);
+        logFile.write("[\n    " + entry + "\n]\n");
+        return;
+    }
+
+    auto last = closing - 1;
+    while (last >= 0 && QChar(tail[last]).isSpace())
+    {
+        last--;
+    }
+    bool isEmpty = last >= 0 && tail[last] == '[';
+
+    logFile.seek(tailStart + closing);
+    logFile.write((isEmpty ? "    " : ",\n    ") + entry + "\n]\n");
 }
 
 // extracting link to either image or its deletion from response body
@@ -137,11 +187,30 @@ void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
 
     QHttpMultiPart *payload = new QHttpMultiPart(QHttpMultiPart::FormDataType);
     QHttpPart part = QHttpPart();
-    part.setBody(imageData.data);
+    qint64 size = 0;
+    if (imageData.data.isEmpty())
+    {
+        // files are streamed from disk while they are sent
+        auto *file = new QFile(originalFilePath, payload);
+        if (!file->open(QIODevice::ReadOnly))
+        {
+            channel->addMessage(makeSystemMessage(
+                QString("Failed to open file: %1").arg(originalFilePath)));
+            delete payload;
+            finishUpload();
+            return;
+        }
+        size = file->size();
+        part.setBodyDevice(file);
+    }
+    else
+    {
+        size = imageData.data.length();
+        part.setBody(imageData.data);
+    }
     part.setHeader(QNetworkRequest::ContentTypeHeader,
                    QString("image/%1").arg(imageData.format));
-    part.setHeader(QNetworkRequest::ContentLengthHeader,
-                   QVariant(imageData.data.length()));
+    part.setHeader(QNetworkRequest::ContentLengthHeader, QVariant(size));
     part.setHeader(QNetworkRequest::ContentDispositionHeader,
                    QString("form-data; name=\"%1\"; filename=\"control_v.%2\"")
                        .arg(formField)
@@ -153,6 +222,40 @@ void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
         .header("Content-Type", contentType)
         .headerList(extraHeaders)
         .multiPart(payload)
+        .onReplyCreated([channel, originalFilePath,
+                         size](QNetworkReply *reply) {
+            if (size < PROGRESS_MIN_SIZE)
+            {
+                return;
+            }
+
+            // called on the network thread, reports every quarter once
+            auto reported = std::make_shared<qint64>(0);
+            QObject::connect(
+                reply, &QNetworkReply::uploadProgress, reply,
+                [channel, originalFilePath, reported](qint64 sent,
+                                                      qint64 total) {
+                    if (total <= 0)
+                    {
+                        return;
+                    }
+                    auto quarter = sent * 4 / total;
+                    if (quarter <= *reported || quarter >= 4)
+                    {
+                        return;
+                    }
+                    *reported = quarter;
+
+                    postToThread([channel, originalFilePath, quarter] {
+                        channel->addMessage(makeSystemMessage(
+                            QString("Uploading %1: %2%")
+                                .arg(originalFilePath.isEmpty()
+                                         ? "image"
+                                         : originalFilePath)
+                                .arg(quarter * 25)));
+                    });
+                });
+        })
         .onSuccess([&textEdit, channel,
                     originalFilePath](NetworkResult result) -> Outcome {
             QString link = getSettings()->imageUploaderLink.getValue().isEmpty()
@@ -166,7 +269,10 @@ void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
                           result, getSettings()->imageUploaderDeletionLink);
             qCDebug(chatterinoNuulsuploader) << link << deletionLink;
             textEdit.insertPlainText(link + " ");
-            if (uploadQueue.empty())
+
+            // this upload is still counted as active until finally runs
+            auto left = uploadQueue.size() + size_t(activeUploads) - 1;
+            if (left == 0)
             {
                 channel->addMessage(makeSystemMessage(
                     QString("Your image has been uploaded to %1 %2.")
@@ -175,28 +281,18 @@ void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
                                  ? ""
                                  : QString("(Deletion link: %1 )")
                                        .arg(deletionLink))));
-                uploadMutex.unlock();
             }
             else
             {
                 channel->addMessage(makeSystemMessage(
                     QString("Your image has been uploaded to %1 %2. %3 left. "
-                            "Please wait until all of them are uploaded. "
-                            "About %4 seconds left.")
+                            "Please wait until all of them are uploaded.")
                         .arg(link)
                         .arg(deletionLink.isEmpty()
                                  ? ""
                                  : QString("(Deletion link: %1 )")
                                        .arg(deletionLink))
-                        .arg(uploadQueue.size())
-                        .arg(uploadQueue.size() * (UPLOAD_DELAY / 1000 + 1))));
-                // 2 seconds for the timer that's there not to spam the remote server
-                // and 1 second of actual uploading.
-
-                QTimer::singleShot(UPLOAD_DELAY, [channel, &textEdit]() {
-                    uploadImageToNuuls(uploadQueue.front(), channel, textEdit);
-                    uploadQueue.pop();
-                });
+                        .arg(left)));
             }
 
             logToFile(originalFilePath, link, deletionLink, channel);
@@ -207,23 +303,25 @@ void uploadImageToNuuls(RawImageData imageData, ChannelPtr channel,
             channel->addMessage(makeSystemMessage(
                 QString("An error happened while uploading your image: %1")
                     .arg(result.status())));
-            uploadMutex.unlock();
             return true;
         })
+        .finally([] {
+            finishUpload();
+        })
         .execute();
 }
 
 void upload(const QMimeData *source, ChannelPtr channel,
             ResizingTextEdit &outputTextEdit)
 {
-    if (!uploadMutex.tryLock())
+    // new uploads wait in the queue for the ones that are still running
+    bool busy = activeUploads > 0;
+    if (!busy)
     {
-        channel->addMessage(makeSystemMessage(
-            QString("Please wait until the upload finishes.")));
-        return;
+        channel->addMessage(makeSystemMessage(QString("Started upload...")));
     }
 
-    channel->addMessage(makeSystemMessage(QString("Started upload...")));
+    std::vector<RawImageData> images;
     if (source->hasUrls())
     {
         auto mimeDb = QMimeDatabase();
@@ -233,7 +331,40 @@ void upload(const QMimeData *source, ChannelPtr channel,
         {
             QString localPath = path.toLocalFile();
             QMimeType mime = mimeDb.mimeTypeForUrl(path);
-            if (mime.name().startsWith("image") && !mime.inherits("image/gif"))
+
+            // formats the uploader accepts are sent as they are, streamed
+            // from the file
+            QString format;
+            if (mime.inherits("image/gif"))
+            {
+                format = "gif";
+            }
+            else if (mime.inherits("image/png"))
+            {
+                format = "png";
+            }
+            else if (mime.inherits("image/jpeg"))
+            {
+                format = "jpeg";
+            }
+
+            if (!format.isEmpty())
+            {
+                channel->addMessage(makeSystemMessage(
+                    QString(format == "gif" ? "Uploading GIF: %1"
+                                            : "Uploading image: %1")
+                        .arg(localPath)));
+                QFile file(localPath);
+                bool isOkay = file.open(QIODevice::ReadOnly);
+                if (!isOkay)
+                {
+                    channel->addMessage(
+                        makeSystemMessage(QString("Failed to open file. :(")));
+                    return;
+                }
+                images.push_back({QByteArray(), format, localPath});
+            }
+            else if (mime.name().startsWith("image"))
             {
                 channel->addMessage(makeSystemMessage(
                     QString("Uploading image: %1").arg(localPath)));
@@ -242,15 +373,13 @@ void upload(const QMimeData *source, ChannelPtr channel,
                 {
                     channel->addMessage(
                         makeSystemMessage(QString("Couldn't load image :(")));
-                    uploadMutex.unlock();
                     return;
                 }
 
                 boost::optional<QByteArray> imageData = convertToPng(img);
                 if (imageData)
                 {
-                    RawImageData data = {imageData.get(), "png", localPath};
-                    uploadQueue.push(data);
+                    images.push_back({imageData.get(), "png", localPath});
                 }
                 else
                 {
@@ -258,58 +387,30 @@ void upload(const QMimeData *source, ChannelPtr channel,
                         QString("Cannot upload file: %1. Couldn't convert "
                                 "image to png.")
                             .arg(localPath)));
-                    uploadMutex.unlock();
-                    return;
-                }
-            }
-            else if (mime.inherits("image/gif"))
-            {
-                channel->addMessage(makeSystemMessage(
-                    QString("Uploading GIF: %1").arg(localPath)));
-                QFile file(localPath);
-                bool isOkay = file.open(QIODevice::ReadOnly);
-                if (!isOkay)
-                {
-                    channel->addMessage(
-                        makeSystemMessage(QString("Failed to open file. :(")));
-                    uploadMutex.unlock();
                     return;
                 }
-                RawImageData data = {file.readAll(), "gif", localPath};
-                uploadQueue.push(data);
-                file.close();
-                // file.readAll() => might be a bit big but it /should/ work
             }
             else
             {
                 channel->addMessage(makeSystemMessage(
                     QString("Cannot upload file: %1. Not an image.")
                         .arg(localPath)));
-                uploadMutex.unlock();
                 return;
             }
         }
-        if (!uploadQueue.empty())
-        {
-            uploadImageToNuuls(uploadQueue.front(), channel, outputTextEdit);
-            uploadQueue.pop();
-        }
     }
     else if (source->hasFormat("image/png"))
     {
         // the path to file is not present every time, thus the filePath is empty
-        uploadImageToNuuls({source->data("image/png"), "png", ""}, channel,
-                           outputTextEdit);
+        images.push_back({source->data("image/png"), "png", ""});
     }
     else if (source->hasFormat("image/jpeg"))
     {
-        uploadImageToNuuls({source->data("image/jpeg"), "jpeg", ""}, channel,
-                           outputTextEdit);
+        images.push_back({source->data("image/jpeg"), "jpeg", ""});
     }
     else if (source->hasFormat("image/gif"))
     {
-        uploadImageToNuuls({source->data("image/gif"), "gif", ""}, channel,
-                           outputTextEdit);
+        images.push_back({source->data("image/gif"), "gif", ""});
     }
 
     else
@@ -318,16 +419,28 @@ void upload(const QMimeData *source, ChannelPtr channel,
         boost::optional<QByteArray> imageData = convertToPng(image);
         if (imageData)
         {
-            uploadImageToNuuls({imageData.get(), "png", ""}, channel,
-                               outputTextEdit);
+            images.push_back({imageData.get(), "png", ""});
         }
         else
         {
             channel->addMessage(makeSystemMessage(
                 QString("Cannot upload file, failed to convert to png.")));
-            uploadMutex.unlock();
+            return;
         }
     }
+
+    if (busy)
+    {
+        channel->addMessage(makeSystemMessage(
+            QString("Queued %1 upload(s) behind %2 others.")
+                .arg(images.size())
+                .arg(uploadQueue.size() + size_t(activeUploads))));
+    }
+    for (auto &image : images)
+    {
+        uploadQueue.push_back({std::move(image), channel, &outputTextEdit});
+    }
+    startUploads();
 }
 
 }  // namespace chatterino
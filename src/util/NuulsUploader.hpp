@@ -6,6 +6,7 @@
 
 namespace chatterino {
 struct RawImageData {
+    // if empty, the file at filePath is streamed while uploading
     QByteArray data;
     QString format;
     QString filePath;
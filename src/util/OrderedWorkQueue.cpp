@@ -0,0 +1,99 @@
+#include "util/OrderedWorkQueue.hpp"
+
+#include "debug/AssertInGuiThread.hpp"
+#include "util/DebugCount.hpp"
+#include "util/PostToThread.hpp"
+
+#include <QtConcurrent>
+
+namespace chatterino {
+
+OrderedWorkQueue::OrderedWorkQueue()
+    : lanes_(std::make_shared<Lanes>())
+{
+}
+
+void OrderedWorkQueue::run(const QString &key, std::function<Result()> work)
+{
+    assertInGuiThread();
+
+    auto task = std::make_shared<Task>();
+    (*this->lanes_)[key].push_back(task);
+    DebugCount::increase("ordered work queue tasks");
+
+    QtConcurrent::run([weak = std::weak_ptr<Lanes>(this->lanes_), key, task,
+                       work = std::move(work)] {
+        auto result = work();
+
+        postToThread([weak, key, task, result = std::move(result)]() mutable {
+            DebugCount::decrease("ordered work queue tasks");
+
+            auto lanes = weak.lock();
+            if (!lanes)
+            {
+                return;
+            }
+
+            task->result = std::move(result);
+            task->done = true;
+            OrderedWorkQueue::deliver(*lanes, key);
+        });
+    });
+}
+
+void OrderedWorkQueue::runAfter(const QString &key, Result result)
+{
+    assertInGuiThread();
+
+    if (!this->hasPending(key))
+    {
+        if (result)
+        {
+            result();
+        }
+        return;
+    }
+
+    auto task = std::make_shared<Task>();
+    task->result = std::move(result);
+    task->done = true;
+    (*this->lanes_)[key].push_back(task);
+}
+
+bool OrderedWorkQueue::hasPending(const QString &key) const
+{
+    return this->lanes_->count(key) != 0;
+}
+
+void OrderedWorkQueue::deliver(Lanes &lanes, const QString &key)
+{
+    while (true)
+    {
+        // results may queue more work, which can invalidate iterators
+        auto it = lanes.find(key);
+        if (it == lanes.end())
+        {
+            return;
+        }
+
+        auto &tasks = it->second;
+        if (!tasks.front()->done)
+        {
+            return;
+        }
+
+        auto task = std::move(tasks.front());
+        tasks.pop_front();
+        if (tasks.empty())
+        {
+            lanes.erase(it);
+        }
+
+        if (task->result)
+        {
+            task->result();
+        }
+    }
+}
+
+}  // namespace chatterino
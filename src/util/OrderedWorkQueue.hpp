@@ -0,0 +1,58 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <deque>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Runs work on the thread pool and hands the results back to the gui
+ *        thread in the order the work was queued in.
+ *
+ * Work is grouped by a key, results of the same key are always delivered in
+ * order while different keys don't wait for each other. Tasks and results
+ * may add more work for any key. Gui thread only.
+ */
+class OrderedWorkQueue : boost::noncopyable
+{
+public:
+    /// Function that is run on the gui thread once a task is done
+    using Result = std::function<void()>;
+
+    OrderedWorkQueue();
+
+    /// Runs work on the thread pool. The result it returns is called on the
+    /// gui thread after the results of all earlier tasks of the same key.
+    /// An empty result is skipped.
+    void run(const QString &key, std::function<Result()> work);
+
+    /// Calls result on the gui thread after the results of all earlier tasks
+    /// of the same key, right away if there are none outstanding
+    void runAfter(const QString &key, Result result);
+
+    /// Returns true if results of the key are still outstanding
+    bool hasPending(const QString &key) const;
+
+private:
+    struct Task {
+        Result result;
+        bool done = false;
+    };
+    using Lanes =
+        std::unordered_map<QString, std::deque<std::shared_ptr<Task>>>;
+
+    static void deliver(Lanes &lanes, const QString &key);
+
+    // shared with the tasks so results arriving after the queue is gone are
+    // dropped
+    std::shared_ptr<Lanes> lanes_;
+};
+
+}  // namespace chatterino
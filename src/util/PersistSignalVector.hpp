@@ -1,22 +1,49 @@
 #pragma once
 
+#include <functional>
 #include <memory>
 #include "common/ChatterinoSetting.hpp"
 #include "common/SignalVector.hpp"
 
 namespace chatterino {
 
+/// Keeps vec in the setting at name of manager and calls save after it
+/// changed. Lists that are still in settings.json from before they were
+/// moved to their own file are taken from there.
 template <typename T>
-inline void persist(SignalVector<T> &vec, const std::string &name)
+inline void persist(
+    SignalVector<T> &vec, const std::string &name,
+    const std::shared_ptr<pajlada::Settings::SettingManager> &manager,
+    std::function<void()> save)
 {
-    auto setting = std::make_unique<ChatterinoSetting<std::vector<T>>>(name);
+    auto setting =
+        std::make_unique<pajlada::Settings::Setting<std::vector<T>>>(name,
+                                                                     manager);
 
-    for (auto &&item : setting->getValue())
-        vec.append(item);
+    auto items = setting->getValue();
+    if (items.empty())
+    {
+        ChatterinoSetting<std::vector<T>> legacy(name);
+        items = legacy.getValue();
+        if (!items.empty())
+        {
+            setting->setValue(items);
+            pajlada::Settings::SettingManager::removeSetting(name);
+            save();
+        }
+    }
 
-    vec.delayedItemsChanged.connect([setting = setting.get(), vec = &vec] {
-        setting->setValue(vec->raw());
-    });
+    {
+        typename SignalVector<T>::Batch batch(vec);
+        for (auto &&item : items)
+            vec.append(item);
+    }
+
+    vec.delayedItemsChanged.connect(
+        [setting = setting.get(), vec = &vec, save = std::move(save)] {
+            setting->setValue(vec->raw());
+            save();
+        });
 
     // TODO: Delete when appropriate.
     setting.release();
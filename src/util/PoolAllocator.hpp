@@ -0,0 +1,275 @@
+#pragma once
+
+#include "util/DebugCount.hpp"
+
+#include <QString>
+
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <new>
+#include <utility>
+#include <vector>
+
+namespace chatterino {
+
+/**
+ * @brief Blocks of one size, cached per thread.
+ *
+ * Every thread takes blocks from and returns them to its own free list
+ * without a lock. A list that grows too long hands a batch to the shared
+ * pool and an empty one takes a batch from it, so blocks freed on another
+ * thread than they were allocated on, like messages that are built on one
+ * thread and dropped on the gui thread, are used again. Memory is never
+ * returned to the system, the pool keeps what was in use at the peak.
+ */
+template <size_t Size>
+class BlockPool
+{
+    static_assert(Size % alignof(std::max_align_t) == 0,
+                  "blocks have to keep the alignment of the slab");
+
+public:
+    // blocks moved between a thread and the shared pool at once
+    static constexpr size_t BATCH = 32;
+
+    static void *allocate()
+    {
+        if (cacheState() == CacheState::Destroyed)
+        {
+            // the thread is exiting
+            auto batch = take();
+            if (batch.count > 1)
+            {
+                put({batch.head->next, batch.count - 1});
+            }
+            inUse().increase();
+            return batch.head;
+        }
+
+        auto &cache = threadCache();
+        if (cache.head == nullptr)
+        {
+            auto batch = take();
+            cache.head = batch.head;
+            cache.count = batch.count;
+        }
+
+        auto *block = cache.head;
+        cache.head = block->next;
+        cache.count--;
+        inUse().increase();
+        return block;
+    }
+
+    static void deallocate(void *pointer) noexcept
+    {
+        auto *block = static_cast<Block *>(pointer);
+        inUse().decrease();
+
+        if (cacheState() == CacheState::Destroyed)
+        {
+            block->next = nullptr;
+            put({block, 1});
+            return;
+        }
+
+        auto &cache = threadCache();
+        block->next = cache.head;
+        cache.head = block;
+        cache.count++;
+
+        if (cache.count >= 2 * BATCH)
+        {
+            // the first BATCH blocks go to the shared pool
+            auto *last = cache.head;
+            for (size_t i = 1; i < BATCH; i++)
+            {
+                last = last->next;
+            }
+            Batch batch{cache.head, BATCH};
+            cache.head = last->next;
+            cache.count -= BATCH;
+            last->next = nullptr;
+            put(batch);
+        }
+    }
+
+private:
+    struct Block {
+        Block *next;
+    };
+
+    struct Batch {
+        Block *head;
+        size_t count;
+    };
+
+    struct Shared {
+        std::mutex mutex;
+        std::vector<Batch> batches;
+        // keeps the memory reachable for leak checkers
+        std::vector<void *> slabs;
+    };
+
+    enum class CacheState { Unused, Alive, Destroyed };
+
+    struct Cache {
+        Block *head = nullptr;
+        size_t count = 0;
+
+        Cache()
+        {
+            cacheState() = CacheState::Alive;
+        }
+
+        ~Cache()
+        {
+            cacheState() = CacheState::Destroyed;
+            if (this->head != nullptr)
+            {
+                put({this->head, this->count});
+            }
+        }
+    };
+
+    // never destroyed, blocks may be freed after static destructors ran
+    static Shared &shared()
+    {
+        static auto *shared = new Shared;
+        return *shared;
+    }
+
+    // trivial, so it can still be read while the thread exits
+    static CacheState &cacheState()
+    {
+        thread_local CacheState state = CacheState::Unused;
+        return state;
+    }
+
+    static Cache &threadCache()
+    {
+        thread_local Cache cache;
+        return cache;
+    }
+
+    static Batch take()
+    {
+        {
+            auto &shared = BlockPool::shared();
+            std::lock_guard<std::mutex> lock(shared.mutex);
+            if (!shared.batches.empty())
+            {
+                auto batch = shared.batches.back();
+                shared.batches.pop_back();
+                return batch;
+            }
+        }
+
+        auto *slab = static_cast<char *>(::operator new(Size * BATCH));
+        auto block = [slab](size_t index) {
+            return reinterpret_cast<Block *>(slab + index * Size);
+        };
+        for (size_t i = 0; i + 1 < BATCH; i++)
+        {
+            block(i)->next = block(i + 1);
+        }
+        block(BATCH - 1)->next = nullptr;
+        reserved().increase(int64_t(Size * BATCH));
+
+        auto &shared = BlockPool::shared();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.slabs.push_back(slab);
+        return {block(0), BATCH};
+    }
+
+    static void put(Batch batch)
+    {
+        auto &shared = BlockPool::shared();
+        std::lock_guard<std::mutex> lock(shared.mutex);
+        shared.batches.push_back(batch);
+    }
+
+    static DebugCounter &inUse()
+    {
+        static DebugCounter counter(
+            QString("pool blocks of %1 bytes in use").arg(Size));
+        return counter;
+    }
+
+    static DebugCounter &reserved()
+    {
+        static DebugCounter counter(
+            QString("bytes: pool of %1 byte blocks").arg(Size));
+        return counter;
+    }
+};
+
+/**
+ * @brief Allocator that takes single objects from a BlockPool.
+ *
+ * Meant for std::allocate_shared, the object and its control block are
+ * placed in one block. Types of about the same size share a pool.
+ */
+template <typename T>
+class PoolAllocator
+{
+public:
+    using value_type = T;
+
+    PoolAllocator() = default;
+
+    template <typename U>
+    PoolAllocator(const PoolAllocator<U> & /*other*/) noexcept
+    {
+    }
+
+    T *allocate(size_t count)
+    {
+        if (count != 1)
+        {
+            return static_cast<T *>(::operator new(count * sizeof(T)));
+        }
+        return static_cast<T *>(Pool::allocate());
+    }
+
+    void deallocate(T *pointer, size_t count) noexcept
+    {
+        if (count != 1)
+        {
+            ::operator delete(pointer);
+            return;
+        }
+        Pool::deallocate(pointer);
+    }
+
+    template <typename U>
+    bool operator==(const PoolAllocator<U> & /*other*/) const noexcept
+    {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(const PoolAllocator<U> & /*other*/) const noexcept
+    {
+        return false;
+    }
+
+private:
+    static_assert(alignof(T) <= alignof(std::max_align_t),
+                  "over-aligned types can't be pooled");
+
+    static constexpr size_t ALIGNMENT = alignof(std::max_align_t);
+    using Pool =
+        BlockPool<(sizeof(T) + ALIGNMENT - 1) / ALIGNMENT * ALIGNMENT>;
+};
+
+/// std::make_shared with the object and its control block in a pooled block
+template <typename T, typename... Args>
+std::shared_ptr<T> makePooledShared(Args &&... args)
+{
+    return std::allocate_shared<T>(PoolAllocator<T>(),
+                                   std::forward<Args>(args)...);
+}
+
+}  // namespace chatterino
@@ -1,7 +1,9 @@
 #pragma once
 
-#include <QCoreApplication>
+#include "debug/EventLoopWatchdog.hpp"
+#include "util/GuiTaskQueue.hpp"
 
+#include <QCoreApplication>
 #include <QRunnable>
 #include <QThreadPool>
 
@@ -29,31 +31,15 @@ private:
     std::function<void()> action_;
 };
 
-// Taken from
-// https://stackoverflow.com/questions/21646467/how-to-execute-a-functor-or-a-lambda-in-a-given-thread-in-qt-gcd-style
-// Qt 5/4 - preferred, has least allocations
+// Runs fun on the gui thread, see GuiTaskQueue.
+// file and line are where it's called from, the event loop watchdog reports
+// them when fun blocks the gui thread
 template <typename F>
-static void postToThread(F &&fun, QObject *obj = qApp)
+static void postToThread(F &&fun, TaskPriority priority = TaskPriority::Normal,
+                         const char *file = CHATTERINO_CALLER_FILE,
+                         int line = CHATTERINO_CALLER_LINE)
 {
-    struct Event : public QEvent {
-        using Fun = typename std::decay<F>::type;
-        Fun fun;
-        Event(Fun &&fun)
-            : QEvent(QEvent::None)
-            , fun(std::move(fun))
-        {
-        }
-        Event(const Fun &fun)
-            : QEvent(QEvent::None)
-            , fun(fun)
-        {
-        }
-        ~Event() override
-        {
-            fun();
-        }
-    };
-    QCoreApplication::postEvent(obj, new Event(std::forward<F>(fun)));
+    GuiTaskQueue::instance().push(std::forward<F>(fun), priority, file, line);
 }
 
 }  // namespace chatterino
@@ -2,6 +2,146 @@
 
 #include <QHash>
 #include <QString>
+#include <QStringView>
+
+#include <cstdint>
+#include <cstring>
+
+#if defined(_MSC_VER) && defined(_M_X64)
+#    include <intrin.h>
+#endif
+
+namespace chatterino {
+
+namespace detail {
+
+    // wyhash by Wang Yi, reduced to what's needed for strings in memory
+
+    inline void hashMultiply(uint64_t &a, uint64_t &b)
+    {
+#if defined(__SIZEOF_INT128__)
+        __uint128_t r = a;
+        r *= b;
+        a = uint64_t(r);
+        b = uint64_t(r >> 64);
+#elif defined(_MSC_VER) && defined(_M_X64)
+        a = _umul128(a, b, &b);
+#else
+        uint64_t ha = a >> 32, hb = b >> 32;
+        uint64_t la = uint32_t(a), lb = uint32_t(b);
+        uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+        uint64_t t = rl + (rm0 << 32);
+        uint64_t c = t < rl;
+        uint64_t lo = t + (rm1 << 32);
+        c += lo < t;
+        a = lo;
+        b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+    }
+
+    inline uint64_t hashMix(uint64_t a, uint64_t b)
+    {
+        hashMultiply(a, b);
+        return a ^ b;
+    }
+
+    inline uint64_t hashRead8(const unsigned char *p)
+    {
+        uint64_t v;
+        std::memcpy(&v, p, 8);
+        return v;
+    }
+
+    inline uint64_t hashRead4(const unsigned char *p)
+    {
+        uint32_t v;
+        std::memcpy(&v, p, 4);
+        return v;
+    }
+
+    inline uint64_t hashBytes(const unsigned char *p, size_t len)
+    {
+        constexpr uint64_t s0 = 0xa0761d6478bd642full;
+        constexpr uint64_t s1 = 0xe7037ed1a0b428dbull;
+        constexpr uint64_t s2 = 0x8ebc6af09c88c6e3ull;
+        constexpr uint64_t s3 = 0x589965cc75374cc3ull;
+
+        uint64_t seed = hashMix(s0, s1);
+        uint64_t a = 0;
+        uint64_t b = 0;
+
+        if (len <= 16)
+        {
+            if (len >= 4)
+            {
+                auto offset = (len >> 3) << 2;
+                a = (hashRead4(p) << 32) | hashRead4(p + offset);
+                b = (hashRead4(p + len - 4) << 32) |
+                    hashRead4(p + len - 4 - offset);
+            }
+            else if (len > 0)
+            {
+                a = (uint64_t(p[0]) << 16) | (uint64_t(p[len >> 1]) << 8) |
+                    p[len - 1];
+            }
+        }
+        else
+        {
+            auto i = len;
+            if (i > 48)
+            {
+                // three independent lanes, long messages hash in parallel
+                auto see1 = seed;
+                auto see2 = seed;
+                do
+                {
+                    seed = hashMix(hashRead8(p) ^ s1, hashRead8(p + 8) ^ seed);
+                    see1 = hashMix(hashRead8(p + 16) ^ s2,
+                                   hashRead8(p + 24) ^ see1);
+                    see2 = hashMix(hashRead8(p + 32) ^ s3,
+                                   hashRead8(p + 40) ^ see2);
+                    p += 48;
+                    i -= 48;
+                } while (i > 48);
+                seed ^= see1 ^ see2;
+            }
+            while (i > 16)
+            {
+                seed = hashMix(hashRead8(p) ^ s1, hashRead8(p + 8) ^ seed);
+                i -= 16;
+                p += 16;
+            }
+            a = hashRead8(p + i - 16);
+            b = hashRead8(p + i - 8);
+        }
+
+        a ^= s1;
+        b ^= seed;
+        hashMultiply(a, b);
+        return hashMix(a ^ s0 ^ len, b ^ s1);
+    }
+
+}  // namespace detail
+
+/// Hash of the UTF-16 code units of string. Views and strings with the same
+/// content get the same hash, it's only stable within one run.
+inline size_t hashQString(QStringView string)
+{
+    return size_t(detail::hashBytes(
+        reinterpret_cast<const unsigned char *>(string.utf16()),
+        size_t(string.size()) * sizeof(char16_t)));
+}
+
+/// Hash policy for containers keyed by strings, e.g. per word lookups of
+/// emotes and badges. Faster than qHash on short strings.
+struct QStringHash {
+    size_t operator()(QStringView string) const
+    {
+        return hashQString(string);
+    }
+};
+
+}  // namespace chatterino
 
 namespace std {
 
@@ -10,7 +150,7 @@ template <>
 struct hash<QString> {
     std::size_t operator()(const QString &s) const
     {
-        return qHash(s);
+        return chatterino::hashQString(s);
     }
 };
 #endif
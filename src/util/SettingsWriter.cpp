@@ -0,0 +1,121 @@
+#include "util/SettingsWriter.hpp"
+
+#include "common/QLogging.hpp"
+#include "debug/AssertInGuiThread.hpp"
+#include "debug/Benchmark.hpp"
+
+#include <QFile>
+#include <QTimer>
+#include <QtConcurrent>
+#include <pajlada/settings/settingmanager.hpp>
+
+#ifdef USEWINSDK
+#    include <Windows.h>
+#else
+#    include <cstdio>
+#endif
+
+namespace chatterino {
+
+namespace {
+
+    // replaces to in one step, readers see either the old or the new file
+    bool replaceFile(const QString &from, const QString &to)
+    {
+#ifdef USEWINSDK
+        return MoveFileExW(reinterpret_cast<LPCWSTR>(from.utf16()),
+                           reinterpret_cast<LPCWSTR>(to.utf16()),
+                           MOVEFILE_REPLACE_EXISTING |
+                               MOVEFILE_WRITE_THROUGH) != 0;
+#else
+        return std::rename(QFile::encodeName(from).constData(),
+                           QFile::encodeName(to).constData()) == 0;
+#endif
+    }
+
+}  // namespace
+
+SettingsWriter::SettingsWriter()
+{
+    this->pool_.setMaxThreadCount(1);
+}
+
+SettingsWriter::~SettingsWriter()
+{
+    this->pool_.waitForDone();
+}
+
+SettingsWriter &SettingsWriter::instance()
+{
+    static SettingsWriter instance;
+    return instance;
+}
+
+void SettingsWriter::queue(const std::shared_ptr<Manager> &manager,
+                           const QString &path)
+{
+    assertInGuiThread();
+
+    this->queued_[path] = manager;
+
+    if (this->writeQueued_)
+    {
+        return;
+    }
+    this->writeQueued_ = true;
+
+    QTimer::singleShot(DELAY, &this->lifetimeGuard_, [this] {
+        this->writeQueued();
+    });
+}
+
+void SettingsWriter::writeQueued()
+{
+    this->writeQueued_ = false;
+
+    for (auto &[path, manager] : this->queued_)
+    {
+        QtConcurrent::run(&this->pool_,
+                          [manager = std::move(manager), path = path] {
+                              SettingsWriter::save(*manager, path);
+                          });
+    }
+    this->queued_.clear();
+}
+
+void SettingsWriter::flush()
+{
+    this->pool_.waitForDone();
+
+    for (auto &[path, manager] : this->queued_)
+    {
+        SettingsWriter::save(*manager, path);
+    }
+    this->queued_.clear();
+}
+
+bool SettingsWriter::save(Manager &manager, const QString &path)
+{
+    BenchmarkGuard benchmark("save settings");
+
+    // the manager locks its document while it's written, so settings can
+    // change on the gui thread meanwhile
+    auto temporaryPath = path + ".tmp";
+    if (!manager.saveAs(qPrintable(temporaryPath)))
+    {
+        qCWarning(chatterinoCommon) << "Failed to write" << temporaryPath;
+        return false;
+    }
+
+    if (!replaceFile(temporaryPath, path))
+    {
+        qCWarning(chatterinoCommon)
+            << "Failed to move" << temporaryPath << "to" << path;
+        QFile::remove(temporaryPath);
+        return false;
+    }
+
+    return true;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,61 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QObject>
+#include <QString>
+#include <QThreadPool>
+#include <boost/noncopyable.hpp>
+
+#include <chrono>
+#include <memory>
+#include <unordered_map>
+
+namespace pajlada::Settings {
+class SettingManager;
+}  // namespace pajlada::Settings
+
+namespace chatterino {
+
+/**
+ * @brief Saves settings files off the gui thread.
+ *
+ * Saves of the same file requested within DELAY are merged into one. All
+ * files are written by one thread, so a file is never written twice at
+ * once. A file is written next to itself and then moved over it, a crash
+ * while saving leaves the previous one. Gui thread only.
+ */
+class SettingsWriter : boost::noncopyable
+{
+public:
+    using Manager = pajlada::Settings::SettingManager;
+
+    static constexpr std::chrono::milliseconds DELAY{1000};
+
+    SettingsWriter();
+    ~SettingsWriter();
+
+    static SettingsWriter &instance();
+
+    /// Saves manager to path soon
+    void queue(const std::shared_ptr<Manager> &manager, const QString &path);
+
+    /// Saves the queued files on this thread and waits for the ones being
+    /// written, e.g. before exiting
+    void flush();
+
+    /// Writes manager to path, false if it failed. Any thread.
+    static bool save(Manager &manager, const QString &path);
+
+private:
+    void writeQueued();
+
+    // by path
+    std::unordered_map<QString, std::shared_ptr<Manager>> queued_;
+    bool writeQueued_ = false;
+
+    QThreadPool pool_;
+    QObject lifetimeGuard_;
+};
+
+}  // namespace chatterino
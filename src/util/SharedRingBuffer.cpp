@@ -0,0 +1,228 @@
+#include "util/SharedRingBuffer.hpp"
+
+#include "common/QLogging.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <new>
+
+namespace ipc = boost::interprocess;
+
+namespace chatterino {
+
+namespace {
+
+    constexpr uint32_t magic = 0x43524e47;  // "CRNG"
+    constexpr uint32_t version = 1;
+    // marks the end of the data where a record didn't fit anymore, the
+    // record follows at the start
+    constexpr uint32_t wrapMarker = 0xffffffff;
+    constexpr size_t recordAlignment = 8;
+
+    size_t recordSize(size_t length)
+    {
+        auto size = sizeof(uint32_t) + length;
+        return (size + recordAlignment - 1) / recordAlignment *
+               recordAlignment;
+    }
+
+}  // namespace
+
+struct SharedRingBuffer::Header {
+    uint32_t magic;
+    uint32_t version;
+    uint64_t capacity;
+    // bytes ever popped, only written by the reader
+    alignas(64) std::atomic<uint64_t> head;
+    // bytes ever pushed, only written by the writer
+    alignas(64) std::atomic<uint64_t> tail;
+};
+
+static_assert(std::atomic<uint64_t>::is_always_lock_free,
+              "positions have to be lock free to be shared between processes");
+
+std::unique_ptr<SharedRingBuffer> SharedRingBuffer::create(
+    const std::string &name, size_t capacity)
+{
+    capacity = (capacity + recordAlignment - 1) / recordAlignment *
+               recordAlignment;
+
+    try
+    {
+        ipc::shared_memory_object::remove(name.c_str());
+        ipc::shared_memory_object memory(ipc::create_only, name.c_str(),
+                                         ipc::read_write);
+        memory.truncate(ipc::offset_t(sizeof(Header) + capacity));
+
+        std::unique_ptr<SharedRingBuffer> buffer(
+            new SharedRingBuffer(name, true, std::move(memory)));
+
+        auto *header = new (buffer->region_.get_address()) Header;
+        header->capacity = capacity;
+        header->head.store(0, std::memory_order_relaxed);
+        header->tail.store(0, std::memory_order_relaxed);
+        header->version = version;
+        // readers only trust the header once this is set
+        std::atomic_thread_fence(std::memory_order_release);
+        header->magic = magic;
+
+        return buffer;
+    }
+    catch (ipc::interprocess_exception &ex)
+    {
+        qCWarning(chatterinoCommon)
+            << "create shared ring buffer" << name.c_str() << ":" << ex.what();
+        ipc::shared_memory_object::remove(name.c_str());
+        return nullptr;
+    }
+}
+
+std::unique_ptr<SharedRingBuffer> SharedRingBuffer::open(
+    const std::string &name)
+{
+    try
+    {
+        ipc::shared_memory_object memory(ipc::open_only, name.c_str(),
+                                         ipc::read_write);
+
+        std::unique_ptr<SharedRingBuffer> buffer(
+            new SharedRingBuffer(name, false, std::move(memory)));
+
+        const auto &header = buffer->header();
+        if (buffer->region_.get_size() < sizeof(Header) ||
+            header.magic != magic || header.version != version ||
+            buffer->region_.get_size() < sizeof(Header) + header.capacity)
+        {
+            qCWarning(chatterinoCommon)
+                << "shared memory" << name.c_str()
+                << "isn't a ring buffer of this version";
+            return nullptr;
+        }
+        std::atomic_thread_fence(std::memory_order_acquire);
+
+        return buffer;
+    }
+    catch (ipc::interprocess_exception &ex)
+    {
+        qCDebug(chatterinoCommon)
+            << "open shared ring buffer" << name.c_str() << ":" << ex.what();
+        return nullptr;
+    }
+}
+
+SharedRingBuffer::SharedRingBuffer(std::string name, bool owner,
+                                   ipc::shared_memory_object memory)
+    : name_(std::move(name))
+    , owner_(owner)
+    , memory_(std::move(memory))
+    , region_(this->memory_, ipc::read_write)
+{
+}
+
+SharedRingBuffer::~SharedRingBuffer()
+{
+    if (this->owner_)
+    {
+        ipc::shared_memory_object::remove(this->name_.c_str());
+    }
+}
+
+bool SharedRingBuffer::tryPush(const QByteArray &record)
+{
+    auto &header = this->header();
+    const auto capacity = header.capacity;
+    const auto size = recordSize(size_t(record.size()));
+    if (size > capacity)
+    {
+        return false;
+    }
+
+    auto tail = header.tail.load(std::memory_order_relaxed);
+    auto head = header.head.load(std::memory_order_acquire);
+
+    auto offset = tail % capacity;
+    auto toEnd = capacity - offset;
+    auto needed = toEnd < size ? toEnd + size : size;
+    if (tail - head + needed > capacity)
+    {
+        return false;
+    }
+
+    if (toEnd < size)
+    {
+        std::memcpy(this->data() + offset, &wrapMarker, sizeof(uint32_t));
+        tail += toEnd;
+        offset = 0;
+    }
+
+    auto length = uint32_t(record.size());
+    std::memcpy(this->data() + offset, &length, sizeof(uint32_t));
+    std::memcpy(this->data() + offset + sizeof(uint32_t), record.constData(),
+                length);
+
+    header.tail.store(tail + size, std::memory_order_release);
+    return true;
+}
+
+boost::optional<QByteArray> SharedRingBuffer::tryPop()
+{
+    auto &header = this->header();
+    const auto capacity = header.capacity;
+
+    auto head = header.head.load(std::memory_order_relaxed);
+    auto tail = header.tail.load(std::memory_order_acquire);
+    if (head == tail)
+    {
+        return boost::none;
+    }
+
+    auto offset = head % capacity;
+    uint32_t length = 0;
+    std::memcpy(&length, this->data() + offset, sizeof(uint32_t));
+    if (length == wrapMarker)
+    {
+        // the record was pushed together with the marker
+        head += capacity - offset;
+        offset = 0;
+        std::memcpy(&length, this->data(), sizeof(uint32_t));
+    }
+
+    if (recordSize(length) > tail - head ||
+        offset + recordSize(length) > capacity)
+    {
+        // the writer doesn't follow the format, don't read past the data
+        qCWarning(chatterinoCommon)
+            << "corrupt record in shared ring buffer" << this->name_.c_str();
+        header.head.store(tail, std::memory_order_release);
+        return boost::none;
+    }
+
+    QByteArray record(this->data() + offset + sizeof(uint32_t), int(length));
+    header.head.store(head + recordSize(length), std::memory_order_release);
+    return record;
+}
+
+size_t SharedRingBuffer::used() const
+{
+    const auto &header = this->header();
+    return size_t(header.tail.load(std::memory_order_acquire) -
+                  header.head.load(std::memory_order_acquire));
+}
+
+size_t SharedRingBuffer::capacity() const
+{
+    return size_t(this->header().capacity);
+}
+
+SharedRingBuffer::Header &SharedRingBuffer::header() const
+{
+    return *static_cast<Header *>(this->region_.get_address());
+}
+
+char *SharedRingBuffer::data() const
+{
+    return static_cast<char *>(this->region_.get_address()) + sizeof(Header);
+}
+
+}  // namespace chatterino
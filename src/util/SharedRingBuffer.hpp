@@ -0,0 +1,70 @@
+#pragma once
+
+#include <boost/interprocess/mapped_region.hpp>
+#include <boost/interprocess/shared_memory_object.hpp>
+#include <boost/optional.hpp>
+#include <QByteArray>
+
+#include <cstddef>
+#include <memory>
+#include <string>
+
+namespace chatterino {
+
+/**
+ * @brief Ring buffer of byte records in shared memory, to hand messages from
+ *        one process to another.
+ *
+ * There's one writer and one reader, usually in different processes. Neither
+ * side takes a lock, each only advances its own position in the shared
+ * header. Records are copied in and out, a record has to fit into the buffer
+ * as a whole. Messages are meant to be written with encodeMessage, which
+ * makes them independent from the process that built them.
+ *
+ * The process that creates the buffer owns its name and removes it again
+ * once the buffer is destroyed. Readers and writers that opened it keep
+ * their mapping until they destroy their side.
+ */
+class SharedRingBuffer
+{
+public:
+    /// Creates a buffer with room for capacity bytes of records, replacing
+    /// one with the same name that was left behind. nullptr on failure.
+    static std::unique_ptr<SharedRingBuffer> create(const std::string &name,
+                                                    size_t capacity);
+    /// Opens a buffer created by another process, nullptr if there's none
+    /// with the name or it isn't one
+    static std::unique_ptr<SharedRingBuffer> open(const std::string &name);
+
+    ~SharedRingBuffer();
+
+    SharedRingBuffer(const SharedRingBuffer &) = delete;
+    SharedRingBuffer &operator=(const SharedRingBuffer &) = delete;
+
+    /// Writer only. Returns false if the record doesn't fit until the reader
+    /// caught up.
+    bool tryPush(const QByteArray &record);
+    /// Reader only. The oldest record, none if the buffer is empty.
+    boost::optional<QByteArray> tryPop();
+
+    /// Bytes that were pushed but not popped yet, including the framing
+    size_t used() const;
+    size_t capacity() const;
+
+private:
+    struct Header;
+
+    SharedRingBuffer(std::string name, bool owner,
+                     boost::interprocess::shared_memory_object memory);
+
+    Header &header() const;
+    char *data() const;
+
+    std::string name_;
+    // removes the name when destroyed
+    bool owner_;
+    boost::interprocess::shared_memory_object memory_;
+    boost::interprocess::mapped_region region_;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,61 @@
+#include "util/Similarity.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+namespace chatterino {
+
+int longestCommonSubstring(const QString &a, const QString &b, int stopAt)
+{
+    const QString &outer = a.size() >= b.size() ? a : b;
+    const QString &inner = a.size() >= b.size() ? b : a;
+
+    // row[j + 1] is the length of the common substring that ends at the
+    // current character of outer and inner[j]
+    std::vector<int> row(size_t(inner.size()) + 1, 0);
+    int longest = 0;
+
+    for (int i = 0; i < outer.size(); i++)
+    {
+        // the value of row[j] for the previous character of outer
+        int diagonal = 0;
+        for (int j = 0; j < inner.size(); j++)
+        {
+            auto &current = row[size_t(j) + 1];
+            int previous = current;
+
+            current = outer[i] == inner[j] ? diagonal + 1 : 0;
+            diagonal = previous;
+
+            if (current > longest)
+            {
+                longest = current;
+                if (longest >= stopAt)
+                {
+                    return longest;
+                }
+            }
+        }
+    }
+
+    return longest;
+}
+
+bool isSimilar(const QString &a, const QString &b, float threshold)
+{
+    int longer = std::max(a.size(), b.size());
+    int shorter = std::min(a.size(), b.size());
+
+    // the common substring can't be longer than the shorter string
+    if (longer == 0 || float(shorter) <= threshold * float(longer))
+    {
+        return false;
+    }
+
+    int needed = int(std::floor(threshold * float(longer))) + 1;
+
+    return longestCommonSubstring(a, b, needed) >= needed;
+}
+
+}  // namespace chatterino
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <QString>
+
+#include <climits>
+
+namespace chatterino {
+
+/// Returns the length of the longest common substring of a and b. Only
+/// keeps one row of min(a, b) + 1 numbers. Returns early once a common
+/// substring of at least stopAt characters was found, the result is at least
+/// stopAt then.
+int longestCommonSubstring(const QString &a, const QString &b,
+                           int stopAt = INT_MAX);
+
+/// Whether the longest common substring of a and b is longer than threshold
+/// (0 to 1) times the length of the longer string. Strings whose lengths are
+/// too different are rejected without comparing them.
+bool isSimilar(const QString &a, const QString &b, float threshold);
+
+}  // namespace chatterino
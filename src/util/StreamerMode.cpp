@@ -6,6 +6,7 @@
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Settings.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/PostToThread.hpp"
 #include "widgets/Notebook.hpp"
 #include "widgets/Window.hpp"
 #include "widgets/helper/NotebookTab.hpp"
@@ -19,46 +20,152 @@
 #    pragma comment(lib, "Wtsapi32.lib")
 #endif
 
+#ifdef Q_OS_LINUX
+#    include <sys/stat.h>
+#endif
+
+#include <QDirIterator>
+#include <QFile>
 #include <QProcess>
+#include <QTimer>
+#include <QtConcurrent>
+
+#include <atomic>
+#include <unordered_map>
 
 namespace chatterino {
 
-constexpr int cooldownInS = 10;
+namespace {
 
-bool shouldShowWarning = true;
+    constexpr int cooldownInS = 10;
 
-const QStringList &broadcastingBinaries()
-{
-#ifdef USEWINSDK
-    static QStringList bins = {"obs.exe", "obs64.exe"};
-#else
-    static QStringList bins = {"obs"};
+#ifdef Q_OS_LINUX
+    /// Reads the process names from /proc. Processes that were already seen
+    /// in the last scan aren't read again, a pid that got reused has a new
+    /// inode.
+    class ProcScanner
+    {
+    public:
+        bool scan(const QStringList &names)
+        {
+            std::unordered_map<qint64, Process> seen;
+            bool found = false;
+
+            QDirIterator it("/proc", QDir::Dirs | QDir::NoDotAndDotDot);
+            while (it.hasNext())
+            {
+                auto path = it.next();
+
+                bool isPid = false;
+                auto pid = it.fileName().toLongLong(&isPid);
+                struct stat info;
+                if (!isPid || ::stat(QFile::encodeName(path), &info) != 0)
+                {
+                    continue;
+                }
+
+                auto known = this->processes_.find(pid);
+                auto process =
+                    known != this->processes_.end() &&
+                            known->second.inode == info.st_ino
+                        ? known->second
+                        : Process{info.st_ino, isBroadcasting(path, names)};
+
+                found |= process.broadcasting;
+                seen.emplace(pid, process);
+            }
+
+            // processes that exited are dropped
+            this->processes_ = std::move(seen);
+            return found;
+        }
+
+    private:
+        struct Process {
+            ino_t inode;
+            bool broadcasting;
+        };
+
+        static bool isBroadcasting(const QString &path,
+                                   const QStringList &names)
+        {
+            // same name pgrep -x matches against
+            QFile comm(path + "/comm");
+            if (!comm.open(QIODevice::ReadOnly))
+            {
+                return false;
+            }
+
+            return names.contains(QString::fromUtf8(comm.readAll().trimmed()));
+        }
+
+        std::unordered_map<qint64, Process> processes_;
+    };
 #endif
-    return bins;
-}
 
-bool isInStreamerMode()
-{
-    switch (getSettings()->enableStreamerMode.getEnum())
+    /// Looks for broadcasting binaries in the thread pool every few seconds
+    /// while Streamer Mode is set to DetectObs.
+    class BroadcastingDetector
     {
-        case StreamerModeSetting::Enabled:
-            return true;
-        case StreamerModeSetting::Disabled:
-            return false;
-        case StreamerModeSetting::DetectObs:
+    public:
+        static BroadcastingDetector &instance()
+        {
+            static BroadcastingDetector instance;
+            return instance;
+        }
+
+        bool detected() const
+        {
+            return this->detected_.load(std::memory_order_relaxed);
+        }
 
-#if defined(Q_OS_LINUX) || defined(Q_OS_MACOS)
+        pajlada::Signals::NoArgSignal changed;
 
-            static bool cache = false;
-            static QDateTime time = QDateTime();
+    private:
+        BroadcastingDetector()
+        {
+            // the first caller might not be on the gui thread, the timer has
+            // to be created on it
+            postToThread([this] {
+                auto *timer = new QTimer;
+                QObject::connect(timer, &QTimer::timeout, [this] {
+                    this->startScan();
+                });
+                timer->start(cooldownInS * 1000);
+                this->startScan();
+            });
+        }
 
-            if (time.isValid() &&
-                time.addSecs(cooldownInS) > QDateTime::currentDateTime())
+        void startScan()
+        {
+            if (getSettings()->enableStreamerMode.getEnum() !=
+                    StreamerModeSetting::DetectObs ||
+                this->scanning_)
             {
-                return cache;
+                return;
             }
-            time = QDateTime::currentDateTime();
+            this->scanning_ = true;
+
+            QtConcurrent::run([this] {
+                auto found = this->scan();
 
+                postToThread([this, found] {
+                    this->scanning_ = false;
+                    if (found != this->detected())
+                    {
+                        this->detected_.store(found);
+                        this->changed.invoke();
+                    }
+                });
+            });
+        }
+
+        // Runs in the thread pool, only one scan at a time
+        bool scan()
+        {
+#if defined(Q_OS_LINUX)
+            return this->procScanner_.scan(broadcastingBinaries());
+#elif defined(Q_OS_MACOS)
             QProcess p;
             p.start("pgrep", {"-x", broadcastingBinaries().join("|")},
                     QIODevice::NotOpen);
@@ -66,60 +173,45 @@ bool isInStreamerMode()
             if (p.waitForFinished(1000) &&
                 p.exitStatus() == QProcess::NormalExit)
             {
-                cache = (p.exitCode() == 0);
-                return (p.exitCode() == 0);
+                return p.exitCode() == 0;
             }
 
             // Fallback to false and showing a warning
-
-            if (shouldShowWarning)
+            if (this->shouldShowWarning_)
             {
-                shouldShowWarning = false;
+                this->shouldShowWarning_ = false;
 
-                getApp()->twitch->addGlobalSystemMessage(
-                    "Streamer Mode is set to Automatic, but pgrep is missing. "
-                    "Install it to fix the issue or set Streamer Mode to "
-                    "Enabled or Disabled in the Settings.");
+                postToThread([] {
+                    getApp()->twitch->addGlobalSystemMessage(
+                        "Streamer Mode is set to Automatic, but pgrep is "
+                        "missing. Install it to fix the issue or set "
+                        "Streamer Mode to Enabled or Disabled in the "
+                        "Settings.");
+                });
             }
 
             qCWarning(chatterinoStreamerMode) << "pgrep execution timed out!";
-
-            cache = false;
             return false;
-#endif
-
-#ifdef USEWINSDK
+#elif defined(USEWINSDK)
             if (!IsWindowsVistaOrGreater())
             {
                 return false;
             }
-            static bool cache = false;
-            static QDateTime time = QDateTime();
-
-            if (time.isValid() &&
-                time.addSecs(cooldownInS) > QDateTime::currentDateTime())
-            {
-                return cache;
-            }
-            time = QDateTime::currentDateTime();
 
             WTS_PROCESS_INFO *pWPIs = nullptr;
             DWORD dwProcCount = 0;
+            bool found = false;
 
             if (WTSEnumerateProcesses(WTS_CURRENT_SERVER_HANDLE, NULL, 1,
                                       &pWPIs, &dwProcCount))
             {
                 //Go through all processes retrieved
-                for (DWORD i = 0; i < dwProcCount; i++)
+                for (DWORD i = 0; i < dwProcCount && !found; i++)
                 {
                     QString processName = QString::fromUtf16(
                         reinterpret_cast<char16_t *>(pWPIs[i].pProcessName));
 
-                    if (broadcastingBinaries().contains(processName))
-                    {
-                        cache = true;
-                        return true;
-                    }
+                    found = broadcastingBinaries().contains(processName);
                 }
             }
 
@@ -128,11 +220,52 @@ bool isInStreamerMode()
                 WTSFreeMemory(pWPIs);
             }
 
-            cache = false;
+            return found;
+#else
+            return false;
+#endif
+        }
+
+        std::atomic<bool> detected_{false};
+        // gui thread only
+        bool scanning_ = false;
+
+#if defined(Q_OS_LINUX)
+        ProcScanner procScanner_;
+#elif defined(Q_OS_MACOS)
+        bool shouldShowWarning_ = true;
 #endif
+    };
+
+}  // namespace
+
+const QStringList &broadcastingBinaries()
+{
+#ifdef USEWINSDK
+    static QStringList bins = {"obs.exe", "obs64.exe"};
+#else
+    static QStringList bins = {"obs"};
+#endif
+    return bins;
+}
+
+bool isInStreamerMode()
+{
+    switch (getSettings()->enableStreamerMode.getEnum())
+    {
+        case StreamerModeSetting::Enabled:
+            return true;
+        case StreamerModeSetting::Disabled:
             return false;
+        case StreamerModeSetting::DetectObs:
+            return BroadcastingDetector::instance().detected();
     }
     return false;
 }
 
+pajlada::Signals::NoArgSignal &broadcastingBinaryChanged()
+{
+    return BroadcastingDetector::instance().changed;
+}
+
 }  // namespace chatterino
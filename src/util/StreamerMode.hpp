@@ -1,12 +1,19 @@
 #pragma once
 
 #include <QStringList>
+#include <pajlada/signals/signal.hpp>
 
 namespace chatterino {
 
 enum StreamerModeSetting { Disabled = 0, Enabled = 1, DetectObs = 2 };
 
 const QStringList &broadcastingBinaries();
+/// Doesn't block, with DetectObs it returns the result of the last scan for
+/// broadcasting binaries. Can be called from any thread.
 bool isInStreamerMode();
 
+/// Invoked on the gui thread when a scan finds that a broadcasting binary was
+/// started or stopped
+pajlada::Signals::NoArgSignal &broadcastingBinaryChanged();
+
 }  // namespace chatterino
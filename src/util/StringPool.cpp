@@ -0,0 +1,73 @@
+#include "util/StringPool.hpp"
+
+#include "util/DebugCount.hpp"
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    DebugCounter hitCount("string pool hits");
+    DebugCounter missCount("string pool misses");
+    DebugCounter internedCount("interned strings");
+
+}  // namespace
+
+StringPool &StringPool::instance()
+{
+    static StringPool instance;
+    return instance;
+}
+
+QString StringPool::intern(const QString &string)
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    auto it = this->strings_.find(string);
+    if (it != this->strings_.end())
+    {
+        hitCount.increase();
+        return *it;
+    }
+
+    missCount.increase();
+
+    if (this->strings_.size() >= this->purgeSize_)
+    {
+        this->purge();
+    }
+
+    internedCount.increase();
+    return *this->strings_.insert(string).first;
+}
+
+size_t StringPool::size() const
+{
+    std::lock_guard<std::mutex> lock(this->mutex_);
+
+    return this->strings_.size();
+}
+
+void StringPool::purge()
+{
+    auto before = this->strings_.size();
+
+    for (auto it = this->strings_.begin(); it != this->strings_.end();)
+    {
+        // only referenced by the pool itself
+        if (it->isDetached())
+        {
+            it = this->strings_.erase(it);
+        }
+        else
+        {
+            it++;
+        }
+    }
+
+    this->purgeSize_ = std::max<size_t>(1024, this->strings_.size() * 2);
+    internedCount.increase(int64_t(this->strings_.size()) - int64_t(before));
+}
+
+}  // namespace chatterino
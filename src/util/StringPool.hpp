@@ -0,0 +1,41 @@
+#pragma once
+
+#include "util/QStringHash.hpp"
+
+#include <QString>
+#include <boost/noncopyable.hpp>
+
+#include <mutex>
+#include <unordered_set>
+
+namespace chatterino {
+
+/**
+ * @brief Shares the data of equal strings that are kept in many places, e.g.
+ *        the logins of users that chat in multiple channels.
+ *
+ * Strings that aren't used outside of the pool anymore are dropped once the
+ * pool has grown to twice its size after the last cleanup. Thread safe.
+ */
+class StringPool : boost::noncopyable
+{
+public:
+    static StringPool &instance();
+
+    /// Returns a string equal to string that shares its data with all other
+    /// strings interned with the same content
+    QString intern(const QString &string);
+
+    size_t size() const;
+
+private:
+    StringPool() = default;
+
+    void purge();
+
+    mutable std::mutex mutex_;
+    std::unordered_set<QString> strings_;
+    size_t purgeSize_ = 1024;
+};
+
+}  // namespace chatterino
@@ -0,0 +1,139 @@
+#pragma once
+
+#include "util/DebugCount.hpp"
+
+#include <boost/noncopyable.hpp>
+
+#include <algorithm>
+#include <array>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+namespace chatterino {
+
+/**
+ * @brief Looks up values that are alive somewhere else by a key, e.g. images
+ *        by their url, without keeping them alive itself.
+ *
+ * The keys are spread over shards with their own lock, so threads looking up
+ * different keys rarely wait for each other. A shard drops the entries of
+ * values that were destroyed once it has grown to twice its size after the
+ * last cleanup, inserting stays amortized constant and the cache doesn't
+ * fill up with expired entries in long sessions.
+ *
+ * The number of entries, including expired ones that weren't dropped yet,
+ * is reported to the counter. Thread safe.
+ */
+template <typename Key, typename Value, size_t ShardCount = 8>
+class WeakCache : boost::noncopyable
+{
+public:
+    explicit WeakCache(DebugCounter &entryCount)
+        : entryCount_(entryCount)
+    {
+    }
+
+    ~WeakCache()
+    {
+        this->entryCount_.decrease(int64_t(this->size()));
+    }
+
+    /// Returns the cached value for the key if it's alive and reuse accepts
+    /// it, otherwise the one created by make is cached and returned. make is
+    /// called with the lock of the shard held.
+    template <typename Make, typename Reuse>
+    std::shared_ptr<Value> getOrCreate(const Key &key, Make &&make,
+                                       Reuse &&reuse)
+    {
+        auto &shard = this->shardOf(key);
+        std::lock_guard<std::mutex> lock(shard.mutex);
+
+        auto it = shard.entries.find(key);
+        if (it != shard.entries.end())
+        {
+            if (auto shared = it->second.lock(); shared && reuse(*shared))
+            {
+                return shared;
+            }
+
+            std::shared_ptr<Value> shared = make();
+            it->second = shared;
+            return shared;
+        }
+
+        if (shard.entries.size() >= shard.pruneSize)
+        {
+            this->prune(shard);
+        }
+
+        std::shared_ptr<Value> shared = make();
+        shard.entries.emplace(key, shared);
+        this->entryCount_.increase();
+        return shared;
+    }
+
+    /// Returns the cached value for the key if it's alive, otherwise the one
+    /// created by make is cached and returned
+    template <typename Make>
+    std::shared_ptr<Value> getOrCreate(const Key &key, Make &&make)
+    {
+        return this->getOrCreate(key, std::forward<Make>(make),
+                                 [](const Value &) {
+                                     return true;
+                                 });
+    }
+
+    /// Number of entries, including the ones of destroyed values that
+    /// weren't dropped yet
+    size_t size() const
+    {
+        size_t size = 0;
+        for (const auto &shard : this->shards_)
+        {
+            std::lock_guard<std::mutex> lock(shard.mutex);
+            size += shard.entries.size();
+        }
+        return size;
+    }
+
+private:
+    static constexpr size_t MIN_PRUNE_SIZE = 64;
+
+    struct Shard {
+        mutable std::mutex mutex;
+        std::unordered_map<Key, std::weak_ptr<Value>> entries;
+        size_t pruneSize = MIN_PRUNE_SIZE;
+    };
+
+    Shard &shardOf(const Key &key)
+    {
+        return this->shards_[std::hash<Key>()(key) % ShardCount];
+    }
+
+    void prune(Shard &shard)
+    {
+        auto before = shard.entries.size();
+
+        for (auto it = shard.entries.begin(); it != shard.entries.end();)
+        {
+            if (it->second.expired())
+            {
+                it = shard.entries.erase(it);
+            }
+            else
+            {
+                it++;
+            }
+        }
+
+        shard.pruneSize = std::max(MIN_PRUNE_SIZE, shard.entries.size() * 2);
+        this->entryCount_.decrease(int64_t(before - shard.entries.size()));
+    }
+
+    DebugCounter &entryCount_;
+    std::array<Shard, ShardCount> shards_;
+};
+
+}  // namespace chatterino
@@ -5,6 +5,7 @@
 #include "common/QLogging.hpp"
 #include "singletons/Settings.hpp"
 #include "util/DebugCount.hpp"
+#include "util/FrameScheduler.hpp"
 #include "widgets/splits/Split.hpp"
 
 #include <QTimer>
@@ -40,6 +41,57 @@ BOOL CALLBACK enumWindows(HWND hwnd, LPARAM)
 
     return true;
 }
+
+namespace {
+
+    bool isAllowedProcess(HWND attached)
+    {
+        if (getSettings()->attachExtensionToAnyProcess)
+        {
+            return true;
+        }
+
+        DWORD processId;
+        ::GetWindowThreadProcessId(attached, &processId);
+
+        HANDLE process = ::OpenProcess(
+            PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, false, processId);
+
+        std::unique_ptr<TCHAR[]> filename(new TCHAR[512]);
+        DWORD filenameLength =
+            ::GetModuleFileNameEx(process, nullptr, filename.get(), 512);
+        ::CloseHandle(process);
+        QString qfilename =
+            QString::fromWCharArray(filename.get(), int(filenameLength));
+
+        // We don't attach to non-browser processes by default.
+        if (!qfilename.endsWith("chrome.exe") &&
+            !qfilename.endsWith("firefox.exe") &&
+            !qfilename.endsWith("vivaldi.exe") &&
+            !qfilename.endsWith("opera.exe") &&
+            !qfilename.endsWith("msedge.exe") &&
+            !qfilename.endsWith("brave.exe"))
+        {
+            qCWarning(chatterinoWidget) << "NM Illegal caller" << qfilename;
+            return false;
+        }
+
+        return true;
+    }
+
+    void raiseTaskbarsBehind(HWND attached)
+    {
+        taskbarHwnds.clear();
+        ::EnumWindows(&enumWindows, 0);
+
+        for (auto taskbarHwnd : taskbarHwnds)
+        {
+            ::SetWindowPos(taskbarHwnd, GetNextWindow(attached, GW_HWNDNEXT), 0,
+                           0, 0, 0, SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
+        }
+    }
+
+}  // namespace
 #endif
 
 AttachedWindow::AttachedWindow(void *_target, int _yOffset)
@@ -61,6 +113,8 @@ AttachedWindow::AttachedWindow(void *_target, int _yOffset)
 
 AttachedWindow::~AttachedWindow()
 {
+    this->stopTracking();
+
     for (auto it = items.begin(); it != items.end(); it++)
     {
         if (it->window == this)
@@ -164,51 +218,80 @@ void AttachedWindow::attachToHwnd(void *_attachedPtr)
 
     this->attached_ = true;
 
-    //auto hwnd = HWND(this->winId());
     auto attached = HWND(_attachedPtr);
 
-    // FAST TIMER - used to resize/reorder windows
-    this->timer_.setInterval(1);
-    QObject::connect(&this->timer_, &QTimer::timeout, [this, attached] {
-        // check process id
-        if (!this->validProcessName_)
+    if (!isAllowedProcess(attached))
+    {
+        this->deleteLater();
+        return;
+    }
+
+    // The hooks are called on this thread from its event loop. Moving,
+    // resizing, minimizing or closing the target is reported by the first
+    // one, the second one tells us when another window came to the front, so
+    // the z-order needs to be fixed.
+    WINEVENTPROC onEvent = [](HWINEVENTHOOK hook, DWORD event, HWND hwnd,
+                              LONG idObject, LONG /*idChild*/,
+                              DWORD /*idEventThread*/, DWORD /*time*/) {
+        for (Item &item : items)
         {
-            DWORD processId;
-            ::GetWindowThreadProcessId(attached, &processId);
+            AttachedWindow *window = item.window;
 
-            HANDLE process = ::OpenProcess(
-                PROCESS_QUERY_INFORMATION | PROCESS_VM_READ, false, processId);
+            if (hook == window->foregroundHook_)
+            {
+                window->queueUpdate(true);
+                return;
+            }
 
-            std::unique_ptr<TCHAR[]> filename(new TCHAR[512]);
-            DWORD filenameLength =
-                ::GetModuleFileNameEx(process, nullptr, filename.get(), 512);
-            QString qfilename =
-                QString::fromWCharArray(filename.get(), int(filenameLength));
+            if (hook != window->targetHook_ || hwnd != item.hwnd ||
+                idObject != OBJID_WINDOW)
+            {
+                continue;
+            }
 
-            if (!getSettings()->attachExtensionToAnyProcess)
+            switch (event)
             {
-                // We don't attach to non-browser processes by default.
-                if (!qfilename.endsWith("chrome.exe") &&
-                    !qfilename.endsWith("firefox.exe") &&
-                    !qfilename.endsWith("vivaldi.exe") &&
-                    !qfilename.endsWith("opera.exe") &&
-                    !qfilename.endsWith("msedge.exe") &&
-                    !qfilename.endsWith("brave.exe"))
-
-                {
-                    qCWarning(chatterinoWidget)
-                        << "NM Illegal caller" << qfilename;
-                    this->timer_.stop();
-                    this->deleteLater();
-                    return;
-                }
+                case EVENT_OBJECT_DESTROY:
+                    window->stopTracking();
+                    window->deleteLater();
+                    break;
+                case EVENT_OBJECT_SHOW:
+                case EVENT_OBJECT_HIDE:
+                case EVENT_OBJECT_REORDER:
+                case EVENT_OBJECT_LOCATIONCHANGE:
+                    window->queueUpdate(false);
+                    break;
             }
-            this->validProcessName_ = true;
+            return;
         }
+    };
+
+    DWORD processId;
+    DWORD threadId = ::GetWindowThreadProcessId(attached, &processId);
 
+    this->targetHook_ = ::SetWinEventHook(
+        EVENT_OBJECT_DESTROY, EVENT_OBJECT_LOCATIONCHANGE, nullptr, onEvent,
+        processId, threadId, WINEVENT_OUTOFCONTEXT);
+    this->foregroundHook_ = ::SetWinEventHook(
+        EVENT_SYSTEM_FOREGROUND, EVENT_SYSTEM_FOREGROUND, nullptr, onEvent, 0,
+        0, WINEVENT_OUTOFCONTEXT | WINEVENT_SKIPOWNPROCESS);
+
+    if (this->targetHook_ != nullptr && this->foregroundHook_ != nullptr)
+    {
+        this->queueUpdate(true);
+        return;
+    }
+
+    qCWarning(chatterinoWidget)
+        << "NM Couldn't set window event hooks, polling instead"
+        << ::GetLastError();
+    this->stopTracking();
+
+    // FALLBACK TIMER - used to resize/reorder windows
+    this->timer_.setInterval(FrameScheduler::instance().frameInterval());
+    QObject::connect(&this->timer_, &QTimer::timeout, [this, attached] {
         this->updateWindowRect(attached);
     });
-
     this->timer_.start();
 
     // SLOW TIMER - used to hide taskbar behind fullscreen window
@@ -216,21 +299,50 @@ void AttachedWindow::attachToHwnd(void *_attachedPtr)
     QObject::connect(&this->slowTimer_, &QTimer::timeout, [this, attached] {
         if (this->fullscreen_)
         {
-            taskbarHwnds.clear();
-            ::EnumWindows(&enumWindows, 0);
-
-            for (auto taskbarHwnd : taskbarHwnds)
-            {
-                ::SetWindowPos(taskbarHwnd,
-                               GetNextWindow(attached, GW_HWNDNEXT), 0, 0, 0, 0,
-                               SWP_NOMOVE | SWP_NOSIZE | SWP_NOACTIVATE);
-            }
+            raiseTaskbarsBehind(attached);
         }
     });
     this->slowTimer_.start();
 #endif
 }
 
+void AttachedWindow::queueUpdate(bool foregroundChanged)
+{
+#ifdef USEWINSDK
+    this->raiseTaskbar_ = this->raiseTaskbar_ || foregroundChanged;
+
+    FrameScheduler::instance().request(this, FrameStage::Layout, [this] {
+        if (this->raiseTaskbar_ && this->fullscreen_)
+        {
+            raiseTaskbarsBehind(HWND(this->target_));
+        }
+        this->raiseTaskbar_ = false;
+
+        this->updateWindowRect(this->target_);
+    });
+#else
+    (void)foregroundChanged;
+#endif
+}
+
+void AttachedWindow::stopTracking()
+{
+#ifdef USEWINSDK
+    if (this->targetHook_ != nullptr)
+    {
+        ::UnhookWinEvent(HWINEVENTHOOK(this->targetHook_));
+        this->targetHook_ = nullptr;
+    }
+    if (this->foregroundHook_ != nullptr)
+    {
+        ::UnhookWinEvent(HWINEVENTHOOK(this->foregroundHook_));
+        this->foregroundHook_ = nullptr;
+    }
+#endif
+    this->timer_.stop();
+    this->slowTimer_.stop();
+}
+
 void AttachedWindow::updateWindowRect(void *_attachedPtr)
 {
 #ifdef USEWINSDK
@@ -248,7 +360,7 @@ void AttachedWindow::updateWindowRect(void *_attachedPtr)
     {
         qCWarning(chatterinoWidget) << "NM GetLastError()" << ::GetLastError();
 
-        this->timer_.stop();
+        this->stopTracking();
         this->deleteLater();
         return;
     }
@@ -54,6 +54,10 @@ private:
 
     void attachToHwnd(void *attached);
     void updateWindowRect(void *attached);
+    // Updates the window in the next frame, events of the same frame are
+    // merged
+    void queueUpdate(bool foregroundChanged);
+    void stopTracking();
 
     void *target_;
     int yOffset_;
@@ -65,9 +69,14 @@ private:
     bool fullscreen_ = false;
 
 #ifdef USEWINSDK
-    bool validProcessName_ = false;
     bool attached_ = false;
+    // HWINEVENTHOOKs, events of the target window and foreground changes
+    void *targetHook_ = nullptr;
+    void *foregroundHook_ = nullptr;
+    // the taskbar is raised behind fullscreen windows in the next update
+    bool raiseTaskbar_ = false;
 #endif
+    // only used if the event hooks couldn't be set
     QTimer timer_;
     QTimer slowTimer_;
 };
@@ -27,16 +27,8 @@ BaseWidget::BaseWidget(QWidget *parent, Qt::WindowFlags f)
         this->update();
     });
 }
-void BaseWidget::clearShortcuts()
-{
-    for (auto shortcut : this->shortcuts_)
-    {
-        shortcut->setKey(QKeySequence());
-        shortcut->removeEventFilter(this);
-        shortcut->deleteLater();
-    }
-    this->shortcuts_.clear();
-}
+
+BaseWidget::~BaseWidget() = default;
 
 float BaseWidget::scale() const
 {
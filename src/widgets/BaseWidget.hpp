@@ -1,15 +1,17 @@
 #pragma once
 
-#include <QShortcut>
 #include <QWidget>
 #include <boost/optional.hpp>
 #include <pajlada/signals/signal.hpp>
 #include <pajlada/signals/signalholder.hpp>
 
+#include <memory>
+
 namespace chatterino {
 
 class Theme;
 class BaseWindow;
+class HotkeyActions;
 
 class BaseWidget : public QWidget
 {
@@ -18,6 +20,7 @@ class BaseWidget : public QWidget
 public:
     explicit BaseWidget(QWidget *parent = nullptr,
                         Qt::WindowFlags f = Qt::WindowFlags());
+    ~BaseWidget() override;
 
     virtual float scale() const;
     pajlada::Signals::Signal<float> scaleChanged;
@@ -50,8 +53,8 @@ protected:
 
     Theme *theme;
 
-    std::vector<QShortcut *> shortcuts_;
-    void clearShortcuts();
+    // the actions of the hotkeys, they're removed when it's reset
+    std::unique_ptr<HotkeyActions> shortcuts_;
     pajlada::Signals::SignalHolder signalHolder_;
 
 private:
@@ -19,6 +19,7 @@
 #include <QLayout>
 #include <QList>
 #include <QStandardPaths>
+#include <QTimer>
 #include <QUuid>
 #include <QWidget>
 #include <boost/foreach.hpp>
@@ -419,7 +420,55 @@ void Notebook::resizeEvent(QResizeEvent *)
     this->performLayout();
 }
 
+void Notebook::queueLayout()
+{
+    if (this->isLayouting_)
+    {
+        this->layoutAgain_ = true;
+        return;
+    }
+    if (this->layoutQueued_)
+    {
+        return;
+    }
+    this->layoutQueued_ = true;
+
+    QTimer::singleShot(0, this, [this] {
+        if (this->layoutQueued_)
+        {
+            this->performLayout();
+        }
+    });
+}
+
 void Notebook::performLayout(bool animated)
+{
+    // Tabs that are resized by a pass queue another one. They used to lay
+    // out the notebook recursively, once for every resized tab.
+    if (this->isLayouting_)
+    {
+        this->layoutAgain_ = true;
+        return;
+    }
+    this->isLayouting_ = true;
+    this->layoutQueued_ = false;
+
+    // the sizes of the tabs settle after the second pass, the third one is
+    // only for safety
+    for (int pass = 0; pass < 3; pass++)
+    {
+        this->layoutAgain_ = false;
+        this->performLayoutPass(animated);
+        if (!this->layoutAgain_)
+        {
+            break;
+        }
+    }
+
+    this->isLayouting_ = false;
+}
+
+void Notebook::performLayoutPass(bool animated)
 {
     const auto left = int(2 * this->scale());
     const auto scale = this->scale();
@@ -860,6 +909,24 @@ void SplitNotebook::select(QWidget *page, bool focusPage)
         }
     }
     this->Notebook::select(page, focusPage);
+
+    getApp()->windows->updateDormantChannels();
+
+    // the tab switching hotkeys go to the neighbours of this tab next
+    auto index = this->indexOf(page);
+    if (index >= 0 && this->getPageCount() > 1)
+    {
+        auto count = this->getPageCount();
+        int neighbours[] = {(index + 1) % count, (index + count - 1) % count};
+        for (auto neighbour : neighbours)
+        {
+            if (auto container = dynamic_cast<SplitContainer *>(
+                    this->getPageAt(neighbour)))
+            {
+                container->prefetchImages();
+            }
+        }
+    }
 }
 
 }  // namespace chatterino
@@ -57,6 +57,9 @@ public:
     void setShowAddButton(bool value);
 
     void performLayout(bool animate = false);
+    /// Merges all layout requests until the event loop runs again into a
+    /// single layout. Inside of performLayout, another pass is done instead.
+    void queueLayout();
 
     void setTabDirection(NotebookTabDirection direction);
 
@@ -88,6 +91,7 @@ protected:
 private:
     bool containsPage(QWidget *page);
     Item &findItem(QWidget *page);
+    void performLayoutPass(bool animate);
 
     static bool containsChild(const QObject *obj, const QObject *child);
     NotebookTab *getTabFromPage(QWidget *page);
@@ -106,6 +110,11 @@ private:
     bool lockNotebookLayout_ = false;
     NotebookTabDirection tabDirection_ = NotebookTabDirection::Horizontal;
     QAction *lockNotebookLayoutAction_;
+
+    bool isLayouting_ = false;
+    // a tab changed its size during the current layout
+    bool layoutAgain_ = false;
+    bool layoutQueued_ = false;
 };
 
 class SplitNotebook : public Notebook
@@ -5,6 +5,7 @@
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/FrameScheduler.hpp"
 #include "widgets/helper/ChannelView.hpp"
 
 #include <QDebug>
@@ -12,13 +13,14 @@
 #include <QPainter>
 #include <QTimer>
 
+#include <algorithm>
 #include <cmath>
 
 #define MIN_THUMB_HEIGHT 10
 
 namespace chatterino {
 
-Scrollbar::Scrollbar(ChannelView *parent)
+Scrollbar::Scrollbar(QWidget *parent)
     : BaseWidget(parent)
     , currentValueAnimation_(this, "currentValue_")
 {
@@ -30,21 +32,83 @@ Scrollbar::Scrollbar(ChannelView *parent)
     setMouseTracking(true);
 }
 
-void Scrollbar::addHighlight(ScrollbarHighlight highlight)
+void Scrollbar::addHighlights(
+    const std::vector<ScrollbarHighlight> &highlights)
 {
-    ScrollbarHighlight deleted;
-    this->highlights_.pushBack(highlight, deleted);
+    for (const auto &highlight : highlights)
+    {
+        if (this->messageCount_ >= this->messageLimit_)
+        {
+            this->removeFirstHighlight();
+        }
+
+        auto position = this->firstPosition_ + int64_t(this->messageCount_);
+        this->messageCount_++;
+
+        if (!highlight.isNull())
+        {
+            this->highlights_.push_back({position, highlight});
+        }
+    }
+
+    this->highlightBucketsDirty_ = true;
 }
 
 void Scrollbar::addHighlightsAtStart(
     const std::vector<ScrollbarHighlight> &_highlights)
 {
-    this->highlights_.pushFront(_highlights);
+    // like LimitedQueue::pushFront, only the newest ones that fit are added
+    auto accepted = std::min(this->messageLimit_ - this->messageCount_,
+                             _highlights.size());
+
+    for (auto it = _highlights.rbegin();
+         it != _highlights.rbegin() + ptrdiff_t(accepted); ++it)
+    {
+        this->firstPosition_--;
+        this->messageCount_++;
+
+        if (!it->isNull())
+        {
+            this->highlights_.push_front({this->firstPosition_, *it});
+        }
+    }
+
+    this->highlightBucketsDirty_ = true;
 }
 
 void Scrollbar::replaceHighlight(size_t index, ScrollbarHighlight replacement)
 {
-    this->highlights_.replaceItem(index, replacement);
+    if (index >= this->messageCount_)
+    {
+        return;
+    }
+
+    auto position = this->firstPosition_ + int64_t(index);
+    auto it = std::lower_bound(this->highlights_.begin(),
+                               this->highlights_.end(), position,
+                               [](const PositionedHighlight &highlight,
+                                  int64_t position) {
+                                   return highlight.position < position;
+                               });
+    bool found = it != this->highlights_.end() && it->position == position;
+
+    if (replacement.isNull())
+    {
+        if (found)
+        {
+            this->highlights_.erase(it);
+        }
+    }
+    else if (found)
+    {
+        it->highlight = replacement;
+    }
+    else
+    {
+        this->highlights_.insert(it, {position, replacement});
+    }
+
+    this->highlightBucketsDirty_ = true;
 }
 
 void Scrollbar::pauseHighlights()
@@ -57,19 +121,102 @@ void Scrollbar::unpauseHighlights()
     this->highlightsPaused_ = false;
 }
 
+void Scrollbar::setMessageLimit(size_t limit)
+{
+    while (this->messageCount_ > limit)
+    {
+        this->removeFirstHighlight();
+    }
+
+    this->messageLimit_ = limit;
+    this->highlightBucketsDirty_ = true;
+}
+
 void Scrollbar::clearHighlights()
 {
     this->highlights_.clear();
+    this->firstPosition_ = 0;
+    this->messageCount_ = 0;
+    this->highlightBucketsDirty_ = true;
 }
 
-LimitedQueueSnapshot<ScrollbarHighlight> Scrollbar::getHighlightSnapshot()
+void Scrollbar::removeFirstHighlight()
 {
-    if (!this->highlightsPaused_)
+    if (!this->highlights_.empty() &&
+        this->highlights_.front().position == this->firstPosition_)
     {
-        this->highlightSnapshot_ = this->highlights_.getSnapshot();
+        this->highlights_.pop_front();
     }
 
-    return this->highlightSnapshot_;
+    this->firstPosition_++;
+    this->messageCount_--;
+}
+
+void Scrollbar::updateHighlightBuckets()
+{
+    bool enableRedeemedHighlights = getSettings()->enableRedeemedHighlight;
+    bool enableFirstMessageHighlights =
+        getSettings()->enableFirstMessageHighlight;
+    int height = this->height();
+
+    // the buckets painted while paused stay as they were
+    if (this->highlightsPaused_ ||
+        (!this->highlightBucketsDirty_ &&
+         this->highlightBucketsHeight_ == height &&
+         this->highlightBucketsRedeemed_ == enableRedeemedHighlights &&
+         this->highlightBucketsFirstMessage_ == enableFirstMessageHighlights))
+    {
+        return;
+    }
+
+    this->highlightBucketsDirty_ = false;
+    this->highlightBucketsHeight_ = height;
+    this->highlightBucketsRedeemed_ = enableRedeemedHighlights;
+    this->highlightBucketsFirstMessage_ = enableFirstMessageHighlights;
+
+    this->highlightBuckets_.assign(size_t(std::max(height, 0)), {});
+    if (this->messageCount_ == 0 || height <= 0)
+    {
+        return;
+    }
+
+    float dY = float(height) / float(this->messageCount_);
+
+    for (const auto &[position, highlight] : this->highlights_)
+    {
+        if (highlight.isRedeemedHighlight() && !enableRedeemedHighlights)
+        {
+            continue;
+        }
+
+        if (highlight.isFirstMessageHighlight() &&
+            !enableFirstMessageHighlights)
+        {
+            continue;
+        }
+
+        auto index = position - this->firstPosition_;
+        auto row = std::min(int(float(index) * dY), height - 1);
+
+        QColor color = highlight.getColor();
+        color.setAlpha(255);
+
+        // later messages are painted over earlier ones in the same row
+        switch (highlight.getStyle())
+        {
+            case ScrollbarHighlight::Default: {
+                this->highlightBuckets_[size_t(row)].fill = color;
+            }
+            break;
+
+            case ScrollbarHighlight::Line: {
+                this->highlightBuckets_[size_t(row)].line = color;
+            }
+            break;
+
+            case ScrollbarHighlight::None:;
+        }
+    }
 }
 
 void Scrollbar::scrollToBottom(bool animate)
@@ -228,7 +375,9 @@ void Scrollbar::setCurrentValue(qreal value)
         this->updateScroll();
         this->currentValueChanged_.invoke();
 
-        this->update();
+        FrameScheduler::instance().request(this, FrameStage::Paint, [this] {
+            this->update();
+        });
     }
 }
 
@@ -250,10 +399,6 @@ void Scrollbar::paintEvent(QPaintEvent *)
     QPainter painter(this);
     painter.fillRect(rect(), this->theme->scrollbars.background);
 
-    bool enableRedeemedHighlights = getSettings()->enableRedeemedHighlight;
-    bool enableFirstMessageHighlights =
-        getSettings()->enableFirstMessageHighlight;
-
     //    painter.fillRect(QRect(xOffset, 0, width(), this->buttonHeight),
     //                     this->themeManager->ScrollbarArrow);
     //    painter.fillRect(QRect(xOffset, height() - this->buttonHeight,
@@ -275,57 +420,31 @@ void Scrollbar::paintEvent(QPaintEvent *)
     }
 
     // draw highlights
-    auto snapshot = this->getHighlightSnapshot();
-    size_t snapshotLength = snapshot.size();
+    this->updateHighlightBuckets();
 
-    if (snapshotLength == 0)
+    if (this->messageCount_ == 0)
     {
         return;
     }
 
     int w = this->width();
-    float y = 0;
-    float dY = float(this->height()) / float(snapshotLength);
+    float dY = float(this->height()) / float(this->messageCount_);
     int highlightHeight =
         int(std::ceil(std::max<float>(this->scale() * 2, dY)));
 
-    for (size_t i = 0; i < snapshotLength; i++, y += dY)
+    for (size_t row = 0; row < this->highlightBuckets_.size(); row++)
     {
-        ScrollbarHighlight const &highlight = snapshot[i];
+        const auto &bucket = this->highlightBuckets_[row];
 
-        if (highlight.isNull())
-        {
-            continue;
-        }
-
-        if (highlight.isRedeemedHighlight() && !enableRedeemedHighlights)
+        if (bucket.fill.isValid())
         {
-            continue;
+            painter.fillRect(w / 8 * 3, int(row), w / 4, highlightHeight,
+                             bucket.fill);
         }
 
-        if (highlight.isFirstMessageHighlight() &&
-            !enableFirstMessageHighlights)
+        if (bucket.line.isValid())
         {
-            continue;
-        }
-
-        QColor color = highlight.getColor();
-        color.setAlpha(255);
-
-        switch (highlight.getStyle())
-        {
-            case ScrollbarHighlight::Default: {
-                painter.fillRect(w / 8 * 3, int(y), w / 4, highlightHeight,
-                                 color);
-            }
-            break;
-
-            case ScrollbarHighlight::Line: {
-                painter.fillRect(0, int(y), w, 1, color);
-            }
-            break;
-
-            case ScrollbarHighlight::None:;
+            painter.fillRect(0, int(row), w, 1, bucket.line);
         }
     }
 }
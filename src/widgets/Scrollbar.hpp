@@ -1,6 +1,5 @@
 #pragma once
 
-#include "messages/LimitedQueue.hpp"
 #include "widgets/BaseWidget.hpp"
 #include "widgets/helper/ScrollbarHighlight.hpp"
 
@@ -9,18 +8,20 @@
 #include <QWidget>
 #include <pajlada/signals/signal.hpp>
 
-namespace chatterino {
+#include <cstdint>
+#include <deque>
+#include <vector>
 
-class ChannelView;
+namespace chatterino {
 
 class Scrollbar : public BaseWidget
 {
     Q_OBJECT
 
 public:
-    Scrollbar(ChannelView *parent = nullptr);
+    Scrollbar(QWidget *parent = nullptr);
 
-    void addHighlight(ScrollbarHighlight highlight);
+    void addHighlights(const std::vector<ScrollbarHighlight> &highlights);
     void addHighlightsAtStart(
         const std::vector<ScrollbarHighlight> &highlights_);
     void replaceHighlight(size_t index, ScrollbarHighlight replacement);
@@ -28,6 +29,9 @@ public:
     void pauseHighlights();
     void unpauseHighlights();
     void clearHighlights();
+    /// Same as the limit of the messages of the ChannelView, the highlights
+    /// of the oldest messages over it are removed
+    void setMessageLimit(size_t limit);
 
     void scrollToBottom(bool animate = false);
     bool isAtBottom() const;
@@ -67,16 +71,42 @@ protected:
 private:
     Q_PROPERTY(qreal currentValue_ READ getCurrentValue WRITE setCurrentValue)
 
-    LimitedQueueSnapshot<ScrollbarHighlight> getHighlightSnapshot();
     void updateScroll();
+    void removeFirstHighlight();
+    // puts the highlights into one bucket per pixel row of the scrollbar
+    void updateHighlightBuckets();
 
     QMutex mutex_;
 
     QPropertyAnimation currentValueAnimation_;
 
-    LimitedQueue<ScrollbarHighlight> highlights_;
+    // Only the messages that show a highlight are kept, by their position.
+    // Positions grow when messages are added at the end and shrink when they
+    // are added at the start, the index of a message is its position minus
+    // firstPosition_.
+    struct PositionedHighlight {
+        int64_t position;
+        ScrollbarHighlight highlight;
+    };
+    std::deque<PositionedHighlight> highlights_;
+    int64_t firstPosition_ = 0;
+    // amount of messages, with and without highlights
+    size_t messageCount_ = 0;
+    size_t messageLimit_ = 1000;
     bool highlightsPaused_{false};
-    LimitedQueueSnapshot<ScrollbarHighlight> highlightSnapshot_;
+
+    // Colors to paint at the pixel rows, invalid if there's nothing. These
+    // are only rebuilt after the highlights, the size or the settings
+    // changed, so painting doesn't depend on the amount of messages.
+    struct HighlightBucket {
+        QColor fill;
+        QColor line;
+    };
+    std::vector<HighlightBucket> highlightBuckets_;
+    bool highlightBucketsDirty_ = true;
+    int highlightBucketsHeight_ = 0;
+    bool highlightBucketsRedeemed_ = false;
+    bool highlightBucketsFirstMessage_ = false;
 
     bool atBottom_{false};
 
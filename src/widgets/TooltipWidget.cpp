@@ -117,4 +117,14 @@ void TooltipWidget::leaveEvent(QEvent *)
     // clear parents event
 }
 
+void TooltipWidget::hideEvent(QHideEvent *event)
+{
+    BaseWindow::hideEvent(event);
+
+    // the preview frames aren't kept around while nothing is shown
+    this->displayImage_->clear();
+    this->displayImage_->hide();
+    this->hidden.invoke();
+}
+
 }  // namespace chatterino
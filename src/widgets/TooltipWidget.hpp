@@ -23,6 +23,9 @@ public:
     void clearImage();
     void setImage(QPixmap image);
 
+    // the image is cleared once the tooltip is hidden
+    pajlada::Signals::NoArgSignal hidden;
+
 #ifdef USEWINSDK
     void raise();
 #endif
@@ -30,6 +33,7 @@ public:
 protected:
     void changeEvent(QEvent *) override;
     void leaveEvent(QEvent *) override;
+    void hideEvent(QHideEvent *) override;
     void themeChangedEvent() override;
     void scaleChangedEvent(float) override;
     void paintEvent(QPaintEvent *) override;
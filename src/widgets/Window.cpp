@@ -71,11 +71,6 @@ Window::Window(WindowType type)
         this->resize(int(300 * this->scale()), int(500 * this->scale()));
     }
 
-    this->signalHolder_.managedConnect(getApp()->hotkeys->onItemsUpdated,
-                                       [this]() {
-                                           this->clearShortcuts();
-                                           this->addShortcuts();
-                                       });
     if (type == WindowType::Main || type == WindowType::Popup)
     {
         getSettings()->tabDirection.connect([this](int val) {
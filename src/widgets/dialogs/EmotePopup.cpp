@@ -6,15 +6,12 @@
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
 #include "debug/Benchmark.hpp"
-#include "messages/Message.hpp"
-#include "messages/MessageBuilder.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Emotes.hpp"
 #include "singletons/WindowManager.hpp"
 #include "widgets/Notebook.hpp"
 #include "widgets/Scrollbar.hpp"
-#include "widgets/helper/ChannelView.hpp"
 
 #include <QAbstractButton>
 #include <QHBoxLayout>
@@ -24,70 +21,40 @@
 
 namespace chatterino {
 namespace {
-    auto makeTitleMessage(const QString &title)
-    {
-        MessageBuilder builder;
-        builder.emplace<TextElement>(title, MessageElementFlag::Text);
-        builder->flags.set(MessageFlag::Centered);
-        return builder.release();
-    }
-    auto makeEmoteMessage(const EmoteMap &map,
-                          const MessageElementFlag &emoteFlag)
-    {
-        MessageBuilder builder;
-        builder->flags.set(MessageFlag::Centered);
-        builder->flags.set(MessageFlag::DisableCompactEmotes);
+    using Item = EmoteGrid::Item;
+    using Section = EmoteGrid::Section;
 
-        if (map.empty())
+    std::vector<Item> makeItems(const EmoteMap &map)
+    {
+        std::vector<Item> items;
+        items.reserve(map.size());
+        for (const auto &emote : map)
         {
-            builder.emplace<TextElement>("no emotes available",
-                                         MessageElementFlag::Text,
-                                         MessageColor::System);
-            return builder.release();
+            items.push_back({emote.second, emote.first.string});
         }
 
-        std::vector<std::pair<EmoteName, EmotePtr>> vec(map.begin(), map.end());
-        std::sort(vec.begin(), vec.end(),
-                  [](const std::pair<EmoteName, EmotePtr> &l,
-                     const std::pair<EmoteName, EmotePtr> &r) {
-                      return CompletionModel::compareStrings(l.first.string,
-                                                             r.first.string);
+        std::sort(items.begin(), items.end(),
+                  [](const Item &l, const Item &r) {
+                      return CompletionModel::compareStrings(l.text, r.text);
                   });
-        for (const auto &emote : vec)
-        {
-            builder
-                .emplace<EmoteElement>(
-                    emote.second,
-                    MessageElementFlags{MessageElementFlag::AlwaysShow,
-                                        emoteFlag})
-                ->setLink(Link(Link::InsertText, emote.first.string));
-        }
-
-        return builder.release();
+        return items;
     }
-    auto makeEmojiMessage(EmojiMap &emojiMap)
+    std::vector<Item> makeEmojiItems(EmojiMap &emojiMap)
     {
-        MessageBuilder builder;
-        builder->flags.set(MessageFlag::Centered);
-        builder->flags.set(MessageFlag::DisableCompactEmotes);
-
-        emojiMap.each([&builder](const auto &key, const auto &value) {
-            builder
-                .emplace<EmoteElement>(
-                    value->emote,
-                    MessageElementFlags{MessageElementFlag::AlwaysShow,
-                                        MessageElementFlag::EmojiAll})
-                ->setLink(Link(Link::Type::InsertText,
-                               ":" + value->shortCodes[0] + ":"));
+        std::vector<Item> items;
+        emojiMap.each([&items](const auto &key, const auto &value) {
+            items.push_back({value->emote, ":" + value->shortCodes[0] + ":"});
         });
-
-        return builder.release();
+        return items;
     }
     void addEmoteSets(
-        std::vector<std::shared_ptr<TwitchAccount::EmoteSet>> sets,
-        Channel &globalChannel, Channel &subChannel, QString currentChannelName)
+        const std::vector<std::shared_ptr<TwitchAccount::EmoteSet>> &sets,
+        std::vector<Section> &globalSections,
+        std::vector<Section> &subSections, const QString &currentChannelName)
     {
-        QMap<QString, QPair<bool, std::vector<MessagePtr>>> mapOfSets;
+        // the sets of a channel are shown in one section, the bool is true
+        // for the global twitch emotes
+        std::map<QString, std::pair<bool, Section>> sectionOfChannel;
 
         for (const auto &set : sets)
         {
@@ -97,62 +64,42 @@ namespace {
                 continue;
             }
 
-            // TITLE
-            auto channelName = set->channelName;
-            auto text = set->text.isEmpty() ? "Twitch" : set->text;
-
-            // EMOTES
-            MessageBuilder builder;
-            builder->flags.set(MessageFlag::Centered);
-            builder->flags.set(MessageFlag::DisableCompactEmotes);
-
-            // If value of map is empty, create init pair and add title.
-            if (mapOfSets.find(channelName) == mapOfSets.end())
+            auto it = sectionOfChannel.find(set->channelName);
+            if (it == sectionOfChannel.end())
             {
-                std::vector<MessagePtr> b;
-                b.push_back(makeTitleMessage(text));
-                mapOfSets[channelName] = qMakePair(set->key == "0", b);
+                Section section;
+                section.title = set->text.isEmpty() ? "Twitch" : set->text;
+                it = sectionOfChannel
+                         .emplace(set->channelName,
+                                  std::make_pair(set->key == "0",
+                                                 std::move(section)))
+                         .first;
             }
 
+            auto &items = it->second.second.items;
             for (const auto &emote : set->emotes)
             {
-                builder
-                    .emplace<EmoteElement>(
-                        getApp()->emotes->twitch.getOrCreateEmote(emote.id,
-                                                                  emote.name),
-                        MessageElementFlags{MessageElementFlag::AlwaysShow,
-                                            MessageElementFlag::TwitchEmote})
-                    ->setLink(Link(Link::InsertText, emote.name.string));
+                items.push_back(
+                    {getApp()->emotes->twitch.getOrCreateEmote(emote.id,
+                                                               emote.name),
+                     emote.name.string});
             }
-
-            mapOfSets[channelName].second.push_back(builder.release());
         }
 
-        // Output to channel all created messages,
-        // That contain title or emotes.
         // Put current channel emotes at the top
-        auto currentChannelPair = mapOfSets[currentChannelName];
-        for (auto message : currentChannelPair.second)
+        auto current = sectionOfChannel.find(currentChannelName);
+        if (current != sectionOfChannel.end())
         {
-            subChannel.addMessage(message);
+            subSections.push_back(std::move(current->second.second));
+            sectionOfChannel.erase(current);
         }
-        mapOfSets.remove(currentChannelName);
 
-        foreach (auto pair, mapOfSets)
+        for (auto &entry : sectionOfChannel)
         {
-            auto &channel = pair.first ? globalChannel : subChannel;
-            for (auto message : pair.second)
-            {
-                channel.addMessage(message);
-            }
+            auto &sections = entry.second.first ? globalSections : subSections;
+            sections.push_back(std::move(entry.second.second));
         }
     }
-    void addEmotes(Channel &channel, const EmoteMap &map, const QString &title,
-                   const MessageElementFlag &emoteFlag)
-    {
-        channel.addMessage(makeTitleMessage(title));
-        channel.addMessage(makeEmoteMessage(map, emoteFlag));
-    };
 }  // namespace
 
 EmotePopup::EmotePopup(QWidget *parent)
@@ -193,12 +140,7 @@ EmotePopup::EmotePopup(QWidget *parent)
     };
 
     auto makeView = [&](QString tabTitle, bool addToNotebook = true) {
-        auto view = new ChannelView();
-
-        view->setOverrideFlags(MessageElementFlags{
-            MessageElementFlag::Default, MessageElementFlag::AlwaysShow,
-            MessageElementFlag::EmoteImages});
-        view->setEnableScrollingToBottom(false);
+        auto view = new EmoteGrid();
         view->linkClicked.connect(clicked);
 
         if (addToNotebook)
@@ -222,13 +164,11 @@ EmotePopup::EmotePopup(QWidget *parent)
     this->globalEmotesView_ = makeView("Global");
     this->viewEmojis_ = makeView("Emojis");
 
-    this->loadEmojis(*this->viewEmojis_, getApp()->emotes->emojis.emojis);
+    this->viewEmojis_->setSections(
+        {Section{"", makeEmojiItems(getApp()->emotes->emojis.emojis)}});
+    this->buildSearchIndex();
+
     this->addShortcuts();
-    this->signalHolder_.managedConnect(getApp()->hotkeys->onItemsUpdated,
-                                       [this]() {
-                                           this->clearShortcuts();
-                                           this->addShortcuts();
-                                       });
 
     this->search_->setFocus();
 }
@@ -293,10 +233,14 @@ void EmotePopup::addShortcuts()
                  return "scrollPage hotkey called without arguments!";
              }
              auto direction = arguments.at(0);
-             auto channelView = dynamic_cast<ChannelView *>(
-                 this->notebook_->getSelectedPage());
+             auto emoteGrid =
+                 dynamic_cast<EmoteGrid *>(this->notebook_->getSelectedPage());
+             if (emoteGrid == nullptr)
+             {
+                 return "";
+             }
 
-             auto &scrollbar = channelView->getScrollBar();
+             auto &scrollbar = emoteGrid->getScrollBar();
              if (direction == "up")
              {
                  scrollbar.offset(-scrollbar.getLargeChange());
@@ -335,118 +279,104 @@ void EmotePopup::loadChannel(ChannelPtr channel)
 
     this->setWindowTitle("Emotes in #" + this->channel_->getName());
 
+    this->buildSearchIndex();
+
     if (this->twitchChannel_ == nullptr)
     {
         return;
     }
 
-    auto subChannel = std::make_shared<Channel>("", Channel::Type::None);
-    auto globalChannel = std::make_shared<Channel>("", Channel::Type::None);
-    auto channelChannel = std::make_shared<Channel>("", Channel::Type::None);
+    std::vector<Section> subSections;
+    std::vector<Section> globalSections;
+    std::vector<Section> channelSections;
 
     // twitch
     addEmoteSets(
         getApp()->accounts->twitch.getCurrent()->accessEmotes()->emoteSets,
-        *globalChannel, *subChannel, this->channel_->getName());
+        globalSections, subSections, this->channel_->getName());
 
     // global
-    addEmotes(*globalChannel, *getApp()->twitch->getBttvEmotes().emotes(),
-              "BetterTTV", MessageElementFlag::BttvEmote);
-    addEmotes(*globalChannel, *getApp()->twitch->getFfzEmotes().emotes(),
-              "FrankerFaceZ", MessageElementFlag::FfzEmote);
+    globalSections.push_back(
+        {"BetterTTV", makeItems(*getApp()->twitch->getBttvEmotes().emotes())});
+    globalSections.push_back(
+        {"FrankerFaceZ",
+         makeItems(*getApp()->twitch->getFfzEmotes().emotes())});
 
     // channel
-    addEmotes(*channelChannel, *this->twitchChannel_->bttvEmotes(), "BetterTTV",
-              MessageElementFlag::BttvEmote);
-    addEmotes(*channelChannel, *this->twitchChannel_->ffzEmotes(),
-              "FrankerFaceZ", MessageElementFlag::FfzEmote);
+    channelSections.push_back(
+        {"BetterTTV", makeItems(*this->twitchChannel_->bttvEmotes())});
+    channelSections.push_back(
+        {"FrankerFaceZ", makeItems(*this->twitchChannel_->ffzEmotes())});
 
-    this->globalEmotesView_->setChannel(globalChannel);
-    this->subEmotesView_->setChannel(subChannel);
-    this->channelEmotesView_->setChannel(channelChannel);
-
-    if (subChannel->getMessageSnapshot().size() == 0)
+    if (subSections.empty())
     {
-        MessageBuilder builder;
-        builder->flags.set(MessageFlag::Centered);
-        builder->flags.set(MessageFlag::DisableCompactEmotes);
-        builder.emplace<TextElement>("no subscription emotes available",
-                                     MessageElementFlag::Text,
-                                     MessageColor::System);
-        subChannel->addMessage(builder.release());
+        Section section;
+        section.emptyText = "no subscription emotes available";
+        subSections.push_back(std::move(section));
     }
-}
-
-void EmotePopup::loadEmojis(ChannelView &view, EmojiMap &emojiMap)
-{
-    ChannelPtr emojiChannel(new Channel("", Channel::Type::None));
-    emojiChannel->addMessage(makeEmojiMessage(emojiMap));
 
-    view.setChannel(emojiChannel);
+    this->globalEmotesView_->setSections(std::move(globalSections));
+    this->subEmotesView_->setSections(std::move(subSections));
+    this->channelEmotesView_->setSections(std::move(channelSections));
 }
 
-void EmotePopup::loadEmojis(Channel &channel, EmojiMap &emojiMap,
-                            const QString &title)
+void EmotePopup::buildSearchIndex()
 {
-    channel.addMessage(makeTitleMessage(title));
-    channel.addMessage(makeEmojiMessage(emojiMap));
-}
+    this->searchIndex_.clear();
+    this->searchTitles_.clear();
 
-void EmotePopup::filterTwitchEmotes(std::shared_ptr<Channel> searchChannel,
-                                    const QString &searchText)
-{
-    auto twitchEmoteSets =
-        getApp()->accounts->twitch.getCurrent()->accessEmotes()->emoteSets;
-    std::vector<std::shared_ptr<TwitchAccount::EmoteSet>> twitchGlobalEmotes{};
+    auto addSection = [this](const QString &title,
+                             const std::vector<Item> &items) {
+        auto section = this->searchTitles_.size();
+        this->searchTitles_.push_back(title);
 
-    for (const auto &set : twitchEmoteSets)
-    {
-        auto setCopy = std::make_shared<TwitchAccount::EmoteSet>(*set);
-        auto setIt =
-            std::remove_if(setCopy->emotes.begin(), setCopy->emotes.end(),
-                           [searchText](auto &emote) {
-                               return !emote.name.string.contains(
-                                   searchText, Qt::CaseInsensitive);
-                           });
-        setCopy->emotes.resize(std::distance(setCopy->emotes.begin(), setIt));
-
-        if (setCopy->emotes.size() > 0)
-            twitchGlobalEmotes.push_back(setCopy);
-    }
+        for (const auto &item : items)
+        {
+            this->searchIndex_.push_back({item.text.toLower(), section, item});
+        }
+    };
 
-    auto bttvGlobalEmotes = this->filterEmoteMap(
-        searchText, getApp()->twitch->getBttvEmotes().emotes());
-    auto ffzGlobalEmotes = this->filterEmoteMap(
-        searchText, getApp()->twitch->getFfzEmotes().emotes());
+    // true in special channels like /mentions
+    if (this->channel_ && this->channel_->isTwitchChannel())
+    {
+        std::vector<Section> twitchSections;
+        addEmoteSets(
+            getApp()->accounts->twitch.getCurrent()->accessEmotes()->emoteSets,
+            twitchSections, twitchSections, this->channel_->getName());
+        for (const auto &section : twitchSections)
+        {
+            addSection(section.title, section.items);
+        }
 
-    // twitch
-    addEmoteSets(twitchGlobalEmotes, *searchChannel, *searchChannel,
-                 this->channel_->getName());
+        addSection("BetterTTV (Global)",
+                   makeItems(*getApp()->twitch->getBttvEmotes().emotes()));
+        addSection("FrankerFaceZ (Global)",
+                   makeItems(*getApp()->twitch->getFfzEmotes().emotes()));
+    }
 
-    // global
-    if (bttvGlobalEmotes->size() > 0)
-        addEmotes(*searchChannel, *bttvGlobalEmotes, "BetterTTV (Global)",
-                  MessageElementFlag::BttvEmote);
-    if (ffzGlobalEmotes->size() > 0)
-        addEmotes(*searchChannel, *ffzGlobalEmotes, "FrankerFaceZ (Global)",
-                  MessageElementFlag::FfzEmote);
-
-    if (!this->twitchChannel_)
+    if (this->twitchChannel_)
     {
-        return;
+        addSection("BetterTTV (Channel)",
+                   makeItems(*this->twitchChannel_->bttvEmotes()));
+        addSection("FrankerFaceZ (Channel)",
+                   makeItems(*this->twitchChannel_->ffzEmotes()));
     }
 
-    auto bttvChannelEmotes =
-        this->filterEmoteMap(searchText, this->twitchChannel_->bttvEmotes());
-    auto ffzChannelEmotes =
-        this->filterEmoteMap(searchText, this->twitchChannel_->ffzEmotes());
-    // channel
-    if (bttvChannelEmotes->size() > 0)
-        addEmotes(*searchChannel, *bttvChannelEmotes, "BetterTTV (Channel)",
-                  MessageElementFlag::BttvEmote);
-    if (ffzChannelEmotes->size() > 0)
-        addEmotes(*searchChannel, *ffzChannelEmotes, "FrankerFaceZ (Channel)",
-                  MessageElementFlag::FfzEmote);
+    // emojis are searched by their short code, without the colons
+    auto emojiSection = this->searchTitles_.size();
+    this->searchTitles_.push_back("Emojis");
+    getApp()->emotes->emojis.emojis.each(
+        [&](const auto &name, const std::shared_ptr<EmojiData> &emoji) {
+            this->searchIndex_.push_back(
+                {emoji->shortCodes[0].toLower(),
+                 emojiSection,
+                 {emoji->emote, ":" + emoji->shortCodes[0] + ":"}});
+        });
+
+    std::sort(this->searchIndex_.begin(), this->searchIndex_.end(),
+              [](const IndexedEmote &l, const IndexedEmote &r) {
+                  return l.name < r.name;
+              });
 }
 
 void EmotePopup::filterEmotes(const QString &searchText)
@@ -458,51 +388,53 @@ void EmotePopup::filterEmotes(const QString &searchText)
 
         return;
     }
-    auto searchChannel = std::make_shared<Channel>("", Channel::Type::None);
 
-    // true in special channels like /mentions
-    if (this->channel_->isTwitchChannel())
+    auto query = searchText.toLower();
+    auto begin = this->searchIndex_.cbegin();
+    auto end = this->searchIndex_.cend();
+
+    std::vector<Section> sections(this->searchTitles_.size());
+    for (size_t i = 0; i < sections.size(); i++)
     {
-        this->filterTwitchEmotes(searchChannel, searchText);
+        sections[i].title = this->searchTitles_[i];
     }
 
-    EmojiMap filteredEmojis{};
-    int emojiCount = 0;
+    // the emotes starting with the query are a range of the sorted index,
+    // they are shown before the ones which only contain it
+    auto prefixBegin =
+        std::lower_bound(begin, end, query,
+                         [](const IndexedEmote &emote, const QString &query) {
+                             return emote.name < query;
+                         });
+    auto prefixEnd = prefixBegin;
+    for (; prefixEnd != end && prefixEnd->name.startsWith(query); prefixEnd++)
+    {
+        sections[prefixEnd->section].items.push_back(prefixEnd->item);
+    }
 
-    getApp()->emotes->emojis.emojis.each(
-        [&, searchText](const auto &name, std::shared_ptr<EmojiData> &emoji) {
-            if (emoji->shortCodes[0].contains(searchText, Qt::CaseInsensitive))
+    auto addContaining = [&](auto first, auto last) {
+        for (auto it = first; it != last; it++)
+        {
+            if (it->name.contains(query))
             {
-                filteredEmojis.insert(name, emoji);
-                emojiCount++;
+                sections[it->section].items.push_back(it->item);
             }
-        });
-    // emojis
-    if (emojiCount > 0)
-        this->loadEmojis(*searchChannel, filteredEmojis, "Emojis");
+        }
+    };
+    addContaining(begin, prefixBegin);
+    addContaining(prefixEnd, end);
 
-    this->searchView_->setChannel(searchChannel);
+    sections.erase(std::remove_if(sections.begin(), sections.end(),
+                                  [](const Section &section) {
+                                      return section.items.empty();
+                                  }),
+                   sections.end());
+    this->searchView_->setSections(std::move(sections));
 
     this->notebook_->hide();
     this->searchView_->show();
 }
 
-EmoteMap *EmotePopup::filterEmoteMap(const QString &text,
-                                     std::shared_ptr<const EmoteMap> emotes)
-{
-    auto filteredMap = new EmoteMap();
-
-    for (const auto &emote : *emotes)
-    {
-        if (emote.first.string.contains(text, Qt::CaseInsensitive))
-        {
-            filteredMap->insert(emote);
-        }
-    }
-
-    return filteredMap;
-}
-
 void EmotePopup::closeEvent(QCloseEvent *event)
 {
     getApp()->windows->setEmotePopupPos(this->pos());
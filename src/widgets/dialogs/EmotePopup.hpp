@@ -4,6 +4,7 @@
 #include "providers/twitch/TwitchChannel.hpp"
 #include "widgets/BasePopup.hpp"
 #include "widgets/Notebook.hpp"
+#include "widgets/helper/EmoteGrid.hpp"
 
 #include <pajlada/signals/signal.hpp>
 
@@ -12,7 +13,6 @@
 namespace chatterino {
 
 struct Link;
-class ChannelView;
 class Channel;
 using ChannelPtr = std::shared_ptr<Channel>;
 
@@ -28,15 +28,15 @@ public:
     pajlada::Signals::Signal<Link> linkClicked;
 
 private:
-    ChannelView *globalEmotesView_{};
-    ChannelView *channelEmotesView_{};
-    ChannelView *subEmotesView_{};
-    ChannelView *viewEmojis_{};
+    EmoteGrid *globalEmotesView_{};
+    EmoteGrid *channelEmotesView_{};
+    EmoteGrid *subEmotesView_{};
+    EmoteGrid *viewEmojis_{};
     /**
      * @brief Visible only when the user has specified a search query into the `search_` input.
      * Otherwise the `notebook_` and all other views are visible.
      */
-    ChannelView *searchView_{};
+    EmoteGrid *searchView_{};
 
     ChannelPtr channel_;
     TwitchChannel *twitchChannel_{};
@@ -44,13 +44,21 @@ private:
     QLineEdit *search_;
     Notebook *notebook_;
 
-    void loadEmojis(ChannelView &view, EmojiMap &emojiMap);
-    void loadEmojis(Channel &channel, EmojiMap &emojiMap, const QString &title);
-    void filterTwitchEmotes(std::shared_ptr<Channel> searchChannel,
-                            const QString &searchText);
+    struct IndexedEmote {
+        // lowercase, the index is sorted by it
+        QString name;
+        // index into searchTitles_
+        size_t section;
+        EmoteGrid::Item item;
+    };
+
+    /// All emotes that can be searched, built when a channel is loaded so
+    /// typing doesn't copy or sort any emote map.
+    std::vector<IndexedEmote> searchIndex_;
+    std::vector<QString> searchTitles_;
+
+    void buildSearchIndex();
     void filterEmotes(const QString &text);
-    EmoteMap *filterEmoteMap(const QString &text,
-                             std::shared_ptr<const EmoteMap> emotes);
     void addShortcuts() override;
 };
 
@@ -359,15 +359,15 @@ IndirectChannel SelectChannelDialog::getSelectedChannel() const
             }
             else if (this->ui_.twitch.mentions->isChecked())
             {
-                return app->twitch->mentionsChannel;
+                return ChannelPtr(app->twitch->mentionsChannel);
             }
             else if (this->ui_.twitch.whispers->isChecked())
             {
-                return app->twitch->whispersChannel;
+                return ChannelPtr(app->twitch->whispersChannel);
             }
             else if (this->ui_.twitch.live->isChecked())
             {
-                return app->twitch->liveChannel;
+                return ChannelPtr(app->twitch->liveChannel);
             }
         }
         break;
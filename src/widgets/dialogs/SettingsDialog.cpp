@@ -5,6 +5,7 @@
 #include "controllers/commands/CommandController.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
 #include "singletons/Resources.hpp"
+#include "singletons/Settings.hpp"
 #include "util/LayoutCreator.hpp"
 #include "widgets/helper/Button.hpp"
 #include "widgets/settingspages/AboutPage.hpp"
@@ -45,11 +46,6 @@ SettingsDialog::SettingsDialog(QWidget *parent)
     this->setWindowFlags(this->windowFlags() &
                          ~Qt::WindowContextHelpButtonHint);
     this->addShortcuts();
-    this->signalHolder_.managedConnect(getApp()->hotkeys->onItemsUpdated,
-                                       [this]() {
-                                           this->clearShortcuts();
-                                           this->addShortcuts();
-                                       });
 }
 
 void SettingsDialog::addShortcuts()
@@ -357,7 +353,7 @@ void SettingsDialog::onOkClicked()
     if (!getArgs().dontSaveSettings)
     {
         getApp()->commands->save();
-        pajlada::Settings::SettingManager::gSave();
+        getSettings()->queueSave();
     }
     this->close();
 }
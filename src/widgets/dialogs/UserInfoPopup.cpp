@@ -17,6 +17,7 @@
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "singletons/WindowManager.hpp"
+#include "util/CaseInsensitive.hpp"
 #include "util/Clipboard.hpp"
 #include "util/Helpers.hpp"
 #include "util/LayoutCreator.hpp"
@@ -74,30 +75,27 @@ namespace {
         if (message->flags.has(MessageFlag::Whisper))
             return false;
 
-        bool isSubscription = message->flags.has(MessageFlag::Subscription) &&
-                              message->loginName.isEmpty() &&
-                              message->messageText.split(" ").at(0).compare(
-                                  userName, Qt::CaseInsensitive) == 0;
+        // the first word of the text is the user name
+        bool isSubscription =
+            message->flags.has(MessageFlag::Subscription) &&
+            message->loginName.isEmpty() &&
+            equalsIgnoreCase(message->messageText.leftRef(
+                                 message->messageText.indexOf(' ')),
+                             userName);
 
-        bool isModAction =
-            message->timeoutUser.compare(userName, Qt::CaseInsensitive) == 0;
-        bool isSelectedUser =
-            message->loginName.compare(userName, Qt::CaseInsensitive) == 0;
+        bool isModAction = equalsIgnoreCase(message->timeoutUser, userName);
+        bool isSelectedUser = equalsIgnoreCase(message->loginName, userName);
 
         return (isSubscription || isModAction || isSelectedUser);
     }
 
     ChannelPtr filterMessages(const QString &userName, ChannelPtr channel)
     {
-        LimitedQueueSnapshot<MessagePtr> snapshot =
-            channel->getMessageSnapshot();
-
         ChannelPtr channelPtr(
             new Channel(channel->getName(), Channel::Type::None));
 
-        for (size_t i = 0; i < snapshot.size(); i++)
+        for (const auto &message : channel->findMessagesByUser(userName))
         {
-            MessagePtr message = snapshot[i];
             if (checkMessageUserName(userName, message))
             {
                 channelPtr->addMessage(message);
@@ -731,26 +729,41 @@ void UserInfoPopup::updateLatestMessages()
     // shrink dialog in case ChannelView goes from visible to hidden
     this->adjustSize();
 
-    this->refreshConnection_ =
+    // the view over the source channel delivers them in batches
+    this->refreshConnections_.clear();
+    this->refreshConnections_.push_back(
         std::make_unique<pajlada::Signals::ScopedConnection>(
             this->underlyingChannel_->messageAppended.connect(
-                [this, hasMessages](auto message, auto) {
-                    if (!checkMessageUserName(this->userName_, message))
-                        return;
-
-                    if (hasMessages)
-                    {
-                        // display message in ChannelView
-                        this->ui_.latestMessages->channel()->addMessage(
-                            message);
-                    }
-                    else
+                [this](auto message, auto) {
+                    this->appendLatestMessage(message);
+                })));
+    this->refreshConnections_.push_back(
+        std::make_unique<pajlada::Signals::ScopedConnection>(
+            this->underlyingChannel_->messagesAppended.connect(
+                [this](auto &messages) {
+                    for (const auto &appended : messages)
                     {
-                        // The ChannelView is currently hidden, so manually refresh
-                        // and display the latest messages
-                        this->updateLatestMessages();
+                        this->appendLatestMessage(appended.message);
                     }
-                }));
+                })));
+}
+
+void UserInfoPopup::appendLatestMessage(const MessagePtr &message)
+{
+    if (!checkMessageUserName(this->userName_, message))
+    {
+        return;
+    }
+
+    // the view shares the message with the source channel
+    this->ui_.latestMessages->channel()->addMessage(message);
+
+    if (this->ui_.latestMessages->isHidden())
+    {
+        this->ui_.latestMessages->setVisible(true);
+        this->ui_.noMessagesLabel->setVisible(false);
+        this->adjustSize();
+    }
 }
 
 void UserInfoPopup::updateUserData()
@@ -836,13 +849,7 @@ void UserInfoPopup::updateUserData()
             });
 
         // get ignore state
-        bool isIgnoring = false;
-
-        if (auto blocks = currentUser->accessBlockedUserIds();
-            blocks->find(user.id) != blocks->end())
-        {
-            isIgnoring = true;
-        }
+        bool isIgnoring = currentUser->isBlocked(user.id);
 
         // get ignoreHighlights state
         bool isIgnoringHighlights = false;
@@ -38,6 +38,7 @@ private:
     void installEvents();
     void updateUserData();
     void updateLatestMessages();
+    void appendLatestMessage(const MessagePtr &message);
 
     void loadAvatar(const QUrl &url);
     bool isMod_;
@@ -66,7 +67,8 @@ private:
 
     pajlada::Signals::NoArgSignal userStateChanged_;
 
-    std::unique_ptr<pajlada::Signals::ScopedConnection> refreshConnection_;
+    std::vector<std::unique_ptr<pajlada::Signals::ScopedConnection>>
+        refreshConnections_;
 
     std::shared_ptr<bool> hack_;
 
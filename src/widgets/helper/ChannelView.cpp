@@ -4,22 +4,31 @@
 #include <QDate>
 #include <QDebug>
 #include <QDesktopServices>
+#include <QElapsedTimer>
+#include <QFileDialog>
+#include <QFontDatabase>
 #include <QGraphicsBlurEffect>
 #include <QMessageBox>
 #include <QPainter>
+#include <QPointer>
+#include <QSaveFile>
 #include <QScreen>
+#include <QShortcut>
 #include <algorithm>
 #include <chrono>
 #include <cmath>
 #include <functional>
 #include <memory>
+#include <utility>
 
 #include "Application.hpp"
+#include "common/ChannelProjection.hpp"
 #include "common/Common.hpp"
 #include "common/QLogging.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "controllers/commands/CommandController.hpp"
 #include "debug/Benchmark.hpp"
+#include "debug/Trace.hpp"
 #include "messages/Emote.hpp"
 #include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/Message.hpp"
@@ -28,6 +37,7 @@
 #include "messages/layouts/MessageLayout.hpp"
 #include "messages/layouts/MessageLayoutElement.hpp"
 #include "providers/LinkResolver.hpp"
+#include "providers/twitch/IrcReplay.hpp"
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Resources.hpp"
@@ -37,8 +47,10 @@
 #include "singletons/WindowManager.hpp"
 #include "util/Clipboard.hpp"
 #include "util/DistanceBetweenPoints.hpp"
+#include "util/FrameScheduler.hpp"
 #include "util/Helpers.hpp"
 #include "util/IncognitoBrowser.hpp"
+#include "util/PoolAllocator.hpp"
 #include "util/StreamerMode.hpp"
 #include "util/Twitch.hpp"
 #include "widgets/Scrollbar.hpp"
@@ -46,6 +58,7 @@
 #include "widgets/Window.hpp"
 #include "widgets/dialogs/SettingsDialog.hpp"
 #include "widgets/dialogs/UserInfoPopup.hpp"
+#include "widgets/helper/ChannelViewSurface.hpp"
 #include "widgets/helper/EffectLabel.hpp"
 #include "widgets/helper/SearchPopup.hpp"
 #include "widgets/splits/Split.hpp"
@@ -54,6 +67,8 @@
 #define DRAW_WIDTH (this->width())
 #define SELECTION_RESUME_SCROLLING_MSG_THRESHOLD 3
 #define CHAT_HOVER_PAUSE_DURATION 1000
+// how long the cursor has to rest on a link before its info is loaded
+#define LINK_INFO_DELAY_MS 150
 
 namespace chatterino {
 namespace {
@@ -129,6 +144,12 @@ ChannelView::ChannelView(BaseWidget *parent)
     this->initializeScrollbar();
     this->initializeSignals();
 
+    if (getSettings()->openGLRendering)
+    {
+        this->surface_ = new ChannelViewSurface(this);
+        this->surface_->lower();
+    }
+
     this->cursors_.neutral = QCursor(getResources().scrolling.neutralScroll);
     this->cursors_.up = QCursor(getResources().scrolling.upScroll);
     this->cursors_.down = QCursor(getResources().scrolling.downScroll);
@@ -155,6 +176,40 @@ ChannelView::ChannelView(BaseWidget *parent)
     QObject::connect(&this->scrollTimer_, &QTimer::timeout, this,
                      &ChannelView::scrollUpdateRequested);
 
+    this->linkInfoTimer_.setSingleShot(true);
+    this->linkInfoTimer_.setInterval(LINK_INFO_DELAY_MS);
+    QObject::connect(&this->linkInfoTimer_, &QTimer::timeout, this, [this] {
+        auto layout = this->linkInfoLayout_.lock();
+        const auto *element = this->linkInfoElement_;
+        // the cursor moved on or another view resolved it meanwhile
+        if (!layout || element != this->tooltipState_.element ||
+            element->getTooltip() != "No link info loaded")
+        {
+            return;
+        }
+
+        std::weak_ptr<MessageLayout> weakLayout = layout;
+        QPointer<ChannelView> self = this;
+        LinkResolver::getLinkInfo(
+            element->getLink().value, nullptr,
+            [weakLayout, element, self](QString tooltipText,
+                                        Link originalLink,
+                                        ImagePtr thumbnail) {
+                auto shared = weakLayout.lock();
+                if (!shared)
+                    return;
+                element->setTooltip(tooltipText);
+                element->setThumbnail(thumbnail);
+
+                // show it without waiting for the next mouse move
+                if (self && self->tooltipState_.element == element)
+                {
+                    self->hover_.pending = true;
+                    self->processHover();
+                }
+            });
+    });
+
     this->setFocusPolicy(Qt::FocusPolicy::StrongFocus);
 }
 
@@ -177,7 +232,7 @@ void ChannelView::initializeLayout()
 void ChannelView::initializeScrollbar()
 {
     this->scrollBar_->getCurrentValueChanged().connect([this] {
-        this->performLayout(true);
+        this->queueLayout(true);
         this->queueUpdate();
     });
 }
@@ -187,24 +242,26 @@ void ChannelView::initializeSignals()
     this->signalHolder_.managedConnect(getApp()->windows->wordFlagsChanged,
                                        [this] {
                                            this->queueLayout();
-                                           this->update();
+                                           this->queueUpdate();
                                        });
 
     getSettings()->showLastMessageIndicator.connect(
         [this](auto, auto) {
-            this->update();
+            this->queueUpdate();
         },
         this->signalHolder_);
 
-    this->signalHolder_.managedConnect(getApp()->windows->gifRepaintRequested,
-                                       [&] {
-                                           this->queueUpdate();
-                                       });
+    this->signalHolder_.managedConnect(
+        getApp()->windows->gifRepaintRequested, [&] {
+            if (!this->animatedRegion_.isEmpty())
+            {
+                this->queueUpdate(this->animatedRegion_);
+            }
+        });
 
     this->signalHolder_.managedConnect(
         getApp()->windows->layoutRequested, [&](Channel *channel) {
-            if (this->isVisible() &&
-                (channel == nullptr || this->channel_.get() == channel))
+            if (channel == nullptr || this->channel_.get() == channel)
             {
                 this->queueLayout();
             }
@@ -353,32 +410,68 @@ void ChannelView::scaleChangedEvent(float scale)
 
 void ChannelView::queueUpdate()
 {
-    //    if (this->updateTimer.isActive()) {
-    //        this->updateQueued = true;
-    //        return;
-    //    }
+    this->queueUpdate(this->rect());
+}
 
-    //    this->repaint();
+void ChannelView::queueUpdate(const QRegion &region)
+{
+    // All updates until the next frame are painted at once
+    this->updateRegion_ += region;
 
-    this->update();
+    FrameScheduler::instance().request(this, FrameStage::Paint, [this] {
+        auto region = std::exchange(this->updateRegion_, QRegion());
+        if (this->surface_ != nullptr)
+        {
+            // the surface is always drawn completely
+            this->surface_->update();
+        }
+        else
+        {
+            this->update(region);
+        }
+    });
+}
 
-    //    this->updateTimer.start();
+void ChannelView::queueLayout(bool causedByScrollbar)
+{
+    // All layout requests until the next frame are merged into a single
+    // layout. paintEvent performs it right away if it's still pending.
+    this->layoutCausedByScrollbar_ =
+        this->layoutCausedByScrollbar_ || causedByScrollbar;
+    this->layoutDirty_ = this->layoutDirty_ || !causedByScrollbar;
+    if (!this->shown_)
+    {
+        this->layoutDeferred_ = true;
+        return;
+    }
+    this->scheduleLayout();
 }
 
-void ChannelView::queueLayout()
+void ChannelView::scheduleLayout()
 {
-    //    if (!this->layoutCooldown->isActive()) {
-    this->performLayout();
+    if (this->layoutQueued_)
+    {
+        return;
+    }
+    this->layoutQueued_ = true;
 
-    //        this->layoutCooldown->start();
-    //    } else {
-    //        this->layoutQueued = true;
-    //    }
+    FrameScheduler::instance().request(this, FrameStage::Layout, [this] {
+        if (this->layoutQueued_)
+        {
+            this->performLayout(this->layoutCausedByScrollbar_);
+        }
+    });
 }
 
 void ChannelView::performLayout(bool causedByScrollbar)
 {
-    // BenchmarkGuard benchmark("layout");
+    CHATTERINO_TRACE_SCOPE("ChannelView::performLayout");
+
+    QElapsedTimer timer;
+    timer.start();
+
+    this->layoutQueued_ = false;
+    this->layoutCausedByScrollbar_ = false;
 
     /// Get messages and check if there are at least 1
     auto messages = this->getMessagesSnapshot();
@@ -386,15 +479,48 @@ void ChannelView::performLayout(bool causedByScrollbar)
     this->showingLatestMessages_ =
         this->scrollBar_->isAtBottom() || !this->scrollBar_->isVisible();
 
+    LayoutState state{this->getLayoutWidth(),
+                      this->height(),
+                      this->scale(),
+                      this->getFlags(),
+                      getApp()->windows->getGeneration(),
+                      messages.size()};
+    // Scrolling only moves the messages, the ones that were on screen keep
+    // their layouts and buffers, only the ones entering the view are laid
+    // out. The scrollbar's range stays the same.
+    bool onlyScrolled = causedByScrollbar && !this->layoutDirty_ &&
+                        state == this->lastLayoutState_;
+    this->layoutDirty_ = false;
+    this->lastLayoutState_ = state;
+
     /// Layout visible messages
     this->layoutVisibleMessages(messages);
 
     /// Update scrollbar
-    this->updateScrollbar(messages, causedByScrollbar);
+    if (!onlyScrolled)
+    {
+        this->updateScrollbar(messages, causedByScrollbar);
+    }
 
     this->goToBottom_->setVisible(this->enableScrollingToBottom_ &&
                                   this->scrollBar_->isVisible() &&
                                   !this->scrollBar_->isAtBottom());
+
+    /// Layout the messages around the visible ones later
+    this->backgroundLayoutPosition_ = 0;
+    if (this->isVisible())
+    {
+        FrameScheduler::instance().requestBackground(this, [this] {
+            return this->layoutBackgroundMessages();
+        });
+    }
+
+    auto elapsed = timer.nsecsElapsed();
+    IrcReplay::instance().addLayoutTime(elapsed);
+    if (this->performance_)
+    {
+        this->performance_->layoutNsecs += elapsed;
+    }
 }
 
 void ChannelView::layoutVisibleMessages(
@@ -410,12 +536,12 @@ void ChannelView::layoutVisibleMessages(
         auto y = int(-(messages[start]->getHeight() *
                        (fmod(this->scrollBar_->getCurrentValue(), 1))));
 
-        for (auto i = start; i < messages.size() && y <= this->height(); i++)
+        for (auto it = messages.begin() + std::ptrdiff_t(start);
+             it != messages.end() && y <= this->height(); ++it)
         {
-            auto message = messages[i];
+            const auto &message = *it;
 
-            redrawRequired |=
-                message->layout(layoutWidth, this->scale(), flags);
+            redrawRequired |= this->layoutMessage(message, layoutWidth, flags);
 
             y += message->getHeight();
         }
@@ -425,6 +551,98 @@ void ChannelView::layoutVisibleMessages(
         this->queueUpdate();
 }
 
+bool ChannelView::layoutBackgroundMessages()
+{
+    // amount of messages above and below the visible ones to layout
+    constexpr size_t range = 100;
+
+    auto messages = this->getMessagesSnapshot();
+    const auto start = size_t(this->scrollBar_->getCurrentValue());
+    const auto layoutWidth = this->getLayoutWidth();
+    const auto flags = this->getFlags();
+
+    // messages above the view come first, then the ones starting at the
+    // top of the view. Visible ones are already laid out and skipped
+    // quickly.
+    for (; this->backgroundLayoutPosition_ < 2 * range;
+         this->backgroundLayoutPosition_++)
+    {
+        // the rest continues in the next frame
+        if (!FrameScheduler::instance().hasTimeLeft())
+        {
+            return true;
+        }
+
+        auto position = this->backgroundLayoutPosition_;
+        if (position < range && position >= start)
+        {
+            // nothing left above the view
+            this->backgroundLayoutPosition_ = range - 1;
+            continue;
+        }
+
+        auto index = position < range ? start - 1 - position
+                                      : start + (position - range);
+        if (index >= messages.size())
+        {
+            break;
+        }
+
+        this->layoutMessage(messages[index], layoutWidth, flags);
+    }
+
+    this->releaseDistantLayouts(messages);
+    return false;
+}
+
+bool ChannelView::layoutMessage(const MessageLayoutPtr &layout, int width,
+                                MessageElementFlags flags)
+{
+    this->laidOutMessages_.insert(layout);
+    return layout->layout(width, this->scale(), flags);
+}
+
+void ChannelView::releaseDistantLayouts(
+    LimitedQueueSnapshot<MessageLayoutPtr> &messages)
+{
+    // messages above and below the view, and at the bottom, that keep their
+    // layouts
+    constexpr size_t keptRange = 200;
+    // the layouts are only released once this many are laid out
+    constexpr size_t maxLaidOut = 4 * keptRange;
+
+    if (this->laidOutMessages_.size() <= maxLaidOut)
+    {
+        return;
+    }
+
+    const auto start = size_t(this->scrollBar_->getCurrentValue());
+
+    std::unordered_set<MessageLayout *> kept;
+    auto keep = [&](size_t from, size_t to) {
+        for (auto i = from; i < std::min(to, messages.size()); i++)
+        {
+            kept.insert(messages[i].get());
+        }
+    };
+    keep(start > keptRange ? start - keptRange : 0, start + keptRange);
+    keep(messages.size() > keptRange ? messages.size() - keptRange : 0,
+         messages.size());
+
+    for (auto it = this->laidOutMessages_.begin();
+         it != this->laidOutMessages_.end();)
+    {
+        if (kept.count(it->get()) != 0)
+        {
+            ++it;
+            continue;
+        }
+
+        (*it)->releaseLayout();
+        it = this->laidOutMessages_.erase(it);
+    }
+}
+
 void ChannelView::updateScrollbar(
     LimitedQueueSnapshot<MessageLayoutPtr> &messages, bool causedByScrollbar)
 {
@@ -445,7 +663,7 @@ void ChannelView::updateScrollbar(
     {
         auto *message = messages[i].get();
 
-        message->layout(layoutWidth, this->scale(), flags);
+        this->layoutMessage(messages[i], layoutWidth, flags);
 
         h -= message->getHeight();
 
@@ -486,6 +704,7 @@ void ChannelView::clearMessages()
 {
     // Clear all stored messages in this chat widget
     this->messages_.clear();
+    this->laidOutMessages_.clear();
     this->scrollBar_->clearHighlights();
     this->queueLayout();
 
@@ -493,15 +712,55 @@ void ChannelView::clearMessages()
     this->lastMessageHasAlternateBackgroundReverse_ = true;
 }
 
+bool ChannelView::scrollToMessage(const QString &messageID)
+{
+    if (messageID.isEmpty())
+    {
+        return false;
+    }
+
+    // the proxy channel holds the same messages as the view once all appended
+    // messages are delivered
+    this->channel_->flushAppendedMessages();
+
+    auto snapshot = this->getMessagesSnapshot();
+    auto index = this->channel_->findMessageIndex(messageID);
+
+    // the snapshot of a paused view can be behind the channel
+    if (!index || *index >= snapshot.size() ||
+        snapshot[*index]->getMessage()->id != messageID)
+    {
+        index = boost::none;
+        for (size_t i = 0; i < snapshot.size(); i++)
+        {
+            if (snapshot[i]->getMessage()->id == messageID)
+            {
+                index = i;
+                break;
+            }
+        }
+    }
+
+    if (!index)
+    {
+        return false;
+    }
+
+    this->scrollBar_->setDesiredValue(
+        qreal(*index) - this->scrollBar_->getLargeChange() / 2, true);
+    this->queueLayout();
+
+    return true;
+}
+
 Scrollbar &ChannelView::getScrollBar()
 {
     return *this->scrollBar_;
 }
 
-QString ChannelView::getSelectedText()
+void ChannelView::forEachSelectedText(
+    const std::function<void(const QString &)> &fn)
 {
-    QString result = "";
-
     LimitedQueueSnapshot<MessageLayoutPtr> messagesSnapshot =
         this->getMessagesSnapshot();
 
@@ -509,26 +768,102 @@ QString ChannelView::getSelectedText()
 
     if (_selection.isEmpty())
     {
-        return result;
+        return;
     }
 
+    QString text;
     for (int msg = _selection.selectionMin.messageIndex;
          msg <= _selection.selectionMax.messageIndex; msg++)
     {
-        MessageLayoutPtr layout = messagesSnapshot[msg];
-        int from = msg == _selection.selectionMin.messageIndex
-                       ? _selection.selectionMin.charIndex
-                       : 0;
-        int to = msg == _selection.selectionMax.messageIndex
-                     ? _selection.selectionMax.charIndex
-                     : layout->getLastCharacterIndex() + 1;
+        const MessageLayoutPtr &layout = messagesSnapshot[msg];
+        bool first = msg == _selection.selectionMin.messageIndex;
+        bool last = msg == _selection.selectionMax.messageIndex;
 
-        layout->addSelectionText(result, from, to);
+        text.clear();
+        if (first || last)
+        {
+            int from = first ? _selection.selectionMin.charIndex : 0;
+            int to = last ? _selection.selectionMax.charIndex
+                          : layout->getLastCharacterIndex() + 1;
+
+            layout->addSelectionText(text, from, to);
+        }
+        else
+        {
+            // the whole message is selected, its elements have the same
+            // text without laying it out
+            layout->addMessageText(text);
+        }
+
+        fn(text);
+    }
+}
+
+QString ChannelView::getSelectedText()
+{
+    QString result = "";
+
+    Selection _selection = this->selection_;
+
+    if (_selection.isEmpty())
+    {
+        return result;
+    }
+
+    // a guess for the size, so the result isn't reallocated for every
+    // message of big selections
+    LimitedQueueSnapshot<MessageLayoutPtr> messagesSnapshot =
+        this->getMessagesSnapshot();
+    int capacity = 0;
+    for (int msg = _selection.selectionMin.messageIndex;
+         msg <= _selection.selectionMax.messageIndex; msg++)
+    {
+        capacity += messagesSnapshot[msg]->getMessage()->searchText.size() + 16;
     }
+    result.reserve(capacity);
+
+    this->forEachSelectedText([&result](const QString &text) {
+        result += text;
+    });
 
     return result;
 }
 
+void ChannelView::saveSelectionToFile()
+{
+    if (this->selection_.isEmpty())
+    {
+        return;
+    }
+
+    auto fileName = QFileDialog::getSaveFileName(
+        this, "Save selection", QString(), "Text files (*.txt)");
+    if (fileName.isEmpty())
+    {
+        return;
+    }
+
+    QSaveFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly))
+    {
+        QMessageBox::warning(this, "Save selection",
+                             "Could not open " + fileName + ": " +
+                                 file.errorString());
+        return;
+    }
+
+    this->forEachSelectedText([&file](const QString &text) {
+        file.write(text.toUtf8());
+    });
+
+    if (!file.commit())
+    {
+        QMessageBox::warning(this, "Save selection",
+                             "Could not write " + fileName + ": " +
+                                 file.errorString());
+    }
+}
+
 bool ChannelView::hasSelection()
 {
     return !this->selection_.isEmpty();
@@ -550,6 +885,11 @@ bool ChannelView::getEnableScrollingToBottom() const
     return this->enableScrollingToBottom_;
 }
 
+void ChannelView::setImagePriority(ImagePriority priority)
+{
+    this->imagePriority_ = priority;
+}
+
 void ChannelView::setOverrideFlags(boost::optional<MessageElementFlags> value)
 {
     this->overrideFlags_ = std::move(value);
@@ -589,76 +929,23 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
     this->clearMessages();
     this->scrollBar_->clearHighlights();
 
-    /// make copy of channel and expose
-    this->channel_ = std::make_unique<Channel>(underlyingChannel->getName(),
-                                               underlyingChannel->getType());
-
-    //
-    // Proxy channel connections
-    // Use a proxy channel to keep filtered messages past the time they are removed from their origin channel
-    //
-
-    this->channelConnections_.managedConnect(
-        underlyingChannel->messageAppended,
-        [this](MessagePtr &message,
-               boost::optional<MessageFlags> overridingFlags) {
-            if (this->shouldIncludeMessage(message))
-            {
-                if (this->channel_->lastDate_ != QDate::currentDate())
-                {
-                    this->channel_->lastDate_ = QDate::currentDate();
-                    auto msg = makeSystemMessage(
-                        QLocale().toString(QDate::currentDate(),
-                                           QLocale::LongFormat),
-                        QTime(0, 0));
-                    this->channel_->addMessage(msg);
-                }
-                // When the message was received in the underlyingChannel,
-                // logging will be handled. Prevent duplications.
-                if (overridingFlags)
-                {
-                    overridingFlags.get().set(MessageFlag::DoNotLog);
-                }
-                else
-                {
-                    overridingFlags = MessageFlags(message->flags);
-                    overridingFlags.get().set(MessageFlag::DoNotLog);
-                }
-
-                this->channel_->addMessage(message, overridingFlags);
-            }
-        });
-
-    this->channelConnections_.managedConnect(
-        underlyingChannel->messagesAddedAtStart,
-        [this](std::vector<MessagePtr> &messages) {
-            std::vector<MessagePtr> filtered;
-            std::copy_if(messages.begin(), messages.end(),
-                         std::back_inserter(filtered), [this](MessagePtr msg) {
-                             return this->shouldIncludeMessage(msg);
-                         });
-
-            if (!filtered.empty())
-                this->channel_->addMessagesAtStart(filtered);
-        });
-
-    this->channelConnections_.managedConnect(
-        underlyingChannel->messageReplaced,
-        [this](size_t index, MessagePtr replacement) {
-            if (this->shouldIncludeMessage(replacement))
-                this->channel_->replaceMessage(index, replacement);
-        });
+    // views of the same channel with the same filters share the messages
+    // that passed the filters
+    this->projection_ = ChannelProjection::get(underlyingChannel,
+                                               this->getFilterIds());
+    this->channel_ = this->projection_->channel();
+    // messages still waiting to be delivered are in the snapshot below
+    this->channel_->flushAppendedMessages();
 
     //
     // Standard channel connections
     //
 
-    // on new message
+    // on new messages, the projection batches them
     this->channelConnections_.managedConnect(
-        this->channel_->messageAppended,
-        [this](MessagePtr &message,
-               boost::optional<MessageFlags> overridingFlags) {
-            this->messageAppended(message, std::move(overridingFlags));
+        this->channel_->messagesAppended,
+        [this](std::vector<Channel::AppendedMessage> &messages) {
+            this->messagesAppended(messages);
         });
 
     this->channelConnections_.managedConnect(
@@ -680,13 +967,28 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
             this->messageReplaced(index, replacement);
         });
 
-    auto snapshot = underlyingChannel->getMessageSnapshot();
+    // on messages changed in place
+    this->channelConnections_.managedConnect(
+        this->channel_->messagesChanged, [this](std::vector<size_t> &indices) {
+            this->messagesChanged(indices);
+        });
 
-    for (size_t i = 0; i < snapshot.size(); i++)
-    {
-        MessageLayoutPtr deleted;
+    // the view keeps as many messages as the channel
+    this->channelConnections_.managedConnect(
+        this->channel_->messageLimitChanged, [this] {
+            this->messageLimitChanged();
+        });
+    this->messageLimitChanged();
+
+    auto snapshot = this->channel_->getMessageSnapshot();
 
-        auto messageLayout = new MessageLayout(snapshot[i]);
+    std::vector<MessageLayoutPtr> layouts;
+    std::vector<ScrollbarHighlight> highlights;
+    layouts.reserve(snapshot.size());
+
+    for (const auto &message : snapshot)
+    {
+        auto messageLayout = makePooledShared<MessageLayout>(message);
 
         if (this->lastMessageHasAlternateBackground_)
         {
@@ -700,14 +1002,16 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
             messageLayout->flags.set(MessageLayoutFlag::IgnoreHighlights);
         }
 
-        this->messages_.pushBack(MessageLayoutPtr(messageLayout), deleted);
+        layouts.push_back(std::move(messageLayout));
         if (this->showScrollbarHighlights())
         {
-            this->scrollBar_->addHighlight(
-                snapshot[i]->getScrollBarHighlight());
+            highlights.push_back(message->getScrollBarHighlight());
         }
     }
 
+    this->messages_.pushBack(layouts);
+    this->scrollBar_->addHighlights(highlights);
+
     this->underlyingChannel_ = underlyingChannel;
 
     this->queueLayout();
@@ -726,6 +1030,17 @@ void ChannelView::setChannel(ChannelPtr underlyingChannel)
 void ChannelView::setFilters(const QList<QUuid> &ids)
 {
     this->channelFilters_ = std::make_shared<FilterSet>(ids);
+
+    // the shown messages passed the old filters
+    if (this->projection_)
+    {
+        auto sorted = this->getFilterIds();
+        std::sort(sorted.begin(), sorted.end());
+        if (sorted != this->projection_->filterIds())
+        {
+            this->setChannel(this->underlyingChannel_);
+        }
+    }
 }
 
 const QList<QUuid> ChannelView::getFilterIds() const
@@ -743,21 +1058,6 @@ FilterSetPtr ChannelView::getFilterSet() const
     return this->channelFilters_;
 }
 
-bool ChannelView::shouldIncludeMessage(const MessagePtr &m) const
-{
-    if (this->channelFilters_)
-    {
-        if (getSettings()->excludeUserMessagesFromFilter &&
-            getApp()->accounts->twitch.getCurrent()->getUserName().compare(
-                m->loginName, Qt::CaseInsensitive) == 0)
-            return true;
-
-        return this->channelFilters_->filter(m, this->channel_);
-    }
-
-    return true;
-}
-
 ChannelPtr ChannelView::sourceChannel() const
 {
     return this->sourceChannel_;
@@ -773,30 +1073,14 @@ bool ChannelView::hasSourceChannel() const
     return this->sourceChannel_ != nullptr;
 }
 
-void ChannelView::messageAppended(MessagePtr &message,
-                                  boost::optional<MessageFlags> overridingFlags)
+void ChannelView::messagesAppended(
+    std::vector<Channel::AppendedMessage> &messages)
 {
-    MessageLayoutPtr deleted;
-
-    auto *messageFlags = &message->flags;
-    if (overridingFlags)
+    if (this->performance_)
     {
-        messageFlags = overridingFlags.get_ptr();
+        this->performance_->messages += int(messages.size());
     }
 
-    auto messageRef = new MessageLayout(message);
-
-    if (this->lastMessageHasAlternateBackground_)
-    {
-        messageRef->flags.set(MessageLayoutFlag::AlternateBackground);
-    }
-    if (this->channel_->shouldIgnoreHighlights())
-    {
-        messageRef->flags.set(MessageLayoutFlag::IgnoreHighlights);
-    }
-    this->lastMessageHasAlternateBackground_ =
-        !this->lastMessageHasAlternateBackground_;
-
     if (!this->scrollBar_->isAtBottom() &&
         this->scrollBar_->getCurrentValueAnimation().state() ==
             QPropertyAnimation::Running)
@@ -809,42 +1093,86 @@ void ChannelView::messageAppended(MessagePtr &message,
         loop.exec();
     }
 
-    if (this->messages_.pushBack(MessageLayoutPtr(messageRef), deleted))
+    std::vector<MessageLayoutPtr> layouts;
+    layouts.reserve(messages.size());
+
+    boost::optional<HighlightState> highlightState;
+    bool ignoreHighlights = this->channel_->shouldIgnoreHighlights();
+
+    for (auto &appended : messages)
+    {
+        const auto &message = appended.message;
+
+        auto *messageFlags = &message->flags;
+        if (appended.overridingFlags)
+        {
+            messageFlags = appended.overridingFlags.get_ptr();
+        }
+
+        auto messageRef = makePooledShared<MessageLayout>(message);
+
+        if (this->lastMessageHasAlternateBackground_)
+        {
+            messageRef->flags.set(MessageLayoutFlag::AlternateBackground);
+        }
+        if (ignoreHighlights)
+        {
+            messageRef->flags.set(MessageLayoutFlag::IgnoreHighlights);
+        }
+        this->lastMessageHasAlternateBackground_ =
+            !this->lastMessageHasAlternateBackground_;
+
+        layouts.push_back(std::move(messageRef));
+
+        if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+        {
+            if (messageFlags->has(MessageFlag::Highlighted) &&
+                messageFlags->has(MessageFlag::ShowInMentions) &&
+                !messageFlags->has(MessageFlag::Subscription) &&
+                (getSettings()->highlightMentions ||
+                 this->channel_->getType() != Channel::Type::TwitchMentions))
+
+            {
+                highlightState = HighlightState::Highlighted;
+            }
+            else if (!highlightState)
+            {
+                highlightState = HighlightState::NewMessage;
+            }
+        }
+    }
+
+    if (auto removed = this->messages_.pushBack(layouts))
     {
         if (this->paused())
         {
             if (!this->scrollBar_->isAtBottom())
-                this->pauseScrollOffset_--;
+                this->pauseScrollOffset_ -= int(removed);
         }
         else
         {
             if (this->scrollBar_->isAtBottom())
                 this->scrollBar_->scrollToBottom();
             else
-                this->scrollBar_->offset(-1);
+                this->scrollBar_->offset(-qreal(removed));
         }
     }
 
-    if (!messageFlags->has(MessageFlag::DoNotTriggerNotification))
+    if (highlightState)
     {
-        if (messageFlags->has(MessageFlag::Highlighted) &&
-            messageFlags->has(MessageFlag::ShowInMentions) &&
-            !messageFlags->has(MessageFlag::Subscription) &&
-            (getSettings()->highlightMentions ||
-             this->channel_->getType() != Channel::Type::TwitchMentions))
-
-        {
-            this->tabHighlightRequested.invoke(HighlightState::Highlighted);
-        }
-        else
-        {
-            this->tabHighlightRequested.invoke(HighlightState::NewMessage);
-        }
+        this->tabHighlightRequested.invoke(*highlightState);
     }
 
     if (this->showScrollbarHighlights())
     {
-        this->scrollBar_->addHighlight(message->getScrollBarHighlight());
+        std::vector<ScrollbarHighlight> highlights;
+        highlights.reserve(messages.size());
+        for (const auto &appended : messages)
+        {
+            highlights.push_back(appended.message->getScrollBarHighlight());
+        }
+
+        this->scrollBar_->addHighlights(highlights);
     }
 
     this->messageWasAdded_ = true;
@@ -860,7 +1188,7 @@ void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
     for (size_t i = 0; i < messages.size(); i++)
     {
         auto message = messages.at(i);
-        auto layout = new MessageLayout(message);
+        auto layout = makePooledShared<MessageLayout>(message);
 
         // alternate color
         if (!this->lastMessageHasAlternateBackgroundReverse_)
@@ -868,7 +1196,7 @@ void ChannelView::messageAddedAtStart(std::vector<MessagePtr> &messages)
         this->lastMessageHasAlternateBackgroundReverse_ =
             !this->lastMessageHasAlternateBackgroundReverse_;
 
-        messageRefs.at(i) = MessageLayoutPtr(layout);
+        messageRefs.at(i) = std::move(layout);
     }
 
     /// Add the messages at the start
@@ -920,7 +1248,7 @@ void ChannelView::messageReplaced(size_t index, MessagePtr &replacement)
         return;
     }
 
-    MessageLayoutPtr newItem(new MessageLayout(replacement));
+    auto newItem = makePooledShared<MessageLayout>(replacement);
     auto snapshot = this->messages_.getSnapshot();
     if (index >= snapshot.size())
     {
@@ -943,6 +1271,53 @@ void ChannelView::messageReplaced(size_t index, MessagePtr &replacement)
     this->queueLayout();
 }
 
+void ChannelView::messagesChanged(std::vector<size_t> &indices)
+{
+    auto snapshot = this->messages_.getSnapshot();
+
+    // the layouts are laid out again in the next layout pass, all at once
+    for (auto index : indices)
+    {
+        if (index >= snapshot.size())
+        {
+            continue;
+        }
+
+        const auto &layout = snapshot[index];
+        layout->flags.set(MessageLayoutFlag::RequiresLayout);
+        this->scrollBar_->replaceHighlight(
+            index, layout->getMessage()->getScrollBarHighlight());
+    }
+
+    this->queueLayout();
+}
+
+void ChannelView::messageLimitChanged()
+{
+    auto limit = this->channel_->getMessageLimit();
+
+    // like messages removed in messagesAppended, the selection was already
+    // moved by messageRemoveFromStart
+    if (auto removed = this->messages_.setLimit(limit).size())
+    {
+        if (this->paused())
+        {
+            if (!this->scrollBar_->isAtBottom())
+                this->pauseScrollOffset_ -= int(removed);
+        }
+        else
+        {
+            if (this->scrollBar_->isAtBottom())
+                this->scrollBar_->scrollToBottom();
+            else
+                this->scrollBar_->offset(-qreal(removed));
+        }
+    }
+    this->scrollBar_->setMessageLimit(limit);
+
+    this->queueLayout();
+}
+
 void ChannelView::updateLastReadMessage()
 {
     auto _snapshot = this->getMessagesSnapshot();
@@ -952,7 +1327,34 @@ void ChannelView::updateLastReadMessage()
         this->lastReadMessage_ = _snapshot[_snapshot.size() - 1];
     }
 
-    this->update();
+    this->queueUpdate();
+}
+
+void ChannelView::prefetchImages()
+{
+    // about a screen of messages
+    constexpr size_t count = 50;
+
+    if (this->isVisible() || !this->channel_)
+    {
+        return;
+    }
+
+    ImagePriorityScope imagePriority(ImagePriority::Low);
+
+    auto snapshot = this->channel_->getMessageSnapshot();
+    auto flags = this->getFlags();
+    auto scale = float(this->scale());
+
+    auto end = snapshot.rbegin() +
+               std::ptrdiff_t(std::min(snapshot.size(), count));
+    for (auto it = snapshot.rbegin(); it != end; ++it)
+    {
+        for (const auto &element : (*it)->elements)
+        {
+            element->prefetchImages(scale, flags);
+        }
+    }
 }
 
 void ChannelView::resizeEvent(QResizeEvent *)
@@ -965,9 +1367,14 @@ void ChannelView::resizeEvent(QResizeEvent *)
 
     this->scrollBar_->raise();
 
+    if (this->surface_ != nullptr)
+    {
+        this->surface_->setGeometry(this->rect());
+    }
+
     this->queueLayout();
 
-    this->update();
+    this->queueUpdate();
 }
 
 void ChannelView::setSelection(const SelectionItem &start,
@@ -1030,16 +1437,40 @@ MessageElementFlags ChannelView::getFlags() const
     return flags;
 }
 
-void ChannelView::paintEvent(QPaintEvent * /*event*/)
+void ChannelView::paintEvent(QPaintEvent *event)
 {
-    //    BenchmarkGuard benchmark("paint");
+    CHATTERINO_TRACE_SCOPE("ChannelView::paintEvent");
+
+    if (this->surface_ != nullptr)
+    {
+        this->surface_->update();
+        return;
+    }
 
     QPainter painter(this);
+    this->paintContents(painter, event->region());
+}
 
-    painter.fillRect(rect(), this->theme->splits.background);
+void ChannelView::paintContents(QPainter &painter, const QRegion &region)
+{
+    QElapsedTimer timer;
+    if (this->performance_)
+    {
+        timer.start();
+    }
+
+    if (this->layoutQueued_)
+    {
+        this->performLayout(this->layoutCausedByScrollbar_);
+    }
+
+    painter.fillRect(region.boundingRect(), this->theme->splits.background);
+
+    // animated images outside of the repainted area stay where they were
+    this->animatedRegion_ -= region;
 
     // draw messages
-    this->drawMessages(painter);
+    this->drawMessages(painter, region.boundingRect());
 
     // draw paused sign
     if (this->paused())
@@ -1049,12 +1480,90 @@ void ChannelView::paintEvent(QPaintEvent * /*event*/)
         painter.fillRect(QRectF(5, a / 4, a / 4, a), brush);
         painter.fillRect(QRectF(15, a / 4, a / 4, a), brush);
     }
+
+    if (this->performance_)
+    {
+        this->performance_->paintNsecs += timer.nsecsElapsed();
+        this->performance_->frames++;
+        this->drawPerformanceOverlay(painter);
+    }
+}
+
+void ChannelView::togglePerformanceOverlay()
+{
+    if (this->performance_)
+    {
+        this->performance_.reset();
+        this->queueUpdate();
+        return;
+    }
+
+    this->performance_ = std::make_unique<PerformanceStats>();
+    this->performance_->second.start();
+    this->performance_->refreshTimer.setInterval(1000);
+    QObject::connect(&this->performance_->refreshTimer, &QTimer::timeout,
+                     this, [this] {
+                         this->queueUpdate();
+                     });
+    this->performance_->refreshTimer.start();
+    this->queueUpdate();
+}
+
+void ChannelView::drawPerformanceOverlay(QPainter &painter)
+{
+    auto &stats = *this->performance_;
+
+    auto elapsed = stats.second.elapsed();
+    if (elapsed >= 1000)
+    {
+        // paint time of the overlay refreshes is included, it stays small
+        stats.messagesPerSecond = stats.messages * 1000.0 / elapsed;
+        stats.layoutMsPerFrame =
+            stats.layoutNsecs / 1e6 / std::max(stats.frames, 1);
+        stats.paintMsPerFrame =
+            stats.paintNsecs / 1e6 / std::max(stats.frames, 1);
+
+        stats.messages = 0;
+        stats.frames = 0;
+        stats.layoutNsecs = 0;
+        stats.paintNsecs = 0;
+        stats.second.restart();
+    }
+
+    auto text =
+        QString("%1 messages/s\n"
+                "layout %2 ms/frame\n"
+                "paint %3 ms/frame\n"
+                "%4 visible layouts\n"
+                "%5 KiB buffers\n"
+                "%6 animated elements")
+            .arg(stats.messagesPerSecond, 0, 'f', 1)
+            .arg(stats.layoutMsPerFrame, 0, 'f', 2)
+            .arg(stats.paintMsPerFrame, 0, 'f', 2)
+            .arg(stats.visibleLayouts)
+            .arg(stats.bufferBytes / 1024)
+            .arg(stats.animatedElements);
+
+    painter.setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    auto bounds = painter.fontMetrics().boundingRect(
+        QRect(0, 0, this->width(), this->height()), Qt::AlignLeft, text);
+
+    auto margin = int(4 * this->scale());
+    bounds.moveTopRight(QPoint(
+        this->width() - margin - this->scrollBar_->width(), margin));
+
+    painter.fillRect(bounds.adjusted(-margin, -margin, margin, margin),
+                     QColor(0, 0, 0, 180));
+    painter.setPen(Qt::white);
+    painter.drawText(bounds, Qt::AlignLeft, text);
 }
 
 // if overlays is false then it draws the message, if true then it draws things
 // such as the grey overlay when a message is disabled
-void ChannelView::drawMessages(QPainter &painter)
+void ChannelView::drawMessages(QPainter &painter, const QRect &area)
 {
+    ImagePriorityScope imagePriority(this->imagePriority_);
+
     auto messagesSnapshot = this->getMessagesSnapshot();
 
     size_t start = size_t(this->scrollBar_->getCurrentValue());
@@ -1073,6 +1582,17 @@ void ChannelView::drawMessages(QPainter &painter)
     auto app = getApp();
     bool isMentions = this->underlyingChannel_ == app->twitch->mentionsChannel;
 
+    // animation frames only paint a part of the view, they would make the
+    // overlay flicker
+    auto *stats =
+        area.contains(this->rect()) ? this->performance_.get() : nullptr;
+    if (stats != nullptr)
+    {
+        stats->visibleLayouts = 0;
+        stats->bufferBytes = 0;
+        stats->animatedElements = 0;
+    }
+
     for (size_t i = start; i < messagesSnapshot.size(); ++i)
     {
         MessageLayout *layout = messagesSnapshot[i].get();
@@ -1083,8 +1603,22 @@ void ChannelView::drawMessages(QPainter &painter)
             isLastMessage = this->lastReadMessage_.get() == layout;
         }
 
-        layout->paint(painter, DRAW_WIDTH, y, i, this->selection_,
-                      isLastMessage, windowFocused, isMentions);
+        // animation frames only repaint the animated images, the other
+        // messages are clipped away anyway
+        if (y + layout->getHeight() > area.top() && y <= area.bottom())
+        {
+            auto animated =
+                layout->paint(painter, DRAW_WIDTH, y, i, this->selection_,
+                              isLastMessage, windowFocused, isMentions);
+            this->animatedRegion_ += animated;
+
+            if (stats != nullptr)
+            {
+                stats->visibleLayouts++;
+                stats->bufferBytes += layout->bufferBytes();
+                stats->animatedElements += animated.rectCount();
+            }
+        }
 
         y += layout->getHeight();
 
@@ -1236,6 +1770,9 @@ void ChannelView::enterEvent(QEvent *)
 void ChannelView::leaveEvent(QEvent *)
 {
     this->unpause(PauseReason::Mouse);
+    // a move that's still queued mustn't bring the tooltip back
+    this->hover_.pending = false;
+    this->linkInfoTimer_.stop();
 
     this->queueLayout();
 }
@@ -1253,22 +1790,41 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
         this->pause(PauseReason::Mouse);
     }
 
+    this->hover_.pos = event->pos();
+    this->hover_.screenPos = event->screenPos();
+    this->hover_.globalPos = event->globalPos();
+    this->hover_.modifiers = event->modifiers();
+    this->hover_.pending = true;
+
+    FrameScheduler::instance().request(this, FrameStage::Input, [this] {
+        this->processHover();
+    });
+}
+
+void ChannelView::processHover()
+{
+    if (!std::exchange(this->hover_.pending, false))
+    {
+        return;
+    }
+    const auto &hover = this->hover_;
+
     auto tooltipWidget = TooltipWidget::instance();
     std::shared_ptr<MessageLayout> layout;
     QPoint relativePos;
     int messageIndex;
 
     // no message under cursor
-    if (!tryGetMessageAt(event->pos(), layout, relativePos, messageIndex))
+    if (!tryGetMessageAt(hover.pos, layout, relativePos, messageIndex))
     {
         this->setCursor(Qt::ArrowCursor);
-        tooltipWidget->hide();
+        this->hideTooltip();
         return;
     }
 
     if (this->isScrolling_)
     {
-        this->currentMousePosition_ = event->screenPos();
+        this->currentMousePosition_ = hover.screenPos;
     }
 
     // is selecting
@@ -1287,7 +1843,7 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
     if (layout->flags.has(MessageLayoutFlag::Collapsed))
     {
         this->setCursor(Qt::PointingHandCursor);
-        tooltipWidget->hide();
+        this->hideTooltip();
         return;
     }
 
@@ -1298,7 +1854,7 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
     if (hoverLayoutElement == nullptr)
     {
         this->setCursor(Qt::ArrowCursor);
-        tooltipWidget->hide();
+        this->hideTooltip();
         return;
     }
 
@@ -1439,14 +1995,24 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
     }
 
     auto element = &hoverLayoutElement->getCreator();
-    bool isLinkValid = hoverLayoutElement->getLink().isValid();
+    bool isLinkValid = hoverLayoutElement->getLinkAt(relativePos).isValid();
     auto emoteElement = dynamic_cast<const EmoteElement *>(element);
 
     if (element->getTooltip().isEmpty() ||
         (isLinkValid && emoteElement == nullptr &&
          !getSettings()->linkInfoTooltip))
     {
-        tooltipWidget->hide();
+        this->hideTooltip();
+    }
+    else if (tooltipWidget->isVisible() &&
+             this->tooltipState_.element == element &&
+             this->tooltipState_.layout.lock() == layout &&
+             this->tooltipState_.text == element->getTooltip() &&
+             this->tooltipState_.thumbnail == element->getThumbnail() &&
+             this->tooltipState_.modifiers == hover.modifiers)
+    {
+        // same tooltip as before, it only follows the cursor
+        tooltipWidget->moveTo(this, hover.globalPos);
     }
     else
     {
@@ -1457,7 +2023,7 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
         if ((badgeElement || emoteElement) &&
             getSettings()->emotesTooltipPreview.getValue())
         {
-            if (event->modifiers() == Qt::ShiftModifier ||
+            if (hover.modifiers == Qt::ShiftModifier ||
                 getSettings()->emotesTooltipPreview.getValue() == 1)
             {
                 if (emoteElement)
@@ -1480,18 +2046,7 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
         {
             if (element->getTooltip() == "No link info loaded")
             {
-                std::weak_ptr<MessageLayout> weakLayout = layout;
-                LinkResolver::getLinkInfo(
-                    element->getLink().value, nullptr,
-                    [weakLayout, element](QString tooltipText,
-                                          Link originalLink,
-                                          ImagePtr thumbnail) {
-                        auto shared = weakLayout.lock();
-                        if (!shared)
-                            return;
-                        element->setTooltip(tooltipText);
-                        element->setThumbnail(thumbnail);
-                    });
+                this->queueLinkInfo(layout, element);
             }
             auto thumbnailSize = getSettings()->thumbnailSize;
             if (!thumbnailSize)
@@ -1520,13 +2075,19 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
             }
         }
 
-        tooltipWidget->moveTo(this, event->globalPos());
+        tooltipWidget->moveTo(this, hover.globalPos);
         tooltipWidget->setWordWrap(isLinkValid);
         tooltipWidget->setText(element->getTooltip());
         tooltipWidget->adjustSize();
         tooltipWidget->setWindowFlag(Qt::WindowStaysOnTopHint, true);
         tooltipWidget->show();
         tooltipWidget->raise();
+
+        this->tooltipState_.layout = layout;
+        this->tooltipState_.element = element;
+        this->tooltipState_.text = element->getTooltip();
+        this->tooltipState_.thumbnail = element->getThumbnail();
+        this->tooltipState_.modifiers = hover.modifiers;
     }
 
     // check if word has a link
@@ -1540,6 +2101,26 @@ void ChannelView::mouseMoveEvent(QMouseEvent *event)
     }
 }
 
+void ChannelView::hideTooltip()
+{
+    TooltipWidget::instance()->hide();
+    this->tooltipState_ = {};
+    this->linkInfoTimer_.stop();
+}
+
+void ChannelView::queueLinkInfo(const MessageLayoutPtr &layout,
+                                const MessageElement *element)
+{
+    if (this->linkInfoElement_ == element && this->linkInfoTimer_.isActive())
+    {
+        return;
+    }
+
+    this->linkInfoLayout_ = layout;
+    this->linkInfoElement_ = element;
+    this->linkInfoTimer_.start();
+}
+
 void ChannelView::mousePressEvent(QMouseEvent *event)
 {
     this->mouseDown.invoke(event);
@@ -1630,7 +2211,7 @@ void ChannelView::mousePressEvent(QMouseEvent *event)
         default:;
     }
 
-    this->update();
+    this->queueUpdate();
 }
 
 void ChannelView::mouseReleaseEvent(QMouseEvent *event)
@@ -1762,13 +2343,14 @@ void ChannelView::mouseReleaseEvent(QMouseEvent *event)
     }
 
     // handle the click
-    this->handleMouseClick(event, hoverLayoutElement, layout);
+    this->handleMouseClick(event, hoverLayoutElement, relativePos, layout);
 
-    this->update();
+    this->queueUpdate();
 }
 
 void ChannelView::handleMouseClick(QMouseEvent *event,
                                    const MessageLayoutElement *hoveredElement,
+                                   const QPoint &relativePos,
                                    MessageLayoutPtr layout)
 {
     switch (event->button())
@@ -1789,7 +2371,7 @@ void ChannelView::handleMouseClick(QMouseEvent *event,
                 return;
             }
 
-            const auto &link = hoveredElement->getLink();
+            const auto &link = hoveredElement->getLinkAt(relativePos);
             if (!getSettings()->linksDoubleClickOnly)
             {
                 this->handleLinkClick(event, link, layout.get());
@@ -1813,7 +2395,7 @@ void ChannelView::handleMouseClick(QMouseEvent *event,
 
             if (hoveredElement != nullptr)
             {
-                const auto &link = hoveredElement->getLink();
+                const auto &link = hoveredElement->getLinkAt(relativePos);
 
                 if (link.type == Link::UserInfo)
                 {
@@ -1843,7 +2425,7 @@ void ChannelView::handleMouseClick(QMouseEvent *event,
                 return;
             }
 
-            const auto &link = hoveredElement->getLink();
+            const auto &link = hoveredElement->getLinkAt(relativePos);
             if (!getSettings()->linksDoubleClickOnly)
             {
                 this->handleLinkClick(event, link, layout.get());
@@ -1973,6 +2555,9 @@ void ChannelView::addMessageContextMenuItems(
         menu.addAction("Copy selection", [this] {
             crossPlatformCopy(this->getSelectedText());
         });
+        menu.addAction("Save selection to file...", [this] {
+            this->saveSelectionToFile();
+        });
     }
 
     menu.addAction("Copy message", [layout] {
@@ -1989,6 +2574,28 @@ void ChannelView::addMessageContextMenuItems(
 
         crossPlatformCopy(copyString);
     });
+
+    // search results, user cards and mentions show messages of other
+    // channels, a split of that channel can scroll to the message
+    const auto *message = layout->getMessage();
+    ChannelPtr messageChannel = this->sourceChannel_;
+    if (!message->channelName.isEmpty() &&
+        (!messageChannel || messageChannel->getName() != message->channelName))
+    {
+        messageChannel =
+            getApp()->twitch->getChannelOrEmpty(message->channelName);
+    }
+
+    if (!message->id.isEmpty() && messageChannel &&
+        !messageChannel->isEmpty() &&
+        messageChannel != this->underlyingChannel_)
+    {
+        menu.addAction("Go to message",
+                       [messageChannel, messageID = message->id] {
+                           getApp()->windows->scrollToMessage(messageChannel,
+                                                              messageID);
+                       });
+    }
 }
 
 void ChannelView::addTwitchLinkContextMenuItems(
@@ -2138,13 +2745,29 @@ void ChannelView::mouseDoubleClickEvent(QMouseEvent *event)
 
     if (getSettings()->linksDoubleClickOnly)
     {
-        auto &link = hoverLayoutElement->getLink();
+        auto &link = hoverLayoutElement->getLinkAt(relativePos);
         this->handleLinkClick(event, link, layout.get());
     }
 }
 
+void ChannelView::showEvent(QShowEvent *)
+{
+    this->shown_ = true;
+
+    // the first paint lays out the visible messages, the ones around them
+    // follow in the background
+    if (this->layoutDeferred_)
+    {
+        this->layoutDeferred_ = false;
+        this->scheduleLayout();
+    }
+}
+
 void ChannelView::hideEvent(QHideEvent *)
 {
+    this->shown_ = false;
+    FrameScheduler::instance().cancelBackground(this);
+
     for (auto &layout : this->messagesOnScreen_)
     {
         layout->deleteBuffer();
@@ -1,14 +1,18 @@
 #pragma once
 
+#include <QElapsedTimer>
 #include <QPaintEvent>
+#include <QRegion>
 #include <QScroller>
 #include <QTimer>
 #include <QWheelEvent>
 #include <QWidget>
 #include <pajlada/signals/signal.hpp>
+#include <functional>
 #include <unordered_map>
 #include <unordered_set>
 
+#include "common/Channel.hpp"
 #include "common/FlagsEnum.hpp"
 #include "controllers/filters/FilterSet.hpp"
 #include "messages/Image.hpp"
@@ -21,6 +25,7 @@ namespace chatterino {
 enum class HighlightState;
 
 class Channel;
+class ChannelProjection;
 using ChannelPtr = std::shared_ptr<Channel>;
 
 struct Message;
@@ -37,7 +42,9 @@ using MessageElementFlags = FlagsEnum<MessageElementFlag>;
 
 class Scrollbar;
 class EffectLabel;
+class ChannelViewSurface;
 struct Link;
+class MessageElement;
 class MessageLayoutElement;
 
 enum class PauseReason {
@@ -64,15 +71,26 @@ public:
     explicit ChannelView(BaseWidget *parent = nullptr);
 
     void queueUpdate();
+    void queueUpdate(const QRegion &region);
+    /// Paints the view into painter, by paintEvent or the OpenGL surface
+    void paintContents(QPainter &painter, const QRegion &region);
     Scrollbar &getScrollBar();
     QString getSelectedText();
+    /// Asks for a file and writes the selected text to it, one message at a
+    /// time
+    void saveSelectionToFile();
     bool hasSelection();
     void clearSelection();
     void setEnableScrollingToBottom(bool);
     bool getEnableScrollingToBottom() const;
+    // priority with which the images drawn by this view are decoded
+    void setImagePriority(ImagePriority priority);
     void setOverrideFlags(boost::optional<MessageElementFlags> value);
     const boost::optional<MessageElementFlags> &getOverrideFlags() const;
     void updateLastReadMessage();
+    /// Starts loading the images of the newest messages at low priority
+    /// while the view is hidden, so they're there once it's shown
+    void prefetchImages();
 
     /// Pausing
     bool pausable() const;
@@ -93,10 +111,20 @@ public:
     bool hasSourceChannel() const;
 
     LimitedQueueSnapshot<MessageLayoutPtr> getMessagesSnapshot();
-    void queueLayout();
+    /// Merges all layout requests until the next frame, see FrameScheduler.
+    /// Hidden views are only laid out once they're shown again.
+    void queueLayout(bool causedByScrollbar = false);
 
     void clearMessages();
 
+    /// Shows or hides the numbers of messages, layouts, paints and buffers
+    /// of this view in its corner
+    void togglePerformanceOverlay();
+
+    /// Scrolls the message with the id into the middle of the view. Returns
+    /// false if the view doesn't show the message.
+    bool scrollToMessage(const QString &messageID);
+
     /**
      * @brief Creates and shows a UserInfoPopup dialog
      *
@@ -131,6 +159,7 @@ protected:
     void mouseReleaseEvent(QMouseEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override;
 
+    void showEvent(QShowEvent *) override;
     void hideEvent(QHideEvent *) override;
 
     void handleLinkClick(QMouseEvent *event, const Link &link,
@@ -140,23 +169,39 @@ protected:
                          QPoint &relativePos, int &index);
 
 private:
+    // Calls fn with the selected text of every selected message, oldest
+    // first. Only the first and last message of the selection are laid out.
+    void forEachSelectedText(const std::function<void(const QString &)> &fn);
+
     void initializeLayout();
     void initializeScrollbar();
     void initializeSignals();
 
-    void messageAppended(MessagePtr &message,
-                         boost::optional<MessageFlags> overridingFlags);
+    void messagesAppended(std::vector<Channel::AppendedMessage> &messages);
     void messageAddedAtStart(std::vector<MessagePtr> &messages);
     void messageRemoveFromStart(MessagePtr &message);
     void messageReplaced(size_t index, MessagePtr &replacement);
+    void messagesChanged(std::vector<size_t> &indices);
+    void messageLimitChanged();
 
+    // requests the layout from the FrameScheduler, unless it already is
+    void scheduleLayout();
     void performLayout(bool causedByScollbar = false);
     void layoutVisibleMessages(
         LimitedQueueSnapshot<MessageLayoutPtr> &messages);
+    // returns true while there are messages left to layout
+    bool layoutBackgroundMessages();
+    bool layoutMessage(const MessageLayoutPtr &layout, int width,
+                       MessageElementFlags flags);
+    // frees the layouts of the messages far away from the view and the
+    // bottom, so only a window of messages holds laid out elements
+    void releaseDistantLayouts(
+        LimitedQueueSnapshot<MessageLayoutPtr> &messages);
     void updateScrollbar(LimitedQueueSnapshot<MessageLayoutPtr> &messages,
                          bool causedByScrollbar);
 
-    void drawMessages(QPainter &painter);
+    void drawMessages(QPainter &painter, const QRect &area);
+    void drawPerformanceOverlay(QPainter &painter);
     void setSelection(const SelectionItem &start, const SelectionItem &end);
     MessageElementFlags getFlags() const;
     void selectWholeMessage(MessageLayout *layout, int &messageIndex);
@@ -166,7 +211,7 @@ private:
 
     void handleMouseClick(QMouseEvent *event,
                           const MessageLayoutElement *hoveredElement,
-                          MessageLayoutPtr layout);
+                          const QPoint &relativePos, MessageLayoutPtr layout);
     void addContextMenuItems(const MessageLayoutElement *hoveredElement,
                              MessageLayoutPtr layout, QMouseEvent *event);
     void addImageContextMenuItems(const MessageLayoutElement *hoveredElement,
@@ -191,14 +236,80 @@ private:
     void enableScrolling(const QPointF &scrollStart);
     void disableScrolling();
 
-    QTimer *layoutCooldown_;
-    bool layoutQueued_;
-
-    QTimer updateTimer_;
-    bool updateQueued_ = false;
+    // handles the latest mouse move, see hover_
+    void processHover();
+    void hideTooltip();
+    // resolves the link info of element once the cursor rests on it
+    void queueLinkInfo(const MessageLayoutPtr &layout,
+                       const MessageElement *element);
+
+    bool layoutQueued_ = false;
+    bool layoutCausedByScrollbar_ = false;
+    // between the show and hide events, the view is hidden while its tab
+    // isn't selected or its window is minimized
+    bool shown_ = false;
+    // a layout was requested while the view was hidden
+    bool layoutDeferred_ = false;
+    // whether anything but the scroll position changed since the last full
+    // layout
+    bool layoutDirty_ = true;
+    // what the last full layout was done for, a layout caused only by
+    // scrolling keeps the layouts and buffers if nothing of it changed
+    struct LayoutState {
+        int width = -1;
+        int height = -1;
+        float scale = 0;
+        MessageElementFlags flags;
+        int generation = -1;
+        size_t messageCount = 0;
+
+        bool operator==(const LayoutState &other) const
+        {
+            return this->width == other.width &&
+                   this->height == other.height &&
+                   this->scale == other.scale && this->flags == other.flags &&
+                   this->generation == other.generation &&
+                   this->messageCount == other.messageCount;
+        }
+    };
+    LayoutState lastLayoutState_;
+    // area to repaint in the next frame
+    QRegion updateRegion_;
+
+    // the messages around the visible ones are laid out in small slices in
+    // the background frames, so scrolling to them doesn't stall
+    size_t backgroundLayoutPosition_ = 0;
     bool messageWasAdded_ = false;
     bool lastMessageHasAlternateBackground_ = false;
     bool lastMessageHasAlternateBackgroundReverse_ = true;
+    // area covered by the animated images that are currently on screen, only
+    // this area is repainted for a new animation frame
+    QRegion animatedRegion_;
+
+    // What the performance overlay shows. Only exists while it's shown, so
+    // the views without it don't measure anything.
+    struct PerformanceStats {
+        // refreshes the overlay when nothing else repaints the view
+        QTimer refreshTimer;
+
+        // sums since the start of the current second
+        QElapsedTimer second;
+        int messages = 0;
+        int frames = 0;
+        qint64 layoutNsecs = 0;
+        qint64 paintNsecs = 0;
+
+        // averages of the last complete second
+        double messagesPerSecond = 0;
+        double layoutMsPerFrame = 0;
+        double paintMsPerFrame = 0;
+
+        // state of the last paint
+        int visibleLayouts = 0;
+        int64_t bufferBytes = 0;
+        int animatedElements = 0;
+    };
+    std::unique_ptr<PerformanceStats> performance_;
 
     bool pausable_ = false;
     QTimer pauseTimer_;
@@ -213,18 +324,20 @@ private:
 
     LimitedQueueSnapshot<MessageLayoutPtr> snapshot_;
 
+    // the messages of underlyingChannel_ passing the filters, channel_ is
+    // its channel
+    std::shared_ptr<ChannelProjection> projection_;
     ChannelPtr channel_ = nullptr;
     ChannelPtr underlyingChannel_ = nullptr;
     ChannelPtr sourceChannel_ = nullptr;
 
     Scrollbar *scrollBar_;
     EffectLabel *goToBottom_;
+    // only exists if the view is drawn with OpenGL
+    ChannelViewSurface *surface_ = nullptr;
 
     FilterSetPtr channelFilters_;
 
-    // Returns true if message should be included
-    bool shouldIncludeMessage(const MessagePtr &m) const;
-
     // Returns whether the scrollbar should have highlights
     bool showScrollbarHighlights() const;
 
@@ -232,6 +345,7 @@ private:
     // "Show latest messages" button
     bool showingLatestMessages_ = true;
     bool enableScrollingToBottom_ = true;
+    ImagePriority imagePriority_ = ImagePriority::High;
 
     bool onlyUpdateEmotes_ = false;
 
@@ -250,6 +364,27 @@ private:
     QPointF currentMousePosition_;
     QTimer scrollTimer_;
 
+    // Mouse moves arrive far more often than frames, only the latest one of
+    // each frame is hit-tested and updates the selection and tooltip.
+    struct {
+        QPoint pos;
+        QPointF screenPos;
+        QPoint globalPos;
+        Qt::KeyboardModifiers modifiers;
+        bool pending = false;
+    } hover_;
+    // what the tooltip shows, it's only rebuilt if any of it changed
+    struct {
+        std::weak_ptr<MessageLayout> layout;
+        const MessageElement *element = nullptr;
+        QString text;
+        ImagePtr thumbnail;
+        Qt::KeyboardModifiers modifiers;
+    } tooltipState_;
+    QTimer linkInfoTimer_;
+    std::weak_ptr<MessageLayout> linkInfoLayout_;
+    const MessageElement *linkInfoElement_ = nullptr;
+
     struct {
         QCursor neutral;
         QCursor up;
@@ -267,6 +402,8 @@ private:
     pajlada::Signals::SignalHolder channelConnections_;
 
     std::unordered_set<std::shared_ptr<MessageLayout>> messagesOnScreen_;
+    // messages this view laid out since their layouts were last released
+    std::unordered_set<std::shared_ptr<MessageLayout>> laidOutMessages_;
 
     static constexpr int leftPadding = 8;
     static constexpr int scrollbarPadding = 8;
@@ -0,0 +1,23 @@
+#include "widgets/helper/ChannelViewSurface.hpp"
+
+#include "widgets/helper/ChannelView.hpp"
+
+#include <QPainter>
+
+namespace chatterino {
+
+ChannelViewSurface::ChannelViewSurface(ChannelView *view)
+    : QOpenGLWidget(view)
+    , view_(view)
+{
+    this->setAttribute(Qt::WA_TransparentForMouseEvents);
+}
+
+void ChannelViewSurface::paintGL()
+{
+    // the framebuffer doesn't keep its content, everything is drawn again
+    QPainter painter(this);
+    this->view_->paintContents(painter, this->rect());
+}
+
+}  // namespace chatterino
@@ -0,0 +1,30 @@
+#pragma once
+
+#include <QOpenGLWidget>
+
+namespace chatterino {
+
+class ChannelView;
+
+/**
+ * @brief Paints a ChannelView through OpenGL.
+ *
+ * QPainter uses the OpenGL paint engine on this widget. It keeps the message
+ * buffers and the frames of animated emotes as textures on the GPU, so a frame
+ * only draws textured quads for them instead of blitting pixmaps on the CPU.
+ * The surface covers the view below its scrollbar, mouse events go through
+ * to the view.
+ */
+class ChannelViewSurface final : public QOpenGLWidget
+{
+public:
+    explicit ChannelViewSurface(ChannelView *view);
+
+protected:
+    void paintGL() override;
+
+private:
+    ChannelView *view_;
+};
+
+}  // namespace chatterino
@@ -1,6 +1,6 @@
 #include "DebugPopup.hpp"
 
-#include "util/DebugCount.hpp"
+#include "util/MemoryUsage.hpp"
 
 #include <QFontDatabase>
 #include <QHBoxLayout>
@@ -9,21 +9,93 @@
 
 namespace chatterino {
 
+namespace {
+
+    QString formatMicroseconds(int64_t microseconds)
+    {
+        if (microseconds < 1000)
+        {
+            return QString("%1 us").arg(microseconds);
+        }
+        return QString("%1 ms").arg(microseconds / 1000.0, 0, 'f', 1);
+    }
+
+}  // namespace
+
 DebugPopup::DebugPopup()
 {
     auto *layout = new QHBoxLayout(this);
-    auto *text = new QLabel(this);
+    this->text_ = new QLabel(this);
     auto *timer = new QTimer(this);
 
-    timer->setInterval(300);
-    QObject::connect(timer, &QTimer::timeout, [text] {
-        text->setText(DebugCount::getDebugText());
+    timer->setInterval(1000);
+    QObject::connect(timer, &QTimer::timeout, [this] {
+        this->refresh();
     });
     timer->start();
 
-    text->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+    this->text_->setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont));
+
+    layout->addWidget(this->text_);
+
+    this->sinceRefresh_.start();
+    this->refresh();
+}
+
+void DebugPopup::refresh()
+{
+    auto seconds = std::max<qint64>(this->sinceRefresh_.restart(), 1) / 1000.0;
+
+    QString text;
+    for (const auto &value : DebugCount::values())
+    {
+        text += value.name + ": " + QString::number(value.value);
+
+        auto previous = this->previousValues_.find(value.name);
+        if (previous != this->previousValues_.end() &&
+            previous->second != value.value)
+        {
+            text += QString(" (%1%2/s)")
+                        .arg(value.value > previous->second ? "+" : "")
+                        .arg((value.value - previous->second) / seconds, 0,
+                             'f', 1);
+        }
+        text += "\n";
+
+        this->previousValues_[value.name] = value.value;
+    }
+
+    for (const auto *histogram : DebugCount::histograms())
+    {
+        auto snapshot = histogram->snapshot();
+        text += "\n" + histogram->name() + ": " +
+                QString::number(snapshot.count);
+
+        auto previous = this->previousSnapshots_.find(histogram->name());
+        if (previous == this->previousSnapshots_.end())
+        {
+            this->previousSnapshots_.emplace(histogram->name(), snapshot);
+            text += "\n";
+            continue;
+        }
+
+        auto recent = snapshot.since(previous->second);
+        previous->second = snapshot;
+
+        if (recent.count > 0)
+        {
+            text += QString(" (+%1/s)").arg(recent.count / seconds, 0, 'f', 1);
+            text += "\n  p50 " + formatMicroseconds(recent.percentile(0.5)) +
+                    ", p90 " + formatMicroseconds(recent.percentile(0.9)) +
+                    ", p99 " + formatMicroseconds(recent.percentile(0.99)) +
+                    ", max " + formatMicroseconds(recent.percentile(1));
+        }
+        text += "\n";
+    }
+
+    text += "\n" + MemoryUsage::snapshot(10).join("\n");
 
-    layout->addWidget(text);
+    this->text_->setText(text);
 }
 
 }  // namespace chatterino
@@ -1,13 +1,31 @@
 #pragma once
 
+#include "util/DebugCount.hpp"
+#include "util/QStringHash.hpp"
 #include "widgets/BasePopup.hpp"
 
+#include <QElapsedTimer>
+
+#include <unordered_map>
+
+class QLabel;
+
 namespace chatterino {
 
 class DebugPopup : public BasePopup
 {
 public:
     DebugPopup();
+
+private:
+    // counts with their rates and the percentiles of what the histograms
+    // recorded since the last refresh
+    void refresh();
+
+    QLabel *text_;
+    QElapsedTimer sinceRefresh_;
+    std::unordered_map<QString, int64_t> previousValues_;
+    std::unordered_map<QString, DebugHistogram::Snapshot> previousSnapshots_;
 };
 
 }  // namespace chatterino
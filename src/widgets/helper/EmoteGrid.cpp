@@ -0,0 +1,342 @@
+#include "widgets/helper/EmoteGrid.hpp"
+
+#include "Application.hpp"
+#include "messages/Image.hpp"
+#include "singletons/Fonts.hpp"
+#include "singletons/Settings.hpp"
+#include "singletons/Theme.hpp"
+#include "singletons/TooltipPreviewImage.hpp"
+#include "singletons/WindowManager.hpp"
+#include "widgets/Scrollbar.hpp"
+#include "widgets/TooltipWidget.hpp"
+
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+
+#include <algorithm>
+
+namespace chatterino {
+
+namespace {
+
+    // at a scale of 1, the emotes are scaled down to fit
+    constexpr int CELL_SIZE = 32;
+    constexpr int CELL_PADDING = 2;
+
+}  // namespace
+
+EmoteGrid::EmoteGrid(QWidget *parent)
+    : BaseWidget(parent)
+    , scrollBar_(new Scrollbar(this))
+{
+    this->setMouseTracking(true);
+    this->setAttribute(Qt::WA_OpaquePaintEvent);
+
+    this->scrollBar_->getCurrentValueChanged().connect([this] {
+        this->update();
+    });
+
+    this->signalHolder_.managedConnect(
+        getApp()->windows->gifRepaintRequested, [this] {
+            if (this->paintedAnimatedEmote_ && this->isVisible())
+            {
+                this->update();
+            }
+        });
+
+    // images that finished loading are shown by a repaint
+    this->signalHolder_.managedConnect(
+        getApp()->windows->layoutRequested, [this](Channel *) {
+            if (this->isVisible())
+            {
+                this->update();
+            }
+        });
+}
+
+void EmoteGrid::setSections(std::vector<Section> sections)
+{
+    this->sections_ = std::move(sections);
+    this->hoveredItem_ = nullptr;
+
+    this->layoutRows();
+    this->scrollBar_->setDesiredValue(0);
+    this->update();
+}
+
+Scrollbar &EmoteGrid::getScrollBar()
+{
+    return *this->scrollBar_;
+}
+
+int EmoteGrid::cellSize() const
+{
+    return int(CELL_SIZE * this->scale());
+}
+
+int EmoteGrid::textRowHeight() const
+{
+    return getFonts()->getFontMetrics(FontStyle::ChatMedium, this->scale())
+               .height() +
+           int(8 * this->scale());
+}
+
+int EmoteGrid::cellsLeft() const
+{
+    auto available = this->width() - this->scrollBar_->width();
+    return std::max(0, (available - this->columns_ * this->cellSize()) / 2);
+}
+
+void EmoteGrid::layoutRows()
+{
+    this->rows_.clear();
+
+    auto cellSize = this->cellSize();
+    auto textHeight = this->textRowHeight();
+    this->columns_ = std::max(
+        1, (this->width() - this->scrollBar_->width()) / std::max(cellSize, 1));
+
+    int y = 0;
+    for (size_t section = 0; section < this->sections_.size(); section++)
+    {
+        const auto &items = this->sections_[section].items;
+
+        if (!this->sections_[section].title.isEmpty())
+        {
+            this->rows_.push_back({RowType::Title, y, section, 0});
+            y += textHeight;
+        }
+
+        if (items.empty())
+        {
+            this->rows_.push_back({RowType::EmptyText, y, section, 0});
+            y += textHeight;
+        }
+
+        for (size_t first = 0; first < items.size(); first += this->columns_)
+        {
+            this->rows_.push_back({RowType::Emotes, y, section, first});
+            y += cellSize;
+        }
+    }
+
+    this->scrollBar_->setMaximum(y);
+    this->scrollBar_->setLargeChange(this->height());
+    this->scrollBar_->setSmallChange(cellSize);
+    this->scrollBar_->setVisible(y > this->height());
+    // keeps the value in range after the content got shorter
+    this->scrollBar_->setDesiredValue(this->scrollBar_->getDesiredValue());
+}
+
+std::vector<EmoteGrid::Row>::const_iterator EmoteGrid::rowAt(int y) const
+{
+    // the last row starting above y
+    auto it = std::upper_bound(this->rows_.begin(), this->rows_.end(), y,
+                               [](int y, const Row &row) {
+                                   return y < row.y;
+                               });
+    return it == this->rows_.begin() ? it : std::prev(it);
+}
+
+const EmoteGrid::Item *EmoteGrid::itemAt(QPoint pos) const
+{
+    auto y = pos.y() + int(this->scrollBar_->getCurrentValue());
+    auto row = this->rowAt(y);
+
+    if (row == this->rows_.end() || row->type != RowType::Emotes ||
+        y >= row->y + this->cellSize())
+    {
+        return nullptr;
+    }
+
+    auto x = pos.x() - this->cellsLeft();
+    if (x < 0 || x >= this->columns_ * this->cellSize())
+    {
+        return nullptr;
+    }
+
+    const auto &items = this->sections_[row->section].items;
+    auto index = row->first + size_t(x / this->cellSize());
+    return index < items.size() ? &items[index] : nullptr;
+}
+
+void EmoteGrid::paintEvent(QPaintEvent *)
+{
+    QPainter painter(this);
+    painter.fillRect(this->rect(), this->theme->messages.backgrounds.regular);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+
+    // the popup shouldn't slow down the images of the chats
+    ImagePriorityScope imagePriority(ImagePriority::Low);
+
+    this->paintedAnimatedEmote_ = false;
+
+    auto top = int(this->scrollBar_->getCurrentValue());
+    for (auto row = this->rowAt(top);
+         row != this->rows_.end() && row->y < top + this->height(); row++)
+    {
+        this->paintRow(painter, *row, row->y - top);
+    }
+}
+
+void EmoteGrid::paintRow(QPainter &painter, const Row &row, int y)
+{
+    const auto &section = this->sections_[row.section];
+
+    if (row.type != RowType::Emotes)
+    {
+        auto rect = QRect(0, y, this->width() - this->scrollBar_->width(),
+                          this->textRowHeight());
+        painter.setFont(
+            getFonts()->getFont(FontStyle::ChatMedium, this->scale()));
+        painter.setPen(row.type == RowType::Title
+                           ? this->theme->messages.textColors.regular
+                           : this->theme->messages.textColors.system);
+        painter.drawText(rect, Qt::AlignCenter,
+                         row.type == RowType::Title ? section.title
+                                                    : section.emptyText);
+        return;
+    }
+
+    auto cellSize = this->cellSize();
+    auto padding = int(CELL_PADDING * this->scale());
+    auto last = std::min(section.items.size(), row.first + this->columns_);
+
+    for (auto i = row.first; i < last; i++)
+    {
+        const auto &item = section.items[i];
+        auto cell = QRect(this->cellsLeft() + int(i - row.first) * cellSize, y,
+                          cellSize, cellSize);
+
+        if (&item == this->hoveredItem_)
+        {
+            painter.fillRect(cell, this->theme->messages.selection);
+        }
+
+        const auto &image = item.emote->images.getImageOrLoaded(this->scale());
+        if (image->isEmpty())
+        {
+            continue;
+        }
+
+        if (auto pixmap = image->pixmapOrLoad())
+        {
+            // keeps the aspect ratio, wide emotes are scaled down
+            auto size = QSizeF(image->width(), image->height()) * this->scale();
+            size.scale(size.boundedTo(QSizeF(cell.size()) -
+                                      QSizeF(2 * padding, 2 * padding)),
+                       Qt::KeepAspectRatio);
+
+            auto target = QRectF(QPointF(), size);
+            target.moveCenter(QRectF(cell).center());
+            painter.drawPixmap(target, *pixmap, pixmap->rect());
+
+            this->paintedAnimatedEmote_ |= image->animated();
+        }
+    }
+}
+
+void EmoteGrid::resizeEvent(QResizeEvent *)
+{
+    this->scrollBar_->setGeometry(this->width() - this->scrollBar_->width(), 0,
+                                  this->scrollBar_->width(), this->height());
+    this->scrollBar_->raise();
+
+    this->layoutRows();
+}
+
+void EmoteGrid::scaleChangedEvent(float)
+{
+    this->layoutRows();
+    this->update();
+}
+
+void EmoteGrid::wheelEvent(QWheelEvent *event)
+{
+    if (event->modifiers() & Qt::ControlModifier)
+    {
+        event->ignore();
+        return;
+    }
+
+    if (this->scrollBar_->isVisible())
+    {
+        auto delta = event->angleDelta().y() * qreal(1.5) *
+                     getSettings()->mouseScrollMultiplier;
+        this->scrollBar_->offset(-delta);
+    }
+}
+
+void EmoteGrid::mouseMoveEvent(QMouseEvent *event)
+{
+    const auto *item = this->itemAt(event->pos());
+
+    if (item != this->hoveredItem_)
+    {
+        this->hoveredItem_ = item;
+        this->update();
+    }
+
+    if (item == nullptr)
+    {
+        this->setCursor(Qt::ArrowCursor);
+        TooltipWidget::instance()->hide();
+        return;
+    }
+
+    this->setCursor(Qt::PointingHandCursor);
+    this->showTooltip(*item, event);
+}
+
+void EmoteGrid::showTooltip(const Item &item, QMouseEvent *event)
+{
+    auto &tooltipPreviewImage = TooltipPreviewImage::instance();
+    tooltipPreviewImage.setImageScale(0, 0);
+
+    if (getSettings()->emotesTooltipPreview.getValue() &&
+        (event->modifiers() == Qt::ShiftModifier ||
+         getSettings()->emotesTooltipPreview.getValue() == 1))
+    {
+        tooltipPreviewImage.setImage(item.emote->images.getImage(3.0));
+    }
+    else
+    {
+        tooltipPreviewImage.setImage(nullptr);
+    }
+
+    auto *tooltipWidget = TooltipWidget::instance();
+    tooltipWidget->moveTo(this, event->globalPos());
+    tooltipWidget->setWordWrap(false);
+    tooltipWidget->setText(item.emote->tooltip.string);
+    tooltipWidget->adjustSize();
+    tooltipWidget->setWindowFlag(Qt::WindowStaysOnTopHint, true);
+    tooltipWidget->show();
+    tooltipWidget->raise();
+}
+
+void EmoteGrid::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton)
+    {
+        return;
+    }
+
+    if (const auto *item = this->itemAt(event->pos()))
+    {
+        this->linkClicked.invoke(Link(Link::InsertText, item->text));
+    }
+}
+
+void EmoteGrid::leaveEvent(QEvent *)
+{
+    TooltipWidget::instance()->hide();
+
+    if (this->hoveredItem_ != nullptr)
+    {
+        this->hoveredItem_ = nullptr;
+        this->update();
+    }
+}
+
+}  // namespace chatterino
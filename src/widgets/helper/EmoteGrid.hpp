@@ -0,0 +1,85 @@
+#pragma once
+
+#include "messages/Emote.hpp"
+#include "messages/Link.hpp"
+#include "widgets/BaseWidget.hpp"
+
+#include <pajlada/signals/signal.hpp>
+
+#include <vector>
+
+namespace chatterino {
+
+class Scrollbar;
+
+/**
+ * @brief Emotes in a grid of equally sized cells, grouped in sections.
+ *
+ * The layout is a list of rows computed from the number of emotes in each
+ * section and the width of the widget, the emotes themselves are never laid
+ * out. Only the rows in view are painted, so only their images get loaded.
+ */
+class EmoteGrid : public BaseWidget
+{
+public:
+    struct Item {
+        EmotePtr emote;
+        // inserted into the input when the emote is clicked
+        QString text;
+    };
+
+    struct Section {
+        QString title;
+        std::vector<Item> items;
+        // shown below the title if there are no items
+        QString emptyText = "no emotes available";
+    };
+
+    explicit EmoteGrid(QWidget *parent = nullptr);
+
+    void setSections(std::vector<Section> sections);
+
+    Scrollbar &getScrollBar();
+
+    pajlada::Signals::Signal<Link> linkClicked;
+
+protected:
+    void paintEvent(QPaintEvent *) override;
+    void resizeEvent(QResizeEvent *) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *) override;
+    void scaleChangedEvent(float scale) override;
+
+private:
+    enum class RowType { Title, EmptyText, Emotes };
+
+    struct Row {
+        RowType type;
+        int y;
+        size_t section;
+        // index of the first item of the row in its section
+        size_t first;
+    };
+
+    void layoutRows();
+    std::vector<Row>::const_iterator rowAt(int y) const;
+    const Item *itemAt(QPoint pos) const;
+    // left edge of the cells, they are centered
+    int cellsLeft() const;
+    int cellSize() const;
+    int textRowHeight() const;
+
+    void paintRow(QPainter &painter, const Row &row, int y);
+    void showTooltip(const Item &item, QMouseEvent *event);
+
+    Scrollbar *scrollBar_;
+    std::vector<Section> sections_;
+    std::vector<Row> rows_;
+    int columns_ = 1;
+    const Item *hoveredItem_{};
+    bool paintedAnimatedEmote_ = false;
+};
+
+}  // namespace chatterino
@@ -53,6 +53,12 @@ NotebookTab::NotebookTab(Notebook *notebook)
             this->update();
         },
         this->managedConnections_);
+    this->managedConnections_.managedConnect(
+        getApp()->fonts->fontChanged, [this] {
+            this->layoutTitleWidth_ = {};
+            this->paintTitleWidth_ = {};
+            this->updateSize();
+        });
 
     this->setMouseTracking(true);
 
@@ -161,21 +167,34 @@ void NotebookTab::growWidth(int width)
     }
 }
 
+int NotebookTab::titleWidth(TitleWidth &cache, float fontScale)
+{
+    if (cache.fontScale != fontScale)
+    {
+        QFontMetrics metrics =
+            getApp()->fonts->getFontMetrics(FontStyle::UiTabs, fontScale);
+        cache.fontScale = fontScale;
+        cache.width = metrics.horizontalAdvance(this->getTitle());
+    }
+    return cache.width;
+}
+
 int NotebookTab::normalTabWidth()
 {
     float scale = this->scale();
     int width;
 
-    QFontMetrics metrics = getApp()->fonts->getFontMetrics(
-        FontStyle::UiTabs, float(qreal(this->scale()) * deviceDpi(this)));
+    int titleWidth =
+        this->titleWidth(this->layoutTitleWidth_,
+                         float(qreal(this->scale()) * deviceDpi(this)));
 
     if (this->hasXButton())
     {
-        width = (metrics.horizontalAdvance(this->getTitle()) + int(32 * scale));
+        width = (titleWidth + int(32 * scale));
     }
     else
     {
-        width = (metrics.horizontalAdvance(this->getTitle()) + int(16 * scale));
+        width = (titleWidth + int(16 * scale));
     }
 
     if (this->height() > 150 * scale)
@@ -204,7 +223,7 @@ void NotebookTab::updateSize()
     if (this->width() != width || this->height() != height)
     {
         this->resize(width, height);
-        this->notebook_->performLayout();
+        this->notebook_->queueLayout();
     }
 }
 
@@ -260,7 +279,10 @@ void NotebookTab::titleUpdated()
 {
     // Queue up save because: Tab title changed
     getApp()->windows->queueSave();
-    this->notebook_->performLayout();
+    this->layoutTitleWidth_ = {};
+    this->paintTitleWidth_ = {};
+    // many tabs are renamed at once, e.g. when a window layout is loaded
+    this->notebook_->queueLayout();
     this->updateSize();
     this->update();
 }
@@ -304,7 +326,9 @@ void NotebookTab::setHighlightState(HighlightState newHighlightStyle)
     {
         return;
     }
-    if (this->highlightState_ != HighlightState::Highlighted)
+    // only repaint if the state actually changes
+    if (this->highlightState_ != HighlightState::Highlighted &&
+        this->highlightState_ != newHighlightStyle)
     {
         this->highlightState_ = newHighlightStyle;
 
@@ -370,8 +394,6 @@ void NotebookTab::paintEvent(QPaintEvent *)
     auto div = std::max<float>(0.01f, this->logicalDpiX() * deviceDpi(this));
     painter.setFont(
         getApp()->fonts->getFont(FontStyle::UiTabs, scale * 96.f / div));
-    QFontMetrics metrics =
-        app->fonts->getFontMetrics(FontStyle::UiTabs, scale * 96.f / div);
 
     int height = int(scale * NOTEBOOK_TAB_HEIGHT);
 
@@ -442,7 +464,7 @@ void NotebookTab::paintEvent(QPaintEvent *)
         textRect.setRight(textRect.right() - this->height() / 2);
     }
 
-    int width = metrics.horizontalAdvance(this->getTitle());
+    int width = this->titleWidth(this->paintTitleWidth_, scale * 96.f / div);
     Qt::Alignment alignment = width > textRect.width()
                                   ? Qt::AlignLeft | Qt::AlignVCenter
                                   : Qt::AlignHCenter | Qt::AlignVCenter;
@@ -586,6 +608,13 @@ void NotebookTab::enterEvent(QEvent *event)
 {
     this->mouseOver_ = true;
 
+    // the page is likely selected next
+    if (auto *container = dynamic_cast<SplitContainer *>(this->page);
+        container != nullptr && !this->isSelected())
+    {
+        container->prefetchImages();
+    }
+
     this->update();
 
     Button::enterEvent(event);
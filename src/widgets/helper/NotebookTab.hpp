@@ -78,6 +78,13 @@ private:
     QRect getXRect();
     void titleUpdated();
 
+    struct TitleWidth {
+        float fontScale = -1;
+        int width = 0;
+    };
+    // measures the title once per font scale, until the title or font changes
+    int titleWidth(TitleWidth &cache, float fontScale);
+
     QPropertyAnimation positionChangedAnimation_;
     bool positionChangedAnimationRunning_ = false;
     QPoint positionAnimationDesiredPoint_;
@@ -103,6 +110,10 @@ private:
 
     int growWidth_ = 0;
 
+    // layout and painting use different font scales on some platforms
+    TitleWidth layoutTitleWidth_;
+    TitleWidth paintTitleWidth_;
+
     QMenu menu_;
 
     pajlada::Signals::SignalHolder managedConnections_;
@@ -1,10 +1,17 @@
 #include "SearchPopup.hpp"
 
+#include <QCheckBox>
 #include <QHBoxLayout>
 #include <QLineEdit>
+#include <QPointer>
 #include <QPushButton>
 #include <QVBoxLayout>
+#include <QtConcurrent>
 
+#include <algorithm>
+#include <mutex>
+
+#include "Application.hpp"
 #include "common/Channel.hpp"
 #include "controllers/hotkeys/HotkeyController.hpp"
 #include "messages/Message.hpp"
@@ -14,45 +21,97 @@
 #include "messages/search/MessageFlagsPredicate.hpp"
 #include "messages/search/RegexPredicate.hpp"
 #include "messages/search/SubstringPredicate.hpp"
+#include "providers/twitch/TwitchIrcServer.hpp"
+#include "singletons/Logging.hpp"
+#include "singletons/Settings.hpp"
+#include "util/PostToThread.hpp"
 #include "widgets/helper/ChannelView.hpp"
 
 namespace chatterino {
 
-ChannelPtr SearchPopup::filter(const QString &text, const QString &channelName,
-                               const LimitedQueueSnapshot<MessagePtr> &snapshot,
-                               FilterSetPtr filterSet)
-{
-    ChannelPtr channel(new Channel(channelName, Channel::Type::None));
+namespace {
 
-    // Parse predicates from tags in "text"
-    auto predicates = parsePredicates(text);
+    // how far back the logs are searched
+    constexpr int LOG_SEARCH_DAYS = 30;
+    constexpr size_t LOG_SEARCH_LIMIT = 10000;
+    // searching all channels splits LOG_SEARCH_LIMIT between them
+    constexpr size_t LOG_SEARCH_CHANNEL_MIN_LIMIT = 1000;
+    // messages that are checked by one task of the thread pool
+    constexpr size_t SEARCH_CHUNK_SIZE = 250;
 
-    // Check for every message whether it fulfills all predicates that have
-    // been registered
-    for (size_t i = 0; i < snapshot.size(); ++i)
+    QStringList parseAuthors(const QString &input)
     {
-        MessagePtr message = snapshot[i];
+        static QRegularExpression authorRegex(R"((?:^|\s)from:([^\s]+))");
 
-        bool accept = true;
-        for (const auto &pred : predicates)
+        QStringList authors;
+        auto it = authorRegex.globalMatch(input);
+        while (it.hasNext())
         {
-            // Discard the message as soon as one predicate fails
-            if (!pred->appliesTo(*message))
-            {
-                accept = false;
-                break;
-            }
+            authors.append(
+                it.next().captured(1).split(',', QString::SkipEmptyParts));
+        }
+        return authors;
+    }
+
+    // Orders the messages of several channels, keeps the order of messages
+    // that were received at the same time
+    void sortByTime(std::vector<MessagePtr> &messages)
+    {
+        std::stable_sort(messages.begin(), messages.end(),
+                         [](const MessagePtr &a, const MessagePtr &b) {
+                             return a->serverReceivedTime <
+                                    b->serverReceivedTime;
+                         });
+    }
+
+    // Returns true if every message that matches newText also matches
+    // oldText. Predicates are and-ed, except for from: and in: which accept
+    // any of their values, and plain words match fewer messages as they get
+    // longer.
+    bool isNarrowing(const QString &oldText, const QString &newText)
+    {
+        if (oldText.isEmpty() || !newText.startsWith(oldText) ||
+            oldText.count('"') % 2 != 0)
+        {
+            return false;
+        }
+
+        auto added = newText.mid(oldText.size());
+        if (added.contains("from:") || added.contains("in:"))
+        {
+            return false;
         }
 
-        if (accept && filterSet)
-            accept = filterSet->filter(message, channel);
+        if (added.isEmpty() || added.front().isSpace() ||
+            oldText.back().isSpace())
+        {
+            return true;
+        }
 
-        // If all predicates match, add the message to the channel
-        if (accept)
-            channel->addMessage(message);
+        // the last word got longer, it has to stay a plain word
+        static QRegularExpression whitespace(R"(\s)");
+        auto wordStart = oldText.lastIndexOf(whitespace) + 1;
+        auto word = newText.mid(wordStart).section(whitespace, 0, 0);
+        return !word.contains(':') && !word.contains('"');
     }
 
-    return channel;
+}  // namespace
+
+bool SearchPopup::matches(
+    const MessagePtr &message,
+    const std::vector<std::unique_ptr<MessagePredicate>> &predicates,
+    const FilterSetPtr &filterSet, const ChannelPtr &channel)
+{
+    for (const auto &pred : predicates)
+    {
+        // Discard the message as soon as one predicate fails
+        if (!pred->appliesTo(*message))
+        {
+            return false;
+        }
+    }
+
+    return !filterSet || filterSet->filter(message, channel);
 }
 
 SearchPopup::SearchPopup(QWidget *parent)
@@ -91,13 +150,15 @@ void SearchPopup::addShortcuts()
 void SearchPopup::setChannelFilters(FilterSetPtr filters)
 {
     this->channelFilters_ = std::move(filters);
+    this->invalidateResults();
 }
 
 void SearchPopup::setChannel(const ChannelPtr &channel)
 {
     this->channelView_->setSourceChannel(channel);
     this->channelName_ = channel->getName();
-    this->snapshot_ = channel->getMessageSnapshot();
+    this->sourceChannel_ = channel;
+    this->invalidateResults();
     this->search();
 
     this->updateWindowTitle();
@@ -107,6 +168,12 @@ void SearchPopup::updateWindowTitle()
 {
     QString historyName;
 
+    if (this->allChannels_->isChecked())
+    {
+        this->setWindowTitle("Searching in the history of all channels");
+        return;
+    }
+
     if (this->channelName_ == "/whispers")
     {
         historyName = "whispers";
@@ -128,9 +195,230 @@ void SearchPopup::updateWindowTitle()
 
 void SearchPopup::search()
 {
-    this->channelView_->setChannel(filter(this->searchInput_->text(),
-                                          this->channelName_, this->snapshot_,
-                                          this->channelFilters_));
+    if (this->includeLogs_->isChecked())
+    {
+        this->loadLogs();
+    }
+    else if (this->logAuthors_)
+    {
+        this->logMessages_.clear();
+        this->logAuthors_ = boost::none;
+        this->logChannels_.clear();
+        this->invalidateResults();
+    }
+
+    this->startSearch(this->searchInput_->text());
+}
+
+void SearchPopup::startSearch(const QString &text)
+{
+    if (this->searchCancelled_)
+    {
+        *this->searchCancelled_ = true;
+    }
+    auto cancelled = std::make_shared<std::atomic<bool>>(false);
+    this->searchCancelled_ = cancelled;
+
+    // a new key, so the chunks don't wait for cancelled ones
+    auto key = QString::number(++this->searchGeneration_);
+
+    std::shared_ptr<const std::vector<MessagePtr>> source;
+    if (this->finishedQuery_ && isNarrowing(*this->finishedQuery_, text))
+    {
+        source = this->finishedResults_;
+    }
+    else
+    {
+        auto messages =
+            std::make_shared<std::vector<MessagePtr>>(this->logMessages_);
+        auto channels = this->searchedChannels();
+
+        // the token index skips the messages that can't match
+        IndexTerms terms;
+        parsePredicates(text, &terms);
+
+        for (const auto &sourceChannel : channels)
+        {
+            if (auto candidates = sourceChannel->findSearchCandidates(
+                    terms.words, terms.authors))
+            {
+                messages->insert(messages->end(), candidates->begin(),
+                                 candidates->end());
+            }
+            else
+            {
+                auto snapshot = sourceChannel->getMessageSnapshot();
+                messages->insert(messages->end(), snapshot.begin(),
+                                 snapshot.end());
+            }
+        }
+
+        if (channels.size() > 1)
+        {
+            sortByTime(*messages);
+        }
+        source = std::move(messages);
+    }
+
+    auto channel =
+        std::make_shared<Channel>(this->channelName_, Channel::Type::None);
+    channel->setBatchedAppends(true);
+    this->channelView_->setChannel(channel);
+
+    auto results = std::make_shared<std::vector<MessagePtr>>();
+    auto filterSet = this->channelFilters_;
+
+    for (size_t start = 0; start < source->size(); start += SEARCH_CHUNK_SIZE)
+    {
+        this->searchQueue_.run(key, [=]() -> OrderedWorkQueue::Result {
+            // predicates aren't shared between threads, parsing them again
+            // is cheap compared to checking the messages
+            auto predicates = parsePredicates(text);
+
+            std::vector<MessagePtr> matched;
+            auto end = std::min(start + SEARCH_CHUNK_SIZE, source->size());
+            for (size_t i = start; i < end; i++)
+            {
+                if (*cancelled)
+                {
+                    return {};
+                }
+
+                if (matches((*source)[i], predicates, filterSet, channel))
+                {
+                    matched.push_back((*source)[i]);
+                }
+            }
+
+            if (matched.empty())
+            {
+                return {};
+            }
+
+            return [cancelled, channel, results,
+                    matched = std::move(matched)] {
+                if (*cancelled)
+                {
+                    return;
+                }
+
+                for (const auto &message : matched)
+                {
+                    channel->addMessage(message);
+                    results->push_back(message);
+                }
+            };
+        });
+    }
+
+    this->searchQueue_.runAfter(key, [this, cancelled, text, results] {
+        if (*cancelled)
+        {
+            return;
+        }
+
+        this->finishedQuery_ = text;
+        this->finishedResults_ = results;
+    });
+}
+
+std::vector<ChannelPtr> SearchPopup::searchedChannels() const
+{
+    std::vector<ChannelPtr> channels;
+
+    if (this->allChannels_->isChecked())
+    {
+        getApp()->twitch->forEachChannel([&channels](ChannelPtr channel) {
+            channels.push_back(std::move(channel));
+        });
+    }
+    else if (auto channel = this->sourceChannel_.lock())
+    {
+        channels.push_back(std::move(channel));
+    }
+
+    return channels;
+}
+
+void SearchPopup::invalidateResults()
+{
+    this->finishedQuery_ = boost::none;
+    this->finishedResults_.reset();
+}
+
+void SearchPopup::loadLogs()
+{
+    auto authors = parseAuthors(this->searchInput_->text());
+
+    QStringList channelNames;
+    for (const auto &channel : this->searchedChannels())
+    {
+        channelNames.append(channel->getName());
+    }
+
+    // the logs are only read again if the authors or channels changed, the
+    // index lets the reader skip blocks without messages from the authors
+    if (this->logAuthors_ == authors && this->logChannels_ == channelNames)
+    {
+        return;
+    }
+    this->logAuthors_ = authors;
+    this->logChannels_ = channelNames;
+
+    if (channelNames.isEmpty())
+    {
+        this->logMessages_.clear();
+        return;
+    }
+
+    // messages logged in this session are already in the channels
+    auto to = Logging::sessionStart();
+    auto from = to.addDays(-LOG_SEARCH_DAYS);
+    auto limit = std::max(LOG_SEARCH_LIMIT / size_t(channelNames.size()),
+                          LOG_SEARCH_CHANNEL_MIN_LIMIT);
+
+    // every channel is read by its own task, the last one merges them
+    struct Load {
+        std::mutex mutex;
+        std::vector<MessagePtr> messages;
+        int remaining;
+    };
+    auto load = std::make_shared<Load>();
+    load->remaining = channelNames.size();
+
+    for (const auto &channelName : channelNames)
+    {
+        QtConcurrent::run([popup = QPointer<SearchPopup>(this), load,
+                           channelName, from, to, authors, channelNames,
+                           limit] {
+            auto messages =
+                Logging::loadHistory(channelName, from, to, authors, limit);
+
+            std::lock_guard<std::mutex> lock(load->mutex);
+            load->messages.insert(load->messages.end(), messages.begin(),
+                                  messages.end());
+            if (--load->remaining != 0)
+            {
+                return;
+            }
+
+            if (channelNames.size() > 1)
+            {
+                sortByTime(load->messages);
+            }
+
+            postToThread([popup, authors, channelNames,
+                          messages = std::move(load->messages)] {
+                if (popup && popup->logAuthors_ == authors &&
+                    popup->logChannels_ == channelNames)
+                {
+                    popup->logMessages_ = messages;
+                    popup->invalidateResults();
+                    popup->search();
+                }
+            });
+        });
+    }
 }
 
 void SearchPopup::initLayout()
@@ -160,6 +448,34 @@ void SearchPopup::initLayout()
                                  this, &SearchPopup::search);
             }
 
+            // INCLUDE LOGS
+            {
+                this->includeLogs_ = new QCheckBox("Search logs", this);
+                this->includeLogs_->setToolTip(
+                    "Also search the compressed logs of the last " +
+                    QString::number(LOG_SEARCH_DAYS) + " days");
+                this->includeLogs_->setVisible(getSettings()->logCompressed);
+                layout2->addWidget(this->includeLogs_);
+
+                QObject::connect(this->includeLogs_, &QCheckBox::toggled, this,
+                                 &SearchPopup::search);
+            }
+
+            // ALL CHANNELS
+            {
+                this->allChannels_ = new QCheckBox("All channels", this);
+                this->allChannels_->setToolTip(
+                    "Search the messages of all open Twitch channels");
+                layout2->addWidget(this->allChannels_);
+
+                QObject::connect(this->allChannels_, &QCheckBox::toggled, this,
+                                 [this] {
+                                     this->invalidateResults();
+                                     this->search();
+                                     this->updateWindowTitle();
+                                 });
+            }
+
             layout1->addLayout(layout2);
         }
 
@@ -177,7 +493,7 @@ void SearchPopup::initLayout()
 }
 
 std::vector<std::unique_ptr<MessagePredicate>> SearchPopup::parsePredicates(
-    const QString &input)
+    const QString &input, IndexTerms *terms)
 {
     // This regex captures all name:value predicate pairs into named capturing
     // groups and matches all other inputs seperated by spaces as normal
@@ -187,6 +503,7 @@ std::vector<std::unique_ptr<MessagePredicate>> SearchPopup::parsePredicates(
     static QRegularExpression predicateRegex(
         R"lit((?:(?<name>\w+):(?<value>".+?"|[^\s]+))|[^\s]+?(?=$|\s))lit");
     static QRegularExpression trimQuotationMarksRegex(R"(^"|"$)");
+    static QRegularExpression whitespaceRegex(R"(\s)");
 
     QRegularExpressionMatchIterator it = predicateRegex.globalMatch(input);
 
@@ -229,6 +546,20 @@ std::vector<std::unique_ptr<MessagePredicate>> SearchPopup::parsePredicates(
         {
             predicates.push_back(
                 std::make_unique<SubstringPredicate>(match.captured()));
+
+            // quoted values of unknown tags can contain whitespace
+            if (terms && !match.captured().contains(whitespaceRegex))
+            {
+                terms->words.append(match.captured());
+            }
+        }
+    }
+
+    if (terms)
+    {
+        for (const auto &author : authors)
+        {
+            terms->authors.append(author.split(',', QString::SkipEmptyParts));
         }
     }
 
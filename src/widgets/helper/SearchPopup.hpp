@@ -2,12 +2,16 @@
 
 #include "ForwardDecl.hpp"
 #include "controllers/filters/FilterSet.hpp"
-#include "messages/LimitedQueueSnapshot.hpp"
 #include "messages/search/MessagePredicate.hpp"
+#include "util/OrderedWorkQueue.hpp"
 #include "widgets/BasePopup.hpp"
 
+#include <boost/optional.hpp>
+
+#include <atomic>
 #include <memory>
 
+class QCheckBox;
 class QLineEdit;
 
 namespace chatterino {
@@ -26,39 +30,72 @@ protected:
 private:
     void initLayout();
     void search();
+    // evaluates the query on chunks of the messages on the thread pool, the
+    // matches are appended to the view as the chunks finish
+    void startSearch(const QString &text);
+    // the next search can't reuse the results of the last one
+    void invalidateResults();
+    // the channel of the popup, or all Twitch channels in the global mode
+    std::vector<ChannelPtr> searchedChannels() const;
     void addShortcuts() override;
+    // loads the messages from the compressed logs that the search could match
+    void loadLogs();
 
     /**
-     * @brief Only retains those message from a list of messages that satisfy a
-     *        search query.
+     * @brief Checks whether a message satisfies a search query.
      *
-     * @param text          the search query -- will be parsed for MessagePredicates
-     * @param channelName   name of the channel to be returned
-     * @param snapshot      list of messages to filter
+     * @param message       the message to check
+     * @param predicates    the predicates parsed from the search query
      * @param filterSet     channel filter to apply
+     * @param channel       channel the filters are evaluated for
      *
-     * @return a ChannelPtr with "channelName" and the filtered messages from
-     *         "snapshot"
+     * @return true if all predicates and the filters apply to the message
      */
-    static ChannelPtr filter(const QString &text, const QString &channelName,
-                             const LimitedQueueSnapshot<MessagePtr> &snapshot,
-                             FilterSetPtr filterSet);
+    static bool matches(
+        const MessagePtr &message,
+        const std::vector<std::unique_ptr<MessagePredicate>> &predicates,
+        const FilterSetPtr &filterSet, const ChannelPtr &channel);
+
+    // the parts of a query that Channel::findSearchCandidates can look up
+    struct IndexTerms {
+        QStringList words;
+        QStringList authors;
+    };
 
     /**
      * @brief Checks the input for tags and registers their corresponding
      *        predicates.
      *
      * @param input the string to check for tags
+     * @param terms filled in with the terms of the token index, if not null
      * @return a vector of MessagePredicates requested in the input
      */
     static std::vector<std::unique_ptr<MessagePredicate>> parsePredicates(
-        const QString &input);
+        const QString &input, IndexTerms *terms = nullptr);
 
-    LimitedQueueSnapshot<MessagePtr> snapshot_;
+    std::weak_ptr<Channel> sourceChannel_;
     QLineEdit *searchInput_{};
+    QCheckBox *includeLogs_{};
+    QCheckBox *allChannels_{};
     ChannelView *channelView_{};
     QString channelName_{};
     FilterSetPtr channelFilters_;
+
+    std::vector<MessagePtr> logMessages_;
+    // authors logMessages_ are (being) loaded for, all if empty
+    boost::optional<QStringList> logAuthors_;
+    // channels logMessages_ are (being) loaded for
+    QStringList logChannels_;
+
+    OrderedWorkQueue searchQueue_;
+    int searchGeneration_ = 0;
+    // set once the running search is replaced by a newer one
+    std::shared_ptr<std::atomic<bool>> searchCancelled_;
+
+    // query of the last search that finished and the messages it matched,
+    // queries that only get narrower search these instead of all messages
+    boost::optional<QString> finishedQuery_;
+    std::shared_ptr<const std::vector<MessagePtr>> finishedResults_;
 };
 
 }  // namespace chatterino
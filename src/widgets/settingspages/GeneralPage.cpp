@@ -437,6 +437,10 @@ void GeneralPage::initLayout(GeneralPageView &layout)
             "You can receive updates earlier by ticking the box below. Report "
             "issues <a href='https://chatterino.com/link/issues'>here</a>.");
         layout.addCheckbox("Receive beta updates", s.betaUpdates);
+#ifdef Q_OS_WIN
+        layout.addCheckbox("Download updates in the background",
+                           s.prefetchUpdates);
+#endif
     }
     else
     {
@@ -531,6 +535,8 @@ void GeneralPage::initLayout(GeneralPageView &layout)
 
         layout.addLayout(box);
     }
+    layout.addIntInput("Maximum size of saved emotes in MiB", s.imageCacheSize,
+                       64, 16384, 64);
 
     layout.addTitle("Advanced");
 
@@ -681,11 +687,34 @@ void GeneralPage::initLayout(GeneralPageView &layout)
     // TODO: Change phrasing to use better english once we can tag settings, right now it's kept as history instead of historical so that the setting shows up when the user searches for history
     layout.addIntInput("Max number of history messages to load on connect",
                        s.twitchMessageHistoryLimit, 10, 800, 10);
+    layout.addIntInput("Channels loading their message history at once",
+                       s.twitchMessageHistoryConcurrentLoads, 1, 32, 1);
+    layout.addCheckbox("Keep message history between restarts",
+                       s.persistMessageHistory);
+    layout.addIntInput("Memory for drawing messages in MiB",
+                       s.messageBufferBudget, 16, 4096, 16);
+    layout.addIntInput("Memory for emotes and badges in MiB",
+                       s.imageMemoryBudget, 64, 8192, 64);
+    auto *messageBudgetInput =
+        layout.addIntInput("Memory for messages in MiB (0 for no limit)",
+                           s.messageMemoryBudget, 0, 16384, 64);
+    messageBudgetInput->setToolTip(
+        "Once messages take more memory, channels in tabs that aren't "
+        "selected only keep their newest messages.");
+    auto *dormantCheckbox = layout.addCheckbox("Pause channels in hidden tabs",
+                                               s.dormantHiddenChannels);
+    dormantCheckbox->setToolTip(
+        "Messages in tabs that aren't selected are only shown and highlighted "
+        "once the tab is selected. Their live status isn't updated meanwhile.");
 
     layout.addCheckbox("Enable experimental IRC support (requires restart)",
                        s.enableExperimentalIrc);
     layout.addCheckbox("Show unhandled IRC messages",
                        s.showUnhandledIrcMessages);
+    layout.addCheckbox("Log UI stalls to stalls.log (requires restart)",
+                       s.eventLoopWatchdog);
+    layout.addCheckbox("Draw chats with OpenGL (requires restart)",
+                       s.openGLRendering);
     layout.addDropdown<int>(
         "Stack timeouts", {"Stack", "Stack until timeout", "Don't stack"},
         s.timeoutStackStyle,
@@ -151,8 +151,9 @@ ComboBox *GeneralPageView::addDropdown(
 
     QObject::connect(combo, &QComboBox::currentTextChanged,
                      [&setting](const QString &newValue) {
-                         setting = newValue;
-                         getApp()->windows->forceLayoutChannelViews();
+                         getApp()->windows->layoutAfterSettingChange([&] {
+                             setting = newValue;
+                         });
                      });
 
     return combo;
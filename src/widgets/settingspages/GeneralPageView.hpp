@@ -181,9 +181,11 @@ public:
             combo, QOverload<const int>::of(&QComboBox::currentIndexChanged),
             [combo, &setting,
              setValue = std::move(setValue)](const int newIndex) {
-                setting = setValue(DropdownArgs{combo->itemText(newIndex),
-                                                combo->currentIndex(), combo});
-                getApp()->windows->forceLayoutChannelViews();
+                getApp()->windows->layoutAfterSettingChange([&] {
+                    setting = setValue(DropdownArgs{
+                        combo->itemText(newIndex), combo->currentIndex(),
+                        combo});
+                });
             });
 
         return combo;
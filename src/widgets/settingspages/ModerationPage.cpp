@@ -74,6 +74,12 @@ ModerationPage::ModerationPage()
     {
         logs.append(this->createCheckBox("Enable logging",
                                          getSettings()->enableLogging));
+        logs.append(this->createCheckBox(
+            "Force log files to be written to disk (slower)",
+            getSettings()->logSyncToDisk));
+        logs.append(this->createCheckBox(
+            "Write compressed logs (searchable from the search popup)",
+            getSettings()->logCompressed));
         auto logsPathLabel = logs.emplace<QLabel>();
 
         // Logs (copied from LoggingMananger)
@@ -103,8 +103,9 @@ QCheckBox *SettingsPage::createCheckBox(
     // update setting on toggle
     QObject::connect(checkbox, &QCheckBox::toggled, this,
                      [&setting](bool state) {
-                         setting = state;
-                         getApp()->windows->forceLayoutChannelViews();
+                         getApp()->windows->layoutAfterSettingChange([&] {
+                             setting = state;
+                         });
                      });
 
     return checkbox;
@@ -1,6 +1,7 @@
 #include "InputCompletionPopup.hpp"
 
 #include "Application.hpp"
+#include "common/CompletionIndex.hpp"
 #include "controllers/accounts/AccountController.hpp"
 #include "messages/Emote.hpp"
 #include "providers/bttv/BttvEmotes.hpp"
@@ -8,37 +9,40 @@
 #include "providers/twitch/TwitchChannel.hpp"
 #include "providers/twitch/TwitchIrcServer.hpp"
 #include "singletons/Emotes.hpp"
+#include "util/Hotness.hpp"
 #include "util/LayoutCreator.hpp"
 #include "widgets/listview/GenericListView.hpp"
 #include "widgets/splits/InputCompletionItem.hpp"
 
+#include <algorithm>
+
 namespace chatterino {
 namespace {
 
-    struct _Emote {
-        EmotePtr emote;
-        QString displayName;
-        QString providerName;
-    };
+    using detail::CompletionEmote;
 
-    void addEmotes(std::vector<_Emote> &out, const EmoteMap &map,
-                   const QString &text, const QString &providerName)
+    void addEmotes(std::vector<CompletionEmote> &out, const EmoteMap &map,
+                   const QString &providerName)
     {
         for (auto &&emote : map)
-            if (emote.first.string.contains(text, Qt::CaseInsensitive))
-                out.push_back(
-                    {emote.second, emote.second->name.string, providerName});
+            out.push_back(
+                {emote.second, emote.second->name.string, providerName});
     }
 
-    void addEmojis(std::vector<_Emote> &out, const EmojiMap &map,
-                   const QString &text)
+    void addEmojis(std::vector<CompletionEmote> &out, const EmojiMap &map)
     {
         map.each([&](const QString &, const std::shared_ptr<EmojiData> &emoji) {
             for (auto &&shortCode : emoji->shortCodes)
-                if (shortCode.contains(text, Qt::CaseInsensitive))
-                    out.push_back({emoji->emote, shortCode, "Emoji"});
+                out.push_back({emoji->emote, shortCode, "Emoji"});
         });
     }
+
+    // the emotes picked from the popup of any split
+    CompletionUsage &emoteUsage()
+    {
+        static CompletionUsage usage;
+        return usage;
+    }
 }  // namespace
 
 InputCompletionPopup::InputCompletionPopup(QWidget *parent)
@@ -73,47 +77,107 @@ void InputCompletionPopup::initLayout()
 
 void InputCompletionPopup::updateEmotes(const QString &text, ChannelPtr channel)
 {
-    std::vector<_Emote> emotes;
+    auto &last = this->last_;
+    bool sameChannel = last.emotes && last.channel.lock() == channel;
+    if (sameChannel && text == last.text)
+    {
+        // only the cursor moved
+        return;
+    }
+
+    this->updateEmoteIndex(channel);
+
+    std::vector<CompletionEmote> emotes;
+    for (const auto &match :
+         this->emoteIndex_.find(text, size_t(maxEntryCount), &emoteUsage(),
+                                &Hotness::emotes()))
+    {
+        emotes.push_back(this->indexedEmotes_[match.index]);
+    }
+
+    last.text = text;
+    last.emotes = true;
+    last.channel = channel;
+    last.userMatches.clear();
+
+    this->setEmotes(std::move(emotes), text);
+}
+
+void InputCompletionPopup::updateEmoteIndex(const ChannelPtr &channel)
+{
+    EmoteSources sources;
+    sources.channel = channel;
+
     auto tc = dynamic_cast<TwitchChannel *>(channel.get());
     // returns true also for special Twitch channels (/live, /mentions, /whispers, etc.)
     if (channel->isTwitchChannel())
+    {
+        if (auto user = getApp()->accounts->twitch.getCurrent())
+        {
+            sources.account = user;
+            sources.accountGeneration = user->emotesGeneration();
+        }
+        if (tc)
+        {
+            sources.roomId = tc->roomId();
+            sources.bttv = tc->bttvEmotes();
+            sources.ffz = tc->ffzEmotes();
+        }
+        sources.bttvGlobal = getApp()->twitch->getBttvEmotes().emotes();
+        sources.ffzGlobal = getApp()->twitch->getFfzEmotes().emotes();
+    }
+
+    if (this->indexed_ && sources == this->indexSources_)
+    {
+        return;
+    }
+
+    std::vector<CompletionEmote> emotes;
+    if (channel->isTwitchChannel())
     {
         if (auto user = getApp()->accounts->twitch.getCurrent())
         {
             // Twitch Emotes available globally
             auto emoteData = user->accessEmotes();
-            addEmotes(emotes, emoteData->emotes, text, "Twitch Emote");
+            addEmotes(emotes, emoteData->emotes, "Twitch Emote");
 
             // Twitch Emotes available locally
             auto localEmoteData = user->accessLocalEmotes();
-            if (tc &&
-                localEmoteData->find(tc->roomId()) != localEmoteData->end())
+            auto it = localEmoteData->find(sources.roomId);
+            if (tc && it != localEmoteData->end())
             {
-                if (auto localEmotes = &localEmoteData->at(tc->roomId()))
-                {
-                    addEmotes(emotes, *localEmotes, text,
-                              "Local Twitch Emotes");
-                }
+                addEmotes(emotes, it->second, "Local Twitch Emotes");
             }
         }
 
-        if (tc)
-        {
-            // TODO extract "Channel BetterTTV" text into a #define.
-            if (auto bttv = tc->bttvEmotes())
-                addEmotes(emotes, *bttv, text, "Channel BetterTTV");
-            if (auto ffz = tc->ffzEmotes())
-                addEmotes(emotes, *ffz, text, "Channel FrankerFaceZ");
-        }
+        // TODO extract "Channel BetterTTV" text into a #define.
+        if (sources.bttv)
+            addEmotes(emotes, *sources.bttv, "Channel BetterTTV");
+        if (sources.ffz)
+            addEmotes(emotes, *sources.ffz, "Channel FrankerFaceZ");
 
-        if (auto bttvG = getApp()->twitch->getBttvEmotes().emotes())
-            addEmotes(emotes, *bttvG, text, "Global BetterTTV");
-        if (auto ffzG = getApp()->twitch->getFfzEmotes().emotes())
-            addEmotes(emotes, *ffzG, text, "Global FrankerFaceZ");
+        if (sources.bttvGlobal)
+            addEmotes(emotes, *sources.bttvGlobal, "Global BetterTTV");
+        if (sources.ffzGlobal)
+            addEmotes(emotes, *sources.ffzGlobal, "Global FrankerFaceZ");
 
-        addEmojis(emotes, getApp()->emotes->emojis.emojis, text);
+        addEmojis(emotes, getApp()->emotes->emojis.emojis);
     }
 
+    this->emoteIndex_.clear();
+    this->emoteIndex_.reserve(emotes.size());
+    for (const auto &emote : emotes)
+    {
+        this->emoteIndex_.add(emote.displayName);
+    }
+    this->indexedEmotes_ = std::move(emotes);
+    this->indexSources_ = std::move(sources);
+    this->indexed_ = true;
+}
+
+void InputCompletionPopup::setEmotes(std::vector<CompletionEmote> emotes,
+                                     const QString &text)
+{
     // if there is an exact match, put that emote first
     for (size_t i = 1; i < emotes.size(); i++)
     {
@@ -137,7 +201,10 @@ void InputCompletionPopup::updateEmotes(const QString &text, ChannelPtr channel)
     {
         this->model_.addItem(std::make_unique<InputCompletionItem>(
             emote.emote, emote.displayName + " - " + emote.providerName,
-            this->callback_));
+            [this, name = emote.displayName](const QString &text) {
+                emoteUsage().used(name);
+                this->callback_(text);
+            }));
 
         if (count++ == maxEntryCount)
             break;
@@ -154,7 +221,49 @@ void InputCompletionPopup::updateUsers(const QString &text, ChannelPtr channel)
     auto twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
     if (twitchChannel)
     {
-        auto chatters = twitchChannel->accessChatters()->filterByPrefix(text);
+        auto &last = this->last_;
+        bool sameChannel = !last.emotes && last.channel.lock() == channel;
+        if (sameChannel && text == last.text)
+        {
+            return;
+        }
+
+        twitchChannel->refreshChattersForCompletion();
+
+        std::vector<QString> chatters;
+        if (sameChannel && text.startsWith(last.text, Qt::CaseInsensitive))
+        {
+            for (const auto &name : last.userMatches)
+            {
+                if (name.startsWith(text, Qt::CaseInsensitive))
+                {
+                    chatters.push_back(name);
+                }
+            }
+        }
+        else
+        {
+            chatters = twitchChannel->accessChatters()->filterByPrefix(text);
+
+            // users that chatted a lot lately first
+            auto &hotness = Hotness::chatters();
+            std::vector<std::pair<uint32_t, QString>> ranked;
+            ranked.reserve(chatters.size());
+            for (auto &name : chatters)
+            {
+                ranked.emplace_back(hotness.score(name.toLower()),
+                                    std::move(name));
+            }
+            std::stable_sort(ranked.begin(), ranked.end(),
+                             [](const auto &a, const auto &b) {
+                                 return a.first > b.first;
+                             });
+            for (size_t i = 0; i < ranked.size(); i++)
+            {
+                chatters[i] = std::move(ranked[i].second);
+            }
+        }
+
         this->model_.clear();
         int count = 0;
         for (const auto &name : chatters)
@@ -169,6 +278,11 @@ void InputCompletionPopup::updateUsers(const QString &text, ChannelPtr channel)
         {
             this->ui_.listView->setCurrentIndex(this->model_.index(0));
         }
+
+        last.text = text;
+        last.emotes = false;
+        last.channel = channel;
+        last.userMatches = std::move(chatters);
     }
 }
 
@@ -190,6 +304,9 @@ void InputCompletionPopup::showEvent(QShowEvent *)
 void InputCompletionPopup::hideEvent(QHideEvent *)
 {
     this->redrawTimer_.stop();
+
+    // emotes and chatters can change until the popup is shown again
+    this->last_ = {};
 }
 
 }  // namespace chatterino
@@ -2,6 +2,8 @@
 
 #include <functional>
 #include "common/Channel.hpp"
+#include "common/CompletionIndex.hpp"
+#include "messages/Emote.hpp"
 #include "widgets/BasePopup.hpp"
 #include "widgets/listview/GenericListModel.hpp"
 
@@ -9,6 +11,14 @@ namespace chatterino {
 
 class GenericListView;
 
+namespace detail {
+    struct CompletionEmote {
+        EmotePtr emote;
+        QString displayName;
+        QString providerName;
+    };
+}  // namespace detail
+
 class InputCompletionPopup : public BasePopup
 {
     using ActionCallback = std::function<void(const QString &)>;
@@ -30,6 +40,11 @@ protected:
 
 private:
     void initLayout();
+    // rebuilds the index if any of the emotes of channel changed
+    void updateEmoteIndex(const ChannelPtr &channel);
+    // replaces the entries of the model, the exact match goes first
+    void setEmotes(std::vector<detail::CompletionEmote> emotes,
+                   const QString &text);
 
     struct {
         GenericListView *listView;
@@ -38,6 +53,45 @@ private:
     GenericListModel model_;
     ActionCallback callback_;
     QTimer redrawTimer_;
+
+    // The last completion while the popup is shown. A longer text can only
+    // match a part of its chatters, those are filtered instead of searching
+    // all chatters again.
+    struct {
+        QString text;
+        bool emotes = false;
+        std::weak_ptr<Channel> channel;
+        std::vector<QString> userMatches;
+    } last_;
+
+    // What the emote index was built from, it's kept until one of them
+    // changes, so typing only matches against the index.
+    struct EmoteSources {
+        std::weak_ptr<Channel> channel;
+        std::shared_ptr<const void> account;
+        uint64_t accountGeneration = 0;
+        QString roomId;
+        std::shared_ptr<const EmoteMap> bttv;
+        std::shared_ptr<const EmoteMap> ffz;
+        std::shared_ptr<const EmoteMap> bttvGlobal;
+        std::shared_ptr<const EmoteMap> ffzGlobal;
+
+        bool operator==(const EmoteSources &other) const
+        {
+            return this->channel.lock() == other.channel.lock() &&
+                   this->account == other.account &&
+                   this->accountGeneration == other.accountGeneration &&
+                   this->roomId == other.roomId && this->bttv == other.bttv &&
+                   this->ffz == other.ffz &&
+                   this->bttvGlobal == other.bttvGlobal &&
+                   this->ffzGlobal == other.ffzGlobal;
+        }
+    };
+    EmoteSources indexSources_;
+    bool indexed_ = false;
+    CompletionIndex emoteIndex_;
+    // the emotes of the index, in the order they were added
+    std::vector<detail::CompletionEmote> indexedEmotes_;
 };
 
 }  // namespace chatterino
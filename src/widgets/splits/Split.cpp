@@ -87,7 +87,6 @@ Split::Split(QWidget *parent)
     , header_(new SplitHeader(this))
     , view_(new ChannelView(this))
     , input_(new SplitInput(this))
-    , overlay_(new SplitOverlay(this))
 {
     this->setMouseTracking(true);
     this->view_->setPausable(true);
@@ -177,7 +176,6 @@ Split::Split(QWidget *parent)
         this->signalHolder_);
 
     this->header_->updateModerationModeIcon();
-    this->overlay_->hide();
 
     this->setSizePolicy(QSizePolicy::MinimumExpanding,
                         QSizePolicy::MinimumExpanding);
@@ -188,11 +186,11 @@ Split::Split(QWidget *parent)
                  showSplitOverlayModifiers /*|| status == showAddSplitRegions*/) &&
                 this->isMouseOver_)
             {
-                this->overlay_->show();
+                this->showOverlay();
             }
             else
             {
-                this->overlay_->hide();
+                this->hideOverlay();
             }
 
             if (getSettings()->pauseChatModifier.getEnum() != Qt::NoModifier &&
@@ -251,11 +249,6 @@ Split::Split(QWidget *parent)
         },
         this->signalHolder_);
     this->addShortcuts();
-    this->signalHolder_.managedConnect(getApp()->hotkeys->onItemsUpdated,
-                                       [this]() {
-                                           this->clearShortcuts();
-                                           this->addShortcuts();
-                                       });
 }
 
 void Split::addShortcuts()
@@ -289,6 +282,11 @@ void Split::addShortcuts()
              popup->show();
              return "";
          }},
+        {"togglePerformanceOverlay",
+         [this](std::vector<QString>) -> QString {
+             this->view_->togglePerformanceOverlay();
+             return "";
+         }},
         {"focus",
          [this](std::vector<QString> arguments) -> QString {
              if (arguments.size() == 0)
@@ -637,6 +635,7 @@ ChannelPtr Split::getChannel()
 void Split::setChannel(IndirectChannel newChannel)
 {
     this->channel_ = newChannel;
+    getApp()->windows->queueDormancyUpdate();
 
     this->view_->setChannel(newChannel.get());
 
@@ -788,7 +787,29 @@ void Split::resizeEvent(QResizeEvent *event)
 
     BaseWidget::resizeEvent(event);
 
-    this->overlay_->setGeometry(this->rect());
+    if (this->overlay_ != nullptr)
+    {
+        this->overlay_->setGeometry(this->rect());
+    }
+}
+
+void Split::showOverlay()
+{
+    if (this->overlay_ == nullptr)
+    {
+        this->overlay_ = new SplitOverlay(this);
+        this->overlay_->setGeometry(this->rect());
+    }
+
+    this->overlay_->show();
+}
+
+void Split::hideOverlay()
+{
+    if (this->overlay_ != nullptr)
+    {
+        this->overlay_->hide();
+    }
 }
 
 void Split::enterEvent(QEvent *event)
@@ -800,7 +821,7 @@ void Split::enterEvent(QEvent *event)
     if (modifierStatus ==
         showSplitOverlayModifiers /*|| modifierStatus == showAddSplitRegions*/)
     {
-        this->overlay_->show();
+        this->showOverlay();
     }
 
     this->actionRequested.invoke(Action::ResetMouseStatus);
@@ -810,7 +831,7 @@ void Split::leaveEvent(QEvent *event)
 {
     this->isMouseOver_ = false;
 
-    this->overlay_->hide();
+    this->hideOverlay();
 
     TooltipWidget::instance()->hide();
 
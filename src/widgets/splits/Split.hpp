@@ -113,6 +113,9 @@ protected:
 private:
     void channelNameUpdated(const QString &newChannelName);
     void handleModifiers(Qt::KeyboardModifiers modifiers);
+    // the overlay is only created once it's shown the first time
+    void showOverlay();
+    void hideOverlay();
     void updateInputPlaceholder();
     void addShortcuts() override;
 
@@ -141,7 +144,7 @@ private:
     SplitHeader *header_;
     ChannelView *view_;
     SplitInput *input_;
-    SplitOverlay *overlay_;
+    SplitOverlay *overlay_{};
 
     NullablePtr<SelectChannelDialog> selectChannelDialog_;
 
@@ -17,18 +17,38 @@
 
 #include <QApplication>
 #include <QDebug>
+#include <QGuiApplication>
 #include <QHBoxLayout>
 #include <QJsonArray>
 #include <QJsonObject>
 #include <QMimeData>
 #include <QObject>
 #include <QPainter>
+#include <QScreen>
 #include <QVBoxLayout>
 #include <QWidget>
+#include <QWindow>
 #include <algorithm>
 #include <boost/foreach.hpp>
 
 namespace chatterino {
+namespace {
+    // How long a resize handle has to rest before the splits are resized
+    constexpr int DRAG_SETTLE_MS = 100;
+
+    // Milliseconds between two frames of the screen the widget is on
+    int frameInterval(QWidget *widget)
+    {
+        auto *handle = widget->window()->windowHandle();
+        auto *screen = handle != nullptr ? handle->screen()
+                                         : QGuiApplication::primaryScreen();
+        if (screen == nullptr || screen->refreshRate() <= 0)
+        {
+            return 16;
+        }
+        return std::max(1, int(1000 / screen->refreshRate()));
+    }
+}  // namespace
 
 bool SplitContainer::isDraggingSplit = false;
 Split *SplitContainer::draggingSplit = nullptr;
@@ -216,10 +236,7 @@ void SplitContainer::addSplit(Split *split)
 
     conns.managedConnect(split->getChannelView().tabHighlightRequested,
                          [this](HighlightState state) {
-                             if (this->tab_ != nullptr)
-                             {
-                                 this->tab_->setHighlightState(state);
-                             }
+                             this->queueTabHighlight(state);
                          });
 
     conns.managedConnect(split->getChannelView().liveStatusChanged, [this]() {
@@ -350,7 +367,9 @@ SplitContainer::Position SplitContainer::deleteSplit(Split *split)
     assert(split != nullptr);
 
     split->deleteLater();
-    return releaseSplit(split);
+    auto position = releaseSplit(split);
+    getApp()->windows->queueDormancyUpdate();
+    return position;
 }
 
 void SplitContainer::selectNextSplit(Direction direction)
@@ -462,6 +481,12 @@ Split *SplitContainer::getTopRightSplit(Node &node)
 }
 
 void SplitContainer::layout()
+{
+    this->baseNode_.invalidateRecursively();
+    this->layoutChanged();
+}
+
+void SplitContainer::layoutChanged(bool moveSplits)
 {
     if (this->disableLayouting_)
     {
@@ -483,7 +508,7 @@ void SplitContainer::layout()
     std::vector<ResizeRect> _resizeRects;
     this->baseNode_.layout(
         Split::modifierStatus == showAddSplitRegions || this->isDragging_,
-        this->scale(), _dropRects, _resizeRects);
+        this->scale(), moveSplits, _dropRects, _resizeRects);
 
     this->dropRects_ = _dropRects;
 
@@ -564,7 +589,7 @@ void SplitContainer::resizeEvent(QResizeEvent *event)
 {
     BaseWidget::resizeEvent(event);
 
-    this->layout();
+    this->layoutChanged();
 }
 
 void SplitContainer::mouseReleaseEvent(QMouseEvent *event)
@@ -749,6 +774,14 @@ const std::vector<Split *> SplitContainer::getSplits() const
     return this->splits_;
 }
 
+void SplitContainer::prefetchImages()
+{
+    for (auto *split : this->splits_)
+    {
+        split->getChannelView().prefetchImages();
+    }
+}
+
 SplitContainer::Node *SplitContainer::getBaseNode()
 {
     return &this->baseNode_;
@@ -902,6 +935,31 @@ void SplitContainer::refreshTabTitle()
     this->tab_->setDefaultTitle(newTitle);
 }
 
+void SplitContainer::queueTabHighlight(HighlightState state)
+{
+    if (state == HighlightState::Highlighted)
+    {
+        this->pendingHighlighted_ = true;
+    }
+    if (this->highlightQueued_)
+    {
+        return;
+    }
+    this->highlightQueued_ = true;
+
+    QTimer::singleShot(frameInterval(this), this, [this] {
+        auto state = this->pendingHighlighted_ ? HighlightState::Highlighted
+                                               : HighlightState::NewMessage;
+        this->highlightQueued_ = false;
+        this->pendingHighlighted_ = false;
+
+        if (this->tab_ != nullptr)
+        {
+            this->tab_->setHighlightState(state);
+        }
+    });
+}
+
 void SplitContainer::refreshTabLiveStatus()
 {
     if (this->tab_ == nullptr)
@@ -1210,9 +1268,66 @@ qreal SplitContainer::Node::getChildrensTotalFlex(bool isVertical)
                            });
 }
 
+void SplitContainer::Node::invalidate()
+{
+    for (auto *node = this; node != nullptr; node = node->parent_)
+    {
+        node->dirty_ = true;
+    }
+}
+
+void SplitContainer::Node::invalidateRecursively()
+{
+    this->dirty_ = true;
+    for (auto &child : this->children_)
+    {
+        child->invalidateRecursively();
+    }
+}
+
 void SplitContainer::Node::layout(bool addSpacing, float _scale,
+                                  bool moveSplits,
                                   std::vector<DropRect> &dropRects,
                                   std::vector<ResizeRect> &resizeRects)
+{
+    if (!this->dirty_ && this->layoutGeometry_ == this->geometry_ &&
+        this->layoutSpacing_ == addSpacing && this->layoutScale_ == _scale)
+    {
+        dropRects.insert(dropRects.end(), this->layoutDropRects_.begin(),
+                         this->layoutDropRects_.end());
+        resizeRects.insert(resizeRects.end(),
+                           this->layoutResizeRects_.begin(),
+                           this->layoutResizeRects_.end());
+        return;
+    }
+
+    auto dropStart = dropRects.size();
+    auto resizeStart = resizeRects.size();
+
+    this->layoutChildren(addSpacing, _scale, moveSplits, dropRects,
+                         resizeRects);
+
+    if (!moveSplits)
+    {
+        // some splits may not be where the geometry says
+        this->dirty_ = true;
+        return;
+    }
+
+    this->dirty_ = false;
+    this->layoutGeometry_ = this->geometry_;
+    this->layoutSpacing_ = addSpacing;
+    this->layoutScale_ = _scale;
+    this->layoutDropRects_.assign(dropRects.begin() + dropStart,
+                                  dropRects.end());
+    this->layoutResizeRects_.assign(resizeRects.begin() + resizeStart,
+                                    resizeRects.end());
+}
+
+void SplitContainer::Node::layoutChildren(bool addSpacing, float _scale,
+                                          bool moveSplits,
+                                          std::vector<DropRect> &dropRects,
+                                          std::vector<ResizeRect> &resizeRects)
 {
     for (std::unique_ptr<Node> &node : this->children_)
     {
@@ -1225,9 +1340,12 @@ void SplitContainer::Node::layout(bool addSpacing, float _scale,
     switch (this->type_)
     {
         case Node::_Split: {
-            QRect rect = this->geometry_.toRect();
-            this->split_->setGeometry(
-                rect.marginsRemoved(QMargins(1, 1, 0, 0)));
+            if (moveSplits)
+            {
+                QRect rect = this->geometry_.toRect();
+                this->split_->setGeometry(
+                    rect.marginsRemoved(QMargins(1, 1, 0, 0)));
+            }
         }
         break;
         case Node::VerticalContainer:
@@ -1333,7 +1451,8 @@ void SplitContainer::Node::layout(bool addSpacing, float _scale,
                 }
 
                 child->geometry_ = rect;
-                child->layout(addSpacing, _scale, dropRects, resizeRects);
+                child->layout(addSpacing, _scale, moveSplits, dropRects,
+                              resizeRects);
 
                 pos += child->getSize(isVertical);
 
@@ -1483,6 +1602,17 @@ SplitContainer::ResizeHandle::ResizeHandle(SplitContainer *_parent)
 {
     this->setMouseTracking(true);
     this->hide();
+
+    this->dragTimer_.setSingleShot(true);
+    QObject::connect(&this->dragTimer_, &QTimer::timeout, this, [this] {
+        this->applyDrag();
+    });
+
+    this->settleTimer_.setSingleShot(true);
+    this->settleTimer_.setInterval(DRAG_SETTLE_MS);
+    QObject::connect(&this->settleTimer_, &QTimer::timeout, this, [this] {
+        this->parent->layoutChanged();
+    });
 }
 
 void SplitContainer::ResizeHandle::paintEvent(QPaintEvent *)
@@ -1508,6 +1638,7 @@ void SplitContainer::ResizeHandle::paintEvent(QPaintEvent *)
 void SplitContainer::ResizeHandle::mousePressEvent(QMouseEvent *event)
 {
     this->isMouseDown_ = true;
+    this->dragTimer_.setInterval(frameInterval(this));
 
     if (event->button() == Qt::RightButton)
     {
@@ -1518,6 +1649,17 @@ void SplitContainer::ResizeHandle::mousePressEvent(QMouseEvent *event)
 void SplitContainer::ResizeHandle::mouseReleaseEvent(QMouseEvent *)
 {
     this->isMouseDown_ = false;
+
+    if (this->dragTimer_.isActive())
+    {
+        this->dragTimer_.stop();
+        this->applyDrag();
+    }
+    if (this->settleTimer_.isActive())
+    {
+        this->settleTimer_.stop();
+        this->parent->layoutChanged();
+    }
 }
 
 void SplitContainer::ResizeHandle::mouseMoveEvent(QMouseEvent *event)
@@ -1527,6 +1669,15 @@ void SplitContainer::ResizeHandle::mouseMoveEvent(QMouseEvent *event)
         return;
     }
 
+    this->dragPosition_ = event->globalPos();
+    if (!this->dragTimer_.isActive())
+    {
+        this->dragTimer_.start();
+    }
+}
+
+void SplitContainer::ResizeHandle::applyDrag()
+{
     assert(node != nullptr);
     assert(node->parent_ != nullptr);
 
@@ -1544,14 +1695,10 @@ void SplitContainer::ResizeHandle::mouseMoveEvent(QMouseEvent *event)
     QPoint bottomRight = this->parent->mapToGlobal(
         this->node->geometry_.bottomRight().toPoint());
 
-    int globalX = topLeft.x() > event->globalX()
-                      ? topLeft.x()
-                      : (bottomRight.x() < event->globalX() ? bottomRight.x()
-                                                            : event->globalX());
-    int globalY = topLeft.y() > event->globalY()
-                      ? topLeft.y()
-                      : (bottomRight.y() < event->globalY() ? bottomRight.y()
-                                                            : event->globalY());
+    int globalX = std::clamp(this->dragPosition_.x(), topLeft.x(),
+                             std::max(topLeft.x(), bottomRight.x()));
+    int globalY = std::clamp(this->dragPosition_.y(), topLeft.y(),
+                             std::max(topLeft.y(), bottomRight.y()));
 
     QPoint mousePoint(globalX, globalY);
 
@@ -1561,11 +1708,6 @@ void SplitContainer::ResizeHandle::mouseMoveEvent(QMouseEvent *event)
         before->flexV_ = totalFlexV * (mousePoint.y() - topLeft.y()) /
                          (bottomRight.y() - topLeft.y());
         this->node->flexV_ = totalFlexV - before->flexV_;
-
-        this->parent->layout();
-
-        // move handle
-        this->move(this->x(), int(before->geometry_.bottom() - 4));
     }
     else
     {
@@ -1573,10 +1715,20 @@ void SplitContainer::ResizeHandle::mouseMoveEvent(QMouseEvent *event)
         before->flexH_ = totalFlexH * (mousePoint.x() - topLeft.x()) /
                          (bottomRight.x() - topLeft.x());
         this->node->flexH_ = totalFlexH - before->flexH_;
+    }
 
-        this->parent->layout();
+    // only the siblings of the handle are affected
+    this->node->parent_->invalidate();
+    this->parent->layoutChanged(false);
+    this->settleTimer_.start();
 
-        // move handle
+    // move handle
+    if (this->vertical_)
+    {
+        this->move(this->x(), int(before->geometry_.bottom() - 4));
+    }
+    else
+    {
         this->move(int(before->geometry_.right() - 4), this->y());
     }
 }
@@ -1596,7 +1748,8 @@ void SplitContainer::ResizeHandle::resetFlex()
         sibling->flexV_ = 1;
     }
 
-    this->parent->layout();
+    this->node->getParent()->invalidate();
+    this->parent->layoutChanged();
 }
 
 }  // namespace chatterino
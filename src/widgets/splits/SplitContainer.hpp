@@ -6,6 +6,7 @@
 #include <QDragEnterEvent>
 #include <QHBoxLayout>
 #include <QRect>
+#include <QTimer>
 #include <QVBoxLayout>
 #include <QVector>
 #include <QWidget>
@@ -20,6 +21,7 @@ class QJsonObject;
 
 namespace chatterino {
 
+enum class HighlightState;
 class Split;
 class NotebookTab;
 class Notebook;
@@ -105,9 +107,20 @@ public:
         qreal getFlex(bool isVertical);
         qreal getSize(bool isVertical);
         qreal getChildrensTotalFlex(bool isVertical);
-        void layout(bool addSpacing, float _scale,
+        /// Marks this node and its parents to be laid out again. Needed
+        /// whenever the flex of its children changed.
+        void invalidate();
+        void invalidateRecursively();
+        /// Only lays out the subtree again if it was invalidated or its
+        /// geometry changed, otherwise the rects of the last layout are
+        /// reused. With !moveSplits, the splits keep their geometry and stay
+        /// dirty until the next layout that moves them.
+        void layout(bool addSpacing, float _scale, bool moveSplits,
                     std::vector<DropRect> &dropRects_,
                     std::vector<ResizeRect> &resizeRects);
+        void layoutChildren(bool addSpacing, float _scale, bool moveSplits,
+                            std::vector<DropRect> &dropRects_,
+                            std::vector<ResizeRect> &resizeRects);
 
         static Type toContainerType(Direction _dir);
 
@@ -120,6 +133,14 @@ public:
         qreal flexV_ = 1;
         std::vector<std::unique_ptr<Node>> children_;
 
+        // what the last layout of the subtree was done with and produced
+        bool dirty_ = true;
+        QRectF layoutGeometry_;
+        bool layoutSpacing_{};
+        float layoutScale_{};
+        std::vector<DropRect> layoutDropRects_;
+        std::vector<ResizeRect> layoutResizeRects_;
+
         friend class SplitContainer;
     };
 
@@ -164,9 +185,17 @@ private:
 
     private:
         void resetFlex();
+        // moves the handle to the last mouse position
+        void applyDrag();
 
         bool vertical_;
         bool isMouseDown_ = false;
+
+        QPoint dragPosition_;
+        // mouse moves are applied at most once per frame
+        QTimer dragTimer_;
+        // the splits are only resized once the drag pauses
+        QTimer settleTimer_;
     };
 
 public:
@@ -187,6 +216,9 @@ public:
 
     int getSplitCount();
     const std::vector<Split *> getSplits() const;
+    /// Loads the images of the splits while the container is hidden, e.g.
+    /// when its tab is about to be selected
+    void prefetchImages();
 
     void refreshTab();
 
@@ -221,6 +253,9 @@ private:
                                         Node *node);
 
     void layout();
+    /// Lays out only the nodes that changed since the last layout. Splits
+    /// keep their geometry with !moveSplits, see Node::layout.
+    void layoutChanged(bool moveSplits = true);
     void selectSplitRecursive(Node *node, Direction direction);
     void focusSplitRecursive(Node *node);
     void setPreferedTargetRecursive(Node *node);
@@ -231,6 +266,9 @@ private:
 
     void refreshTabTitle();
     void refreshTabLiveStatus();
+    /// Passes the strongest state requested by the splits to the tab, at
+    /// most once per frame
+    void queueTabHighlight(HighlightState state);
 
     struct DropRegion {
         QRect rect;
@@ -263,6 +301,9 @@ private:
     pajlada::Signals::SignalHolder signalHolder_;
 
     bool isDragging_ = false;
+
+    bool highlightQueued_ = false;
+    bool pendingHighlighted_ = false;
 };
 
 }  // namespace chatterino
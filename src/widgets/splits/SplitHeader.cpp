@@ -22,13 +22,16 @@
 #include "widgets/splits/Split.hpp"
 #include "widgets/splits/SplitContainer.hpp"
 
+#include <QBuffer>
 #include <QDesktopWidget>
 #include <QDrag>
 #include <QHBoxLayout>
+#include <QImageReader>
 #include <QInputDialog>
 #include <QMenu>
 #include <QMimeData>
 #include <QPainter>
+#include <QTimer>
 #include <cmath>
 
 #ifdef USEWEBENGINE
@@ -86,7 +89,8 @@ namespace {
 
         return text;
     }
-    auto formatTooltip(const TwitchChannel::StreamStatus &s, QString thumbnail)
+    auto formatTooltip(const TwitchChannel::StreamStatus &s,
+                       bool thumbnailFailed)
     {
         auto title = [&s]() -> QString {
             if (s.title.isEmpty())
@@ -97,18 +101,15 @@ namespace {
             return s.title.toHtmlEscaped() + "<br><br>";
         }();
 
-        auto tooltip = [&thumbnail]() -> QString {
-            if (getSettings()->thumbnailSizeStream.getValue() == 0)
+        // the thumbnail itself is shown as the image of the tooltip
+        auto tooltip = [thumbnailFailed]() -> QString {
+            if (getSettings()->thumbnailSizeStream.getValue() == 0 ||
+                !thumbnailFailed)
             {
                 return QStringLiteral("");
             }
 
-            if (thumbnail.isEmpty())
-            {
-                return QStringLiteral("Couldn't fetch thumbnail<br>");
-            }
-
-            return "<img src=\"data:image/jpg;base64, " + thumbnail + "\"><br>";
+            return QStringLiteral("Couldn't fetch thumbnail<br>");
         }();
 
         auto game = [&s]() -> QString {
@@ -190,6 +191,13 @@ SplitHeader::SplitHeader(Split *_split)
     this->initializeLayout();
 
     this->setMouseTracking(true);
+
+    this->thumbnailTimer_.setSingleShot(true);
+    this->thumbnailTimer_.setInterval(THUMBNAIL_HOVER_DELAY_MS);
+    QObject::connect(&this->thumbnailTimer_, &QTimer::timeout, this, [this] {
+        this->fetchThumbnail();
+    });
+
     this->updateChannelText();
     this->handleChannelChanged();
     this->updateModerationModeIcon();
@@ -241,7 +249,14 @@ void SplitHeader::initializeLayout()
             w->setSizePolicy(QSizePolicy::Minimum, QSizePolicy::Minimum);
             w->hide();
             this->initializeModeSignals(*w);
-            w->setMenu(this->createChatModeMenu());
+            // the menu is only created once it's opened the first time
+            QObject::connect(w, &Button::leftMousePress, this, [this, w] {
+                if (!this->chatModeMenuCreated_)
+                {
+                    this->chatModeMenuCreated_ = true;
+                    w->setMenu(this->createChatModeMenu());
+                }
+            });
         }),
         // moderator
         this->moderationButton_ = makeWidget<Button>([&](auto w) {
@@ -317,15 +332,6 @@ void SplitHeader::initializeLayout()
             }
         });
 
-    getSettings()->customURIScheme.connect(
-        [this] {
-            if (const auto drop = this->dropdownButton_)
-            {
-                drop->setMenu(this->createMainMenu());
-            }
-        },
-        this->managedConnections_);
-
     layout->setMargin(0);
     layout->setSpacing(0);
     this->setLayout(layout);
@@ -639,8 +645,105 @@ void SplitHeader::initializeModeSignals(EffectLabel &label)
 
 void SplitHeader::resetThumbnail()
 {
+    this->thumbnailTimer_.stop();
     this->lastThumbnail_.invalidate();
-    this->thumbnail_.clear();
+    this->thumbnail_ = QPixmap();
+    this->thumbnailFailed_ = false;
+}
+
+void SplitHeader::fetchThumbnail()
+{
+    auto channel = this->split_->getChannel();
+    auto *twitchChannel = dynamic_cast<TwitchChannel *>(channel.get());
+    if (twitchChannel == nullptr || !twitchChannel->isLive())
+    {
+        return;
+    }
+
+    QSize size;
+    switch (getSettings()->thumbnailSizeStream.getValue())
+    {
+        case 1:
+            size = {80, 45};
+            break;
+        case 2:
+            size = {160, 90};
+            break;
+        case 3:
+            size = {360, 203};
+            break;
+        default:
+            return;
+    }
+
+    if (this->lastThumbnail_.isValid() &&
+        this->lastThumbnail_.elapsed() < THUMBNAIL_LIFETIME_MS)
+    {
+        return;
+    }
+    this->lastThumbnail_.restart();
+
+    // XXX: This URL format can be figured out from the Helix Get Streams API which we parse in TwitchChannel::parseLiveStatus
+    auto url = QString("https://static-cdn.jtvnw.net/previews-ttv/"
+                       "live_user_%1-%2x%3.jpg")
+                   .arg(channel->getName().toLower())
+                   .arg(size.width())
+                   .arg(size.height());
+
+    NetworkRequest(url, NetworkRequestType::Get)
+        .caller(this)
+        .onSuccess([this, size](auto result) -> Outcome {
+            QImage image;
+            // NOTE: We do not follow the redirects, so we need to make sure we only treat code 200 as a valid image
+            if (result.status() == 200)
+            {
+                // decoded once at the size of the tooltip instead of every
+                // time the tooltip is shown
+                auto data = result.getData();
+                QBuffer buffer(&data);
+                buffer.open(QIODevice::ReadOnly);
+                QImageReader reader(&buffer);
+                if (reader.size().isValid() &&
+                    (reader.size().width() > size.width() ||
+                     reader.size().height() > size.height()))
+                {
+                    reader.setScaledSize(
+                        reader.size().scaled(size, Qt::KeepAspectRatio));
+                }
+                image = reader.read();
+            }
+
+            this->thumbnail_ = QPixmap::fromImage(image);
+            this->thumbnailFailed_ = image.isNull();
+            this->updateChannelText();
+            if (this->underMouse())
+            {
+                this->showTooltip();
+            }
+
+            // the thumbnail is only kept for a short while after the header
+            // was hovered, the next hover fetches a new one
+            QTimer::singleShot(THUMBNAIL_LIFETIME_MS, this, [this] {
+                if (!this->underMouse() && this->lastThumbnail_.isValid() &&
+                    this->lastThumbnail_.elapsed() >= THUMBNAIL_LIFETIME_MS)
+                {
+                    this->resetThumbnail();
+                    this->updateChannelText();
+                }
+            });
+            return Success;
+        })
+        .onError([this](auto /*result*/) {
+            this->thumbnail_ = QPixmap();
+            this->thumbnailFailed_ = true;
+            this->updateChannelText();
+            if (this->underMouse())
+            {
+                this->showTooltip();
+            }
+            return true;
+        })
+        .execute();
 }
 
 void SplitHeader::handleChannelChanged()
@@ -701,47 +804,9 @@ void SplitHeader::updateChannelText()
         if (streamStatus->live)
         {
             this->isLive_ = true;
-            // XXX: This URL format can be figured out from the Helix Get Streams API which we parse in TwitchChannel::parseLiveStatus
-            QString url = "https://static-cdn.jtvnw.net/"
-                          "previews-ttv/live_user_" +
-                          channel->getName().toLower();
-            switch (getSettings()->thumbnailSizeStream.getValue())
-            {
-                case 1:
-                    url.append("-80x45.jpg");
-                    break;
-                case 2:
-                    url.append("-160x90.jpg");
-                    break;
-                case 3:
-                    url.append("-360x203.jpg");
-                    break;
-                default:
-                    url = "";
-            }
-            if (!url.isEmpty() &&
-                (!this->lastThumbnail_.isValid() ||
-                 this->lastThumbnail_.elapsed() > 5 * 60 * 1000))
-            {
-                NetworkRequest(url, NetworkRequestType::Get)
-                    .onSuccess([this](auto result) -> Outcome {
-                        // NOTE: We do not follow the redirects, so we need to make sure we only treat code 200 as a valid image
-                        if (result.status() == 200)
-                        {
-                            this->thumbnail_ = QString::fromLatin1(
-                                result.getData().toBase64());
-                        }
-                        else
-                        {
-                            this->thumbnail_.clear();
-                        }
-                        this->updateChannelText();
-                        return Success;
-                    })
-                    .execute();
-                this->lastThumbnail_.restart();
-            }
-            this->tooltipText_ = formatTooltip(*streamStatus, this->thumbnail_);
+            // the thumbnail is only fetched once the header is hovered
+            this->tooltipText_ =
+                formatTooltip(*streamStatus, this->thumbnailFailed_);
             title += formatTitle(*streamStatus, *getSettings());
         }
         else
@@ -865,25 +930,50 @@ void SplitHeader::enterEvent(QEvent *event)
             dynamic_cast<TwitchChannel *>(channel)->refreshTitle();
         }
 
-        TooltipPreviewImage::instance().setImage(nullptr);
-
-        auto tooltip = TooltipWidget::instance();
-        tooltip->setText(this->tooltipText_);
-        tooltip->setWordWrap(true);
-        tooltip->adjustSize();
-        auto pos = this->mapToGlobal(this->rect().bottomLeft()) +
-                   QPoint((this->width() - tooltip->width()) / 2, 1);
+        if (this->isLive_)
+        {
+            // moving the mouse across headers doesn't fetch thumbnails
+            this->thumbnailTimer_.start();
+        }
 
-        tooltip->moveTo(this, pos, false);
-        tooltip->show();
-        tooltip->raise();
+        this->showTooltip();
     }
 
     BaseWidget::enterEvent(event);
 }
 
+void SplitHeader::showTooltip()
+{
+    if (this->tooltipText_.isEmpty())
+    {
+        return;
+    }
+
+    TooltipPreviewImage::instance().setImage(nullptr);
+
+    auto tooltip = TooltipWidget::instance();
+    tooltip->setText(this->tooltipText_);
+    if (this->isLive_ && !this->thumbnail_.isNull())
+    {
+        tooltip->setImage(this->thumbnail_);
+    }
+    else
+    {
+        tooltip->clearImage();
+    }
+    tooltip->setWordWrap(true);
+    tooltip->adjustSize();
+    auto pos = this->mapToGlobal(this->rect().bottomLeft()) +
+               QPoint((this->width() - tooltip->width()) / 2, 1);
+
+    tooltip->moveTo(this, pos, false);
+    tooltip->show();
+    tooltip->raise();
+}
+
 void SplitHeader::leaveEvent(QEvent *event)
 {
+    this->thumbnailTimer_.stop();
     TooltipWidget::instance()->hide();
 
     BaseWidget::leaveEvent(event);
@@ -11,6 +11,8 @@
 #include <vector>
 
 #include <QElapsedTimer>
+#include <QPixmap>
+#include <QTimer>
 
 namespace chatterino {
 
@@ -56,14 +58,24 @@ private:
      *          thumbnail can be fetched
      **/
     void resetThumbnail();
+    /// Fetches the thumbnail of a live channel unless the last one is still
+    /// fresh, and shows it if the header is still hovered
+    void fetchThumbnail();
+    void showTooltip();
 
     void handleChannelChanged();
 
     Split *const split_{};
     QString tooltipText_{};
     bool isLive_{false};
-    QString thumbnail_;
+    // how long the mouse has to stay on the header to fetch a thumbnail
+    static constexpr int THUMBNAIL_HOVER_DELAY_MS = 300;
+    static constexpr int THUMBNAIL_LIFETIME_MS = 2 * 60 * 1000;
+
+    QPixmap thumbnail_;
+    bool thumbnailFailed_{false};
     QElapsedTimer lastThumbnail_;
+    QTimer thumbnailTimer_;
     std::chrono::steady_clock::time_point lastReloadedChannelEmotes_;
     std::chrono::steady_clock::time_point lastReloadedSubEmotes_;
 
@@ -80,6 +92,7 @@ private:
     bool dragging_{false};
     bool doubleClicked_{false};
     bool menuVisible_{false};
+    bool chatModeMenuCreated_{false};
 
     // signals
     pajlada::Signals::NoArgSignal modeUpdateRequested_;
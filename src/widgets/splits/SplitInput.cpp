@@ -10,6 +10,7 @@
 #include "singletons/Settings.hpp"
 #include "singletons/Theme.hpp"
 #include "util/Clamp.hpp"
+#include "util/FrameScheduler.hpp"
 #include "util/Helpers.hpp"
 #include "util/LayoutCreator.hpp"
 #include "widgets/Notebook.hpp"
@@ -25,6 +26,7 @@
 
 #include <QCompleter>
 #include <QPainter>
+#include <QTextBlock>
 
 namespace chatterino {
 const int TWITCH_MESSAGE_LIMIT = 500;
@@ -44,8 +46,23 @@ SplitInput::SplitInput(Split *_chatWidget)
         auto completer =
             new QCompleter(&this->split_->getChannel()->completionModel);
         this->ui_.textEdit->setCompleter(completer);
+
+        this->queuedMessages_ = 0;
+        this->updateLengthLabel();
     });
 
+    this->signalHolder_.managedConnect(
+        getApp()->twitch->sendQueueChanged,
+        [this](const QString &channelName, int queuedMessages) {
+            if (this->split_->getChannel()->getName() != channelName)
+            {
+                return;
+            }
+
+            this->queuedMessages_ = queuedMessages;
+            this->updateLengthLabel();
+        });
+
     // misc
     this->installKeyPressedEvent();
     this->addShortcuts();
@@ -53,11 +70,6 @@ SplitInput::SplitInput(Split *_chatWidget)
         this->hideCompletionPopup();
     });
     this->scaleChangedEvent(this->scale());
-    this->signalHolder_.managedConnect(getApp()->hotkeys->onItemsUpdated,
-                                       [this]() {
-                                           this->clearShortcuts();
-                                           this->addShortcuts();
-                                       });
 }
 
 void SplitInput::initLayout()
@@ -70,10 +82,7 @@ void SplitInput::initLayout()
             &this->ui_.hbox);
 
     // input
-    auto textEdit =
-        layout.emplace<ResizingTextEdit>().assign(&this->ui_.textEdit);
-    connect(textEdit.getElement(), &ResizingTextEdit::textChanged, this,
-            &SplitInput::editTextChanged);
+    layout.emplace<ResizingTextEdit>().assign(&this->ui_.textEdit);
 
     // right box
     auto box = layout.emplace<QVBoxLayout>().withoutMargin();
@@ -523,12 +532,26 @@ void SplitInput::installKeyPressedEvent()
 
 void SplitInput::onTextChanged()
 {
-    this->updateCompletionPopup();
+    this->queueInputUpdate(true);
 }
 
 void SplitInput::onCursorPositionChanged()
 {
-    this->updateCompletionPopup();
+    this->queueInputUpdate(false);
+}
+
+void SplitInput::queueInputUpdate(bool textChanged)
+{
+    this->textDirty_ |= textChanged;
+
+    FrameScheduler::instance().request(this, FrameStage::Layout, [this] {
+        if (this->textDirty_)
+        {
+            this->textDirty_ = false;
+            this->editTextChanged();
+        }
+        this->updateCompletionPopup();
+    });
 }
 
 void SplitInput::updateCompletionPopup()
@@ -545,11 +568,12 @@ void SplitInput::updateCompletionPopup()
         return;
     }
 
-    // check if in completion prefix
-    auto &edit = *this->ui_.textEdit;
+    // check if in completion prefix, only the word at the cursor matters and
+    // words don't span lines
+    auto cursor = this->ui_.textEdit->textCursor();
 
-    auto text = edit.toPlainText();
-    auto position = edit.textCursor().position() - 1;
+    auto text = cursor.block().text();
+    auto position = cursor.positionInBlock() - 1;
 
     if (text.length() == 0 || position == -1)
     {
@@ -729,7 +753,25 @@ void SplitInput::editTextChanged()
         labelText = "";
     }
 
-    this->ui_.textEditLength->setText(labelText);
+    this->lengthText_ = labelText;
+    this->updateLengthLabel();
+}
+
+void SplitInput::updateLengthLabel()
+{
+    if (this->queuedMessages_ == 0)
+    {
+        this->ui_.textEditLength->setText(this->lengthText_);
+        this->ui_.textEditLength->setToolTip("");
+        return;
+    }
+
+    auto queuedText = QString("%1 queued").arg(this->queuedMessages_);
+    this->ui_.textEditLength->setText(
+        this->lengthText_.isEmpty() ? queuedText
+                                    : queuedText + " " + this->lengthText_);
+    this->ui_.textEditLength->setToolTip(
+        "Messages waiting to be sent because of Twitch's rate limits");
 }
 
 void SplitInput::paintEvent(QPaintEvent *)
@@ -50,9 +50,13 @@ private:
     void installKeyPressedEvent();
     void onCursorPositionChanged();
     void onTextChanged();
+    // edits are handled once per frame, no matter how many there were
+    void queueInputUpdate(bool textChanged);
     void updateEmoteButton();
     void updateCompletionPopup();
     void showCompletionPopup(const QString &text, bool emoteCompletion);
+    // shows the message length and the messages waiting for the rate limits
+    void updateLengthLabel();
     void hideCompletionPopup();
     void insertCompletionText(const QString &text);
     void openEmotePopup();
@@ -73,6 +77,11 @@ private:
     QStringList prevMsg_;
     QString currMsg_;
     int prevIndex_ = 0;
+    QString lengthText_;
+    int queuedMessages_ = 0;
+    // whether the queued input update has to handle a changed text, not only
+    // a moved cursor
+    bool textDirty_ = false;
 
 private slots:
     void editTextChanged();
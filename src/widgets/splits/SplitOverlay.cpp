@@ -30,14 +30,15 @@ SplitOverlay::SplitOverlay(Split *parent)
     layout->setColumnStretch(1, 1);
     layout->setColumnStretch(3, 1);
 
-    auto *move = new QPushButton(getResources().split.move, QString());
+    auto *move = new QPushButton(getResources().split.move.get(), QString());
     auto *left = this->left_ =
-        new QPushButton(getResources().split.left, QString());
+        new QPushButton(getResources().split.left.get(), QString());
     auto *right = this->right_ =
-        new QPushButton(getResources().split.right, QString());
-    auto *up = this->up_ = new QPushButton(getResources().split.up, QString());
+        new QPushButton(getResources().split.right.get(), QString());
+    auto *up = this->up_ =
+        new QPushButton(getResources().split.up.get(), QString());
     auto *down = this->down_ =
-        new QPushButton(getResources().split.down, QString());
+        new QPushButton(getResources().split.down.get(), QString());
 
     move->setGraphicsEffect(new QGraphicsOpacityEffect(this));
     left->setGraphicsEffect(new QGraphicsOpacityEffect(this));
@@ -0,0 +1,61 @@
+#include "debug/AllocationCounter.hpp"
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+// keeps the compiler from leaving out the allocations
+std::vector<int> *sink = nullptr;
+
+}  // namespace
+
+TEST(AllocationCounter, CountsThisThread)
+{
+    ASSERT_TRUE(AllocationCounter::available());
+
+    AllocationCounter counter;
+    sink = new std::vector<int>(16);
+    EXPECT_EQ(counter.allocations(), 2);
+    EXPECT_GE(counter.bytes(), int64_t(sizeof(int) * 16));
+
+    AllocationCounter nested;
+    delete sink;
+    sink = nullptr;
+    EXPECT_EQ(nested.allocations(), 0);
+    EXPECT_EQ(counter.allocations(), 2);
+
+    // only starting the thread allocates here
+    AllocationCounter threads;
+    std::thread([] {
+        for (int i = 0; i < 100; i++)
+        {
+            delete new std::vector<int>(16);
+        }
+    }).join();
+    EXPECT_LT(threads.allocations(), 10);
+}
+
+TEST(AllocationCounter, TwitchIrcLineParsesInPlace)
+{
+    QByteArray data(
+        "@badge-info=subscriber/14;badges=subscriber/12,bits/1000;"
+        "color=#1E90FF;display-name=SubUser;emotes=25:6-10;first-msg=0;flags=;id=2a1b7a3e-"
+        "0c1f-4b4e-9d3c-1a2b3c4d5e02;mod=0;room-id=11148817;subscriber=1;"
+        "tmi-sent-ts=1642715612000;turbo=0;user-id=100000002;user-type= "
+        ":subuser!subuser@subuser.tmi.twitch.tv PRIVMSG #pajlada :pog! Kappa");
+
+    AllocationCounter counter;
+    auto line = TwitchIrcLine::parse(data);
+    ASSERT_TRUE(line);
+    EXPECT_TRUE(line->isCommand(QLatin1String("PRIVMSG")));
+    EXPECT_TRUE(line->hasTag(QLatin1String("room-id")));
+
+    // the positions of up to 24 tags are kept inline
+    EXPECT_EQ(counter.allocations(), 0);
+}
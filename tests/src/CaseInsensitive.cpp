@@ -0,0 +1,93 @@
+#include "util/CaseInsensitive.hpp"
+
+#include <QString>
+#include <QStringList>
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+// ASCII of every length around the vector size, and a few strings that take
+// Qt's path
+QStringList samples()
+{
+    QStringList samples{
+        "",
+        "a",
+        "Kappa",
+        "KAPPA",
+        "kappa123",
+        "pajlada",
+        "PaJlAdA",
+        "@pajlada: forsenE",
+        "supinic: this is a rather long message with Kappa in it",
+        "supinic: THIS IS A RATHER LONG MESSAGE WITH kappa IN IT",
+        "[\\]^_`{|}~ @AZaz",
+        QString::fromUtf8("Éric"),
+        QString::fromUtf8("éRIC"),
+        // the Kelvin sign folds to 'k'
+        QString::fromUtf8("Kappa"),
+        QString::fromUtf8("straße"),
+        QString::fromUtf8("\U0001F600 Kappa"),
+    };
+    QString letters = "aBcDeFgHiJkLmNoPqRsT";
+    for (int length = 1; length <= letters.size(); length++)
+    {
+        samples.append(letters.left(length));
+        samples.append(letters.left(length).toUpper());
+        samples.append(letters.left(length - 1) + "!");
+    }
+    return samples;
+}
+
+}  // namespace
+
+TEST(CaseInsensitive, IsAscii)
+{
+    EXPECT_TRUE(isAscii(u""));
+    EXPECT_TRUE(isAscii(u"abcdefghijklmnopqrstuvwxyz"));
+    EXPECT_FALSE(isAscii(QString::fromUtf8("abcdefghijklmnopqrstuvwxyé")));
+    EXPECT_FALSE(isAscii(QString::fromUtf8("éabcdefghijklmnopqrstuvwxy")));
+    EXPECT_FALSE(isAscii(QString::fromUtf8("abcdefgh\u0080")));
+}
+
+TEST(CaseInsensitive, SameAsQt)
+{
+    auto strings = samples();
+    for (const auto &a : strings)
+    {
+        for (const auto &b : strings)
+        {
+            EXPECT_EQ(equalsIgnoreCase(a, b),
+                      QString::compare(a, b, Qt::CaseInsensitive) == 0)
+                << a.toStdString() << b.toStdString();
+            EXPECT_EQ(startsWithIgnoreCase(a, b),
+                      a.startsWith(b, Qt::CaseInsensitive))
+                << a.toStdString() << b.toStdString();
+            EXPECT_EQ(indexOfIgnoreCase(a, b),
+                      a.indexOf(b, 0, Qt::CaseInsensitive))
+                << a.toStdString() << b.toStdString();
+
+            for (int from : {1, 7, 9, -3})
+            {
+                EXPECT_EQ(indexOfIgnoreCase(a, b, from),
+                          a.indexOf(b, from, Qt::CaseInsensitive))
+                    << a.toStdString() << b.toStdString() << from;
+            }
+        }
+    }
+}
+
+TEST(CaseInsensitive, FindsEveryPosition)
+{
+    QString haystack = QString("x").repeated(40);
+    for (int i = 0; i + 3 <= haystack.size(); i++)
+    {
+        auto text = QString(haystack).replace(i, 3, "KaP");
+        EXPECT_EQ(indexOfIgnoreCase(text, u"kap"), i);
+        EXPECT_EQ(indexOfIgnoreCase(text, u"kap", i + 1), -1);
+        EXPECT_TRUE(containsIgnoreCase(text, u"KAP"));
+    }
+    EXPECT_FALSE(containsIgnoreCase(haystack, u"kap"));
+}
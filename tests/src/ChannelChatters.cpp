@@ -111,3 +111,27 @@ TEST(ChatterChatters, insertMaxSize)
     EXPECT_EQ(chatters.getUserColor("zneix"), QColor());
     EXPECT_EQ(chatters.getUserColor("user1"), QColor("#00f"));
 }
+
+// Ensure looking up a color doesn't keep it from being dropped, only setting
+// it does
+TEST(ChatterChatters, onlySettingRefreshesColor)
+{
+    MockChannel channel("test");
+
+    ChannelChatters chatters(channel);
+
+    chatters.setUserColor("pajlada", QColor("#f00"));
+    chatters.setUserColor("zneix", QColor("#f0f"));
+    EXPECT_EQ(chatters.getUserColor("pajlada"), QColor("#f00"));
+    chatters.setUserColor("zneix", QColor("#0f0"));
+
+    for (int i = 0; i < ChannelChatters::maxChatterColorCount - 1; ++i)
+    {
+        chatters.setUserColor(QString("user%1").arg(i), QColor("#00f"));
+    }
+
+    EXPECT_EQ(chatters.colorsSize(),
+              size_t(ChannelChatters::maxChatterColorCount));
+    EXPECT_EQ(chatters.getUserColor("pajlada"), QColor());
+    EXPECT_EQ(chatters.getUserColor("zneix"), QColor("#0f0"));
+}
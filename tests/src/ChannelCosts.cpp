@@ -0,0 +1,68 @@
+#include "util/ChannelCosts.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <thread>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+int64_t costOf(const QString &channel, CostCategory category)
+{
+    for (const auto &cost : ChannelCosts::channels())
+    {
+        if (cost.name == channel)
+        {
+            return cost.nanoseconds[size_t(category)];
+        }
+    }
+    return 0;
+}
+
+}  // namespace
+
+TEST(ChannelCosts, AddsUpThreads)
+{
+    ChannelCosts::reset();
+
+    ChannelCosts::add("forsen", CostCategory::Building, 2ms);
+    std::thread([] {
+        ChannelCosts::add("forsen", CostCategory::Building, 3ms);
+        ChannelCosts::add("pajlada", CostCategory::Filters, 1ms);
+        ChannelCosts::add("", CostCategory::Filters, 1ms);
+    }).join();
+
+    auto channels = ChannelCosts::channels();
+    ASSERT_EQ(channels.size(), 2u);
+    EXPECT_EQ(channels[0].name, "forsen");
+    EXPECT_EQ(channels[0].total(), 5'000'000);
+    EXPECT_EQ(channels[1].name, "pajlada");
+    EXPECT_EQ(costOf("pajlada", CostCategory::Filters), 1'000'000);
+
+    ChannelCosts::reset();
+    EXPECT_TRUE(ChannelCosts::channels().empty());
+}
+
+TEST(ChannelCosts, NestedScopesArentCountedTwice)
+{
+    ChannelCosts::reset();
+
+    {
+        ChannelCosts::Scope building("forsen", CostCategory::Building);
+        {
+            ChannelCosts::Scope highlights("pajlada",
+                                           CostCategory::Highlights);
+            EXPECT_EQ(ChannelCosts::current(), "pajlada");
+            std::this_thread::sleep_for(20ms);
+        }
+        EXPECT_EQ(ChannelCosts::current(), "forsen");
+    }
+    EXPECT_EQ(ChannelCosts::current(), "");
+
+    auto highlights = costOf("pajlada", CostCategory::Highlights);
+    EXPECT_GE(highlights, 20'000'000);
+    EXPECT_LT(costOf("forsen", CostCategory::Building), highlights);
+}
@@ -0,0 +1,72 @@
+#include "providers/twitch/ChannelEmoteIndex.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+std::shared_ptr<const EmoteMap> makeEmotes(const QStringList &names,
+                                           const QString &tooltip)
+{
+    auto emotes = std::make_shared<EmoteMap>();
+    for (const auto &name : names)
+    {
+        emotes->emplace(EmoteName{name},
+                        std::make_shared<const Emote>(
+                            Emote{EmoteName{name}, ImageSet{},
+                                  Tooltip{tooltip}, Url{}}));
+    }
+    return emotes;
+}
+
+}  // namespace
+
+TEST(ChannelEmoteIndex, Precedence)
+{
+    ChannelEmoteIndex index(makeEmotes({"a", "b"}, "ffz channel"),
+                            makeEmotes({"b", "c"}, "bttv channel"),
+                            makeEmotes({"c", "d", "TopHat"}, "ffz global"),
+                            makeEmotes({"a", "d", "e", "SantaHat"},
+                                       "bttv global"));
+
+    struct TestCase {
+        QString name;
+        QString tooltip;
+        MessageElementFlags flags;
+    };
+
+    std::vector<TestCase> tests{
+        {"a", "ffz channel", MessageElementFlag::FfzEmote},
+        {"b", "ffz channel", MessageElementFlag::FfzEmote},
+        {"c", "bttv channel", MessageElementFlag::BttvEmote},
+        {"d", "ffz global", MessageElementFlag::FfzEmote},
+        {"e", "bttv global", MessageElementFlag::BttvEmote},
+        // only global BetterTTV emotes can be zero width
+        {"TopHat", "ffz global", MessageElementFlag::FfzEmote},
+        {"SantaHat", "bttv global",
+         {MessageElementFlag::BttvEmote, MessageElementFlag::ZeroWidthEmote}},
+    };
+
+    for (const auto &test : tests)
+    {
+        const auto *entry = index.find(EmoteName{test.name});
+        ASSERT_NE(entry, nullptr) << test.name.toStdString();
+        EXPECT_EQ(entry->emote->tooltip.string, test.tooltip)
+            << test.name.toStdString();
+        EXPECT_TRUE(entry->flags == test.flags) << test.name.toStdString();
+    }
+
+    EXPECT_EQ(index.find(EmoteName{"f"}), nullptr);
+    // names are case sensitive
+    EXPECT_EQ(index.find(EmoteName{"A"}), nullptr);
+}
+
+TEST(ChannelEmoteIndex, MissingMaps)
+{
+    ChannelEmoteIndex index(nullptr, nullptr, nullptr,
+                            makeEmotes({"a"}, "bttv global"));
+
+    ASSERT_NE(index.find(EmoteName{"a"}), nullptr);
+    EXPECT_EQ(index.find(EmoteName{"b"}), nullptr);
+}
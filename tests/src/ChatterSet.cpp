@@ -3,6 +3,8 @@
 #include <gtest/gtest.h>
 #include <QStringList>
 
+#include <algorithm>
+
 TEST(ChatterSet, insert)
 {
     chatterino::ChatterSet set;
@@ -82,3 +84,70 @@ TEST(ChatterSet, MaxSizeLastUsed)
     EXPECT_TRUE(set.contains("pajlada"));
     EXPECT_TRUE(set.contains("Pajlada"));
 }
+
+TEST(ChatterSet, FilterByPrefix)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("pajbot");
+    set.addRecentChatter("zneix");
+    set.addRecentChatter("pa");
+
+    auto names = set.filterByPrefix("PAJ");
+    std::sort(names.begin(), names.end());
+    EXPECT_EQ(names, (std::vector<QString>{"Pajlada", "pajbot"}));
+
+    EXPECT_EQ(set.filterByPrefix("z"), (std::vector<QString>{"zneix"}));
+    EXPECT_EQ(set.filterByPrefix("pa").size(), 3);
+    EXPECT_TRUE(set.filterByPrefix("x").empty());
+    EXPECT_EQ(set.filterByPrefix("").size(), 4);
+}
+
+TEST(ChatterSet, UpdateOnlineChatters)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("zneix");
+    set.addRecentChatter("fourtf");
+
+    set.updateOnlineChatters({"brian6932", "fourtf", "pajlada"});
+
+    EXPECT_EQ(set.size(), 3);
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_TRUE(set.contains("fourtf"));
+    EXPECT_TRUE(set.contains("brian6932"));
+    EXPECT_FALSE(set.contains("zneix"));
+
+    // the casing of known chatters is kept
+    EXPECT_EQ(set.filterByPrefix("paj"), (std::vector<QString>{"Pajlada"}));
+}
+
+TEST(ChatterSet, updateMembership)
+{
+    chatterino::ChatterSet set;
+
+    set.addRecentChatter("Pajlada");
+    set.addRecentChatter("forsen");
+
+    set.updateMembership({"zneix", "pajlada"}, {"forsen", "nobody"});
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_TRUE(set.contains("zneix"));
+    EXPECT_FALSE(set.contains("forsen"));
+    EXPECT_EQ(set.size(), 2u);
+
+    // joined users keep the original casing of known chatters
+    EXPECT_EQ(set.filterByPrefix("p"), std::vector<QString>{"Pajlada"});
+
+    // joined users don't push out chatters
+    std::vector<QString> joined;
+    for (size_t i = 0; i < chatterino::ChatterSet::chatterLimit; i++)
+    {
+        joined.push_back(QString("%1").arg(i));
+    }
+    set.updateMembership(joined, {});
+    EXPECT_EQ(set.size(), chatterino::ChatterSet::chatterLimit);
+    EXPECT_TRUE(set.contains("pajlada"));
+    EXPECT_TRUE(set.contains("zneix"));
+}
@@ -0,0 +1,70 @@
+#include "providers/twitch/TwitchEmotes.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace chatterino;
+
+namespace {
+
+CheerEmoteSet makeSet(const QString &prefix, std::vector<int> tiers)
+{
+    CheerEmoteSet set;
+    set.prefix = prefix;
+    // sorted by their minBits, highest first
+    std::sort(tiers.rbegin(), tiers.rend());
+    for (int minBits : tiers)
+    {
+        CheerEmote emote;
+        emote.minBits = minBits;
+        set.cheerEmotes.push_back(emote);
+    }
+    return set;
+}
+
+}  // namespace
+
+TEST(CheerEmotes, Find)
+{
+    CheerEmotes emotes;
+    emotes.add(makeSet("Cheer", {1, 100, 1000}));
+    emotes.add(makeSet("Party", {1}));
+
+    int bits = 0;
+    const auto *emote = emotes.find("Cheer100", bits);
+    ASSERT_NE(emote, nullptr);
+    EXPECT_EQ(emote->minBits, 100);
+    EXPECT_EQ(bits, 100);
+
+    // case insensitive, the highest tier that's reached
+    emote = emotes.find("cHEER999", bits);
+    ASSERT_NE(emote, nullptr);
+    EXPECT_EQ(emote->minBits, 100);
+    EXPECT_EQ(bits, 999);
+
+    emote = emotes.find("party5", bits);
+    ASSERT_NE(emote, nullptr);
+    EXPECT_EQ(bits, 5);
+
+    EXPECT_EQ(emotes.find("Cheer", bits), nullptr);
+    EXPECT_EQ(emotes.find("Cheer0", bits), nullptr);
+    EXPECT_EQ(emotes.find("Cheer05", bits), nullptr);
+    EXPECT_EQ(emotes.find("Cheer1x", bits), nullptr);
+    EXPECT_EQ(emotes.find("Cheerio100", bits), nullptr);
+    EXPECT_EQ(emotes.find("100", bits), nullptr);
+    EXPECT_EQ(emotes.find("", bits), nullptr);
+}
+
+TEST(CheerEmotes, PrefixEndingWithDigit)
+{
+    CheerEmotes emotes;
+    emotes.add(makeSet("Cheer4", {1}));
+
+    int bits = 0;
+    const auto *emote = emotes.find("Cheer4100", bits);
+    ASSERT_NE(emote, nullptr);
+    EXPECT_EQ(bits, 100);
+
+    EXPECT_EQ(emotes.find("Cheer4", bits), nullptr);
+}
@@ -0,0 +1,54 @@
+#include "controllers/commands/CommandTemplate.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+using Type = CommandTemplate::Token::Type;
+
+TEST(CommandTemplate, Text)
+{
+    EXPECT_TRUE(CommandTemplate("").tokens().empty());
+
+    CommandTemplate command("/me hello");
+    ASSERT_EQ(command.tokens().size(), 1);
+    EXPECT_EQ(command.tokens()[0].type, Type::Text);
+    EXPECT_EQ(command.tokens()[0].text, "/me hello");
+}
+
+TEST(CommandTemplate, Words)
+{
+    CommandTemplate command("/timeout {1} {2+}");
+    const auto &tokens = command.tokens();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[0].type, Type::Text);
+    EXPECT_EQ(tokens[0].text, "/timeout ");
+    EXPECT_EQ(tokens[1].type, Type::Word);
+    EXPECT_EQ(tokens[1].wordIndex, 1);
+    EXPECT_EQ(tokens[2].type, Type::Text);
+    EXPECT_EQ(tokens[2].text, " ");
+    EXPECT_EQ(tokens[3].type, Type::WordsFrom);
+    EXPECT_EQ(tokens[3].wordIndex, 2);
+}
+
+TEST(CommandTemplate, Variables)
+{
+    CommandTemplate command("hi {user.name;chat} in {channel.name}");
+    const auto &tokens = command.tokens();
+
+    ASSERT_EQ(tokens.size(), 4);
+    EXPECT_EQ(tokens[1].type, Type::Variable);
+    EXPECT_EQ(tokens[1].text, "user.name");
+    EXPECT_EQ(tokens[1].altText, "chat");
+    EXPECT_EQ(tokens[1].placeholder, "{user.name;chat}");
+    EXPECT_EQ(tokens[2].text, " in ");
+    EXPECT_EQ(tokens[3].type, Type::Variable);
+    EXPECT_EQ(tokens[3].text, "channel.name");
+    EXPECT_EQ(tokens[3].altText, "");
+
+    // {0} isn't a word, it's kept as it is
+    CommandTemplate zero("a {0}");
+    ASSERT_EQ(zero.tokens().size(), 2);
+    EXPECT_EQ(zero.tokens()[1].type, Type::Variable);
+    EXPECT_EQ(zero.tokens()[1].placeholder, "{0}");
+}
@@ -0,0 +1,106 @@
+#include "common/CompletionIndex.hpp"
+
+#include "util/Hotness.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+std::vector<QString> found(const CompletionIndex &index, const QString &query,
+                           size_t limit = 10,
+                           const CompletionUsage *usage = nullptr,
+                           const Hotness *hotness = nullptr)
+{
+    std::vector<QString> strings;
+    for (const auto &match : index.find(query, limit, usage, hotness))
+    {
+        strings.push_back(index.string(match.index));
+    }
+    return strings;
+}
+
+}  // namespace
+
+TEST(CompletionIndex, FuzzyScore)
+{
+    using detail::fuzzyScore;
+
+    EXPECT_FALSE(fuzzyScore(u"kpz", u"kappa", u"Kappa").has_value());
+    EXPECT_FALSE(fuzzyScore(u"kappaa", u"kappa", u"Kappa").has_value());
+    EXPECT_TRUE(fuzzyScore(u"kpp", u"kappa", u"Kappa").has_value());
+
+    // consecutive characters beat scattered ones
+    EXPECT_GT(*fuzzyScore(u"kap", u"kappa", u"Kappa"),
+              *fuzzyScore(u"kap", u"keepo_amp", u"Keepo_Amp"));
+    // word starts beat characters within a word
+    EXPECT_GT(*fuzzyScore(u"pc", u"pogchamp", u"PogChamp"),
+              *fuzzyScore(u"pc", u"pogchamp", u"pogchamp"));
+    // the whole candidate beats a prefix of a longer one
+    EXPECT_GT(*fuzzyScore(u"lul", u"lul", u"LUL"),
+              *fuzzyScore(u"lul", u"lulw", u"LULW"));
+}
+
+TEST(CompletionIndex, RanksMatches)
+{
+    CompletionIndex index;
+    for (const auto &emote : {"PogChamp", "forsenPog", "Pog", "PagChomp",
+                              "Kappa", "KappaPride", "POGGERS"})
+    {
+        index.add(emote);
+    }
+
+    // PagChomp has no 'g' after the 'o'
+    EXPECT_EQ(found(index, "pog"), (std::vector<QString>{"Pog", "POGGERS",
+                                                          "PogChamp",
+                                                          "forsenPog"}));
+    EXPECT_EQ(found(index, "KAPPA"),
+              (std::vector<QString>{"Kappa", "KappaPride"}));
+    EXPECT_EQ(found(index, "kp"),
+              (std::vector<QString>{"Kappa", "KappaPride"}));
+    EXPECT_TRUE(found(index, "xyz").empty());
+
+    // only the best ones
+    EXPECT_EQ(found(index, "p", 2), (std::vector<QString>{"Pog", "POGGERS"}));
+}
+
+TEST(CompletionIndex, PrefersUsedCandidates)
+{
+    CompletionIndex index;
+    index.add("forsenE");
+    index.add("forsenPls");
+
+    CompletionUsage usage;
+    EXPECT_EQ(found(index, "forsen", 10, &usage).front(), "forsenE");
+
+    usage.used("forsenPls");
+    usage.used("forsenPls");
+    EXPECT_EQ(found(index, "forsen", 10, &usage).front(), "forsenPls");
+    EXPECT_EQ(usage.bonus("forsenE"), 0);
+    EXPECT_GT(usage.bonus("forsenPls"), 0);
+}
+
+TEST(CompletionIndex, PrefersHotCandidates)
+{
+    CompletionIndex index;
+    index.add("forsenE");
+    index.add("forsenPls");
+
+    Hotness hotness;
+    EXPECT_EQ(found(index, "forsen", 10, nullptr, &hotness).front(),
+              "forsenE");
+
+    for (int i = 0; i < 3; i++)
+    {
+        hotness.hit("forsenPls");
+    }
+    EXPECT_EQ(found(index, "forsen", 10, nullptr, &hotness).front(),
+              "forsenPls");
+
+    // picking it is worth more than seeing it
+    CompletionUsage usage;
+    usage.used("forsenE");
+    usage.used("forsenE");
+    EXPECT_EQ(found(index, "forsen", 10, &usage, &hotness).front(), "forsenE");
+}
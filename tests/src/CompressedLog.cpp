@@ -0,0 +1,93 @@
+#include "singletons/helper/CompressedLog.hpp"
+
+#include <gtest/gtest.h>
+#include <QTemporaryDir>
+
+using namespace chatterino;
+
+namespace {
+
+QDateTime at(qint64 seconds)
+{
+    return QDateTime::fromMSecsSinceEpoch(seconds * 1000);
+}
+
+}  // namespace
+
+TEST(CompressedLog, ReadBack)
+{
+    QTemporaryDir dir;
+    auto path = dir.filePath("forsen-2022-01-01.clog");
+
+    CompressedLogWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    writer.append(at(1), "pajlada", "pajlada: hello");
+    writer.append(at(2), "forsen", "forsen: multi\nline");
+    writer.flush(true, false);
+    writer.append(at(3), "", "system message");
+    writer.close(false);
+
+    CompressedLogReader reader(path);
+    auto entries = reader.read(0, 10000, {});
+    ASSERT_EQ(entries.size(), 3);
+
+    EXPECT_EQ(entries[0].time, at(1));
+    EXPECT_EQ(entries[0].login, "pajlada");
+    EXPECT_EQ(entries[0].text, "pajlada: hello");
+    EXPECT_EQ(entries[1].text, "forsen: multi line");
+    EXPECT_EQ(entries[2].login, "");
+    EXPECT_EQ(entries[2].text, "system message");
+}
+
+TEST(CompressedLog, Filters)
+{
+    QTemporaryDir dir;
+    auto path = dir.filePath("forsen-2022-01-01.clog");
+
+    CompressedLogWriter writer;
+    ASSERT_TRUE(writer.open(path));
+    for (int i = 0; i < 100; i++)
+    {
+        writer.append(at(i), i % 2 ? "odd" : "Even", QString::number(i));
+        if (i % 10 == 9)
+        {
+            writer.flush(true, false);
+        }
+    }
+    writer.close(false);
+
+    CompressedLogReader reader(path);
+
+    auto range = reader.read(15000, 24000, {});
+    ASSERT_EQ(range.size(), 10);
+    EXPECT_EQ(range.front().text, "15");
+    EXPECT_EQ(range.back().text, "24");
+
+    // logins are matched in lowercase
+    auto even = reader.read(0, 100000, {"even"});
+    ASSERT_EQ(even.size(), 50);
+    for (const auto &entry : even)
+    {
+        EXPECT_EQ(entry.text.toInt() % 2, 0);
+    }
+
+    EXPECT_TRUE(reader.read(0, 100000, {"nobody"}).empty());
+}
+
+TEST(CompressedLog, AppendsToExistingFile)
+{
+    QTemporaryDir dir;
+    auto path = dir.filePath("forsen-2022-01-01.clog");
+
+    for (int i = 0; i < 3; i++)
+    {
+        CompressedLogWriter writer;
+        ASSERT_TRUE(writer.open(path));
+        writer.append(at(i), "pajlada", QString::number(i));
+        writer.close(false);
+    }
+
+    auto entries = CompressedLogReader(path).read(0, 100000, {});
+    ASSERT_EQ(entries.size(), 3);
+    EXPECT_EQ(entries[2].text, "2");
+}
@@ -0,0 +1,84 @@
+#include "providers/irc/ConnectionLiveness.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+using Action = ConnectionLiveness::Action;
+
+TEST(ConnectionLiveness, PingsQuietConnections)
+{
+    ConnectionLiveness liveness;
+    auto start = ConnectionLiveness::Clock::now();
+    liveness.reset(start);
+
+    EXPECT_EQ(liveness.check(start + 1s), Action::None);
+    EXPECT_TRUE(liveness.nextCheck() == start + ConnectionLiveness::MAX_IDLE);
+
+    auto ping = start + ConnectionLiveness::MAX_IDLE;
+    EXPECT_EQ(liveness.check(ping), Action::SendPing);
+    liveness.pingSent(ping);
+    EXPECT_EQ(liveness.check(ping + 1s), Action::None);
+
+    // nothing came back
+    auto deadline = ping + ConnectionLiveness::MAX_PONG_TIMEOUT;
+    EXPECT_TRUE(liveness.nextCheck() == deadline);
+    EXPECT_EQ(liveness.check(deadline), Action::Dead);
+}
+
+TEST(ConnectionLiveness, NoticesBusyConnectionsGoingQuiet)
+{
+    ConnectionLiveness liveness;
+    auto now = ConnectionLiveness::Clock::now();
+    liveness.reset(now);
+
+    for (int i = 0; i < 100; i++)
+    {
+        now += 10ms;
+        liveness.received(now);
+    }
+    EXPECT_TRUE(liveness.idleTimeout() == ConnectionLiveness::MIN_IDLE);
+
+    auto ping = now + ConnectionLiveness::MIN_IDLE;
+    EXPECT_EQ(liveness.check(ping - 1ms), Action::None);
+    ASSERT_EQ(liveness.check(ping), Action::SendPing);
+    liveness.pingSent(ping);
+    liveness.pongReceived(ping + 50ms);
+    EXPECT_TRUE(liveness.pongTimeout() == ConnectionLiveness::MIN_PONG_TIMEOUT);
+
+    // the pause we pinged in didn't make the usual gap longer
+    EXPECT_TRUE(liveness.idleTimeout() == ConnectionLiveness::MIN_IDLE);
+
+    // dead a bit more than a second after the last message
+    now = ping + 50ms;
+    ping = now + ConnectionLiveness::MIN_IDLE;
+    ASSERT_EQ(liveness.check(ping), Action::SendPing);
+    liveness.pingSent(ping);
+    EXPECT_EQ(liveness.check(ping + ConnectionLiveness::MIN_PONG_TIMEOUT),
+              Action::Dead);
+}
+
+TEST(ConnectionLiveness, AnyTrafficCountsAsPong)
+{
+    ConnectionLiveness liveness;
+    auto start = ConnectionLiveness::Clock::now();
+    liveness.reset(start);
+
+    auto ping = start + ConnectionLiveness::MAX_IDLE;
+    liveness.pingSent(ping);
+    liveness.received(ping + 100ms);
+    EXPECT_EQ(liveness.check(ping + ConnectionLiveness::MAX_PONG_TIMEOUT),
+              Action::None);
+
+    // the late PONG still measures the round trip
+    liveness.pongReceived(ping + 200ms);
+    EXPECT_TRUE(liveness.pongTimeout() < ConnectionLiveness::MAX_PONG_TIMEOUT);
+
+    // a new connection starts over
+    liveness.reset(ping + 1s);
+    EXPECT_TRUE(liveness.pongTimeout() == ConnectionLiveness::MAX_PONG_TIMEOUT);
+    EXPECT_TRUE(liveness.idleTimeout() == ConnectionLiveness::MAX_IDLE);
+}
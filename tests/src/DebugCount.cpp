@@ -0,0 +1,91 @@
+#include "util/DebugCount.hpp"
+
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(DebugCount, CounterSumsAllThreads)
+{
+    static DebugCounter counter("test counter");
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([] {
+            for (int j = 0; j < 1000; j++)
+            {
+                counter.increase();
+            }
+            counter.decrease(10);
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(counter.value(), 4 * 990);
+
+    bool found = false;
+    for (const auto &value : DebugCount::values())
+    {
+        if (value.name == "test counter")
+        {
+            found = true;
+            EXPECT_EQ(value.value, 4 * 990);
+        }
+    }
+    EXPECT_TRUE(found);
+}
+
+TEST(DebugCount, HistogramBuckets)
+{
+    // small values are exact
+    for (int64_t value = 0; value < 16; value++)
+    {
+        EXPECT_EQ(DebugHistogram::upperBoundOf(DebugHistogram::bucketOf(value)),
+                  value);
+    }
+
+    // larger ones are within 12.5%
+    for (int64_t value : {17, 100, 999, 12345, 1000000, 123456789})
+    {
+        auto bound =
+            DebugHistogram::upperBoundOf(DebugHistogram::bucketOf(value));
+        EXPECT_GE(bound, value);
+        EXPECT_LE(bound, value + value / 8);
+    }
+
+    EXPECT_EQ(DebugHistogram::bucketOf(-5), 0u);
+    EXPECT_EQ(DebugHistogram::bucketOf(INT64_MAX),
+              DebugHistogram::BUCKETS - 1);
+}
+
+TEST(DebugCount, HistogramPercentiles)
+{
+    static DebugHistogram histogram("test histogram");
+
+    auto empty = histogram.snapshot();
+    EXPECT_EQ(empty.count, 0);
+    EXPECT_EQ(empty.percentile(0.5), 0);
+
+    for (int i = 1; i <= 100; i++)
+    {
+        histogram.record(i * 10);
+    }
+
+    auto snapshot = histogram.snapshot();
+    EXPECT_EQ(snapshot.count, 100);
+    EXPECT_NEAR(snapshot.percentile(0.5), 500, 500 / 8);
+    EXPECT_NEAR(snapshot.percentile(0.99), 990, 990 / 8);
+    EXPECT_NEAR(snapshot.percentile(1), 1000, 1000 / 8);
+
+    histogram.record(std::chrono::milliseconds(50));
+    auto recent = histogram.snapshot().since(snapshot);
+    EXPECT_EQ(recent.count, 1);
+    EXPECT_NEAR(recent.percentile(0.5), 50000, 50000 / 8);
+}
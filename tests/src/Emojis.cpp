@@ -36,6 +36,12 @@ TEST(Emojis, ShortcodeParsing)
             // expected output
             "👨‍⚕️",
         },
+        {
+            // input
+            "skin tone :+1_tone3:",
+            // expected output
+            "skin tone 👍🏽",
+        },
     };
 
     for (const auto &test : tests)
@@ -53,3 +59,48 @@ TEST(Emojis, ShortcodeParsing)
             << "Input " << test.input.toStdString() << " failed";
     }
 }
+
+TEST(Emojis, Parse)
+{
+    Emojis emojis;
+
+    emojis.load();
+
+    auto getEmote = [&](const QString &unifiedCode) {
+        std::shared_ptr<EmojiData> emoji;
+        EXPECT_TRUE(emojis.emojis.tryGet(unifiedCode, emoji)) << unifiedCode;
+        return emoji ? emoji->emote : nullptr;
+    };
+
+    auto penguin = getEmote("1F427");
+    auto thumbsUp = getEmote("1F44D");
+    auto thumbsUpTone3 = getEmote("1F44D-1F3FD");
+
+    using Word = boost::variant<EmotePtr, QString>;
+
+    struct TestCase {
+        QString input;
+        std::vector<Word> expectedOutput;
+    };
+
+    std::vector<TestCase> tests{
+        {"foo bar", {QString("foo bar")}},
+        {"", {}},
+        {"🐧", {penguin}},
+        {"foo 🐧 bar", {QString("foo "), penguin, QString(" bar")}},
+        {"🐧🐧", {penguin, penguin}},
+        // the longest emoji wins
+        {"👍🏽", {thumbsUpTone3}},
+        {"👍🏽👍", {thumbsUpTone3, thumbsUp}},
+        // a skin tone on its own is an emoji as well
+        {"👍a🏽", {thumbsUp, QString("a"), getEmote("1F3FD")}},
+    };
+
+    for (const auto &test : tests)
+    {
+        auto output = emojis.parse(test.input);
+
+        EXPECT_TRUE(output == test.expectedOutput)
+            << "Input " << test.input.toStdString() << " failed";
+    }
+}
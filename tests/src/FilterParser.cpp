@@ -0,0 +1,120 @@
+#include "controllers/filters/parser/FilterParser.hpp"
+
+#include "controllers/filters/FilterRecord.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+MessagePtr buildMessage()
+{
+    auto message = std::make_shared<Message>();
+    message->displayName = "Pajlada";
+    message->channelName = "forsen";
+    message->messageText = "Hello world PogChamp";
+    message->usernameColor = QColor("#ff0000");
+    message->badgeSet = std::make_shared<const BadgeSet>(BadgeSet{
+        {Badge("moderator", "1"), Badge("subscriber", "12")},
+        {{"subscriber", "14"}},
+    });
+    message->flags.set(MessageFlag::Highlighted);
+    return message;
+}
+
+bool run(const QString &filter, const MessagePtr &message)
+{
+    filterparser::FilterParser parser(filter);
+    EXPECT_TRUE(parser.valid()) << filter.toStdString();
+
+    filterparser::Context context(message, nullptr);
+    return parser.execute(context);
+}
+
+}  // namespace
+
+TEST(FilterParser, Identifiers)
+{
+    auto message = buildMessage();
+
+    EXPECT_TRUE(run("author.name == \"pajlada\"", message));
+    EXPECT_TRUE(run("author.badges contains \"Moderator\"", message));
+    EXPECT_FALSE(run("author.badges contains \"vip\"", message));
+    EXPECT_TRUE(run("author.subbed && author.sub_length == 14", message));
+    EXPECT_FALSE(run("author.no_color", message));
+    EXPECT_TRUE(run("channel.name == \"FORSEN\"", message));
+    EXPECT_FALSE(run("channel.live", message));
+    EXPECT_TRUE(run("flags.highlighted && !flags.sub_message", message));
+    EXPECT_TRUE(run("message.length > 5 && message.length <= 20", message));
+    EXPECT_TRUE(run("message.content startswith \"hello\"", message));
+    EXPECT_TRUE(run("message.content endswith \"pogchamp\"", message));
+    EXPECT_FALSE(run("unknown.identifier", message));
+}
+
+TEST(FilterParser, FounderBadge)
+{
+    auto message = buildMessage();
+    message->badgeSet = std::make_shared<const BadgeSet>(BadgeSet{
+        {Badge("founder", "0"), Badge("vip", "1")},
+        {{"founder", "30"}},
+    });
+
+    EXPECT_TRUE(message->badgeSet->flags.has(BadgeFlag::Vip));
+    EXPECT_FALSE(message->badgeSet->flags.has(BadgeFlag::Moderator));
+    EXPECT_TRUE(run("author.subbed && author.sub_length == 30", message));
+    EXPECT_TRUE(run("author.badges contains \"vip\"", message));
+}
+
+TEST(FilterParser, Operators)
+{
+    auto message = buildMessage();
+
+    EXPECT_TRUE(run("message.content match r\"w.rld\"", message));
+    EXPECT_FALSE(run("message.content match r\"W.rld\"", message));
+    EXPECT_TRUE(run("message.content match ri\"W.rld\"", message));
+    EXPECT_TRUE(run("{\"forsen\", \"xqc\"} contains channel.name", message));
+    EXPECT_TRUE(run("message.length - 10 == 10", message));
+    EXPECT_TRUE(run("message.length % 3 == 2", message));
+    EXPECT_TRUE(run("author.name + \"!\" == \"pajlada!\"", message));
+    EXPECT_TRUE(run("author.name + 1 == \"pajlada1\"", message));
+    EXPECT_TRUE(run("(author.subbed || flags.whisper) && 1 < 2", message));
+    EXPECT_TRUE(run("author.subbed != flags.whisper", message));
+
+    // matching against a list returns the captured text
+    EXPECT_TRUE(
+        run("message.content match {r\"(\\w+) world\", 1}", message));
+    EXPECT_FALSE(
+        run("message.content match {r\"(\\w+) moon\", 1}", message));
+}
+
+TEST(FilterParser, Cacheable)
+{
+    EXPECT_TRUE(filterparser::FilterParser("author.subbed").isCacheable());
+    EXPECT_TRUE(filterparser::FilterParser("message.content contains \"a\"")
+                    .isCacheable());
+    EXPECT_FALSE(
+        filterparser::FilterParser("channel.live || author.subbed")
+            .isCacheable());
+    EXPECT_FALSE(
+        filterparser::FilterParser("!flags.highlighted").isCacheable());
+}
+
+TEST(FilterRecord, RemembersResults)
+{
+    auto message = std::make_shared<Message>();
+    message->messageText = "hello";
+
+    FilterRecord record("test", "message.content == \"hello\"");
+    filterparser::Context context(message, nullptr);
+    EXPECT_TRUE(record.filter(message, context));
+
+    // the message isn't looked at again
+    message->messageText = "bye";
+    EXPECT_TRUE(record.filter(message, context));
+    EXPECT_FALSE(record.filter(context));
+
+    auto other = std::make_shared<Message>();
+    other->messageText = "bye";
+    EXPECT_FALSE(record.filter(other, filterparser::Context(other, nullptr)));
+}
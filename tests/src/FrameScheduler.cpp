@@ -0,0 +1,82 @@
+#include "util/FrameScheduler.hpp"
+
+#include "util/PostToThread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(FrameScheduler, MergesRequestsAndRunsLayoutFirst)
+{
+    using namespace std::chrono_literals;
+
+    QObject first;
+    QObject second;
+    std::vector<int> order;
+    std::promise<void> done;
+
+    postToThread([&] {
+        auto &scheduler = FrameScheduler::instance();
+
+        scheduler.request(&first, FrameStage::Paint, [&] {
+            order.push_back(1);
+        });
+        // replaces the previous paint of first
+        scheduler.request(&first, FrameStage::Paint, [&] {
+            order.push_back(2);
+        });
+        scheduler.request(&second, FrameStage::Layout, [&] {
+            order.push_back(3);
+        });
+        // the same owner may request every stage
+        scheduler.request(&second, FrameStage::Input, [&] {
+            order.push_back(4);
+        });
+        scheduler.requestBackground(&second, [&] {
+            done.set_value();
+            return false;
+        });
+    });
+
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(order, (std::vector<int>{4, 3, 2}));
+}
+
+TEST(FrameScheduler, ContinuesBackgroundTasksAndDropsDeletedOwners)
+{
+    using namespace std::chrono_literals;
+
+    QObject owner;
+    auto deleted = std::make_unique<QObject>();
+    int runs = 0;
+    bool ranDeleted = false;
+    std::promise<void> done;
+
+    postToThread([&] {
+        auto &scheduler = FrameScheduler::instance();
+
+        scheduler.requestBackground(deleted.get(), [&] {
+            ranDeleted = true;
+            return false;
+        });
+        deleted.reset();
+
+        scheduler.requestBackground(&owner, [&] {
+            if (++runs == 3)
+            {
+                done.set_value();
+                return false;
+            }
+            return true;
+        });
+    });
+
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+    EXPECT_EQ(runs, 3);
+    EXPECT_FALSE(ranDeleted);
+}
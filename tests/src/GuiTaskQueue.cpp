@@ -0,0 +1,96 @@
+#include "util/GuiTaskQueue.hpp"
+
+#include "util/PostToThread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(GuiTaskQueue, KeepsOrderPerPriority)
+{
+    using namespace std::chrono_literals;
+
+    std::promise<void> blocked;
+    std::promise<void> release;
+    std::promise<void> done;
+    std::vector<int> order;
+
+    // keeps the gui thread busy so all following tasks are queued at once
+    postToThread([&] {
+        blocked.set_value();
+        release.get_future().wait();
+    });
+    blocked.get_future().wait();
+
+    for (int i = 0; i < 3; i++)
+    {
+        postToThread(
+            [&, i] {
+                order.push_back(20 + i);
+            },
+            TaskPriority::Low);
+        postToThread([&, i] {
+            order.push_back(10 + i);
+        });
+        postToThread(
+            [&, i] {
+                order.push_back(i);
+            },
+            TaskPriority::High);
+    }
+    postToThread(
+        [&] {
+            done.set_value();
+        },
+        TaskPriority::Low);
+
+    release.set_value();
+    ASSERT_EQ(done.get_future().wait_for(5s), std::future_status::ready);
+
+    EXPECT_EQ(order, (std::vector<int>{0, 1, 2, 10, 11, 12, 20, 21, 22}));
+}
+
+TEST(GuiTaskQueue, RunsTasksFromManyThreads)
+{
+    using namespace std::chrono_literals;
+
+    constexpr int threadCount = 4;
+    constexpr int tasksPerThread = 10000;
+
+    std::vector<int> lastSeen(threadCount, -1);
+    bool inOrder = true;
+    int count = 0;
+    std::promise<void> done;
+
+    std::vector<std::thread> threads;
+    for (int t = 0; t < threadCount; t++)
+    {
+        threads.emplace_back([&, t] {
+            for (int i = 0; i < tasksPerThread; i++)
+            {
+                postToThread([&, t, i] {
+                    // tasks of one thread run in the order they were pushed
+                    inOrder = inOrder && lastSeen[size_t(t)] == i - 1;
+                    lastSeen[size_t(t)] = i;
+
+                    if (++count == threadCount * tasksPerThread)
+                    {
+                        done.set_value();
+                    }
+                });
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    ASSERT_EQ(done.get_future().wait_for(10s), std::future_status::ready);
+    EXPECT_TRUE(inOrder);
+}
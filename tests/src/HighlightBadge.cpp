@@ -0,0 +1,61 @@
+#include "controllers/highlights/HighlightBadge.hpp"
+
+#include "messages/Message.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+HighlightBadge buildHighlightBadge(const QString &badgeName)
+{
+    return HighlightBadge(badgeName,  // badgeName
+                          badgeName,  // displayName
+                          false,      // hasAlert
+                          false,      // hasSound
+                          "",         // soundURL
+                          QColor()    // color
+    );
+}
+
+}  // namespace
+
+TEST(HighlightBadge, Badge)
+{
+    auto any = buildHighlightBadge("subscriber");
+    auto version = buildHighlightBadge("Subscriber/12");
+    auto multi = buildHighlightBadge("vip,subscriber/12,moderator");
+
+    Badge sub12("subscriber", "12");
+    Badge sub6("subscriber", "6");
+    Badge vip("vip", "1");
+    Badge staff("staff", "1");
+
+    EXPECT_TRUE(any.isMatch(sub12));
+    EXPECT_TRUE(any.isMatch(sub6));
+    EXPECT_FALSE(any.isMatch(vip));
+
+    EXPECT_TRUE(version.isMatch(sub12));
+    EXPECT_FALSE(version.isMatch(sub6));
+
+    EXPECT_TRUE(multi.isMatch(sub12));
+    EXPECT_FALSE(multi.isMatch(sub6));
+    EXPECT_TRUE(multi.isMatch(vip));
+    EXPECT_FALSE(multi.isMatch(staff));
+}
+
+TEST(HighlightBadge, BadgeSet)
+{
+    auto version = buildHighlightBadge("subscriber/12");
+    auto multi = buildHighlightBadge("vip,moderator");
+
+    BadgeSet set({Badge("moderator", "1"), Badge("subscriber", "12")}, {});
+    BadgeSet empty;
+
+    EXPECT_TRUE(version.isMatch(set));
+    EXPECT_TRUE(multi.isMatch(set));
+    EXPECT_FALSE(multi.isMatch(empty));
+    EXPECT_TRUE(set.flags.has(BadgeFlag::Moderator));
+    EXPECT_TRUE(set.isSubscribed());
+}
@@ -0,0 +1,95 @@
+#include "controllers/highlights/HighlightMatcher.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+HighlightPhrase buildHighlightPhrase(const QString &phrase, bool isRegex,
+                                     bool isCaseSensitive)
+{
+    return HighlightPhrase(phrase,           // pattern
+                           false,            // showInMentions
+                           false,            // hasAlert
+                           false,            // hasSound
+                           isRegex,          // isRegex
+                           isCaseSensitive,  // isCaseSensitive
+                           "",               // soundURL
+                           QColor()          // color
+    );
+}
+
+std::vector<QString> matchingPatterns(const HighlightMatcher &matcher,
+                                      const QString &subject)
+{
+    std::vector<QString> patterns;
+    for (const auto *phrase : matcher.match(subject))
+    {
+        patterns.push_back(phrase->getPattern());
+    }
+    return patterns;
+}
+
+}  // namespace
+
+TEST(HighlightMatcher, MatchesLikeHighlightPhrase)
+{
+    std::vector<HighlightPhrase> phrases{
+        buildHighlightPhrase("test", false, false),
+        buildHighlightPhrase("Test", false, true),
+        buildHighlightPhrase("a b", false, false),
+        buildHighlightPhrase("!", false, false),
+        buildHighlightPhrase("", false, false),
+        buildHighlightPhrase("te", false, false),
+        buildHighlightPhrase("^foo", true, false),
+        buildHighlightPhrase("b.r$", true, true),
+        buildHighlightPhrase("(\\w)\\1", true, false),
+        buildHighlightPhrase("[invalid", true, false),
+        buildHighlightPhrase("ümlaut", false, false),
+        buildHighlightPhrase("straße", false, false),
+    };
+
+    HighlightMatcher matcher(phrases);
+
+    std::vector<QString> subjects{
+        "",           "test",         "TEST",       "Test",
+        "testing",    "a test!",      "!test",      "footest",
+        "foo test",   "FOO bar",      "foo BAR",    "a b c",
+        "ab",         "bar",          "aa",         "xyz",
+        "ÜMLAUT",     "Ümlauts",      "STRASSE",    "straße!",
+        "te st",      "tE",           "test_",      "_test",
+        "😂test😂",   "test😂 te",    "a  b",       "!!",
+    };
+
+    for (const auto &subject : subjects)
+    {
+        std::vector<QString> expected;
+        for (const auto &phrase : phrases)
+        {
+            if (phrase.isMatch(subject))
+            {
+                expected.push_back(phrase.getPattern());
+            }
+        }
+
+        EXPECT_EQ(matchingPatterns(matcher, subject), expected)
+            << "subject: " << subject.toStdString();
+    }
+}
+
+TEST(HighlightMatcher, KeepsPhraseOrder)
+{
+    HighlightMatcher matcher({
+        buildHighlightPhrase("b.*", true, false),
+        buildHighlightPhrase("bar", false, false),
+        buildHighlightPhrase("foo", false, true),
+        buildHighlightPhrase("fo+", true, false),
+    });
+
+    EXPECT_EQ(matchingPatterns(matcher, "bar foo"),
+              (std::vector<QString>{"b.*", "bar", "foo", "fo+"}));
+    EXPECT_EQ(matchingPatterns(matcher, "FOO"), (std::vector<QString>{"fo+"}));
+    EXPECT_EQ(matcher.match("baz").size(), 1);
+    EXPECT_TRUE(matcher.match("qux").empty());
+}
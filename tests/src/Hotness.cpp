@@ -0,0 +1,97 @@
+#include "util/Hotness.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(Hotness, Counts)
+{
+    Hotness hotness;
+    auto now = Hotness::Clock::now();
+
+    EXPECT_EQ(hotness.score("forsenE", now), 0u);
+
+    for (int i = 0; i < 5; i++)
+    {
+        hotness.hit("forsenE", now);
+    }
+    hotness.hit("Kappa", now);
+
+    EXPECT_EQ(hotness.score("forsenE", now), 5u);
+    EXPECT_EQ(hotness.score("Kappa", now), 1u);
+    EXPECT_EQ(hotness.score("PogChamp", now), 0u);
+}
+
+TEST(Hotness, Decays)
+{
+    Hotness hotness;
+    auto now = Hotness::Clock::now();
+
+    for (int i = 0; i < 8; i++)
+    {
+        hotness.hit("forsenE", now);
+    }
+
+    EXPECT_EQ(hotness.score("forsenE", now + Hotness::HALF_LIFE), 4u);
+    EXPECT_EQ(hotness.score("forsenE", now + 3 * Hotness::HALF_LIFE), 1u);
+    EXPECT_EQ(hotness.score("forsenE", now + 40 * Hotness::HALF_LIFE), 0u);
+
+    // the decay is applied before the hit
+    hotness.hit("forsenE", now + 2 * Hotness::HALF_LIFE);
+    EXPECT_EQ(hotness.score("forsenE", now + 2 * Hotness::HALF_LIFE), 3u);
+}
+
+TEST(Hotness, ManyKeys)
+{
+    Hotness hotness;
+    auto now = Hotness::Clock::now();
+
+    for (int i = 0; i < 100; i++)
+    {
+        hotness.hit("hot", now);
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        hotness.hit(QString("cold%1").arg(i), now);
+    }
+
+    // collisions can only add to the score
+    EXPECT_GE(hotness.score("hot", now), 100u);
+    size_t colder = 0;
+    for (int i = 0; i < 1000; i++)
+    {
+        auto score = hotness.score(QString("cold%1").arg(i), now);
+        EXPECT_GE(score, 1u);
+        if (score < 100)
+        {
+            colder++;
+        }
+    }
+    EXPECT_GT(colder, 990u);
+}
+
+TEST(Hotness, Threads)
+{
+    Hotness hotness;
+    auto now = Hotness::Clock::now();
+
+    std::vector<std::thread> threads;
+    for (int i = 0; i < 4; i++)
+    {
+        threads.emplace_back([&] {
+            for (int j = 0; j < 1000; j++)
+            {
+                hotness.hit("forsenE", now);
+            }
+        });
+    }
+    for (auto &thread : threads)
+    {
+        thread.join();
+    }
+
+    EXPECT_EQ(hotness.score("forsenE", now), 4000u);
+}
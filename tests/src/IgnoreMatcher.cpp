@@ -0,0 +1,85 @@
+#include "controllers/ignores/IgnoreMatcher.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+IgnorePhrase block(const QString &pattern, bool isRegex = false,
+                   bool isCaseSensitive = false)
+{
+    return IgnorePhrase(pattern, isRegex, true, "***", isCaseSensitive);
+}
+
+IgnorePhrase replace(const QString &pattern, bool isRegex = false,
+                     bool isCaseSensitive = false)
+{
+    return IgnorePhrase(pattern, isRegex, false, "***", isCaseSensitive);
+}
+
+}  // namespace
+
+TEST(IgnoreMatcher, FindBlockMatchesIsMatch)
+{
+    std::vector<IgnorePhrase> phrases{
+        block("spam"),
+        block("CaseSensitive", false, true),
+        block("^!\\w+$", true),
+        block("(a)\\1", true),
+        block("[invalid", true),
+        block(""),
+        block("ß"),
+        replace("replaced"),
+    };
+    IgnoreMatcher matcher(phrases);
+
+    std::vector<QString> subjects{
+        "",
+        "nothing to see here",
+        "buy SPAM now",
+        "casesensitive",
+        "so CaseSensitive",
+        "!command",
+        "not !command",
+        "aa",
+        "[invalid",
+        "STRASSE straße",
+        "replaced",
+    };
+
+    for (const auto &subject : subjects)
+    {
+        const IgnorePhrase *expected = nullptr;
+        for (const auto &phrase : matcher.phrases())
+        {
+            if (phrase.isBlock() && phrase.isMatch(subject))
+            {
+                expected = &phrase;
+                break;
+            }
+        }
+
+        EXPECT_EQ(matcher.findBlock(subject), expected)
+            << subject.toStdString();
+    }
+}
+
+TEST(IgnoreMatcher, FirstReplaceCandidate)
+{
+    IgnoreMatcher matcher({
+        replace("foo"),
+        block("bar"),
+        replace("bar"),
+        replace("b.z", true),
+        replace("Qux", false, true),
+    });
+
+    EXPECT_EQ(matcher.firstReplaceCandidate("nothing"), 5);
+    EXPECT_EQ(matcher.firstReplaceCandidate("FOO bar"), 0);
+    // the blocking phrase is skipped
+    EXPECT_EQ(matcher.firstReplaceCandidate("bar"), 2);
+    EXPECT_EQ(matcher.firstReplaceCandidate("BAZ"), 3);
+    EXPECT_EQ(matcher.firstReplaceCandidate("qux"), 5);
+    EXPECT_EQ(matcher.firstReplaceCandidate("Qux"), 4);
+}
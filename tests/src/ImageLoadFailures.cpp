@@ -0,0 +1,82 @@
+#include "messages/ImageLoadFailures.hpp"
+
+#include "common/NetworkResult.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+const QString emote = "https://cdn.example.com/emote/1/1x";
+const QString otherEmote = "https://cdn.example.com/emote/2/1x";
+const QString badge = "https://badges.example.com/badge/1x";
+
+}  // namespace
+
+TEST(ImageLoadFailures, BacksOffUrls)
+{
+    ImageLoadFailures failures;
+    auto now = ImageLoadFailures::Clock::now();
+
+    EXPECT_TRUE(failures.mayLoad(emote, now));
+    failures.failed(emote, 404, now);
+    EXPECT_FALSE(failures.mayLoad(emote, now + 1s));
+    EXPECT_TRUE(failures.mayLoad(otherEmote, now + 1s));
+
+    now += ImageLoadFailures::URL_FIRST_WINDOW;
+    EXPECT_TRUE(failures.mayLoad(emote, now));
+
+    // the window doubles
+    failures.failed(emote, 404, now);
+    EXPECT_FALSE(
+        failures.mayLoad(emote, now + ImageLoadFailures::URL_FIRST_WINDOW));
+    EXPECT_TRUE(failures.mayLoad(
+        emote, now + 2 * ImageLoadFailures::URL_FIRST_WINDOW));
+
+    failures.succeeded(emote);
+    EXPECT_TRUE(failures.mayLoad(emote, now));
+}
+
+TEST(ImageLoadFailures, PausesFailingHosts)
+{
+    ImageLoadFailures failures;
+    auto now = ImageLoadFailures::Clock::now();
+
+    // missing images don't mean the cdn is down
+    for (int i = 0; i < ImageLoadFailures::HOST_FAILURES; i++)
+    {
+        failures.failed(QString("https://cdn.example.com/%1").arg(i), 404,
+                        now);
+    }
+    EXPECT_FALSE(failures.isPaused(otherEmote, now));
+
+    for (int i = 0; i < ImageLoadFailures::HOST_FAILURES; i++)
+    {
+        failures.failed(QString("https://cdn.example.com/%1").arg(i), 503,
+                        now);
+    }
+    EXPECT_TRUE(failures.isPaused(otherEmote, now));
+    EXPECT_FALSE(failures.mayLoad(otherEmote, now));
+    EXPECT_TRUE(failures.mayLoad(badge, now));
+
+    // a single probe once the window is over
+    now += ImageLoadFailures::HOST_FIRST_WINDOW;
+    EXPECT_TRUE(failures.mayLoad(otherEmote, now));
+    EXPECT_FALSE(failures.mayLoad(emote, now));
+
+    // the probe failed, the host stays paused for longer
+    failures.failed(otherEmote, NetworkResult::timedoutStatus, now);
+    EXPECT_FALSE(
+        failures.mayLoad(emote, now + ImageLoadFailures::HOST_FIRST_WINDOW));
+    now += 2 * ImageLoadFailures::HOST_FIRST_WINDOW;
+    EXPECT_TRUE(failures.mayLoad(emote, now));
+
+    failures.succeeded(emote);
+    EXPECT_FALSE(failures.isPaused(otherEmote, now));
+    EXPECT_TRUE(failures.mayLoad(
+        otherEmote, now + ImageLoadFailures::URL_FIRST_WINDOW * 2));
+}
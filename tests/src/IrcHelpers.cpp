@@ -0,0 +1,31 @@
+#include "util/IrcHelpers.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace chatterino;
+
+TEST(IrcHelpers, ParseTagString)
+{
+    struct TestCase {
+        QString input;
+        QString expected;
+    };
+
+    std::vector<TestCase> tests{
+        {"", ""},
+        {"no escapes", "no escapes"},
+        {R"(a\sb\sc)", "a b c"},
+        {R"(semi\:colon)", "semi;colon"},
+        {R"(back\\slash)", R"(back\slash)"},
+        {R"(line\nbreak\r)", "line\nbreak\r"},
+        {R"(unknown\xescape)", "unknownxescape"},
+        {R"(trailing\)", R"(trailing\)"},
+    };
+
+    for (const auto &[input, expected] : tests)
+    {
+        EXPECT_EQ(parseTagString(input), expected) << input;
+    }
+}
@@ -0,0 +1,185 @@
+#include "providers/irc/JoinQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+LoadPriority hidden(const QString &)
+{
+    return LoadPriority::Hidden;
+}
+
+std::vector<QString> channelsNamed(const QString &prefix, size_t count)
+{
+    std::vector<QString> channels;
+    for (size_t i = 0; i < count; i++)
+    {
+        channels.push_back(prefix + QString::number(i));
+    }
+    return channels;
+}
+
+}  // namespace
+
+TEST(JoinQueue, BatchesUpToTheLimit)
+{
+    JoinQueue queue;
+    auto start = JoinQueue::Clock::now();
+
+    for (const auto &channel : channelsNamed("channel", 30))
+    {
+        queue.push(channel);
+    }
+    // already queued
+    queue.push("channel0");
+    EXPECT_EQ(queue.size(), 30);
+
+    auto joins = queue.takeSendable(start, hidden);
+    ASSERT_EQ(joins.size(), JoinQueue::UNVERIFIED.joins);
+    EXPECT_EQ(joins.front(), "channel0");
+    EXPECT_EQ(queue.size(), 30 - JoinQueue::UNVERIFIED.joins);
+    EXPECT_EQ(queue.pendingCount(), JoinQueue::UNVERIFIED.joins);
+
+    // being joined
+    queue.push("channel0");
+    EXPECT_EQ(queue.size(), 30 - JoinQueue::UNVERIFIED.joins);
+
+    EXPECT_TRUE(queue.takeSendable(start + 1s, hidden).empty());
+    for (const auto &channel : joins)
+    {
+        queue.confirmed(channel, start + 1s);
+    }
+    EXPECT_TRUE(queue.nextWakeTime(start + 1s) ==
+                start + JoinQueue::UNVERIFIED.window);
+
+    joins = queue.takeSendable(start + JoinQueue::UNVERIFIED.window, hidden);
+    EXPECT_EQ(joins.size(), 30 - JoinQueue::UNVERIFIED.joins);
+    EXPECT_EQ(queue.size(), 0);
+}
+
+TEST(JoinQueue, FitsIntoOneLine)
+{
+    JoinQueue queue(JoinQueue::VERIFIED);
+    auto start = JoinQueue::Clock::now();
+
+    // about 25 characters, the longest Twitch allows
+    auto channels = channelsNamed("abcdefghijklmnopqrstuvw", 30);
+    for (const auto &channel : channels)
+    {
+        queue.push(channel);
+    }
+
+    auto joins = queue.takeSendable(start, hidden);
+    ASSERT_FALSE(joins.empty());
+    EXPECT_LT(joins.size(), channels.size());
+
+    int length = QString("JOIN ").size();
+    for (const auto &channel : joins)
+    {
+        length += channel.size() + 2;
+    }
+    // the last channel has no comma
+    EXPECT_LE(length - 1, JoinQueue::MAX_LINE_LENGTH);
+
+    // the rest goes into the next line right away
+    EXPECT_TRUE(queue.nextWakeTime(start) == start);
+    EXPECT_EQ(queue.takeSendable(start, hidden).size(),
+              channels.size() - joins.size());
+}
+
+TEST(JoinQueue, JoinsVisibleChannelsFirst)
+{
+    JoinQueue queue;
+    auto start = JoinQueue::Clock::now();
+
+    for (const auto &channel : channelsNamed("hidden", 20))
+    {
+        queue.push(channel);
+    }
+    queue.push("visible");
+    queue.push("selected");
+
+    auto joins = queue.takeSendable(start, [](const QString &channel) {
+        if (channel == "selected")
+        {
+            return LoadPriority::SelectedTab;
+        }
+        if (channel == "visible")
+        {
+            return LoadPriority::VisibleWindow;
+        }
+        return LoadPriority::Hidden;
+    });
+    ASSERT_EQ(joins.size(), JoinQueue::UNVERIFIED.joins);
+    EXPECT_EQ(joins[0], "selected");
+    EXPECT_EQ(joins[1], "visible");
+    EXPECT_EQ(joins[2], "hidden0");
+}
+
+TEST(JoinQueue, BacksOffAndRecovers)
+{
+    JoinQueue queue;
+    auto start = JoinQueue::Clock::now();
+    auto window = JoinQueue::UNVERIFIED.window;
+
+    queue.push("forsen");
+    queue.push("pajlada");
+    ASSERT_EQ(queue.takeSendable(start, hidden).size(), 2);
+    queue.confirmed("forsen", start + 200ms);
+
+    // the timeout follows the round trip, at least MIN_CONFIRM_TIMEOUT
+    EXPECT_TRUE(queue.nextWakeTime(start + 1s) ==
+                start + JoinQueue::MIN_CONFIRM_TIMEOUT);
+    EXPECT_EQ(queue.expire(start + 1s), 0);
+    EXPECT_EQ(queue.expire(start + JoinQueue::MIN_CONFIRM_TIMEOUT), 1);
+    EXPECT_EQ(queue.size(), 1);
+    EXPECT_EQ(queue.pendingCount(), 0);
+    EXPECT_EQ(queue.rate(), JoinQueue::UNVERIFIED.joins / 2);
+
+    // the expired join is sent again first
+    queue.push("zneix");
+    auto joins = queue.takeSendable(start + window, hidden);
+    ASSERT_EQ(joins.size(), 2);
+    EXPECT_EQ(joins[0], "pajlada");
+
+    // every rate's worth of confirmations grows the rate by one
+    auto rate = queue.rate();
+    auto later = start + 2 * window;
+    auto channels = channelsNamed("channel", rate);
+    for (const auto &channel : channels)
+    {
+        queue.push(channel);
+    }
+    ASSERT_EQ(queue.takeSendable(later, hidden).size(), rate);
+    for (const auto &channel : channels)
+    {
+        queue.confirmed(channel, later + 100ms);
+    }
+    EXPECT_EQ(queue.rate(), rate + 1);
+}
+
+TEST(JoinQueue, ForgetsRemovedChannels)
+{
+    JoinQueue queue;
+    auto start = JoinQueue::Clock::now();
+
+    queue.push("forsen");
+    queue.push("pajlada");
+    ASSERT_EQ(queue.takeSendable(start, hidden).size(), 2);
+
+    queue.remove("forsen");
+    queue.forgetPending();
+    EXPECT_EQ(queue.pendingCount(), 0);
+    EXPECT_TRUE(queue.nextWakeTime(start) == boost::none);
+    EXPECT_EQ(queue.expire(start + JoinQueue::MAX_CONFIRM_TIMEOUT), 0);
+
+    queue.push("pajlada");
+    queue.push("zneix");
+    queue.remove("zneix");
+    EXPECT_EQ(queue.size(), 1);
+}
@@ -0,0 +1,60 @@
+#include "util/JsonDocument.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(JsonDocument, ReadsMembers)
+{
+    JsonDocument document(
+        R"({"id":"11148817","name":"päjlada","count":3,"live":true})");
+
+    ASSERT_TRUE(document.isValid());
+    const auto &root = document.root();
+
+    EXPECT_EQ(rj::string(root, "id"), "11148817");
+    EXPECT_EQ(rj::latin1(root, "id"), QLatin1String("11148817"));
+    EXPECT_EQ(rj::string(root, "name"), QString::fromUtf8("päjlada"));
+    EXPECT_EQ(rj::integer(root, "count"), 3);
+    EXPECT_TRUE(rj::boolean(root, "live"));
+}
+
+TEST(JsonDocument, DefaultsMissingMembers)
+{
+    JsonDocument document(R"({"id":5,"data":[]})");
+
+    ASSERT_TRUE(document.isValid());
+    const auto &root = document.root();
+
+    // the id isn't a string
+    EXPECT_EQ(rj::string(root, "id"), QString());
+    EXPECT_EQ(rj::latin1(root, "id"), QLatin1String());
+    EXPECT_EQ(rj::integer(root, "missing"), 0);
+    EXPECT_FALSE(rj::boolean(root, "missing"));
+    EXPECT_EQ(rj::member(root, "missing"), nullptr);
+    EXPECT_EQ(rj::member(*rj::member(root, "data"), "id"), nullptr);
+}
+
+TEST(JsonDocument, KeepsDataUnchanged)
+{
+    QByteArray data = R"({"escaped":"a\nb"})";
+    auto copy = data;
+
+    JsonDocument document(data);
+
+    ASSERT_TRUE(document.isValid());
+    EXPECT_EQ(rj::string(document.root(), "escaped"), "a\nb");
+    // parsing in situ works on its own copy
+    EXPECT_EQ(data, copy);
+}
+
+TEST(JsonDocument, RejectsInvalidJson)
+{
+    for (const auto *json : {"", "{", R"({"a":})", "[1,2"})
+    {
+        JsonDocument document(json);
+
+        EXPECT_FALSE(document.isValid()) << json;
+        EXPECT_TRUE(document.root().IsNull()) << json;
+    }
+}
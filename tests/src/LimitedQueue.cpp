@@ -0,0 +1,194 @@
+#include "messages/LimitedQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+template <typename T>
+std::vector<T> toVector(const LimitedQueueSnapshot<T> &snapshot)
+{
+    std::vector<T> items;
+    for (size_t i = 0; i < snapshot.size(); i++)
+    {
+        items.push_back(snapshot[i]);
+    }
+    return items;
+}
+
+}  // namespace
+
+TEST(LimitedQueue, PushBack)
+{
+    LimitedQueue<int> queue(5);
+    int deleted = -1;
+
+    for (int i = 0; i < 5; i++)
+    {
+        EXPECT_FALSE(queue.pushBack(i, deleted));
+    }
+
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{0, 1, 2, 3, 4}));
+
+    EXPECT_TRUE(queue.pushBack(5, deleted));
+    EXPECT_EQ(deleted, 0);
+
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{1, 2, 3, 4, 5}));
+}
+
+TEST(LimitedQueue, PushBackMany)
+{
+    LimitedQueue<int> queue(5);
+
+    EXPECT_EQ(queue.pushBack(std::vector<int>{0, 1, 2}), 0);
+    EXPECT_EQ(toVector(queue.getSnapshot()), (std::vector<int>{0, 1, 2}));
+
+    EXPECT_EQ(queue.pushBack(std::vector<int>{3, 4, 5, 6}), 2);
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{2, 3, 4, 5, 6}));
+
+    // more items than fit into the queue
+    EXPECT_EQ(queue.pushBack(std::vector<int>{7, 8, 9, 10, 11, 12}), 6);
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{8, 9, 10, 11, 12}));
+}
+
+TEST(LimitedQueue, PushFront)
+{
+    LimitedQueue<int> queue(5);
+    int deleted = -1;
+
+    queue.pushBack(3, deleted);
+    queue.pushBack(4, deleted);
+
+    // only the last items fit into the queue
+    auto accepted = queue.pushFront({-1, 0, 1, 2});
+    EXPECT_EQ(accepted, (std::vector<int>{0, 1, 2}));
+
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{0, 1, 2, 3, 4}));
+
+    EXPECT_TRUE(queue.pushFront({-1}).empty());
+}
+
+TEST(LimitedQueue, ReplaceItem)
+{
+    LimitedQueue<int> queue(5);
+    int deleted = -1;
+
+    for (int i = 0; i < 5; i++)
+    {
+        queue.pushBack(i, deleted);
+    }
+
+    EXPECT_EQ(queue.replaceItem(2, 20), 2);
+    EXPECT_TRUE(queue.replaceItem(size_t(4), 40));
+    EXPECT_FALSE(queue.replaceItem(size_t(5), 50));
+    EXPECT_EQ(queue.replaceItem(100, 1000), -1);
+
+    EXPECT_EQ(toVector(queue.getSnapshot()),
+              (std::vector<int>{0, 1, 20, 3, 40}));
+}
+
+TEST(LimitedQueue, SnapshotIsUnaffectedByChanges)
+{
+    LimitedQueue<int> queue(300);
+    int deleted = -1;
+
+    for (int i = 0; i < 300; i++)
+    {
+        queue.pushBack(i, deleted);
+    }
+
+    auto snapshot = queue.getSnapshot();
+    auto expected = toVector(snapshot);
+
+    // wrap around the whole queue a few times
+    for (int i = 300; i < 3000; i++)
+    {
+        queue.pushBack(i, deleted);
+        EXPECT_EQ(deleted, i - 300);
+    }
+    queue.replaceItem(size_t(0), -1);
+
+    EXPECT_EQ(toVector(snapshot), expected);
+
+    auto current = queue.getSnapshot();
+    ASSERT_EQ(current.size(), 300);
+    EXPECT_EQ(current[0], -1);
+    for (size_t i = 1; i < current.size(); i++)
+    {
+        EXPECT_EQ(current[i], int(2700 + i));
+    }
+
+    queue.clear();
+    EXPECT_TRUE(queue.empty());
+    EXPECT_EQ(toVector(snapshot), expected);
+}
+
+TEST(LimitedQueue, SetLimit)
+{
+    LimitedQueue<int> queue(10);
+    for (int i = 0; i < 10; i++)
+    {
+        queue.pushBack(std::vector<int>{i});
+    }
+    auto before = queue.getSnapshot();
+
+    EXPECT_EQ(queue.setLimit(3), (std::vector<int>{0, 1, 2, 3, 4, 5, 6}));
+    EXPECT_EQ(queue.limit(), 3U);
+    EXPECT_EQ(toVector(queue.getSnapshot()), (std::vector<int>{7, 8, 9}));
+    EXPECT_EQ(before.size(), 10U);
+
+    int deleted = -1;
+    EXPECT_TRUE(queue.pushBack(10, deleted));
+    EXPECT_EQ(deleted, 7);
+
+    // more than the table had room for at first
+    auto limit = detail::limitedQueueChunkSize * 100;
+    EXPECT_TRUE(queue.setLimit(limit).empty());
+    for (size_t i = 0; i < limit; i++)
+    {
+        queue.pushBack(std::vector<int>{int(11 + i)});
+    }
+
+    auto items = toVector(queue.getSnapshot());
+    ASSERT_EQ(items.size(), limit);
+    EXPECT_EQ(items.front(), 11);
+    EXPECT_EQ(items.back(), int(10 + limit));
+}
+
+TEST(LimitedQueue, SnapshotIterators)
+{
+    // spans chunks and doesn't start at the beginning of one
+    LimitedQueue<int> queue(detail::limitedQueueChunkSize * 2 + 5);
+    for (int i = 0; i < int(detail::limitedQueueChunkSize * 4); i++)
+    {
+        queue.pushBack(std::vector<int>{i});
+    }
+    auto snapshot = queue.getSnapshot();
+
+    std::vector<int> forward;
+    for (const auto &item : snapshot)
+    {
+        forward.push_back(item);
+    }
+    EXPECT_EQ(forward, toVector(snapshot));
+
+    std::vector<int> backward(snapshot.rbegin(), snapshot.rend());
+    std::reverse(backward.begin(), backward.end());
+    EXPECT_EQ(backward, forward);
+
+    EXPECT_EQ(snapshot.end() - snapshot.begin(),
+              std::ptrdiff_t(snapshot.size()));
+    for (size_t i = 0; i < snapshot.size(); i += 7)
+    {
+        EXPECT_EQ(*(snapshot.begin() + std::ptrdiff_t(i)), snapshot[i]);
+    }
+}
@@ -0,0 +1,54 @@
+#include "common/LinkParser.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace chatterino;
+
+TEST(LinkParser, Matches)
+{
+    std::vector<QString> links{
+        "chatterino.com",
+        "https://chatterino.com",
+        "HTTP://CHATTERINO.COM/download",
+        "www.twitch.tv/pajlada?foo=bar#baz",
+        "chatterino.com:8080/path",
+        "xn--ngbc5azd.xn--mgbaam7a8h",
+        "пример.рф",
+        "ПРИМЕР.РФ",
+        "127.0.0.1",
+        "http://192.168.0.1:8080",
+    };
+
+    for (const auto &link : links)
+    {
+        LinkParser parser(link);
+        EXPECT_TRUE(parser.hasMatch()) << link;
+        EXPECT_EQ(parser.getCaptured(), link);
+    }
+}
+
+TEST(LinkParser, DoesntMatch)
+{
+    std::vector<QString> words{
+        "",
+        "Kappa",
+        "word.",
+        ".com",
+        "chatterino..com",
+        "chatterino.notatld",
+        "chatterino.com:port",
+        "1.2.3",
+        "1.2.3.4.5",
+        "1234.0.0.1",
+        "1..2.3",
+        "127.0.0.1.",
+        "١٢٣.١.١.١",
+    };
+
+    for (const auto &word : words)
+    {
+        EXPECT_FALSE(LinkParser(word).hasMatch()) << word;
+    }
+}
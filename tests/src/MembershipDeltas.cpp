@@ -0,0 +1,86 @@
+#include "common/MembershipDeltas.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(MembershipDeltas, MergesUsers)
+{
+    MembershipDeltas deltas;
+    EXPECT_TRUE(deltas.empty());
+
+    deltas.join("Zeta", true);
+    deltas.join("alpha", true);
+    deltas.join("zeta", true);
+    deltas.part("beta", true);
+    deltas.join("quiet", false);
+    EXPECT_FALSE(deltas.empty());
+
+    auto batch = deltas.take(10);
+    EXPECT_EQ(batch.joined, (std::vector<QString>{"alpha", "quiet", "zeta"}));
+    EXPECT_EQ(batch.parted, (std::vector<QString>{"beta"}));
+    EXPECT_EQ(batch.namedJoins, (QStringList{"Zeta", "alpha"}));
+    EXPECT_EQ(batch.namedParts, (QStringList{"beta"}));
+    EXPECT_EQ(batch.moreJoins, 0u);
+    EXPECT_EQ(batch.moreParts, 0u);
+
+    EXPECT_TRUE(deltas.empty());
+    batch = deltas.take(10);
+    EXPECT_TRUE(batch.joined.empty());
+    EXPECT_TRUE(batch.namedJoins.isEmpty());
+}
+
+TEST(MembershipDeltas, RejoinCancels)
+{
+    MembershipDeltas deltas;
+
+    deltas.join("forsen", true);
+    deltas.part("forsen", true);
+    deltas.part("pajlada", true);
+    deltas.join("pajlada", true);
+    deltas.part("pajlada", true);
+
+    auto batch = deltas.take(10);
+    EXPECT_TRUE(batch.joined.empty());
+    EXPECT_EQ(batch.parted, (std::vector<QString>{"pajlada"}));
+    EXPECT_TRUE(batch.namedJoins.isEmpty());
+    EXPECT_EQ(batch.namedParts, (QStringList{"pajlada"}));
+}
+
+TEST(MembershipDeltas, NamesAreCapped)
+{
+    MembershipDeltas deltas;
+
+    for (int i = 0; i < 10; i++)
+    {
+        deltas.join(QString("user%1").arg(i), true);
+    }
+    deltas.join("unnamed", false);
+
+    auto batch = deltas.take(3);
+    EXPECT_EQ(batch.joined.size(), 11u);
+    EXPECT_EQ(batch.namedJoins, (QStringList{"user0", "user1", "user2"}));
+    EXPECT_EQ(batch.moreJoins, 7u);
+}
+
+TEST(MembershipDeltas, UsersAreCapped)
+{
+    MembershipDeltas deltas;
+
+    for (size_t i = 0; i < MembershipDeltas::MAX_USERS; i++)
+    {
+        deltas.join(QString("user%1").arg(i), false);
+    }
+    // only counted
+    deltas.join("late", true);
+    deltas.part("later", true);
+    deltas.part("silent", false);
+
+    auto batch = deltas.take(100);
+    EXPECT_EQ(batch.joined.size(), MembershipDeltas::MAX_USERS);
+    EXPECT_TRUE(batch.parted.empty());
+    EXPECT_TRUE(batch.namedJoins.isEmpty());
+    EXPECT_EQ(batch.moreJoins, 1u);
+    EXPECT_EQ(batch.moreParts, 1u);
+    EXPECT_TRUE(deltas.empty());
+}
@@ -0,0 +1,90 @@
+#include "messages/MessageArena.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+struct Counted {
+    explicit Counted(int &alive)
+        : alive_(alive)
+    {
+        this->alive_++;
+    }
+
+    virtual ~Counted()
+    {
+        this->alive_--;
+    }
+
+    int &alive_;
+};
+
+struct alignas(32) OverAligned {
+    char data[48];
+};
+
+}  // namespace
+
+TEST(MessageArena, DestroysThroughArenaPtr)
+{
+    int alive = 0;
+
+    {
+        MessageArena arena;
+        std::vector<ArenaPtr<Counted>> objects;
+
+        for (int i = 0; i < 100; i++)
+        {
+            objects.emplace_back(arena.create<Counted>(alive));
+        }
+        EXPECT_EQ(alive, 100);
+
+        objects.resize(50);
+        EXPECT_EQ(alive, 50);
+    }
+
+    EXPECT_EQ(alive, 0);
+}
+
+TEST(MessageArena, Alignment)
+{
+    MessageArena arena;
+
+    for (int i = 0; i < 200; i++)
+    {
+        arena.allocate(1, 1);
+        auto *object = arena.create<OverAligned>();
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(object) % alignof(OverAligned),
+                  0);
+
+        auto *integer = arena.create<int64_t>(i);
+        EXPECT_EQ(reinterpret_cast<uintptr_t>(integer) % alignof(int64_t), 0);
+        EXPECT_EQ(*integer, i);
+    }
+}
+
+TEST(MessageArena, LargeAllocations)
+{
+    MessageArena arena;
+    EXPECT_EQ(arena.bytes(), 0);
+
+    auto *small = static_cast<char *>(arena.allocate(16, 1));
+    auto afterSmall = arena.bytes();
+    EXPECT_GT(afterSmall, 0);
+
+    // larger than any chunk would be
+    auto *large = static_cast<char *>(arena.allocate(100 * 1024, 8));
+    EXPECT_GE(arena.bytes(), afterSmall + 100 * 1024);
+
+    // both stay usable
+    std::fill(small, small + 16, 'a');
+    std::fill(large, large + 100 * 1024, 'b');
+    EXPECT_EQ(small[15], 'a');
+    EXPECT_EQ(large[100 * 1024 - 1], 'b');
+}
@@ -0,0 +1,121 @@
+#include "messages/MessageCodec.hpp"
+
+#include "messages/Message.hpp"
+#include "messages/MessageElement.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+std::shared_ptr<Message> makeMessage()
+{
+    auto message = std::make_shared<Message>();
+    message->flags.set(MessageFlag::Highlighted);
+    message->flags.set(MessageFlag::FirstMessage);
+    message->id = "7eb848c9-1060-4e5e-9f4c-612877982e79";
+    message->loginName = "pajlada";
+    message->displayName = "pajlada";
+    message->localizedName = "パジャ";
+    message->channelName = "forsen";
+    message->messageText = "hello https://chatterino.com";
+    message->searchText = "pajlada pajlada: hello https://chatterino.com";
+    message->usernameColor = QColor(255, 0, 0);
+    message->highlightColor = std::make_shared<QColor>(0, 0, 255, 100);
+    message->count = 3;
+    message->badgeSet = std::make_shared<const BadgeSet>(
+        std::vector<Badge>{Badge("subscriber", "12"), Badge("moderator", "1")},
+        boost::container::flat_map<QString, QString>{{"subscriber", "14"}});
+
+    auto *text = message->arena.create<TextElement>(
+        "hello", MessageElementFlag::Text, MessageColor(QColor(1, 2, 3)),
+        FontStyle::ChatMediumBold);
+    message->elements.emplace_back(text);
+
+    auto *link = message->arena.create<TextElement>(
+        "https://chatterino.com", MessageElementFlag::Text,
+        MessageColor::Link);
+    link->setLink({Link::Url, "https://chatterino.com"});
+    link->setTooltip("<b>URL:</b> https://chatterino.com");
+    link->setTrailingSpace(false);
+    message->elements.emplace_back(link);
+
+    message->elements.emplace_back(
+        message->arena.create<LinebreakElement>(MessageElementFlag::Misc));
+
+    return message;
+}
+
+}  // namespace
+
+TEST(MessageCodec, RoundTrip)
+{
+    auto original = makeMessage();
+    auto decoded = decodeMessage(encodeMessage(*original));
+    ASSERT_NE(decoded, nullptr);
+
+    EXPECT_TRUE(decoded->flags == original->flags);
+    EXPECT_EQ(decoded->parseTime, original->parseTime);
+    EXPECT_EQ(decoded->serverReceivedTime, original->serverReceivedTime);
+    EXPECT_EQ(decoded->id, original->id);
+    EXPECT_EQ(decoded->loginName, original->loginName);
+    EXPECT_EQ(decoded->localizedName, original->localizedName);
+    EXPECT_EQ(decoded->channelName, original->channelName);
+    EXPECT_EQ(decoded->messageText, original->messageText);
+    EXPECT_EQ(decoded->searchText, original->searchText);
+    EXPECT_EQ(decoded->usernameColor, original->usernameColor);
+    ASSERT_NE(decoded->highlightColor, nullptr);
+    EXPECT_EQ(*decoded->highlightColor, *original->highlightColor);
+    EXPECT_EQ(decoded->count, 3U);
+
+    ASSERT_EQ(decoded->badgeSet->badges.size(), 2U);
+    EXPECT_EQ(decoded->badgeSet->badges[0].token_, "subscriber/12");
+    EXPECT_EQ(decoded->badgeSet->badgeInfos.at("subscriber"), "14");
+    EXPECT_EQ(decoded->badgeSet->subMonths,
+              original->badgeSet->subMonths);
+
+    ASSERT_EQ(decoded->elements.size(), 3U);
+
+    const auto *text =
+        dynamic_cast<const TextElement *>(decoded->elements[0].get());
+    ASSERT_NE(text, nullptr);
+    EXPECT_EQ(text->getWords(), "hello");
+    EXPECT_EQ(text->getColor().getType(), MessageColor::Custom);
+    EXPECT_EQ(text->getColor().getCustomColor(), QColor(1, 2, 3));
+    EXPECT_EQ(text->getStyle(), FontStyle::ChatMediumBold);
+    EXPECT_TRUE(text->hasTrailingSpace());
+
+    const auto *link =
+        dynamic_cast<const TextElement *>(decoded->elements[1].get());
+    ASSERT_NE(link, nullptr);
+    EXPECT_EQ(link->getLink().type, Link::Url);
+    EXPECT_EQ(link->getLink().value, "https://chatterino.com");
+    EXPECT_EQ(link->getTooltip(), "<b>URL:</b> https://chatterino.com");
+    EXPECT_FALSE(link->hasTrailingSpace());
+
+    EXPECT_NE(
+        dynamic_cast<const LinebreakElement *>(decoded->elements[2].get()),
+        nullptr);
+}
+
+TEST(MessageCodec, RejectsBrokenData)
+{
+    auto encoded = encodeMessage(*makeMessage());
+
+    // cut off anywhere
+    for (int size = 0; size < encoded.size(); size++)
+    {
+        EXPECT_EQ(decodeMessage(encoded.left(size)), nullptr) << size;
+    }
+
+    // trailing garbage
+    EXPECT_EQ(decodeMessage(encoded + "x"), nullptr);
+
+    // another version
+    auto otherVersion = encoded;
+    otherVersion[2] = char(MESSAGE_CODEC_VERSION + 1);
+    EXPECT_EQ(decodeMessage(otherVersion), nullptr);
+}
@@ -0,0 +1,96 @@
+#include "providers/twitch/MessageSendQueue.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+namespace {
+
+MessageSendQueue::Entry chat(const QString &channel, const QString &message,
+                             bool highRateLimit = false)
+{
+    return {channel, message, highRateLimit, MessageSendQueue::Priority::Chat};
+}
+
+}  // namespace
+
+TEST(MessageSendQueue, SpacesMessagesOfAChannel)
+{
+    MessageSendQueue queue;
+    auto start = MessageSendQueue::Clock::now();
+
+    queue.push(chat("forsen", "a"));
+    queue.push(chat("forsen", "b"));
+    queue.push(chat("pajlada", "c"));
+
+    auto sent = queue.takeSendable(start);
+    ASSERT_EQ(sent.size(), 2);
+    EXPECT_EQ(sent[0].message, "a");
+    EXPECT_EQ(sent[1].message, "c");
+    EXPECT_EQ(queue.size("forsen"), 1);
+
+    EXPECT_TRUE(queue.nextSendTime(start) ==
+                start + MessageSendQueue::LOW_CHANNEL_GAP);
+    EXPECT_TRUE(queue.takeSendable(start + 500ms).empty());
+
+    sent = queue.takeSendable(start + MessageSendQueue::LOW_CHANNEL_GAP);
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0].message, "b");
+    EXPECT_EQ(queue.size(), 0);
+    EXPECT_TRUE(queue.nextSendTime(start) == boost::none);
+}
+
+TEST(MessageSendQueue, WaitsForTheWindow)
+{
+    MessageSendQueue queue;
+    auto start = MessageSendQueue::Clock::now();
+
+    // one message per channel so only the window limits them
+    for (size_t i = 0; i <= MessageSendQueue::LOW_LIMIT; i++)
+    {
+        queue.push(chat(QString("channel%1").arg(i), "message"));
+    }
+    queue.push(chat("moderated", "message", true));
+
+    auto sent = queue.takeSendable(start);
+    ASSERT_EQ(sent.size(), MessageSendQueue::LOW_LIMIT + 1);
+    // the channel with the high limit isn't held back
+    EXPECT_EQ(sent.back().channel, "moderated");
+    EXPECT_EQ(queue.size(), 1);
+
+    EXPECT_TRUE(queue.nextSendTime(start) == start + MessageSendQueue::WINDOW);
+    EXPECT_TRUE(queue.takeSendable(start + 10s).empty());
+    EXPECT_EQ(queue.takeSendable(start + MessageSendQueue::WINDOW).size(), 1);
+}
+
+TEST(MessageSendQueue, ModerationCommandsSkipAhead)
+{
+    MessageSendQueue queue;
+    auto start = MessageSendQueue::Clock::now();
+
+    queue.push(chat("forsen", "first", true));
+    queue.push(chat("forsen", "second", true));
+    queue.push({"forsen", "/ban someone", true,
+                MessageSendQueue::Priority::Moderation});
+
+    auto sent = queue.takeSendable(start);
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0].message, "/ban someone");
+
+    sent = queue.takeSendable(start + MessageSendQueue::HIGH_CHANNEL_GAP);
+    ASSERT_EQ(sent.size(), 1);
+    EXPECT_EQ(sent[0].message, "first");
+}
+
+TEST(MessageSendQueue, ModerationCommands)
+{
+    EXPECT_TRUE(MessageSendQueue::isModerationCommand("/ban forsen"));
+    EXPECT_TRUE(MessageSendQueue::isModerationCommand(".Timeout forsen 10"));
+    EXPECT_TRUE(MessageSendQueue::isModerationCommand("/clear"));
+    EXPECT_FALSE(MessageSendQueue::isModerationCommand("/me waves"));
+    EXPECT_FALSE(MessageSendQueue::isModerationCommand("ban forsen"));
+    EXPECT_FALSE(MessageSendQueue::isModerationCommand("/banana"));
+}
@@ -0,0 +1,93 @@
+#include "messages/search/MessageTokenIndex.hpp"
+
+#include "messages/Message.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+
+using namespace chatterino;
+
+namespace {
+
+std::unique_ptr<Message> makeMessage(const QString &login,
+                                     const QString &displayName,
+                                     const QString &text)
+{
+    auto message = std::make_unique<Message>();
+    message->loginName = login;
+    message->displayName = displayName;
+    message->searchText = displayName + " " + login + ": " + text;
+    return message;
+}
+
+using Positions = std::vector<int64_t>;
+
+}  // namespace
+
+TEST(MessageTokenIndex, FindSubstring)
+{
+    MessageTokenIndex index;
+    auto first = makeMessage("forsen", "Forsen", "Kappa 123");
+    auto second = makeMessage("pajlada", "pajlada", "kappa kappa");
+    auto third = makeMessage("zneix", "zneix", "hello");
+
+    index.add(*first, 0);
+    index.add(*second, 1);
+    index.add(*third, 2);
+
+    EXPECT_EQ(index.findSubstring("kappa"), (Positions{0, 1}));
+    EXPECT_EQ(index.findSubstring("APP"), (Positions{0, 1}));
+    EXPECT_EQ(index.findSubstring("pajlada:"), (Positions{1}));
+    EXPECT_EQ(index.findSubstring("123"), (Positions{0}));
+    EXPECT_TRUE(index.findSubstring("4Head").empty());
+}
+
+TEST(MessageTokenIndex, FindAuthors)
+{
+    MessageTokenIndex index;
+    auto first = makeMessage("forsen", "Forsen", "hi");
+    auto second = makeMessage("mm2pl", "Mm2PL", "hi");
+    auto third = makeMessage("forsen", "Forsen", "hi");
+
+    index.add(*first, 0);
+    index.add(*second, 1);
+    index.add(*third, 2);
+
+    EXPECT_EQ(index.findAuthors({"FORSEN"}), (Positions{0, 2}));
+    EXPECT_EQ(index.findAuthors({"mm2pl", "forsen"}), (Positions{0, 1, 2}));
+    EXPECT_TRUE(index.findAuthors({"fors"}).empty());
+}
+
+TEST(MessageTokenIndex, Remove)
+{
+    MessageTokenIndex index;
+    auto first = makeMessage("forsen", "Forsen", "Kappa");
+    auto second = makeMessage("pajlada", "pajlada", "Kappa");
+
+    index.add(*first, 0);
+    index.add(*second, 1);
+    index.remove(*first, 0);
+
+    EXPECT_EQ(index.findSubstring("kappa"), (Positions{1}));
+    EXPECT_TRUE(index.findAuthors({"forsen"}).empty());
+}
+
+TEST(MessageTokenIndex, AddAtStart)
+{
+    MessageTokenIndex index;
+    auto newer = makeMessage("forsen", "Forsen", "Kappa");
+    auto older = makeMessage("forsen", "Forsen", "Kappa");
+
+    index.add(*newer, 0);
+    index.add(*older, -1);
+
+    EXPECT_EQ(index.findSubstring("kappa"), (Positions{-1, 0}));
+}
+
+TEST(MessageTokenIndex, Intersect)
+{
+    EXPECT_EQ(MessageTokenIndex::intersect({1, 2, 4, 8}, {2, 3, 4}),
+              (Positions{2, 4}));
+    EXPECT_TRUE(MessageTokenIndex::intersect({}, {1}).empty());
+}
@@ -0,0 +1,80 @@
+#include "common/NetworkCache.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+const QDateTime NOW = QDateTime::fromSecsSinceEpoch(1600000000, Qt::UTC);
+
+}  // namespace
+
+TEST(NetworkCache, NoStore)
+{
+    NetworkResult result("body", 200, {{"Cache-Control", "no-store"}});
+
+    EXPECT_EQ(NetworkCache::makeEntry(result, boost::none, NOW), nullptr);
+    EXPECT_EQ(NetworkCache::makeEntry(result, std::chrono::seconds(60), NOW),
+              nullptr);
+}
+
+TEST(NetworkCache, NoHeaders)
+{
+    NetworkResult result("body", 200);
+
+    auto entry = NetworkCache::makeEntry(result, boost::none, NOW);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->body, "body");
+    EXPECT_FALSE(entry->freshUntil.isValid());
+    EXPECT_FALSE(entry->canRevalidate());
+
+    // entries without an expiry are never fresh for requests with a ttl
+    EXPECT_TRUE(entry->isFresh(false));
+    EXPECT_FALSE(entry->isFresh(true));
+}
+
+TEST(NetworkCache, MaxAge)
+{
+    NetworkResult result("body", 200,
+                         {{"cache-control", "public, max-age=300"}});
+
+    auto entry = NetworkCache::makeEntry(result, boost::none, NOW);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->freshUntil, NOW.addSecs(300));
+}
+
+TEST(NetworkCache, TtlOverridesMaxAge)
+{
+    NetworkResult result("body", 200, {{"Cache-Control", "max-age=300"}});
+
+    auto entry =
+        NetworkCache::makeEntry(result, std::chrono::seconds(3600), NOW);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->freshUntil, NOW.addSecs(3600));
+}
+
+TEST(NetworkCache, NoCache)
+{
+    NetworkResult result("body", 200, {{"Cache-Control", "no-cache"}});
+
+    auto entry = NetworkCache::makeEntry(result, boost::none, NOW);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->freshUntil, NOW);
+    EXPECT_FALSE(entry->isFresh(false));
+}
+
+TEST(NetworkCache, Validators)
+{
+    NetworkResult result("body", 200,
+                         {
+                             {"ETag", "\"abc\""},
+                             {"Last-Modified", "Sun, 13 Sep 2020 12:26:40 GMT"},
+                         });
+
+    auto entry = NetworkCache::makeEntry(result, boost::none, NOW);
+    ASSERT_NE(entry, nullptr);
+    EXPECT_EQ(entry->etag, "\"abc\"");
+    EXPECT_EQ(entry->lastModified, "Sun, 13 Sep 2020 12:26:40 GMT");
+    EXPECT_TRUE(entry->canRevalidate());
+}
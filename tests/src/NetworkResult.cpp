@@ -0,0 +1,26 @@
+#include "common/NetworkResult.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(NetworkResult, Header)
+{
+    NetworkResult result({}, 200,
+                         {
+                             {"Ratelimit-Remaining", "799"},
+                             {"ratelimit-reset", "1600000000"},
+                         });
+
+    EXPECT_EQ(result.header("Ratelimit-Remaining"), "799");
+    EXPECT_EQ(result.header("ratelimit-remaining"), "799");
+    EXPECT_EQ(result.header("Ratelimit-Reset"), "1600000000");
+    EXPECT_TRUE(result.header("Ratelimit-Limit").isEmpty());
+}
+
+TEST(NetworkResult, NoHeaders)
+{
+    NetworkResult result({}, NetworkResult::timedoutStatus);
+
+    EXPECT_TRUE(result.header("Ratelimit-Remaining").isEmpty());
+}
@@ -0,0 +1,98 @@
+#include "common/NetworkScheduler.hpp"
+
+#include <gtest/gtest.h>
+
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+NetworkScheduler::Job makeJob(const QString &host,
+                              NetworkRequestPriority priority,
+                              std::vector<int> &started, int id,
+                              bool cancelled = false)
+{
+    NetworkScheduler::Job job;
+    job.host = host;
+    job.priority = priority;
+    job.cancelled = [cancelled] {
+        return cancelled;
+    };
+    job.start = [&started, id] {
+        started.push_back(id);
+    };
+    job.drop = [&started, id] {
+        started.push_back(-id);
+    };
+    return job;
+}
+
+}  // namespace
+
+TEST(NetworkScheduler, LimitsRunningPerHost)
+{
+    NetworkScheduler scheduler(2);
+    std::vector<int> started;
+
+    for (int i = 1; i <= 4; i++)
+    {
+        scheduler.add(
+            makeJob("a", NetworkRequestPriority::Normal, started, i));
+    }
+    scheduler.add(makeJob("b", NetworkRequestPriority::Normal, started, 5));
+
+    EXPECT_EQ(started, (std::vector<int>{1, 2, 5}));
+    EXPECT_EQ(scheduler.running("a"), 2);
+    EXPECT_EQ(scheduler.waiting("a"), 2);
+    EXPECT_EQ(scheduler.running("b"), 1);
+
+    scheduler.finish("a");
+    EXPECT_EQ(started, (std::vector<int>{1, 2, 5, 3}));
+
+    scheduler.finish("a");
+    scheduler.finish("a");
+    scheduler.finish("a");
+    EXPECT_EQ(started, (std::vector<int>{1, 2, 5, 3, 4}));
+    EXPECT_EQ(scheduler.running("a"), 0);
+    EXPECT_EQ(scheduler.waiting("a"), 0);
+}
+
+TEST(NetworkScheduler, StartsByPriority)
+{
+    NetworkScheduler scheduler(1);
+    std::vector<int> started;
+
+    scheduler.add(makeJob("a", NetworkRequestPriority::Normal, started, 1));
+    scheduler.add(makeJob("a", NetworkRequestPriority::Low, started, 2));
+    scheduler.add(makeJob("a", NetworkRequestPriority::Normal, started, 3));
+    scheduler.add(makeJob("a", NetworkRequestPriority::High, started, 4));
+
+    for (int i = 0; i < 4; i++)
+    {
+        scheduler.finish("a");
+    }
+
+    EXPECT_EQ(started, (std::vector<int>{1, 4, 3, 2}));
+}
+
+TEST(NetworkScheduler, DropsCancelledJobs)
+{
+    NetworkScheduler scheduler(1);
+    std::vector<int> started;
+
+    scheduler.add(
+        makeJob("a", NetworkRequestPriority::Normal, started, 1, true));
+    scheduler.add(makeJob("a", NetworkRequestPriority::Normal, started, 2));
+    scheduler.add(
+        makeJob("a", NetworkRequestPriority::Normal, started, 3, true));
+    scheduler.add(makeJob("a", NetworkRequestPriority::Normal, started, 4));
+
+    EXPECT_EQ(scheduler.running("a"), 1);
+
+    // the cancelled job doesn't take the place of the next one
+    scheduler.finish("a");
+    EXPECT_EQ(started, (std::vector<int>{-1, 2, -3, 4}));
+    EXPECT_EQ(scheduler.running("a"), 1);
+    EXPECT_EQ(scheduler.waiting("a"), 0);
+}
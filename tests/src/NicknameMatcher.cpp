@@ -0,0 +1,72 @@
+#include "controllers/nicknames/NicknameMatcher.hpp"
+
+#include "controllers/highlights/HighlightBlacklistMatcher.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(NicknameMatcher, ReplaceMatchesLoop)
+{
+    std::vector<Nickname> nicknames{
+        {"forsen", "Forsen Nick", false, false},
+        {"CaseSensitive", "Sensitive Nick", false, true},
+        {"^pajl(ada)?$", "Regex Nick", true, false},
+        {"pajlada", "Shadowed Nick", false, false},
+        {"FORSEN", "Second Forsen", false, false},
+        {"[invalid", "Invalid Nick", true, false},
+        {"ß", "Eszett Nick", false, false},
+        {"later", "Plain Nick", false, false},
+        {"^lat", "Late Regex", true, false},
+    };
+    NicknameMatcher matcher(nicknames);
+
+    std::vector<QString> userNames{
+        "",           "forsen",  "FoRsEn",  "casesensitive", "CaseSensitive",
+        "pajl",       "pajlada", "PAJLADA", "[invalid",      "ß",
+        "ẞ",          "later",   "latest",  "nobody",
+    };
+
+    for (const auto &userName : userNames)
+    {
+        QString expected = userName;
+        bool expectedMatch = false;
+        for (const auto &nickname : nicknames)
+        {
+            if (nickname.match(expected))
+            {
+                expectedMatch = true;
+                break;
+            }
+        }
+
+        QString actual = userName;
+        EXPECT_EQ(matcher.replace(actual), expectedMatch) << userName;
+        EXPECT_EQ(actual, expected) << userName;
+    }
+}
+
+TEST(HighlightBlacklistMatcher, IsMatchMatchesLoop)
+{
+    std::vector<HighlightBlacklistUser> users{
+        {"Forsen"},
+        {"^bot_", true},
+        {"[invalid", true},
+    };
+    HighlightBlacklistMatcher matcher(users);
+
+    std::vector<QString> userNames{
+        "", "forsen", "FORSEN", "bot_one", "BOT_two", "[invalid", "nobody",
+    };
+
+    for (const auto &userName : userNames)
+    {
+        bool expected = false;
+        for (const auto &user : users)
+        {
+            expected = expected || user.isMatch(userName);
+        }
+
+        EXPECT_EQ(matcher.isMatch(userName), expected) << userName;
+    }
+}
@@ -0,0 +1,61 @@
+#include "util/OrderedWorkQueue.hpp"
+
+#include "util/PostToThread.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <future>
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+TEST(OrderedWorkQueue, KeepsOrderPerKey)
+{
+    using namespace std::chrono_literals;
+
+    OrderedWorkQueue queue;
+    std::vector<int> results;
+    std::vector<int> otherResults;
+    std::promise<void> done;
+
+    // the queue may only be used from the gui thread
+    postToThread([&] {
+        for (int i = 0; i < 50; i++)
+        {
+            queue.run("a", [&, i]() -> OrderedWorkQueue::Result {
+                // make later tasks finish before earlier ones
+                std::this_thread::sleep_for(std::chrono::milliseconds(i % 5));
+                return [&, i] {
+                    results.push_back(i);
+                };
+            });
+        }
+
+        EXPECT_TRUE(queue.hasPending("a"));
+        EXPECT_FALSE(queue.hasPending("b"));
+
+        // nothing to wait for
+        queue.runAfter("b", [&] {
+            otherResults.push_back(0);
+        });
+        EXPECT_EQ(otherResults, std::vector<int>{0});
+
+        queue.runAfter("a", [&] {
+            results.push_back(-1);
+            done.set_value();
+        });
+    });
+
+    ASSERT_EQ(done.get_future().wait_for(10s), std::future_status::ready);
+
+    std::vector<int> expected;
+    for (int i = 0; i < 50; i++)
+    {
+        expected.push_back(i);
+    }
+    expected.push_back(-1);
+
+    EXPECT_EQ(results, expected);
+}
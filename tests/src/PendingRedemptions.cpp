@@ -0,0 +1,59 @@
+#include "providers/twitch/PendingRedemptions.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+#include <vector>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+TEST(PendingRedemptions, MatchesRewards)
+{
+    PendingRedemptions pending;
+    auto now = PendingRedemptions::Clock::now();
+
+    std::vector<QString> shown;
+    auto show = [&](const QString &name) {
+        return [&shown, name](bool known) {
+            shown.push_back(known ? name : name + " (unknown)");
+        };
+    };
+
+    pending.add("a", show("first"), now);
+    pending.add("b", show("second"), now + 1s);
+    pending.add("a", show("third"), now + 2s);
+
+    pending.rewardAdded("a");
+    ASSERT_EQ(shown.size(), 2u);
+    EXPECT_EQ(shown[0], "first");
+    EXPECT_EQ(shown[1], "third");
+    EXPECT_EQ(pending.size(), 1u);
+
+    pending.expire(now + PendingRedemptions::TIMEOUT);
+    EXPECT_EQ(shown.size(), 2u);
+    pending.expire(now + 1s + PendingRedemptions::TIMEOUT);
+    ASSERT_EQ(shown.size(), 3u);
+    EXPECT_EQ(shown[2], "second (unknown)");
+    EXPECT_TRUE(pending.empty());
+}
+
+TEST(PendingRedemptions, IsBounded)
+{
+    PendingRedemptions pending;
+    auto now = PendingRedemptions::Clock::now();
+
+    int givenUp = 0;
+    auto count = [&](bool known) {
+        if (!known)
+        {
+            givenUp++;
+        }
+    };
+    for (size_t i = 0; i < PendingRedemptions::MAX_PENDING + 2; i++)
+    {
+        pending.add("a", count, now);
+    }
+    EXPECT_EQ(givenUp, 2);
+    EXPECT_EQ(pending.size(), PendingRedemptions::MAX_PENDING);
+}
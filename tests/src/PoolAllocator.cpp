@@ -0,0 +1,61 @@
+#include "util/PoolAllocator.hpp"
+
+#include <gtest/gtest.h>
+
+#include <thread>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+struct Item {
+    explicit Item(int value)
+        : value(value)
+    {
+    }
+
+    int value;
+    char padding[200];
+};
+
+}  // namespace
+
+TEST(PoolAllocator, ReusesBlocks)
+{
+    auto first = makePooledShared<Item>(1);
+    EXPECT_EQ(first->value, 1);
+
+    const void *address = first.get();
+    first.reset();
+
+    // the latest freed block is used first
+    auto second = makePooledShared<Item>(2);
+    EXPECT_EQ(second.get(), address);
+    EXPECT_EQ(second->value, 2);
+}
+
+TEST(PoolAllocator, FreesOnOtherThreads)
+{
+    std::vector<std::shared_ptr<Item>> items;
+    for (int i = 0; i < 1000; i++)
+    {
+        items.push_back(makePooledShared<Item>(i));
+    }
+    for (int i = 0; i < 1000; i++)
+    {
+        EXPECT_EQ(items[size_t(i)]->value, i);
+    }
+
+    std::thread([items = std::move(items)]() mutable {
+        items.clear();
+    }).join();
+
+    // the other thread gave them back to the shared pool
+    std::vector<std::shared_ptr<Item>> again;
+    for (int i = 0; i < 1000; i++)
+    {
+        again.push_back(makePooledShared<Item>(i));
+    }
+    EXPECT_EQ(again.back()->value, 999);
+}
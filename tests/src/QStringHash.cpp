@@ -0,0 +1,41 @@
+#include "util/QStringHash.hpp"
+
+#include <gtest/gtest.h>
+
+#include <unordered_set>
+
+using namespace chatterino;
+
+TEST(QStringHash, SameContentSameHash)
+{
+    auto letters = QString("abcdefghijklmnopqrstuvwxyz").repeated(3);
+    for (int length = 0; length <= 64; length++)
+    {
+        auto text = letters.left(length);
+        // a copy that doesn't share the data
+        QString copy(text.constData(), text.size());
+        EXPECT_EQ(hashQString(text), hashQString(copy));
+    }
+
+    QString message = "forsen: Kappa Keepo PogChamp";
+    EXPECT_EQ(hashQString(QStringView(message).mid(8, 5)),
+              hashQString(QString("Kappa")));
+    EXPECT_EQ(QStringHash()(QString("Keepo")), hashQString(u"Keepo"));
+}
+
+TEST(QStringHash, DifferentContent)
+{
+    // every length takes a different path through the hash
+    std::unordered_set<size_t> hashes;
+    QString text;
+    for (int length = 0; length <= 100; length++)
+    {
+        hashes.insert(hashQString(text));
+        text += QChar('a' + length % 26);
+    }
+    EXPECT_EQ(hashes.size(), 101U);
+
+    EXPECT_NE(hashQString(QString("Kappa")), hashQString(QString("kappa")));
+    EXPECT_NE(hashQString(QString("ab")), hashQString(QString("ba")));
+    EXPECT_NE(hashQString(QString(QChar(0xe9))), hashQString(QString("e")));
+}
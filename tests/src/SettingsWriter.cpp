@@ -0,0 +1,58 @@
+#include "util/SettingsWriter.hpp"
+
+#include <gtest/gtest.h>
+#include <pajlada/settings/setting.hpp>
+#include <pajlada/settings/settingmanager.hpp>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTemporaryDir>
+
+using namespace chatterino;
+
+namespace {
+
+QJsonObject readJson(const QString &path)
+{
+    QFile file(path);
+    if (!file.open(QIODevice::ReadOnly))
+    {
+        return {};
+    }
+    return QJsonDocument::fromJson(file.readAll()).object();
+}
+
+}  // namespace
+
+TEST(SettingsWriter, ReplacesFile)
+{
+    QTemporaryDir dir;
+    auto path = dir.filePath("lists.json");
+
+    auto manager = std::make_shared<pajlada::Settings::SettingManager>();
+    pajlada::Settings::Setting<int> setting("/forsen", manager);
+
+    setting = 1;
+    ASSERT_TRUE(SettingsWriter::save(*manager, path));
+    EXPECT_EQ(readJson(path).value("forsen").toInt(), 1);
+
+    setting = 2;
+    ASSERT_TRUE(SettingsWriter::save(*manager, path));
+    EXPECT_EQ(readJson(path).value("forsen").toInt(), 2);
+
+    // written next to it first
+    EXPECT_FALSE(QFile::exists(path + ".tmp"));
+}
+
+TEST(SettingsWriter, FailsWithoutDirectory)
+{
+    QTemporaryDir dir;
+    auto path = dir.filePath("missing/lists.json");
+
+    auto manager = std::make_shared<pajlada::Settings::SettingManager>();
+    pajlada::Settings::Setting<int> setting("/forsen", manager);
+    setting = 1;
+
+    EXPECT_FALSE(SettingsWriter::save(*manager, path));
+    EXPECT_FALSE(QFile::exists(path));
+}
@@ -0,0 +1,97 @@
+#include "util/SharedRingBuffer.hpp"
+
+#include <gtest/gtest.h>
+
+#include <random>
+#include <string>
+#include <thread>
+
+using namespace chatterino;
+
+namespace {
+
+std::string uniqueName(const char *test)
+{
+    // tests of several builds may run at the same time
+    static auto suffix = std::to_string(std::random_device()());
+    return std::string("chatterino_test_ring_") + test + "_" + suffix;
+}
+
+}  // namespace
+
+TEST(SharedRingBuffer, WrapsAround)
+{
+    auto writer = SharedRingBuffer::create(uniqueName("wraps"), 64);
+    ASSERT_NE(writer, nullptr);
+    auto reader = SharedRingBuffer::open(uniqueName("wraps"));
+    ASSERT_NE(reader, nullptr);
+    EXPECT_EQ(reader->capacity(), 64u);
+
+    EXPECT_FALSE(reader->tryPop());
+    // doesn't fit as a whole
+    EXPECT_FALSE(writer->tryPush(QByteArray(64, 'x')));
+
+    for (int i = 0; i < 20; i++)
+    {
+        auto record = QByteArray(i % 7 + 10, char('a' + i));
+        ASSERT_TRUE(writer->tryPush(record)) << i;
+        ASSERT_TRUE(writer->tryPush(QByteArray())) << i;
+
+        auto popped = reader->tryPop();
+        ASSERT_TRUE(popped) << i;
+        EXPECT_EQ(*popped, record);
+        popped = reader->tryPop();
+        ASSERT_TRUE(popped) << i;
+        EXPECT_TRUE(popped->isEmpty());
+    }
+    EXPECT_EQ(writer->used(), 0u);
+}
+
+TEST(SharedRingBuffer, WaitsForTheReader)
+{
+    auto name = uniqueName("waits");
+    auto writer = SharedRingBuffer::create(name, 256);
+    ASSERT_NE(writer, nullptr);
+    auto reader = SharedRingBuffer::open(name);
+    ASSERT_NE(reader, nullptr);
+
+    int pushed = 0;
+    while (writer->tryPush(QByteArray::number(pushed)))
+    {
+        pushed++;
+    }
+    EXPECT_GT(pushed, 0);
+    EXPECT_EQ(*reader->tryPop(), QByteArray("0"));
+    EXPECT_TRUE(writer->tryPush(QByteArray::number(pushed)));
+
+    constexpr int count = 10000;
+    std::thread thread([&] {
+        for (int i = pushed + 1; i < count; i++)
+        {
+            while (!writer->tryPush(QByteArray::number(i)))
+            {
+                std::this_thread::yield();
+            }
+        }
+    });
+
+    for (int i = 1; i < count; i++)
+    {
+        boost::optional<QByteArray> record;
+        while (!(record = reader->tryPop()))
+        {
+            std::this_thread::yield();
+        }
+        ASSERT_EQ(*record, QByteArray::number(i));
+    }
+    thread.join();
+}
+
+TEST(SharedRingBuffer, OpensOnlyExistingBuffers)
+{
+    EXPECT_EQ(SharedRingBuffer::open(uniqueName("missing")), nullptr);
+
+    auto name = uniqueName("removed");
+    SharedRingBuffer::create(name, 64);
+    EXPECT_EQ(SharedRingBuffer::open(name), nullptr);
+}
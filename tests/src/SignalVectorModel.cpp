@@ -0,0 +1,104 @@
+#include "common/SignalVectorModel.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+namespace {
+
+class StringModel : public SignalVectorModel<QString>
+{
+public:
+    StringModel()
+        : SignalVectorModel<QString>(1)
+    {
+    }
+
+    int inserts = 0;
+    int removes = 0;
+    int resets = 0;
+
+    void countNotifications()
+    {
+        QObject::connect(this, &QAbstractItemModel::rowsInserted, [this] {
+            this->inserts++;
+        });
+        QObject::connect(this, &QAbstractItemModel::rowsRemoved, [this] {
+            this->removes++;
+        });
+        QObject::connect(this, &QAbstractItemModel::modelReset, [this] {
+            this->resets++;
+        });
+    }
+
+    QString value(int row) const
+    {
+        return this->data(this->index(row, 0), Qt::DisplayRole).toString();
+    }
+
+protected:
+    QString getItemFromRow(std::vector<QStandardItem *> &row,
+                           const QString &original) override
+    {
+        return row[0]->data(Qt::DisplayRole).toString();
+    }
+
+    void getRowFromItem(const QString &item,
+                        std::vector<QStandardItem *> &row) override
+    {
+        row[0]->setData(item, Qt::DisplayRole);
+    }
+};
+
+}  // namespace
+
+TEST(SignalVectorModel, SmallChangesAreIncremental)
+{
+    SignalVector<QString> vector;
+    vector.append("a");
+
+    StringModel model;
+    model.initialize(&vector);
+    model.countNotifications();
+
+    vector.append("b");
+    {
+        SignalVector<QString>::Batch batch(vector);
+        vector.append("c");
+        vector.removeAt(0);
+
+        // views only hear about the changes once the batch is done
+        EXPECT_EQ(model.inserts, 1);
+        EXPECT_EQ(model.value(0), "a");
+    }
+
+    EXPECT_EQ(model.inserts, 2);
+    EXPECT_EQ(model.removes, 1);
+    EXPECT_EQ(model.resets, 0);
+    ASSERT_EQ(model.rowCount(QModelIndex()), 2);
+    EXPECT_EQ(model.value(0), "b");
+    EXPECT_EQ(model.value(1), "c");
+}
+
+TEST(SignalVectorModel, LargeBatchesResetOnce)
+{
+    SignalVector<QString> vector;
+    StringModel model;
+    model.initialize(&vector);
+    model.countNotifications();
+
+    {
+        SignalVector<QString>::Batch batch(vector);
+        for (int i = 0; i < 1000; i++)
+        {
+            vector.append(QString::number(i));
+        }
+        vector.insert("first", 0);
+    }
+
+    EXPECT_EQ(model.inserts, 0);
+    EXPECT_EQ(model.resets, 1);
+    ASSERT_EQ(model.rowCount(QModelIndex()), 1001);
+    EXPECT_EQ(model.value(0), "first");
+    EXPECT_EQ(model.value(1000), "999");
+}
@@ -0,0 +1,45 @@
+#include "util/Similarity.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(Similarity, LongestCommonSubstring)
+{
+    EXPECT_EQ(longestCommonSubstring("", ""), 0);
+    EXPECT_EQ(longestCommonSubstring("abc", ""), 0);
+    EXPECT_EQ(longestCommonSubstring("abc", "xyz"), 0);
+    EXPECT_EQ(longestCommonSubstring("abc", "abc"), 3);
+    EXPECT_EQ(longestCommonSubstring("xabcdy", "zabcdw"), 4);
+    // the shorter string is either one
+    EXPECT_EQ(longestCommonSubstring("cde", "abcdefg"), 3);
+    EXPECT_EQ(longestCommonSubstring("abcdefg", "cde"), 3);
+    // the longest one isn't the first one
+    EXPECT_EQ(longestCommonSubstring("ab xy abcde", "abcde ab"), 5);
+}
+
+TEST(Similarity, StopsEarly)
+{
+    QString a = "forsen forsen forsen forsen";
+    QString b = "forsen forsen forsen forsen";
+
+    EXPECT_EQ(longestCommonSubstring(a, b), a.size());
+
+    int found = longestCommonSubstring(a, b, 5);
+    EXPECT_GE(found, 5);
+    EXPECT_LT(found, a.size());
+}
+
+TEST(Similarity, IsSimilar)
+{
+    EXPECT_FALSE(isSimilar("", "", 0.5f));
+    EXPECT_TRUE(isSimilar("abcd", "abcd", 0.9f));
+
+    // 4 of 8 characters
+    EXPECT_TRUE(isSimilar("abcdxxxx", "abcdyyyy", 0.4f));
+    EXPECT_FALSE(isSimilar("abcdxxxx", "abcdyyyy", 0.5f));
+
+    // the lengths alone rule it out
+    EXPECT_FALSE(isSimilar("ab", "abcdefgh", 0.5f));
+    EXPECT_TRUE(isSimilar("abcde", "abcdefgh", 0.5f));
+}
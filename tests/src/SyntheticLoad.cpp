@@ -0,0 +1,69 @@
+#include "providers/twitch/SyntheticLoad.hpp"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+
+using namespace chatterino;
+
+TEST(SyntheticLoad, Parse)
+{
+    SyntheticLoad load;
+    EXPECT_EQ(load.parse({"rate=250", "seconds=5", "emotes=1", "pubsub=0"}),
+              "");
+    EXPECT_EQ(load.messagesPerSecond, 250.0);
+    EXPECT_EQ(load.seconds, 5.0);
+    EXPECT_EQ(load.emotes, 1.0);
+    EXPECT_EQ(load.pubsub, 0.0);
+
+    EXPECT_NE(SyntheticLoad().parse({"rate=0"}), "");
+    EXPECT_NE(SyntheticLoad().parse({"emotes=2"}), "");
+    EXPECT_NE(SyntheticLoad().parse({"links"}), "");
+    EXPECT_NE(SyntheticLoad().parse({"unknown=1"}), "");
+}
+
+TEST(SyntheticLoad, Generate)
+{
+    SyntheticLoad load;
+    ASSERT_EQ(load.parse({"rate=10", "seconds=2", "cheers=1", "highlights=1",
+                          "timeouts=0", "pubsub=0"}),
+              "");
+
+    auto lines = generateSyntheticLoad(
+        load, {{"forsen", "22484632"}, {"pajlada", "11148817"}}, "testuser");
+
+    // every channel gets its messages
+    ASSERT_EQ(lines.size(), 40U);
+    EXPECT_TRUE(std::is_sorted(lines.begin(), lines.end(),
+                               [](const auto &a, const auto &b) {
+                                   return a.dueUs < b.dueUs;
+                               }));
+    EXPECT_EQ(lines.back().dueUs, 1900000);
+
+    int forsen = 0;
+    for (const auto &line : lines)
+    {
+        EXPECT_FALSE(line.pubsub);
+        EXPECT_TRUE(line.data.contains(" PRIVMSG #"));
+        EXPECT_TRUE(line.data.contains(";bits=100;"));
+        EXPECT_TRUE(line.data.endsWith(" @testuser"));
+        forsen += line.data.contains("PRIVMSG #forsen :") ? 1 : 0;
+    }
+    EXPECT_EQ(forsen, 20);
+}
+
+TEST(SyntheticLoad, GenerateModeration)
+{
+    SyntheticLoad load;
+    ASSERT_EQ(load.parse({"rate=10", "seconds=1", "timeouts=1", "pubsub=1"}),
+              "");
+
+    auto lines = generateSyntheticLoad(load, {{"forsen", "22484632"}}, "");
+
+    // each message is followed by a timeout and a PubSub timeout
+    ASSERT_EQ(lines.size(), 30U);
+    EXPECT_TRUE(lines[1].data.contains(" CLEARCHAT #forsen :loaduser"));
+    EXPECT_TRUE(lines[2].pubsub);
+    EXPECT_TRUE(
+        lines[2].data.contains("chat_moderator_actions.1.22484632"));
+}
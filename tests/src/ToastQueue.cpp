@@ -0,0 +1,77 @@
+#include "singletons/helper/ToastQueue.hpp"
+
+#include "controllers/notifications/NotificationController.hpp"
+
+#include <gtest/gtest.h>
+
+#include <chrono>
+
+using namespace chatterino;
+using namespace std::chrono_literals;
+
+TEST(ToastQueue, MergesBursts)
+{
+    ToastQueue queue;
+    auto now = ToastQueue::Clock::now();
+
+    queue.push("forsen", Platform::Twitch, now);
+    queue.push("pajlada", Platform::Twitch, now + 200ms);
+    queue.push("forsen", Platform::Twitch, now + 300ms);
+    EXPECT_FALSE(queue.take(now + 500ms));
+    EXPECT_TRUE(queue.nextDue() == now + ToastQueue::MERGE_DELAY);
+
+    auto toast = queue.take(now + ToastQueue::MERGE_DELAY);
+    ASSERT_TRUE(toast);
+    ASSERT_EQ(toast->channels.size(), 2u);
+    EXPECT_EQ(toast->text(), "forsen and pajlada are live!");
+    EXPECT_TRUE(queue.empty());
+
+    queue.push("a", Platform::Twitch, now);
+    toast = queue.take(now + ToastQueue::MERGE_DELAY);
+    ASSERT_TRUE(toast);
+    EXPECT_EQ(toast->text(), "a is live!");
+
+    for (auto name : {"a", "b", "c", "d", "e"})
+    {
+        queue.push(name, Platform::Twitch, now);
+    }
+    EXPECT_EQ(queue.take(now + ToastQueue::MERGE_DELAY)->text(),
+              "a, b, c and 2 more are live!");
+}
+
+TEST(ToastQueue, LimitsTheRate)
+{
+    ToastQueue queue;
+    auto now = ToastQueue::Clock::now();
+
+    for (int i = 0; i < ToastQueue::BURST; i++)
+    {
+        queue.push(QString::number(i), Platform::Twitch, now);
+        now += ToastQueue::MERGE_DELAY;
+        ASSERT_TRUE(queue.take(now)) << i;
+    }
+    auto limited = now;
+
+    // these wait until the limit allows another toast
+    queue.push("forsen", Platform::Twitch, now);
+    queue.push("pajlada", Platform::Twitch, now + 5s);
+    EXPECT_FALSE(queue.take(now + 5s));
+
+    auto due = queue.nextDue();
+    EXPECT_TRUE(due > limited);
+    EXPECT_TRUE(due <= limited + ToastQueue::REFILL_INTERVAL);
+    auto toast = queue.take(due);
+    ASSERT_TRUE(toast);
+    EXPECT_EQ(toast->channels.size(), 2u);
+
+    // refills up to the burst after a quiet while
+    now = due + ToastQueue::BURST * ToastQueue::REFILL_INTERVAL;
+    for (int i = 0; i < ToastQueue::BURST; i++)
+    {
+        queue.push(QString::number(i), Platform::Twitch, now);
+        now += ToastQueue::MERGE_DELAY;
+        ASSERT_TRUE(queue.take(now)) << i;
+    }
+    queue.push("forsen", Platform::Twitch, now);
+    EXPECT_FALSE(queue.take(now + ToastQueue::MERGE_DELAY));
+}
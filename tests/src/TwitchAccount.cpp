@@ -155,3 +155,18 @@ TEST(TwitchAccount, BatchThreeParts)
 
     EXPECT_EQ(result, expectation);
 }
+
+TEST(TwitchAccount, BatchExactlyFull)
+{
+    QStringList bigList;
+    for (int i = 0; i < 200; i++)
+    {
+        bigList.push_back(QString::number(i));
+    }
+
+    auto result = getEmoteSetBatches(bigList);
+
+    ASSERT_EQ(result.size(), 2U);
+    EXPECT_EQ(result[0], bigList.mid(0, 100));
+    EXPECT_EQ(result[1], bigList.mid(100, 100));
+}
@@ -0,0 +1,63 @@
+#include "providers/twitch/TwitchIrcLine.hpp"
+
+#include <gtest/gtest.h>
+
+using namespace chatterino;
+
+TEST(TwitchIrcLine, PrivateMessage)
+{
+    auto line = TwitchIrcLine::parse(
+        "@badge-info=;badges=moderator/1;display-name=Forsen;emotes=;"
+        "system-msg=hello\\sworld\\:\\\\;flags= :forsen!forsen@forsen.tmi."
+        "twitch.tv PRIVMSG #pajlada :Kappa :) 123\r\n");
+    ASSERT_TRUE(line);
+
+    EXPECT_EQ(line->command(), "PRIVMSG");
+    EXPECT_TRUE(line->isCommand(QLatin1String("PRIVMSG")));
+    EXPECT_FALSE(line->isCommand(QLatin1String("PRIV")));
+    EXPECT_EQ(line->nick(), "forsen");
+
+    ASSERT_EQ(line->parameterCount(), 2);
+    EXPECT_EQ(line->parameter(0), "#pajlada");
+    EXPECT_EQ(line->parameter(1), "Kappa :) 123");
+    EXPECT_EQ(line->parameter(2), "");
+
+    EXPECT_EQ(line->tag(QLatin1String("badges")), "moderator/1");
+    EXPECT_EQ(line->tag(QLatin1String("display-name")), "Forsen");
+    EXPECT_EQ(line->tag(QLatin1String("system-msg")), "hello world;\\");
+    EXPECT_TRUE(line->hasTag(QLatin1String("flags")));
+    EXPECT_EQ(line->tag(QLatin1String("flags")), "");
+    EXPECT_FALSE(line->hasTag(QLatin1String("color")));
+}
+
+TEST(TwitchIrcLine, WithoutTagsOrPrefix)
+{
+    auto ping = TwitchIrcLine::parse("PING :tmi.twitch.tv");
+    ASSERT_TRUE(ping);
+    EXPECT_EQ(ping->command(), "PING");
+    EXPECT_EQ(ping->nick(), "");
+    ASSERT_EQ(ping->parameterCount(), 1);
+    EXPECT_EQ(ping->parameter(0), "tmi.twitch.tv");
+
+    auto join = TwitchIrcLine::parse(
+        ":justinfan123!justinfan123@justinfan123.tmi.twitch.tv JOIN #forsen");
+    ASSERT_TRUE(join);
+    EXPECT_EQ(join->command(), "JOIN");
+    EXPECT_EQ(join->nick(), "justinfan123");
+    ASSERT_EQ(join->parameterCount(), 1);
+    EXPECT_EQ(join->parameter(0), "#forsen");
+
+    auto clear = TwitchIrcLine::parse(
+        "@room-id=1;tmi-sent-ts=2 :tmi.twitch.tv CLEARCHAT #forsen");
+    ASSERT_TRUE(clear);
+    EXPECT_EQ(clear->nick(), "tmi.twitch.tv");
+    EXPECT_EQ(clear->tag(QLatin1String("tmi-sent-ts")), "2");
+    EXPECT_EQ(clear->parameterCount(), 1);
+}
+
+TEST(TwitchIrcLine, Invalid)
+{
+    EXPECT_FALSE(TwitchIrcLine::parse(""));
+    EXPECT_FALSE(TwitchIrcLine::parse("\r\n"));
+    EXPECT_FALSE(TwitchIrcLine::parse("@a=b :prefix"));
+}
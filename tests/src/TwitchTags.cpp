@@ -0,0 +1,44 @@
+#include "providers/twitch/TwitchTags.hpp"
+
+#include <gtest/gtest.h>
+#include <QString>
+
+using namespace chatterino;
+
+TEST(TwitchTags, ParseBadgesTag)
+{
+    QString tag("moderator/1,subscriber/3012,,broken,a/b/c,glhf-pledge/1");
+    auto badges = parseBadgesTag(tag);
+
+    ASSERT_EQ(badges.size(), 3);
+    EXPECT_EQ(badges[0].name.toString(), "moderator");
+    EXPECT_EQ(badges[0].version.toString(), "1");
+    EXPECT_EQ(badges[1].name.toString(), "subscriber");
+    EXPECT_EQ(badges[1].version.toString(), "3012");
+    EXPECT_EQ(badges[2].name.toString(), "glhf-pledge");
+    EXPECT_EQ(badges[2].version.toString(), "1");
+
+    EXPECT_TRUE(parseBadgesTag(QString()).empty());
+}
+
+TEST(TwitchTags, ParseEmotesTag)
+{
+    QString tag("25:0-4,12-16/emotesv2_abc:6-10/broken/1902:x-2,3-/9:20-21");
+    auto emotes = parseEmotesTag(tag);
+
+    ASSERT_EQ(emotes.size(), 4);
+    EXPECT_EQ(emotes[0].id.toString(), "25");
+    EXPECT_EQ(emotes[0].start, 0);
+    EXPECT_EQ(emotes[0].end, 4);
+    EXPECT_EQ(emotes[1].id.toString(), "25");
+    EXPECT_EQ(emotes[1].start, 12);
+    EXPECT_EQ(emotes[1].end, 16);
+    EXPECT_EQ(emotes[2].id.toString(), "emotesv2_abc");
+    EXPECT_EQ(emotes[2].start, 6);
+    EXPECT_EQ(emotes[2].end, 10);
+    EXPECT_EQ(emotes[3].id.toString(), "9");
+    EXPECT_EQ(emotes[3].start, 20);
+    EXPECT_EQ(emotes[3].end, 21);
+
+    EXPECT_TRUE(parseEmotesTag(QString()).empty());
+}
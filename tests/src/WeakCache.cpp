@@ -0,0 +1,103 @@
+#include "util/WeakCache.hpp"
+
+#include <gtest/gtest.h>
+
+#include <memory>
+#include <vector>
+
+using namespace chatterino;
+
+namespace {
+
+DebugCounter testEntries("test weak cache entries");
+
+}  // namespace
+
+TEST(WeakCache, ReturnsAliveValue)
+{
+    WeakCache<int, int> cache(testEntries);
+
+    auto first = cache.getOrCreate(1, [] {
+        return std::make_shared<int>(10);
+    });
+    auto second = cache.getOrCreate(1, [] {
+        return std::make_shared<int>(20);
+    });
+
+    EXPECT_EQ(first, second);
+    EXPECT_EQ(*second, 10);
+}
+
+TEST(WeakCache, RecreatesDestroyedValue)
+{
+    WeakCache<int, int> cache(testEntries);
+
+    cache.getOrCreate(1, [] {
+        return std::make_shared<int>(10);
+    });
+    auto value = cache.getOrCreate(1, [] {
+        return std::make_shared<int>(20);
+    });
+
+    EXPECT_EQ(*value, 20);
+    EXPECT_EQ(cache.size(), 1U);
+}
+
+TEST(WeakCache, ReplacesRejectedValue)
+{
+    WeakCache<int, int> cache(testEntries);
+
+    auto first = cache.getOrCreate(1, [] {
+        return std::make_shared<int>(10);
+    });
+    auto second = cache.getOrCreate(
+        1,
+        [] {
+            return std::make_shared<int>(20);
+        },
+        [](int cached) {
+            return cached == 20;
+        });
+    auto third = cache.getOrCreate(1, [] {
+        return std::make_shared<int>(30);
+    });
+
+    EXPECT_EQ(*first, 10);
+    EXPECT_EQ(*second, 20);
+    EXPECT_EQ(second, third);
+}
+
+TEST(WeakCache, DropsExpiredEntries)
+{
+    WeakCache<int, int, 1> cache(testEntries);
+    auto before = testEntries.value();
+
+    // values that aren't kept alive anywhere
+    for (int i = 0; i < 10000; i++)
+    {
+        cache.getOrCreate(i, [] {
+            return std::make_shared<int>(0);
+        });
+    }
+
+    EXPECT_LT(cache.size(), 128U);
+    EXPECT_EQ(testEntries.value() - before, int64_t(cache.size()));
+
+    // values that are alive stay
+    std::vector<std::shared_ptr<int>> alive;
+    for (int i = 0; i < 1000; i++)
+    {
+        alive.push_back(cache.getOrCreate(-i - 1, [] {
+            return std::make_shared<int>(0);
+        }));
+    }
+
+    EXPECT_GE(cache.size(), alive.size());
+    for (int i = 0; i < 1000; i++)
+    {
+        auto value = cache.getOrCreate(-i - 1, [] {
+            return std::make_shared<int>(1);
+        });
+        EXPECT_EQ(value, alive[size_t(i)]);
+    }
+}
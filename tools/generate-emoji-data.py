@@ -0,0 +1,131 @@
+#!/usr/bin/env python3
+"""
+Turns the emoji data from https://github.com/iamcal/emoji-data (emoji.json)
+into the table read by Emojis::loadEmojiData (emoji.bin).
+
+Run it after updating emoji.json:
+    python3 generate-emoji-data.py ../resources/emoji.json ../resources/emoji.bin
+
+All numbers are unsigned 32 bit little endian integers, all strings are
+UTF-16LE without a terminator and referenced by (offset, length) in code
+units into the string data. The layout is:
+
+    header:      "C2EM", version, emoji count, emoji offset,
+                 short code count, short code offset,
+                 sorted short code offset, string offset, string length
+    emojis:      value, unified code, non-qualified code (string refs),
+                 first short code, short code count, capabilities
+    short codes: short code (string ref), emoji index
+    sorted:      indices into the short codes, stably sorted by the short
+                 code, used for the lookup and the completion
+
+Skin tone variations are separate emojis following their base emoji, their
+short code is the one of the base emoji with the tone names appended.
+"""
+
+import json
+import struct
+import sys
+
+VERSION = 1
+HEADER = struct.Struct("<4s8I")
+EMOJI = struct.Struct("<9I")
+SHORT_CODE = struct.Struct("<3I")
+
+CAPABILITIES = ["apple", "google", "twitter", "facebook"]
+
+TONE_NAMES = {
+    "1F3FB": "tone1",
+    "1F3FC": "tone2",
+    "1F3FD": "tone3",
+    "1F3FE": "tone4",
+    "1F3FF": "tone5",
+}
+
+
+class Strings:
+    def __init__(self):
+        self.data = bytearray()
+        self.offsets = {}
+
+    def add(self, text):
+        text = text or ""
+        if text not in self.offsets:
+            self.offsets[text] = len(self.data) // 2
+            self.data += text.encode("utf-16-le")
+        return self.offsets[text], len(text.encode("utf-16-le")) // 2
+
+
+def tone_names(tones):
+    return "-".join(TONE_NAMES[tone] for tone in tones.split("-")
+                    if tone in TONE_NAMES)
+
+
+def emoji_value(emoji):
+    code = emoji.get("non_qualified") or emoji.get("unified") or ""
+    return "".join(chr(int(c, 16)) for c in code.lower().split("-") if c)
+
+
+def flatten(root):
+    """Yields (emoji, short codes) in the order of the source data"""
+    for emoji in root:
+        short_codes = emoji["short_names"]
+        yield emoji, short_codes
+
+        for tones, variation in emoji.get("skin_variations", {}).items():
+            yield variation, [short_codes[0] + "_" + tone_names(tones)]
+
+
+def main(source, target):
+    with open(source, encoding="utf-8") as f:
+        root = json.load(f)
+
+    strings = Strings()
+    emojis = []
+    short_codes = []
+
+    for emoji, codes in flatten(root):
+        capabilities = 0
+        for i, name in enumerate(CAPABILITIES):
+            if emoji.get("has_img_" + name):
+                capabilities |= 1 << i
+
+        emojis.append((*strings.add(emoji_value(emoji)),
+                       *strings.add(emoji.get("unified")),
+                       *strings.add(emoji.get("non_qualified")),
+                       len(short_codes), len(codes), capabilities))
+        short_codes += [(code, len(emojis) - 1) for code in codes]
+
+    # same order as comparing the UTF-16 code units like QString does
+    order = sorted(range(len(short_codes)),
+                   key=lambda i: short_codes[i][0].encode("utf-16-be"))
+    short_codes = [(*strings.add(code), emoji) for code, emoji in short_codes]
+
+    emoji_offset = HEADER.size
+    short_code_offset = emoji_offset + EMOJI.size * len(emojis)
+    sorted_offset = short_code_offset + SHORT_CODE.size * len(short_codes)
+    string_offset = sorted_offset + 4 * len(order)
+
+    out = bytearray(HEADER.pack(b"C2EM", VERSION, len(emojis), emoji_offset,
+                                len(short_codes), short_code_offset,
+                                sorted_offset, string_offset,
+                                len(strings.data) // 2))
+    for emoji in emojis:
+        out += EMOJI.pack(*emoji)
+    for entry in short_codes:
+        out += SHORT_CODE.pack(*entry)
+    for i in order:
+        out += struct.pack("<I", i)
+    out += strings.data
+
+    with open(target, "wb") as f:
+        f.write(out)
+
+    print(f"{len(emojis)} emojis, {len(short_codes)} short codes, "
+          f"{len(out)} bytes")
+
+
+if __name__ == "__main__":
+    if len(sys.argv) != 3:
+        sys.exit(f"usage: {sys.argv[0]} emoji.json emoji.bin")
+    main(sys.argv[1], sys.argv[2])
@@ -1,2 +1,3 @@
 #!/bin/bash
 wget https://raw.githubusercontent.com/iamcal/emoji-data/master/emoji.json -O ../resources/emoji.json
+python3 generate-emoji-data.py ../resources/emoji.json ../resources/emoji.bin